@@ -1696,6 +1696,62 @@ def warp_52():
 
     return 'success'
 
+###############################################################################
+# Test that warping chunks in parallel (-multi) with several kernel threads
+# gives the same result as a single threaded warp
+
+def warp_53():
+
+    src_ds = gdal.Open('../gcore/data/utmsmall.tif')
+
+    for options in [ [], ['STREAMABLE_OUTPUT=YES'] ]:
+        ref_ds = gdal.Warp('', src_ds, format = 'MEM',
+                           dstSRS = 'EPSG:4326',
+                           warpMemoryLimit = 10000,
+                           warpOptions = options,
+                           resampleAlg = gdal.GRA_Cubic)
+        ref_cs = ref_ds.GetRasterBand(1).Checksum()
+        ref_ds = None
+
+        out_ds = gdal.Warp('', src_ds, format = 'MEM',
+                           dstSRS = 'EPSG:4326',
+                           warpMemoryLimit = 10000,
+                           multithread = True,
+                           warpOptions = options + ['NUM_THREADS=4'],
+                           resampleAlg = gdal.GRA_Cubic)
+        cs = out_ds.GetRasterBand(1).Checksum()
+        out_ds = None
+        if cs != ref_cs:
+            gdaltest.post_reason('fail')
+            print(options)
+            print(cs)
+            print(ref_cs)
+            return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test kernel threads on a chunk of a single line
+
+def warp_54():
+
+    src_ds = gdal.Open('../gcore/data/byte.tif')
+    ref_ds = gdal.Warp('', src_ds, format = 'MEM', width = 20, height = 1)
+    ref_cs = ref_ds.GetRasterBand(1).Checksum()
+    ref_ds = None
+
+    out_ds = gdal.Warp('', src_ds, format = 'MEM', width = 20, height = 1,
+                       warpOptions = ['NUM_THREADS=4'])
+    cs = out_ds.GetRasterBand(1).Checksum()
+    out_ds = None
+    if cs != ref_cs:
+        gdaltest.post_reason('fail')
+        print(cs)
+        print(ref_cs)
+        return 'fail'
+
+    return 'success'
+
 gdaltest_list = [
     warp_1,
     warp_1_short,
@@ -1765,7 +1821,9 @@ gdaltest_list = [
     warp_49,
     warp_50,
     warp_51,
-    warp_52
+    warp_52,
+    warp_53,
+    warp_54
     ]
 
 
@@ -30,7 +30,15 @@
 #include <tut.h>
 #include <tut_gdal.h>
 
+#include <cpl_conv.h>
+#include <cpl_string.h>
 #include <gdal_alg.h>
+#include <gdalwarper.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
 
 namespace tut
 {
@@ -82,4 +90,344 @@ namespace tut
         ensure_approx_equals(data.y, 0.0);
         GDAL_CG_Destroy(hCG);
     }
+    static int nCurvedTransformPoints = 0;
+
+    static int CurvedTransform( void *, int bDstToSrc, int nPointCount,
+                                double *x, double *y, double *,
+                                int *panSuccess )
+    {
+        const double dfSign = bDstToSrc ? 1.0 : -1.0;
+        for( int i = 0; i < nPointCount; i++ )
+        {
+            const double dfX = x[i];
+            x[i] = 1.5 * x[i] + dfSign * 20 * sin(y[i] / 300);
+            y[i] = 0.75 * y[i] + dfSign * 30 * cos(dfX / 200);
+            panSuccess[i] = TRUE;
+        }
+        nCurvedTransformPoints += nPointCount;
+        return TRUE;
+    }
+
+    // Compare the approximate transformers with the exact transformation
+    template<>
+    template<>
+    void object::test<2>()
+    {
+        const int nSize = 1000;
+        const double dfMaxError = 0.125;
+        double adfX[nSize], adfY[nSize], adfZ[nSize];
+        double adfXRef[nSize], adfYRef[nSize];
+        int anSuccess[nSize];
+        int anTransformedPoints[2] = { 0, 0 };
+
+        for( int iPass = 0; iPass < 2; iPass++ )
+        {
+            void* hTransformArg = iPass == 0 ?
+                GDALCreateApproxTransformer(CurvedTransform, NULL, dfMaxError) :
+                GDALCreateApproxGridTransformer(CurvedTransform, NULL,
+                                                dfMaxError);
+            ensure(hTransformArg != NULL);
+
+            double dfMaxDiff = 0.0;
+            for( int iLine = 0; iLine < nSize; iLine++ )
+            {
+                for( int i = 0; i < nSize; i++ )
+                {
+                    adfX[i] = adfXRef[i] = i + 0.5;
+                    adfY[i] = adfYRef[i] = iLine + 0.5;
+                    adfZ[i] = 0.0;
+                }
+                CurvedTransform(NULL, TRUE, nSize, adfXRef, adfYRef, adfZ,
+                                anSuccess);
+                nCurvedTransformPoints = 0;
+                ensure(GDALApproxTransform(hTransformArg, TRUE, nSize,
+                                           adfX, adfY, adfZ, anSuccess));
+                anTransformedPoints[iPass] += nCurvedTransformPoints;
+                for( int i = 0; i < nSize; i++ )
+                {
+                    ensure(anSuccess[i]);
+                    dfMaxDiff = std::max(dfMaxDiff,
+                                         fabs(adfX[i] - adfXRef[i]) +
+                                         fabs(adfY[i] - adfYRef[i]));
+                }
+            }
+            GDALDestroyApproxTransformer(hTransformArg);
+
+            // The error is only checked at sample points, so it can be
+            // slightly exceeded between them.
+            ensure("Approximation error too large",
+                   dfMaxDiff <= 1.5 * dfMaxError);
+        }
+
+        // The grid should need much less exact transformations.
+        ensure(anTransformedPoints[1] * 10 < anTransformedPoints[0]);
+    }
+
+    static int AffineTransform( void *, int bDstToSrc, int nPointCount,
+                                double *x, double *y, double *,
+                                int *panSuccess )
+    {
+        for( int i = 0; i < nPointCount; i++ )
+        {
+            const double dfX = x[i];
+            if( bDstToSrc )
+            {
+                x[i] = 3.3 + 0.97 * dfX + 0.08 * y[i];
+                y[i] = 2.1 - 0.05 * dfX + 1.02 * y[i];
+            }
+            panSuccess[i] = bDstToSrc;
+        }
+        return TRUE;
+    }
+
+    // Downsampling by a non integer factor.
+    static int ScaleTransform( void *, int bDstToSrc, int nPointCount,
+                               double *x, double *y, double *,
+                               int *panSuccess )
+    {
+        for( int i = 0; i < nPointCount; i++ )
+        {
+            if( bDstToSrc )
+            {
+                x[i] = 123.0 / 50 * x[i];
+                y[i] = 97.0 / 40 * y[i];
+            }
+            panSuccess[i] = bDstToSrc;
+        }
+        return TRUE;
+    }
+
+    template<class T> static void WarpKernel( GDALDataType eDT,
+                                              GDALResampleAlg eResample,
+                                              std::vector<T>& aDst,
+                                              GDALTransformerFunc pfnTransformer = AffineTransform,
+                                              int nDstXSize = 121,
+                                              int nDstYSize = 95,
+                                              char** papszWarpOptions = NULL )
+    {
+        const int nSrcXSize = 123;
+        const int nSrcYSize = 97;
+
+        // Pseudo random values covering the whole range of the data type,
+        // so that cubic resampling overshoots it.
+        std::vector<T> aSrc(nSrcXSize * nSrcYSize + WARP_EXTRA_ELTS);
+        unsigned int nSeed = 12345;
+        for( size_t i = 0; i < aSrc.size(); i++ )
+        {
+            nSeed = nSeed * 1103515245U + 12345U;
+            const double dfRand = ((nSeed >> 8) & 0xFFFF) / 65535.0;
+            if( eDT == GDT_Float32 )
+                aSrc[i] = static_cast<T>(dfRand * 2000 - 1000);
+            else
+                aSrc[i] = static_cast<T>(
+                    std::numeric_limits<T>::min() +
+                    dfRand * (static_cast<double>(std::numeric_limits<T>::max()) -
+                              std::numeric_limits<T>::min()));
+        }
+        aDst.resize(nDstXSize * nDstYSize);
+        std::fill(aDst.begin(), aDst.end(), 0);
+
+        GByte* pabySrc = reinterpret_cast<GByte*>(&aSrc[0]);
+        GByte* pabyDst = reinterpret_cast<GByte*>(&aDst[0]);
+        GDALWarpKernel oWK;
+        oWK.eResample = eResample;
+        oWK.eWorkingDataType = eDT;
+        oWK.nBands = 1;
+        oWK.nSrcXSize = nSrcXSize;
+        oWK.nSrcYSize = nSrcYSize;
+        oWK.papabySrcImage = &pabySrc;
+        oWK.nDstXSize = nDstXSize;
+        oWK.nDstYSize = nDstYSize;
+        oWK.papabyDstImage = &pabyDst;
+        oWK.pfnTransformer = pfnTransformer;
+        char** papszOptions = CSLDuplicate(papszWarpOptions);
+        papszOptions = CSLSetNameValue(papszOptions, "EXTRA_ELTS",
+                                       CPLSPrintf("%d", WARP_EXTRA_ELTS));
+        oWK.papszWarpOptions = papszOptions;
+        ensure_equals(oWK.PerformWarp(), CE_None);
+        CSLDestroy(papszOptions);
+    }
+
+    template<class T> static void CheckWarpKernelSIMD( GDALDataType eDT )
+    {
+        const GDALResampleAlg aeResample[] = { GRA_Bilinear, GRA_Cubic };
+        for( int i = 0; i < 2; i++ )
+        {
+            std::vector<T> aRef, aSSE2, aDefault;
+            CPLSetConfigOption("GDAL_USE_AVX2", "NO");
+            CPLSetConfigOption("GDAL_USE_SSE2", "NO");
+            WarpKernel(eDT, aeResample[i], aRef);
+            CPLSetConfigOption("GDAL_USE_SSE2", NULL);
+            WarpKernel(eDT, aeResample[i], aSSE2);
+            CPLSetConfigOption("GDAL_USE_AVX2", NULL);
+            WarpKernel(eDT, aeResample[i], aDefault);
+
+            ensure("Warped image is empty",
+                   std::count(aRef.begin(), aRef.end(), 0) <
+                       static_cast<int>(aRef.size()) / 2);
+            ensure("SSE2 resampling differs", aSSE2 == aRef);
+            ensure("Default resampling differs", aDefault == aRef);
+        }
+    }
+
+    // Check that the vectorized bilinear and cubic resampling of the warp
+    // kernel give the same results as the scalar code
+    template<>
+    template<>
+    void object::test<3>()
+    {
+        CheckWarpKernelSIMD<GByte>(GDT_Byte);
+        CheckWarpKernelSIMD<GUInt16>(GDT_UInt16);
+        CheckWarpKernelSIMD<GInt16>(GDT_Int16);
+        CheckWarpKernelSIMD<float>(GDT_Float32);
+    }
+
+    template<class T> static void CheckWarpKernelSeparable( GDALDataType eDT )
+    {
+        const GDALResampleAlg aeResample[] = { GRA_Bilinear, GRA_Cubic,
+                                               GRA_CubicSpline, GRA_Lanczos };
+        char** papszNoSeparable =
+            CSLSetNameValue(NULL, "USE_SEPARABLE_FILTER", "NO");
+        for( int i = 0; i < 4; i++ )
+        {
+            // Axis aligned downsampling: the two pass convolution must
+            // give the same results as the per pixel one, up to rounding.
+            std::vector<T> aRef, aSeparable;
+            WarpKernel(eDT, aeResample[i], aRef, ScaleTransform, 50, 40,
+                       papszNoSeparable);
+            WarpKernel(eDT, aeResample[i], aSeparable, ScaleTransform, 50, 40);
+
+            ensure("Warped image is empty",
+                   std::count(aRef.begin(), aRef.end(), 0) <
+                       static_cast<int>(aRef.size()) / 2);
+            double dfMaxDiff = 0.0;
+            for( size_t j = 0; j < aRef.size(); j++ )
+            {
+                dfMaxDiff = std::max(dfMaxDiff,
+                                     fabs(static_cast<double>(aRef[j]) -
+                                          static_cast<double>(aSeparable[j])));
+            }
+            ensure("Separable resampling differs",
+                   dfMaxDiff <= (eDT == GDT_Float32 ? 1e-3 : 1.0));
+
+            // Rotation: the chunk is not separable.
+            WarpKernel(eDT, aeResample[i], aRef, AffineTransform, 50, 40,
+                       papszNoSeparable);
+            WarpKernel(eDT, aeResample[i], aSeparable, AffineTransform, 50, 40);
+            ensure("Non separable resampling differs", aSeparable == aRef);
+        }
+        CSLDestroy(papszNoSeparable);
+    }
+
+    // Check that the separable path of the warp kernel gives the same
+    // results as the per pixel one
+    template<>
+    template<>
+    void object::test<4>()
+    {
+        CheckWarpKernelSeparable<GByte>(GDT_Byte);
+        CheckWarpKernelSeparable<GUInt16>(GDT_UInt16);
+        CheckWarpKernelSeparable<GInt16>(GDT_Int16);
+        CheckWarpKernelSeparable<float>(GDT_Float32);
+    }
+
+    static int ElevationTransform( void *, int, int nPointCount,
+                                   double *x, double *y, double *z,
+                                   int *panSuccess )
+    {
+        for( int i = 0; i < nPointCount; i++ )
+        {
+            x[i] += z[i] * sin(y[i] / 300);
+            y[i] += z[i] * cos(x[i] / 200);
+            panSuccess[i] = TRUE;
+        }
+        return TRUE;
+    }
+
+    // Test the approximation grid with wide lines, sparse requests and
+    // non zero elevations
+    template<>
+    template<>
+    void object::test<5>()
+    {
+        const double dfMaxError = 0.125;
+        void* hTransformArg =
+            GDALCreateApproxGridTransformer(CurvedTransform, NULL, dfMaxError);
+        ensure(hTransformArg != NULL);
+
+        // Once the tiles of the first line are built, the next lines of the
+        // same tile row need no exact transformation, even when they span
+        // many tiles.
+        const int nWidth = 20000;
+        std::vector<double> adfX(nWidth), adfY(nWidth), adfZ(nWidth, 0.0);
+        std::vector<int> anSuccess(nWidth);
+        for( int iLine = 0; iLine < 256; iLine++ )
+        {
+            for( int i = 0; i < nWidth; i++ )
+            {
+                adfX[i] = i + 0.5;
+                adfY[i] = iLine + 0.5;
+                adfZ[i] = 0.0;
+            }
+            nCurvedTransformPoints = 0;
+            ensure(GDALApproxTransform(hTransformArg, TRUE, nWidth,
+                                       &adfX[0], &adfY[0], &adfZ[0],
+                                       &anSuccess[0]));
+            if( iLine > 0 )
+                ensure_equals("Tiles evicted from the cache",
+                              nCurvedTransformPoints, 0);
+        }
+
+        // Sparse requests, as when computing the source window, are
+        // transformed exactly.
+        const int nSteps = 21;
+        int nPoints = 0;
+        for( int i = 0; i < nSteps; i++ )
+        {
+            for( int j = 0; j < nSteps; j++ )
+            {
+                adfX[nPoints] = 50000.0 + i * 250.0;
+                adfY[nPoints] = 50000.0 + j * 250.0;
+                adfZ[nPoints] = 0.0;
+                nPoints++;
+            }
+        }
+        nCurvedTransformPoints = 0;
+        ensure(GDALApproxTransform(hTransformArg, TRUE, nPoints,
+                                   &adfX[0], &adfY[0], &adfZ[0],
+                                   &anSuccess[0]));
+        ensure_equals(nCurvedTransformPoints, nPoints);
+        GDALDestroyApproxTransformer(hTransformArg);
+
+        // The elevation of the points is passed to the exact transformer.
+        hTransformArg = GDALCreateApproxGridTransformer(ElevationTransform,
+                                                        NULL, dfMaxError);
+        ensure(hTransformArg != NULL);
+        double dfMaxDiff = 0.0;
+        for( int iLine = 0; iLine < 300; iLine += 7 )
+        {
+            std::vector<double> adfXRef(1000), adfYRef(1000), adfZRef(1000);
+            for( int i = 0; i < 1000; i++ )
+            {
+                adfX[i] = adfXRef[i] = i + 0.5;
+                adfY[i] = adfYRef[i] = iLine + 0.5;
+                adfZ[i] = adfZRef[i] = 100.0;
+            }
+            ElevationTransform(NULL, TRUE, 1000, &adfXRef[0], &adfYRef[0],
+                               &adfZRef[0], &anSuccess[0]);
+            ensure(GDALApproxTransform(hTransformArg, TRUE, 1000,
+                                       &adfX[0], &adfY[0], &adfZ[0],
+                                       &anSuccess[0]));
+            for( int i = 0; i < 1000; i++ )
+            {
+                ensure(anSuccess[i]);
+                dfMaxDiff = std::max(dfMaxDiff,
+                                     fabs(adfX[i] - adfXRef[i]) +
+                                     fabs(adfY[i] - adfYRef[i]));
+            }
+        }
+        GDALDestroyApproxTransformer(hTransformArg);
+        ensure("Approximation error too large", dfMaxDiff <= 1.5 * dfMaxError);
+    }
+
 } // namespace tut
@@ -34,6 +34,8 @@
 #include <gdal.h>
 #include <gdal_priv.h>
 #include <gdal_utils.h>
+#include <vrtdataset.h>
+#include <algorithm>
 #include <string>
 #include <limits>
 
@@ -282,4 +284,263 @@ namespace tut
         GetGDALDriverManager()->DeregisterDriver( poDriver );
         delete poDriver;
     }
+
+    static void GetCacheTotals( GIntBig& nHits, GIntBig& nMisses )
+    {
+        nHits = 0;
+        nMisses = 0;
+        for( int i = 0; i < GDALGetCacheShardCount(); i++ )
+        {
+            GIntBig nShardHits = 0, nShardMisses = 0;
+            ensure( GDALGetCacheShardStatistics(i, NULL, &nShardHits,
+                                                &nShardMisses, NULL) );
+            nHits += nShardHits;
+            nMisses += nShardMisses;
+        }
+    }
+
+    // Test block cache statistics
+    template<> template<> void object::test<10>()
+    {
+        ensure( GDALGetCacheShardCount() >= 1 );
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        ensure( !GDALGetCacheShardStatistics(-1, NULL, NULL, NULL, NULL) );
+        CPLPopErrorHandler();
+
+        GDALDatasetH hDS = GDALCreate(GDALGetDriverByName("MEM"), "",
+                                      10, 10, 1, GDT_Byte, NULL);
+        GDALRasterBand* poBand = (GDALRasterBand*)GDALGetRasterBand(hDS, 1);
+        GIntBig nHitsBefore, nMissesBefore, nHits, nMisses;
+        GetCacheTotals(nHitsBefore, nMissesBefore);
+
+        GDALRasterBlock* poBlock = poBand->GetLockedBlockRef(0, 0);
+        ensure( poBlock != NULL );
+        poBlock->DropLock();
+        GetCacheTotals(nHits, nMisses);
+        ensure_equals( nMisses, nMissesBefore + 1 );
+        ensure_equals( nHits, nHitsBefore );
+
+        poBlock = poBand->GetLockedBlockRef(0, 0);
+        ensure( poBlock != NULL );
+        poBlock->DropLock();
+        GetCacheTotals(nHits, nMisses);
+        ensure_equals( nMisses, nMissesBefore + 1 );
+        ensure_equals( nHits, nHitsBefore + 1 );
+
+        GDALClose(hDS);
+    }
+
+    // Test per-dataset block cache quota and statistics
+    template<> template<> void object::test<11>()
+    {
+        GDALDatasetH hDS = GDALCreate(GDALGetDriverByName("MEM"), "",
+                                      100, 100, 1, GDT_Byte, NULL);
+        ensure_equals( GDALDatasetGetCacheMax(hDS), 0 );
+        GDALDatasetSetCacheMax(hDS, 1000);
+        ensure_equals( GDALDatasetGetCacheMax(hDS), 1000 );
+
+        // Blocks are lines of 100 bytes
+        GDALRasterBand* poBand = (GDALRasterBand*)GDALGetRasterBand(hDS, 1);
+        for( int i = 0; i < 20; i++ )
+        {
+            GDALRasterBlock* poBlock = poBand->GetLockedBlockRef(0, i);
+            ensure( poBlock != NULL );
+            poBlock->DropLock();
+        }
+        GIntBig nCacheUsed, nHits, nMisses;
+        GDALDatasetGetCacheStatistics(hDS, &nCacheUsed, &nHits, &nMisses);
+        ensure_equals( nCacheUsed, 1000 );
+        ensure_equals( nMisses, 20 );
+        ensure_equals( nHits, 0 );
+
+        // The most recent block is still cached, the oldest has been evicted
+        GDALRasterBlock* poBlock = poBand->GetLockedBlockRef(0, 19);
+        ensure( poBlock != NULL );
+        poBlock->DropLock();
+        GDALDatasetGetCacheStatistics(hDS, NULL, &nHits, &nMisses);
+        ensure_equals( nHits, 1 );
+        ensure_equals( nMisses, 20 );
+        poBlock = poBand->GetLockedBlockRef(0, 0);
+        ensure( poBlock != NULL );
+        poBlock->DropLock();
+        GDALDatasetGetCacheStatistics(hDS, NULL, &nHits, &nMisses);
+        ensure_equals( nHits, 1 );
+        ensure_equals( nMisses, 21 );
+
+        GDALDatasetSetCacheMax(hDS, 500);
+        GDALDatasetGetCacheStatistics(hDS, &nCacheUsed, NULL, NULL);
+        ensure_equals( nCacheUsed, 500 );
+
+        GDALClose(hDS);
+    }
+
+    // Test the compressed cache tier
+    template<> template<> void object::test<12>()
+    {
+        const char* pszFilename = "/vsimem/test_gdal_compressed_cache.tif";
+        const char* apszOptions[] = { "BLOCKYSIZE=1", NULL };
+        GDALDatasetH hDS = GDALCreate(GDALGetDriverByName("GTiff"),
+                                      pszFilename, 100, 100, 1, GDT_Byte,
+                                      (char**)apszOptions);
+        ensure( hDS != NULL );
+        GByte abyLine[100];
+        for( int i = 0; i < 100; i++ )
+        {
+            memset(abyLine, i + 1, sizeof(abyLine));
+            CPLErr eErr = GDALRasterIO(GDALGetRasterBand(hDS, 1), GF_Write,
+                                       0, i, 100, 1, abyLine, 100, 1,
+                                       GDT_Byte, 0, 0);
+            ensure_equals( eErr, CE_None );
+        }
+        GDALClose(hDS);
+
+        GIntBig nOldCacheUsed, nOldHits, nOldMisses;
+        GDALGetCompressedCacheStatistics(&nOldCacheUsed, &nOldHits,
+                                         &nOldMisses);
+        const GIntBig nOldCacheMax = GDALGetCompressedCacheMax64();
+        GDALSetCompressedCacheMax64(1024 * 1024);
+        ensure_equals( GDALGetCompressedCacheMax64(), 1024 * 1024 );
+
+        // Keep at most 10 lines of the dataset in the block cache
+        hDS = GDALOpen(pszFilename, GA_ReadOnly);
+        ensure( hDS != NULL );
+        GDALDatasetSetCacheMax(hDS, 1000);
+        GDALRasterBand* poBand = (GDALRasterBand*)GDALGetRasterBand(hDS, 1);
+        for( int i = 0; i < 20; i++ )
+        {
+            GDALRasterBlock* poBlock = poBand->GetLockedBlockRef(0, i);
+            ensure( poBlock != NULL );
+            poBlock->DropLock();
+        }
+        GIntBig nCacheUsed, nHits, nMisses;
+        GDALGetCompressedCacheStatistics(&nCacheUsed, &nHits, &nMisses);
+        ensure( nCacheUsed > nOldCacheUsed );
+        ensure_equals( nHits - nOldHits, 0 );
+        ensure_equals( nMisses - nOldMisses, 20 );
+
+        // The first line has been evicted, and is restored from the tier
+        GDALRasterBlock* poBlock = poBand->GetLockedBlockRef(0, 0);
+        ensure( poBlock != NULL );
+        ensure_equals( ((GByte*)poBlock->GetDataRef())[99], 1 );
+        poBlock->DropLock();
+        GDALGetCompressedCacheStatistics(NULL, &nHits, NULL);
+        ensure_equals( nHits - nOldHits, 1 );
+
+        // Closing the dataset discards its blocks from the tier
+        GDALClose(hDS);
+        GDALGetCompressedCacheStatistics(&nCacheUsed, NULL, NULL);
+        ensure_equals( nCacheUsed, nOldCacheUsed );
+
+        GDALSetCompressedCacheMax64(nOldCacheMax);
+        VSIUnlink(pszFilename);
+    }
+
+    static void ReadBlockLines( GDALRasterBand* poBand, int nFirst,
+                                int nCount )
+    {
+        for( int i = nFirst; i < nFirst + nCount; i++ )
+        {
+            GDALRasterBlock* poBlock = poBand->GetLockedBlockRef(0, i);
+            ensure( poBlock != NULL );
+            poBlock->DropLock();
+        }
+    }
+
+    // Test that the 2Q cache policy keeps reused blocks resident during a
+    // sequential scan. Run with --config GDAL_RB_CACHE_POLICY 2Q, since the
+    // policy is selected once per process. The default LRU policy is
+    // checked to evict them instead.
+    template<> template<> void object::test<13>()
+    {
+        const bool b2Q = EQUAL(
+            CPLGetConfigOption("GDAL_RB_CACHE_POLICY", "LRU"), "2Q");
+        if( GDALGetCacheShardCount() != 1 )
+            return;
+
+        // Room for 100 lines of 100 bytes, in an otherwise empty cache
+        const GIntBig nOldCacheMax = GDALGetCacheMax64();
+        GDALSetCacheMax64(0);
+        GDALSetCacheMax64(10000);
+
+        GDALDatasetH hDS = GDALCreate(GDALGetDriverByName("MEM"), "",
+                                      100, 1000, 1, GDT_Byte, NULL);
+        GDALRasterBand* poBand = (GDALRasterBand*)GDALGetRasterBand(hDS, 1);
+        GIntBig nHitsBefore, nMissesBefore, nHits, nMisses;
+
+        // The hot lines are evicted by the first filler lines, and read again
+        // while 2Q still remembers them, which promotes them to its main list
+        ReadBlockLines(poBand, 0, 10);
+        ReadBlockLines(poBand, 100, 100);
+        ReadBlockLines(poBand, 0, 10);
+
+        // Sequential scan of the rest of the raster, then re-read of the
+        // hot lines
+        ReadBlockLines(poBand, 200, 800);
+        GetCacheTotals(nHitsBefore, nMissesBefore);
+        ReadBlockLines(poBand, 0, 10);
+        GetCacheTotals(nHits, nMisses);
+        ensure_equals( nHits - nHitsBefore, b2Q ? 10 : 0 );
+        ensure_equals( nMisses - nMissesBefore, b2Q ? 0 : 10 );
+
+        // Flushing the band makes 2Q forget its evicted lines, so that
+        // reading them again is not taken as a reuse
+        ReadBlockLines(poBand, 100, 100);
+        GDALFlushRasterCache(poBand);
+        ReadBlockLines(poBand, 100, 10);
+        ReadBlockLines(poBand, 200, 800);
+        GetCacheTotals(nHitsBefore, nMissesBefore);
+        ReadBlockLines(poBand, 100, 10);
+        GetCacheTotals(nHits, nMisses);
+        ensure_equals( nHits - nHitsBefore, 0 );
+        ensure_equals( nMisses - nMissesBefore, 10 );
+
+        GDALClose(hDS);
+        GDALSetCacheMax64(nOldCacheMax);
+    }
+
+    // Test that the VRT source index notices sources that are swapped or
+    // moved in place, and not only sources that are added or removed.
+    template<> template<> void object::test<14>()
+    {
+        const int nSize = 100;
+        GDALDatasetH hSrcDS = GDALCreate(GDALGetDriverByName("MEM"), "",
+                                         nSize, 1, 1, GDT_Byte, NULL);
+        GDALRasterBand* poSrcBand =
+            (GDALRasterBand*)GDALGetRasterBand(hSrcDS, 1);
+        GByte abyLine[nSize];
+        for( int i = 0; i < nSize; i++ )
+            abyLine[i] = static_cast<GByte>(i);
+        ensure_equals( poSrcBand->RasterIO(GF_Write, 0, 0, nSize, 1,
+                                           abyLine, nSize, 1, GDT_Byte,
+                                           0, 0, NULL), CE_None );
+
+        VRTDataset* poVRTDS = (VRTDataset*)GDALCreate(
+            GDALGetDriverByName("VRT"), "", nSize, 1, 0, GDT_Byte, NULL);
+        poVRTDS->AddBand(GDT_Byte, NULL);
+        VRTSourcedRasterBand* poVRTBand =
+            (VRTSourcedRasterBand*)poVRTDS->GetRasterBand(1);
+        for( int i = 0; i < nSize; i++ )
+            poVRTBand->AddSimpleSource(poSrcBand, i, 0, 1, 1, i, 0, 1, 1);
+
+        GByte byVal = 0;
+        ensure_equals( poVRTBand->RasterIO(GF_Read, 5, 0, 1, 1, &byVal, 1, 1,
+                                           GDT_Byte, 0, 0, NULL), CE_None );
+        ensure_equals( byVal, 5 );
+
+        // The source covering pixel 5 is now the 8th one
+        std::swap(poVRTBand->papoSources[5], poVRTBand->papoSources[7]);
+        ensure_equals( poVRTBand->RasterIO(GF_Read, 5, 0, 1, 1, &byVal, 1, 1,
+                                           GDT_Byte, 0, 0, NULL), CE_None );
+        ensure_equals( byVal, 5 );
+
+        // The last source is moved over pixel 5, and wins as it comes last
+        ((VRTSimpleSource*)poVRTBand->papoSources[nSize - 1])->SetDstWindow(
+            5, 0, 1, 1);
+        ensure_equals( poVRTBand->RasterIO(GF_Read, 5, 0, 1, 1, &byVal, 1, 1,
+                                           GDT_Byte, 0, 0, NULL), CE_None );
+        ensure_equals( byVal, nSize - 1 );
+
+        GDALClose((GDALDatasetH)poVRTDS);
+        GDALClose(hSrcDS);
+    }
 } // namespace tut
@@ -268,4 +268,200 @@ namespace tut
         GDALClose(ds);
     }
 
+    // Test reading with bDirectRead, which bypasses the block cache
+    template<>
+    template<>
+    void object::test<8>()
+    {
+        const char* pszFilename = "/vsimem/test_gdal_gtiff_direct_read.tif";
+        const char* const apszOptions[] = { "TILED=YES", "BLOCKXSIZE=16",
+                                            "BLOCKYSIZE=16", NULL };
+        GDALDatasetH ds = GDALCreate(drv_, pszFilename, 50, 40, 1, GDT_Int16,
+                                     const_cast<char**>(apszOptions));
+        ensure("Can't create dataset", NULL != ds);
+        std::vector<GInt16> values(50 * 40);
+        for( size_t i = 0; i < values.size(); i++ )
+            values[i] = static_cast<GInt16>(i);
+        ensure_equals("Can't write data",
+            GDALRasterIO(GDALGetRasterBand(ds, 1), GF_Write, 0, 0, 50, 40,
+                         &values[0], 50, 40, GDT_Int16, 0, 0), CE_None);
+        GDALClose(ds);
+
+        ds = GDALOpen(pszFilename, GA_ReadOnly);
+        ensure("Can't open dataset", NULL != ds);
+        GDALRasterBand* poBand =
+            reinterpret_cast<GDALRasterBand*>(GDALGetRasterBand(ds, 1));
+        GDALRasterIOExtraArg sExtraArg;
+        INIT_RASTERIO_EXTRA_ARG(sExtraArg);
+        sExtraArg.bDirectRead = TRUE;
+
+        const GIntBig nCacheUsed = GDALGetCacheUsed64();
+        // One full block, straight into the buffer
+        std::vector<GInt16> block(16 * 16);
+        ensure_equals("Can't read block",
+            poBand->RasterIO(GF_Read, 16, 16, 16, 16, &block[0], 16, 16,
+                             GDT_Int16, 0, 0, &sExtraArg), CE_None);
+        ensure_equals("Wrong block value", block[17], values[17 * 50 + 17]);
+        // Unaligned window with data type conversion
+        std::vector<float> window(45 * 33);
+        ensure_equals("Can't read window",
+            poBand->RasterIO(GF_Read, 3, 5, 45, 33, &window[0], 45, 33,
+                             GDT_Float32, 0, 0, &sExtraArg), CE_None);
+        for( int iY = 0; iY < 33; iY++ )
+        {
+            for( int iX = 0; iX < 45; iX++ )
+            {
+                if( window[iY * 45 + iX] != values[(iY + 5) * 50 + iX + 3] )
+                    ensure_equals("Wrong window value",
+                                  window[iY * 45 + iX],
+                                  static_cast<float>(values[(iY + 5) * 50 + iX + 3]));
+            }
+        }
+        ensure_equals("Block cache was used", GDALGetCacheUsed64(), nCacheUsed);
+
+        GDALClose(ds);
+        VSIUnlink(pszFilename);
+    }
+
+    // Build overviews with and without GDAL_NUM_THREADS and check that the
+    // multi-threaded computation gives the same result
+    template<>
+    template<>
+    void object::test<9>()
+    {
+        const char* const apszInterleaves[] = { "BAND", "PIXEL" };
+        const char* const apszResamplings[] = { "NEAREST", "AVERAGE",
+                                                "CUBIC" };
+        for( int iInterleave = 0; iInterleave < 2; iInterleave++ )
+        {
+            for( int iResampling = 0; iResampling < 3; iResampling++ )
+            {
+                int anChecksums[2][2 * 2];
+                for( int iPass = 0; iPass < 2; iPass++ )
+                {
+                    const char* pszFilename =
+                        "/vsimem/test_gdal_gtiff_ovr_threads.tif";
+                    char** papszOptions = NULL;
+                    papszOptions = CSLSetNameValue(papszOptions, "INTERLEAVE",
+                                            apszInterleaves[iInterleave]);
+                    papszOptions = CSLSetNameValue(papszOptions, "TILED", "YES");
+                    GDALDatasetH ds = GDALCreate(drv_, pszFilename, 300, 200,
+                                                 2, GDT_Byte, papszOptions);
+                    CSLDestroy(papszOptions);
+                    ensure("Can't create dataset", NULL != ds);
+                    std::vector<GByte> values(300 * 200);
+                    for( int iBand = 1; iBand <= 2; iBand++ )
+                    {
+                        for( size_t i = 0; i < values.size(); i++ )
+                            values[i] = static_cast<GByte>((i * 7 + iBand) % 251);
+                        ensure_equals("Can't write data",
+                            GDALRasterIO(GDALGetRasterBand(ds, iBand), GF_Write,
+                                         0, 0, 300, 200, &values[0], 300, 200,
+                                         GDT_Byte, 0, 0), CE_None);
+                    }
+
+                    CPLSetConfigOption("GDAL_NUM_THREADS",
+                                       iPass == 0 ? NULL : "4");
+                    int anOverviewList[] = { 2, 4 };
+                    CPLErr eErr = GDALBuildOverviews(ds,
+                                        apszResamplings[iResampling],
+                                        2, anOverviewList, 0, NULL, NULL, NULL);
+                    CPLSetConfigOption("GDAL_NUM_THREADS", NULL);
+                    ensure_equals("Can't build overviews", eErr, CE_None);
+
+                    for( int iBand = 1; iBand <= 2; iBand++ )
+                    {
+                        for( int iOvr = 0; iOvr < 2; iOvr++ )
+                        {
+                            GDALRasterBandH hOvr = GDALGetOverview(
+                                GDALGetRasterBand(ds, iBand), iOvr);
+                            anChecksums[iPass][(iBand - 1) * 2 + iOvr] =
+                                GDALChecksumImage(hOvr, 0, 0,
+                                                  GDALGetRasterBandXSize(hOvr),
+                                                  GDALGetRasterBandYSize(hOvr));
+                        }
+                    }
+                    GDALClose(ds);
+                    VSIUnlink(pszFilename);
+                }
+                for( int i = 0; i < 2 * 2; i++ )
+                {
+                    ensure_equals("Wrong multi-threaded overview checksum",
+                                  anChecksums[1][i], anChecksums[0][i]);
+                }
+            }
+        }
+    }
+
+    // Check that overviews computed in a single pass over the base raster
+    // match the ones computed level after level
+    template<>
+    template<>
+    void object::test<10>()
+    {
+        const char* const apszInterleaves[] = { "BAND", "PIXEL" };
+        const char* const apszResamplings[] = { "NEAREST", "AVERAGE",
+                                                "GAUSS", "CUBIC" };
+        for( int iInterleave = 0; iInterleave < 2; iInterleave++ )
+        {
+            for( int iResampling = 0; iResampling < 4; iResampling++ )
+            {
+                int anChecksums[2][2 * 3];
+                for( int iPass = 0; iPass < 2; iPass++ )
+                {
+                    const char* pszFilename =
+                        "/vsimem/test_gdal_gtiff_ovr_single_pass.tif";
+                    char** papszOptions = NULL;
+                    papszOptions = CSLSetNameValue(papszOptions, "INTERLEAVE",
+                                            apszInterleaves[iInterleave]);
+                    GDALDatasetH ds = GDALCreate(drv_, pszFilename, 301, 203,
+                                                 2, GDT_UInt16, papszOptions);
+                    CSLDestroy(papszOptions);
+                    ensure("Can't create dataset", NULL != ds);
+                    std::vector<GUInt16> values(301 * 203);
+                    for( int iBand = 1; iBand <= 2; iBand++ )
+                    {
+                        for( size_t i = 0; i < values.size(); i++ )
+                            values[i] = static_cast<GUInt16>(
+                                            (i * 13 + iBand * (i / 301)) % 1000);
+                        ensure_equals("Can't write data",
+                            GDALRasterIO(GDALGetRasterBand(ds, iBand), GF_Write,
+                                         0, 0, 301, 203, &values[0], 301, 203,
+                                         GDT_UInt16, 0, 0), CE_None);
+                        GDALSetRasterNoDataValue(GDALGetRasterBand(ds, iBand), 0);
+                    }
+
+                    CPLSetConfigOption("GDAL_OVR_SINGLE_PASS",
+                                       iPass == 0 ? "NO" : NULL);
+                    int anOverviewList[] = { 2, 4, 8 };
+                    CPLErr eErr = GDALBuildOverviews(ds,
+                                        apszResamplings[iResampling],
+                                        3, anOverviewList, 0, NULL, NULL, NULL);
+                    CPLSetConfigOption("GDAL_OVR_SINGLE_PASS", NULL);
+                    ensure_equals("Can't build overviews", eErr, CE_None);
+
+                    for( int iBand = 1; iBand <= 2; iBand++ )
+                    {
+                        for( int iOvr = 0; iOvr < 3; iOvr++ )
+                        {
+                            GDALRasterBandH hOvr = GDALGetOverview(
+                                GDALGetRasterBand(ds, iBand), iOvr);
+                            anChecksums[iPass][(iBand - 1) * 3 + iOvr] =
+                                GDALChecksumImage(hOvr, 0, 0,
+                                                  GDALGetRasterBandXSize(hOvr),
+                                                  GDALGetRasterBandYSize(hOvr));
+                        }
+                    }
+                    GDALClose(ds);
+                    VSIUnlink(pszFilename);
+                }
+                for( int i = 0; i < 2 * 3; i++ )
+                {
+                    ensure_equals("Wrong single pass overview checksum",
+                                  anChecksums[1][i], anChecksums[0][i]);
+                }
+            }
+        }
+    }
+
  } // namespace tut
@@ -32,7 +32,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 #include <tut.h>
 #include <ogrsf_frmts.h>
+#include <algorithm>
 #include <string>
+#include <vector>
 
 namespace tut
 {
@@ -444,4 +446,459 @@ namespace tut
         }
     }
 
+    // Test that compiled attribute filters and SQL expressions give the
+    // same results as the evaluation of the expression tree
+    template<>
+    template<>
+    void object::test<7>()
+    {
+        OGRFeatureDefn* poDefn = new OGRFeatureDefn("test");
+        poDefn->Reference();
+        OGRFieldDefn oFieldInt("int", OFTInteger);
+        poDefn->AddFieldDefn(&oFieldInt);
+        OGRFieldDefn oFieldInt64("int64", OFTInteger64);
+        poDefn->AddFieldDefn(&oFieldInt64);
+        OGRFieldDefn oFieldReal("real", OFTReal);
+        poDefn->AddFieldDefn(&oFieldReal);
+        OGRFieldDefn oFieldStr("str", OFTString);
+        poDefn->AddFieldDefn(&oFieldStr);
+        OGRFieldDefn oFieldDate("dt", OFTDateTime);
+        poDefn->AddFieldDefn(&oFieldDate);
+        OGRFieldDefn oFieldBool("b", OFTInteger);
+        oFieldBool.SetSubType(OFSTBoolean);
+        poDefn->AddFieldDefn(&oFieldBool);
+
+        const char* const apszStr[] = { "foo", "Bar", "baz%", "" };
+        std::vector<OGRFeature*> apoFeatures;
+        for( int i = 0; i < 40; i++ )
+        {
+            OGRFeature* poFeature = new OGRFeature(poDefn);
+            poFeature->SetFID(i);
+            if( i % 7 != 3 )
+                poFeature->SetField(0, i - 20);
+            if( i % 5 != 2 )
+                poFeature->SetField(1, (GIntBig)i * 1000000000);
+            if( i % 6 != 4 )
+                poFeature->SetField(2, i * 0.75 - 10);
+            if( i % 9 != 5 )
+                poFeature->SetField(3, apszStr[i % 4]);
+            if( i % 4 != 1 )
+                poFeature->SetField(4, 2016, 1 + i % 12, 1 + i % 28,
+                                     i % 24, 0, 0, (i % 2) ? 100 : 0);
+            poFeature->SetField(5, i % 3 == 0);
+            apoFeatures.push_back(poFeature);
+        }
+
+        const char* const apszExpr[] = {
+            "int > 3",
+            "int = -20 OR int64 = 2000000000",
+            "int >= 0 AND real < 5.5",
+            "NOT (int BETWEEN -5 AND 5)",
+            "int IN (1, 2, -3, 10)",
+            "int64 IN (3000000000, 5000000000)",
+            "real BETWEEN 0 AND 10",
+            "real IN (0.5, 2, 5)",
+            "int + 1 = 6",
+            "int * 2 - 3 > real",
+            "int / 3 = 2",
+            "int % 4 = 1",
+            "real % 3 = 1",
+            "int / 0 = 2147483647",
+            "real / 0 > 1",
+            "real + int > 4.5",
+            "int IS NULL",
+            "str IS NULL OR real IS NULL",
+            "NOT int IS NULL",
+            "str = 'foo'",
+            "str <> 'FOO'",
+            "str > 'b'",
+            "str <= 'bar'",
+            "str IN ('foo', 'baz%')",
+            "str BETWEEN 'a' AND 'c'",
+            "str LIKE 'ba%'",
+            "str LIKE 'baz!%' ESCAPE '!'",
+            "str LIKE '_a_'",
+            "dt = '2016/01/01 00:00:00'",
+            "dt = '2016/05/05 04:00:00+00'",
+            "dt > '2016/06/01'",
+            "b",
+            "b AND int > 0",
+            "b = 0 OR int < 0",
+            "FID < 10 AND str = 'foo'",
+            "int",
+            "int64 > real",
+            "CONCAT(str, 'x') = 'foox'",
+            "CAST(int AS character(10)) = '5'",
+            "int IS NULL AND real > 5"
+        };
+
+        for( size_t iExpr = 0;
+             iExpr < sizeof(apszExpr) / sizeof(apszExpr[0]); iExpr++ )
+        {
+            OGRFeatureQuery oTreeQuery;
+            OGRFeatureQuery oProgramQuery;
+            ensure_equals( apszExpr[iExpr],
+                           oTreeQuery.Compile(poDefn, apszExpr[iExpr]),
+                           OGRERR_NONE );
+            ensure_equals( apszExpr[iExpr],
+                           oProgramQuery.Compile(poDefn, apszExpr[iExpr]),
+                           OGRERR_NONE );
+
+            int nMatches = 0;
+            for( size_t i = 0; i < apoFeatures.size(); i++ )
+            {
+                CPLSetConfigOption("OGR_SQL_COMPILE_EXPRESSIONS", "NO");
+                int bExpected = oTreeQuery.Evaluate(apoFeatures[i]);
+                CPLSetConfigOption("OGR_SQL_COMPILE_EXPRESSIONS", NULL);
+                int bGot = oProgramQuery.Evaluate(apoFeatures[i]);
+                ensure_equals( CPLSPrintf("%s, feature %d", apszExpr[iExpr],
+                                          (int)i), bGot, bExpected );
+                if( bGot )
+                    nMatches++;
+            }
+            ensure( apszExpr[iExpr], nMatches > 0 );
+        }
+
+        // Same for computed columns of SQL requests
+        GDALDriver* poMemDrv = GetGDALDriverManager()->GetDriverByName("Memory");
+        ensure( poMemDrv != NULL );
+        GDALDataset* poDS = poMemDrv->Create("", 0, 0, 0, GDT_Unknown, NULL);
+        ensure( poDS != NULL );
+        OGRLayer* poLayer = poDS->CreateLayer("test");
+        for( int iField = 0; iField < poDefn->GetFieldCount(); iField++ )
+            poLayer->CreateField(poDefn->GetFieldDefn(iField));
+        for( size_t i = 0; i < apoFeatures.size(); i++ )
+        {
+            OGRFeature* poFeature = new OGRFeature(poLayer->GetLayerDefn());
+            poFeature->SetFrom(apoFeatures[i]);
+            ensure_equals( poLayer->CreateFeature(poFeature), OGRERR_NONE );
+            delete poFeature;
+        }
+
+        const char* pszSQL =
+            "SELECT int * 3 + 1, int64 - int, real * 2, real % 4, int / 0, "
+            "int > real, str LIKE 'b%', dt <> '2016/02/02 01:00:00', "
+            "b OR int IS NULL, CONCAT(str, '!') FROM test WHERE int < 15";
+        std::vector<CPLString> aosExpected;
+        for( int iPass = 0; iPass < 2; iPass++ )
+        {
+            CPLSetConfigOption("OGR_SQL_COMPILE_EXPRESSIONS",
+                               iPass == 0 ? "NO" : NULL);
+            OGRLayer* poSQLLayer = poDS->ExecuteSQL(pszSQL, NULL, NULL);
+            ensure( poSQLLayer != NULL );
+            OGRFeature* poFeature;
+            int iFeature = 0;
+            while( (poFeature = poSQLLayer->GetNextFeature()) != NULL )
+            {
+                CPLString osDump;
+                for( int iField = 0; iField < poFeature->GetFieldCount();
+                     iField++ )
+                {
+                    osDump += poFeature->IsFieldSet(iField) ?
+                        poFeature->GetFieldAsString(iField) : "(null)";
+                    osDump += ",";
+                }
+                if( iPass == 0 )
+                    aosExpected.push_back(osDump);
+                else
+                {
+                    ensure( iFeature < (int)aosExpected.size() );
+                    ensure_equals( osDump, aosExpected[iFeature] );
+                }
+                iFeature++;
+                delete poFeature;
+            }
+            ensure_equals( iFeature, (int)aosExpected.size() );
+            poDS->ReleaseResultSet(poSQLLayer);
+        }
+        CPLSetConfigOption("OGR_SQL_COMPILE_EXPRESSIONS", NULL);
+        ensure( aosExpected.size() > 10 );
+
+        GDALClose(poDS);
+        for( size_t i = 0; i < apoFeatures.size(); i++ )
+            delete apoFeatures[i];
+        poDefn->Release();
+    }
+
+    // Test that a GeoJSON FeatureCollection read in streaming mode gives
+    // the same layer as when it is loaded in memory
+    template<>
+    template<>
+    void object::test<8>()
+    {
+        const char* pszFilename = "/vsimem/test_ogr_geojson_streaming.json";
+        const char* pszContent =
+            "{ \"type\": \"FeatureCollection\", \"name\": \"test\",\n"
+            "  \"features\": [\n"
+            "  { \"type\": \"Feature\", \"id\": 3, \"properties\": "
+            "{ \"a\": 1, \"s\": \"x\" }, \"geometry\": "
+            "{ \"type\": \"Point\", \"coordinates\": [1, 2] } },\n"
+            "  { \"type\": \"Feature\", \"id\": 3, \"properties\": "
+            "{ \"a\": 2.5, \"b\": \"}]{[\\\"\" }, \"geometry\": null },\n"
+            "  { \"type\": \"Feature\", \"properties\": "
+            "{ \"s\": \"y\", \"c\": [1, 2] }, \"geometry\": "
+            "{ \"type\": \"Point\", \"coordinates\": [3, 4] } },\n"
+            "  { \"type\": \"Feature\", \"id\": 10, \"properties\": { }, "
+            "\"geometry\": { \"type\": \"Point\", \"coordinates\": [5, 6] } }\n"
+            "  ],\n"
+            "  \"crs\": { \"type\": \"name\", \"properties\": "
+            "{ \"name\": \"urn:ogc:def:crs:EPSG::32631\" } } }\n";
+        VSIFCloseL(VSIFileFromMemBuffer(pszFilename, (GByte*)pszContent,
+                                        strlen(pszContent), FALSE));
+
+        std::vector<std::string> aosExpected;
+        for( int iPass = 0; iPass < 2; iPass++ )
+        {
+            CPLSetConfigOption("OGR_GEOJSON_STREAMING", iPass == 0 ? "NO" : "YES");
+            CPLPushErrorHandler(CPLQuietErrorHandler);
+            GDALDataset* poDS = (GDALDataset*)GDALOpenEx(pszFilename,
+                                        GDAL_OF_VECTOR, NULL, NULL, NULL);
+            CPLPopErrorHandler();
+            ensure( poDS != NULL );
+            OGRLayer* poLayer = poDS->GetLayer(0);
+            ensure( poLayer != NULL );
+
+            std::string osSchema;
+            OGRFeatureDefn* poDefn = poLayer->GetLayerDefn();
+            for( int iField = 0; iField < poDefn->GetFieldCount(); iField++ )
+            {
+                osSchema += poDefn->GetFieldDefn(iField)->GetNameRef();
+                osSchema += ":";
+                osSchema += OGRFieldDefn::GetFieldTypeName(
+                    poDefn->GetFieldDefn(iField)->GetType());
+                osSchema += ",";
+            }
+            osSchema += OGRGeometryTypeToName(poDefn->GetGeomType());
+            osSchema += ",";
+            osSchema += poLayer->GetFIDColumn();
+            OGRSpatialReference* poSRS = poLayer->GetSpatialRef();
+            ensure( poSRS != NULL );
+            osSchema += CPLSPrintf(",%s", poSRS->GetAuthorityCode(NULL));
+
+            std::vector<std::string> aosDump;
+            aosDump.push_back(osSchema);
+            aosDump.push_back(CPLSPrintf(CPL_FRMT_GIB,
+                                         poLayer->GetFeatureCount()));
+
+            // Features are returned by FID in memory, but in file order
+            // when streamed
+            std::vector<std::string> aosFeatures;
+            std::vector<GIntBig> anFIDs;
+            OGRFeature* poFeature;
+            while( (poFeature = poLayer->GetNextFeature()) != NULL )
+            {
+                anFIDs.push_back(poFeature->GetFID());
+                std::string osDump(CPLSPrintf(CPL_FRMT_GIB ",",
+                                              poFeature->GetFID()));
+                for( int iField = 0; iField < poFeature->GetFieldCount();
+                     iField++ )
+                {
+                    osDump += poFeature->IsFieldSet(iField) ?
+                        poFeature->GetFieldAsString(iField) : "(null)";
+                    osDump += ",";
+                }
+                char* pszWKT = NULL;
+                if( poFeature->GetGeometryRef() != NULL )
+                    poFeature->GetGeometryRef()->exportToWkt(&pszWKT);
+                osDump += pszWKT ? pszWKT : "(null)";
+                CPLFree(pszWKT);
+                aosFeatures.push_back(osDump);
+                delete poFeature;
+            }
+            ensure_equals( anFIDs.size(), 4U );
+            ensure_equals( anFIDs[0], iPass == 0 ? 1 : 3 );
+            ensure_equals( anFIDs[1], iPass == 0 ? 2 : 1 );
+            ensure_equals( anFIDs[2], iPass == 0 ? 3 : 2 );
+            ensure_equals( anFIDs[3], 10 );
+            std::sort(aosFeatures.begin(), aosFeatures.end());
+            aosDump.insert(aosDump.end(), aosFeatures.begin(),
+                           aosFeatures.end());
+
+            // Random access by FID and by index
+            poFeature = poLayer->GetFeature(10);
+            ensure( poFeature != NULL );
+            ensure_equals( poFeature->GetFID(), 10 );
+            delete poFeature;
+            poFeature = poLayer->GetFeature(1);
+            ensure( poFeature != NULL );
+            ensure_equals( std::string(poFeature->GetFieldAsString("b")),
+                           std::string("}]{[\"") );
+            delete poFeature;
+            ensure( poLayer->GetFeature(4) == NULL );
+            if( iPass == 1 )
+            {
+                // Indices are in file order
+                ensure_equals( poLayer->SetNextByIndex(2), OGRERR_NONE );
+                poFeature = poLayer->GetNextFeature();
+                ensure( poFeature != NULL );
+                ensure_equals( poFeature->GetFID(), 2 );
+                delete poFeature;
+            }
+
+            poLayer->SetAttributeFilter("s = 'y'");
+            aosDump.push_back(CPLSPrintf(CPL_FRMT_GIB,
+                                         poLayer->GetFeatureCount()));
+            poLayer->SetAttributeFilter(NULL);
+
+            if( iPass == 0 )
+                aosExpected = aosDump;
+            else
+            {
+                ensure_equals( aosDump.size(), aosExpected.size() );
+                for( size_t i = 0; i < aosDump.size(); i++ )
+                    ensure_equals( aosDump[i], aosExpected[i] );
+            }
+            GDALClose(poDS);
+        }
+        ensure_equals( aosExpected.size(), 7U );
+        ensure_equals( aosExpected[2], std::string("1,2.5,(null),}]{[\",(null),(null)") );
+
+        // Content that cannot be streamed is still loaded in memory
+        const char* pszFeature =
+            "{ \"type\": \"Feature\", \"properties\": { \"a\": 1 }, "
+            "\"geometry\": { \"type\": \"Point\", \"coordinates\": [1, 2] } }";
+        VSIFCloseL(VSIFileFromMemBuffer(pszFilename, (GByte*)pszFeature,
+                                        strlen(pszFeature), FALSE));
+        GDALDataset* poDS = (GDALDataset*)GDALOpenEx(pszFilename,
+                                        GDAL_OF_VECTOR, NULL, NULL, NULL);
+        ensure( poDS != NULL );
+        ensure_equals( poDS->GetLayer(0)->GetFeatureCount(), 1 );
+        GDALClose(poDS);
+
+        CPLSetConfigOption("OGR_GEOJSON_STREAMING", NULL);
+        VSIUnlink(pszFilename);
+    }
+
+    // Test that the GeoJSON text writer produces the same output as the
+    // json-c one
+    template<>
+    template<>
+    void object::test<9>()
+    {
+        GDALDriver* poDriver =
+            GetGDALDriverManager()->GetDriverByName("GeoJSON");
+        ensure( poDriver != NULL );
+
+        const char* const apszWKT[] = {
+            "POINT (1.5 -2.25)",
+            "POINT (0.125 1e-7 3)",
+            "POINT EMPTY",
+            "LINESTRING (0 0,1.123456789012345 2,3 4)",
+            "LINESTRING EMPTY",
+            "POLYGON ((0 0,0 1,1 1,0 0),(0.1 0.1,0.1 0.2,0.2 0.2,0.1 0.1))",
+            "POLYGON EMPTY",
+            "MULTIPOINT (1 2,3 4)",
+            "MULTILINESTRING ((1 2,3 4),(5 6,7 8))",
+            "MULTIPOLYGON (((0 0 1,0 1 1,1 1 1,0 0 1)),((2 2 0,2 3 0,3 3 0,2 2 0)))",
+            "GEOMETRYCOLLECTION (POINT (1 2),POINT EMPTY,LINESTRING (1 2,3 4))",
+            "GEOMETRYCOLLECTION EMPTY",
+            "CIRCULARSTRING (0 0,1 1,2 0)",
+            "POINT (nan 2)",
+            NULL
+        };
+
+        const char* const apszLCO[] = { NULL, "COORDINATE_PRECISION=3",
+                                        "SIGNIFICANT_FIGURES=4",
+                                        "WRITE_BBOX=YES" };
+        for( int iLCO = 0; iLCO < 4; iLCO++ )
+        {
+            std::string aosOutput[2];
+            for( int iPass = 0; iPass < 2; iPass++ )
+            {
+                CPLSetConfigOption("OGR_GEOJSON_DIRECT_WRITE",
+                                   iPass == 0 ? "NO" : "YES");
+                const char* pszFilename = "/vsimem/test_ogr_geojson_write.json";
+                GDALDataset* poDS = poDriver->Create(pszFilename, 0, 0, 0,
+                                                     GDT_Unknown, NULL);
+                ensure( poDS != NULL );
+                char* apszOptions[2] = { (char*)apszLCO[iLCO], NULL };
+                OGRLayer* poLayer = poDS->CreateLayer("test", NULL, wkbUnknown,
+                                                      apszOptions);
+                ensure( poLayer != NULL );
+
+                OGRFieldDefn oFieldInt("int", OFTInteger);
+                poLayer->CreateField(&oFieldInt);
+                OGRFieldDefn oFieldBool("bool", OFTInteger);
+                oFieldBool.SetSubType(OFSTBoolean);
+                poLayer->CreateField(&oFieldBool);
+                OGRFieldDefn oFieldInt64("int64", OFTInteger64);
+                poLayer->CreateField(&oFieldInt64);
+                OGRFieldDefn oFieldReal("real", OFTReal);
+                poLayer->CreateField(&oFieldReal);
+                OGRFieldDefn oFieldStr("str/\"name", OFTString);
+                poLayer->CreateField(&oFieldStr);
+                OGRFieldDefn oFieldIntList("intlist", OFTIntegerList);
+                poLayer->CreateField(&oFieldIntList);
+                OGRFieldDefn oFieldRealList("reallist", OFTRealList);
+                poLayer->CreateField(&oFieldRealList);
+                OGRFieldDefn oFieldStrList("strlist", OFTStringList);
+                poLayer->CreateField(&oFieldStrList);
+                OGRFieldDefn oFieldDate("date", OFTDateTime);
+                poLayer->CreateField(&oFieldDate);
+
+                const char* const apszStr[] = {
+                    "plain", "quote \" back\\slash /\t\n\x01",
+                    "{ \"a\": [1, 2.5] }", "[not json", "" };
+                for( int i = 0; apszWKT[i] != NULL; i++ )
+                {
+                    OGRFeature oFeature(poLayer->GetLayerDefn());
+                    if( i % 3 != 0 )
+                        oFeature.SetFID(i * 10);
+                    if( i % 4 != 3 )
+                    {
+                        oFeature.SetField(0, i - 5);
+                        oFeature.SetField(1, i % 2);
+                        oFeature.SetField(2, ((GIntBig)1 << 40) * i);
+                        oFeature.SetField(3, i * 1.1 - 3);
+                        oFeature.SetField(4, apszStr[i % 5]);
+                        const int anList[] = { i, -i, 1 };
+                        oFeature.SetField(5, i % 2 == 0 ? 3 : 0, (int*)anList);
+                        const double adfList[] = { i / 3.0, 1e300, -0.0 };
+                        oFeature.SetField(6, 3, (double*)adfList);
+                        char* apszList[] = { (char*)apszStr[i % 5],
+                                             (char*)"b", NULL };
+                        oFeature.SetField(7, apszList);
+                        oFeature.SetField(8, 2016, 1, 2, 3, 4, 5.5f, 100);
+                    }
+                    OGRGeometry* poGeom = NULL;
+                    char* pszWKT = (char*)apszWKT[i];
+                    OGRGeometryFactory::createFromWkt(&pszWKT, NULL, &poGeom);
+                    oFeature.SetGeometryDirectly(poGeom);
+                    CPLPushErrorHandler(CPLQuietErrorHandler);
+                    ensure_equals( poLayer->CreateFeature(&oFeature),
+                                   OGRERR_NONE );
+                    CPLPopErrorHandler();
+                }
+                GDALClose(poDS);
+
+                vsi_l_offset nSize = 0;
+                GByte* pabyData = VSIGetMemFileBuffer(pszFilename, &nSize,
+                                                      FALSE);
+                ensure( pabyData != NULL );
+                aosOutput[iPass].assign((const char*)pabyData, (size_t)nSize);
+                VSIUnlink(pszFilename);
+            }
+            ensure_equals( aosOutput[1], aosOutput[0] );
+        }
+
+        // Exact rounding of coordinates, ties to even
+        OGRPoint oPoint(0.125, -0.375);
+        char* apszOptions[2] = { (char*)"COORDINATE_PRECISION=2", NULL };
+        for( int iPass = 0; iPass < 2; iPass++ )
+        {
+            CPLSetConfigOption("OGR_GEOJSON_DIRECT_WRITE",
+                               iPass == 0 ? "NO" : "YES");
+            char* pszJSon = OGR_G_ExportToJsonEx((OGRGeometryH)&oPoint,
+                                                 apszOptions);
+            ensure( pszJSon != NULL );
+            ensure_equals( std::string(pszJSon),
+                std::string("{ \"type\": \"Point\", \"coordinates\": [ 0.12, -0.38 ] }") );
+            CPLFree(pszJSon);
+        }
+        OGRPoint oEmptyPoint;
+        ensure( OGR_G_ExportToJson((OGRGeometryH)&oEmptyPoint) == NULL );
+
+        CPLSetConfigOption("OGR_GEOJSON_DIRECT_WRITE", NULL);
+    }
+
 } // namespace tut
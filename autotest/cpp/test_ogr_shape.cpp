@@ -414,4 +414,158 @@ namespace tut
         OGR_DS_Destroy(ds);
     }
 
+    // Collect the FIDs of the features with a geometry returned for a set
+    // of spatial filters tiling the layer extent
+    static std::vector<GIntBig> collect_filtered_fids(OGRLayerH lyr,
+                                                      int steps = 4)
+    {
+        OGREnvelope extent;
+        OGR_L_SetSpatialFilter(lyr, NULL);
+        OGR_L_GetExtent(lyr, &extent, TRUE);
+
+        std::vector<GIntBig> fids;
+        const double dx = (extent.MaxX - extent.MinX) / steps;
+        const double dy = (extent.MaxY - extent.MinY) / steps;
+        for (int i = 0; i < steps; i++)
+        {
+            for (int j = 0; j < steps; j++)
+            {
+                OGR_L_SetSpatialFilterRect(lyr,
+                    extent.MinX + i * dx, extent.MinY + j * dy,
+                    extent.MinX + (i + 1.5) * dx, extent.MinY + (j + 1.5) * dy);
+                OGRFeatureH feat = NULL;
+                while (NULL != (feat = OGR_L_GetNextFeature(lyr)))
+                {
+                    // Features without geometry are only returned by the
+                    // non indexed path, as with .qix and .sbn indices
+                    if (NULL != OGR_F_GetGeometryRef(feat))
+                        fids.push_back(OGR_F_GetFID(feat));
+                    OGR_F_Destroy(feat);
+                }
+                fids.push_back(-1);
+            }
+        }
+        OGR_L_SetSpatialFilter(lyr, NULL);
+        return fids;
+    }
+
+    // Test the packed Hilbert R-tree spatial index
+    template<>
+    template<>
+    void object::test<11>()
+    {
+        std::string tmp(data_tmp_);
+        tmp += SEP;
+        tmp += "tpoly.shp";
+        std::string rtx(CPLResetExtension(tmp.c_str(), "rtx"));
+
+        OGRDataSourceH ds = OGR_Dr_Open(drv_, tmp.c_str(), true);
+        ensure("Can't open layer", NULL != ds);
+        OGRLayerH lyr = OGR_DS_GetLayer(ds, 0);
+        ensure("Can't get layer", NULL != lyr);
+
+        std::vector<GIntBig> expected = collect_filtered_fids(lyr);
+
+        OGR_DS_ExecuteSQL(ds, "CREATE SPATIAL INDEX ON tpoly TYPE RTREE",
+                          NULL, NULL);
+        VSIStatBufL sStat;
+        ensure("R-tree index not created", VSIStatL(rtx.c_str(), &sStat) == 0);
+        ensure("Fast spatial filter expected",
+               OGR_L_TestCapability(lyr, OLCFastSpatialFilter) != 0);
+        ensure("Different results with R-tree index",
+               expected == collect_filtered_fids(lyr));
+        OGR_DS_Destroy(ds);
+
+        // Reopen read-only: the index is picked up from the .rtx file
+        ds = OGR_Dr_Open(drv_, tmp.c_str(), false);
+        ensure("Can't open layer", NULL != ds);
+        lyr = OGR_DS_GetLayer(ds, 0);
+        ensure("Fast spatial filter expected",
+               OGR_L_TestCapability(lyr, OLCFastSpatialFilter) != 0);
+        ensure("Different results with R-tree index after reopening",
+               expected == collect_filtered_fids(lyr));
+        OGR_DS_Destroy(ds);
+
+        // Dropping the index removes the file
+        ds = OGR_Dr_Open(drv_, tmp.c_str(), true);
+        ensure("Can't open layer", NULL != ds);
+        OGR_DS_ExecuteSQL(ds, "DROP SPATIAL INDEX ON tpoly", NULL, NULL);
+        ensure("R-tree index not deleted", VSIStatL(rtx.c_str(), &sStat) != 0);
+        OGR_DS_Destroy(ds);
+    }
+
+    // Test the R-tree spatial index on a layer large enough to have
+    // several levels of nodes
+    template<>
+    template<>
+    void object::test<12>()
+    {
+        const char* filename = "/vsimem/test_ogr_shape_rtree.shp";
+        OGRDataSourceH ds = OGR_Dr_CreateDataSource(drv_, filename, NULL);
+        ensure("Can't create datasource", NULL != ds);
+        OGRLayerH lyr = OGR_DS_CreateLayer(ds, "test_ogr_shape_rtree", NULL,
+                                           wkbPolygon, NULL);
+        ensure("Can't create layer", NULL != lyr);
+
+        // Squares of various sizes spread around (0,0), with the first one
+        // degenerated to the origin, and a few features without geometry
+        const int count = 5000;
+        unsigned int seed = 1;
+        for (int i = 0; i < count; i++)
+        {
+            OGRFeatureH feat = OGR_F_Create(OGR_L_GetLayerDefn(lyr));
+            if (i % 97 != 1)
+            {
+                double x = 0.0;
+                double y = 0.0;
+                double size = 0.0;
+                if (i > 0)
+                {
+                    seed = seed * 1103515245U + 12345U;
+                    x = static_cast<int>((seed >> 8) % 20001) / 100.0 - 100.0;
+                    seed = seed * 1103515245U + 12345U;
+                    y = static_cast<int>((seed >> 8) % 20001) / 100.0 - 100.0;
+                    size = (i % 7) * (i % 11) / 10.0;
+                }
+                OGRGeometryH ring = OGR_G_CreateGeometry(wkbLinearRing);
+                OGR_G_AddPoint_2D(ring, x, y);
+                OGR_G_AddPoint_2D(ring, x, y + size);
+                OGR_G_AddPoint_2D(ring, x + size, y + size);
+                OGR_G_AddPoint_2D(ring, x + size, y);
+                OGR_G_AddPoint_2D(ring, x, y);
+                OGRGeometryH poly = OGR_G_CreateGeometry(wkbPolygon);
+                OGR_G_AddGeometryDirectly(poly, ring);
+                OGR_F_SetGeometryDirectly(feat, poly);
+            }
+            ensure_equals("Can't create feature", OGRERR_NONE,
+                          OGR_L_CreateFeature(lyr, feat));
+            OGR_F_Destroy(feat);
+        }
+        OGR_DS_Destroy(ds);
+
+        ds = OGR_Dr_Open(drv_, filename, true);
+        ensure("Can't open layer", NULL != ds);
+        lyr = OGR_DS_GetLayer(ds, 0);
+        std::vector<GIntBig> expected = collect_filtered_fids(lyr, 10);
+
+        OGR_DS_ExecuteSQL(ds, "CREATE SPATIAL INDEX ON test_ogr_shape_rtree "
+                          "TYPE RTREE", NULL, NULL);
+        ensure("Fast spatial filter expected",
+               OGR_L_TestCapability(lyr, OLCFastSpatialFilter) != 0);
+        ensure("Different results with R-tree index",
+               expected == collect_filtered_fids(lyr, 10));
+        OGR_DS_Destroy(ds);
+
+        ds = OGR_Dr_Open(drv_, filename, false);
+        ensure("Can't open layer", NULL != ds);
+        lyr = OGR_DS_GetLayer(ds, 0);
+        ensure("Fast spatial filter expected",
+               OGR_L_TestCapability(lyr, OLCFastSpatialFilter) != 0);
+        ensure("Different results with R-tree index after reopening",
+               expected == collect_filtered_fids(lyr, 10));
+        OGR_DS_Destroy(ds);
+
+        OGR_Dr_DeleteDataSource(drv_, filename);
+    }
+
 } // namespace tut
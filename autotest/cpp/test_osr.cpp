@@ -40,6 +40,8 @@
 #include <tut.h>
 #include <tut_gdal.h>
 #include <ogr_srs_api.h> // OGR/OSR API
+#include <ogr_p.h>
+#include <cpl_csv.h>
 #include <algorithm>
 #include <cmath>
 #include <string>
@@ -361,5 +363,88 @@ namespace tut
         CPLFree(wkt1);
     }
 
+    // Redirects the EPSG support files to an in-memory copy
+    static const char* EPSGDictCSVFilename(const char* pszBasename)
+    {
+        return CPLFormFilename("/vsimem/test_osr_epsg", pszBasename, NULL);
+    }
+
+    // Test the in-process EPSG cache and the binary EPSG dictionary
+    template<>
+    template<>
+    void object::test<8 >()
+    {
+        ensure("SRS handle is NULL", NULL != srs_);
+
+        err_ = OSRImportFromEPSG(srs_, 32631);
+        ensure_equals("OSRImportFromEPSG failed", err_, OGRERR_NONE);
+        char* wkt1 = NULL;
+        OSRExportToWkt(srs_, &wkt1);
+        std::string expect(wkt1);
+        CPLFree(wkt1);
+
+        // A cached definition must not be affected by changes to the
+        // objects built from it.
+        OSRSetProjParm(srs_, SRS_PP_FALSE_EASTING, 0.0);
+        err_ = OSRImportFromEPSG(srs_, 32631);
+        ensure_equals("OSRImportFromEPSG failed", err_, OGRERR_NONE);
+        OSRExportToWkt(srs_, &wkt1);
+        ensure_equals("cached EPSG:32631 not as expected", std::string(wkt1), expect);
+        CPLFree(wkt1);
+
+        CPLString osDataDir = CPLGetPath(CSVFilename("gcs.csv"));
+        if (osDataDir.empty())
+            return;
+
+        const char* const apszFiles[] = {
+            "gcs.csv", "gcs.override.csv", "pcs.csv", "pcs.override.csv",
+            "vertcs.csv", "vertcs.override.csv", "compdcs.csv",
+            "compdcs.override.csv", "geoccs.csv", "ellipsoid.csv",
+            "prime_meridian.csv", "unit_of_measure.csv",
+            "coordinate_axis.csv" };
+        for (size_t i = 0; i < sizeof(apszFiles) / sizeof(char*); i++)
+        {
+            CPLString osSrc = CPLFormFilename(osDataDir, apszFiles[i], NULL);
+            VSIStatBufL sStat;
+            if (VSIStatL(osSrc, &sStat) == 0)
+                CPLCopyFile(EPSGDictCSVFilename(apszFiles[i]), osSrc);
+        }
+
+        SetCSVFilenameHook(EPSGDictCSVFilename);
+
+        err_ = OSRWriteEPSGDictionary("/vsimem/test_osr_epsg/epsg_wkt.bin");
+        ensure_equals("OSRWriteEPSGDictionary failed", err_, OGRERR_NONE);
+
+        // Blank pcs.csv without changing its size, so that EPSG:32631 can
+        // only come from the dictionary.
+        VSIStatBufL sStat;
+        ensure("cannot stat pcs.csv",
+               VSIStatL(EPSGDictCSVFilename("pcs.csv"), &sStat) == 0);
+        std::string osBlank(static_cast<size_t>(sStat.st_size), ' ');
+        VSILFILE* fp = VSIFOpenL(EPSGDictCSVFilename("pcs.csv"), "wb");
+        ensure("cannot write pcs.csv", fp != NULL);
+        VSIFWriteL(osBlank.data(), 1, osBlank.size(), fp);
+        VSIFCloseL(fp);
+        CSVDeaccess(NULL);
+
+        err_ = OSRImportFromEPSG(srs_, 32631);
+        std::string got;
+        if (err_ == OGRERR_NONE)
+        {
+            OSRExportToWkt(srs_, &wkt1);
+            got = wkt1;
+            CPLFree(wkt1);
+        }
+
+        SetCSVFilenameHook(NULL);
+        CSVDeaccess(NULL);
+        for (size_t i = 0; i < sizeof(apszFiles) / sizeof(char*); i++)
+            VSIUnlink(EPSGDictCSVFilename(apszFiles[i]));
+        VSIUnlink("/vsimem/test_osr_epsg/epsg_wkt.bin");
+
+        ensure_equals("OSRImportFromEPSG failed", err_, OGRERR_NONE);
+        ensure_equals("EPSG:32631 from dictionary not as expected", got, expect);
+    }
+
 
 } // namespace tut
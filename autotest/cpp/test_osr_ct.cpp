@@ -41,7 +41,10 @@
 #include <tut_gdal.h>
 #include <ogr_srs_api.h> // OSR
 #include <ogr_api.h> // OGR
+#include <ogr_spatialref.h>
+#include <ogrct_fastpath.h>
 #include <cpl_error.h> // CPL
+#include <cpl_conv.h> // CPL
 #include <algorithm>
 #include <cmath>
 #include <string>
@@ -180,4 +183,152 @@ namespace tut
         OGR_G_DestroyGeometry(geom);
     }
 
+    // Create the same transformation again through the cache
+    template<>
+    template<>
+    void object::test<4>()
+    {
+        ensure("SRS UTM handle is NULL", NULL != srs_utm_);
+        ensure("SRS LL handle is NULL", NULL != srs_ll_);
+
+        err_ = OSRSetUTM(srs_utm_, 11, TRUE);
+        ensure_equals("Can't set UTM zone", err_, OGRERR_NONE);
+
+        err_ = OSRSetWellKnownGeogCS(srs_utm_, "NAD27");
+        ensure_equals("Can't set GeogCS", err_, OGRERR_NONE);
+
+        err_ = OSRSetWellKnownGeogCS(srs_ll_, "WGS84");
+        ensure_equals("Can't set GeogCS", err_, OGRERR_NONE);
+
+        GIntBig nHitsBefore = 0;
+        GIntBig nMissesBefore = 0;
+        OCTGetCacheStatistics(NULL, &nHitsBefore, &nMissesBefore);
+
+        double x[3] = { 0 };
+        double y[3] = { 0 };
+        for( int i = 0; i < 3; i++ )
+        {
+            OGRCoordinateTransformationH ct =
+                OCTNewCoordinateTransformation(srs_ll_, srs_utm_);
+            ensure("PROJ.4 missing, transforms not available", NULL != ct);
+
+            x[i] = -117.5;
+            y[i] = 32.0;
+            ensure_equals("OCTTransform() failed",
+                OCTTransform(ct, 1, &x[i], &y[i], NULL), TRUE);
+            OCTDestroyCoordinateTransformation(ct);
+        }
+
+        ensure_equals("Wrong X from cached transformation", x[1], x[0]);
+        ensure_equals("Wrong Y from cached transformation", y[1], y[0]);
+        ensure_equals("Wrong X from cached transformation", x[2], x[0]);
+        ensure_equals("Wrong Y from cached transformation", y[2], y[0]);
+
+        int nEntries = 0;
+        GIntBig nHits = 0;
+        GIntBig nMisses = 0;
+        OCTGetCacheStatistics(&nEntries, &nHits, &nMisses);
+        ensure("No cached transformation", nEntries > 0);
+        ensure_equals("Wrong cache hits", nHits - nHitsBefore, 2);
+        ensure("Wrong cache misses", nMisses - nMissesBefore <= 1);
+
+        // Disabling the cache
+        CPLSetConfigOption("OGR_CT_CACHE_SIZE", "0");
+        ct_ = OCTNewCoordinateTransformation(srs_ll_, srs_utm_);
+        CPLSetConfigOption("OGR_CT_CACHE_SIZE", NULL);
+        ensure("PROJ.4 missing, transforms not available", NULL != ct_);
+
+        GIntBig nHitsAfter = 0;
+        OCTGetCacheStatistics(NULL, &nHitsAfter, NULL);
+        ensure_equals("Cache used while disabled", nHitsAfter, nHits);
+    }
+
+    // Test the fast path against PROJ.4
+    template<>
+    template<>
+    void object::test<5>()
+    {
+        const char* apszDefns[] = {
+            "+proj=utm +zone=31 +datum=WGS84 +units=m +no_defs",
+            "+proj=utm +zone=33 +south +ellps=intl +units=m +no_defs",
+            "+proj=tmerc +lat_0=49 +lon_0=-2 +k=0.9996012717 +x_0=400000 "
+                "+y_0=-100000 +ellps=airy +units=m +no_defs",
+            "+proj=merc +lon_0=10 +lat_ts=30 +x_0=0 +y_0=0 +datum=WGS84 "
+                "+units=m +no_defs",
+            "+proj=merc +a=6378137 +b=6378137 +lat_ts=0.0 +lon_0=0.0 "
+                "+x_0=0.0 +y_0=0 +k=1.0 +units=m +nadgrids=@null +no_defs"
+        };
+
+        OGRSpatialReference oLL;
+        oLL.SetWellKnownGeogCS("WGS84");
+
+        for( size_t i = 0; i < CPL_ARRAYSIZE(apszDefns); i++ )
+        {
+            OGRSpatialReference oProj;
+            ensure_equals("Can't import PROJ.4 string",
+                          oProj.importFromProj4(apszDefns[i]), OGRERR_NONE);
+            oLL.CopyGeogCSFrom(&oProj);
+
+            double adfX[2][4] = { { 0 } };
+            double adfY[2][4] = { { 0 } };
+            int anSuccess[2] = { 0 };
+            for( int iPass = 0; iPass < 2; iPass++ )
+            {
+                CPLSetConfigOption("OGR_CT_FAST_PATH",
+                                   iPass == 0 ? "YES" : "NO");
+                OGRCoordinateTransformation* poCT =
+                    OGRCreateCoordinateTransformation(&oLL, &oProj);
+                OGRCoordinateTransformation* poInvCT =
+                    OGRCreateCoordinateTransformation(&oProj, &oLL);
+                CPLSetConfigOption("OGR_CT_FAST_PATH", NULL);
+                ensure("PROJ.4 missing, transforms not available",
+                       poCT != NULL && poInvCT != NULL);
+
+                const double dfLon = oProj.GetProjParm(SRS_PP_CENTRAL_MERIDIAN);
+                double* x = adfX[iPass];
+                double* y = adfY[iPass];
+                x[0] = dfLon + 0.5; y[0] = 50.0;
+                x[1] = dfLon - 1.5; y[1] = -20.0;
+                x[2] = dfLon + 2.0; y[2] = 0.0;
+                x[3] = dfLon - 0.25; y[3] = 60.0;
+                anSuccess[iPass] = poCT->Transform(4, x, y) &&
+                                   poInvCT->Transform(2, x + 2, y + 2);
+                delete poCT;
+                delete poInvCT;
+            }
+
+            ensure("Transform() failed", anSuccess[0] && anSuccess[1]);
+            for( int j = 0; j < 4; j++ )
+            {
+                ensure_distance("Wrong X from fast path",
+                                adfX[0][j], adfX[1][j], 1e-9);
+                ensure_distance("Wrong Y from fast path",
+                                adfY[0][j], adfY[1][j], 1e-9);
+            }
+
+            // Check that the first pass did go through the fast path
+            char* pszLLDefn = NULL;
+            char* pszProjDefn = NULL;
+            oLL.exportToProj4(&pszLLDefn);
+            oProj.exportToProj4(&pszProjDefn);
+            OGRProj4FastPath* poFastPath =
+                OGRProj4FastPath::Create(pszLLDefn, pszProjDefn);
+            OGRProj4FastPath* poInvFastPath =
+                OGRProj4FastPath::Create(pszProjDefn, pszLLDefn);
+            CPLFree(pszLLDefn);
+            CPLFree(pszProjDefn);
+            ensure("Fast path not available",
+                   poFastPath != NULL && poInvFastPath != NULL);
+            delete poFastPath;
+            delete poInvFastPath;
+        }
+
+        // Datum shifts are left to PROJ.4
+        OGRProj4FastPath* poFastPath = OGRProj4FastPath::Create(
+            "+proj=longlat +datum=WGS84 +no_defs",
+            "+proj=utm +zone=31 +ellps=intl "
+                "+towgs84=-87,-98,-121,0,0,0,0 +units=m +no_defs");
+        ensure("Unexpected fast path with a datum shift", poFastPath == NULL);
+    }
+
 } // namespace tut
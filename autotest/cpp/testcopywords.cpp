@@ -28,7 +28,14 @@
  ****************************************************************************/
 
 #include <iostream>
+#include <limits>
 #include <gdal.h>
+#include <gdal_priv_templates.hpp>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 char* pIn;
 char* pOut;
@@ -108,6 +115,21 @@ void Test(GDALDataType intype, ConstantType inval, ConstantType invali,
         ASSERT(intype, inval, outtype, outval, *(OutType*)(pOut + GDALGetDataTypeSize(outtype)/8));
         ASSERT(intype, inval, outtype, outval, *(OutType*)(pOut + 2 * GDALGetDataTypeSize(outtype)/8));
         ASSERT(intype, inval, outtype, outval, *(OutType*)(pOut + 3 * GDALGetDataTypeSize(outtype)/8));
+
+        /* Test packed offsets on enough words to use the SSE2 code paths */
+        const int nInSize = GDALGetDataTypeSize(intype)/8;
+        const int nOutSize = GDALGetDataTypeSize(outtype)/8;
+        for( int i = 0; i < 3 * 33; i++ )
+            *(InType*)(pIn + i * nInSize) = (InType)inval;
+        GDALCopyWords(pIn, intype, nInSize, pOut, outtype, nOutSize, 33);
+        for( int i = 0; i < 33; i++ )
+            ASSERT(intype, inval, outtype, outval, *(OutType*)(pOut + i * nOutSize));
+
+        /* Test pixel interleaved to packed */
+        memset(pOut, 0xff, 33 * nOutSize);
+        GDALCopyWords(pIn, intype, 3 * nInSize, pOut, outtype, nOutSize, 33);
+        for( int i = 0; i < 33; i++ )
+            ASSERT(intype, inval, outtype, outval, *(OutType*)(pOut + i * nOutSize));
     }
 }
 
@@ -469,10 +491,159 @@ void check_GDT_CFloat32and64()
     }
 }
 
+/************************************************************************/
+/*                       TestDistinctValues()                           */
+/************************************************************************/
+
+/* Distinct value for the i-th word: a spread of in and out of range values, */
+/* with some rounding ties, extreme values and NaN */
+static double GetDistinctValue(int i)
+{
+    switch( i % 11 )
+    {
+        case 0: return i * 13.0;
+        case 1: return -i * 977.0;
+        case 2: return i * 4001.5;
+        case 3: return 255.5 - i;
+        case 4: return i * 1e7;
+        case 5: return -i * 1e7 - 0.5;
+        case 6: return (i % 2) ? 4294967295.0 : -2147483648.0;
+        case 7: return i + 0.49;
+        case 8: return std::numeric_limits<double>::quiet_NaN();
+        case 9: return 65535.0 + i;
+        default: return -0.5 * i;
+    }
+}
+
+template <class T> static bool IsNaN(T val) { return val != val; }
+
+/* Compare GDALCopyWords() on packed buffers of distinct values against the */
+/* scalar GDALCopyWord(), so that lane order and packing errors of the */
+/* vector code paths are detected */
+template <class InType, class OutType>
+void TestDistinctValues(GDALDataType intype, GDALDataType outtype)
+{
+    const int nWords = 16 * 5 + 7;
+    InType* pInWords = (InType*)pIn;
+    OutType* pOutWords = (OutType*)pOut;
+    for( int nWordCount = 1; nWordCount <= nWords; nWordCount += 5 )
+    {
+        for( int i = 0; i < nWordCount; i++ )
+            GDALCopyWord(GetDistinctValue(i), pInWords[i]);
+        memset(pOut, 0xff, nWords * sizeof(OutType));
+
+        GDALCopyWords(pIn, intype, sizeof(InType),
+                      pOut, outtype, sizeof(OutType), nWordCount);
+
+        for( int i = 0; i < nWordCount; i++ )
+        {
+            /* NaN to integer is undefined in the scalar Float32 code path, */
+            /* which has no vector counterpart to check anyway */
+            if( intype == GDT_Float32 && IsNaN(pInWords[i]) &&
+                std::numeric_limits<OutType>::is_integer )
+                continue;
+            OutType expected;
+            GDALCopyWord(pInWords[i], expected);
+            if( IsNaN(expected) ? !IsNaN(pOutWords[i]) :
+                                  pOutWords[i] != expected )
+            {
+                std::cout << "Test failed for word " << i << " of " <<
+                             nWordCount << " (intype=" <<
+                             GDALGetDataTypeName(intype) << ",inval=" <<
+                             (double)pInWords[i] << ",outtype=" <<
+                             GDALGetDataTypeName(outtype) << ",got " <<
+                             (double)pOutWords[i] << " expected " <<
+                             (double)expected << ")" << std::endl;
+                bErr = TRUE;
+                break;
+            }
+        }
+    }
+}
+
+template <class InType> void TestDistinctValuesFrom(GDALDataType intype)
+{
+    TestDistinctValues<InType, GByte>(intype, GDT_Byte);
+    TestDistinctValues<InType, GInt16>(intype, GDT_Int16);
+    TestDistinctValues<InType, GUInt16>(intype, GDT_UInt16);
+    TestDistinctValues<InType, GInt32>(intype, GDT_Int32);
+    TestDistinctValues<InType, GUInt32>(intype, GDT_UInt32);
+    TestDistinctValues<InType, float>(intype, GDT_Float32);
+    TestDistinctValues<InType, double>(intype, GDT_Float64);
+}
+
+void check_distinct_values()
+{
+    TestDistinctValuesFrom<GByte>(GDT_Byte);
+    TestDistinctValuesFrom<GInt16>(GDT_Int16);
+    TestDistinctValuesFrom<GUInt16>(GDT_UInt16);
+    TestDistinctValuesFrom<GInt32>(GDT_Int32);
+    TestDistinctValuesFrom<GUInt32>(GDT_UInt32);
+    TestDistinctValuesFrom<float>(GDT_Float32);
+    TestDistinctValuesFrom<double>(GDT_Float64);
+}
+
+/************************************************************************/
+/*                    check_interleaved_buffer_end()                    */
+/************************************************************************/
+
+/* Extract each band of a pixel interleaved buffer whose last word is the */
+/* last byte before an unreadable page, so that reads past the end of the */
+/* source crash */
+void check_interleaved_buffer_end()
+{
+    const int nMaxPixels = 16 * 6;
+    for( int nBands = 2; nBands <= 4; nBands++ )
+    {
+        for( int nPixels = 1; nPixels <= nMaxPixels; nPixels++ )
+        {
+            const size_t nSize = (size_t)nPixels * nBands;
+#ifndef WIN32
+            const size_t nPageSize = (size_t)sysconf(_SC_PAGESIZE);
+            const size_t nMapSize = ((nSize + nPageSize - 1) / nPageSize + 1) * nPageSize;
+            GByte* pabyMap = (GByte*)mmap(NULL, nMapSize, PROT_READ | PROT_WRITE,
+                                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if( pabyMap == MAP_FAILED )
+                return;
+            mprotect(pabyMap + nMapSize - nPageSize, nPageSize, PROT_NONE);
+            GByte* pabySrc = pabyMap + nMapSize - nPageSize - nSize;
+#else
+            GByte* pabySrc = (GByte*)malloc(nSize);
+#endif
+            for( size_t i = 0; i < nSize; i++ )
+                pabySrc[i] = (GByte)(i * 7 + i / 251);
+
+            for( int iBand = 0; iBand < nBands; iBand++ )
+            {
+                GByte abyDst[nMaxPixels];
+                GDALCopyWords(pabySrc + iBand, GDT_Byte, nBands,
+                              abyDst, GDT_Byte, 1, nPixels);
+                for( int i = 0; i < nPixels; i++ )
+                {
+                    if( abyDst[i] != pabySrc[i * nBands + iBand] )
+                    {
+                        std::cout << "Test failed for pixel " << i << " of " <<
+                                     nPixels << ", band " << iBand << " of " <<
+                                     nBands << std::endl;
+                        bErr = TRUE;
+                        break;
+                    }
+                }
+            }
+
+#ifndef WIN32
+            munmap(pabyMap, nMapSize);
+#else
+            free(pabySrc);
+#endif
+        }
+    }
+}
+
 int main(int /* argc */, char* /* argv */ [])
 {
-    pIn = (char*)malloc(128);
-    pOut = (char*)malloc(128);
+    pIn = (char*)malloc(3 * 33 * 16);
+    pOut = (char*)malloc(3 * 33 * 16);
 
     check_GDT_Byte();
     check_GDT_Int16();
@@ -483,6 +654,8 @@ int main(int /* argc */, char* /* argv */ [])
     check_GDT_CInt16();
     check_GDT_CInt32();
     check_GDT_CFloat32and64();
+    check_distinct_values();
+    check_interleaved_buffer_end();
 
     free(pIn);
     free(pOut);
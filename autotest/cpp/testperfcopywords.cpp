@@ -29,55 +29,88 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 
 #include "gdal.h"
 
-int main(int /* argc */, char* /* argv */ [])
-{
-    void* in = calloc(1, 256 * 256 * 16);
-    void* out = malloc(256 * 256 * 16);
+#define WORD_COUNT  (256 * 256)
+#define ITERATIONS  1000
 
+/* Time ITERATIONS calls to GDALCopyWords() and report the throughput, */
+/* counting the bytes read and written. */
+static void Bench(const void* in, GDALDataType intype, int instride,
+                  void* out, GDALDataType outtype, int outstride,
+                  const char* pszComment)
+{
+    clock_t start, end;
     int i;
+    double dfSeconds, dfGB;
+
+    start = clock();
+
+    for(i=0;i<ITERATIONS;i++)
+        GDALCopyWords(in, intype, instride, out, outtype, outstride, WORD_COUNT);
+
+    end = clock();
+
+    dfSeconds = (end - start) * 1.0 / CLOCKS_PER_SEC;
+    dfGB = (double)ITERATIONS * WORD_COUNT *
+           (GDALGetDataTypeSizeBytes(intype) + GDALGetDataTypeSizeBytes(outtype)) / 1e9;
+    printf("%s -> %s%s : %.2f s, %.2f GB/s\n",
+           GDALGetDataTypeName(intype),
+           GDALGetDataTypeName(outtype),
+           pszComment,
+           dfSeconds,
+           dfSeconds > 0 ? dfGB / dfSeconds : 0.0);
+}
+
+int main(int argc, char* argv[])
+{
+    void* in = calloc(1, WORD_COUNT * 16 * 4);
+    void* out = malloc(WORD_COUNT * 16 * 4);
+
     int intype, outtype;
+    int bPackedOnly = FALSE;
 
-    clock_t start, end;
+    if( argc == 2 && strcmp(argv[1], "-packed") == 0 )
+        bPackedOnly = TRUE;
+    else if( argc != 1 )
+    {
+        printf("Usage: testperfcopywords [-packed]\n");
+        return 1;
+    }
 
     for(intype=GDT_Byte;intype<=GDT_CFloat64;intype++)
     {
+        const int nInSize = GDALGetDataTypeSizeBytes((GDALDataType)intype);
+
         for(outtype=GDT_Byte;outtype<=GDT_CFloat64;outtype++)
         {
-            start = clock();
+            const int nOutSize = GDALGetDataTypeSizeBytes((GDALDataType)outtype);
 
-            for(i=0;i<1000;i++)
-                GDALCopyWords(in, (GDALDataType)intype, 16, out, (GDALDataType)outtype, 16, 256 * 256);
+            if( !bPackedOnly )
+                Bench(in, (GDALDataType)intype, 16,
+                      out, (GDALDataType)outtype, 16, "");
 
-            end = clock();
+            Bench(in, (GDALDataType)intype, nInSize,
+                  out, (GDALDataType)outtype, nOutSize, " (packed)");
 
-            printf("%s -> %s : %.2f s\n",
-                   GDALGetDataTypeName((GDALDataType)intype),
-                   GDALGetDataTypeName((GDALDataType)outtype),
-                   (end - start) * 1.0 / CLOCKS_PER_SEC);
-
-            start = clock();
-
-            for(i=0;i<1000;i++)
-                GDALCopyWords(in,
-                              (GDALDataType)intype,
-                              GDALGetDataTypeSize((GDALDataType)intype) / 8,
-                              out,
-                              (GDALDataType)outtype, 
-                              GDALGetDataTypeSize((GDALDataType)outtype) / 8,
-                              256 * 256);
-
-            end = clock();
-
-            printf("%s -> %s (packed) : %.2f s\n",
-                   GDALGetDataTypeName((GDALDataType)intype),
-                   GDALGetDataTypeName((GDALDataType)outtype),
-                   (end - start) * 1.0 / CLOCKS_PER_SEC);
+            if( !bPackedOnly && intype == outtype )
+            {
+                /* Extraction of one band of a 3 and 4 band pixel interleaved buffer */
+                Bench(in, (GDALDataType)intype, 3 * nInSize,
+                      out, (GDALDataType)outtype, nOutSize, " (3-band interleaved to packed)");
+                Bench(in, (GDALDataType)intype, 4 * nInSize,
+                      out, (GDALDataType)outtype, nOutSize, " (4-band interleaved to packed)");
+                Bench(in, (GDALDataType)intype, nInSize,
+                      out, (GDALDataType)outtype, 4 * nOutSize, " (packed to 4-band interleaved)");
+            }
         }
     }
 
+    free(in);
+    free(out);
+
     return 0;
 }
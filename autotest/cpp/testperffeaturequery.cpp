@@ -0,0 +1,157 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  OGR
+ * Purpose:  Test performance of attribute filters and SQL expressions,
+ *           with and without their compilation to a flat program.
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include <stdio.h>
+#include <time.h>
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "ogrsf_frmts.h"
+
+#define FEATURE_COUNT 100000
+#define ITERATIONS    10
+
+/* Time ITERATIONS evaluations of a filter on all the features and report */
+/* the throughput in features per second. */
+static void BenchFilter( OGRFeatureDefn* poDefn, OGRFeature** papoFeatures,
+                         const char* pszExpr, bool bCompile )
+{
+    CPLSetConfigOption("OGR_SQL_COMPILE_EXPRESSIONS", bCompile ? NULL : "NO");
+
+    OGRFeatureQuery oQuery;
+    if( oQuery.Compile(poDefn, pszExpr) != OGRERR_NONE )
+        return;
+
+    int nMatches = 0;
+    clock_t start = clock();
+    for( int iIter = 0; iIter < ITERATIONS; iIter++ )
+    {
+        for( int i = 0; i < FEATURE_COUNT; i++ )
+        {
+            if( oQuery.Evaluate(papoFeatures[i]) )
+                nMatches++;
+        }
+    }
+    clock_t end = clock();
+
+    double dfSeconds = (end - start) * 1.0 / CLOCKS_PER_SEC;
+    printf("%-45s %-8s : %.2f s, %.2f Mfeatures/s (%d matches)\n",
+           pszExpr, bCompile ? "compiled" : "tree", dfSeconds,
+           (double)ITERATIONS * FEATURE_COUNT / 1e6 / dfSeconds,
+           nMatches / ITERATIONS);
+}
+
+/* Time a SQL request with computed columns on a memory layer. */
+static void BenchSQL( GDALDataset* poDS, const char* pszSQL, bool bCompile )
+{
+    CPLSetConfigOption("OGR_SQL_COMPILE_EXPRESSIONS", bCompile ? NULL : "NO");
+
+    int nFeatures = 0;
+    clock_t start = clock();
+    for( int iIter = 0; iIter < ITERATIONS; iIter++ )
+    {
+        OGRLayer* poSQLLayer = poDS->ExecuteSQL(pszSQL, NULL, NULL);
+        if( poSQLLayer == NULL )
+            return;
+        OGRFeature* poFeature;
+        while( (poFeature = poSQLLayer->GetNextFeature()) != NULL )
+        {
+            nFeatures++;
+            delete poFeature;
+        }
+        poDS->ReleaseResultSet(poSQLLayer);
+    }
+    clock_t end = clock();
+
+    double dfSeconds = (end - start) * 1.0 / CLOCKS_PER_SEC;
+    printf("%-45s %-8s : %.2f s, %.2f Mfeatures/s\n",
+           "SQL", bCompile ? "compiled" : "tree", dfSeconds,
+           (double)nFeatures / 1e6 / dfSeconds);
+}
+
+int main(int /* argc */, char* /* argv */ [])
+{
+    GDALAllRegister();
+
+    GDALDriver* poMemDrv = GetGDALDriverManager()->GetDriverByName("Memory");
+    if( poMemDrv == NULL )
+        return 1;
+    GDALDataset* poDS = poMemDrv->Create("", 0, 0, 0, GDT_Unknown, NULL);
+    OGRLayer* poLayer = poDS->CreateLayer("test");
+    OGRFieldDefn oFieldInt("int", OFTInteger);
+    poLayer->CreateField(&oFieldInt);
+    OGRFieldDefn oFieldReal("real", OFTReal);
+    poLayer->CreateField(&oFieldReal);
+    OGRFieldDefn oFieldStr("str", OFTString);
+    poLayer->CreateField(&oFieldStr);
+    OGRFeatureDefn* poDefn = poLayer->GetLayerDefn();
+
+    const char* const apszStr[] = { "residential", "primary", "secondary",
+                                    "tertiary", "footway" };
+    OGRFeature** papoFeatures = new OGRFeature*[FEATURE_COUNT];
+    for( int i = 0; i < FEATURE_COUNT; i++ )
+    {
+        papoFeatures[i] = new OGRFeature(poDefn);
+        papoFeatures[i]->SetField(0, i % 1000);
+        if( i % 10 != 0 )
+            papoFeatures[i]->SetField(1, i * 0.01);
+        papoFeatures[i]->SetField(2, apszStr[i % 5]);
+        if( poLayer->CreateFeature(papoFeatures[i]) != OGRERR_NONE )
+            return 1;
+    }
+
+    const char* const apszExpr[] = {
+        "int > 500",
+        "int >= 100 AND real < 500.5",
+        "str = 'primary' OR str = 'secondary'",
+        "str IN ('primary', 'tertiary') AND int BETWEEN 10 AND 900",
+        "str LIKE '%ary' AND NOT real IS NULL",
+        "real / 3 + int * 2 > 1000",
+    };
+    for( size_t iExpr = 0; iExpr < sizeof(apszExpr) / sizeof(apszExpr[0]);
+         iExpr++ )
+    {
+        BenchFilter(poDefn, papoFeatures, apszExpr[iExpr], false);
+        BenchFilter(poDefn, papoFeatures, apszExpr[iExpr], true);
+    }
+
+    const char* pszSQL = "SELECT int * 3 + 1, real / 2, int > real, "
+                         "str LIKE 'p%' FROM test WHERE int % 3 = 0";
+    BenchSQL(poDS, pszSQL, false);
+    BenchSQL(poDS, pszSQL, true);
+
+    CPLSetConfigOption("OGR_SQL_COMPILE_EXPRESSIONS", NULL);
+
+    for( int i = 0; i < FEATURE_COUNT; i++ )
+        delete papoFeatures[i];
+    delete[] papoFeatures;
+    GDALClose(poDS);
+
+    return 0;
+}
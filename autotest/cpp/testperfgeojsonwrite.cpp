@@ -0,0 +1,136 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  OGR
+ * Purpose:  Test performance of the GeoJSON writer, with and without
+ *           direct text output.
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+#include "ogrsf_frmts.h"
+
+#define FEATURE_COUNT 20000
+#define RING_POINTS   100
+
+/* Write all the features to a /vsimem GeoJSON file and report the output */
+/* throughput in MB per second. */
+static void BenchWrite( OGRFeature** papoFeatures, const char* pszLCO,
+                        bool bDirect )
+{
+    CPLSetConfigOption("OGR_GEOJSON_DIRECT_WRITE", bDirect ? NULL : "NO");
+
+    const char* pszFilename = "/vsimem/testperfgeojsonwrite.json";
+    GDALDriver* poDriver = GetGDALDriverManager()->GetDriverByName("GeoJSON");
+    clock_t start = clock();
+    GDALDataset* poDS = poDriver->Create(pszFilename, 0, 0, 0, GDT_Unknown,
+                                         NULL);
+    if( poDS == NULL )
+        return;
+    char* apszOptions[2] = { (char*)pszLCO, NULL };
+    OGRLayer* poLayer = poDS->CreateLayer("test", NULL, wkbPolygon,
+                                          pszLCO ? apszOptions : NULL);
+    OGRFeatureDefn* poSrcDefn = papoFeatures[0]->GetDefnRef();
+    for( int i = 0; i < poSrcDefn->GetFieldCount(); i++ )
+        poLayer->CreateField(poSrcDefn->GetFieldDefn(i));
+    for( int i = 0; i < FEATURE_COUNT; i++ )
+    {
+        if( poLayer->CreateFeature(papoFeatures[i]) != OGRERR_NONE )
+            break;
+    }
+    GDALClose(poDS);
+    clock_t end = clock();
+
+    VSIStatBufL sStat;
+    if( VSIStatL(pszFilename, &sStat) != 0 )
+        sStat.st_size = 0;
+    VSIUnlink(pszFilename);
+
+    double dfSeconds = (end - start) * 1.0 / CLOCKS_PER_SEC;
+    printf("%-25s %-6s : %.2f s, %.1f MB, %.1f MB/s\n",
+           pszLCO ? pszLCO : "default", bDirect ? "direct" : "json-c",
+           dfSeconds, sStat.st_size / 1e6, sStat.st_size / 1e6 / dfSeconds);
+}
+
+int main(int /* argc */, char* /* argv */ [])
+{
+    GDALAllRegister();
+
+    OGRFeatureDefn* poDefn = new OGRFeatureDefn("test");
+    poDefn->Reference();
+    OGRFieldDefn oFieldInt("id", OFTInteger);
+    poDefn->AddFieldDefn(&oFieldInt);
+    OGRFieldDefn oFieldReal("area", OFTReal);
+    poDefn->AddFieldDefn(&oFieldReal);
+    OGRFieldDefn oFieldStr("name", OFTString);
+    poDefn->AddFieldDefn(&oFieldStr);
+
+    /* Polygons with a ring of RING_POINTS vertices in geographic */
+    /* coordinates, with full double precision. */
+    OGRFeature** papoFeatures = new OGRFeature*[FEATURE_COUNT];
+    for( int i = 0; i < FEATURE_COUNT; i++ )
+    {
+        papoFeatures[i] = new OGRFeature(poDefn);
+        papoFeatures[i]->SetFID(i);
+        papoFeatures[i]->SetField(0, i);
+        papoFeatures[i]->SetField(1, i * 0.37 + 1.0 / 3);
+        papoFeatures[i]->SetField(2, CPLSPrintf("parcel %d", i));
+
+        const double dfCenterX = -120.0 + (i % 200) * 0.01;
+        const double dfCenterY = 35.0 + (i / 200) * 0.01;
+        OGRLinearRing* poRing = new OGRLinearRing();
+        for( int j = 0; j < RING_POINTS; j++ )
+        {
+            const double dfAngle = 2 * M_PI * j / RING_POINTS;
+            poRing->addPoint(dfCenterX + 0.004 * cos(dfAngle),
+                             dfCenterY + 0.004 * sin(dfAngle));
+        }
+        poRing->closeRings();
+        OGRPolygon* poPolygon = new OGRPolygon();
+        poPolygon->addRingDirectly(poRing);
+        papoFeatures[i]->SetGeometryDirectly(poPolygon);
+    }
+
+    const char* const apszLCO[] = { NULL, "COORDINATE_PRECISION=7",
+                                    "SIGNIFICANT_FIGURES=10" };
+    for( size_t i = 0; i < sizeof(apszLCO) / sizeof(apszLCO[0]); i++ )
+    {
+        BenchWrite(papoFeatures, apszLCO[i], false);
+        BenchWrite(papoFeatures, apszLCO[i], true);
+    }
+
+    CPLSetConfigOption("OGR_GEOJSON_DIRECT_WRITE", NULL);
+
+    for( int i = 0; i < FEATURE_COUNT; i++ )
+        delete papoFeatures[i];
+    delete[] papoFeatures;
+    poDefn->Release();
+
+    return 0;
+}
@@ -0,0 +1,203 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL algorithms
+ * Purpose:  Test performance of the bilinear and cubic resampling of
+ *           GDALWarpKernel, with and without its vectorized code paths.
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "gdalwarper.h"
+
+#define SRC_SIZE    1024
+#define DST_SIZE    1000
+#define DST_SIZE_DOWN 300
+#define ITERATIONS  10
+
+/* A slight rotation, so that the source is fully covered and the 4 */
+/* sample formulas are used. */
+static int RotationTransform( void *, int bDstToSrc, int nPointCount,
+                              double *x, double *y, double *,
+                              int *panSuccess )
+{
+    int i;
+    for( i = 0; i < nPointCount; i++ )
+    {
+        const double dfX = x[i];
+        if( bDstToSrc )
+        {
+            x[i] = 12.3 + 0.998 * dfX + 0.01 * y[i];
+            y[i] = 8.7 - 0.01 * dfX + 0.998 * y[i];
+        }
+        panSuccess[i] = bDstToSrc;
+    }
+    return TRUE;
+}
+
+/* Downsampling of the SRC_SIZE x SRC_SIZE source to DST_SIZE_DOWN x */
+/* DST_SIZE_DOWN, for the separable filters. */
+static int ScaleTransform( void *, int bDstToSrc, int nPointCount,
+                           double *x, double *y, double *,
+                           int *panSuccess )
+{
+    int i;
+    for( i = 0; i < nPointCount; i++ )
+    {
+        if( bDstToSrc )
+        {
+            x[i] *= (double)SRC_SIZE / DST_SIZE_DOWN;
+            y[i] *= (double)SRC_SIZE / DST_SIZE_DOWN;
+        }
+        panSuccess[i] = bDstToSrc;
+    }
+    return TRUE;
+}
+
+/* Time ITERATIONS warps of a DST_SIZE x DST_SIZE image and report the */
+/* throughput in destination pixels per second. */
+static void Bench( GByte* pabySrc, GByte* pabyDst, GDALDataType eDT,
+                   GDALResampleAlg eResample, const char* pszResampling,
+                   const char* pszImpl )
+{
+    GDALWarpKernel oWK;
+    oWK.eResample = eResample;
+    oWK.eWorkingDataType = eDT;
+    oWK.nBands = 1;
+    oWK.nSrcXSize = SRC_SIZE;
+    oWK.nSrcYSize = SRC_SIZE;
+    oWK.papabySrcImage = &pabySrc;
+    oWK.nDstXSize = DST_SIZE;
+    oWK.nDstYSize = DST_SIZE;
+    oWK.papabyDstImage = &pabyDst;
+    oWK.pfnTransformer = RotationTransform;
+
+    clock_t start = clock();
+    int i;
+    for( i = 0; i < ITERATIONS; i++ )
+        oWK.PerformWarp();
+    clock_t end = clock();
+
+    double dfSeconds = (end - start) * 1.0 / CLOCKS_PER_SEC;
+    printf("%-8s %-9s %-7s : %.2f s, %.1f Mpixels/s\n",
+           GDALGetDataTypeName(eDT), pszResampling, pszImpl, dfSeconds,
+           (double)ITERATIONS * DST_SIZE * DST_SIZE / 1e6 / dfSeconds);
+}
+
+/* Time ITERATIONS downsampling warps with a separable transformation, */
+/* with and without the two pass convolution. */
+static void BenchSeparable( GByte* pabySrc, GByte* pabyDst, GDALDataType eDT,
+                            GDALResampleAlg eResample,
+                            const char* pszResampling, bool bSeparable )
+{
+    GDALWarpKernel oWK;
+    oWK.eResample = eResample;
+    oWK.eWorkingDataType = eDT;
+    oWK.nBands = 1;
+    oWK.nSrcXSize = SRC_SIZE;
+    oWK.nSrcYSize = SRC_SIZE;
+    oWK.papabySrcImage = &pabySrc;
+    oWK.nDstXSize = DST_SIZE_DOWN;
+    oWK.nDstYSize = DST_SIZE_DOWN;
+    oWK.papabyDstImage = &pabyDst;
+    oWK.pfnTransformer = ScaleTransform;
+    oWK.papszWarpOptions = CSLSetNameValue(NULL, "EXTRA_ELTS",
+                                           CPLSPrintf("%d", WARP_EXTRA_ELTS));
+    oWK.papszWarpOptions = CSLSetNameValue(oWK.papszWarpOptions,
+                                           "USE_SEPARABLE_FILTER",
+                                           bSeparable ? "YES" : "NO");
+
+    clock_t start = clock();
+    int i;
+    for( i = 0; i < ITERATIONS; i++ )
+        oWK.PerformWarp();
+    clock_t end = clock();
+    CSLDestroy(oWK.papszWarpOptions);
+
+    double dfSeconds = (end - start) * 1.0 / CLOCKS_PER_SEC;
+    printf("%-8s %-11s %-9s : %.2f s, %.1f Mpixels/s\n",
+           GDALGetDataTypeName(eDT), pszResampling,
+           bSeparable ? "separable" : "per-pixel", dfSeconds,
+           (double)ITERATIONS * DST_SIZE_DOWN * DST_SIZE_DOWN / 1e6 / dfSeconds);
+}
+
+int main(int /* argc */, char* /* argv */ [])
+{
+    const GDALDataType aeDT[] = { GDT_Byte, GDT_UInt16, GDT_Int16,
+                                  GDT_Float32 };
+    const GDALResampleAlg aeResample[] = { GRA_Bilinear, GRA_Cubic };
+    const char* const apszResampling[] = { "bilinear", "cubic" };
+
+    GByte* pabySrc = (GByte*)CPLMalloc((SRC_SIZE * SRC_SIZE + WARP_EXTRA_ELTS) * 4);
+    GByte* pabyDst = (GByte*)CPLMalloc(DST_SIZE * DST_SIZE * 4);
+    int i, iDT, iResample;
+    for( i = 0; i < (SRC_SIZE * SRC_SIZE + WARP_EXTRA_ELTS) * 4; i++ )
+        pabySrc[i] = (GByte)(i * 7 + (i >> 10));
+
+    for( iDT = 0; iDT < 4; iDT++ )
+    {
+        if( aeDT[iDT] == GDT_Float32 )
+        {
+            for( i = 0; i < SRC_SIZE * SRC_SIZE; i++ )
+                ((float*)pabySrc)[i] = (float)(i % 1000);
+        }
+        for( iResample = 0; iResample < 2; iResample++ )
+        {
+            CPLSetConfigOption("GDAL_USE_AVX2", "NO");
+            CPLSetConfigOption("GDAL_USE_SSE2", "NO");
+            Bench(pabySrc, pabyDst, aeDT[iDT], aeResample[iResample],
+                  apszResampling[iResample], "scalar");
+            CPLSetConfigOption("GDAL_USE_SSE2", NULL);
+            Bench(pabySrc, pabyDst, aeDT[iDT], aeResample[iResample],
+                  apszResampling[iResample], "SSE2");
+            CPLSetConfigOption("GDAL_USE_AVX2", NULL);
+            Bench(pabySrc, pabyDst, aeDT[iDT], aeResample[iResample],
+                  apszResampling[iResample], "default");
+        }
+    }
+
+    const GDALResampleAlg aeResampleSep[] = { GRA_Cubic, GRA_CubicSpline,
+                                              GRA_Lanczos };
+    const char* const apszResamplingSep[] = { "cubic", "cubicspline",
+                                              "lanczos" };
+    for( iDT = 0; iDT < 4; iDT++ )
+    {
+        for( iResample = 0; iResample < 3; iResample++ )
+        {
+            BenchSeparable(pabySrc, pabyDst, aeDT[iDT], aeResampleSep[iResample],
+                           apszResamplingSep[iResample], false);
+            BenchSeparable(pabySrc, pabyDst, aeDT[iDT], aeResampleSep[iResample],
+                           apszResamplingSep[iResample], true);
+        }
+    }
+
+    CPLFree(pabySrc);
+    CPLFree(pabyDst);
+    return 0;
+}
@@ -2079,6 +2079,40 @@ def tiff_ovr_52():
 
     return 'success'
 
+###############################################################################
+# Test multi-threaded overview computation, with GDAL_NUM_THREADS and with
+# the NUM_THREADS open option
+
+def tiff_ovr_53():
+
+    src_ds = gdal.Open('data/byte.tif')
+    for interleave in [ 'BAND', 'PIXEL' ]:
+        for resampling in [ 'NEAR', 'AVERAGE', 'CUBIC' ]:
+            ref_cs = None
+            for (config_threads, open_threads) in [ (None, None), ('4', None), (None, 'ALL_CPUS') ]:
+                mem_ds = gdal.GetDriverByName('MEM').Create('', 20, 20, 3)
+                for i in range(3):
+                    mem_ds.GetRasterBand(i+1).WriteRaster(0, 0, 20, 20, src_ds.ReadRaster(0, 0, 20, 20))
+                gdal.GetDriverByName('GTiff').CreateCopy('/vsimem/tiff_ovr_53.tif', mem_ds, options = [ 'INTERLEAVE=' + interleave ])
+                open_options = []
+                if open_threads is not None:
+                    open_options = [ 'NUM_THREADS=' + open_threads ]
+                ds = gdal.OpenEx('/vsimem/tiff_ovr_53.tif', gdal.OF_UPDATE, open_options = open_options)
+                gdal.SetConfigOption('GDAL_NUM_THREADS', config_threads)
+                ds.BuildOverviews(resampling, [2, 4])
+                gdal.SetConfigOption('GDAL_NUM_THREADS', None)
+                cs = [ ds.GetRasterBand(i+1).GetOverview(j).Checksum() for i in range(3) for j in range(2) ]
+                ds = None
+                gdal.GetDriverByName('GTiff').Delete('/vsimem/tiff_ovr_53.tif')
+                if ref_cs is None:
+                    ref_cs = cs
+                elif cs != ref_cs:
+                    gdaltest.post_reason('fail')
+                    print(interleave, resampling, config_threads, open_threads, cs, ref_cs)
+                    return 'fail'
+
+    return 'success'
+
 ###############################################################################
 # Cleanup
 
@@ -2195,7 +2229,8 @@ for item in gdaltest_list_internal:
 gdaltest_list.append(tiff_ovr_restore_endianness)
 
 gdaltest_list += [ tiff_ovr_51,
-                   tiff_ovr_52 ]
+                   tiff_ovr_52,
+                   tiff_ovr_53 ]
 
 if __name__ == '__main__':
 
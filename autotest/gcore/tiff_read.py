@@ -2502,6 +2502,47 @@ def tiff_read_one_strip_no_bytecount():
 
     return 'success'
 
+###############################################################################
+# Test multi-threaded decoding with the NUM_THREADS open option
+
+def tiff_read_multi_threaded():
+
+    src_ds = gdal.Open('data/rgbsmall.tif')
+    expected_cs = [ src_ds.GetRasterBand(i+1).Checksum() for i in range(3) ]
+
+    for options in [ ['TILED=YES', 'BLOCKXSIZE=16', 'BLOCKYSIZE=16', 'COMPRESS=DEFLATE'],
+                     ['TILED=YES', 'BLOCKXSIZE=16', 'BLOCKYSIZE=16', 'COMPRESS=LZW', 'INTERLEAVE=BAND'],
+                     ['BLOCKYSIZE=4', 'COMPRESS=PACKBITS'] ]:
+        gdaltest.tiff_drv.CreateCopy('/vsimem/tiff_read_multi_threaded.tif', src_ds, options = options)
+
+        ds = gdal.OpenEx('/vsimem/tiff_read_multi_threaded.tif', open_options = ['NUM_THREADS=4'])
+        # Dataset level request, then band level request on a fresh dataset
+        data = ds.ReadRaster(0, 0, ds.RasterXSize, ds.RasterYSize)
+        cs = [ ds.GetRasterBand(i+1).Checksum() for i in range(3) ]
+        ds = None
+        if cs != expected_cs:
+            gdaltest.post_reason('fail')
+            print(options)
+            print(cs)
+            return 'fail'
+
+        ds = gdal.OpenEx('/vsimem/tiff_read_multi_threaded.tif', open_options = ['NUM_THREADS=4'])
+        cs = [ ds.GetRasterBand(i+1).Checksum() for i in range(3) ]
+        if ds.ReadRaster(0, 0, ds.RasterXSize, ds.RasterYSize) != data:
+            gdaltest.post_reason('fail')
+            print(options)
+            return 'fail'
+        ds = None
+        if cs != expected_cs:
+            gdaltest.post_reason('fail')
+            print(options)
+            print(cs)
+            return 'fail'
+
+    gdaltest.tiff_drv.Delete('/vsimem/tiff_read_multi_threaded.tif')
+
+    return 'success'
+
 ###############################################################################
 
 for item in init_list:
@@ -2564,6 +2605,7 @@ gdaltest_list.append( (tiff_read_logl_as_rgba) )
 gdaltest_list.append( (tiff_read_scanline_more_than_2GB) )
 gdaltest_list.append( (tiff_read_wrong_number_extrasamples) )
 gdaltest_list.append( (tiff_read_one_strip_no_bytecount) )
+gdaltest_list.append( (tiff_read_multi_threaded) )
 
 gdaltest_list.append( (tiff_read_online_1) )
 gdaltest_list.append( (tiff_read_online_2) )
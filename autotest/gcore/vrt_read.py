@@ -33,6 +33,7 @@
 import os
 import sys
 import shutil
+import struct
 
 sys.path.append( '../pymod' )
 
@@ -1091,6 +1092,233 @@ def vrt_read_24():
 
     return 'success'
 
+###############################################################################
+# Test reading a mosaic with enough sources to trigger the source index,
+# including overlapping sources whose order must be preserved.
+
+def vrt_read_25():
+
+    src_ds = gdal.Open('data/byte.tif')
+    src_data = src_ds.ReadRaster(0,0,20,20)
+    src_ds = None
+
+    mem_ds = gdal.GetDriverByName('MEM').Create('', 205, 203)
+
+    xml = '<VRTDataset rasterXSize="205" rasterYSize="203"><VRTRasterBand dataType="Byte" band="1">'
+    sources = []
+    for j in range(10):
+        for i in range(10):
+            sources.append( (i * 20, j * 20) )
+    # Overlapping sources, including ones partially outside the raster
+    for k in range(20):
+        sources.append( ((k * 37) % 200 - 7, (k * 53) % 200 - 5) )
+    for (x, y) in sources:
+        xml += '<SimpleSource><SourceFilename relativeToVRT="0">data/byte.tif</SourceFilename>'
+        xml += '<SourceBand>1</SourceBand><SrcRect xOff="0" yOff="0" xSize="20" ySize="20"/>'
+        xml += '<DstRect xOff="%d" yOff="%d" xSize="20" ySize="20"/></SimpleSource>' % (x, y)
+        xoff = max(x, 0)
+        yoff = max(y, 0)
+        xsize = min(x + 20, 205) - xoff
+        ysize = min(y + 20, 203) - yoff
+        tmp_ds = gdal.GetDriverByName('MEM').Create('', 20, 20)
+        tmp_ds.WriteRaster(0,0,20,20,src_data)
+        mem_ds.WriteRaster(xoff, yoff, xsize, ysize,
+                           tmp_ds.ReadRaster(xoff - x, yoff - y, xsize, ysize))
+        tmp_ds = None
+    xml += '</VRTRasterBand></VRTDataset>'
+
+    ds = gdal.Open(xml)
+    if ds.GetRasterBand(1).Checksum() != mem_ds.GetRasterBand(1).Checksum():
+        gdaltest.post_reason('failure')
+        print(ds.GetRasterBand(1).Checksum())
+        print(mem_ds.GetRasterBand(1).Checksum())
+        return 'fail'
+
+    for (xoff, yoff, xsize, ysize) in [ (0, 0, 1, 1), (13, 17, 31, 29),
+                                        (190, 180, 15, 23), (60, 0, 40, 203) ]:
+        if ds.ReadRaster(xoff, yoff, xsize, ysize) != \
+           mem_ds.ReadRaster(xoff, yoff, xsize, ysize):
+            gdaltest.post_reason('failure')
+            print(xoff, yoff, xsize, ysize)
+            return 'fail'
+        if ds.GetRasterBand(1).ReadRaster(xoff, yoff, xsize, ysize) != \
+           mem_ds.GetRasterBand(1).ReadRaster(xoff, yoff, xsize, ysize):
+            gdaltest.post_reason('failure')
+            print(xoff, yoff, xsize, ysize)
+            return 'fail'
+
+    ds = None
+    mem_ds = None
+
+    return 'success'
+
+###############################################################################
+# Test VRT_LAZY_SOURCE_OPENING
+
+def vrt_read_26():
+
+    gdal.SetConfigOption('VRT_LAZY_SOURCE_OPENING', 'YES')
+
+    # Opening succeeds, but reading the missing source fails
+    ds = gdal.Open('data/idontexist.vrt')
+    if ds is None:
+        gdal.SetConfigOption('VRT_LAZY_SOURCE_OPENING', None)
+        gdaltest.post_reason('failure')
+        return 'fail'
+    gdal.PushErrorHandler('CPLQuietErrorHandler')
+    data = ds.ReadRaster(0,0,20,20)
+    gdal.PopErrorHandler()
+    ds = None
+    if data is not None:
+        gdal.SetConfigOption('VRT_LAZY_SOURCE_OPENING', None)
+        gdaltest.post_reason('failure')
+        return 'fail'
+
+    # The file list is known without opening the source
+    ds = gdal.Open('data/byte.vrt')
+    filelist = ds.GetFileList()
+    cs = ds.GetRasterBand(1).Checksum()
+    ds = None
+
+    gdal.SetConfigOption('VRT_LAZY_SOURCE_OPENING', None)
+
+    if len(filelist) != 2:
+        gdaltest.post_reason('failure')
+        print(filelist)
+        return 'fail'
+
+    if cs != 4672:
+        gdaltest.post_reason('failure')
+        print(cs)
+        return 'fail'
+
+    return 'success'
+
+###############################################################################
+# Test the binary encoding of VRT files (.vrtb)
+
+def vrt_read_27():
+
+    src_ds = gdal.Open('data/byte.vrt')
+    ds = gdal.GetDriverByName('VRT').CreateCopy('/vsimem/vrt_read_27.vrtb',
+                                                src_ds)
+    ds = None
+    src_ds = None
+
+    f = gdal.VSIFOpenL('/vsimem/vrt_read_27.vrtb', 'rb')
+    data = gdal.VSIFReadL(1, 100000, f)
+    gdal.VSIFCloseL(f)
+    if data[0:8].decode('ascii') != 'GDALVRTB':
+        gdaltest.post_reason('failure')
+        return 'fail'
+
+    ds = gdal.Open('/vsimem/vrt_read_27.vrtb')
+    if ds is None or ds.GetDriver().ShortName != 'VRT':
+        gdaltest.post_reason('failure')
+        return 'fail'
+    cs = ds.GetRasterBand(1).Checksum()
+    nodata = ds.GetRasterBand(1).GetNoDataValue()
+    md = ds.GetMetadataItem('test')
+    ds = None
+
+    if cs != 4672 or nodata != 107 or md != 'testvalue':
+        gdaltest.post_reason('failure')
+        print(cs, nodata, md)
+        return 'fail'
+
+    # Truncated file
+    f = gdal.VSIFOpenL('/vsimem/vrt_read_27_truncated.vrtb', 'wb')
+    gdal.VSIFWriteL(data[0:len(data)-1], 1, len(data)-1, f)
+    gdal.VSIFCloseL(f)
+    with gdaltest.error_handler():
+        ds = gdal.Open('/vsimem/vrt_read_27_truncated.vrtb')
+    if ds is not None:
+        gdaltest.post_reason('failure')
+        return 'fail'
+
+    # Warped VRT, whose XMLInit() edits the decoded tree
+    ds = gdal.Warp('/vsimem/vrt_read_27_warped.vrtb', 'data/byte.tif',
+                   format='VRT')
+    ds = None
+    ds = gdal.Open('/vsimem/vrt_read_27_warped.vrtb')
+    if ds is None or \
+       ds.GetMetadata('xml:VRT')[0].find('VRTWarpedDataset') < 0:
+        gdaltest.post_reason('failure')
+        return 'fail'
+    cs = ds.GetRasterBand(1).Checksum()
+    ds = None
+    if cs != 4672:
+        gdaltest.post_reason('failure')
+        print(cs)
+        return 'fail'
+
+    gdal.Unlink('/vsimem/vrt_read_27.vrtb')
+    gdal.Unlink('/vsimem/vrt_read_27_truncated.vrtb')
+    gdal.Unlink('/vsimem/vrt_read_27_warped.vrtb')
+
+    return 'success'
+
+###############################################################################
+# Test built-in pixel functions and expressions of derived bands
+
+def vrt_read_28():
+
+    src_ds = gdal.Open('data/byte.tif')
+    src_data = struct.unpack('B' * 400, src_ds.ReadRaster())
+    src_ds = None
+
+    template = """<VRTDataset rasterXSize="20" rasterYSize="20">
+  <VRTRasterBand dataType="Float32" band="1" subClass="VRTDerivedRasterBand">
+    %s
+    <SimpleSource>
+      <SourceFilename relativeToVRT="0">data/byte.tif</SourceFilename>
+      <SourceBand>1</SourceBand>
+    </SimpleSource>
+    <SimpleSource>
+      <SourceFilename relativeToVRT="0">data/byte.tif</SourceFilename>
+      <SourceBand>1</SourceBand>
+    </SimpleSource>
+  </VRTRasterBand>
+</VRTDataset>"""
+
+    tests = [ ('<PixelFunctionType>sum</PixelFunctionType>',
+               lambda x: 2 * x),
+              ('<PixelFunctionType>diff</PixelFunctionType>',
+               lambda x: 0),
+              ('<PixelFunctionExpression>(B1 - 100) / (B2 + 1)</PixelFunctionExpression>',
+               lambda x: (x - 100.0) / (x + 1)),
+              ('<PixelFunctionExpression>if(B1 &gt; 140 &amp;&amp; B2 != 173, -B1, 2^2)</PixelFunctionExpression>',
+               lambda x: -x if x > 140 and x != 173 else 4),
+              ('<PixelFunctionExpression>B1 + B2</PixelFunctionExpression><NoDataValue>107</NoDataValue>',
+               lambda x: 107 if x == 107 else 2 * x) ]
+
+    for (extra, func) in tests:
+        ds = gdal.Open(template % extra)
+        data = struct.unpack('f' * 400, ds.ReadRaster())
+        ds = None
+        for i in range(400):
+            if abs(data[i] - func(src_data[i])) > 1e-5:
+                gdaltest.post_reason('failure')
+                print(extra, i, src_data[i], data[i])
+                return 'fail'
+
+    # Invalid expression
+    with gdaltest.error_handler():
+        ds = gdal.Open(template % '<PixelFunctionExpression>B1 +</PixelFunctionExpression>')
+    if ds is not None:
+        gdaltest.post_reason('failure')
+        return 'fail'
+
+    # Reference to a missing source
+    ds = gdal.Open(template % '<PixelFunctionExpression>B3</PixelFunctionExpression>')
+    with gdaltest.error_handler():
+        cs = ds.GetRasterBand(1).Checksum()
+    if cs != -1 and gdal.GetLastErrorMsg().find('B3') < 0:
+        gdaltest.post_reason('failure')
+        return 'fail'
+
+    return 'success'
+
 for item in init_list:
     ut = gdaltest.GDALTest( 'VRT', item[0], item[1], item[2] )
     if ut is None:
@@ -1122,6 +1350,10 @@ gdaltest_list.append( vrt_read_21 )
 gdaltest_list.append( vrt_read_22 )
 gdaltest_list.append( vrt_read_23 )
 gdaltest_list.append( vrt_read_24 )
+gdaltest_list.append( vrt_read_25 )
+gdaltest_list.append( vrt_read_26 )
+gdaltest_list.append( vrt_read_27 )
+gdaltest_list.append( vrt_read_28 )
 
 if __name__ == '__main__':
 
@@ -33,7 +33,7 @@ import sys
 
 sys.path.append( '../pymod' )
 
-from osgeo import gdal, ogr
+from osgeo import gdal, ogr, osr
 import gdaltest
 import ogrtest
 
@@ -389,6 +389,89 @@ def test_ogr2ogr_lib_17():
 
     return 'success'
 
+###############################################################################
+# Test -nt: multi-threaded translation gives the same features, in the same
+# order, and the same errors, as the single-threaded one
+
+class ogr2ogr_lib_error_collector:
+    def __init__(self):
+        self.msgs = []
+
+    def handler(self, eErrClass, err_no, msg):
+        if eErrClass != gdal.CE_Debug:
+            self.msgs.append(msg)
+
+def ogr2ogr_lib_18_translate(srcDS, options):
+    collector = ogr2ogr_lib_error_collector()
+    gdal.PushErrorHandler(collector.handler)
+    ds = gdal.VectorTranslate('', srcDS, format = 'Memory', options = options)
+    gdal.PopErrorHandler()
+    return (ds, collector.msgs)
+
+def test_ogr2ogr_lib_18():
+
+    # Several batches of features, with one out of the domain of the target
+    # SRS in the last one
+    srcDS = gdal.GetDriverByName('Memory').Create('', 0, 0, 0)
+    srs = osr.SpatialReference()
+    srs.ImportFromEPSG(4326)
+    lyr = srcDS.CreateLayer('test', srs = srs, geom_type = ogr.wkbPoint)
+    lyr.CreateField(ogr.FieldDefn('id', ogr.OFTInteger))
+    for i in range(3000):
+        f = ogr.Feature(lyr.GetLayerDefn())
+        f.SetField('id', i)
+        y = 100 if i == 2500 else (i % 170) - 85
+        f.SetGeometry(ogr.CreateGeometryFromWkt('POINT (%d %d)' % ((i % 360) - 180, y)))
+        lyr.CreateFeature(f)
+    f = None
+
+    options = [ '-t_srs', 'EPSG:3857' ]
+    for skipfailures in [ [], [ '-skipfailures' ] ]:
+        (ref_ds, ref_msgs) = ogr2ogr_lib_18_translate(srcDS, options + skipfailures + [ '-nt', '1' ])
+        (ds, msgs) = ogr2ogr_lib_18_translate(srcDS, options + skipfailures + [ '-nt', '4' ])
+
+        # The errors of the worker threads go through the error handler of
+        # the caller, in the order of the source features
+        if msgs != ref_msgs or len(msgs) < 2 or \
+           msgs[-1].find('Failed to reproject feature 2500') < 0:
+            gdaltest.post_reason('failure')
+            print(ref_msgs)
+            print(msgs)
+            return 'fail'
+
+        if len(skipfailures) == 0:
+            if ds is not None or ref_ds is not None:
+                gdaltest.post_reason('failure')
+                return 'fail'
+            continue
+
+        ref_lyr = ref_ds.GetLayer(0)
+        lyr = ds.GetLayer(0)
+        if lyr.GetFeatureCount() != 3000 or ref_lyr.GetFeatureCount() != 3000:
+            gdaltest.post_reason('failure')
+            return 'fail'
+        for i in range(3000):
+            ref_f = ref_lyr.GetNextFeature()
+            f = lyr.GetNextFeature()
+            ref_geom = ref_f.GetGeometryRef()
+            geom = f.GetGeometryRef()
+            if f.GetField('id') != i or ref_f.GetField('id') != i or \
+               (geom is None) != (ref_geom is None) or (i == 2500) != (geom is None) or \
+               (geom is not None and geom.ExportToWkt() != ref_geom.ExportToWkt()):
+                gdaltest.post_reason('failure')
+                ref_f.DumpReadable()
+                f.DumpReadable()
+                return 'fail'
+
+    # Interruption by the progress callback
+    with gdaltest.error_handler():
+        ds = gdal.VectorTranslate('', srcDS, format = 'Memory', options = [ '-nt', '4' ], callback = mycallback_with_failure)
+    if ds is not None:
+        gdaltest.post_reason('failure')
+        return 'fail'
+
+    return 'success'
+
 gdaltest_list = [
     test_ogr2ogr_lib_1,
     test_ogr2ogr_lib_2,
@@ -406,7 +489,8 @@ gdaltest_list = [
     test_ogr2ogr_lib_14,
     test_ogr2ogr_lib_15,
     test_ogr2ogr_lib_16,
-    test_ogr2ogr_lib_17
+    test_ogr2ogr_lib_17,
+    test_ogr2ogr_lib_18
     ]
 
 if __name__ == '__main__':
@@ -222,6 +222,9 @@ int CPL_DLL GDALGeoLocTransform(
 void CPL_DLL *
 GDALCreateApproxTransformer( GDALTransformerFunc pfnRawTransformer,
                              void *pRawTransformerArg, double dfMaxError );
+void CPL_DLL *
+GDALCreateApproxGridTransformer( GDALTransformerFunc pfnRawTransformer,
+                                 void *pRawTransformerArg, double dfMaxError );
 void CPL_DLL GDALApproxTransformerOwnsSubtransformer( void *pCBData,
                                                       int bOwnFlag );
 void CPL_DLL GDALDestroyApproxTransformer( void *pApproxArg );
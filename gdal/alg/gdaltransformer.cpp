@@ -38,6 +38,11 @@
 #include "cpl_list.h"
 #include "cpl_multiproc.h"
 
+#include <algorithm>
+#include <map>
+#include <utility>
+#include <vector>
+
 CPL_CVSID("$Id$");
 CPL_C_START
 void *GDALDeserializeGCPTransformer( CPLXMLNode *psTree );
@@ -2486,6 +2491,8 @@ GDALDeserializeReprojectionTransformer( CPLXMLNode *psTree )
 /* ==================================================================== */
 /************************************************************************/
 
+class ApproxGrid;
+
 typedef struct
 {
     GDALTransformerInfo sTI;
@@ -2495,8 +2502,21 @@ typedef struct
     double	      dfMaxError;
 
     int               bOwnSubtransformer;
+
+    /* Two dimensional approximation grids, for both directions */
+    int               bGrid;
+    ApproxGrid       *apoGrid[2];
 } ApproxTransformInfo;
 
+static void *GDALCreateApproxTransformerInternal(
+    GDALTransformerFunc pfnBaseTransformer, void *pBaseTransformArg,
+    double dfMaxError, int bGrid );
+static int GDALApproxGridTransform( ApproxTransformInfo *psATInfo,
+                                    int bDstToSrc, int nPoints,
+                                    double *x, double *y, double *z,
+                                    int *panSuccess );
+static void GDALApproxGridDestroy( ApproxTransformInfo *psATInfo );
+
 /************************************************************************/
 /*                  GDALCreateSimilarApproxTransformer()                */
 /************************************************************************/
@@ -2513,6 +2533,8 @@ void* GDALCreateSimilarApproxTransformer( void *hTransformArg, double dfSrcRatio
         CPLMalloc(sizeof(ApproxTransformInfo));
 
     memcpy(psClonedInfo, psInfo, sizeof(ApproxTransformInfo));
+    psClonedInfo->apoGrid[0] = NULL;
+    psClonedInfo->apoGrid[1] = NULL;
     if( psClonedInfo->pBaseCBData )
     {
         psClonedInfo->pBaseCBData = GDALCreateSimilarTransformer( psInfo->pBaseCBData,
@@ -2547,6 +2569,8 @@ GDALSerializeApproxTransformer( void *pTransformArg )
 /* -------------------------------------------------------------------- */
     CPLCreateXMLElementAndValue( psTree, "MaxError",
                                  CPLString().Printf("%g",psInfo->dfMaxError) );
+    if( psInfo->bGrid )
+        CPLCreateXMLElementAndValue( psTree, "Grid", "YES" );
 
 /* -------------------------------------------------------------------- */
 /*      Capture underlying transformer.                                 */
@@ -2596,6 +2620,10 @@ GDALSerializeApproxTransformer( void *pTransformArg )
  * circumstances as little internal validation is done, in order to keep things
  * fast.
  *
+ * Starting with GDAL 2.2, setting the GDAL_APPROX_TRANSFORMER_GRID
+ * configuration option to YES makes this function return the same
+ * transformer as GDALCreateApproxGridTransformer().
+ *
  * @param pfnBaseTransformer the high precision transformer which should be
  * approximated.
  * @param pBaseTransformArg the callback argument for the high precision
@@ -2610,6 +2638,68 @@ GDALSerializeApproxTransformer( void *pTransformArg )
 void *GDALCreateApproxTransformer( GDALTransformerFunc pfnBaseTransformer,
                                    void *pBaseTransformArg, double dfMaxError)
 
+{
+    return GDALCreateApproxTransformerInternal(
+        pfnBaseTransformer, pBaseTransformArg, dfMaxError,
+        CPLTestBool(CPLGetConfigOption("GDAL_APPROX_TRANSFORMER_GRID", "NO")) );
+}
+
+/************************************************************************/
+/*                  GDALCreateApproxGridTransformer()                   */
+/************************************************************************/
+
+/**
+ * Create an approximating transformer working on a two dimensional grid.
+ *
+ * This function creates a context for an approximated transformer, like
+ * GDALCreateApproxTransformer(), but instead of approximating the
+ * transformation along each set of points passed to GDALApproxTransform(),
+ * it divides the input space in tiles of 256x256 units, and refines each
+ * tile as a quadtree until the bilinear interpolation of the corners of each
+ * cell is within the error threshold at the center and at the middle of the
+ * edges of the cell, as the line approximation is checked at the middle of
+ * the line.  Cells that cannot be approximated down to 4x4 units are exactly
+ * transformed.  Tiles are computed the first time they are needed,
+ * and reused by the following calls, so that the exact transformations
+ * are shared by successive scanlines.
+ *
+ * The input coordinates are expected to be pixel/line coordinates, or in
+ * units of the same magnitude, as is the case for warpers.  Unlike
+ * GDALCreateApproxTransformer(), the points passed in do not need to be on a
+ * line.
+ *
+ * @param pfnBaseTransformer the high precision transformer which should be
+ * approximated.
+ * @param pBaseTransformArg the callback argument for the high precision
+ * transformer.
+ * @param dfMaxError the maximum cartesian error in the "output" space that
+ * is to be accepted in the bilinear approximation.
+ *
+ * @return callback pointer suitable for use with GDALApproxTransform().  It
+ * should be deallocated with GDALDestroyApproxTransformer().
+ *
+ * @since GDAL 2.2
+ */
+
+void *GDALCreateApproxGridTransformer( GDALTransformerFunc pfnBaseTransformer,
+                                       void *pBaseTransformArg,
+                                       double dfMaxError )
+
+{
+    return GDALCreateApproxTransformerInternal( pfnBaseTransformer,
+                                                pBaseTransformArg,
+                                                dfMaxError, TRUE );
+}
+
+/************************************************************************/
+/*                GDALCreateApproxTransformerInternal()                 */
+/************************************************************************/
+
+static
+void *GDALCreateApproxTransformerInternal( GDALTransformerFunc pfnBaseTransformer,
+                                           void *pBaseTransformArg,
+                                           double dfMaxError, int bGrid )
+
 {
     ApproxTransformInfo	*psATInfo;
 
@@ -2618,6 +2708,9 @@ void *GDALCreateApproxTransformer( GDALTransformerFunc pfnBaseTransformer,
     psATInfo->pBaseCBData = pBaseTransformArg;
     psATInfo->dfMaxError = dfMaxError;
     psATInfo->bOwnSubtransformer = FALSE;
+    psATInfo->bGrid = bGrid;
+    psATInfo->apoGrid[0] = NULL;
+    psATInfo->apoGrid[1] = NULL;
 
     memcpy( psATInfo->sTI.abySignature, GDAL_GTI2_SIGNATURE, strlen(GDAL_GTI2_SIGNATURE) );
     psATInfo->sTI.pszClassName = "GDALApproxTransformer";
@@ -2665,6 +2758,8 @@ void GDALDestroyApproxTransformer( void * pCBData )
     if( psATInfo->bOwnSubtransformer )
         GDALDestroyTransformer( psATInfo->pBaseCBData );
 
+    GDALApproxGridDestroy( psATInfo );
+
     CPLFree( pCBData );
 }
 
@@ -2927,6 +3022,475 @@ static int GDALApproxTransformInternal( void *pCBData, int bDstToSrc, int nPoint
     return TRUE;
 }
 
+/************************************************************************/
+/* ==================================================================== */
+/*      Two dimensional approximation grid.                             */
+/* ==================================================================== */
+/************************************************************************/
+
+#define APPROX_GRID_TILE_SIZE       256
+#define APPROX_GRID_MIN_CELL_SIZE   4
+
+/* Minimum number of tiles kept in cache. It is raised so that the tiles */
+/* spanned by two successive tile rows of the widest request fit in. */
+#define APPROX_GRID_MAX_TILES       64
+
+/* Requests that are not a line of points, with less points than this per */
+/* tile of their extent, are transformed exactly, as building the tiles */
+/* would cost more than it saves. */
+#define APPROX_GRID_MIN_DENSITY     64
+
+/* Each cell is checked on a regular lattice of 3x3 points: its corners,  */
+/* the middle of its edges and its center. */
+#define APPROX_GRID_SAMPLES         3
+
+typedef struct
+{
+    double      dfX;
+    double      dfY;
+    double      dfZ;
+    int         bSuccess;
+} ApproxGridNode;
+
+typedef struct
+{
+    double      dfX0;
+    double      dfY0;
+    double      dfSize;
+
+    /* Index of the first of the 4 sub-cells, or -1 for a leaf cell */
+    int         iChild;
+
+    /* Leaf cell whose points are transformed with the base transformer */
+    int         bExact;
+
+    /* Transformed top-left, top-right, bottom-left and bottom-right corners */
+    ApproxGridNode asCorner[4];
+} ApproxGridCell;
+
+typedef std::pair<GIntBig, GIntBig> ApproxGridKey;
+
+typedef struct
+{
+    /* Cells of the quadtree of the tile, root cell first */
+    std::vector<ApproxGridCell> asCells;
+
+    /* Value of the use counter of the grid when the tile was last used */
+    GUIntBig    nLastUse;
+} ApproxGridTile;
+
+class ApproxGrid
+{
+  public:
+    ApproxGrid() : dfZ(0.0), nUseCounter(0), nMaxTiles(APPROX_GRID_MAX_TILES) {}
+
+    /* Input Z of the points the tiles are built from. Points with another */
+    /* Z are transformed exactly. */
+    double      dfZ;
+
+    /* Tiles from their indices, the least recently used being evicted */
+    /* when there are more than nMaxTiles. */
+    std::map<ApproxGridKey, ApproxGridTile> oMapTiles;
+    GUIntBig    nUseCounter;
+    size_t      nMaxTiles;
+};
+
+/************************************************************************/
+/*                        GDALApproxGridDestroy()                       */
+/************************************************************************/
+
+static void GDALApproxGridDestroy( ApproxTransformInfo *psATInfo )
+
+{
+    delete psATInfo->apoGrid[0];
+    delete psATInfo->apoGrid[1];
+    psATInfo->apoGrid[0] = NULL;
+    psATInfo->apoGrid[1] = NULL;
+}
+
+/************************************************************************/
+/*                         GDALApproxGridKey()                          */
+/************************************************************************/
+
+static ApproxGridKey GDALApproxGridKey( double dfX, double dfY )
+
+{
+    const double dfUnit =
+        (double) APPROX_GRID_MIN_CELL_SIZE / (APPROX_GRID_SAMPLES - 1);
+    return ApproxGridKey( (GIntBig) floor(dfX / dfUnit + 0.5),
+                          (GIntBig) floor(dfY / dfUnit + 0.5) );
+}
+
+/************************************************************************/
+/*                      GDALApproxGridLineCoefs()                       */
+/*                                                                      */
+/*      Along the line of ordinate dfY, the bilinear interpolation of   */
+/*      the corners of a cell reduces to a linear function of the       */
+/*      abscissa: X = adfA[0] + adfB[0] * x, and so on for Y and Z.     */
+/************************************************************************/
+
+static void GDALApproxGridLineCoefs( const ApproxGridCell *psCell, double dfY,
+                                     double adfA[3], double adfB[3] )
+
+{
+    const double dfV = (dfY - psCell->dfY0) / psCell->dfSize;
+    const ApproxGridNode *pasC = psCell->asCorner;
+    const double adfC[4][3] = {
+        { pasC[0].dfX, pasC[0].dfY, pasC[0].dfZ },
+        { pasC[1].dfX, pasC[1].dfY, pasC[1].dfZ },
+        { pasC[2].dfX, pasC[2].dfY, pasC[2].dfZ },
+        { pasC[3].dfX, pasC[3].dfY, pasC[3].dfZ } };
+
+    for( int i = 0; i < 3; i++ )
+    {
+        const double dfLeft = adfC[0][i] + (adfC[2][i] - adfC[0][i]) * dfV;
+        const double dfRight = adfC[1][i] + (adfC[3][i] - adfC[1][i]) * dfV;
+        adfB[i] = (dfRight - dfLeft) / psCell->dfSize;
+        adfA[i] = dfLeft - adfB[i] * psCell->dfX0;
+    }
+}
+
+/************************************************************************/
+/*                       GDALApproxGridBuildTile()                      */
+/*                                                                      */
+/*      Refine a tile, one level of the quadtree at a time so that the  */
+/*      new points of each level are transformed in a single call.      */
+/************************************************************************/
+
+static void GDALApproxGridBuildTile( ApproxTransformInfo *psATInfo,
+                                     int bDstToSrc, double dfZ,
+                                     GIntBig nTileX, GIntBig nTileY,
+                                     std::vector<ApproxGridCell>& asCells )
+
+{
+    ApproxGridCell sRoot;
+    memset( &sRoot, 0, sizeof(sRoot) );
+    sRoot.dfX0 = (double) nTileX * APPROX_GRID_TILE_SIZE;
+    sRoot.dfY0 = (double) nTileY * APPROX_GRID_TILE_SIZE;
+    sRoot.dfSize = APPROX_GRID_TILE_SIZE;
+    sRoot.iChild = -1;
+
+    asCells.resize( 0 );
+    asCells.push_back( sRoot );
+
+    std::vector<int> aiLevel;
+    aiLevel.push_back( 0 );
+
+    /* Exactly transformed points, from their coordinates in units of */
+    /* the lattice spacing of the smallest cells. */
+    std::map<ApproxGridKey, ApproxGridNode> oMapNodes;
+
+    std::vector<double> adfX, adfY, adfZ;
+    std::vector<int> abSuccess;
+    std::vector<ApproxGridKey> aoKeys;
+    const int nSamples = APPROX_GRID_SAMPLES * APPROX_GRID_SAMPLES;
+
+    while( !aiLevel.empty() )
+    {
+/* -------------------------------------------------------------------- */
+/*      Transform the lattice points of the cells that are not known    */
+/*      yet.  They are shared with the neighbouring and sub-cells.      */
+/* -------------------------------------------------------------------- */
+        adfX.resize( 0 );
+        adfY.resize( 0 );
+        aoKeys.resize( 0 );
+        for( size_t i = 0; i < aiLevel.size(); i++ )
+        {
+            const ApproxGridCell& sCell = asCells[aiLevel[i]];
+            const double dfStep = sCell.dfSize / (APPROX_GRID_SAMPLES - 1);
+            for( int j = 0; j < nSamples; j++ )
+            {
+                const double dfX = sCell.dfX0 + (j % APPROX_GRID_SAMPLES) * dfStep;
+                const double dfY = sCell.dfY0 + (j / APPROX_GRID_SAMPLES) * dfStep;
+                const ApproxGridKey oKey = GDALApproxGridKey( dfX, dfY );
+                if( oMapNodes.find( oKey ) != oMapNodes.end() )
+                    continue;
+                oMapNodes[oKey].bSuccess = FALSE;
+                aoKeys.push_back( oKey );
+                adfX.push_back( dfX );
+                adfY.push_back( dfY );
+            }
+        }
+
+        if( !aoKeys.empty() )
+        {
+            const int nCount = static_cast<int>(aoKeys.size());
+            adfZ.assign( nCount, dfZ );
+            abSuccess.assign( nCount, FALSE );
+            if( !psATInfo->pfnBaseTransformer( psATInfo->pBaseCBData,
+                                               bDstToSrc, nCount,
+                                               &adfX[0], &adfY[0], &adfZ[0],
+                                               &abSuccess[0] ) )
+                abSuccess.assign( nCount, FALSE );
+
+            for( int i = 0; i < nCount; i++ )
+            {
+                ApproxGridNode& sNode = oMapNodes[aoKeys[i]];
+                sNode.dfX = adfX[i];
+                sNode.dfY = adfY[i];
+                sNode.dfZ = adfZ[i];
+                sNode.bSuccess = abSuccess[i];
+            }
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Check the bilinear interpolation of the corners against the     */
+/*      other points, and split the cells where it is not good enough.  */
+/* -------------------------------------------------------------------- */
+        std::vector<int> aiNextLevel;
+        for( size_t i = 0; i < aiLevel.size(); i++ )
+        {
+            ApproxGridCell sCell = asCells[aiLevel[i]];
+            const double dfStep = sCell.dfSize / (APPROX_GRID_SAMPLES - 1);
+            ApproxGridNode asNodes[nSamples];
+            bool bOK = true;
+
+            for( int j = 0; j < nSamples; j++ )
+            {
+                asNodes[j] = oMapNodes[ GDALApproxGridKey(
+                    sCell.dfX0 + (j % APPROX_GRID_SAMPLES) * dfStep,
+                    sCell.dfY0 + (j / APPROX_GRID_SAMPLES) * dfStep ) ];
+                bOK &= asNodes[j].bSuccess != FALSE;
+            }
+            sCell.asCorner[0] = asNodes[0];
+            sCell.asCorner[1] = asNodes[APPROX_GRID_SAMPLES - 1];
+            sCell.asCorner[2] = asNodes[nSamples - APPROX_GRID_SAMPLES];
+            sCell.asCorner[3] = asNodes[nSamples - 1];
+
+            for( int j = 1; bOK && j < nSamples - 1; j++ )
+            {
+                const double dfX =
+                    sCell.dfX0 + (j % APPROX_GRID_SAMPLES) * dfStep;
+                double adfA[3], adfB[3];
+                GDALApproxGridLineCoefs( &sCell,
+                    sCell.dfY0 + (j / APPROX_GRID_SAMPLES) * dfStep,
+                    adfA, adfB );
+                const double dfError =
+                    fabs(adfA[0] + adfB[0] * dfX - asNodes[j].dfX) +
+                    fabs(adfA[1] + adfB[1] * dfX - asNodes[j].dfY);
+                bOK = dfError <= psATInfo->dfMaxError;
+            }
+
+            if( !bOK && sCell.dfSize > APPROX_GRID_MIN_CELL_SIZE )
+            {
+                sCell.iChild = static_cast<int>(asCells.size());
+                for( int j = 0; j < 4; j++ )
+                {
+                    ApproxGridCell sChild;
+                    memset( &sChild, 0, sizeof(sChild) );
+                    sChild.dfSize = sCell.dfSize / 2;
+                    sChild.dfX0 = sCell.dfX0 + (j % 2) * sChild.dfSize;
+                    sChild.dfY0 = sCell.dfY0 + (j / 2) * sChild.dfSize;
+                    sChild.iChild = -1;
+                    aiNextLevel.push_back( static_cast<int>(asCells.size()) );
+                    asCells.push_back( sChild );
+                }
+            }
+            else
+                sCell.bExact = !bOK;
+
+            asCells[aiLevel[i]] = sCell;
+        }
+
+        aiLevel.swap( aiNextLevel );
+    }
+}
+
+/************************************************************************/
+/*                      GDALApproxGridTransform()                       */
+/************************************************************************/
+
+static int GDALApproxGridTransform( ApproxTransformInfo *psATInfo,
+                                    int bDstToSrc, int nPoints,
+                                    double *x, double *y, double *z,
+                                    int *panSuccess )
+
+{
+/* -------------------------------------------------------------------- */
+/*      Find the extent of the request in tiles, to know if it is       */
+/*      worth going through the grid, and how many tiles to keep.       */
+/* -------------------------------------------------------------------- */
+    bool bLine = true;
+    bool bHasExtent = false;
+    double dfMinX = 0.0;
+    double dfMinY = 0.0;
+    double dfMaxX = 0.0;
+    double dfMaxY = 0.0;
+    for( int i = 0; i < nPoints; i++ )
+    {
+        if( y[i] != y[0] )
+            bLine = false;
+        if( !(fabs(x[i]) < 1e15 && fabs(y[i]) < 1e15) )
+            continue;
+        if( !bHasExtent )
+        {
+            bHasExtent = true;
+            dfMinX = dfMaxX = x[i];
+            dfMinY = dfMaxY = y[i];
+        }
+        else
+        {
+            dfMinX = std::min( dfMinX, x[i] );
+            dfMinY = std::min( dfMinY, y[i] );
+            dfMaxX = std::max( dfMaxX, x[i] );
+            dfMaxY = std::max( dfMaxY, y[i] );
+        }
+    }
+    if( !bHasExtent )
+        return psATInfo->pfnBaseTransformer( psATInfo->pBaseCBData, bDstToSrc,
+                                             nPoints, x, y, z, panSuccess );
+
+    const double dfTilesX = floor(dfMaxX / APPROX_GRID_TILE_SIZE) -
+                            floor(dfMinX / APPROX_GRID_TILE_SIZE) + 1;
+    const double dfTilesY = floor(dfMaxY / APPROX_GRID_TILE_SIZE) -
+                            floor(dfMinY / APPROX_GRID_TILE_SIZE) + 1;
+    if( !bLine &&
+        nPoints < APPROX_GRID_MIN_DENSITY * dfTilesX * dfTilesY )
+        return psATInfo->pfnBaseTransformer( psATInfo->pBaseCBData, bDstToSrc,
+                                             nPoints, x, y, z, panSuccess );
+
+    ApproxGrid *&poGrid = psATInfo->apoGrid[bDstToSrc ? 1 : 0];
+    if( poGrid == NULL )
+    {
+        poGrid = new ApproxGrid();
+        poGrid->dfZ = z[0];
+    }
+
+    /* A request cannot touch more tiles than it has points */
+    const double dfTiles = std::min( dfTilesX * dfTilesY,
+                                     static_cast<double>(nPoints) );
+    if( 2 * dfTiles > poGrid->nMaxTiles )
+        poGrid->nMaxTiles = static_cast<size_t>(2 * dfTiles);
+
+    std::vector<int> aiExact;
+
+    /* Successive points are usually on the same line of the same cell, */
+    /* where the interpolation is linear. */
+    bool bHasLine = false;
+    double dfLineY = 0.0;
+    double dfLineXMin = 0.0;
+    double dfLineXMax = 0.0;
+    double adfA[3] = { 0.0, 0.0, 0.0 };
+    double adfB[3] = { 0.0, 0.0, 0.0 };
+
+    for( int i = 0; i < nPoints; i++ )
+    {
+        const double dfX = x[i];
+        if( bHasLine && y[i] == dfLineY &&
+            dfX >= dfLineXMin && dfX < dfLineXMax )
+        {
+            x[i] = adfA[0] + adfB[0] * dfX;
+            y[i] = adfA[1] + adfB[1] * dfX;
+            z[i] = adfA[2] + adfB[2] * dfX;
+            panSuccess[i] = TRUE;
+            continue;
+        }
+
+        // Also catches NaN.
+        if( !(fabs(x[i]) < 1e15 && fabs(y[i]) < 1e15) || z[i] != poGrid->dfZ )
+        {
+            aiExact.push_back( i );
+            continue;
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Find the tile of the point, computing it if needed.             */
+/* -------------------------------------------------------------------- */
+        const ApproxGridKey oTileKey(
+            (GIntBig) floor(x[i] / APPROX_GRID_TILE_SIZE),
+            (GIntBig) floor(y[i] / APPROX_GRID_TILE_SIZE) );
+        std::map<ApproxGridKey, ApproxGridTile>::iterator oIter =
+            poGrid->oMapTiles.find( oTileKey );
+        if( oIter == poGrid->oMapTiles.end() )
+        {
+            if( poGrid->oMapTiles.size() >= poGrid->nMaxTiles )
+            {
+                std::map<ApproxGridKey, ApproxGridTile>::iterator oLRU =
+                    poGrid->oMapTiles.begin();
+                for( oIter = poGrid->oMapTiles.begin();
+                     oIter != poGrid->oMapTiles.end(); ++oIter )
+                {
+                    if( oIter->second.nLastUse < oLRU->second.nLastUse )
+                        oLRU = oIter;
+                }
+                poGrid->oMapTiles.erase( oLRU );
+            }
+            oIter = poGrid->oMapTiles.insert(
+                std::make_pair( oTileKey, ApproxGridTile() ) ).first;
+            GDALApproxGridBuildTile( psATInfo, bDstToSrc, poGrid->dfZ,
+                                     oTileKey.first, oTileKey.second,
+                                     oIter->second.asCells );
+        }
+        oIter->second.nLastUse = ++poGrid->nUseCounter;
+        const std::vector<ApproxGridCell>& asCells = oIter->second.asCells;
+
+/* -------------------------------------------------------------------- */
+/*      Descend to the leaf cell, and interpolate in it.                */
+/* -------------------------------------------------------------------- */
+        int iCell = 0;
+        while( asCells[iCell].iChild >= 0 )
+        {
+            const ApproxGridCell& sCell = asCells[iCell];
+            const double dfHalf = sCell.dfSize / 2;
+            iCell = sCell.iChild
+                + ((x[i] - sCell.dfX0 >= dfHalf) ? 1 : 0)
+                + ((y[i] - sCell.dfY0 >= dfHalf) ? 2 : 0);
+        }
+
+        const ApproxGridCell *psLeaf = &asCells[iCell];
+        if( psLeaf->bExact )
+        {
+            bHasLine = false;
+            aiExact.push_back( i );
+            continue;
+        }
+
+        bHasLine = true;
+        dfLineY = y[i];
+        dfLineXMin = psLeaf->dfX0;
+        dfLineXMax = psLeaf->dfX0 + psLeaf->dfSize;
+        GDALApproxGridLineCoefs( psLeaf, dfLineY, adfA, adfB );
+
+        x[i] = adfA[0] + adfB[0] * dfX;
+        y[i] = adfA[1] + adfB[1] * dfX;
+        z[i] = adfA[2] + adfB[2] * dfX;
+        panSuccess[i] = TRUE;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Transform exactly the remaining points.                         */
+/* -------------------------------------------------------------------- */
+    if( aiExact.empty() )
+        return TRUE;
+
+    const int nExact = static_cast<int>(aiExact.size());
+    if( nExact == nPoints )
+        return psATInfo->pfnBaseTransformer( psATInfo->pBaseCBData, bDstToSrc,
+                                             nPoints, x, y, z, panSuccess );
+
+    std::vector<double> adfX( nExact ), adfY( nExact ), adfZ( nExact );
+    std::vector<int> abSuccess( nExact, FALSE );
+    for( int i = 0; i < nExact; i++ )
+    {
+        adfX[i] = x[aiExact[i]];
+        adfY[i] = y[aiExact[i]];
+        adfZ[i] = z[aiExact[i]];
+    }
+    const int bRet =
+        psATInfo->pfnBaseTransformer( psATInfo->pBaseCBData, bDstToSrc,
+                                      nExact, &adfX[0], &adfY[0], &adfZ[0],
+                                      &abSuccess[0] );
+    for( int i = 0; i < nExact; i++ )
+    {
+        x[aiExact[i]] = adfX[i];
+        y[aiExact[i]] = adfY[i];
+        z[aiExact[i]] = adfZ[i];
+        panSuccess[aiExact[i]] = bRet ? abSuccess[i] : FALSE;
+    }
+
+    return bRet;
+}
+
 /************************************************************************/
 /*                        GDALApproxTransform()                         */
 /************************************************************************/
@@ -2950,6 +3514,10 @@ int GDALApproxTransform( void *pCBData, int bDstToSrc, int nPoints,
 
     int nMiddle = (nPoints-1)/2;
 
+    if( psATInfo->bGrid && psATInfo->dfMaxError != 0.0 )
+        return GDALApproxGridTransform( psATInfo, bDstToSrc, nPoints,
+                                        x, y, z, panSuccess );
+
 /* -------------------------------------------------------------------- */
 /*      Bail if our preconditions are not met, or if error is not       */
 /*      acceptable.                                                     */
@@ -3031,9 +3599,12 @@ GDALDeserializeApproxTransformer( CPLXMLNode *psTree )
     }
     else
     {
-        void *pApproxCBData = GDALCreateApproxTransformer( pfnBaseTransform,
-                                                           pBaseCBData,
-                                                           dfMaxError );
+        const int bGrid =
+            CPLTestBool(CPLGetXMLValue( psTree, "Grid", "NO" ));
+        void *pApproxCBData =
+            GDALCreateApproxTransformerInternal( pfnBaseTransform,
+                                                 pBaseCBData,
+                                                 dfMaxError, bGrid );
         GDALApproxTransformerOwnsSubtransformer( pApproxCBData, TRUE );
 
         return pApproxCBData;
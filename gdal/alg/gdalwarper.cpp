@@ -912,6 +912,9 @@ GDALWarpDstAlphaMasker( void *pMaskFuncArg, int nBandCount,
  * - NUM_THREADS: (GDAL >= 1.10) Can be set to a numeric value or ALL_CPUS to
  * set the number of threads to use to parallelize the computation part of the
  * warping. If not set, computation will be done in a single thread.
+ * Starting with GDAL 2.2, the lines of each chunk are handed out to the
+ * threads in small groups as they become idle, rather than in one band
+ * per thread.
  *
  * - STREAMABLE_OUTPUT: (GDAL >= 2.0) This defaults to FALSE, but may
  * be set to TRUE typically when writing to a streamed file. The
@@ -934,6 +937,21 @@ GDALWarpDstAlphaMasker( void *pMaskFuncArg, int nBandCount,
  * ratio, the higher the performance will be, since exact
  * reprojections must statistically be done with a frequency of
  * 4*error_threshold/SRC_COORD_PRECISION.
+ *
+ * - USE_SEPARABLE_FILTER: (GDAL >= 2.2) This defaults to TRUE. For
+ * unmasked Byte, Int16, UInt16 and Float32 data resampled with the cubic
+ * spline or Lanczos kernels, or downsampled with the bilinear or cubic
+ * kernels, chunks where the source column of a pixel only depends on its
+ * target column, and its source line only on its target line (typically
+ * when the transformation is close to an axis aligned affine one), are
+ * resampled with a horizontal pass followed by a vertical pass, with
+ * precomputed filter weights. Setting it to FALSE resamples each pixel
+ * independently.
+ *
+ * - SEPARABLE_MAX_ERROR: (GDAL >= 2.2) Maximum difference, in source
+ * pixels, between the source coordinates computed by the transformer and
+ * the ones used by the separable filter for a chunk to be resampled with
+ * it. Defaults to 0.01.
  */
 
 /************************************************************************/
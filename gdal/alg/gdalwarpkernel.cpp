@@ -38,6 +38,7 @@
 #include "gdal_alg_priv.h"
 #include "cpl_string.h"
 #include "gdalwarpkernel_opencl.h"
+#include "gdalwarpkernel_avx2.h"
 #include "cpl_atomic_ops.h"
 #include "cpl_worker_thread_pool.h"
 #include <limits>
@@ -152,6 +153,7 @@ static CPLErr GWKAverageOrMode( GDALWarpKernel * );
 static CPLErr GWKCubicNoMasksOrDstDensityOnlyUShort( GDALWarpKernel * );
 static CPLErr GWKCubicSplineNoMasksOrDstDensityOnlyUShort( GDALWarpKernel * );
 static CPLErr GWKBilinearNoMasksOrDstDensityOnlyUShort( GDALWarpKernel * );
+static CPLErr GWKSeparableCase( GDALWarpKernel * );
 
 /************************************************************************/
 /*                           GWKJobStruct                               */
@@ -165,11 +167,14 @@ struct _GWKJobStruct
     int             iYMin;
     int             iYMax;
     volatile int   *pnCounter;
+    volatile int   *pnNextY;
+    int             nYStep;
     volatile int   *pbStop;
     CPLCond        *hCond;
     CPLMutex       *hCondMutex;
     int           (*pfnProgress)(GWKJobStruct* psJob);
     void           *pTransformerArg;
+    void           *pUserData;
 
     // Just used during thread initialization phase
     GDALTransformerFunc pfnTransformerInit;
@@ -217,7 +222,8 @@ static int GWKProgressMonoThread(GWKJobStruct* psJob)
 /************************************************************************/
 
 static CPLErr GWKGenericMonoThread( GDALWarpKernel *poWK,
-                                    void (*pfnFunc) (void *pUserData) )
+                                    void (*pfnFunc) (void *pUserData),
+                                    void *pUserData )
 {
     volatile int bStop = FALSE;
     volatile int nCounter = 0;
@@ -225,6 +231,8 @@ static CPLErr GWKGenericMonoThread( GDALWarpKernel *poWK,
     GWKJobStruct sThreadJob;
     sThreadJob.poWK = poWK;
     sThreadJob.pnCounter = &nCounter;
+    sThreadJob.pnNextY = NULL;
+    sThreadJob.nYStep = 0;
     sThreadJob.iYMin = 0;
     sThreadJob.iYMax = poWK->nDstYSize;
     sThreadJob.pbStop = &bStop;
@@ -232,12 +240,63 @@ static CPLErr GWKGenericMonoThread( GDALWarpKernel *poWK,
     sThreadJob.hCondMutex = NULL;
     sThreadJob.pfnProgress = GWKProgressMonoThread;
     sThreadJob.pTransformerArg = poWK->pTransformerArg;
+    sThreadJob.pUserData = pUserData;
 
     pfnFunc(&sThreadJob);
 
     return !bStop ? CE_None : CE_Failure;
 }
 
+/************************************************************************/
+/*                           GWKClaimLines()                            */
+/************************************************************************/
+
+/* With GWKRun(), take the next group of nYStep destination lines that  */
+/* no other worker has taken yet, so that workers that got cheap lines  */
+/* (for example fully outside of the source) go on with the remaining   */
+/* ones instead of waiting for the others. Return the first line of the */
+/* group, or -1 when all lines have been taken or the computation must  */
+/* be interrupted. In mono-thread mode, the job only has the lines      */
+/* between iYMin and iYMax.                                             */
+
+static int GWKClaimLines( GWKJobStruct* psJob )
+{
+    if( psJob->pnNextY == NULL || *(psJob->pbStop) )
+        return -1;
+    const int nDstYSize = psJob->poWK->nDstYSize;
+    const int iYMin =
+        CPLAtomicAdd(psJob->pnNextY, psJob->nYStep) - psJob->nYStep;
+    if( iYMin >= nDstYSize )
+        return -1;
+    psJob->iYMin = iYMin;
+    psJob->iYMax = MIN(iYMin + psJob->nYStep, nDstYSize);
+    return iYMin;
+}
+
+/************************************************************************/
+/*                     GWKFirstLine() / GWKNextLine()                   */
+/*                                                                      */
+/*      Iterate over the destination lines to be processed by a job,    */
+/*      so that the kernels do their setup once per worker:             */
+/*                                                                      */
+/*      for( iDstY = GWKFirstLine(psJob); iDstY >= 0;                   */
+/*           iDstY = GWKNextLine(psJob, iDstY) )                        */
+/************************************************************************/
+
+static int GWKFirstLine( GWKJobStruct* psJob )
+{
+    if( psJob->pnNextY == NULL )
+        return psJob->iYMin < psJob->iYMax ? psJob->iYMin : -1;
+    return GWKClaimLines(psJob);
+}
+
+static int GWKNextLine( GWKJobStruct* psJob, int iDstY )
+{
+    if( iDstY + 1 < psJob->iYMax )
+        return iDstY + 1;
+    return GWKClaimLines(psJob);
+}
+
 /************************************************************************/
 /*                     GWKThreadInitTransformer()                       */
 /************************************************************************/
@@ -407,7 +466,8 @@ void GWKThreadsEnd(void* psThreadDataIn)
 
 static CPLErr GWKRun( GDALWarpKernel *poWK,
                       const char* pszFuncName,
-                      void (*pfnFunc) (void *pUserData) )
+                      void (*pfnFunc) (void *pUserData),
+                      void *pUserData = NULL )
 
 {
     int nDstYSize = poWK->nDstYSize;
@@ -429,17 +489,25 @@ static CPLErr GWKRun( GDALWarpKernel *poWK,
     GWKThreadData* psThreadData = (GWKThreadData*)poWK->psThreadData;
     if( psThreadData == NULL || psThreadData->poThreadPool == NULL )
     {
-        return GWKGenericMonoThread(poWK, pfnFunc);
+        return GWKGenericMonoThread(poWK, pfnFunc, pUserData);
     }
 
     int nThreads = psThreadData->poThreadPool->GetThreadCount();
     if (nThreads >= nDstYSize / 2)
         nThreads = nDstYSize / 2;
+    if( nThreads < 1 )
+        return GWKGenericMonoThread(poWK, pfnFunc, pUserData);
+
+    /* Lines are handed out to the threads by groups of nYStep as they */
+    /* become available, rather than in one fixed band per thread, as the */
+    /* cost of a line can vary a lot within a chunk. */
+    const int nYStep = MAX(1, nDstYSize / (nThreads * 16));
 
-    CPLDebug("WARP", "Using %d threads", nThreads);
+    CPLDebug("WARP", "Using %d threads, %d lines per job", nThreads, nYStep);
 
     volatile int bStop = FALSE;
     volatile int nCounter = 0;
+    volatile int nNextY = 0;
 
     CPLAcquireMutex(psThreadData->hCondMutex, 1000);
 
@@ -450,8 +518,9 @@ static CPLErr GWKRun( GDALWarpKernel *poWK,
     {
         psThreadData->pasThreadJob[i].poWK = poWK;
         psThreadData->pasThreadJob[i].pnCounter = &nCounter;
-        psThreadData->pasThreadJob[i].iYMin = (int)(((GIntBig)i) * nDstYSize / nThreads);
-        psThreadData->pasThreadJob[i].iYMax = (int)(((GIntBig)(i + 1)) * nDstYSize / nThreads);
+        psThreadData->pasThreadJob[i].pnNextY = &nNextY;
+        psThreadData->pasThreadJob[i].nYStep = nYStep;
+        psThreadData->pasThreadJob[i].pUserData = pUserData;
         psThreadData->pasThreadJob[i].pbStop = &bStop;
         if( poWK->pfnProgress != GDALDummyProgress )
             psThreadData->pasThreadJob[i].pfnProgress = GWKProgressThread;
@@ -1084,6 +1153,26 @@ CPLErr GDALWarpKernel::PerformWarp()
         && pafUnifiedSrcDensity == NULL
         && panDstValid == NULL );
 
+    if( (eWorkingDataType == GDT_Byte
+         || eWorkingDataType == GDT_Int16
+         || eWorkingDataType == GDT_UInt16
+         || eWorkingDataType == GDT_Float32) &&
+        (eResample == GRA_CubicSpline
+         || eResample == GRA_Lanczos
+         || ((eResample == GRA_Cubic || eResample == GRA_Bilinear) &&
+             !bUse4SamplesFormula)) &&
+        bNoMasksOrDstDensityOnly &&
+        CSLFetchBoolean( papszWarpOptions, "USE_SEPARABLE_FILTER", TRUE ) )
+    {
+        CPLErr eResult = GWKSeparableCase( this );
+
+        // CE_Warning tells us the transformation of this chunk cannot be
+        // split in a horizontal and a vertical part, so we fall through
+        // to the per pixel methods.
+        if( eResult != CE_Warning )
+            return eResult;
+    }
+
     if( eWorkingDataType == GDT_Byte
         && eResample == GRA_NearestNeighbour
         && bNoMasksOrDstDensityOnly )
@@ -3983,8 +4072,6 @@ static void GWKGeneralCaseThread( void* pData)
 {
     GWKJobStruct* psJob = (GWKJobStruct*) pData;
     GDALWarpKernel *poWK = psJob->poWK;
-    int iYMin = psJob->iYMin;
-    int iYMax = psJob->iYMax;
 
     int iDstY;
     int nDstXSize = poWK->nDstXSize;
@@ -4017,7 +4104,8 @@ static void GWKGeneralCaseThread( void* pData)
 /* ==================================================================== */
 /*      Loop over output lines.                                         */
 /* ==================================================================== */
-    for( iDstY = iYMin; iDstY < iYMax; iDstY++ )
+    for( iDstY = GWKFirstLine(psJob); iDstY >= 0;
+         iDstY = GWKNextLine(psJob, iDstY) )
     {
         int iDstX;
 
@@ -4184,6 +4272,375 @@ static void GWKGeneralCaseThread( void* pData)
         GWKResampleDeleteWrkStruct(psWrkStruct);
 }
 
+/************************************************************************/
+/*                 Vectorized bilinear and cubic resampling             */
+/*                                                                      */
+/*      The NoMasksOrDstDensityOnly cases with the 4 sample formulas    */
+/*      resample the points of a destination line whose kernel is       */
+/*      entirely inside the source window with one of the functions     */
+/*      below, which process several points at a time with the same     */
+/*      sequence of double precision operations as                      */
+/*      GWKBilinearResampleNoMasks4SampleT() and                        */
+/*      GWKCubicResampleNoMasks4SampleT(), and so give the same         */
+/*      results.  The AVX2 version is selected at runtime when the CPU  */
+/*      supports it, unless GDAL_USE_AVX2 is set to NO.  The SSE2       */
+/*      version is used otherwise on x86_64, and with Emscripten when   */
+/*      building with -msse2 -msimd128, where it is translated to       */
+/*      WebAssembly SIMD instructions, unless GDAL_USE_SSE2 is set to   */
+/*      NO.                                                             */
+/************************************************************************/
+
+template<class T> struct GWKResampleRowFunc
+{
+    typedef void (*Type)( const T* pSrc, int nSrcXSize,
+                          const double* padfX, const double* padfY,
+                          const int* panDstX, int nCount, T* pDstLine );
+};
+
+#if defined(__x86_64) || defined(_M_X64) || \
+    (defined(__EMSCRIPTEN__) && defined(__SSE2__))
+
+#define GWK_HAVE_SSE2_ROW_RESAMPLING
+#include <emmintrin.h>
+
+/************************************************************************/
+/*              GWKBilinearResampleNoMasks4SampleRowSSE2()              */
+/************************************************************************/
+
+template<class T>
+static void GWKBilinearResampleNoMasks4SampleRowSSE2(
+    const T* pSrc, int nSrcXSize, const double* padfX, const double* padfY,
+    const int* panDstX, int nCount, T* pDstLine )
+{
+    const __m128d xmm_half = _mm_set1_pd(0.5);
+    const __m128d xmm_one = _mm_set1_pd(1.0);
+    const __m128d xmm_one_and_half = _mm_set1_pd(1.5);
+
+    for( int i = 0; i < nCount; i += 2 )
+    {
+        const int j = (i + 1 < nCount) ? i + 1 : i;
+        const __m128d xmm_x = _mm_set_pd( padfX[j], padfX[i] );
+        const __m128d xmm_y = _mm_set_pd( padfY[j], padfY[i] );
+
+        // The points are inside the source, so truncation is the same
+        // as floor() here.
+        const __m128i xmm_ix = _mm_cvttpd_epi32( _mm_sub_pd(xmm_x, xmm_half) );
+        const __m128i xmm_iy = _mm_cvttpd_epi32( _mm_sub_pd(xmm_y, xmm_half) );
+        int anIX[4], anIY[4];
+        _mm_storeu_si128( reinterpret_cast<__m128i*>(anIX), xmm_ix );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>(anIY), xmm_iy );
+        const int iOffset0 = anIX[0] + anIY[0] * nSrcXSize;
+        const int iOffset1 = anIX[1] + anIY[1] * nSrcXSize;
+
+        const __m128d xmm_rx = _mm_sub_pd( xmm_one_and_half,
+            _mm_sub_pd(xmm_x, _mm_cvtepi32_pd(xmm_ix)) );
+        const __m128d xmm_ry = _mm_sub_pd( xmm_one_and_half,
+            _mm_sub_pd(xmm_y, _mm_cvtepi32_pd(xmm_iy)) );
+        const __m128d xmm_rx1 = _mm_sub_pd( xmm_one, xmm_rx );
+        const __m128d xmm_ry1 = _mm_sub_pd( xmm_one, xmm_ry );
+
+        const __m128d xmm_f00 =
+            _mm_set_pd( pSrc[iOffset1], pSrc[iOffset0] );
+        const __m128d xmm_f01 =
+            _mm_set_pd( pSrc[iOffset1 + 1], pSrc[iOffset0 + 1] );
+        const __m128d xmm_f10 =
+            _mm_set_pd( pSrc[iOffset1 + nSrcXSize],
+                        pSrc[iOffset0 + nSrcXSize] );
+        const __m128d xmm_f11 =
+            _mm_set_pd( pSrc[iOffset1 + 1 + nSrcXSize],
+                        pSrc[iOffset0 + 1 + nSrcXSize] );
+
+        const __m128d xmm_v = _mm_add_pd(
+            _mm_mul_pd( _mm_add_pd(_mm_mul_pd(xmm_f00, xmm_rx),
+                                   _mm_mul_pd(xmm_f01, xmm_rx1)),
+                        xmm_ry ),
+            _mm_mul_pd( _mm_add_pd(_mm_mul_pd(xmm_f10, xmm_rx),
+                                   _mm_mul_pd(xmm_f11, xmm_rx1)),
+                        xmm_ry1 ) );
+
+        double adfValue[2];
+        _mm_storeu_pd( adfValue, xmm_v );
+        pDstLine[panDstX[i]] = GWKRoundValueT<T>(adfValue[0]);
+        pDstLine[panDstX[j]] = GWKRoundValueT<T>(adfValue[1]);
+    }
+}
+
+/************************************************************************/
+/*                     GWKSSE2CubicConvolution()                        */
+/************************************************************************/
+
+static CPL_INLINE __m128d GWKSSE2CubicConvolution( __m128d xmm_d1,
+                                                   __m128d xmm_d2,
+                                                   __m128d xmm_d3,
+                                                   __m128d xmm_f0,
+                                                   __m128d xmm_f1,
+                                                   __m128d xmm_f2,
+                                                   __m128d xmm_f3 )
+{
+    const __m128d xmm_t1 = _mm_mul_pd( xmm_d1, _mm_sub_pd(xmm_f2, xmm_f0) );
+    const __m128d xmm_t2 = _mm_mul_pd( xmm_d2,
+        _mm_sub_pd(
+            _mm_add_pd(
+                _mm_sub_pd(_mm_mul_pd(_mm_set1_pd(2.0), xmm_f0),
+                           _mm_mul_pd(_mm_set1_pd(5.0), xmm_f1)),
+                _mm_mul_pd(_mm_set1_pd(4.0), xmm_f2)),
+            xmm_f3) );
+    const __m128d xmm_t3 = _mm_mul_pd( xmm_d3,
+        _mm_sub_pd(
+            _mm_add_pd(
+                _mm_mul_pd(_mm_set1_pd(3.0), _mm_sub_pd(xmm_f1, xmm_f2)),
+                xmm_f3),
+            xmm_f0) );
+    return _mm_add_pd( xmm_f1,
+        _mm_mul_pd( _mm_set1_pd(0.5),
+                    _mm_add_pd(_mm_add_pd(xmm_t1, xmm_t2), xmm_t3) ) );
+}
+
+/************************************************************************/
+/*               GWKCubicResampleNoMasks4SampleRowSSE2()                */
+/************************************************************************/
+
+template<class T>
+static void GWKCubicResampleNoMasks4SampleRowSSE2(
+    const T* pSrc, int nSrcXSize, const double* padfX, const double* padfY,
+    const int* panDstX, int nCount, T* pDstLine )
+{
+    const __m128d xmm_half = _mm_set1_pd(0.5);
+
+    for( int i = 0; i < nCount; i += 2 )
+    {
+        const int j = (i + 1 < nCount) ? i + 1 : i;
+        const __m128d xmm_x =
+            _mm_sub_pd( _mm_set_pd(padfX[j], padfX[i]), xmm_half );
+        const __m128d xmm_y =
+            _mm_sub_pd( _mm_set_pd(padfY[j], padfY[i]), xmm_half );
+
+        const __m128i xmm_ix = _mm_cvttpd_epi32( xmm_x );
+        const __m128i xmm_iy = _mm_cvttpd_epi32( xmm_y );
+        int anIX[4], anIY[4];
+        _mm_storeu_si128( reinterpret_cast<__m128i*>(anIX), xmm_ix );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>(anIY), xmm_iy );
+        const T* pSrc0 = pSrc + anIX[0] + (anIY[0] - 1) * nSrcXSize;
+        const T* pSrc1 = pSrc + anIX[1] + (anIY[1] - 1) * nSrcXSize;
+
+        const __m128d xmm_dx = _mm_sub_pd( xmm_x, _mm_cvtepi32_pd(xmm_ix) );
+        const __m128d xmm_dy = _mm_sub_pd( xmm_y, _mm_cvtepi32_pd(xmm_iy) );
+        const __m128d xmm_dx2 = _mm_mul_pd( xmm_dx, xmm_dx );
+        const __m128d xmm_dy2 = _mm_mul_pd( xmm_dy, xmm_dy );
+        const __m128d xmm_dx3 = _mm_mul_pd( xmm_dx2, xmm_dx );
+        const __m128d xmm_dy3 = _mm_mul_pd( xmm_dy2, xmm_dy );
+
+        __m128d axmm_value[4];
+        for( int k = 0; k < 4; k++ )
+        {
+            axmm_value[k] = GWKSSE2CubicConvolution(
+                xmm_dx, xmm_dx2, xmm_dx3,
+                _mm_set_pd(pSrc1[-1], pSrc0[-1]),
+                _mm_set_pd(pSrc1[0], pSrc0[0]),
+                _mm_set_pd(pSrc1[1], pSrc0[1]),
+                _mm_set_pd(pSrc1[2], pSrc0[2]) );
+            pSrc0 += nSrcXSize;
+            pSrc1 += nSrcXSize;
+        }
+
+        const __m128d xmm_v = GWKSSE2CubicConvolution(
+            xmm_dy, xmm_dy2, xmm_dy3,
+            axmm_value[0], axmm_value[1], axmm_value[2], axmm_value[3] );
+
+        double adfValue[2];
+        _mm_storeu_pd( adfValue, xmm_v );
+        pDstLine[panDstX[i]] = GWKClampValueT<T>(adfValue[0]);
+        pDstLine[panDstX[j]] = GWKClampValueT<T>(adfValue[1]);
+    }
+}
+
+#endif /* GWK_HAVE_SSE2_ROW_RESAMPLING */
+
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+
+/************************************************************************/
+/*                          GWKHaveRuntimeAVX2()                        */
+/************************************************************************/
+
+#define CPUID_AVX2_EBX_BIT      5
+#define CPUID_OSXSAVE_ECX_BIT   27
+#define CPUID_AVX_ECX_BIT       28
+
+#define BIT_XMM_STATE           (1 << 1)
+#define BIT_YMM_STATE           (2 << 1)
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64))
+
+#include <cpuid.h>
+
+static bool GWKHaveRuntimeAVX2Internal()
+{
+    unsigned int nEAX = 0, nEBX = 0, nECX = 0, nEDX = 0;
+    if( __get_cpuid_max(0, NULL) < 7 )
+        return false;
+
+    /* Check OSXSAVE and AVX features */
+    __cpuid( 1, nEAX, nEBX, nECX, nEDX );
+    if( (nECX & (1 << CPUID_OSXSAVE_ECX_BIT)) == 0 ||
+        (nECX & (1 << CPUID_AVX_ECX_BIT)) == 0 )
+        return false;
+
+    /* Issue XGETBV and check the XMM and YMM state bit */
+    unsigned int nXCRLow;
+    unsigned int nXCRHigh;
+    __asm__ ("xgetbv" : "=a" (nXCRLow), "=d" (nXCRHigh) : "c" (0));
+    if( (nXCRLow & ( BIT_XMM_STATE | BIT_YMM_STATE )) !=
+                   ( BIT_XMM_STATE | BIT_YMM_STATE ) )
+        return false;
+
+    /* Check AVX2 feature */
+    __cpuid_count( 7, 0, nEAX, nEBX, nECX, nEDX );
+    return (nEBX & (1 << CPUID_AVX2_EBX_BIT)) != 0;
+}
+
+#elif defined(_MSC_FULL_VER) && (_MSC_FULL_VER >= 160040219) && (defined(_M_IX86) || defined(_M_X64))
+
+#include <intrin.h>
+
+static bool GWKHaveRuntimeAVX2Internal()
+{
+    int cpuinfo[4] = {0,0,0,0};
+    __cpuid(cpuinfo, 0);
+    if( cpuinfo[0] < 7 )
+        return false;
+
+    /* Check OSXSAVE and AVX features */
+    __cpuid(cpuinfo, 1);
+    if( (cpuinfo[2] & (1 << CPUID_OSXSAVE_ECX_BIT)) == 0 ||
+        (cpuinfo[2] & (1 << CPUID_AVX_ECX_BIT)) == 0 )
+        return false;
+
+    /* Issue XGETBV and check the XMM and YMM state bit */
+    unsigned __int64 xcrFeatureMask = _xgetbv(_XCR_XFEATURE_ENABLED_MASK);
+    if( (xcrFeatureMask & ( BIT_XMM_STATE | BIT_YMM_STATE )) !=
+                          ( BIT_XMM_STATE | BIT_YMM_STATE ) )
+        return false;
+
+    /* Check AVX2 feature */
+    __cpuidex(cpuinfo, 7, 0);
+    return (cpuinfo[1] & (1 << CPUID_AVX2_EBX_BIT)) != 0;
+}
+
+#else
+
+static bool GWKHaveRuntimeAVX2Internal()
+{
+    return false;
+}
+
+#endif
+
+static bool GWKHaveRuntimeAVX2()
+{
+    static const bool bHaveAVX2 = GWKHaveRuntimeAVX2Internal();
+    return bHaveAVX2;
+}
+
+#endif /* HAVE_AVX2_AT_COMPILE_TIME */
+
+/************************************************************************/
+/*                      GWKSelectResampleRowFunc()                      */
+/************************************************************************/
+
+template<class T>
+static typename GWKResampleRowFunc<T>::Type
+GWKSelectResampleRowFunc( GDALResampleAlg eResample )
+{
+    typename GWKResampleRowFunc<T>::Type pfnBilinear = NULL;
+    typename GWKResampleRowFunc<T>::Type pfnCubic = NULL;
+
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+    if( GWKHaveRuntimeAVX2() &&
+        CPLTestBool(CPLGetConfigOption("GDAL_USE_AVX2", "YES")) )
+    {
+        pfnBilinear = GWKBilinearResampleNoMasks4SampleRowAVX2;
+        pfnCubic = GWKCubicResampleNoMasks4SampleRowAVX2;
+    }
+#endif
+#ifdef GWK_HAVE_SSE2_ROW_RESAMPLING
+    if( pfnBilinear == NULL &&
+        CPLTestBool(CPLGetConfigOption("GDAL_USE_SSE2", "YES")) )
+    {
+        pfnBilinear = GWKBilinearResampleNoMasks4SampleRowSSE2<T>;
+        pfnCubic = GWKCubicResampleNoMasks4SampleRowSSE2<T>;
+    }
+#endif
+
+    return eResample == GRA_Bilinear ? pfnBilinear :
+           eResample == GRA_Cubic ? pfnCubic : NULL;
+}
+
+/************************************************************************/
+/*                       GWKGetResampleRowFunc()                        */
+/*                                                                      */
+/*      Returns the vectorized resampling function to use for the       */
+/*      data type, or NULL if there is none.                            */
+/************************************************************************/
+
+template<class T>
+static typename GWKResampleRowFunc<T>::Type
+GWKGetResampleRowFunc( GDALResampleAlg /* eResample */ )
+{
+    return NULL;
+}
+
+template<>
+GWKResampleRowFunc<GByte>::Type
+GWKGetResampleRowFunc<GByte>( GDALResampleAlg eResample )
+{
+    return GWKSelectResampleRowFunc<GByte>(eResample);
+}
+
+template<>
+GWKResampleRowFunc<GUInt16>::Type
+GWKGetResampleRowFunc<GUInt16>( GDALResampleAlg eResample )
+{
+    return GWKSelectResampleRowFunc<GUInt16>(eResample);
+}
+
+template<>
+GWKResampleRowFunc<GInt16>::Type
+GWKGetResampleRowFunc<GInt16>( GDALResampleAlg eResample )
+{
+    return GWKSelectResampleRowFunc<GInt16>(eResample);
+}
+
+template<>
+GWKResampleRowFunc<float>::Type
+GWKGetResampleRowFunc<float>( GDALResampleAlg eResample )
+{
+    return GWKSelectResampleRowFunc<float>(eResample);
+}
+
+/************************************************************************/
+/*                     GWKIsInside4SampleKernel()                       */
+/*                                                                      */
+/*      Whether the point can be resampled by the vectorized            */
+/*      functions: its kernel must be entirely inside the source        */
+/*      window, with one more source line below it.                     */
+/************************************************************************/
+
+static CPL_INLINE bool GWKIsInside4SampleKernel( GDALResampleAlg eResample,
+                                                 double dfSrcX, double dfSrcY,
+                                                 int nSrcXSize, int nSrcYSize )
+{
+    // Same as iSrcX >= 0 && iSrcX + 1 < nSrcXSize and
+    // iSrcY >= 0 && iSrcY + 2 < nSrcYSize, with iSrcX = floor(dfSrcX - 0.5)
+    if( eResample == GRA_Bilinear )
+        return dfSrcX >= 0.5 && dfSrcX < nSrcXSize - 0.5 &&
+               dfSrcY >= 0.5 && dfSrcY < nSrcYSize - 1.5;
+
+    // Same as iSrcX >= 1 && iSrcX + 2 < nSrcXSize and
+    // iSrcY >= 1 && iSrcY + 3 < nSrcYSize, with iSrcX = (int)(dfSrcX - 0.5)
+    return dfSrcX >= 1.5 && dfSrcX < nSrcXSize - 1.5 &&
+           dfSrcY >= 1.5 && dfSrcY < nSrcYSize - 2.5;
+}
+
 /************************************************************************/
 /*                GWKResampleNoMasksOrDstDensityOnlyThreadInternal()           */
 /************************************************************************/
@@ -4194,8 +4651,6 @@ static void GWKResampleNoMasksOrDstDensityOnlyThreadInternal( void* pData )
 {
     GWKJobStruct* psJob = (GWKJobStruct*) pData;
     GDALWarpKernel *poWK = psJob->poWK;
-    int iYMin = psJob->iYMin;
-    int iYMax = psJob->iYMax;
 
     int iDstY;
     int nDstXSize = poWK->nDstXSize;
@@ -4220,12 +4675,31 @@ static void GWKResampleNoMasksOrDstDensityOnlyThreadInternal( void* pData )
     double dfErrorThreshold = CPLAtof(
         CSLFetchNameValueDef(poWK->papszWarpOptions, "ERROR_THRESHOLD", "0"));
 
+/* -------------------------------------------------------------------- */
+/*      Points of each line that can be resampled by a vectorized       */
+/*      function are gathered and resampled at the end of the line.     */
+/* -------------------------------------------------------------------- */
+    typename GWKResampleRowFunc<T>::Type pfnResampleRow = NULL;
+    if( bUse4SamplesFormula )
+        pfnResampleRow = GWKGetResampleRowFunc<T>(eResample);
+
+    double *padfXRow = NULL, *padfYRow = NULL;
+    int    *panDstXRow = NULL;
+    if( pfnResampleRow != NULL )
+    {
+        padfXRow = (double *) CPLMalloc(sizeof(double) * nDstXSize);
+        padfYRow = (double *) CPLMalloc(sizeof(double) * nDstXSize);
+        panDstXRow = (int *) CPLMalloc(sizeof(int) * nDstXSize);
+    }
+
 /* ==================================================================== */
 /*      Loop over output lines.                                         */
 /* ==================================================================== */
-    for( iDstY = iYMin; iDstY < iYMax; iDstY++ )
+    for( iDstY = GWKFirstLine(psJob); iDstY >= 0;
+         iDstY = GWKNextLine(psJob, iDstY) )
     {
         int iDstX;
+        int nRowCount = 0;
 
 /* -------------------------------------------------------------------- */
 /*      Setup points to transform to source image space.                */
@@ -4272,6 +4746,22 @@ static void GWKResampleNoMasksOrDstDensityOnlyThreadInternal( void* pData )
 
             iDstOffset = iDstX + iDstY * nDstXSize;
 
+            if( pfnResampleRow != NULL &&
+                GWKIsInside4SampleKernel( eResample,
+                                          padfX[iDstX]-poWK->nSrcXOff,
+                                          padfY[iDstX]-poWK->nSrcYOff,
+                                          nSrcXSize, nSrcYSize ) )
+            {
+                padfXRow[nRowCount] = padfX[iDstX]-poWK->nSrcXOff;
+                padfYRow[nRowCount] = padfY[iDstX]-poWK->nSrcYOff;
+                panDstXRow[nRowCount] = iDstX;
+                nRowCount++;
+
+                if( poWK->pafDstDensity )
+                    poWK->pafDstDensity[iDstOffset] = 1.0f;
+                continue;
+            }
+
             for( iBand = 0; iBand < poWK->nBands; iBand++ )
             {
                 T value = 0;
@@ -4305,6 +4795,18 @@ static void GWKResampleNoMasksOrDstDensityOnlyThreadInternal( void* pData )
                 poWK->pafDstDensity[iDstOffset] = 1.0f;
         }
 
+        if( nRowCount > 0 )
+        {
+            for( int iBand = 0; iBand < poWK->nBands; iBand++ )
+            {
+                pfnResampleRow( (const T *)poWK->papabySrcImage[iBand],
+                                nSrcXSize, padfXRow, padfYRow, panDstXRow,
+                                nRowCount,
+                                (T *)poWK->papabyDstImage[iBand] +
+                                    iDstY * nDstXSize );
+            }
+        }
+
 /* -------------------------------------------------------------------- */
 /*      Report progress to the user, and optionally cancel out.         */
 /* -------------------------------------------------------------------- */
@@ -4320,6 +4822,9 @@ static void GWKResampleNoMasksOrDstDensityOnlyThreadInternal( void* pData )
     CPLFree( padfZ );
     CPLFree( pabSuccess );
     CPLFree( padfWeight );
+    CPLFree( padfXRow );
+    CPLFree( padfYRow );
+    CPLFree( panDstXRow );
 }
 
 template<class T,GDALResampleAlg eResample>
@@ -4395,8 +4900,6 @@ static void GWKNearestThread( void* pData )
 {
     GWKJobStruct* psJob = (GWKJobStruct*) pData;
     GDALWarpKernel *poWK = psJob->poWK;
-    int iYMin = psJob->iYMin;
-    int iYMax = psJob->iYMax;
 
     int iDstY;
     int nDstXSize = poWK->nDstXSize;
@@ -4422,7 +4925,8 @@ static void GWKNearestThread( void* pData )
 /* ==================================================================== */
 /*      Loop over output lines.                                         */
 /* ==================================================================== */
-    for( iDstY = iYMin; iDstY < iYMax; iDstY++ )
+    for( iDstY = GWKFirstLine(psJob); iDstY >= 0;
+         iDstY = GWKNextLine(psJob, iDstY) )
     {
         int iDstX;
 
@@ -4626,6 +5130,432 @@ static CPLErr GWKNearestFloat( GDALWarpKernel *poWK )
 }
 
 
+/************************************************************************/
+/*                         GWKSeparableAxis                             */
+/*                                                                      */
+/*      Filter weights along one axis of a chunk whose transformation   */
+/*      is separable: for each destination column (resp. line), the     */
+/*      first source column (resp. line) of its kernel, the number of   */
+/*      source pixels in the kernel, and their normalized weights.      */
+/*      A negative first index means that the destination column       */
+/*      (resp. line) falls outside of the source window.                */
+/************************************************************************/
+
+typedef struct
+{
+    int     nTaps;
+    int    *panFirst;
+    int    *panCount;
+    double *padfWeights;
+} GWKSeparableAxis;
+
+typedef struct
+{
+    GWKSeparableAxis sX;
+    GWKSeparableAxis sY;
+} GWKSeparableFilter;
+
+/************************************************************************/
+/*                       GWKSeparableDestroy()                          */
+/************************************************************************/
+
+static void GWKSeparableDestroy( GWKSeparableFilter* psFilter )
+{
+    if( psFilter == NULL )
+        return;
+    CPLFree( psFilter->sX.panFirst );
+    CPLFree( psFilter->sX.panCount );
+    CPLFree( psFilter->sX.padfWeights );
+    CPLFree( psFilter->sY.panFirst );
+    CPLFree( psFilter->sY.panCount );
+    CPLFree( psFilter->sY.padfWeights );
+    CPLFree( psFilter );
+}
+
+/************************************************************************/
+/*                    GWKSeparableComputeWeights()                      */
+/*                                                                      */
+/*      Compute the weights of one axis with the same kernel extent     */
+/*      and filter as GWKResample(), GWKResampleOptimizedLanczos() and  */
+/*      GWKResampleNoMasksT() use along that axis for each pixel.       */
+/************************************************************************/
+
+static int GWKSeparableComputeWeights( const GDALWarpKernel *poWK,
+                                       const double *padfSrcCoord,
+                                       int nDstSize, int nSrcOff,
+                                       int nSrcSize, double dfScale,
+                                       int nFiltInit, int nRadius,
+                                       GWKSeparableAxis *psAxis )
+{
+    psAxis->nTaps = nRadius - nFiltInit + 1;
+    psAxis->panFirst = (int *) VSI_MALLOC2_VERBOSE(sizeof(int), nDstSize);
+    psAxis->panCount = (int *) VSI_MALLOC2_VERBOSE(sizeof(int), nDstSize);
+    psAxis->padfWeights = (double *)
+        VSI_MALLOC3_VERBOSE(sizeof(double), psAxis->nTaps, nDstSize);
+    if( psAxis->panFirst == NULL || psAxis->panCount == NULL ||
+        psAxis->padfWeights == NULL )
+        return FALSE;
+
+    const bool bLanczos = (poWK->eResample == GRA_Lanczos);
+    const bool bScaleBelow1 = (dfScale < 1.0);
+    FilterFuncType pfnGetWeight = apfGWKFilter[poWK->eResample];
+    CPLAssert(pfnGetWeight);
+
+    for( int iDst = 0; iDst < nDstSize; iDst++ )
+    {
+        double *padfWeights = psAxis->padfWeights + iDst * psAxis->nTaps;
+        psAxis->panFirst[iDst] = -1;
+        psAxis->panCount[iDst] = 0;
+
+        // Same test as GWKCheckAndComputeSrcOffsets()
+        const double dfSrc = padfSrcCoord[iDst];
+        if( !(dfSrc >= nSrcOff) )
+            continue;
+        const int iSrcNearest = ((int) (dfSrc + 1e-10)) - nSrcOff;
+        if( iSrcNearest < 0 || iSrcNearest >= nSrcSize )
+            continue;
+
+        const int iSrc = (int) floor( dfSrc - nSrcOff - 0.5 );
+        const double dfDelta = dfSrc - nSrcOff - 0.5 - iSrc;
+
+        // Skip sampling over edge of image
+        int iMin = nFiltInit, iMax = nRadius;
+        if( iSrc + iMin < 0 )
+            iMin = -iSrc;
+        if( iSrc + iMax >= nSrcSize )
+            iMax = nSrcSize - iSrc - 1;
+        if( bLanczos && bScaleBelow1 )
+        {
+            while( iMin * dfScale < -3.0 )
+                iMin ++;
+            while( iMax * dfScale > 3.0 )
+                iMax --;
+        }
+        else if( bLanczos )
+        {
+            while( iMin - dfDelta < -3.0 )
+                iMin ++;
+            while( iMax - dfDelta > 3.0 )
+                iMax --;
+        }
+
+        double dfAccumulatorWeight = 0.0;
+        for( int i = iMin; i <= iMax; i++ )
+        {
+            double dfX;
+            if( bLanczos )
+                dfX = bScaleBelow1 ? i * dfScale : i - dfDelta;
+            else
+                dfX = bScaleBelow1 ? (i - dfDelta) * dfScale : i - dfDelta;
+            padfWeights[i - iMin] = pfnGetWeight(dfX);
+            dfAccumulatorWeight += padfWeights[i - iMin];
+        }
+        if( dfAccumulatorWeight < 0.000001 )
+            continue;
+
+        for( int i = iMin; i <= iMax; i++ )
+            padfWeights[i - iMin] /= dfAccumulatorWeight;
+        psAxis->panFirst[iDst] = iSrc + iMin;
+        psAxis->panCount[iDst] = iMax - iMin + 1;
+    }
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                       GWKSeparableCreate()                           */
+/*                                                                      */
+/*      Check whether the source column of each destination pixel       */
+/*      only depends on its destination column, and its source line     */
+/*      only on its destination line, up to the SEPARABLE_MAX_ERROR     */
+/*      warp option (in source pixels, 0.01 by default).  That is the   */
+/*      case of chunks where the transformation is close to an axis     */
+/*      aligned affine one.  The source coordinates of the middle line  */
+/*      and column of the destination window are then used for the     */
+/*      whole chunk, and the filter weights are precomputed for each    */
+/*      destination column and line.                                    */
+/************************************************************************/
+
+static GWKSeparableFilter* GWKSeparableCreate( GDALWarpKernel *poWK )
+{
+    const int nDstXSize = poWK->nDstXSize, nDstYSize = poWK->nDstYSize;
+    const int nSrcXSize = poWK->nSrcXSize, nSrcYSize = poWK->nSrcYSize;
+
+    // Cases that the per pixel methods handle with another algorithm.
+    if( nSrcXSize < 2 || nSrcYSize < 2 ||
+        poWK->nXRadius > nSrcXSize || poWK->nYRadius > nSrcYSize ||
+        CPLAtof(CSLFetchNameValueDef(poWK->papszWarpOptions,
+                                     "SRC_COORD_PRECISION", "0")) > 0.0 )
+        return NULL;
+
+    const double dfMaxError = CPLAtof(
+        CSLFetchNameValueDef(poWK->papszWarpOptions,
+                             "SEPARABLE_MAX_ERROR", "0.01"));
+
+    const int nMaxSize = MAX(nDstXSize, nDstYSize);
+    double *padfX = (double *) VSI_MALLOC2_VERBOSE(sizeof(double), nMaxSize);
+    double *padfY = (double *) VSI_MALLOC2_VERBOSE(sizeof(double), nMaxSize);
+    double *padfZ = (double *) VSI_MALLOC2_VERBOSE(sizeof(double), nMaxSize);
+    int *pabSuccess = (int *) VSI_MALLOC2_VERBOSE(sizeof(int), nMaxSize);
+    double *padfColSrcX = (double *)
+        VSI_MALLOC2_VERBOSE(sizeof(double), nDstXSize);
+    double *padfRowSrcY = (double *)
+        VSI_MALLOC2_VERBOSE(sizeof(double), nDstYSize);
+    int bSeparable = ( padfX != NULL && padfY != NULL && padfZ != NULL &&
+                       pabSuccess != NULL && padfColSrcX != NULL &&
+                       padfRowSrcY != NULL );
+
+/* -------------------------------------------------------------------- */
+/*      Transform the middle line and the middle column.                */
+/* -------------------------------------------------------------------- */
+    const int iMidX = nDstXSize / 2, iMidY = nDstYSize / 2;
+    for( int iPass = 0; bSeparable && iPass < 2; iPass++ )
+    {
+        const int nCount = (iPass == 0) ? nDstXSize : nDstYSize;
+        for( int i = 0; i < nCount; i++ )
+        {
+            padfX[i] = ((iPass == 0) ? i : iMidX) + 0.5 + poWK->nDstXOff;
+            padfY[i] = ((iPass == 0) ? iMidY : i) + 0.5 + poWK->nDstYOff;
+            padfZ[i] = 0.0;
+        }
+        poWK->pfnTransformer( poWK->pTransformerArg, TRUE, nCount,
+                              padfX, padfY, padfZ, pabSuccess );
+        for( int i = 0; bSeparable && i < nCount; i++ )
+        {
+            if( !pabSuccess[i] )
+                bSeparable = FALSE;
+            else if( iPass == 0 )
+                padfColSrcX[i] = padfX[i];
+            else
+                padfRowSrcY[i] = padfY[i];
+        }
+        for( int i = 0; bSeparable && i < nCount; i++ )
+        {
+            if( iPass == 0 ?
+                    fabs(padfY[i] - padfY[iMidX]) > dfMaxError :
+                    fabs(padfX[i] - padfColSrcX[iMidX]) > dfMaxError )
+                bSeparable = FALSE;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Check a grid of points spread over the destination window.      */
+/* -------------------------------------------------------------------- */
+    const int nXSteps = MIN(16, nDstXSize - 1);
+    const int nYSteps = MIN(16, nDstYSize - 1);
+    for( int iYStep = 0; bSeparable && iYStep <= nYSteps; iYStep++ )
+    {
+        const int iDstY = (nYSteps == 0) ? 0 :
+            (int) ((double) iYStep * (nDstYSize - 1) / nYSteps);
+        for( int iXStep = 0; iXStep <= nXSteps; iXStep++ )
+        {
+            const int iDstX = (nXSteps == 0) ? 0 :
+                (int) ((double) iXStep * (nDstXSize - 1) / nXSteps);
+            padfX[iXStep] = iDstX + 0.5 + poWK->nDstXOff;
+            padfY[iXStep] = iDstY + 0.5 + poWK->nDstYOff;
+            padfZ[iXStep] = 0.0;
+        }
+        poWK->pfnTransformer( poWK->pTransformerArg, TRUE, nXSteps + 1,
+                              padfX, padfY, padfZ, pabSuccess );
+        for( int iXStep = 0; bSeparable && iXStep <= nXSteps; iXStep++ )
+        {
+            const int iDstX = (nXSteps == 0) ? 0 :
+                (int) ((double) iXStep * (nDstXSize - 1) / nXSteps);
+            if( !pabSuccess[iXStep] ||
+                fabs(padfX[iXStep] - padfColSrcX[iDstX]) > dfMaxError ||
+                fabs(padfY[iXStep] - padfRowSrcY[iDstY]) > dfMaxError )
+                bSeparable = FALSE;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Precompute the weights.                                         */
+/* -------------------------------------------------------------------- */
+    GWKSeparableFilter* psFilter = NULL;
+    if( bSeparable )
+    {
+        psFilter = (GWKSeparableFilter *)
+            VSI_CALLOC_VERBOSE(1, sizeof(GWKSeparableFilter));
+        if( psFilter == NULL ||
+            !GWKSeparableComputeWeights( poWK, padfColSrcX, nDstXSize,
+                                         poWK->nSrcXOff, nSrcXSize,
+                                         poWK->dfXScale, poWK->nFiltInitX,
+                                         poWK->nXRadius, &(psFilter->sX) ) ||
+            !GWKSeparableComputeWeights( poWK, padfRowSrcY, nDstYSize,
+                                         poWK->nSrcYOff, nSrcYSize,
+                                         poWK->dfYScale, poWK->nFiltInitY,
+                                         poWK->nYRadius, &(psFilter->sY) ) )
+        {
+            GWKSeparableDestroy( psFilter );
+            psFilter = NULL;
+        }
+    }
+
+    CPLFree( padfX );
+    CPLFree( padfY );
+    CPLFree( padfZ );
+    CPLFree( pabSuccess );
+    CPLFree( padfColSrcX );
+    CPLFree( padfRowSrcY );
+
+    return psFilter;
+}
+
+/************************************************************************/
+/*                        GWKSeparableThread()                          */
+/*                                                                      */
+/*      Two pass convolution: source lines are first filtered           */
+/*      horizontally to the destination columns, and the destination    */
+/*      lines are then computed from them with the vertical weights.    */
+/*      Filtered source lines are kept in a ring buffer, indexed by     */
+/*      source line modulo its size, which is the maximum kernel        */
+/*      height, so that they are reused by consecutive destination      */
+/*      lines.                                                          */
+/************************************************************************/
+
+template<class T>
+static void GWKSeparableThread( void* pData )
+{
+    GWKJobStruct* psJob = (GWKJobStruct*) pData;
+    GDALWarpKernel *poWK = psJob->poWK;
+    const GWKSeparableFilter* psFilter =
+        (const GWKSeparableFilter*) psJob->pUserData;
+    const GWKSeparableAxis* psX = &(psFilter->sX);
+    const GWKSeparableAxis* psY = &(psFilter->sY);
+    const int nDstXSize = poWK->nDstXSize;
+    const int nSrcXSize = poWK->nSrcXSize;
+    const int nBands = poWK->nBands;
+    const int nRingLines = psY->nTaps;
+
+    double *padfRing = (double *)
+        CPLMalloc(sizeof(double) * nDstXSize * nRingLines * nBands);
+    int *panRingSrcY = (int *) CPLMalloc(sizeof(int) * nRingLines * nBands);
+    double *padfAcc = (double *) CPLMalloc(sizeof(double) * nDstXSize);
+    for( int i = 0; i < nRingLines * nBands; i++ )
+        panRingSrcY[i] = -1;
+
+    for( int iDstY = GWKFirstLine(psJob); iDstY >= 0;
+         iDstY = GWKNextLine(psJob, iDstY) )
+    {
+        const int iSrcYFirst = psY->panFirst[iDstY];
+        const int nSrcYCount = psY->panCount[iDstY];
+        const double *padfWeightsY = psY->padfWeights + iDstY * psY->nTaps;
+
+        for( int iBand = 0; iBand < nBands && iSrcYFirst >= 0; iBand++ )
+        {
+            const T *pSrcBand = (const T *) poWK->papabySrcImage[iBand];
+            T *pDstLine = (T *) poWK->papabyDstImage[iBand] +
+                                                iDstY * nDstXSize;
+
+            for( int iDstX = 0; iDstX < nDstXSize; iDstX++ )
+                padfAcc[iDstX] = 0.0;
+
+            for( int j = 0; j < nSrcYCount; j++ )
+            {
+                const int iSrcY = iSrcYFirst + j;
+                const int iSlot = iBand * nRingLines + iSrcY % nRingLines;
+                double *padfLine = padfRing + (size_t)iSlot * nDstXSize;
+
+/* -------------------------------------------------------------------- */
+/*      Horizontal pass, if that source line is not in the ring yet.    */
+/* -------------------------------------------------------------------- */
+                if( panRingSrcY[iSlot] != iSrcY )
+                {
+                    const T *pSrcLine = pSrcBand + (size_t)iSrcY * nSrcXSize;
+                    for( int iDstX = 0; iDstX < nDstXSize; iDstX++ )
+                    {
+                        const T *pSrc = pSrcLine + psX->panFirst[iDstX];
+                        const double *padfWeightsX =
+                            psX->padfWeights + iDstX * psX->nTaps;
+                        const int nCount = psX->panCount[iDstX];
+                        double dfAccumulator = 0.0;
+                        for( int i = 0; i < nCount; i++ )
+                            dfAccumulator += (double)pSrc[i] * padfWeightsX[i];
+                        padfLine[iDstX] = dfAccumulator;
+                    }
+                    panRingSrcY[iSlot] = iSrcY;
+                }
+
+/* -------------------------------------------------------------------- */
+/*      Vertical pass.                                                  */
+/* -------------------------------------------------------------------- */
+                const double dfWeight = padfWeightsY[j];
+                for( int iDstX = 0; iDstX < nDstXSize; iDstX++ )
+                    padfAcc[iDstX] += padfLine[iDstX] * dfWeight;
+            }
+
+            for( int iDstX = 0; iDstX < nDstXSize; iDstX++ )
+            {
+                if( psX->panFirst[iDstX] >= 0 )
+                    pDstLine[iDstX] = GWKClampValueT<T>(padfAcc[iDstX]);
+            }
+        }
+
+        if( poWK->pafDstDensity && iSrcYFirst >= 0 )
+        {
+            for( int iDstX = 0; iDstX < nDstXSize; iDstX++ )
+            {
+                if( psX->panFirst[iDstX] >= 0 )
+                    poWK->pafDstDensity[iDstX + iDstY * nDstXSize] = 1.0f;
+            }
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Report progress to the user, and optionally cancel out.         */
+/* -------------------------------------------------------------------- */
+        if (psJob->pfnProgress && psJob->pfnProgress(psJob))
+            break;
+    }
+
+    CPLFree( padfRing );
+    CPLFree( panRingSrcY );
+    CPLFree( padfAcc );
+}
+
+/************************************************************************/
+/*                         GWKSeparableCase()                           */
+/*                                                                      */
+/*      Case for non masked Byte, Int16, UInt16 and Float32 data with   */
+/*      a kernel based resampling, when the transformation of the       */
+/*      chunk is separable.  Returns CE_Warning, without doing          */
+/*      anything, if it is not.                                         */
+/************************************************************************/
+
+static CPLErr GWKSeparableCase( GDALWarpKernel *poWK )
+{
+    GWKSeparableFilter* psFilter = GWKSeparableCreate( poWK );
+    if( psFilter == NULL )
+        return CE_Warning;
+
+    CPLErr eErr;
+    switch( poWK->eWorkingDataType )
+    {
+        case GDT_Byte:
+            eErr = GWKRun( poWK, "GWKSeparableCase",
+                           GWKSeparableThread<GByte>, psFilter );
+            break;
+        case GDT_Int16:
+            eErr = GWKRun( poWK, "GWKSeparableCase",
+                           GWKSeparableThread<GInt16>, psFilter );
+            break;
+        case GDT_UInt16:
+            eErr = GWKRun( poWK, "GWKSeparableCase",
+                           GWKSeparableThread<GUInt16>, psFilter );
+            break;
+        case GDT_Float32:
+            eErr = GWKRun( poWK, "GWKSeparableCase",
+                           GWKSeparableThread<float>, psFilter );
+            break;
+        default:
+            CPLAssert(FALSE);
+            eErr = CE_Warning;
+            break;
+    }
+
+    GWKSeparableDestroy( psFilter );
+    return eErr;
+}
+
 /************************************************************************/
 /*                           GWKAverageOrMode()                         */
 /*                                                                      */
@@ -4643,8 +5573,6 @@ static void GWKAverageOrModeThread( void* pData)
 {
     GWKJobStruct* psJob = (GWKJobStruct*) pData;
     GDALWarpKernel *poWK = psJob->poWK;
-    int iYMin = psJob->iYMin;
-    int iYMax = psJob->iYMax;
 
     int iDstY, iDstX, iSrcX, iSrcY, iDstOffset;
     int nDstXSize = poWK->nDstXSize;
@@ -4773,7 +5701,8 @@ static void GWKAverageOrModeThread( void* pData)
 /* ==================================================================== */
 /*      Loop over output lines.                                         */
 /* ==================================================================== */
-    for( iDstY = iYMin; iDstY < iYMax; iDstY++ )
+    for( iDstY = GWKFirstLine(psJob); iDstY >= 0;
+         iDstY = GWKNextLine(psJob, iDstY) )
     {
 
 /* -------------------------------------------------------------------- */
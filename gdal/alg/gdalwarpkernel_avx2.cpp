@@ -0,0 +1,410 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  High Performance Image Reprojector
+ * Purpose:  AVX2 implementation of the bilinear and cubic resampling of
+ *           GDALWarpKernel.
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gdalwarpkernel_avx2.h"
+
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+#include <immintrin.h>
+
+#include <algorithm>
+#include <limits>
+
+CPL_CVSID("$Id$");
+
+/* The points are processed 4 at a time, one per 64 bit lane, with the   */
+/* same sequence of double precision operations as the scalar code, so   */
+/* that the results are identical.  Source samples are fetched with      */
+/* gather instructions.                                                  */
+
+/************************************************************************/
+/*                        GWKAVX2GatherRow2()                           */
+/*                                                                      */
+/*      Fetch the samples at offset and offset+1 of 4 points.           */
+/************************************************************************/
+
+static CPL_INLINE void GWKAVX2GatherRow2( const GByte* pSrc,
+                                          __m128i xmm_offset,
+                                          __m256d& ymm_f0, __m256d& ymm_f1 )
+{
+    const __m128i xmm_mask = _mm_set1_epi32(0xFF);
+    const __m128i xmm_v =
+        _mm_i32gather_epi32( reinterpret_cast<const int*>(pSrc), xmm_offset, 1 );
+    ymm_f0 = _mm256_cvtepi32_pd( _mm_and_si128(xmm_v, xmm_mask) );
+    ymm_f1 = _mm256_cvtepi32_pd(
+        _mm_and_si128(_mm_srli_epi32(xmm_v, 8), xmm_mask) );
+}
+
+static CPL_INLINE void GWKAVX2GatherRow2( const GUInt16* pSrc,
+                                          __m128i xmm_offset,
+                                          __m256d& ymm_f0, __m256d& ymm_f1 )
+{
+    const __m128i xmm_v =
+        _mm_i32gather_epi32( reinterpret_cast<const int*>(pSrc), xmm_offset, 2 );
+    ymm_f0 = _mm256_cvtepi32_pd( _mm_and_si128(xmm_v, _mm_set1_epi32(0xFFFF)) );
+    ymm_f1 = _mm256_cvtepi32_pd( _mm_srli_epi32(xmm_v, 16) );
+}
+
+static CPL_INLINE void GWKAVX2GatherRow2( const GInt16* pSrc,
+                                          __m128i xmm_offset,
+                                          __m256d& ymm_f0, __m256d& ymm_f1 )
+{
+    const __m128i xmm_v =
+        _mm_i32gather_epi32( reinterpret_cast<const int*>(pSrc), xmm_offset, 2 );
+    ymm_f0 = _mm256_cvtepi32_pd( _mm_srai_epi32(_mm_slli_epi32(xmm_v, 16), 16) );
+    ymm_f1 = _mm256_cvtepi32_pd( _mm_srai_epi32(xmm_v, 16) );
+}
+
+static CPL_INLINE void GWKAVX2GatherRow2( const float* pSrc,
+                                          __m128i xmm_offset,
+                                          __m256d& ymm_f0, __m256d& ymm_f1 )
+{
+    ymm_f0 = _mm256_cvtps_pd( _mm_i32gather_ps(pSrc, xmm_offset, 4) );
+    ymm_f1 = _mm256_cvtps_pd(
+        _mm_i32gather_ps(pSrc, _mm_add_epi32(xmm_offset, _mm_set1_epi32(1)), 4) );
+}
+
+/************************************************************************/
+/*                        GWKAVX2GatherRow4()                           */
+/*                                                                      */
+/*      Fetch the samples at offset-1 to offset+2 of 4 points.          */
+/************************************************************************/
+
+template<class T>
+static CPL_INLINE void GWKAVX2GatherRow4( const T* pSrc, __m128i xmm_offset,
+                                          __m256d& ymm_f0, __m256d& ymm_f1,
+                                          __m256d& ymm_f2, __m256d& ymm_f3 )
+{
+    GWKAVX2GatherRow2( pSrc, _mm_sub_epi32(xmm_offset, _mm_set1_epi32(1)),
+                       ymm_f0, ymm_f1 );
+    GWKAVX2GatherRow2( pSrc, _mm_add_epi32(xmm_offset, _mm_set1_epi32(1)),
+                       ymm_f2, ymm_f3 );
+}
+
+template<>
+CPL_INLINE void GWKAVX2GatherRow4<GByte>( const GByte* pSrc, __m128i xmm_offset,
+                                          __m256d& ymm_f0, __m256d& ymm_f1,
+                                          __m256d& ymm_f2, __m256d& ymm_f3 )
+{
+    const __m128i xmm_mask = _mm_set1_epi32(0xFF);
+    const __m128i xmm_v =
+        _mm_i32gather_epi32( reinterpret_cast<const int*>(pSrc),
+                             _mm_sub_epi32(xmm_offset, _mm_set1_epi32(1)), 1 );
+    ymm_f0 = _mm256_cvtepi32_pd( _mm_and_si128(xmm_v, xmm_mask) );
+    ymm_f1 = _mm256_cvtepi32_pd(
+        _mm_and_si128(_mm_srli_epi32(xmm_v, 8), xmm_mask) );
+    ymm_f2 = _mm256_cvtepi32_pd(
+        _mm_and_si128(_mm_srli_epi32(xmm_v, 16), xmm_mask) );
+    ymm_f3 = _mm256_cvtepi32_pd( _mm_srli_epi32(xmm_v, 24) );
+}
+
+/************************************************************************/
+/*                            GWKAVX2Load()                             */
+/*                                                                      */
+/*      Load 4 coordinates, repeating the last valid one if there are   */
+/*      less than 4 of them left.                                       */
+/************************************************************************/
+
+static CPL_INLINE __m256d GWKAVX2Load( const double* padfValue, int nValid )
+{
+    if( nValid == 4 )
+        return _mm256_loadu_pd( padfValue );
+
+    double adfValue[4];
+    for( int i = 0; i < 4; i++ )
+        adfValue[i] = padfValue[std::min(i, nValid - 1)];
+    return _mm256_loadu_pd( adfValue );
+}
+
+/************************************************************************/
+/*                          GWKAVX2Clamp()                              */
+/************************************************************************/
+
+template<class T>
+static CPL_INLINE __m256d GWKAVX2Clamp( __m256d ymm_v )
+{
+    ymm_v = _mm256_max_pd( ymm_v,
+                           _mm256_set1_pd(std::numeric_limits<T>::min()) );
+    return _mm256_min_pd( ymm_v,
+                          _mm256_set1_pd(std::numeric_limits<T>::max()) );
+}
+
+template<>
+CPL_INLINE __m256d GWKAVX2Clamp<float>( __m256d ymm_v )
+{
+    return ymm_v;
+}
+
+/************************************************************************/
+/*                         GWKAVX2RoundStore()                          */
+/*                                                                      */
+/*      Round like GWKRoundValueT() and store the nValid first values.  */
+/************************************************************************/
+
+template<class T>
+static CPL_INLINE void GWKAVX2RoundStore( __m256d ymm_v, const int* panDstX,
+                                          int nValid, T* pDstLine )
+{
+    ymm_v = _mm256_add_pd( ymm_v, _mm256_set1_pd(0.5) );
+    if( std::numeric_limits<T>::is_signed )
+        ymm_v = _mm256_floor_pd( ymm_v );
+
+    int anValue[4];
+    _mm_storeu_si128( reinterpret_cast<__m128i*>(anValue),
+                      _mm256_cvttpd_epi32(ymm_v) );
+    for( int i = 0; i < nValid; i++ )
+        pDstLine[panDstX[i]] = static_cast<T>(anValue[i]);
+}
+
+template<>
+CPL_INLINE void GWKAVX2RoundStore<float>( __m256d ymm_v, const int* panDstX,
+                                          int nValid, float* pDstLine )
+{
+    float afValue[4];
+    _mm_storeu_ps( afValue, _mm256_cvtpd_ps(ymm_v) );
+    for( int i = 0; i < nValid; i++ )
+        pDstLine[panDstX[i]] = afValue[i];
+}
+
+/************************************************************************/
+/*                    GWKAVX2CubicConvolution()                         */
+/*                                                                      */
+/*      Same as the CubicConvolution() macro of gdalwarpkernel.cpp.     */
+/************************************************************************/
+
+static CPL_INLINE __m256d GWKAVX2CubicConvolution( __m256d ymm_d1,
+                                                   __m256d ymm_d2,
+                                                   __m256d ymm_d3,
+                                                   __m256d ymm_f0,
+                                                   __m256d ymm_f1,
+                                                   __m256d ymm_f2,
+                                                   __m256d ymm_f3 )
+{
+    // distance1*(f2 - f0)
+    const __m256d ymm_t1 =
+        _mm256_mul_pd( ymm_d1, _mm256_sub_pd(ymm_f2, ymm_f0) );
+    // distance2*(2.0*f0 - 5.0*f1 + 4.0*f2 - f3)
+    const __m256d ymm_t2 = _mm256_mul_pd( ymm_d2,
+        _mm256_sub_pd(
+            _mm256_add_pd(
+                _mm256_sub_pd(_mm256_mul_pd(_mm256_set1_pd(2.0), ymm_f0),
+                              _mm256_mul_pd(_mm256_set1_pd(5.0), ymm_f1)),
+                _mm256_mul_pd(_mm256_set1_pd(4.0), ymm_f2)),
+            ymm_f3) );
+    // distance3*(3.0*(f1 - f2) + f3 - f0)
+    const __m256d ymm_t3 = _mm256_mul_pd( ymm_d3,
+        _mm256_sub_pd(
+            _mm256_add_pd(
+                _mm256_mul_pd(_mm256_set1_pd(3.0),
+                              _mm256_sub_pd(ymm_f1, ymm_f2)),
+                ymm_f3),
+            ymm_f0) );
+    return _mm256_add_pd( ymm_f1,
+        _mm256_mul_pd( _mm256_set1_pd(0.5),
+                       _mm256_add_pd(_mm256_add_pd(ymm_t1, ymm_t2), ymm_t3) ) );
+}
+
+/************************************************************************/
+/*              GWKBilinearResampleNoMasks4SampleRowAVX2T()             */
+/************************************************************************/
+
+template<class T>
+static void GWKBilinearResampleNoMasks4SampleRowAVX2T(
+    const T* pSrc, int nSrcXSize, const double* padfX, const double* padfY,
+    const int* panDstX, int nCount, T* pDstLine )
+{
+    const __m256d ymm_half = _mm256_set1_pd(0.5);
+    const __m256d ymm_one = _mm256_set1_pd(1.0);
+    const __m256d ymm_one_and_half = _mm256_set1_pd(1.5);
+    const __m128i xmm_stride = _mm_set1_epi32(nSrcXSize);
+
+    for( int i = 0; i < nCount; i += 4 )
+    {
+        const int nValid = std::min(4, nCount - i);
+        const __m256d ymm_x = GWKAVX2Load( padfX + i, nValid );
+        const __m256d ymm_y = GWKAVX2Load( padfY + i, nValid );
+
+        // iSrcX = floor(dfSrcX - 0.5), dfRatioX = 1.5 - (dfSrcX - iSrcX)
+        const __m256d ymm_ix = _mm256_floor_pd( _mm256_sub_pd(ymm_x, ymm_half) );
+        const __m256d ymm_iy = _mm256_floor_pd( _mm256_sub_pd(ymm_y, ymm_half) );
+        const __m128i xmm_offset = _mm_add_epi32(
+            _mm256_cvttpd_epi32(ymm_ix),
+            _mm_mullo_epi32(_mm256_cvttpd_epi32(ymm_iy), xmm_stride) );
+        const __m256d ymm_rx =
+            _mm256_sub_pd( ymm_one_and_half, _mm256_sub_pd(ymm_x, ymm_ix) );
+        const __m256d ymm_ry =
+            _mm256_sub_pd( ymm_one_and_half, _mm256_sub_pd(ymm_y, ymm_iy) );
+        const __m256d ymm_rx1 = _mm256_sub_pd( ymm_one, ymm_rx );
+        const __m256d ymm_ry1 = _mm256_sub_pd( ymm_one, ymm_ry );
+
+        __m256d ymm_f00, ymm_f01, ymm_f10, ymm_f11;
+        GWKAVX2GatherRow2( pSrc, xmm_offset, ymm_f00, ymm_f01 );
+        GWKAVX2GatherRow2( pSrc, _mm_add_epi32(xmm_offset, xmm_stride),
+                           ymm_f10, ymm_f11 );
+
+        const __m256d ymm_v = _mm256_add_pd(
+            _mm256_mul_pd( _mm256_add_pd(_mm256_mul_pd(ymm_f00, ymm_rx),
+                                         _mm256_mul_pd(ymm_f01, ymm_rx1)),
+                           ymm_ry ),
+            _mm256_mul_pd( _mm256_add_pd(_mm256_mul_pd(ymm_f10, ymm_rx),
+                                         _mm256_mul_pd(ymm_f11, ymm_rx1)),
+                           ymm_ry1 ) );
+
+        GWKAVX2RoundStore( ymm_v, panDstX + i, nValid, pDstLine );
+    }
+}
+
+/************************************************************************/
+/*                GWKCubicResampleNoMasks4SampleRowAVX2T()              */
+/************************************************************************/
+
+template<class T>
+static void GWKCubicResampleNoMasks4SampleRowAVX2T(
+    const T* pSrc, int nSrcXSize, const double* padfX, const double* padfY,
+    const int* panDstX, int nCount, T* pDstLine )
+{
+    const __m256d ymm_half = _mm256_set1_pd(0.5);
+    const __m128i xmm_stride = _mm_set1_epi32(nSrcXSize);
+
+    for( int i = 0; i < nCount; i += 4 )
+    {
+        const int nValid = std::min(4, nCount - i);
+        const __m256d ymm_x =
+            _mm256_sub_pd( GWKAVX2Load(padfX + i, nValid), ymm_half );
+        const __m256d ymm_y =
+            _mm256_sub_pd( GWKAVX2Load(padfY + i, nValid), ymm_half );
+
+        // iSrcX = (int)(dfSrcX - 0.5), dfDeltaX = dfSrcX - 0.5 - iSrcX
+        const __m256d ymm_ix =
+            _mm256_round_pd( ymm_x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC );
+        const __m256d ymm_iy =
+            _mm256_round_pd( ymm_y, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC );
+        const __m128i xmm_offset = _mm_add_epi32(
+            _mm256_cvttpd_epi32(ymm_ix),
+            _mm_mullo_epi32(_mm256_cvttpd_epi32(ymm_iy), xmm_stride) );
+        const __m256d ymm_dx = _mm256_sub_pd( ymm_x, ymm_ix );
+        const __m256d ymm_dy = _mm256_sub_pd( ymm_y, ymm_iy );
+        const __m256d ymm_dx2 = _mm256_mul_pd( ymm_dx, ymm_dx );
+        const __m256d ymm_dy2 = _mm256_mul_pd( ymm_dy, ymm_dy );
+        const __m256d ymm_dx3 = _mm256_mul_pd( ymm_dx2, ymm_dx );
+        const __m256d ymm_dy3 = _mm256_mul_pd( ymm_dy2, ymm_dy );
+
+        __m256d aymm_value[4];
+        __m128i xmm_row_offset = _mm_sub_epi32( xmm_offset, xmm_stride );
+        for( int j = 0; j < 4; j++ )
+        {
+            __m256d ymm_f0, ymm_f1, ymm_f2, ymm_f3;
+            GWKAVX2GatherRow4( pSrc, xmm_row_offset,
+                               ymm_f0, ymm_f1, ymm_f2, ymm_f3 );
+            aymm_value[j] = GWKAVX2CubicConvolution(
+                ymm_dx, ymm_dx2, ymm_dx3, ymm_f0, ymm_f1, ymm_f2, ymm_f3 );
+            xmm_row_offset = _mm_add_epi32( xmm_row_offset, xmm_stride );
+        }
+
+        const __m256d ymm_v = GWKAVX2CubicConvolution(
+            ymm_dy, ymm_dy2, ymm_dy3,
+            aymm_value[0], aymm_value[1], aymm_value[2], aymm_value[3] );
+
+        GWKAVX2RoundStore( GWKAVX2Clamp<T>(ymm_v), panDstX + i, nValid,
+                           pDstLine );
+    }
+}
+
+/************************************************************************/
+/*               GWKBilinearResampleNoMasks4SampleRowAVX2()             */
+/************************************************************************/
+
+void GWKBilinearResampleNoMasks4SampleRowAVX2(
+    const GByte* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, GByte* pDstLine )
+{
+    GWKBilinearResampleNoMasks4SampleRowAVX2T( pSrc, nSrcXSize, padfX, padfY,
+                                               panDstX, nCount, pDstLine );
+}
+
+void GWKBilinearResampleNoMasks4SampleRowAVX2(
+    const GUInt16* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, GUInt16* pDstLine )
+{
+    GWKBilinearResampleNoMasks4SampleRowAVX2T( pSrc, nSrcXSize, padfX, padfY,
+                                               panDstX, nCount, pDstLine );
+}
+
+void GWKBilinearResampleNoMasks4SampleRowAVX2(
+    const GInt16* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, GInt16* pDstLine )
+{
+    GWKBilinearResampleNoMasks4SampleRowAVX2T( pSrc, nSrcXSize, padfX, padfY,
+                                               panDstX, nCount, pDstLine );
+}
+
+void GWKBilinearResampleNoMasks4SampleRowAVX2(
+    const float* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, float* pDstLine )
+{
+    GWKBilinearResampleNoMasks4SampleRowAVX2T( pSrc, nSrcXSize, padfX, padfY,
+                                               panDstX, nCount, pDstLine );
+}
+
+/************************************************************************/
+/*                GWKCubicResampleNoMasks4SampleRowAVX2()               */
+/************************************************************************/
+
+void GWKCubicResampleNoMasks4SampleRowAVX2(
+    const GByte* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, GByte* pDstLine )
+{
+    GWKCubicResampleNoMasks4SampleRowAVX2T( pSrc, nSrcXSize, padfX, padfY,
+                                            panDstX, nCount, pDstLine );
+}
+
+void GWKCubicResampleNoMasks4SampleRowAVX2(
+    const GUInt16* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, GUInt16* pDstLine )
+{
+    GWKCubicResampleNoMasks4SampleRowAVX2T( pSrc, nSrcXSize, padfX, padfY,
+                                            panDstX, nCount, pDstLine );
+}
+
+void GWKCubicResampleNoMasks4SampleRowAVX2(
+    const GInt16* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, GInt16* pDstLine )
+{
+    GWKCubicResampleNoMasks4SampleRowAVX2T( pSrc, nSrcXSize, padfX, padfY,
+                                            panDstX, nCount, pDstLine );
+}
+
+void GWKCubicResampleNoMasks4SampleRowAVX2(
+    const float* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, float* pDstLine )
+{
+    GWKCubicResampleNoMasks4SampleRowAVX2T( pSrc, nSrcXSize, padfX, padfY,
+                                            panDstX, nCount, pDstLine );
+}
+
+#endif /* HAVE_AVX2_AT_COMPILE_TIME */
@@ -0,0 +1,73 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  High Performance Image Reprojector
+ * Purpose:  AVX2 implementation of the bilinear and cubic resampling of
+ *           GDALWarpKernel.
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef GDALWARPKERNEL_AVX2_H_INCLUDED
+#define GDALWARPKERNEL_AVX2_H_INCLUDED
+
+#include "cpl_port.h"
+
+#ifdef HAVE_AVX2_AT_COMPILE_TIME
+
+/* These resample nCount points of a destination line, given by their    */
+/* source pixel/line coordinates padfX/padfY (relative to the source     */
+/* window) and their destination column panDstX, into pDstLine.  They    */
+/* give the same results as GWKBilinearResampleNoMasks4SampleT() and     */
+/* GWKCubicResampleNoMasks4SampleT(), but may only be used for points    */
+/* whose kernel is entirely inside the source window, with one more      */
+/* source line below it, as source samples are read 4 bytes at a time.   */
+
+void GWKBilinearResampleNoMasks4SampleRowAVX2(
+    const GByte* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, GByte* pDstLine );
+void GWKBilinearResampleNoMasks4SampleRowAVX2(
+    const GUInt16* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, GUInt16* pDstLine );
+void GWKBilinearResampleNoMasks4SampleRowAVX2(
+    const GInt16* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, GInt16* pDstLine );
+void GWKBilinearResampleNoMasks4SampleRowAVX2(
+    const float* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, float* pDstLine );
+
+void GWKCubicResampleNoMasks4SampleRowAVX2(
+    const GByte* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, GByte* pDstLine );
+void GWKCubicResampleNoMasks4SampleRowAVX2(
+    const GUInt16* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, GUInt16* pDstLine );
+void GWKCubicResampleNoMasks4SampleRowAVX2(
+    const GInt16* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, GInt16* pDstLine );
+void GWKCubicResampleNoMasks4SampleRowAVX2(
+    const float* pSrc, int nSrcXSize, const double* padfX,
+    const double* padfY, const int* panDstX, int nCount, float* pDstLine );
+
+#endif /* HAVE_AVX2_AT_COMPILE_TIME */
+
+#endif /* ndef GDALWARPKERNEL_AVX2_H_INCLUDED */
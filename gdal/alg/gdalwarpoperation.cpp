@@ -31,6 +31,7 @@
 #include "gdalwarper.h"
 #include "cpl_string.h"
 #include "cpl_multiproc.h"
+#include "cpl_worker_thread_pool.h"
 #include "ogr_api.h"
 
 CPL_CVSID("$Id$");
@@ -757,7 +758,8 @@ typedef struct
 {
     GDALWarpOperation *poOperation;
     GDALWarpChunk     *pasChunkInfo;
-    CPLJoinableThread *hThreadHandle;
+    int                iChunk;
+    int                bReportTimings;
     CPLErr             eErr;
     double             dfProgressBase;
     double             dfProgressScale;
@@ -775,6 +777,7 @@ static void ChunkThreadMain( void *pThreadData )
     volatile ChunkThreadData* psData = (volatile ChunkThreadData*) pThreadData;
 
     GDALWarpChunk *pasChunkInfo = psData->pasChunkInfo;
+    const unsigned long nStartTime = VSITime(NULL);
 
 /* -------------------------------------------------------------------- */
 /*      Acquire IO mutex.                                               */
@@ -784,16 +787,19 @@ static void ChunkThreadMain( void *pThreadData )
         CPLError( CE_Failure, CPLE_AppDefined,
                     "Failed to acquire IOMutex in WarpRegion()." );
         psData->eErr = CE_Failure;
+
+        /* Do not let ChunkAndWarpMulti() wait forever for us */
+        CPLAcquireMutex( psData->hCondMutex, 1.0 );
+        psData->bIOMutexTaken = TRUE;
+        CPLCondSignal(psData->hCond);
+        CPLReleaseMutex( psData->hCondMutex );
     }
     else
     {
-        if (psData->hCond != NULL)
-        {
-            CPLAcquireMutex( psData->hCondMutex, 1.0 );
-            psData->bIOMutexTaken = TRUE;
-            CPLCondSignal(psData->hCond);
-            CPLReleaseMutex( psData->hCondMutex );
-        }
+        CPLAcquireMutex( psData->hCondMutex, 1.0 );
+        psData->bIOMutexTaken = TRUE;
+        CPLCondSignal(psData->hCond);
+        CPLReleaseMutex( psData->hCondMutex );
 
         psData->eErr = psData->poOperation->WarpRegion(
                                     pasChunkInfo->dx, pasChunkInfo->dy,
@@ -809,6 +815,15 @@ static void ChunkThreadMain( void *pThreadData )
     /* -------------------------------------------------------------------- */
         CPLReleaseMutex( psData->hIOMutex );
     }
+
+    if( psData->bReportTimings )
+    {
+        CPLDebug( "WARP_TIMING", "Chunk %d (%d,%d %dx%d): %lds",
+                  psData->iChunk,
+                  pasChunkInfo->dx, pasChunkInfo->dy,
+                  pasChunkInfo->dsx, pasChunkInfo->dsy,
+                  (long)(VSITime(NULL) - nStartTime) );
+    }
 }
 
 /************************************************************************/
@@ -827,6 +842,14 @@ static void ChunkThreadMain( void *pThreadData )
  * internally this method uses multiple threads to interleave input/output
  * for one region while the processing is being done for another.
  *
+ * Starting with GDAL 2.2, the chunks are run by a pool of worker threads,
+ * with up to three chunks in flight: one doing I/O, one being warped and one
+ * waiting for its next step, so that neither stage waits for the other when
+ * chunks have uneven costs. With the STREAMABLE_OUTPUT warp option, two
+ * chunks at most are in flight so that output is written in order. Chunks
+ * are always read in order. With the REPORT_TIMINGS warp option, the time
+ * spent on each chunk is reported.
+ *
  * @param nDstXOff X offset to window of destination data to be produced.
  * @param nDstYOff Y offset to window of destination data to be produced.
  * @param nDstXSize Width of output window on destination file to be produced.
@@ -860,101 +883,100 @@ CPLErr GDALWarpOperation::ChunkAndWarpMulti(
         qsort(pasChunkList, nChunkListCount, sizeof(GDALWarpChunk), OrderWarpChunk);
 
 /* -------------------------------------------------------------------- */
-/*      Process them one at a time, updating the progress               */
-/*      information for each region.                                    */
+/*      Chunks are warped one at a time (the warp kernel uses its own   */
+/*      threads) and I/O is serialized, so a third chunk in flight is   */
+/*      enough to keep both busy. Beyond two, the order of the writes   */
+/*      is no longer guaranteed.                                        */
 /* -------------------------------------------------------------------- */
-    ChunkThreadData volatile asThreadData[2];
-    memset((void*)&asThreadData, 0, sizeof(asThreadData));
-    asThreadData[0].poOperation = this;
-    asThreadData[0].hIOMutex = hIOMutex;
-    asThreadData[1].poOperation = this;
-    asThreadData[1].hIOMutex = hIOMutex;
-
-    int iChunk;
-    double dfPixelsProcessed=0.0, dfTotalPixels = nDstXSize*(double)nDstYSize;
+    const int nMaxChunksInFlight =
+        CSLFetchBoolean( psOptions->papszWarpOptions, "STREAMABLE_OUTPUT",
+                         FALSE ) ? 2 : 3;
 
+    CPLWorkerThreadPool oThreadPool;
     CPLErr eErr = CE_None;
-    for( iChunk = 0; iChunk < nChunkListCount+1; iChunk++ )
+    if( nChunkListCount > 0 &&
+        !oThreadPool.Setup( MIN(nMaxChunksInFlight, nChunkListCount),
+                            NULL, NULL ) )
     {
-        int    iThread = iChunk % 2;
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Cannot create worker threads in ChunkAndWarpMulti()" );
+        eErr = CE_Failure;
+    }
 
 /* -------------------------------------------------------------------- */
-/*      Launch thread for this chunk.                                   */
+/*      Submit the chunks, updating the progress information for each   */
+/*      region.                                                         */
 /* -------------------------------------------------------------------- */
-        if( pasChunkList != NULL && iChunk < nChunkListCount )
-        {
-            GDALWarpChunk *pasThisChunk = pasChunkList + iChunk;
-            double dfChunkPixels = pasThisChunk->dsx * (double) pasThisChunk->dsy;
-
-            asThreadData[iThread].dfProgressBase = dfPixelsProcessed / dfTotalPixels;
-            asThreadData[iThread].dfProgressScale = dfChunkPixels / dfTotalPixels;
+    std::vector<ChunkThreadData> asThreadData(nChunkListCount);
+    if( nChunkListCount > 0 )
+        memset(&asThreadData[0], 0, nChunkListCount * sizeof(ChunkThreadData));
 
-            dfPixelsProcessed += dfChunkPixels;
+    double dfPixelsProcessed=0.0, dfTotalPixels = nDstXSize*(double)nDstYSize;
 
-            asThreadData[iThread].pasChunkInfo = pasThisChunk;
+    int iChunk;
+    for( iChunk = 0; iChunk < nChunkListCount && eErr == CE_None; iChunk++ )
+    {
+/* -------------------------------------------------------------------- */
+/*      Wait for a previous chunk to complete if there are already      */
+/*      enough in flight.                                               */
+/* -------------------------------------------------------------------- */
+        if( iChunk >= nMaxChunksInFlight )
+        {
+            oThreadPool.WaitCompletion( nMaxChunksInFlight - 1 );
 
-            if ( iChunk == 0 )
-            {
-                asThreadData[iThread].hCond = hCond;
-                asThreadData[iThread].hCondMutex = hCondMutex;
-            }
-            else
+            for( int i = 0; i < iChunk; i++ )
             {
-                asThreadData[iThread].hCond = NULL;
-                asThreadData[iThread].hCondMutex = NULL;
+                if( asThreadData[i].eErr != CE_None )
+                    eErr = asThreadData[i].eErr;
             }
-            asThreadData[iThread].bIOMutexTaken = FALSE;
-
-            CPLDebug( "GDAL", "Start chunk %d.", iChunk );
-            asThreadData[iThread].hThreadHandle =
-                CPLCreateJoinableThread( ChunkThreadMain, (void*) &asThreadData[iThread] );
-            if( asThreadData[iThread].hThreadHandle == NULL )
-            {
-                CPLError( CE_Failure, CPLE_AppDefined,
-                          "CPLCreateJoinableThread() failed in ChunkAndWarpMulti()" );
-                eErr = CE_Failure;
+            if( eErr != CE_None )
                 break;
-            }
-
-            /* Wait that the first thread has acquired the IO mutex before proceeding. */
-            /* (This will ensure that the first thread will run before the second one). */
-            if( iChunk == 0 )
-            {
-                CPLAcquireMutex(hCondMutex, 1.0);
-                while (asThreadData[iThread].bIOMutexTaken == FALSE)
-                    CPLCondWait(hCond, hCondMutex);
-                CPLReleaseMutex(hCondMutex);
-            }
         }
 
-/* -------------------------------------------------------------------- */
-/*      Wait for previous chunks thread to complete.                    */
-/* -------------------------------------------------------------------- */
-        if( iChunk > 0 )
-        {
-            iThread = (iChunk-1) % 2;
-
-            /* Wait for thread to finish. */
-            CPLJoinThread(asThreadData[iThread].hThreadHandle);
-            asThreadData[iThread].hThreadHandle = NULL;
+        GDALWarpChunk *pasThisChunk = pasChunkList + iChunk;
+        double dfChunkPixels = pasThisChunk->dsx * (double) pasThisChunk->dsy;
 
-            CPLDebug( "GDAL", "Finished chunk %d.", iChunk-1 );
+        ChunkThreadData* psData = &asThreadData[iChunk];
+        psData->poOperation = this;
+        psData->pasChunkInfo = pasThisChunk;
+        psData->iChunk = iChunk;
+        psData->bReportTimings = bReportTimings;
+        psData->eErr = CE_None;
+        psData->dfProgressBase = dfPixelsProcessed / dfTotalPixels;
+        psData->dfProgressScale = dfChunkPixels / dfTotalPixels;
+        psData->hIOMutex = hIOMutex;
+        psData->hCond = hCond;
+        psData->hCondMutex = hCondMutex;
+        psData->bIOMutexTaken = FALSE;
 
-            eErr = asThreadData[iThread].eErr;
+        dfPixelsProcessed += dfChunkPixels;
 
-            if( eErr != CE_None )
-                break;
+        CPLDebug( "GDAL", "Start chunk %d.", iChunk );
+        if( !oThreadPool.SubmitJob( ChunkThreadMain, psData ) )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Cannot submit job in ChunkAndWarpMulti()" );
+            eErr = CE_Failure;
+            break;
         }
+
+        /* Wait that the chunk has acquired the IO mutex before submitting */
+        /* the next one, so that chunks are read in order. */
+        CPLAcquireMutex(hCondMutex, 1.0);
+        while( asThreadData[iChunk].bIOMutexTaken == FALSE )
+            CPLCondWait(hCond, hCondMutex);
+        CPLReleaseMutex(hCondMutex);
     }
 
-    /* -------------------------------------------------------------------- */
-    /*      Wait for all threads to complete.                               */
-    /* -------------------------------------------------------------------- */
-    int iThread;
-    for(iThread = 0; iThread < 2; iThread ++)
+/* -------------------------------------------------------------------- */
+/*      Wait for all chunks to complete.                                */
+/* -------------------------------------------------------------------- */
+    oThreadPool.WaitCompletion();
+
+    for( int i = 0; i < iChunk && eErr == CE_None; i++ )
     {
-        if (asThreadData[iThread].hThreadHandle)
-            CPLJoinThread(asThreadData[iThread].hThreadHandle);
+        if( asThreadData[i].eErr != CE_None )
+            eErr = asThreadData[i].eErr;
     }
 
     CPLDestroyCond(hCond);
@@ -0,0 +1,87 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Write the binary EPSG dictionary from the EPSG support files.
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_conv.h"
+#include "cpl_csv.h"
+#include "cpl_string.h"
+#include "ogr_p.h"
+#include "ogr_spatialref.h"
+
+CPL_CVSID("$Id$");
+
+/************************************************************************/
+/*                               Usage()                                */
+/************************************************************************/
+
+static void Usage()
+{
+    printf( "buildepsgdict [output_file]\n"
+            "\n"
+            "Builds every coordinate system of the EPSG support files and\n"
+            "writes their WKT in a binary dictionary that is used instead of\n"
+            "the CSV files to resolve EPSG codes.  By default, it is written\n"
+            "as epsg_wkt.bin next to gcs.csv, which is where it is looked for.\n" );
+    exit( 1 );
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main( int argc, char ** argv )
+
+{
+    const char *pszOutput = NULL;
+
+    argc = OGRGeneralCmdLineProcessor( argc, &argv, 0 );
+    if( argc < 1 )
+        exit( -argc );
+
+    for( int iArg = 1; iArg < argc; iArg++ )
+    {
+        if( argv[iArg][0] == '-' || pszOutput != NULL )
+            Usage();
+        pszOutput = argv[iArg];
+    }
+
+    CPLString osOutput;
+    if( pszOutput != NULL )
+        osOutput = pszOutput;
+    else
+        osOutput = CPLFormFilename( CPLGetPath( CSVFilename( "gcs.csv" ) ),
+                                    "epsg_wkt.bin", NULL );
+
+    const int nRet = OSRWriteEPSGDictionary( osOutput ) == OGRERR_NONE ? 0 : 1;
+    if( nRet == 0 )
+        printf( "Wrote %s.\n", osOutput.c_str() );
+
+    CSLDestroy( argv );
+    OSRCleanup();
+
+    return nRet;
+}
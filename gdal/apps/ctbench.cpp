@@ -0,0 +1,202 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Utilities
+ * Purpose:  Benchmark of coordinate transformations, with and without the
+ *           batched fast path of OGRProj4CT.
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "ogr_spatialref.h"
+#include "ogr_p.h"
+
+#include <algorithm>
+#include <cmath>
+#include <time.h>
+#include <vector>
+
+CPL_CVSID("$Id$");
+
+/************************************************************************/
+/*                               Usage()                                */
+/************************************************************************/
+
+static void Usage()
+{
+    printf( "ctbench [-n <points>] [-i <iterations>] <src_srs> <dst_srs>\n"
+            "\n"
+            "Transforms the specified number of points, spread around the\n"
+            "center of the area of the source SRS, with the fast path of\n"
+            "coordinate transformations and with PROJ.4 only\n"
+            "(OGR_CT_FAST_PATH=NO), and reports the throughput of each and\n"
+            "the largest difference between their results.\n" );
+    exit( 1 );
+}
+
+/************************************************************************/
+/*                           TimeTransform()                            */
+/*                                                                      */
+/*      Returns the number of points transformed per second.            */
+/************************************************************************/
+
+static double TimeTransform( OGRSpatialReference *poSrcSRS,
+                             OGRSpatialReference *poDstSRS,
+                             bool bFastPath, int nIterations,
+                             const std::vector<double>& adfX,
+                             const std::vector<double>& adfY,
+                             std::vector<double>& adfXOut,
+                             std::vector<double>& adfYOut )
+{
+    CPLSetConfigOption( "OGR_CT_FAST_PATH", bFastPath ? "YES" : "NO" );
+    OGRCoordinateTransformation *poCT =
+        OGRCreateCoordinateTransformation( poSrcSRS, poDstSRS );
+    CPLSetConfigOption( "OGR_CT_FAST_PATH", NULL );
+    if( poCT == NULL )
+        exit( 1 );
+
+    const int nPoints = static_cast<int>(adfX.size());
+    clock_t nTime = 0;
+    for( int i = 0; i < nIterations; i++ )
+    {
+        adfXOut = adfX;
+        adfYOut = adfY;
+        const clock_t nStart = clock();
+        poCT->Transform( nPoints, &adfXOut[0], &adfYOut[0] );
+        nTime += clock() - nStart;
+    }
+    delete poCT;
+
+    if( nTime == 0 )
+        nTime = 1;
+    return static_cast<double>(nPoints) * nIterations * CLOCKS_PER_SEC /
+           static_cast<double>(nTime);
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main( int argc, char ** argv )
+
+{
+    int nPoints = 1000000;
+    int nIterations = 5;
+    const char *pszSrcSRS = NULL;
+    const char *pszDstSRS = NULL;
+
+/* -------------------------------------------------------------------- */
+/*      Process arguments.                                              */
+/* -------------------------------------------------------------------- */
+    argc = OGRGeneralCmdLineProcessor( argc, &argv, 0 );
+    if( argc < 1 )
+        exit( -argc );
+
+    for( int iArg = 1; iArg < argc; iArg++ )
+    {
+        if( EQUAL(argv[iArg],"-n") && iArg < argc-1 )
+            nPoints = atoi(argv[++iArg]);
+        else if( EQUAL(argv[iArg],"-i") && iArg < argc-1 )
+            nIterations = atoi(argv[++iArg]);
+        else if( pszSrcSRS == NULL )
+            pszSrcSRS = argv[iArg];
+        else if( pszDstSRS == NULL )
+            pszDstSRS = argv[iArg];
+        else
+        {
+            printf( "Unrecognized argument: %s\n", argv[iArg] );
+            Usage();
+        }
+    }
+
+    if( pszDstSRS == NULL || nPoints <= 0 || nIterations <= 0 )
+        Usage();
+
+    OGRSpatialReference oSrcSRS;
+    OGRSpatialReference oDstSRS;
+    if( oSrcSRS.SetFromUserInput( pszSrcSRS ) != OGRERR_NONE ||
+        oDstSRS.SetFromUserInput( pszDstSRS ) != OGRERR_NONE )
+    {
+        printf( "Cannot parse SRS.\n" );
+        exit( 1 );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Spread the points over a few degrees around the central         */
+/*      meridian of the source SRS, and project them in it.             */
+/* -------------------------------------------------------------------- */
+    const double dfLon0 = oSrcSRS.IsProjected() ?
+        oSrcSRS.GetProjParm( SRS_PP_CENTRAL_MERIDIAN ) : 0.0;
+    const double dfLat0 = oSrcSRS.IsProjected() ?
+        oSrcSRS.GetProjParm( SRS_PP_LATITUDE_OF_ORIGIN ) : 0.0;
+    std::vector<double> adfX( nPoints );
+    std::vector<double> adfY( nPoints );
+    const int nSide = static_cast<int>(ceil(sqrt(static_cast<double>(nPoints))));
+    for( int i = 0; i < nPoints; i++ )
+    {
+        adfX[i] = dfLon0 - 2.5 + 5.0 * (i % nSide) / nSide;
+        adfY[i] = std::max(-80.0, std::min(80.0,
+                  dfLat0 + 20.0 - 40.0 * (i / nSide) / nSide));
+    }
+
+    OGRSpatialReference *poGeogSRS = oSrcSRS.CloneGeogCS();
+    OGRCoordinateTransformation *poCT =
+        OGRCreateCoordinateTransformation( poGeogSRS, &oSrcSRS );
+    if( poCT == NULL ||
+        !poCT->Transform( nPoints, &adfX[0], &adfY[0] ) )
+    {
+        printf( "Cannot generate points in source SRS.\n" );
+        exit( 1 );
+    }
+    delete poCT;
+    delete poGeogSRS;
+
+/* -------------------------------------------------------------------- */
+/*      Run the benchmark.                                              */
+/* -------------------------------------------------------------------- */
+    std::vector<double> adfXFast, adfYFast, adfXProj, adfYProj;
+    const double dfFast = TimeTransform( &oSrcSRS, &oDstSRS, true,
+                                         nIterations, adfX, adfY,
+                                         adfXFast, adfYFast );
+    const double dfProj = TimeTransform( &oSrcSRS, &oDstSRS, false,
+                                         nIterations, adfX, adfY,
+                                         adfXProj, adfYProj );
+
+    double dfMaxDiff = 0.0;
+    for( int i = 0; i < nPoints; i++ )
+    {
+        dfMaxDiff = std::max(dfMaxDiff, fabs(adfXFast[i] - adfXProj[i]));
+        dfMaxDiff = std::max(dfMaxDiff, fabs(adfYFast[i] - adfYProj[i]));
+    }
+
+    printf( "Fast path: %.3f Mpoints/s\n", dfFast / 1e6 );
+    printf( "PROJ.4:    %.3f Mpoints/s\n", dfProj / 1e6 );
+    printf( "Speed-up: %.2fx, max difference: %g\n",
+            dfFast / dfProj, dfMaxDiff );
+
+    CSLDestroy( argv );
+    OSRCleanup();
+
+    return 0;
+}
@@ -39,6 +39,7 @@
 #include "gdal_utils_priv.h"
 #include "gdal_alg.h"
 #include "commonutils.h"
+#include "cpl_worker_thread_pool.h"
 #include <map>
 #include <vector>
 
@@ -317,6 +318,11 @@ struct GDALVectorTranslateOptions
 
     /*! Whether layer and feature native data must be transferred. */
     bool bNativeData;
+
+    /*! number of threads used to translate features (field mapping, geometry operations and
+        reprojection), while reading and writing are done by the calling thread. 0 means that the
+        GDAL_NUM_THREADS configuration option is used. */
+    int nThreads;
 };
 
 typedef struct
@@ -340,6 +346,31 @@ typedef struct
     TargetLayerInfo  *psInfo;
 } AssociatedLayers;
 
+/* One part of a source feature (several with -explodecollections), */
+/* translated to the target layer but not yet written. */
+typedef struct
+{
+    OGRFeature  *poDstFeature; /* NULL if the part has been clipped out */
+    bool         bSetFromFailed;
+    int          nReprojectFailures;
+} TranslatedPart;
+
+/* Error emitted while translating a feature in a worker thread, where */
+/* the error handlers of the calling thread are not active. */
+typedef struct
+{
+    CPLErr       eErrClass;
+    CPLErrorNum  nErrorNum;
+    CPLString    osMsg;
+} TranslateError;
+
+typedef struct
+{
+    OGRFeature                  *poSrcFeature;
+    std::vector<TranslatedPart>  asParts;
+    std::vector<TranslateError>  asErrors;
+} TranslatedFeature;
+
 class SetupTargetLayer
 {
 public:
@@ -398,6 +429,7 @@ public:
     bool                          m_bExplodeCollections;
     vsi_l_offset                  m_nSrcFileSize;
     bool                          m_bNativeData;
+    int                           m_nThreads;
 
     int                 Translate(TargetLayerInfo* psInfo,
                                   GIntBig nCountLayerFeatures,
@@ -405,6 +437,42 @@ public:
                                   GDALProgressFunc pfnProgress,
                                   void *pProgressArg,
                                   GDALVectorTranslateOptions *psOptions);
+
+    void                TranslateFeature(TranslatedFeature* psFeature,
+                                         TargetLayerInfo* psInfo,
+                                         OGRFeatureDefn* poDstDefn,
+                                         OGRCoordinateTransformation** papoCT,
+                                         OGRSpatialReference* poOutputSRS,
+                                         bool bExplodeCollections,
+                                         GDALVectorTranslateOptions *psOptions) const;
+
+private:
+    bool                ReadFeature(TargetLayerInfo* psInfo,
+                                    OGRSpatialReference* poOutputSRS,
+                                    GDALVectorTranslateOptions *psOptions,
+                                    OGRFeature** ppoFeature);
+    bool                WriteFeature(TranslatedFeature* psFeature,
+                                     TargetLayerInfo* psInfo,
+                                     int& nFeaturesInTransaction,
+                                     GIntBig& nFeaturesWritten,
+                                     GDALVectorTranslateOptions *psOptions);
+    bool                ReportProgress(GIntBig nCount,
+                                       GIntBig nCountLayerFeatures,
+                                       GDALProgressFunc pfnProgress,
+                                       void *pProgressArg);
+    bool                TranslateMultiThreaded(TargetLayerInfo* psInfo,
+                                               OGRFeature* poFirstFeature,
+                                               OGRSpatialReference* poOutputSRS,
+                                               bool bExplodeCollections,
+                                               int& nFeaturesInTransaction,
+                                               GIntBig& nCount,
+                                               GIntBig& nFeaturesWritten,
+                                               GIntBig nCountLayerFeatures,
+                                               GIntBig* pnReadFeatureCount,
+                                               GDALProgressFunc pfnProgress,
+                                               void *pProgressArg,
+                                               GDALVectorTranslateOptions *psOptions,
+                                               bool& bStopped);
 };
 
 static OGRLayer* GetLayerAndOverwriteIfNecessary(GDALDataset *poDstDS,
@@ -1679,6 +1747,17 @@ GDALDatasetH GDALVectorTranslate( const char *pszDest, GDALDatasetH hDstDS, int
     oTranslator.m_bExplodeCollections = psOptions->bExplodeCollections;
     oTranslator.m_nSrcFileSize = nSrcFileSize;
     oTranslator.m_bNativeData = psOptions->bNativeData;
+    oTranslator.m_nThreads = psOptions->nThreads;
+    if( oTranslator.m_nThreads == 0 )
+    {
+        const char* pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+        if( EQUAL(pszThreads, "ALL_CPUS") )
+            oTranslator.m_nThreads = CPLGetNumCPUs();
+        else
+            oTranslator.m_nThreads = atoi(pszThreads);
+    }
+    if( oTranslator.m_nThreads > 128 )
+        oTranslator.m_nThreads = 128;
 
     if( psOptions->nGroupTransactions )
     {
@@ -3354,433 +3433,838 @@ static bool SetupCT( TargetLayerInfo* psInfo,
 }
 
 /************************************************************************/
-/*                     LayerTranslator::Translate()                     */
+/*                    LayerTranslator::ReadFeature()                    */
 /************************************************************************/
 
-int LayerTranslator::Translate( TargetLayerInfo* psInfo,
-                                GIntBig nCountLayerFeatures,
-                                GIntBig* pnReadFeatureCount,
-                                GDALProgressFunc pfnProgress,
-                                void *pProgressArg,
-                                GDALVectorTranslateOptions *psOptions )
+/* Fetch the next source feature, and set up the coordinate             */
+/* transformations if it is the first one or if they may change from  */
+/* one feature to another. *ppoFeature is set to NULL at the end of the */
+/* layer.                                                               */
+
+bool LayerTranslator::ReadFeature( TargetLayerInfo* psInfo,
+                                   OGRSpatialReference* poOutputSRS,
+                                   GDALVectorTranslateOptions *psOptions,
+                                   OGRFeature** ppoFeature )
 {
-    OGRLayer    *poSrcLayer;
-    OGRLayer    *poDstLayer;
-    const int         eGType = m_eGType;
-    OGRSpatialReference* poOutputSRS = m_poOutputSRS;
+    OGRLayer *poSrcLayer = psInfo->poSrcLayer;
+    OGRFeature *poFeature;
 
-    poSrcLayer = psInfo->poSrcLayer;
-    poDstLayer = psInfo->poDstLayer;
-    int* const panMap = psInfo->panMap;
-    const int iSrcZField = psInfo->iSrcZField;
-    const bool bPreserveFID = psInfo->bPreserveFID;
-    const int nSrcGeomFieldCount = poSrcLayer->GetLayerDefn()->GetGeomFieldCount();
-    const int nDstGeomFieldCount = poDstLayer->GetLayerDefn()->GetGeomFieldCount();
-    const bool bExplodeCollections = m_bExplodeCollections && nDstGeomFieldCount <= 1;
+    if( psOptions->nFIDToFetch != OGRNullFID )
+        poFeature = poSrcLayer->GetFeature(psOptions->nFIDToFetch);
+    else
+        poFeature = poSrcLayer->GetNextFeature();
 
-    if( poOutputSRS == NULL && !m_bNullifyOutputSRS )
+    *ppoFeature = poFeature;
+    if( poFeature == NULL )
+        return true;
+
+    if( psInfo->nFeaturesRead == 0 || psInfo->bPerFeatureCT )
     {
-        if( nSrcGeomFieldCount == 1 )
-        {
-            poOutputSRS = poSrcLayer->GetSpatialRef();
-        }
-        else if( psInfo->iRequestedSrcGeomField > 0 )
+        if( !SetupCT( psInfo, poSrcLayer, m_bTransform, m_bWrapDateline,
+                      m_osDateLineOffset, m_poUserSourceSRS,
+                      poFeature, poOutputSRS, m_poGCPCoordTrans) )
         {
-            poOutputSRS = poSrcLayer->GetLayerDefn()->GetGeomFieldDefn(
-                psInfo->iRequestedSrcGeomField)->GetSpatialRef();
+            OGRFeature::DestroyFeature( poFeature );
+            *ppoFeature = NULL;
+            return false;
         }
-
     }
 
-/* -------------------------------------------------------------------- */
-/*      Transfer features.                                              */
-/* -------------------------------------------------------------------- */
-    OGRFeature  *poFeature;
-    int         nFeaturesInTransaction = 0;
-    GIntBig      nCount = 0; /* written + failed */
-    GIntBig      nFeaturesWritten = 0;
+    psInfo->nFeaturesRead ++;
 
-    if( psOptions->nGroupTransactions )
+    return true;
+}
+
+/************************************************************************/
+/*                  LayerTranslator::TranslateFeature()                 */
+/************************************************************************/
+
+/* Build the target feature(s) of psFeature->poSrcFeature: field        */
+/* mapping, geometry operations and reprojection. This does not access  */
+/* the source or target layers, so that it can be run by worker         */
+/* threads, each with its own coordinate transformations in papoCT.     */
+/* Failures are recorded in psFeature->asParts to be reported by        */
+/* WriteFeature().                                                      */
+
+void LayerTranslator::TranslateFeature( TranslatedFeature* psFeature,
+                                        TargetLayerInfo* psInfo,
+                                        OGRFeatureDefn* poDstDefn,
+                                        OGRCoordinateTransformation** papoCT,
+                                        OGRSpatialReference* poOutputSRS,
+                                        bool bExplodeCollections,
+                                        GDALVectorTranslateOptions *psOptions ) const
+{
+    OGRFeature* poFeature = psFeature->poSrcFeature;
+    int* const panMap = psInfo->panMap;
+    const int iSrcZField = psInfo->iSrcZField;
+    const bool bPreserveFID = psInfo->bPreserveFID;
+    const int nSrcGeomFieldCount = poFeature->GetGeomFieldCount();
+    const int nDstGeomFieldCount = poDstDefn->GetGeomFieldCount();
+    const int eGType = m_eGType;
+
+    int nParts = 0;
+    int nIters = 1;
+    if (bExplodeCollections)
     {
-        if( psOptions->nLayerTransaction )
+        OGRGeometry* poSrcGeometry;
+        if( psInfo->iRequestedSrcGeomField >= 0 )
+            poSrcGeometry = poFeature->GetGeomFieldRef(
+                                    psInfo->iRequestedSrcGeomField);
+        else
+            poSrcGeometry = poFeature->GetGeometryRef();
+        if (poSrcGeometry &&
+            OGR_GT_IsSubClassOf(poSrcGeometry->getGeometryType(), wkbGeometryCollection) )
         {
-            if( poDstLayer->StartTransaction() != OGRERR_NONE )
-                return false;
+            nParts = ((OGRGeometryCollection*)poSrcGeometry)->getNumGeometries();
+            nIters = nParts;
+            if (nIters == 0)
+                nIters = 1;
         }
     }
 
-    bool bRet = true;
-    while( true )
+    for(int iPart = 0; iPart < nIters; iPart++)
     {
-        OGRFeature      *poDstFeature = NULL;
+        TranslatedPart sPart;
+        sPart.poDstFeature = NULL;
+        sPart.bSetFromFailed = false;
+        sPart.nReprojectFailures = 0;
 
-        if( psOptions->nFIDToFetch != OGRNullFID )
-            poFeature = poSrcLayer->GetFeature(psOptions->nFIDToFetch);
-        else
-            poFeature = poSrcLayer->GetNextFeature();
+        CPLErrorReset();
+        OGRFeature* poDstFeature = OGRFeature::CreateFeature( poDstDefn );
 
-        if( poFeature == NULL )
-            break;
+        /* Optimization to avoid duplicating the source geometry in the */
+        /* target feature : we steal it from the source feature for now... */
+        OGRGeometry* poStolenGeometry = NULL;
+        if( !bExplodeCollections && nSrcGeomFieldCount == 1 &&
+            nDstGeomFieldCount == 1 )
+        {
+            poStolenGeometry = poFeature->StealGeometry();
+        }
+        else if( !bExplodeCollections &&
+                 psInfo->iRequestedSrcGeomField >= 0 )
+        {
+            poStolenGeometry = poFeature->StealGeometry(
+                psInfo->iRequestedSrcGeomField);
+        }
 
-        if( psInfo->nFeaturesRead == 0 || psInfo->bPerFeatureCT )
+        if( poDstFeature->SetFrom( poFeature, panMap, TRUE ) != OGRERR_NONE )
         {
-            if( !SetupCT( psInfo, poSrcLayer, m_bTransform, m_bWrapDateline,
-                          m_osDateLineOffset, m_poUserSourceSRS,
-                          poFeature, poOutputSRS, m_poGCPCoordTrans) )
-            {
-                OGRFeature::DestroyFeature( poFeature );
-                return false;
-            }
+            OGRFeature::DestroyFeature( poDstFeature );
+            OGRGeometryFactory::destroyGeometry( poStolenGeometry );
+            sPart.bSetFromFailed = true;
+            psFeature->asParts.push_back(sPart);
+            return;
         }
 
-        psInfo->nFeaturesRead ++;
+        /* ... and now we can attach the stolen geometry */
+        if( poStolenGeometry )
+        {
+            poDstFeature->SetGeometryDirectly(poStolenGeometry);
+        }
 
-        int nParts = 0;
-        int nIters = 1;
-        if (bExplodeCollections)
+        if( bPreserveFID )
+            poDstFeature->SetFID( poFeature->GetFID() );
+        else if( psInfo->iSrcFIDField >= 0 &&
+                 poFeature->IsFieldSet(psInfo->iSrcFIDField))
+            poDstFeature->SetFID( poFeature->GetFieldAsInteger64(psInfo->iSrcFIDField) );
+
+        /* Erase native data if asked explicitly */
+        if( !m_bNativeData )
         {
-            OGRGeometry* poSrcGeometry;
-            if( psInfo->iRequestedSrcGeomField >= 0 )
-                poSrcGeometry = poFeature->GetGeomFieldRef(
-                                        psInfo->iRequestedSrcGeomField);
-            else
-                poSrcGeometry = poFeature->GetGeometryRef();
-            if (poSrcGeometry &&
-                OGR_GT_IsSubClassOf(poSrcGeometry->getGeometryType(), wkbGeometryCollection) )
-            {
-                nParts = ((OGRGeometryCollection*)poSrcGeometry)->getNumGeometries();
-                nIters = nParts;
-                if (nIters == 0)
-                    nIters = 1;
-            }
+            poDstFeature->SetNativeData(NULL);
+            poDstFeature->SetNativeMediaType(NULL);
         }
 
-        for(int iPart = 0; iPart < nIters; iPart++)
+        for( int iGeom = 0; iGeom < nDstGeomFieldCount; iGeom ++ )
         {
-            if( ++nFeaturesInTransaction == psOptions->nGroupTransactions )
+            OGRGeometry* poDstGeometry = poDstFeature->StealGeometry(iGeom);
+            if (poDstGeometry == NULL)
+                continue;
+
+            if (nParts > 0)
             {
-                if( psOptions->nLayerTransaction )
-                {
-                    if( poDstLayer->CommitTransaction() != OGRERR_NONE ||
-                        poDstLayer->StartTransaction() != OGRERR_NONE )
-                    {
-                        OGRFeature::DestroyFeature( poFeature );
-                        return false;
-                    }
-                }
-                else
-                {
-                    if( m_poODS->CommitTransaction() != OGRERR_NONE ||
-                        m_poODS->StartTransaction(psOptions->bForceTransaction) != OGRERR_NONE )
-                    {
-                        OGRFeature::DestroyFeature( poFeature );
-                        return false;
-                    }
-                }
-                nFeaturesInTransaction = 0;
+                /* For -explodecollections, extract the iPart(th) of the geometry */
+                OGRGeometry* poPart = ((OGRGeometryCollection*)poDstGeometry)->getGeometryRef(iPart);
+                ((OGRGeometryCollection*)poDstGeometry)->removeGeometry(iPart, FALSE);
+                delete poDstGeometry;
+                poDstGeometry = poPart;
             }
 
-            CPLErrorReset();
-            poDstFeature = OGRFeature::CreateFeature( poDstLayer->GetLayerDefn() );
+            if (iSrcZField != -1)
+            {
+                SetZ(poDstGeometry, poFeature->GetFieldAsDouble(iSrcZField));
+                /* This will correct the coordinate dimension to 3 */
+                OGRGeometry* poDupGeometry = poDstGeometry->clone();
+                delete poDstGeometry;
+                poDstGeometry = poDupGeometry;
+            }
 
-            /* Optimization to avoid duplicating the source geometry in the */
-            /* target feature : we steal it from the source feature for now... */
-            OGRGeometry* poStolenGeometry = NULL;
-            if( !bExplodeCollections && nSrcGeomFieldCount == 1 &&
-                nDstGeomFieldCount == 1 )
+            if (m_nCoordDim == 2 || m_nCoordDim == 3)
+                poDstGeometry->setCoordinateDimension( m_nCoordDim );
+            else if (m_nCoordDim == 4)
+            {
+                poDstGeometry->set3D( TRUE );
+                poDstGeometry->setMeasured( TRUE );
+            }
+            else if (m_nCoordDim == COORD_DIM_XYM)
             {
-                poStolenGeometry = poFeature->StealGeometry();
+                poDstGeometry->set3D( FALSE );
+                poDstGeometry->setMeasured( TRUE );
             }
-            else if( !bExplodeCollections &&
-                     psInfo->iRequestedSrcGeomField >= 0 )
+            else if ( m_nCoordDim == COORD_DIM_LAYER_DIM )
             {
-                poStolenGeometry = poFeature->StealGeometry(
-                    psInfo->iRequestedSrcGeomField);
+                const OGRwkbGeometryType eDstLayerGeomType =
+                  poDstDefn->GetGeomFieldDefn(iGeom)->GetType();
+                poDstGeometry->set3D( wkbHasZ(eDstLayerGeomType) );
+                poDstGeometry->setMeasured( wkbHasM(eDstLayerGeomType) );
             }
 
-            if( poDstFeature->SetFrom( poFeature, panMap, TRUE ) != OGRERR_NONE )
+            if (m_eGeomOp == GEOMOP_SEGMENTIZE)
+            {
+                if (m_dfGeomOpParam > 0)
+                    poDstGeometry->segmentize(m_dfGeomOpParam);
+            }
+            else if (m_eGeomOp == GEOMOP_SIMPLIFY_PRESERVE_TOPOLOGY)
             {
-                if( psOptions->nGroupTransactions )
+                if (m_dfGeomOpParam > 0)
                 {
-                    if( psOptions->nLayerTransaction )
+                    OGRGeometry* poNewGeom = poDstGeometry->SimplifyPreserveTopology(m_dfGeomOpParam);
+                    if (poNewGeom)
                     {
-                        if( poDstLayer->CommitTransaction() != OGRERR_NONE )
-                        {
-                            OGRFeature::DestroyFeature( poFeature );
-                            OGRFeature::DestroyFeature( poDstFeature );
-                            OGRGeometryFactory::destroyGeometry( poStolenGeometry );
-                            return false;
-                        }
+                        delete poDstGeometry;
+                        poDstGeometry = poNewGeom;
                     }
                 }
-
-                CPLError( CE_Failure, CPLE_AppDefined,
-                        "Unable to translate feature " CPL_FRMT_GIB " from layer %s.",
-                        poFeature->GetFID(), poSrcLayer->GetName() );
-
-                OGRFeature::DestroyFeature( poFeature );
-                OGRFeature::DestroyFeature( poDstFeature );
-                OGRGeometryFactory::destroyGeometry( poStolenGeometry );
-                return false;
             }
 
-            /* ... and now we can attach the stolen geometry */
-            if( poStolenGeometry )
+            if (m_poClipSrc)
             {
-                poDstFeature->SetGeometryDirectly(poStolenGeometry);
+                OGRGeometry* poClipped = poDstGeometry->Intersection(m_poClipSrc);
+                delete poDstGeometry;
+                if (poClipped == NULL || poClipped->IsEmpty())
+                {
+                    delete poClipped;
+                    goto end_loop;
+                }
+                poDstGeometry = poClipped;
             }
 
-            if( bPreserveFID )
-                poDstFeature->SetFID( poFeature->GetFID() );
-            else if( psInfo->iSrcFIDField >= 0 &&
-                     poFeature->IsFieldSet(psInfo->iSrcFIDField))
-                poDstFeature->SetFID( poFeature->GetFieldAsInteger64(psInfo->iSrcFIDField) );
+            OGRCoordinateTransformation* poCT = papoCT[iGeom];
+            if( !m_bTransform )
+                poCT = m_poGCPCoordTrans;
+            char** papszTransformOptions = psInfo->papapszTransformOptions[iGeom];
+
+            if( poCT != NULL || papszTransformOptions != NULL)
+            {
+                OGRGeometry* poReprojectedGeom =
+                    OGRGeometryFactory::transformWithOptions(poDstGeometry, poCT, papszTransformOptions);
+                if( poReprojectedGeom == NULL )
+                {
+                    sPart.nReprojectFailures ++;
+                    if( !psOptions->bSkipFailures )
+                    {
+                        delete poDstGeometry;
+                        goto end_loop;
+                    }
+                }
 
-            /* Erase native data if asked explicitly */
-            if( !m_bNativeData )
+                delete poDstGeometry;
+                poDstGeometry = poReprojectedGeom;
+            }
+            else if (poOutputSRS != NULL)
             {
-                poDstFeature->SetNativeData(NULL);
-                poDstFeature->SetNativeMediaType(NULL);
+                poDstGeometry->assignSpatialReference(poOutputSRS);
             }
 
-            for( int iGeom = 0; iGeom < nDstGeomFieldCount; iGeom ++ )
+            if (m_poClipDst)
             {
-                OGRGeometry* poDstGeometry = poDstFeature->StealGeometry(iGeom);
-                if (poDstGeometry == NULL)
-                    continue;
+                if( poDstGeometry == NULL )
+                    goto end_loop;
 
-                if (nParts > 0)
+                OGRGeometry* poClipped = poDstGeometry->Intersection(m_poClipDst);
+                delete poDstGeometry;
+                if (poClipped == NULL || poClipped->IsEmpty())
                 {
-                    /* For -explodecollections, extract the iPart(th) of the geometry */
-                    OGRGeometry* poPart = ((OGRGeometryCollection*)poDstGeometry)->getGeometryRef(iPart);
-                    ((OGRGeometryCollection*)poDstGeometry)->removeGeometry(iPart, FALSE);
-                    delete poDstGeometry;
-                    poDstGeometry = poPart;
+                    delete poClipped;
+                    goto end_loop;
                 }
 
-                if (iSrcZField != -1)
-                {
-                    SetZ(poDstGeometry, poFeature->GetFieldAsDouble(iSrcZField));
-                    /* This will correct the coordinate dimension to 3 */
-                    OGRGeometry* poDupGeometry = poDstGeometry->clone();
-                    delete poDstGeometry;
-                    poDstGeometry = poDupGeometry;
-                }
+                poDstGeometry = poClipped;
+            }
 
-                if (m_nCoordDim == 2 || m_nCoordDim == 3)
-                    poDstGeometry->setCoordinateDimension( m_nCoordDim );
-                else if (m_nCoordDim == 4)
+            if( eGType != GEOMTYPE_UNCHANGED )
+            {
+                poDstGeometry = OGRGeometryFactory::forceTo(
+                        poDstGeometry, (OGRwkbGeometryType)eGType);
+            }
+            else if( m_eGeomTypeConversion == GTC_PROMOTE_TO_MULTI ||
+                     m_eGeomTypeConversion == GTC_CONVERT_TO_LINEAR ||
+                     m_eGeomTypeConversion == GTC_CONVERT_TO_CURVE )
+            {
+                if( poDstGeometry != NULL )
                 {
-                    poDstGeometry->set3D( TRUE );
-                    poDstGeometry->setMeasured( TRUE );
+                    OGRwkbGeometryType eTargetType = poDstGeometry->getGeometryType();
+                    eTargetType = ConvertType(m_eGeomTypeConversion, eTargetType);
+                    poDstGeometry = OGRGeometryFactory::forceTo(poDstGeometry, eTargetType);
                 }
-                else if (m_nCoordDim == COORD_DIM_XYM)
+            }
+
+            poDstFeature->SetGeomFieldDirectly(iGeom, poDstGeometry);
+        }
+
+        sPart.poDstFeature = poDstFeature;
+        poDstFeature = NULL;
+
+end_loop:
+        OGRFeature::DestroyFeature( poDstFeature );
+        psFeature->asParts.push_back(sPart);
+
+        /* Nothing more will be written after a reprojection failure */
+        if( sPart.nReprojectFailures > 0 && !psOptions->bSkipFailures )
+            return;
+    }
+}
+
+/************************************************************************/
+/*                       DestroyTranslatedFeature()                     */
+/************************************************************************/
+
+static void DestroyTranslatedFeature( TranslatedFeature* psFeature )
+{
+    for( size_t iPart = 0; iPart < psFeature->asParts.size(); iPart++ )
+        OGRFeature::DestroyFeature( psFeature->asParts[iPart].poDstFeature );
+    psFeature->asParts.clear();
+    psFeature->asErrors.clear();
+    OGRFeature::DestroyFeature( psFeature->poSrcFeature );
+    psFeature->poSrcFeature = NULL;
+}
+
+/************************************************************************/
+/*                   LayerTranslator::WriteFeature()                    */
+/************************************************************************/
+
+/* Write the parts of a translated feature into the target layer,       */
+/* managing transactions and reporting the errors collected and the     */
+/* failures recorded by TranslateFeature(). The features are destroyed  */
+/* in all cases.                                                        */
+
+bool LayerTranslator::WriteFeature( TranslatedFeature* psFeature,
+                                    TargetLayerInfo* psInfo,
+                                    int& nFeaturesInTransaction,
+                                    GIntBig& nFeaturesWritten,
+                                    GDALVectorTranslateOptions *psOptions )
+{
+    OGRLayer *poSrcLayer = psInfo->poSrcLayer;
+    OGRLayer *poDstLayer = psInfo->poDstLayer;
+    OGRFeature* poFeature = psFeature->poSrcFeature;
+    const bool bPreserveFID = psInfo->bPreserveFID;
+    bool bRet = true;
+
+    /* Emit them from the calling thread, in the order of the source */
+    /* features, whatever the worker that translated them. */
+    for( size_t i = 0; i < psFeature->asErrors.size(); i++ )
+    {
+        const TranslateError& sError = psFeature->asErrors[i];
+        CPLError( sError.eErrClass, sError.nErrorNum, "%s",
+                  sError.osMsg.c_str() );
+    }
+
+    for( size_t iPart = 0; bRet && iPart < psFeature->asParts.size(); iPart++ )
+    {
+        TranslatedPart& sPart = psFeature->asParts[iPart];
+
+        if( ++nFeaturesInTransaction == psOptions->nGroupTransactions )
+        {
+            if( psOptions->nLayerTransaction )
+            {
+                if( poDstLayer->CommitTransaction() != OGRERR_NONE ||
+                    poDstLayer->StartTransaction() != OGRERR_NONE )
                 {
-                    poDstGeometry->set3D( FALSE );
-                    poDstGeometry->setMeasured( TRUE );
+                    bRet = false;
+                    break;
                 }
-                else if ( m_nCoordDim == COORD_DIM_LAYER_DIM )
+            }
+            else
+            {
+                if( m_poODS->CommitTransaction() != OGRERR_NONE ||
+                    m_poODS->StartTransaction(psOptions->bForceTransaction) != OGRERR_NONE )
                 {
-                    const OGRwkbGeometryType eDstLayerGeomType =
-                      poDstLayer->GetLayerDefn()->GetGeomFieldDefn(iGeom)->GetType();
-                    poDstGeometry->set3D( wkbHasZ(eDstLayerGeomType) );
-                    poDstGeometry->setMeasured( wkbHasM(eDstLayerGeomType) );
+                    bRet = false;
+                    break;
                 }
+            }
+            nFeaturesInTransaction = 0;
+        }
 
-                if (m_eGeomOp == GEOMOP_SEGMENTIZE)
-                {
-                    if (m_dfGeomOpParam > 0)
-                        poDstGeometry->segmentize(m_dfGeomOpParam);
-                }
-                else if (m_eGeomOp == GEOMOP_SIMPLIFY_PRESERVE_TOPOLOGY)
+        if( sPart.bSetFromFailed )
+        {
+            if( psOptions->nGroupTransactions )
+            {
+                if( psOptions->nLayerTransaction )
                 {
-                    if (m_dfGeomOpParam > 0)
+                    if( poDstLayer->CommitTransaction() != OGRERR_NONE )
                     {
-                        OGRGeometry* poNewGeom = poDstGeometry->SimplifyPreserveTopology(m_dfGeomOpParam);
-                        if (poNewGeom)
-                        {
-                            delete poDstGeometry;
-                            poDstGeometry = poNewGeom;
-                        }
+                        bRet = false;
+                        break;
                     }
                 }
+            }
 
-                if (m_poClipSrc)
+            CPLError( CE_Failure, CPLE_AppDefined,
+                    "Unable to translate feature " CPL_FRMT_GIB " from layer %s.",
+                    poFeature->GetFID(), poSrcLayer->GetName() );
+
+            bRet = false;
+            break;
+        }
+
+        for( int i = 0; i < sPart.nReprojectFailures; i++ )
+        {
+            if( psOptions->nGroupTransactions )
+            {
+                if( psOptions->nLayerTransaction )
                 {
-                    OGRGeometry* poClipped = poDstGeometry->Intersection(m_poClipSrc);
-                    delete poDstGeometry;
-                    if (poClipped == NULL || poClipped->IsEmpty())
+                    if( poDstLayer->CommitTransaction() != OGRERR_NONE &&
+                        !psOptions->bSkipFailures )
                     {
-                        delete poClipped;
-                        goto end_loop;
+                        bRet = false;
+                        break;
                     }
-                    poDstGeometry = poClipped;
                 }
+            }
 
-                OGRCoordinateTransformation* poCT = psInfo->papoCT[iGeom];
-                if( !m_bTransform )
-                    poCT = m_poGCPCoordTrans;
-                char** papszTransformOptions = psInfo->papapszTransformOptions[iGeom];
+            CPLError( CE_Failure, CPLE_AppDefined, "Failed to reproject feature " CPL_FRMT_GIB " (geometry probably out of source or destination SRS).",
+                      poFeature->GetFID() );
+            if( !psOptions->bSkipFailures )
+            {
+                bRet = false;
+                break;
+            }
+        }
+        if( !bRet )
+            break;
 
-                if( poCT != NULL || papszTransformOptions != NULL)
-                {
-                    OGRGeometry* poReprojectedGeom =
-                        OGRGeometryFactory::transformWithOptions(poDstGeometry, poCT, papszTransformOptions);
-                    if( poReprojectedGeom == NULL )
-                    {
-                        if( psOptions->nGroupTransactions )
-                        {
-                            if( psOptions->nLayerTransaction )
-                            {
-                                if( poDstLayer->CommitTransaction() != OGRERR_NONE &&
-                                    !psOptions->bSkipFailures )
-                                {
-                                    OGRFeature::DestroyFeature( poFeature );
-                                    OGRFeature::DestroyFeature( poDstFeature );
-                                    delete poDstGeometry;
-                                    return false;
-                                }
-                            }
-                        }
+        OGRFeature* poDstFeature = sPart.poDstFeature;
+        if( poDstFeature == NULL )
+            continue;
 
-                        CPLError( CE_Failure, CPLE_AppDefined, "Failed to reproject feature " CPL_FRMT_GIB " (geometry probably out of source or destination SRS).",
-                                  poFeature->GetFID() );
-                        if( !psOptions->bSkipFailures )
-                        {
-                            OGRFeature::DestroyFeature( poFeature );
-                            OGRFeature::DestroyFeature( poDstFeature );
-                            delete poDstGeometry;
-                            return false;
-                        }
-                    }
+        CPLErrorReset();
+        if( poDstLayer->CreateFeature( poDstFeature ) == OGRERR_NONE )
+        {
+            nFeaturesWritten ++;
+            if( (bPreserveFID && poDstFeature->GetFID() != poFeature->GetFID()) ||
+                (!bPreserveFID && psInfo->iSrcFIDField >= 0 && poFeature->IsFieldSet(psInfo->iSrcFIDField) &&
+                 poDstFeature->GetFID() != poFeature->GetFieldAsInteger64(psInfo->iSrcFIDField)) )
+            {
+                CPLError( CE_Warning, CPLE_AppDefined,
+                          "Feature id not preserved");
+            }
+        }
+        else if( !psOptions->bSkipFailures )
+        {
+            if( psOptions->nGroupTransactions )
+            {
+                if( psOptions->nLayerTransaction )
+                    poDstLayer->RollbackTransaction();
+            }
+
+            CPLError( CE_Failure, CPLE_AppDefined,
+                    "Unable to write feature " CPL_FRMT_GIB " from layer %s.",
+                    poFeature->GetFID(), poSrcLayer->GetName() );
 
-                    delete poDstGeometry;
-                    poDstGeometry = poReprojectedGeom;
+            bRet = false;
+        }
+        else
+        {
+            CPLDebug( "GDALVectorTranslate", "Unable to write feature " CPL_FRMT_GIB " into layer %s.",
+                       poFeature->GetFID(), poSrcLayer->GetName() );
+            if( psOptions->nGroupTransactions )
+            {
+                if( psOptions->nLayerTransaction )
+                {
+                    poDstLayer->RollbackTransaction();
+                    CPL_IGNORE_RET_VAL(poDstLayer->StartTransaction());
                 }
-                else if (poOutputSRS != NULL)
+                else
                 {
-                    poDstGeometry->assignSpatialReference(poOutputSRS);
+                    m_poODS->RollbackTransaction();
+                    m_poODS->StartTransaction(psOptions->bForceTransaction);
                 }
+            }
+        }
+    }
 
-                if (m_poClipDst)
-                {
-                    if( poDstGeometry == NULL )
-                        goto end_loop;
+    DestroyTranslatedFeature( psFeature );
 
-                    OGRGeometry* poClipped = poDstGeometry->Intersection(m_poClipDst);
-                    delete poDstGeometry;
-                    if (poClipped == NULL || poClipped->IsEmpty())
-                    {
-                        delete poClipped;
-                        goto end_loop;
-                    }
+    return bRet;
+}
 
-                    poDstGeometry = poClipped;
-                }
+/************************************************************************/
+/*                  LayerTranslator::ReportProgress()                   */
+/************************************************************************/
 
-                if( eGType != GEOMTYPE_UNCHANGED )
-                {
-                    poDstGeometry = OGRGeometryFactory::forceTo(
-                            poDstGeometry, (OGRwkbGeometryType)eGType);
-                }
-                else if( m_eGeomTypeConversion == GTC_PROMOTE_TO_MULTI ||
-                         m_eGeomTypeConversion == GTC_CONVERT_TO_LINEAR ||
-                         m_eGeomTypeConversion == GTC_CONVERT_TO_CURVE )
+bool LayerTranslator::ReportProgress( GIntBig nCount,
+                                      GIntBig nCountLayerFeatures,
+                                      GDALProgressFunc pfnProgress,
+                                      void *pProgressArg )
+{
+    bool bGoOn = true;
+    if (pfnProgress)
+    {
+        if (m_nSrcFileSize != 0)
+        {
+            if ((nCount % 1000) == 0)
+            {
+                OGRLayer* poFCLayer = m_poSrcDS->ExecuteSQL("GetBytesRead()", NULL, NULL);
+                if( poFCLayer != NULL )
                 {
-                    if( poDstGeometry != NULL )
+                    OGRFeature* poFeat = poFCLayer->GetNextFeature();
+                    if( poFeat )
                     {
-                        OGRwkbGeometryType eTargetType = poDstGeometry->getGeometryType();
-                        eTargetType = ConvertType(m_eGeomTypeConversion, eTargetType);
-                        poDstGeometry = OGRGeometryFactory::forceTo(poDstGeometry, eTargetType);
+                        const char* pszReadSize = poFeat->GetFieldAsString(0);
+                        GUIntBig nReadSize = CPLScanUIntBig( pszReadSize, 32 );
+                        bGoOn = pfnProgress(nReadSize * 1.0 / m_nSrcFileSize, "", pProgressArg) != FALSE;
+                        OGRFeature::DestroyFeature( poFeat );
                     }
                 }
-
-                poDstFeature->SetGeomFieldDirectly(iGeom, poDstGeometry);
+                m_poSrcDS->ReleaseResultSet(poFCLayer);
             }
+        }
+        else
+        {
+            bGoOn = pfnProgress(nCount * 1.0 / nCountLayerFeatures, "", pProgressArg) != FALSE;
+        }
+    }
+    return bGoOn;
+}
+
+/************************************************************************/
+/*                          TranslateBatchJob                           */
+/************************************************************************/
+
+/* A contiguous range of a batch of source features, translated by a    */
+/* worker thread with its own coordinate transformations.               */
+
+typedef struct
+{
+    const LayerTranslator        *poTranslator;
+    TargetLayerInfo              *psInfo;
+    OGRFeatureDefn               *poDstDefn;
+    OGRCoordinateTransformation **papoCT;
+    OGRSpatialReference          *poOutputSRS;
+    bool                          bExplodeCollections;
+    GDALVectorTranslateOptions   *psOptions;
+    TranslatedFeature            *pasFeatures;
+    int                           nFeatures;
+} TranslateBatchJob;
+
+static void CPL_STDCALL TranslateErrorCollector( CPLErr eErrClass,
+                                                 CPLErrorNum nErrorNum,
+                                                 const char* pszMsg )
+{
+    TranslatedFeature* psFeature =
+        (TranslatedFeature*) CPLGetErrorHandlerUserData();
+    TranslateError sError;
+    sError.eErrClass = eErrClass;
+    sError.nErrorNum = nErrorNum;
+    sError.osMsg = pszMsg;
+    psFeature->asErrors.push_back(sError);
+}
+
+static void TranslateBatchJobFunc( void* pData )
+{
+    TranslateBatchJob* psJob = (TranslateBatchJob*) pData;
+    for( int i = 0; i < psJob->nFeatures; i++ )
+    {
+        /* Error handlers are per thread: collect the errors, to be */
+        /* reported by WriteFeature() */
+        CPLPushErrorHandlerEx( TranslateErrorCollector,
+                               &psJob->pasFeatures[i] );
+        psJob->poTranslator->TranslateFeature( &psJob->pasFeatures[i],
+                                               psJob->psInfo,
+                                               psJob->poDstDefn,
+                                               psJob->papoCT,
+                                               psJob->poOutputSRS,
+                                               psJob->bExplodeCollections,
+                                               psJob->psOptions );
+        CPLPopErrorHandler();
+    }
+}
 
-            CPLErrorReset();
-            if( poDstLayer->CreateFeature( poDstFeature ) == OGRERR_NONE )
+/* Number of source features read before being handed to the workers */
+#define TRANSLATE_BATCH_SIZE 1024
+
+/************************************************************************/
+/*               LayerTranslator::TranslateMultiThreaded()              */
+/************************************************************************/
+
+/* Pipelined translation: the calling thread reads a batch of source    */
+/* features while the worker threads translate the previous one, and    */
+/* then writes the translated batch, in order, while the workers        */
+/* translate the one just read. Source and target layers are thus only  */
+/* accessed by the calling thread. Returns false on error, and sets     */
+/* bStopped if the progress function asked to stop.                     */
+
+bool LayerTranslator::TranslateMultiThreaded( TargetLayerInfo* psInfo,
+                                              OGRFeature* poFirstFeature,
+                                              OGRSpatialReference* poOutputSRS,
+                                              bool bExplodeCollections,
+                                              int& nFeaturesInTransaction,
+                                              GIntBig& nCount,
+                                              GIntBig& nFeaturesWritten,
+                                              GIntBig nCountLayerFeatures,
+                                              GIntBig* pnReadFeatureCount,
+                                              GDALProgressFunc pfnProgress,
+                                              void *pProgressArg,
+                                              GDALVectorTranslateOptions *psOptions,
+                                              bool& bStopped )
+{
+    OGRFeatureDefn* poDstDefn = psInfo->poDstLayer->GetLayerDefn();
+    const int nDstGeomFieldCount = poDstDefn->GetGeomFieldCount();
+    const int nJobs = m_nThreads;
+
+    CPLWorkerThreadPool oPool;
+    if( !oPool.Setup(m_nThreads, NULL, NULL) )
+        return false;
+
+    CPLDebug("GDALVectorTranslate", "Using %d threads to translate layer %s",
+             m_nThreads, psInfo->poSrcLayer->GetName());
+
+/* -------------------------------------------------------------------- */
+/*      Each job slot gets its own coordinate transformations, as they  */
+/*      have a state that cannot be shared between threads.             */
+/* -------------------------------------------------------------------- */
+    std::vector<OGRCoordinateTransformation*> apoCT(nJobs * nDstGeomFieldCount, NULL);
+    bool bRet = true;
+    for( int iJob = 0; bRet && iJob < nJobs; iJob++ )
+    {
+        for( int iGeom = 0; iGeom < nDstGeomFieldCount; iGeom++ )
+        {
+            OGRCoordinateTransformation* poCT = psInfo->papoCT[iGeom];
+            if( poCT == NULL )
+                continue;
+            apoCT[iJob * nDstGeomFieldCount + iGeom] =
+                OGRCreateCoordinateTransformation( poCT->GetSourceCS(),
+                                                   poCT->GetTargetCS() );
+            if( apoCT[iJob * nDstGeomFieldCount + iGeom] == NULL )
+                bRet = false;
+        }
+    }
+
+    std::vector<TranslateBatchJob> asJobs(nJobs);
+    for( int iJob = 0; iJob < nJobs; iJob++ )
+    {
+        TranslateBatchJob& sJob = asJobs[iJob];
+        sJob.poTranslator = this;
+        sJob.psInfo = psInfo;
+        sJob.poDstDefn = poDstDefn;
+        sJob.papoCT = nDstGeomFieldCount ? &apoCT[iJob * nDstGeomFieldCount] : NULL;
+        sJob.poOutputSRS = poOutputSRS;
+        sJob.bExplodeCollections = bExplodeCollections;
+        sJob.psOptions = psOptions;
+        sJob.pasFeatures = NULL;
+        sJob.nFeatures = 0;
+    }
+
+    std::vector<TranslatedFeature> asTranslating;
+    std::vector<TranslatedFeature> asRead;
+    OGRFeature* poFeature = poFirstFeature;
+    bool bEOF = false;
+
+    while( bRet && !bStopped && !(bEOF && asTranslating.empty()) )
+    {
+/* -------------------------------------------------------------------- */
+/*      Read the next batch while the workers translate the current     */
+/*      one.                                                            */
+/* -------------------------------------------------------------------- */
+        while( !bEOF && asRead.size() < TRANSLATE_BATCH_SIZE )
+        {
+            if( poFeature == NULL && !ReadFeature(psInfo, poOutputSRS,
+                                                  psOptions, &poFeature) )
             {
-                nFeaturesWritten ++;
-                if( (bPreserveFID && poDstFeature->GetFID() != poFeature->GetFID()) ||
-                    (!bPreserveFID && psInfo->iSrcFIDField >= 0 && poFeature->IsFieldSet(psInfo->iSrcFIDField) &&
-                     poDstFeature->GetFID() != poFeature->GetFieldAsInteger64(psInfo->iSrcFIDField)) )
-                {
-                    CPLError( CE_Warning, CPLE_AppDefined,
-                              "Feature id not preserved");
-                }
+                bRet = false;
+                break;
             }
-            else if( !psOptions->bSkipFailures )
+            if( poFeature == NULL )
             {
-                if( psOptions->nGroupTransactions )
-                {
-                    if( psOptions->nLayerTransaction )
-                        poDstLayer->RollbackTransaction();
-                }
+                bEOF = true;
+                break;
+            }
+            TranslatedFeature sFeature;
+            sFeature.poSrcFeature = poFeature;
+            asRead.push_back(sFeature);
+            poFeature = NULL;
+        }
 
-                CPLError( CE_Failure, CPLE_AppDefined,
-                        "Unable to write feature " CPL_FRMT_GIB " from layer %s.",
-                        poFeature->GetFID(), poSrcLayer->GetName() );
+        oPool.WaitCompletion();
+        if( !bRet )
+            break;
 
-                OGRFeature::DestroyFeature( poFeature );
-                OGRFeature::DestroyFeature( poDstFeature );
-                return false;
+/* -------------------------------------------------------------------- */
+/*      Hand the batch just read to the workers, and write the one      */
+/*      they have translated.                                           */
+/* -------------------------------------------------------------------- */
+        std::vector<TranslatedFeature> asTranslated;
+        asTranslated.swap(asTranslating);
+        asTranslating.swap(asRead);
+
+        if( !asTranslating.empty() )
+        {
+            const int nFeatures = (int)asTranslating.size();
+            const int nPerJob = (nFeatures + nJobs - 1) / nJobs;
+            std::vector<void*> apJobs;
+            for( int iJob = 0; iJob < nJobs && iJob * nPerJob < nFeatures; iJob++ )
+            {
+                asJobs[iJob].pasFeatures = &asTranslating[iJob * nPerJob];
+                asJobs[iJob].nFeatures =
+                    MIN(nPerJob, nFeatures - iJob * nPerJob);
+                apJobs.push_back(&asJobs[iJob]);
             }
-            else
+            if( !oPool.SubmitJobs(TranslateBatchJobFunc, apJobs) )
             {
-                CPLDebug( "GDALVectorTranslate", "Unable to write feature " CPL_FRMT_GIB " into layer %s.",
-                           poFeature->GetFID(), poSrcLayer->GetName() );
-                if( psOptions->nGroupTransactions )
-                {
-                    if( psOptions->nLayerTransaction )
-                    {
-                        poDstLayer->RollbackTransaction();
-                        CPL_IGNORE_RET_VAL(poDstLayer->StartTransaction());
-                    }
-                    else
-                    {
-                        m_poODS->RollbackTransaction();
-                        m_poODS->StartTransaction(psOptions->bForceTransaction);
-                    }
-                }
+                // Translate in this thread instead.
+                for( size_t i = 0; i < apJobs.size(); i++ )
+                    TranslateBatchJobFunc(apJobs[i]);
             }
-
-end_loop:
-            OGRFeature::DestroyFeature( poDstFeature );
         }
 
-        OGRFeature::DestroyFeature( poFeature );
-
-        /* Report progress */
-        nCount ++;
-        bool bGoOn = true;
-        if (pfnProgress)
+        for( size_t i = 0; i < asTranslated.size(); i++ )
         {
-            if (m_nSrcFileSize != 0)
+            if( !WriteFeature(&asTranslated[i], psInfo,
+                              nFeaturesInTransaction, nFeaturesWritten,
+                              psOptions) )
             {
-                if ((nCount % 1000) == 0)
-                {
-                    OGRLayer* poFCLayer = m_poSrcDS->ExecuteSQL("GetBytesRead()", NULL, NULL);
-                    if( poFCLayer != NULL )
-                    {
-                        OGRFeature* poFeat = poFCLayer->GetNextFeature();
-                        if( poFeat )
-                        {
-                            const char* pszReadSize = poFeat->GetFieldAsString(0);
-                            GUIntBig nReadSize = CPLScanUIntBig( pszReadSize, 32 );
-                            bGoOn = pfnProgress(nReadSize * 1.0 / m_nSrcFileSize, "", pProgressArg) != FALSE;
-                            OGRFeature::DestroyFeature( poFeat );
-                        }
-                    }
-                    m_poSrcDS->ReleaseResultSet(poFCLayer);
-                }
+                for( size_t j = i + 1; j < asTranslated.size(); j++ )
+                    DestroyTranslatedFeature(&asTranslated[j]);
+                bRet = false;
+                break;
             }
-            else
+
+            /* Report progress */
+            nCount ++;
+            if( !ReportProgress(nCount, nCountLayerFeatures,
+                                pfnProgress, pProgressArg) )
             {
-                bGoOn = pfnProgress(nCount * 1.0 / nCountLayerFeatures, "", pProgressArg) != FALSE;
+                for( size_t j = i + 1; j < asTranslated.size(); j++ )
+                    DestroyTranslatedFeature(&asTranslated[j]);
+                bStopped = true;
+                break;
             }
+
+            if (pnReadFeatureCount)
+                *pnReadFeatureCount = nCount;
         }
-        if( !bGoOn )
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Cleanup after an error or an interruption.                      */
+/* -------------------------------------------------------------------- */
+    oPool.WaitCompletion();
+    for( size_t i = 0; i < asTranslating.size(); i++ )
+        DestroyTranslatedFeature(&asTranslating[i]);
+    for( size_t i = 0; i < asRead.size(); i++ )
+        DestroyTranslatedFeature(&asRead[i]);
+    OGRFeature::DestroyFeature( poFeature );
+    for( size_t i = 0; i < apoCT.size(); i++ )
+        delete apoCT[i];
+
+    return bRet;
+}
+
+/************************************************************************/
+/*                     LayerTranslator::Translate()                     */
+/************************************************************************/
+
+int LayerTranslator::Translate( TargetLayerInfo* psInfo,
+                                GIntBig nCountLayerFeatures,
+                                GIntBig* pnReadFeatureCount,
+                                GDALProgressFunc pfnProgress,
+                                void *pProgressArg,
+                                GDALVectorTranslateOptions *psOptions )
+{
+    OGRLayer    *poSrcLayer;
+    OGRLayer    *poDstLayer;
+    OGRSpatialReference* poOutputSRS = m_poOutputSRS;
+
+    poSrcLayer = psInfo->poSrcLayer;
+    poDstLayer = psInfo->poDstLayer;
+    const int nSrcGeomFieldCount = poSrcLayer->GetLayerDefn()->GetGeomFieldCount();
+    OGRFeatureDefn* poDstDefn = poDstLayer->GetLayerDefn();
+    const int nDstGeomFieldCount = poDstDefn->GetGeomFieldCount();
+    const bool bExplodeCollections = m_bExplodeCollections && nDstGeomFieldCount <= 1;
+
+    if( poOutputSRS == NULL && !m_bNullifyOutputSRS )
+    {
+        if( nSrcGeomFieldCount == 1 )
+        {
+            poOutputSRS = poSrcLayer->GetSpatialRef();
+        }
+        else if( psInfo->iRequestedSrcGeomField > 0 )
+        {
+            poOutputSRS = poSrcLayer->GetLayerDefn()->GetGeomFieldDefn(
+                psInfo->iRequestedSrcGeomField)->GetSpatialRef();
+        }
+
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Transfer features.                                              */
+/* -------------------------------------------------------------------- */
+    OGRFeature  *poFeature;
+    int         nFeaturesInTransaction = 0;
+    GIntBig      nCount = 0; /* written + failed */
+    GIntBig      nFeaturesWritten = 0;
+
+    if( psOptions->nGroupTransactions )
+    {
+        if( psOptions->nLayerTransaction )
+        {
+            if( poDstLayer->StartTransaction() != OGRERR_NONE )
+                return false;
+        }
+    }
+
+    if( !ReadFeature( psInfo, poOutputSRS, psOptions, &poFeature ) )
+        return false;
+
+/* -------------------------------------------------------------------- */
+/*      Use worker threads if asked, unless coordinate transformations  */
+/*      change from one feature to another, or a single feature is      */
+/*      requested.                                                      */
+/* -------------------------------------------------------------------- */
+    bool bRet = true;
+    if( poFeature != NULL && m_nThreads > 1 &&
+        psOptions->nFIDToFetch == OGRNullFID &&
+        !psInfo->bPerFeatureCT && m_poGCPCoordTrans == NULL )
+    {
+        bool bStopped = false;
+        if( !TranslateMultiThreaded( psInfo, poFeature, poOutputSRS,
+                                     bExplodeCollections,
+                                     nFeaturesInTransaction, nCount,
+                                     nFeaturesWritten, nCountLayerFeatures,
+                                     pnReadFeatureCount,
+                                     pfnProgress, pProgressArg, psOptions,
+                                     bStopped ) )
+            return false;
+        if( bStopped )
+            bRet = false;
+        poFeature = NULL;
+    }
+
+    while( poFeature != NULL )
+    {
+        TranslatedFeature sFeature;
+        sFeature.poSrcFeature = poFeature;
+        TranslateFeature( &sFeature, psInfo, poDstDefn, psInfo->papoCT,
+                          poOutputSRS, bExplodeCollections, psOptions );
+        if( !WriteFeature( &sFeature, psInfo, nFeaturesInTransaction,
+                           nFeaturesWritten, psOptions ) )
+            return false;
+
+        /* Report progress */
+        nCount ++;
+        if( !ReportProgress( nCount, nCountLayerFeatures,
+                             pfnProgress, pProgressArg ) )
         {
             bRet = false;
             break;
@@ -3791,6 +4275,9 @@ end_loop:
 
         if( psOptions->nFIDToFetch != OGRNullFID )
             break;
+
+        if( !ReadFeature( psInfo, poOutputSRS, psOptions, &poFeature ) )
+            return false;
     }
 
     if( psOptions->nGroupTransactions )
@@ -3848,6 +4335,7 @@ GDALVectorTranslateOptions *GDALVectorTranslateOptionsNew(char** papszArgv,
     psOptions->nLayerTransaction = -1;
     psOptions->bForceTransaction = false;
     psOptions->nGroupTransactions = 20000;
+    psOptions->nThreads = 0;
     psOptions->nFIDToFetch = OGRNullFID;
     psOptions->bQuiet = false;
     psOptions->pszFormat = CPLStrdup("ESRI Shapefile");
@@ -4085,6 +4573,23 @@ GDALVectorTranslateOptions *GDALVectorTranslateOptionsNew(char** papszArgv,
                     psOptions->nGroupTransactions = atoi(papszArgv[i]);
             }
         }
+        else if( EQUAL(papszArgv[i],"-nt") && i+1 < nArgc )
+        {
+            ++i;
+            if( EQUAL(papszArgv[i], "ALL_CPUS") )
+                psOptions->nThreads = CPLGetNumCPUs();
+            else
+            {
+                psOptions->nThreads = atoi(papszArgv[i]);
+                if( psOptions->nThreads <= 0 )
+                {
+                    CPLError(CE_Failure, CPLE_IllegalArg,
+                             "Invalid value for -nt: %s", papszArgv[i]);
+                    GDALVectorTranslateOptionsFree(psOptions);
+                    return NULL;
+                }
+            }
+        }
         else if ( EQUAL(papszArgv[i],"-ds_transaction") )
         {
             psOptions->nLayerTransaction = FALSE;
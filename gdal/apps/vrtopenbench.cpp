@@ -0,0 +1,165 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  GDAL Utilities
+ * Purpose:  Benchmark of the opening time of a VRT in its XML and binary
+ *           (.vrtb) forms.
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "gdal.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "cpl_vsi.h"
+
+#include <time.h>
+
+CPL_CVSID("$Id$");
+
+/************************************************************************/
+/*                               Usage()                                */
+/************************************************************************/
+
+static void Usage()
+{
+    printf( "vrtopenbench [-i <iterations>] [-lazy] file.vrt [file.vrtb]\n"
+            "\n"
+            "Opens file.vrt and its binary version the specified number of\n"
+            "times, and reports the average opening time of each. If the\n"
+            "binary version is not specified, it is written next to\n"
+            "file.vrt with the .vrtb extension.\n" );
+    exit( 1 );
+}
+
+/************************************************************************/
+/*                             TimeOpen()                               */
+/*                                                                      */
+/*      Returns the average opening time in milliseconds.               */
+/************************************************************************/
+
+static double TimeOpen( const char *pszFilename, int nIterations )
+{
+    const clock_t nStart = clock();
+    for( int i = 0; i < nIterations; i++ )
+    {
+        GDALDatasetH hDS = GDALOpen( pszFilename, GA_ReadOnly );
+        if( hDS == NULL )
+        {
+            printf( "Cannot open %s.\n", pszFilename );
+            exit( 1 );
+        }
+        GDALClose( hDS );
+    }
+    return 1000.0 * static_cast<double>(clock() - nStart) /
+           CLOCKS_PER_SEC / nIterations;
+}
+
+/************************************************************************/
+/*                                main()                                */
+/************************************************************************/
+
+int main( int argc, char ** argv )
+
+{
+    int nIterations = 10;
+    const char *pszXMLFilename = NULL;
+    const char *pszBinaryFilename = NULL;
+
+/* -------------------------------------------------------------------- */
+/*      Process arguments.                                              */
+/* -------------------------------------------------------------------- */
+    argc = GDALGeneralCmdLineProcessor( argc, &argv, 0 );
+    if( argc < 1 )
+        exit( -argc );
+
+    for( int iArg = 1; iArg < argc; iArg++ )
+    {
+        if( EQUAL(argv[iArg],"-i") && iArg < argc-1 )
+            nIterations = atoi(argv[++iArg]);
+        else if( EQUAL(argv[iArg],"-lazy") )
+            CPLSetConfigOption( "VRT_LAZY_SOURCE_OPENING", "YES" );
+        else if( pszXMLFilename == NULL )
+            pszXMLFilename = argv[iArg];
+        else if( pszBinaryFilename == NULL )
+            pszBinaryFilename = argv[iArg];
+        else
+        {
+            printf( "Unrecognized argument: %s\n", argv[iArg] );
+            Usage();
+        }
+    }
+
+    if( pszXMLFilename == NULL || nIterations <= 0 )
+        Usage();
+
+    GDALAllRegister();
+
+/* -------------------------------------------------------------------- */
+/*      Write the binary version if needed.                             */
+/* -------------------------------------------------------------------- */
+    CPLString osBinaryFilename;
+    if( pszBinaryFilename != NULL )
+        osBinaryFilename = pszBinaryFilename;
+    else
+    {
+        osBinaryFilename = CPLResetExtension( pszXMLFilename, "vrtb" );
+        GDALDatasetH hSrcDS = GDALOpen( pszXMLFilename, GA_ReadOnly );
+        if( hSrcDS == NULL )
+            exit( 1 );
+        GDALDatasetH hDstDS =
+            GDALCreateCopy( GDALGetDriverByName("VRT"), osBinaryFilename,
+                            hSrcDS, FALSE, NULL, NULL, NULL );
+        GDALClose( hSrcDS );
+        if( hDstDS == NULL )
+            exit( 1 );
+        GDALClose( hDstDS );
+    }
+
+    VSIStatBufL sStatXML, sStatBinary;
+    if( VSIStatL( pszXMLFilename, &sStatXML ) != 0 ||
+        VSIStatL( osBinaryFilename, &sStatBinary ) != 0 )
+    {
+        printf( "Cannot stat input files.\n" );
+        exit( 1 );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Run the benchmark.                                              */
+/* -------------------------------------------------------------------- */
+    const double dfXMLTime = TimeOpen( pszXMLFilename, nIterations );
+    const double dfBinaryTime = TimeOpen( osBinaryFilename, nIterations );
+
+    printf( "XML:    %s, " CPL_FRMT_GUIB " bytes, %.3f ms per open\n",
+            pszXMLFilename,
+            static_cast<GUIntBig>(sStatXML.st_size), dfXMLTime );
+    printf( "Binary: %s, " CPL_FRMT_GUIB " bytes, %.3f ms per open\n",
+            osBinaryFilename.c_str(),
+            static_cast<GUIntBig>(sStatBinary.st_size), dfBinaryTime );
+    if( dfBinaryTime > 0 )
+        printf( "Speed-up: %.2fx\n", dfXMLTime / dfBinaryTime );
+
+    CSLDestroy( argv );
+    GDALDestroyDriverManager();
+
+    return 0;
+}
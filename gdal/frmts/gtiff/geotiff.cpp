@@ -38,6 +38,7 @@
 
 #include "cpl_port.h"  // Must be first.
 
+#include <algorithm>
 #include <set>
 
 #include "cpl_csv.h"
@@ -197,6 +198,26 @@ typedef struct
     int           bReady;
 } GTiffCompressionJob;
 
+typedef struct
+{
+    GTiffDataset    *poDS;
+    int              nBlockXOff;
+    int              nBlockYOff;
+    int              nBlockId;
+    int              nBlockBufSize;
+    int              nBlockReqSize;
+    /* Blocks to fill: one per band if pixel interleaved (NULL for the */
+    /* bands whose block is already cached), a single one otherwise */
+    std::vector<GDALRasterBlock*> apoBlocks;
+    bool             bSuccess;
+} GTiffDecompressionJob;
+
+typedef struct
+{
+    VSILFILE     *fp;
+    TIFF         *hTIFF;
+} GTiffDecompressionHandle;
+
 class GTiffDataset CPL_FINAL : public GDALPamDataset
 {
     friend class GTiffRasterBand;
@@ -346,6 +367,7 @@ class GTiffDataset CPL_FINAL : public GDALPamDataset
     void          LoadICCProfile();
 
     int           bHasWarnedDisableAggressiveBandCaching;
+    int           bHasWarnedDisableDecompressionThreads;
 
     int           bDontReloadFirstBlock; /* Hack for libtiff 3.X and #3633 */
 
@@ -398,6 +420,17 @@ class GTiffDataset CPL_FINAL : public GDALPamDataset
     int            SubmitCompressionJob(int nStripOrTile, GByte* pabyData,
                                         int cc, int nHeight);
 
+    CPLWorkerThreadPool *poDecompressThreadPool;
+    CPLMutex      *hDecompressHandlesMutex;
+    std::vector<GTiffDecompressionHandle> asDecompressionHandles;
+    void           InitDecompressionThreads(char** papszOptions);
+    CPLWorkerThreadPool* GetDecompressThreadPool();
+    static void    ThreadDecompressionFunc(void* pData);
+    bool           OpenDecompressionHandles(int nCount);
+    void           CacheBlocksMultiThreaded( int nXOff, int nYOff,
+                                             int nXSize, int nYSize,
+                                             int nBandCount, int *panBandMap );
+
     int            GuessJPEGQuality(int& bOutHasQuantizationTable,
                                     int& bOutHasHuffmanTable);
 
@@ -468,6 +501,8 @@ class GTiffDataset CPL_FINAL : public GDALPamDataset
 
     virtual CPLErr IBuildOverviews( const char *, int, int *, int, int *,
                                     GDALProgressFunc, void * );
+    CPLErr         BuildOverviewsInternal( const char *, int, int *, int, int *,
+                                           GDALProgressFunc, void * );
 
     CPLErr         OpenOffset( TIFF *, GTiffDataset **ppoActiveDSRef,
                                toff_t nDirOffset, int bBaseIn, GDALAccess,
@@ -970,6 +1005,8 @@ protected:
     void NullBlock( void *pData );
     CPLErr FillCacheForOtherBands( int nBlockXOff, int nBlockYOff );
 
+    virtual int CanDirectReadBlocks();
+
 public:
                    GTiffRasterBand( GTiffDataset *, int );
                   ~GTiffRasterBand();
@@ -1882,6 +1919,16 @@ CPLErr GTiffDataset::IRasterIO( GDALRWFlag eRWFlag,
             return (CPLErr)nErr;
     }
 
+    // Don't fill the block cache if the caller asked to bypass it
+    if( eRWFlag == GF_Read &&
+        !(psExtraArg->bDirectRead &&
+          static_cast<GTiffRasterBand*>(
+              GetRasterBand(panBandMap[0]))->CanDirectReadBlocks()) )
+    {
+        CacheBlocksMultiThreaded( nXOff, nYOff, nXSize, nYSize,
+                                  nBandCount, panBandMap );
+    }
+
     nJPEGOverviewVisibilityFlag ++;
     eErr =  GDALPamDataset::IRasterIO(
                 eRWFlag, nXOff, nYOff, nXSize, nYSize,
@@ -3548,6 +3595,17 @@ CPLErr GTiffRasterBand::IRasterIO( GDALRWFlag eRWFlag,
             return (CPLErr)nErr;
     }
 
+    const bool bDirectRead = eRWFlag == GF_Read &&
+                             psExtraArg->bDirectRead &&
+                             nXSize == nBufXSize && nYSize == nBufYSize &&
+                             CanDirectReadBlocks();
+
+    if( eRWFlag == GF_Read && !bDirectRead )
+    {
+        poGDS->CacheBlocksMultiThreaded( nXOff, nYOff, nXSize, nYSize,
+                                         1, &nBand );
+    }
+
     if (poGDS->nBands != 1 &&
         poGDS->nPlanarConfig == PLANARCONFIG_CONTIG &&
         eRWFlag == GF_Read &&
@@ -3761,6 +3819,18 @@ CPLErr GTiffRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
 }
 
 
+/************************************************************************/
+/*                        CanDirectReadBlocks()                         */
+/************************************************************************/
+
+int GTiffRasterBand::CanDirectReadBlocks()
+{
+    /* With pixel interleaving, IReadBlock() decodes all bands at once and */
+    /* pushes the other ones in the block cache. */
+    return poGDS->nBands == 1 ||
+           poGDS->nPlanarConfig == PLANARCONFIG_SEPARATE;
+}
+
 /************************************************************************/
 /*                       FillCacheForOtherBands()                       */
 /************************************************************************/
@@ -4833,6 +4903,9 @@ class GTiffSplitBand CPL_FINAL : public GTiffRasterBand
 
     virtual CPLErr IReadBlock( int, int, void * );
     virtual CPLErr IWriteBlock( int, int, void * );
+
+  protected:
+    virtual int CanDirectReadBlocks() { return FALSE; }
 };
 
 /************************************************************************/
@@ -4975,6 +5048,9 @@ class GTiffRGBABand CPL_FINAL : public GTiffRasterBand
     virtual CPLErr IWriteBlock( int, int, void * );
 
     virtual GDALColorInterp GetColorInterpretation();
+
+  protected:
+    virtual int CanDirectReadBlocks() { return FALSE; }
 };
 
 
@@ -5139,6 +5215,9 @@ class GTiffOddBitsBand : public GTiffRasterBand
 
     virtual CPLErr IReadBlock( int, int, void * );
     virtual CPLErr IWriteBlock( int, int, void * );
+
+  protected:
+    virtual int CanDirectReadBlocks() { return FALSE; }
 };
 
 
@@ -6093,6 +6172,7 @@ GTiffDataset::GTiffDataset() :
     bTreatAsSplitBitmap = FALSE;
     bClipWarn = FALSE;
     bHasWarnedDisableAggressiveBandCaching = FALSE;
+    bHasWarnedDisableDecompressionThreads = FALSE;
     bDontReloadFirstBlock = FALSE;
 
     nZLevel = -1;
@@ -6133,6 +6213,8 @@ GTiffDataset::GTiffDataset() :
     papszMetadataFiles = NULL;
     poCompressThreadPool = NULL;
     hCompressThreadPoolMutex = NULL;
+    poDecompressThreadPool = NULL;
+    hDecompressHandlesMutex = NULL;
 
     m_pTempBufferForCommonDirectIO = NULL;
     m_nTempBufferForCommonDirectIOSize = 0;
@@ -6224,6 +6306,19 @@ int GTiffDataset::Finalize()
         CPLDestroyMutex(hCompressThreadPoolMutex);
     }
 
+    // Destroy decompression pool and the TIFF handles of its threads
+    delete poDecompressThreadPool;
+    poDecompressThreadPool = NULL;
+    for( int i = 0; i < static_cast<int>(asDecompressionHandles.size()); ++i )
+    {
+        XTIFFClose(asDecompressionHandles[i].hTIFF);
+        CPL_IGNORE_RET_VAL(VSIFCloseL(asDecompressionHandles[i].fp));
+    }
+    asDecompressionHandles.clear();
+    if( hDecompressHandlesMutex )
+        CPLDestroyMutex(hDecompressHandlesMutex);
+    hDecompressHandlesMutex = NULL;
+
 /* -------------------------------------------------------------------- */
 /*      If there is still changed metadata, then presumably we want     */
 /*      to push it into PAM.                                            */
@@ -6716,70 +6811,107 @@ bool GTiffDataset::WriteEncodedStrip(uint32 strip, GByte* pabyData,
 }
 
 /************************************************************************/
-/*                        InitCompressionThreads()                      */
+/*                         GetNumThreadsOption()                        */
 /************************************************************************/
 
-void GTiffDataset::InitCompressionThreads(char** papszOptions)
+static int GetNumThreadsOption(char** papszOptions)
 {
     const char* pszValue = CSLFetchNameValue( papszOptions, "NUM_THREADS" );
     if (pszValue == NULL)
         pszValue = CPLGetConfigOption("GDAL_NUM_THREADS", NULL);
-    if( pszValue )
+    if( pszValue == NULL )
+        return 1;
+
+    int nThreads;
+    if (EQUAL(pszValue, "ALL_CPUS"))
+        nThreads = CPLGetNumCPUs();
+    else
+        nThreads = atoi(pszValue);
+    if( nThreads <= 1 &&
+        (nThreads < 0 || (!EQUAL(pszValue, "0") && !EQUAL(pszValue, "1") && !EQUAL(pszValue, "ALL_CPUS"))) )
     {
-        int nThreads;
-        if (EQUAL(pszValue, "ALL_CPUS"))
-            nThreads = CPLGetNumCPUs();
+        CPLError(CE_Warning, CPLE_AppDefined,
+                 "Invalid value for NUM_THREADS: %s", pszValue);
+    }
+    return nThreads;
+}
+
+/************************************************************************/
+/*                        InitCompressionThreads()                      */
+/************************************************************************/
+
+void GTiffDataset::InitCompressionThreads(char** papszOptions)
+{
+    const int nThreads = GetNumThreadsOption(papszOptions);
+    if( nThreads > 1 )
+    {
+        if( nCompression == COMPRESSION_NONE ||
+            nCompression == COMPRESSION_JPEG )
+        {
+            CPLDebug("GTiff", "NUM_THREADS ignored with uncompressed or JPEG");
+        }
         else
-            nThreads = atoi(pszValue);
-        if( nThreads > 1 )
         {
-            if( nCompression == COMPRESSION_NONE ||
-                nCompression == COMPRESSION_JPEG )
+            CPLDebug("GTiff", "Using %d threads for compression", nThreads);
+            poCompressThreadPool = new CPLWorkerThreadPool();
+            if( !poCompressThreadPool->Setup(nThreads, NULL, NULL) )
             {
-                CPLDebug("GTiff", "NUM_THREADS ignored with uncompressed or JPEG");
+                delete poCompressThreadPool;
+                poCompressThreadPool = NULL;
             }
             else
             {
-                CPLDebug("GTiff", "Using %d threads for compression", nThreads);
-                poCompressThreadPool = new CPLWorkerThreadPool();
-                if( !poCompressThreadPool->Setup(nThreads, NULL, NULL) )
+                // Add a margin of an extra job w.r.t thread number
+                // so as to optimize compression time (enables the main
+                // thread to do boring I/O while all CPUs are working)
+                asCompressionJobs.resize(nThreads + 1);
+                memset(&asCompressionJobs[0], 0,
+                       asCompressionJobs.size() * sizeof(GTiffCompressionJob));
+                for(int i=0;i<(int)asCompressionJobs.size();i++)
                 {
-                    delete poCompressThreadPool;
-                    poCompressThreadPool = NULL;
-                }
-                else
-                {
-                    // Add a margin of an extra job w.r.t thread number
-                    // so as to optimize compression time (enables the main
-                    // thread to do boring I/O while all CPUs are working)
-                    asCompressionJobs.resize(nThreads + 1);
-                    memset(&asCompressionJobs[0], 0,
-                           asCompressionJobs.size() * sizeof(GTiffCompressionJob));
-                    for(int i=0;i<(int)asCompressionJobs.size();i++)
-                    {
-                        asCompressionJobs[i].pszTmpFilename =
-                            CPLStrdup(CPLSPrintf("/vsimem/gtiff/thread/job/%p",
-                                                 &asCompressionJobs[i]));
-                        asCompressionJobs[i].nStripOrTile = -1;
-                    }
-                    hCompressThreadPoolMutex = CPLCreateMutex();
-                    CPLReleaseMutex(hCompressThreadPoolMutex);
-
-                    // This is kind of a hack, but basically using
-                    // TIFFWriteRawStrip/Tile and then TIFFReadEncodedStrip/Tile
-                    // does not work on a newly created file, because TIFF_MYBUFFER
-                    // is not set in tif_flags
-                    // (if using TIFFWriteEncodedStrip/Tile first, TIFFWriteBufferSetup()
-                    // is automatically called)
-                    // This should likely rather fixed in libtiff itself...
-                    TIFFWriteBufferSetup(hTIFF, NULL, -1);
+                    asCompressionJobs[i].pszTmpFilename =
+                        CPLStrdup(CPLSPrintf("/vsimem/gtiff/thread/job/%p",
+                                             &asCompressionJobs[i]));
+                    asCompressionJobs[i].nStripOrTile = -1;
                 }
+                hCompressThreadPoolMutex = CPLCreateMutex();
+                CPLReleaseMutex(hCompressThreadPoolMutex);
+
+                // This is kind of a hack, but basically using
+                // TIFFWriteRawStrip/Tile and then TIFFReadEncodedStrip/Tile
+                // does not work on a newly created file, because TIFF_MYBUFFER
+                // is not set in tif_flags
+                // (if using TIFFWriteEncodedStrip/Tile first, TIFFWriteBufferSetup()
+                // is automatically called)
+                // This should likely rather fixed in libtiff itself...
+                TIFFWriteBufferSetup(hTIFF, NULL, -1);
             }
         }
-        else if (nThreads < 0 || (!EQUAL(pszValue, "0") && !EQUAL(pszValue, "1") && !EQUAL(pszValue, "ALL_CPUS")) )
+    }
+}
+
+/************************************************************************/
+/*                       InitDecompressionThreads()                     */
+/************************************************************************/
+
+void GTiffDataset::InitDecompressionThreads(char** papszOptions)
+{
+    const int nThreads = GetNumThreadsOption(papszOptions);
+    if( nThreads > 1 )
+    {
+        if( nCompression == COMPRESSION_NONE )
         {
-            CPLError(CE_Warning, CPLE_AppDefined,
-                     "Invalid value for NUM_THREADS: %s", pszValue);
+            CPLDebug("GTiff", "NUM_THREADS ignored with uncompressed");
+        }
+        else
+        {
+            CPLDebug("GTiff", "Using %d threads for decompression", nThreads);
+            poDecompressThreadPool = new CPLWorkerThreadPool();
+            if( !poDecompressThreadPool->Setup(nThreads, NULL, NULL) )
+            {
+                delete poDecompressThreadPool;
+                poDecompressThreadPool = NULL;
+            }
         }
     }
 }
@@ -7022,6 +7154,327 @@ int GTiffDataset::SubmitCompressionJob(int nStripOrTile, GByte* pabyData,
     return TRUE;
 }
 
+/************************************************************************/
+/*                      GetDecompressThreadPool()                       */
+/*                                                                      */
+/*      Overview and mask datasets use the pool of their base dataset.  */
+/************************************************************************/
+
+CPLWorkerThreadPool* GTiffDataset::GetDecompressThreadPool()
+{
+    GTiffDataset* poRootDS = this;
+    while( poRootDS->poBaseDS != NULL )
+        poRootDS = poRootDS->poBaseDS;
+    return poRootDS->poDecompressThreadPool;
+}
+
+/************************************************************************/
+/*                      OpenDecompressionHandles()                      */
+/*                                                                      */
+/*      Make sure that nCount TIFF handles opened on the directory of   */
+/*      this dataset are available to the decompression threads.       */
+/************************************************************************/
+
+bool GTiffDataset::OpenDecompressionHandles(int nCount)
+{
+    GTiffDataset* poRootDS = this;
+    while( poRootDS->poBaseDS != NULL )
+        poRootDS = poRootDS->poBaseDS;
+
+    int nColorMode = 0;
+    const bool bSetColorMode = nCompression == COMPRESSION_JPEG &&
+        TIFFGetField( hTIFF, TIFFTAG_JPEGCOLORMODE, &nColorMode );
+
+    while( static_cast<int>(asDecompressionHandles.size()) < nCount )
+    {
+        GTiffDecompressionHandle sHandle;
+        sHandle.fp = VSIFOpenL( poRootDS->osFilename, "rb" );
+        if( sHandle.fp == NULL )
+            return false;
+
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        sHandle.hTIFF = VSI_TIFFOpen( poRootDS->osFilename, "rc", sHandle.fp );
+        const bool bOK = sHandle.hTIFF != NULL &&
+            TIFFSetSubDirectory( sHandle.hTIFF, nDirOffset ) &&
+            TIFFIsTiled( sHandle.hTIFF ) == TIFFIsTiled( hTIFF ) &&
+            TIFFNumberOfStrips( sHandle.hTIFF ) == TIFFNumberOfStrips( hTIFF );
+        CPLPopErrorHandler();
+        if( !bOK )
+        {
+            CPLDebug("GTiff", "Cannot open %s for decompression threads",
+                     poRootDS->osFilename.c_str());
+            if( sHandle.hTIFF != NULL )
+                XTIFFClose( sHandle.hTIFF );
+            CPL_IGNORE_RET_VAL(VSIFCloseL( sHandle.fp ));
+            return false;
+        }
+
+        if( bSetColorMode )
+            TIFFSetField( sHandle.hTIFF, TIFFTAG_JPEGCOLORMODE, nColorMode );
+
+        asDecompressionHandles.push_back(sHandle);
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                      ThreadDecompressionFunc()                       */
+/************************************************************************/
+
+void GTiffDataset::ThreadDecompressionFunc(void* pData)
+{
+    GTiffDecompressionJob* psJob = static_cast<GTiffDecompressionJob*>(pData);
+    GTiffDataset* poDS = psJob->poDS;
+
+    GTiffDecompressionHandle sHandle;
+    {
+        CPLMutexHolderD(&poDS->hDecompressHandlesMutex);
+        sHandle = poDS->asDecompressionHandles.back();
+        poDS->asDecompressionHandles.pop_back();
+    }
+
+    // Pixel interleaved blocks are decoded in a temporary buffer, and then
+    // dispatched to the blocks of each band.
+    const bool bInterleaved = psJob->apoBlocks.size() > 1;
+    GByte* pabyBuffer = bInterleaved ?
+        static_cast<GByte*>(VSI_MALLOC_VERBOSE(psJob->nBlockBufSize)) :
+        static_cast<GByte*>(psJob->apoBlocks[0]->GetDataRef());
+
+    if( pabyBuffer != NULL )
+    {
+        if( psJob->nBlockReqSize < psJob->nBlockBufSize )
+            memset( pabyBuffer, 0, psJob->nBlockBufSize );
+
+        // Errors are reported when the block is read again by IReadBlock()
+        CPLPushErrorHandler(CPLQuietErrorHandler);
+        if( TIFFIsTiled( sHandle.hTIFF ) )
+            psJob->bSuccess = TIFFReadEncodedTile( sHandle.hTIFF,
+                                                   psJob->nBlockId,
+                                                   pabyBuffer,
+                                                   psJob->nBlockReqSize ) != -1;
+        else
+            psJob->bSuccess = TIFFReadEncodedStrip( sHandle.hTIFF,
+                                                    psJob->nBlockId,
+                                                    pabyBuffer,
+                                                    psJob->nBlockReqSize ) != -1;
+        CPLPopErrorHandler();
+    }
+
+    if( bInterleaved && psJob->bSuccess )
+    {
+        const int nWordBytes = poDS->nBitsPerSample / 8;
+        for( int iBand = 0; iBand < poDS->nBands; iBand++ )
+        {
+            GDALRasterBlock* poBlock = psJob->apoBlocks[iBand];
+            if( poBlock == NULL )
+                continue;
+            GDALCopyWords(pabyBuffer + iBand * nWordBytes,
+                          poBlock->GetDataType(), poDS->nBands * nWordBytes,
+                          poBlock->GetDataRef(),
+                          poBlock->GetDataType(), nWordBytes,
+                          poBlock->GetXSize() * poBlock->GetYSize());
+        }
+    }
+    if( bInterleaved )
+        VSIFree(pabyBuffer);
+
+    {
+        CPLMutexHolderD(&poDS->hDecompressHandlesMutex);
+        poDS->asDecompressionHandles.push_back(sHandle);
+    }
+}
+
+/************************************************************************/
+/*                      CacheBlocksMultiThreaded()                      */
+/*                                                                      */
+/*      Decode in the decompression threads the blocks intersecting     */
+/*      a window that are not yet in the block cache, so that the       */
+/*      following RasterIO() finds them there.                          */
+/************************************************************************/
+
+void GTiffDataset::CacheBlocksMultiThreaded( int nXOff, int nYOff,
+                                             int nXSize, int nYSize,
+                                             int nBandCount, int *panBandMap )
+{
+    CPLWorkerThreadPool* poPool = GetDecompressThreadPool();
+    if( poPool == NULL || eAccess != GA_ReadOnly || bStreamingIn ||
+        bTreatAsRGBA || bTreatAsSplit || bTreatAsSplitBitmap ||
+        nCompression == COMPRESSION_NONE )
+        return;
+
+    // Only for bands handled by GTiffRasterBand itself
+    const GDALDataType eDataType = GetRasterBand(1)->GetRasterDataType();
+    const int nDTSize = GDALGetDataTypeSizeBytes(eDataType);
+    if( nDTSize * 8 != nBitsPerSample )
+        return;
+
+    if( !SetDirectory() )
+        return;
+
+    const bool bInterleaved = nBands > 1 &&
+                              nPlanarConfig == PLANARCONFIG_CONTIG;
+    const int nBlockBufSize = static_cast<int>(TIFFIsTiled(hTIFF) ?
+        TIFFTileSize(hTIFF) : TIFFStripSize(hTIFF));
+    if( nBlockBufSize <= 0 )
+        return;
+
+    const int nBlocksPerRow = DIV_ROUND_UP(nRasterXSize, nBlockXSize);
+    const int nBlockX1 = nXOff / nBlockXSize;
+    const int nBlockY1 = nYOff / nBlockYSize;
+    const int nBlockX2 = (nXOff + nXSize - 1) / nBlockXSize;
+    const int nBlockY2 = (nYOff + nYSize - 1) / nBlockYSize;
+
+/* -------------------------------------------------------------------- */
+/*      Do not bother for a single block, nor if the blocks cannot      */
+/*      stay in the cache till they are used.                           */
+/* -------------------------------------------------------------------- */
+    const GIntBig nBlocks =
+        static_cast<GIntBig>(nBlockX2 - nBlockX1 + 1) *
+        (nBlockY2 - nBlockY1 + 1) * (bInterleaved ? nBands : nBandCount);
+    if( nBlocks < 2 )
+        return;
+    const GIntBig nRequiredMem =
+        nBlocks * nBlockXSize * nBlockYSize * nDTSize;
+
+    // The blocks are spread over the shards of the block cache, each of
+    // them getting an equal share of the cache size, and count against the
+    // quota of the dataset, if any.
+    const int nShardCount = GDALGetCacheShardCount();
+    GIntBig nCacheMax = (GDALGetCacheMax64() / nShardCount) *
+                        MIN(nBlocks, static_cast<GIntBig>(nShardCount));
+    const GIntBig nDatasetCacheMax = GetBlockCacheMax();
+    if( nDatasetCacheMax > 0 )
+        nCacheMax = MIN(nCacheMax, nDatasetCacheMax);
+    if( nRequiredMem > nCacheMax / 2 )
+    {
+        if( !bHasWarnedDisableDecompressionThreads )
+        {
+            CPLDebug( "GTiff", "Decompression threads not used. Cache not "
+                      "big enough. At least " CPL_FRMT_GIB " bytes necessary",
+                      nRequiredMem * 2 );
+            bHasWarnedDisableDecompressionThreads = TRUE;
+        }
+        return;
+    }
+
+    if( hDecompressHandlesMutex == NULL )
+    {
+        hDecompressHandlesMutex = CPLCreateMutex();
+        CPLReleaseMutex(hDecompressHandlesMutex);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Lock new blocks for the ones that are not yet cached.           */
+/* -------------------------------------------------------------------- */
+    std::vector<GTiffDecompressionJob> asJobs;
+    for( int nBlockYOff = nBlockY1; nBlockYOff <= nBlockY2; nBlockYOff++ )
+    {
+        // The bottom most partial tiles and strips are sometimes only
+        // partially encoded (#1179)
+        int nBlockReqSize = nBlockBufSize;
+        if( static_cast<int>((nBlockYOff+1) * nBlockYSize) > nRasterYSize )
+        {
+            nBlockReqSize = (nBlockBufSize / nBlockYSize)
+                * (nBlockYSize - (((nBlockYOff+1) * nBlockYSize) % nRasterYSize));
+        }
+
+        for( int nBlockXOff = nBlockX1; nBlockXOff <= nBlockX2; nBlockXOff++ )
+        {
+            const int nBlockIdBand0 = nBlockXOff + nBlockYOff * nBlocksPerRow;
+            const int nJobBands = bInterleaved ? nBands : nBandCount;
+            for( int i = 0; i < nJobBands; i++ )
+            {
+                const int iBand = bInterleaved ? i + 1 : panBandMap[i];
+                GTiffRasterBand* poBand =
+                    static_cast<GTiffRasterBand*>(GetRasterBand(iBand));
+                GDALRasterBlock* poBlock =
+                    poBand->TryGetLockedBlockRef(nBlockXOff, nBlockYOff);
+                if( poBlock != NULL )
+                {
+                    poBlock->DropLock();
+                    continue;
+                }
+
+                int nBlockId = nBlockIdBand0;
+                if( nPlanarConfig == PLANARCONFIG_SEPARATE )
+                    nBlockId += (iBand - 1) * nBlocksPerBand;
+
+                if( !bInterleaved || asJobs.empty() ||
+                    asJobs.back().nBlockId != nBlockId )
+                {
+                    // Missing blocks are left to IReadBlock()
+                    if( !IsBlockAvailable(nBlockId) )
+                    {
+                        if( bInterleaved )
+                            break;
+                        continue;
+                    }
+                    GTiffDecompressionJob sJob;
+                    sJob.poDS = this;
+                    sJob.nBlockXOff = nBlockXOff;
+                    sJob.nBlockYOff = nBlockYOff;
+                    sJob.nBlockId = nBlockId;
+                    sJob.nBlockBufSize = nBlockBufSize;
+                    sJob.nBlockReqSize = nBlockReqSize;
+                    sJob.apoBlocks.resize(bInterleaved ? nBands : 1);
+                    sJob.bSuccess = false;
+                    asJobs.push_back(sJob);
+                }
+
+                poBlock = poBand->GetLockedBlockRef(nBlockXOff, nBlockYOff,
+                                                    TRUE);
+                asJobs.back().apoBlocks[bInterleaved ? i : 0] = poBlock;
+                if( poBlock == NULL && !bInterleaved )
+                    asJobs.pop_back();
+            }
+        }
+    }
+
+    // Drop the pixel interleaved jobs that ended up with no block to fill
+    for( int i = static_cast<int>(asJobs.size()) - 1; i >= 0; i-- )
+    {
+        bool bHasBlock = false;
+        for( size_t j = 0; j < asJobs[i].apoBlocks.size(); j++ )
+            bHasBlock |= asJobs[i].apoBlocks[j] != NULL;
+        if( !bHasBlock )
+            asJobs.erase(asJobs.begin() + i);
+    }
+    if( asJobs.empty() )
+        return;
+
+/* -------------------------------------------------------------------- */
+/*      Decode them in the threads.                                     */
+/* -------------------------------------------------------------------- */
+    if( OpenDecompressionHandles(std::min(static_cast<int>(asJobs.size()),
+                                          poPool->GetThreadCount())) )
+    {
+        std::vector<void*> apJobs;
+        for( size_t i = 0; i < asJobs.size(); i++ )
+            apJobs.push_back(&asJobs[i]);
+        poPool->SubmitJobs(ThreadDecompressionFunc, apJobs);
+        poPool->WaitCompletion();
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Release the blocks. The ones that could not be decoded are      */
+/*      discarded, so that IReadBlock() reads them again and reports    */
+/*      the error.                                                      */
+/* -------------------------------------------------------------------- */
+    for( size_t i = 0; i < asJobs.size(); i++ )
+    {
+        for( size_t j = 0; j < asJobs[i].apoBlocks.size(); j++ )
+        {
+            GDALRasterBlock* poBlock = asJobs[i].apoBlocks[j];
+            if( poBlock == NULL )
+                continue;
+            poBlock->DropLock();
+            if( !asJobs[i].bSuccess )
+                poBlock->GetBand()->FlushBlock(asJobs[i].nBlockXOff,
+                                               asJobs[i].nBlockYOff);
+        }
+    }
+}
+
 /************************************************************************/
 /*                          DiscardLsb()                               */
 /************************************************************************/
@@ -8196,6 +8649,41 @@ CPLErr GTiffDataset::IBuildOverviews(
     int nBandsIn, int * panBandList,
     GDALProgressFunc pfnProgress, void * pProgressData )
 
+{
+/* -------------------------------------------------------------------- */
+/*      The overview computation code is driven by GDAL_NUM_THREADS,    */
+/*      so forward the NUM_THREADS open option to it.                   */
+/* -------------------------------------------------------------------- */
+    const char* pszNumThreads =
+        CSLFetchNameValue(papszOpenOptions, "NUM_THREADS");
+    if( pszNumThreads == NULL )
+        return BuildOverviewsInternal( pszResampling,
+                                       nOverviews, panOverviewList,
+                                       nBandsIn, panBandList,
+                                       pfnProgress, pProgressData );
+
+    CPLString osOldVal =
+        CPLGetThreadLocalConfigOption("GDAL_NUM_THREADS", "");
+    CPLSetThreadLocalConfigOption("GDAL_NUM_THREADS", pszNumThreads);
+    CPLErr eErr = BuildOverviewsInternal( pszResampling,
+                                          nOverviews, panOverviewList,
+                                          nBandsIn, panBandList,
+                                          pfnProgress, pProgressData );
+    CPLSetThreadLocalConfigOption("GDAL_NUM_THREADS",
+                                  osOldVal.size() ? osOldVal.c_str() : NULL);
+    return eErr;
+}
+
+/************************************************************************/
+/*                       BuildOverviewsInternal()                       */
+/************************************************************************/
+
+CPLErr GTiffDataset::BuildOverviewsInternal(
+    const char * pszResampling,
+    int nOverviews, int * panOverviewList,
+    int nBandsIn, int * panBandList,
+    GDALProgressFunc pfnProgress, void * pProgressData )
+
 {
     CPLErr       eErr = CE_None;
     int          i;
@@ -8593,9 +9081,12 @@ CPLErr GTiffDataset::IBuildOverviews(
             }
         }
 
-        GDALRegenerateOverviewsMultiBand(nBandsIn, papoBandList,
+        CPLErr eErrMB =
+            GDALRegenerateOverviewsMultiBand(nBandsIn, papoBandList,
                                          nNewOverviews, papapoOverviewBands,
                                          pszResampling, pfnProgress, pProgressData );
+        if( eErr == CE_None )
+            eErr = eErrMB;
 
         for( iBand = 0; iBand < nBandsIn; iBand++ )
         {
@@ -10128,6 +10619,10 @@ GDALDataset *GTiffDataset::Open( GDALOpenInfo * poOpenInfo )
     {
         poDS->InitCreationOrOpenOptions(poOpenInfo->papszOpenOptions);
     }
+    else
+    {
+        poDS->InitDecompressionThreads(poOpenInfo->papszOpenOptions);
+    }
 
     if( nCompression == COMPRESSION_JPEG && poOpenInfo->eAccess == GA_Update )
     {
@@ -15592,7 +16087,7 @@ void GDALRegister_GTiff()
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONOPTIONLIST, szCreateOptions );
     poDriver->SetMetadataItem( GDAL_DMD_OPENOPTIONLIST,
 "<OpenOptionList>"
-"   <Option name='NUM_THREADS' type='string' description='Number of worker threads for compression. Can be set to ALL_CPUS' default='1'/>"
+"   <Option name='NUM_THREADS' type='string' description='Number of worker threads for compression, or for decompression in read-only mode, and for overview computation. Can be set to ALL_CPUS' default='1'/>"
 "   <Option name='GEOTIFF_KEYS_FLAVOR' type='string-select' default='STANDARD' description='Which flavor of GeoTIFF keys must be used (for writing)'>"
 "       <Value>STANDARD</Value>"
 "       <Value>ESRI_PE</Value>"
@@ -0,0 +1,360 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  Virtual GDAL Datasets
+ * Purpose:  Compact binary encoding of the XML tree of a VRT, so that it can
+ *           be opened without parsing XML text.
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "vrtdataset.h"
+#include "cpl_minixml.h"
+#include "cpl_string.h"
+
+CPL_CVSID("$Id$");
+
+/*
+ * Layout of a binary VRT (all integers are little-endian 32 bit unsigned):
+ *
+ *   Header:
+ *     8 bytes: signature "GDALVRTB"
+ *     version (currently 1)
+ *     number of strings
+ *     size in bytes of the string table
+ *     number of nodes
+ *     number of top-level nodes
+ *
+ *   String table: the distinct node values (element and attribute names,
+ *   texts), each one terminated by a nul character.
+ *
+ *   Nodes, in depth-first order, 9 bytes each:
+ *     1 byte: node type (CPLXMLNodeType)
+ *     index of the node value in the string table
+ *     number of children
+ *
+ * Decoding requires no tokenization nor escaping, which is what dominates
+ * the parsing of the XML form of big mosaics. The decoded tree is an ordinary
+ * CPLXMLNode tree, since the XMLInit() methods of the VRT datasets may edit
+ * it.
+ */
+
+static const char szVRTBinarySignature[] = "GDALVRTB";
+static const int VRT_BINARY_SIGNATURE_SIZE = 8;
+static const int VRT_BINARY_HEADER_SIZE = VRT_BINARY_SIGNATURE_SIZE + 5 * 4;
+static const int VRT_BINARY_NODE_SIZE = 1 + 2 * 4;
+static const GUInt32 VRT_BINARY_VERSION = 1;
+
+/************************************************************************/
+/*                          VRTIsBinaryTree()                           */
+/************************************************************************/
+
+int VRTIsBinaryTree( const GByte *pabyData, size_t nDataSize )
+
+{
+    return nDataSize >= static_cast<size_t>(VRT_BINARY_SIGNATURE_SIZE) &&
+           memcmp( pabyData, szVRTBinarySignature,
+                   VRT_BINARY_SIGNATURE_SIZE ) == 0;
+}
+
+/************************************************************************/
+/*                        VRTIsBinaryFilename()                         */
+/*                                                                      */
+/*      Whether a VRT written to that file should use the binary        */
+/*      encoding.                                                       */
+/************************************************************************/
+
+int VRTIsBinaryFilename( const char *pszFilename )
+
+{
+    return EQUAL( CPLGetExtension(pszFilename), "vrtb" );
+}
+
+/************************************************************************/
+/*                              WriteUInt32()                           */
+/************************************************************************/
+
+static void WriteUInt32( std::vector<GByte>& abyOut, GUInt32 nVal )
+{
+    CPL_LSBPTR32( &nVal );
+    const GByte* pabyVal = reinterpret_cast<const GByte *>( &nVal );
+    abyOut.insert( abyOut.end(), pabyVal, pabyVal + 4 );
+}
+
+/************************************************************************/
+/*                              ReadUInt32()                            */
+/************************************************************************/
+
+static GUInt32 ReadUInt32( const GByte *pabyData )
+{
+    GUInt32 nVal;
+    memcpy( &nVal, pabyData, 4 );
+    CPL_LSBPTR32( &nVal );
+    return nVal;
+}
+
+/************************************************************************/
+/*                           SerializeNode()                            */
+/************************************************************************/
+
+static void SerializeNode( const CPLXMLNode *psNode,
+                           std::map<CPLString, GUInt32>& oMapStrings,
+                           std::vector<GByte>& abyStrings,
+                           std::vector<GByte>& abyNodes,
+                           GUInt32& nNodeCount )
+{
+    const char* pszValue = psNode->pszValue ? psNode->pszValue : "";
+    std::map<CPLString, GUInt32>::iterator oIter = oMapStrings.find(pszValue);
+    GUInt32 nStringIdx;
+    if( oIter == oMapStrings.end() )
+    {
+        nStringIdx = static_cast<GUInt32>(oMapStrings.size());
+        oMapStrings[pszValue] = nStringIdx;
+        abyStrings.insert( abyStrings.end(),
+                           reinterpret_cast<const GByte *>(pszValue),
+                           reinterpret_cast<const GByte *>(pszValue) +
+                                strlen(pszValue) + 1 );
+    }
+    else
+        nStringIdx = oIter->second;
+
+    GUInt32 nChildCount = 0;
+    for( const CPLXMLNode* psChild = psNode->psChild; psChild != NULL;
+         psChild = psChild->psNext )
+        nChildCount ++;
+
+    abyNodes.push_back( static_cast<GByte>(psNode->eType) );
+    WriteUInt32( abyNodes, nStringIdx );
+    WriteUInt32( abyNodes, nChildCount );
+    nNodeCount ++;
+
+    // Attributes are written first, which is the order in which the XML
+    // parser creates them, whatever the order in the serialized tree.
+    for( int iPass = 0; iPass < 2; iPass++ )
+    {
+        for( const CPLXMLNode* psChild = psNode->psChild; psChild != NULL;
+             psChild = psChild->psNext )
+        {
+            if( (psChild->eType == CXT_Attribute) == (iPass == 0) )
+                SerializeNode( psChild, oMapStrings, abyStrings, abyNodes,
+                               nNodeCount );
+        }
+    }
+}
+
+/************************************************************************/
+/*                       VRTSerializeBinaryTree()                       */
+/*                                                                      */
+/*      Encode a XML tree, and its siblings, in a buffer to free with   */
+/*      CPLFree().                                                      */
+/************************************************************************/
+
+GByte *VRTSerializeBinaryTree( const CPLXMLNode *psTree, size_t *pnSize )
+
+{
+    std::map<CPLString, GUInt32> oMapStrings;
+    std::vector<GByte> abyStrings;
+    std::vector<GByte> abyNodes;
+    GUInt32 nNodeCount = 0;
+    GUInt32 nRootCount = 0;
+
+    for( const CPLXMLNode* psNode = psTree; psNode != NULL;
+         psNode = psNode->psNext )
+    {
+        SerializeNode( psNode, oMapStrings, abyStrings, abyNodes, nNodeCount );
+        nRootCount ++;
+    }
+
+    std::vector<GByte> abyHeader( szVRTBinarySignature,
+                                  szVRTBinarySignature +
+                                        VRT_BINARY_SIGNATURE_SIZE );
+    WriteUInt32( abyHeader, VRT_BINARY_VERSION );
+    WriteUInt32( abyHeader, static_cast<GUInt32>(oMapStrings.size()) );
+    WriteUInt32( abyHeader, static_cast<GUInt32>(abyStrings.size()) );
+    WriteUInt32( abyHeader, nNodeCount );
+    WriteUInt32( abyHeader, nRootCount );
+
+    *pnSize = abyHeader.size() + abyStrings.size() + abyNodes.size();
+    GByte* pabyRet = static_cast<GByte *>( VSI_MALLOC_VERBOSE(*pnSize) );
+    if( pabyRet == NULL )
+    {
+        *pnSize = 0;
+        return NULL;
+    }
+    memcpy( pabyRet, &abyHeader[0], abyHeader.size() );
+    if( !abyStrings.empty() )
+        memcpy( pabyRet + abyHeader.size(), &abyStrings[0],
+                abyStrings.size() );
+    if( !abyNodes.empty() )
+        memcpy( pabyRet + abyHeader.size() + abyStrings.size(), &abyNodes[0],
+                abyNodes.size() );
+    return pabyRet;
+}
+
+/************************************************************************/
+/*                         VRTParseBinaryTree()                         */
+/*                                                                      */
+/*      Decode a buffer produced by VRTSerializeBinaryTree(). The       */
+/*      returned tree must be freed with CPLDestroyXMLNode().           */
+/************************************************************************/
+
+CPLXMLNode *VRTParseBinaryTree( const GByte *pabyData, size_t nDataSize )
+
+{
+    if( nDataSize < static_cast<size_t>(VRT_BINARY_HEADER_SIZE) ||
+        !VRTIsBinaryTree( pabyData, nDataSize ) )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined, "Not a binary VRT." );
+        return NULL;
+    }
+
+    const GByte* pabyHeader = pabyData + VRT_BINARY_SIGNATURE_SIZE;
+    const GUInt32 nVersion = ReadUInt32( pabyHeader );
+    const GUInt32 nStringCount = ReadUInt32( pabyHeader + 4 );
+    const GUInt32 nStringsSize = ReadUInt32( pabyHeader + 8 );
+    const GUInt32 nNodeCount = ReadUInt32( pabyHeader + 12 );
+    const GUInt32 nRootCount = ReadUInt32( pabyHeader + 16 );
+
+    if( nVersion != VRT_BINARY_VERSION )
+    {
+        CPLError( CE_Failure, CPLE_NotSupported,
+                  "Unsupported binary VRT version: %u.", nVersion );
+        return NULL;
+    }
+
+    if( static_cast<GUIntBig>(VRT_BINARY_HEADER_SIZE) + nStringsSize +
+            static_cast<GUIntBig>(nNodeCount) * VRT_BINARY_NODE_SIZE
+                                        != static_cast<GUIntBig>(nDataSize) ||
+        nStringCount > nStringsSize || nRootCount == 0 ||
+        nRootCount > nNodeCount ||
+        (nStringsSize > 0 &&
+         pabyData[VRT_BINARY_HEADER_SIZE + nStringsSize - 1] != '\0') )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined, "Corrupted binary VRT." );
+        return NULL;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Index the string table.                                         */
+/* -------------------------------------------------------------------- */
+    const char* pszStrings =
+        reinterpret_cast<const char *>( pabyData + VRT_BINARY_HEADER_SIZE );
+    std::vector<const char*> apszStrings;
+    apszStrings.reserve( nStringCount );
+    for( GUInt32 nOffset = 0; nOffset < nStringsSize; )
+    {
+        const char* pszString = pszStrings + nOffset;
+        apszStrings.push_back( pszString );
+        nOffset += static_cast<GUInt32>(strlen(pszString)) + 1;
+    }
+    if( apszStrings.size() != nStringCount )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined, "Corrupted binary VRT." );
+        return NULL;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Link the nodes. The stack holds the nodes whose children are    */
+/*      being read, the first entry standing for the top level.         */
+/* -------------------------------------------------------------------- */
+    struct ParentInfo
+    {
+        CPLXMLNode *psNode;
+        CPLXMLNode *psLastChild;
+        GUInt32     nRemainingChildren;
+    };
+    std::vector<ParentInfo> asStack;
+    ParentInfo sTopLevel;
+    sTopLevel.psNode = NULL;
+    sTopLevel.psLastChild = NULL;
+    sTopLevel.nRemainingChildren = nRootCount;
+    asStack.push_back( sTopLevel );
+
+    CPLXMLNode* psRoot = NULL;
+    const GByte* pabyNode = pabyData + VRT_BINARY_HEADER_SIZE + nStringsSize;
+    for( GUInt32 iNode = 0; iNode < nNodeCount;
+         iNode++, pabyNode += VRT_BINARY_NODE_SIZE )
+    {
+        while( !asStack.empty() && asStack.back().nRemainingChildren == 0 )
+            asStack.pop_back();
+
+        const int nType = pabyNode[0];
+        const GUInt32 nStringIdx = ReadUInt32( pabyNode + 1 );
+        const GUInt32 nChildCount = ReadUInt32( pabyNode + 5 );
+
+        // Besides bounds, check the invariants of the trees built by the XML
+        // parser that the users of CPLXMLNode rely on: an attribute has a
+        // single text child and is the child of an element, and only
+        // elements and attributes have children.
+        const CPLXMLNode* psParent =
+            asStack.empty() ? NULL : asStack.back().psNode;
+        if( asStack.empty() || nType > CXT_Literal ||
+            nStringIdx >= nStringCount ||
+            nChildCount > nNodeCount - iNode - 1 ||
+            (nType == CXT_Attribute &&
+             (nChildCount != 1 || psParent == NULL ||
+              psParent->eType != CXT_Element)) ||
+            (nType != CXT_Attribute && nType != CXT_Element &&
+             nChildCount != 0) ||
+            (psParent != NULL && psParent->eType == CXT_Attribute &&
+             nType != CXT_Text) )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined, "Corrupted binary VRT." );
+            CPLDestroyXMLNode( psRoot );
+            return NULL;
+        }
+
+        CPLXMLNode* psNode = CPLCreateXMLNode(
+            NULL, static_cast<CPLXMLNodeType>(nType), apszStrings[nStringIdx] );
+
+        ParentInfo& sParent = asStack.back();
+        if( sParent.psLastChild != NULL )
+            sParent.psLastChild->psNext = psNode;
+        else if( sParent.psNode != NULL )
+            sParent.psNode->psChild = psNode;
+        else
+            psRoot = psNode;
+        sParent.psLastChild = psNode;
+        sParent.nRemainingChildren --;
+
+        if( nChildCount > 0 )
+        {
+            ParentInfo sInfo;
+            sInfo.psNode = psNode;
+            sInfo.psLastChild = NULL;
+            sInfo.nRemainingChildren = nChildCount;
+            asStack.push_back( sInfo );
+        }
+    }
+
+    for( size_t i = 0; i < asStack.size(); i++ )
+    {
+        if( asStack[i].nRemainingChildren != 0 )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined, "Corrupted binary VRT." );
+            CPLDestroyXMLNode( psRoot );
+            return NULL;
+        }
+    }
+
+    return psRoot;
+}
@@ -141,11 +141,37 @@ void VRTDataset::FlushCache()
         return;
     }
 
+    bool bOK = true;
+    if( VRTIsBinaryFilename( GetDescription() ) )
+    {
+    /* -------------------------------------------------------------------- */
+    /*      Write the binary encoding of the tree.                          */
+    /* -------------------------------------------------------------------- */
+        char *l_pszVRTPath = CPLStrdup(CPLGetPath(GetDescription()));
+        CPLXMLNode *psDSTree = SerializeToXML( l_pszVRTPath );
+        CPLFree( l_pszVRTPath );
+
+        size_t nSize = 0;
+        GByte *pabyContent = VRTSerializeBinaryTree( psDSTree, &nSize );
+        CPLDestroyXMLNode( psDSTree );
+
+        bOK &= pabyContent != NULL &&
+               VSIFWriteL( pabyContent, 1, nSize, fpVRT ) == nSize;
+        CPLFree( pabyContent );
+        if( VSIFCloseL( fpVRT ) != 0 )
+            bOK = false;
+        if( !bOK )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Failed to write .vrtb file in FlushCache()." );
+        }
+        return;
+    }
+
     /* -------------------------------------------------------------------- */
     /*      Convert tree to a single block of XML text.                     */
     /* -------------------------------------------------------------------- */
     char** papszContent = GetMetadata("xml:VRT");
-    bool bOK = true;
     if( papszContent && papszContent[0] )
     {
         /* ------------------------------------------------------------------ */
@@ -635,6 +661,9 @@ int VRTDataset::Identify( GDALOpenInfo * poOpenInfo )
          && strstr((const char *)poOpenInfo->pabyHeader,"<VRTDataset") != NULL )
         return TRUE;
 
+    if( VRTIsBinaryTree( poOpenInfo->pabyHeader, poOpenInfo->nHeaderBytes ) )
+        return TRUE;
+
     if( strstr(poOpenInfo->pszFilename,"<VRTDataset") != NULL )
         return TRUE;
 
@@ -659,6 +688,7 @@ GDALDataset *VRTDataset::Open( GDALOpenInfo * poOpenInfo )
 /*	Try to read the whole file into memory.				*/
 /* -------------------------------------------------------------------- */
     char *pszXML = NULL;
+    size_t nXMLLength = 0;
     VSILFILE *fp = poOpenInfo->fpL;
 
     char *pszVRTPath = NULL;
@@ -715,6 +745,7 @@ GDALDataset *VRTDataset::Open( GDALOpenInfo * poOpenInfo )
         }
 
         pszXML[nLength] = '\0';
+        nXMLLength = nLength;
 
         char* pszCurDir = CPLGetCurrentDir();
         const char *currentVrtFilename
@@ -790,8 +821,30 @@ GDALDataset *VRTDataset::Open( GDALOpenInfo * poOpenInfo )
 /* -------------------------------------------------------------------- */
 /*      Turn the XML representation into a VRTDataset.                  */
 /* -------------------------------------------------------------------- */
-    VRTDataset *poDS = reinterpret_cast<VRTDataset *>(
-        OpenXML( pszXML, pszVRTPath, poOpenInfo->eAccess ) );
+    VRTDataset *poDS;
+    if( VRTIsBinaryTree( reinterpret_cast<const GByte *>(pszXML),
+                         nXMLLength ) )
+    {
+        CPLXMLNode *psTree = VRTParseBinaryTree(
+            reinterpret_cast<const GByte *>(pszXML), nXMLLength );
+        if( psTree == NULL )
+            poDS = NULL;
+        else
+        {
+            const char* pszSubClass = CPLGetXMLValue(
+                psTree, "=VRTDataset.subClass", "" );
+            poDS = reinterpret_cast<VRTDataset *>(
+                OpenXMLTree( psTree, pszVRTPath, poOpenInfo->eAccess,
+                             EQUAL(pszSubClass, "VRTWarpedDataset"),
+                             EQUAL(pszSubClass, "VRTPansharpenedDataset") ) );
+            CPLDestroyXMLNode( psTree );
+        }
+    }
+    else
+    {
+        poDS = reinterpret_cast<VRTDataset *>(
+            OpenXML( pszXML, pszVRTPath, poOpenInfo->eAccess ) );
+    }
 
     if( poDS != NULL )
         poDS->m_bNeedsFlush = FALSE;
@@ -830,18 +883,37 @@ GDALDataset *VRTDataset::OpenXML( const char *pszXML, const char *pszVRTPath,
     if( psTree == NULL )
         return NULL;
 
+    GDALDataset* poDS = OpenXMLTree(
+        psTree, pszVRTPath, eAccess,
+        strstr( pszXML, "VRTWarpedDataset" ) != NULL,
+        strstr( pszXML, "VRTPansharpenedDataset" ) != NULL );
+
+    CPLDestroyXMLNode( psTree );
+
+    return poDS;
+}
+
+/************************************************************************/
+/*                            OpenXMLTree()                             */
+/*                                                                      */
+/*      Create an open VRTDataset from a XML tree, parsed from XML      */
+/*      text or decoded from a binary VRT. The tree is not destroyed.   */
+/************************************************************************/
+
+GDALDataset *VRTDataset::OpenXMLTree( CPLXMLNode *psTree,
+                                      const char *pszVRTPath,
+                                      GDALAccess eAccess,
+                                      bool bIsWarped, bool bIsPansharpened )
+
+{
     CPLXMLNode *psRoot = CPLGetXMLNode( psTree, "=VRTDataset" );
     if (psRoot == NULL)
     {
         CPLError( CE_Failure, CPLE_AppDefined,
                   "Missing VRTDataset element." );
-        CPLDestroyXMLNode( psTree );
         return NULL;
     }
 
-    const bool bIsPansharpened
-        = strstr( pszXML, "VRTPansharpenedDataset" ) != NULL;
-
     if( !bIsPansharpened &&
         (CPLGetXMLNode( psRoot, "rasterXSize" ) == NULL
         || CPLGetXMLNode( psRoot, "rasterYSize" ) == NULL
@@ -850,7 +922,6 @@ GDALDataset *VRTDataset::OpenXML( const char *pszXML, const char *pszVRTPath,
         CPLError( CE_Failure, CPLE_AppDefined,
                   "Missing one of rasterXSize, rasterYSize or bands on"
                   " VRTDataset." );
-        CPLDestroyXMLNode( psTree );
         return NULL;
     }
 
@@ -863,12 +934,11 @@ GDALDataset *VRTDataset::OpenXML( const char *pszXML, const char *pszVRTPath,
     if ( !bIsPansharpened &&
          !GDALCheckDatasetDimensions( nXSize, nYSize ) )
     {
-        CPLDestroyXMLNode( psTree );
         return NULL;
     }
 
     VRTDataset *poDS;
-    if( strstr(pszXML,"VRTWarpedDataset") != NULL )
+    if( bIsWarped )
         poDS = new VRTWarpedDataset( nXSize, nYSize );
     else if( bIsPansharpened )
         poDS = new VRTPansharpenedDataset( nXSize, nYSize );
@@ -884,11 +954,6 @@ GDALDataset *VRTDataset::OpenXML( const char *pszXML, const char *pszVRTPath,
         poDS = NULL;
     }
 
-/* -------------------------------------------------------------------- */
-/*      Try to return a regular handle on the file.                     */
-/* -------------------------------------------------------------------- */
-    CPLDestroyXMLNode( psTree );
-
     return poDS;
 }
 
@@ -1276,6 +1341,11 @@ int VRTDataset::CheckCompatibleForDatasetIO()
                 if (!EQUAL(poSource->GetType(), "SimpleSource"))
                     return FALSE;
 
+                // Do not open all the sources of a lazily opened mosaic
+                // just for that.
+                if (nSources > 1 && poSource->IsPending())
+                    return FALSE;
+
                 GDALRasterBand *srcband = poSource->GetBand();
                 if (srcband == NULL)
                     return FALSE;
@@ -1452,14 +1522,23 @@ CPLErr VRTDataset::IRasterIO( GDALRWFlag eRWFlag,
             const double dfNoDataValue = poBand->GetNoDataValue(&bHasNoData);
             if( bHasNoData )
             {
-                for( int i = 0; i < poBand->nSources; i++ )
+                std::vector<int> anSources;
+                poBand->GetSourcesInWindow( nXOff, nYOff, nXSize, nYSize,
+                                            anSources );
+                for( size_t i = 0; i < anSources.size(); i++ )
                 {
                     VRTSimpleSource* poSource
                         = reinterpret_cast<VRTSimpleSource *>(
-                            poBand->papoSources[i] );
+                            poBand->papoSources[anSources[i]] );
+                    GDALRasterBand* poSrcBand = poSource->GetBand();
+                    if( poSrcBand == NULL )
+                    {
+                        bLocalCompatibleForDatasetIO = false;
+                        break;
+                    }
                     int bSrcHasNoData = FALSE;
                     const double dfSrcNoData
-                        = poSource->GetBand()->GetNoDataValue(&bSrcHasNoData);
+                        = poSrcBand->GetNoDataValue(&bSrcHasNoData);
                     if( !bSrcHasNoData || dfSrcNoData != dfNoDataValue )
                     {
                         bLocalCompatibleForDatasetIO = false;
@@ -1505,14 +1584,18 @@ CPLErr VRTDataset::IRasterIO( GDALRWFlag eRWFlag,
         // they don't necessary instantiate all underlying rasterbands.
         VRTSourcedRasterBand* poBand = reinterpret_cast<VRTSourcedRasterBand *>(
             papoBands[nBands - 1] );
-        for( int iSource = 0;
-             eErr == CE_None && iSource < poBand->nSources;
-             iSource++ )
+        std::vector<int> anSources;
+        poBand->GetSourcesInWindow( nXOff, nYOff, nXSize, nYSize, anSources );
+        const int nCandidates = static_cast<int>(anSources.size());
+        for( int iCandidate = 0;
+             eErr == CE_None && iCandidate < nCandidates;
+             iCandidate++ )
         {
+            const int iSource = anSources[iCandidate];
             psExtraArg->pfnProgress = GDALScaledProgress;
             psExtraArg->pProgressData =
-                GDALCreateScaledProgress( 1.0 * iSource / poBand->nSources,
-                                        1.0 * (iSource + 1) / poBand->nSources,
+                GDALCreateScaledProgress( 1.0 * iCandidate / nCandidates,
+                                        1.0 * (iCandidate + 1) / nCandidates,
                                         pfnProgressGlobal,
                                         pProgressDataGlobal );
 
@@ -32,6 +32,7 @@
 #define VIRTUALDATASET_H_INCLUDED
 
 #include "cpl_hash_set.h"
+#include "cpl_quad_tree.h"
 #include "gdal_pam.h"
 #include "gdal_priv.h"
 #include "gdal_vrt.h"
@@ -42,6 +43,12 @@
 int VRTApplyMetadata( CPLXMLNode *, GDALMajorObject * );
 CPLXMLNode *VRTSerializeMetadata( GDALMajorObject * );
 
+/* Binary encoding of the XML tree of a VRT (see vrtbinary.cpp) */
+int VRTIsBinaryTree( const GByte *pabyData, size_t nDataSize );
+GByte *VRTSerializeBinaryTree( const CPLXMLNode *psTree, size_t *pnSize );
+CPLXMLNode *VRTParseBinaryTree( const GByte *pabyData, size_t nDataSize );
+int VRTIsBinaryFilename( const char *pszFilename );
+
 #if 0
 int VRTWarpedOverviewTransform( void *pTransformArg, int bDstToSrc,
                                 int nPointCount,
@@ -208,6 +215,9 @@ class CPL_DLL VRTDataset : public GDALDataset
     static int          Identify( GDALOpenInfo * );
     static GDALDataset *Open( GDALOpenInfo * );
     static GDALDataset *OpenXML( const char *, const char * = NULL, GDALAccess eAccess = GA_ReadOnly );
+    static GDALDataset *OpenXMLTree( CPLXMLNode *psTree, const char *pszVRTPath,
+                                     GDALAccess eAccess,
+                                     bool bIsWarped, bool bIsPansharpened );
     static GDALDataset *Create( const char * pszName,
                                 int nXSize, int nYSize, int nBands,
                                 GDALDataType eType, char ** papszOptions );
@@ -456,10 +466,19 @@ class CPL_DLL VRTSourcedRasterBand : public VRTRasterBand
     CPLString      m_osLastLocationInfo;
     char         **m_papszSourceList;
 
+    CPLQuadTree   *m_hSourceIndex;
+    std::vector<VRTSource*> m_apoIndexedSources;
+    std::vector<double> m_adfIndexedDstWindows;
+    std::vector<int> m_anUnindexedSources;
+
     void           Initialize( int nXSize, int nYSize );
 
     int            CanUseSourcesMinMaxImplementations();
 
+    void           BuildSourceIndex();
+    int            IsSourceIndexUpToDate();
+    void           InvalidateSourceIndex();
+
   public:
     int            nSources;
     VRTSource    **papoSources;
@@ -540,6 +559,10 @@ class CPL_DLL VRTSourcedRasterBand : public VRTRasterBand
 
     virtual CPLErr IReadBlock( int, int, void * );
 
+    void           GetSourcesInWindow( int nXOff, int nYOff,
+                                       int nXSize, int nYSize,
+                                       std::vector<int>& anSources );
+
     virtual void   GetFileList(char*** ppapszFileList, int *pnSize,
                                int *pnMaxSize, CPLHashSet* hSetFiles);
 
@@ -602,12 +625,76 @@ class VRTPansharpenedRasterBand : public VRTRasterBand
     int                 GetIndexAsPansharpenedBand() const { return m_nIndexAsPansharpenedBand; }
 };
 
+/************************************************************************/
+/*                          VRTPixelExpression                          */
+/*                                                                      */
+/*      Expression of a derived band, compiled in a program that is     */
+/*      evaluated on whole buffers (see vrtexpression.cpp).             */
+/************************************************************************/
+
+class VRTPixelExpression
+{
+  public:
+    typedef enum
+    {
+        OP_CONST, OP_SOURCE,
+        OP_NEG, OP_NOT, OP_ABS, OP_SQRT, OP_EXP, OP_LOG, OP_LOG10,
+        OP_SIN, OP_COS, OP_TAN, OP_ASIN, OP_ACOS, OP_ATAN,
+        OP_FLOOR, OP_CEIL, OP_ISNAN,
+        OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW, OP_ATAN2, OP_MIN, OP_MAX,
+        OP_LT, OP_LE, OP_GT, OP_GE, OP_EQ, OP_NE, OP_AND, OP_OR,
+        OP_IF
+    } Opcode;
+
+    typedef struct
+    {
+        Opcode eOp;
+        double dfValue;     /* OP_CONST */
+        int    nSource;     /* OP_SOURCE, 0-based */
+    } Instruction;
+
+  private:
+    CPLString                 m_osExpression;
+    std::vector<Instruction>  m_aoProgram;
+    int                       m_nMaxStackDepth;
+    int                       m_nMaxSource;
+
+                              VRTPixelExpression();
+
+  public:
+    static VRTPixelExpression *Compile( const char *pszExpression );
+
+    const char *GetExpression() const { return m_osExpression.c_str(); }
+
+    /* Number of sources referenced, i.e. highest N of the BN variables */
+    int         GetSourceCount() const { return m_nMaxSource; }
+
+    void        Evaluate( const double * const *papadfSources,
+                          double *padfDst, size_t nValues ) const;
+};
+
+int VRTGetBuiltinPixelFunctionExpression( const char *pszFuncName,
+                                          int nSources,
+                                          CPLString &osExpression );
+
 /************************************************************************/
 /*                         VRTDerivedRasterBand                         */
 /************************************************************************/
 
 class CPL_DLL VRTDerivedRasterBand : public VRTSourcedRasterBand
 {
+    CPLString           m_osExpression;
+    VRTPixelExpression *m_poExpression;
+
+    VRTPixelExpression *GetCompiledExpression();
+    CPLErr              EvaluateExpression( VRTPixelExpression *poExpression,
+                                            int nXOff, int nYOff,
+                                            int nXSize, int nYSize,
+                                            void *pData,
+                                            int nBufXSize, int nBufYSize,
+                                            GDALDataType eBufType,
+                                            GSpacing nPixelSpace,
+                                            GSpacing nLineSpace );
 
  public:
     char *pszFuncName;
@@ -628,6 +715,7 @@ class CPL_DLL VRTDerivedRasterBand : public VRTSourcedRasterBand
     static GDALDerivedPixelFunc GetPixelFunction(const char *pszFuncName);
 
     void SetPixelFunctionName(const char *pszFuncName);
+    void SetPixelFunctionExpression(const char *pszExpression);
     void SetSourceTransferType(GDALDataType eDataType);
 
     virtual CPLErr         XMLInit( CPLXMLNode *, const char * );
@@ -733,6 +821,23 @@ protected:
     int                 m_bRelativeToVRTOri;
     CPLString           m_osSourceFileNameOri;
 
+    /* Description of the source dataset, kept until it is opened. With */
+    /* VRT_LAZY_SOURCE_OPENING, this happens on the first access. */
+    int                 m_bSrcDSPending;
+    CPLString           m_osSrcDSName;
+    int                 m_nSrcBand;
+    int                 m_bGetMaskBand;
+    int                 m_bSharedSrcDS;
+    char              **m_papszSrcOpenOptions;
+    int                 m_nSrcRasterXSize;
+    int                 m_nSrcRasterYSize;
+    GDALDataType        m_eSrcDataType;
+    int                 m_nSrcBlockXSize;
+    int                 m_nSrcBlockYSize;
+
+    CPLErr              OpenSourceDataset();
+    int                 OpenPendingSource();
+
     int                 NeedMaxValAdjustment() const;
 
 public:
@@ -748,6 +853,8 @@ public:
     void           SetSrcMaskBand( GDALRasterBand * );
     void           SetSrcWindow( double, double, double, double );
     void           SetDstWindow( double, double, double, double );
+    int            GetDstWindow( double *pdfDstXOff, double *pdfDstYOff,
+                                 double *pdfDstXSize, double *pdfDstYSize );
     void           SetNoDataValue( double dfNoDataValue );
     const CPLString& GetResampling() const { return m_osResampling; }
     void           SetResampling( const char* pszResampling );
@@ -790,6 +897,7 @@ public:
     virtual const char* GetType() { return "SimpleSource"; }
 
     GDALRasterBand* GetBand();
+    int             IsPending() const { return m_bSrcDSPending; }
     int             IsSameExceptBandNumber(VRTSimpleSource* poOtherSource);
     CPLErr          DatasetRasterIO(
                                int nXOff, int nYOff, int nXSize, int nYSize,
@@ -47,6 +47,7 @@ static std::map<CPLString, GDALDerivedPixelFunc> osMapPixelFunction;
 
 VRTDerivedRasterBand::VRTDerivedRasterBand(GDALDataset *poDSIn, int nBandIn) :
     VRTSourcedRasterBand( poDSIn, nBandIn ),
+    m_poExpression(NULL),
     pszFuncName(NULL),
     eSourceTransferType(GDT_Unknown)
 {}
@@ -59,6 +60,7 @@ VRTDerivedRasterBand::VRTDerivedRasterBand(GDALDataset *poDSIn, int nBandIn,
 					   GDALDataType eType,
 					   int nXSize, int nYSize) :
     VRTSourcedRasterBand(poDSIn, nBandIn, eType, nXSize, nYSize),
+    m_poExpression(NULL),
     pszFuncName(NULL),
     eSourceTransferType(GDT_Unknown)
 {}
@@ -71,6 +73,7 @@ VRTDerivedRasterBand::~VRTDerivedRasterBand()
 
 {
     CPLFree( pszFuncName );
+    delete m_poExpression;
 }
 
 /************************************************************************/
@@ -174,6 +177,33 @@ void VRTDerivedRasterBand::SetPixelFunctionName(const char *pszFuncNameIn)
     pszFuncName = CPLStrdup( pszFuncNameIn );
 }
 
+/************************************************************************/
+/*                      SetPixelFunctionExpression()                    */
+/************************************************************************/
+
+/**
+ * Set the expression that computes the pixels of this derived band from
+ * its sources, instead of a pixel function.
+ *
+ * The expression uses the B1, B2, ... variables for the values of the
+ * first, second, ... sources, numbers, the + - * / ^ arithmetic operators,
+ * the < <= > >= == != comparison operators and the && || ! logical
+ * operators (which evaluate to 1 or 0), and the abs, sqrt, exp, log, log10,
+ * sin, cos, tan, asin, acos, atan, floor, ceil, isnan, pow, atan2, min, max
+ * and if(condition, value_if_true, value_if_false) functions, for example
+ * "(B2 - B1) / (B2 + B1)". Computations are done on double precision values.
+ *
+ * @param pszExpression the expression, or NULL or an empty string to use
+ * the pixel function again.
+ *
+ * @since GDAL 2.2
+ */
+void VRTDerivedRasterBand::SetPixelFunctionExpression(
+    const char *pszExpression )
+{
+    m_osExpression = pszExpression ? pszExpression : "";
+}
+
 /************************************************************************/
 /*                         SetSourceTransferType()                      */
 /************************************************************************/
@@ -311,14 +341,19 @@ CPLErr VRTDerivedRasterBand::IRasterIO(GDALRWFlag eRWFlag,
     }
 
     /* ---- Get pixel function for band ---- */
-    GDALDerivedPixelFunc pfnPixelFunc
-        = VRTDerivedRasterBand::GetPixelFunction(this->pszFuncName);
+    GDALDerivedPixelFunc pfnPixelFunc = NULL;
+    if( m_osExpression.empty() )
+        pfnPixelFunc =
+            VRTDerivedRasterBand::GetPixelFunction(this->pszFuncName);
     if (pfnPixelFunc == NULL) {
-	CPLError( CE_Failure, CPLE_IllegalArg,
-		  "VRTDerivedRasterBand::IRasterIO:"
-		  "Derived band pixel function '%s' not registered.\n",
-		  this->pszFuncName);
-	return CE_Failure;
+        /* ---- Expression or built-in pixel function ---- */
+        VRTPixelExpression *poExpression = GetCompiledExpression();
+        if( poExpression == NULL )
+            return CE_Failure;
+        return EvaluateExpression( poExpression, nXOff, nYOff,
+                                   nXSize, nYSize, pData,
+                                   nBufXSize, nBufYSize, eBufType,
+                                   nPixelSpace, nLineSpace );
     }
 
     /* TODO: It would be nice to use a MallocBlock function for each
@@ -390,6 +425,149 @@ CPLErr VRTDerivedRasterBand::IRasterIO(GDALRWFlag eRWFlag,
     return eErr;
 }
 
+/************************************************************************/
+/*                        GetCompiledExpression()                       */
+/*                                                                      */
+/*      Compile, if not already done, the expression of the band or of  */
+/*      its built-in pixel function. Returns NULL, after emitting an    */
+/*      error, if there is none or it is invalid.                       */
+/************************************************************************/
+
+VRTPixelExpression *VRTDerivedRasterBand::GetCompiledExpression()
+{
+    CPLString osExpression( m_osExpression );
+    if( osExpression.empty() )
+    {
+        if( !VRTGetBuiltinPixelFunctionExpression( pszFuncName, nSources,
+                                                   osExpression ) )
+        {
+            CPLError( CE_Failure, CPLE_IllegalArg,
+                      "VRTDerivedRasterBand::IRasterIO:"
+                      "Derived band pixel function '%s' not registered.\n",
+                      this->pszFuncName);
+            return NULL;
+        }
+        if( osExpression.empty() )
+            return NULL;
+    }
+
+    if( m_poExpression != NULL &&
+        osExpression == m_poExpression->GetExpression() )
+        return m_poExpression;
+
+    delete m_poExpression;
+    m_poExpression = VRTPixelExpression::Compile( osExpression );
+    return m_poExpression;
+}
+
+/************************************************************************/
+/*                         EvaluateExpression()                         */
+/*                                                                      */
+/*      Read the sources as double values and compute the pixels       */
+/*      from them on whole buffers. If a nodata value is set, pixels    */
+/*      for which one of the sources is nodata are set to nodata.       */
+/************************************************************************/
+
+CPLErr VRTDerivedRasterBand::EvaluateExpression(
+    VRTPixelExpression *poExpression,
+    int nXOff, int nYOff, int nXSize, int nYSize, void *pData,
+    int nBufXSize, int nBufYSize, GDALDataType eBufType,
+    GSpacing nPixelSpace, GSpacing nLineSpace )
+{
+    const int nUsedSources = poExpression->GetSourceCount();
+    if( nUsedSources > nSources )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Expression '%s' uses B%d, but the band has only %d "
+                  "source(s).",
+                  poExpression->GetExpression(), nUsedSources, nSources );
+        return CE_Failure;
+    }
+
+    const size_t nValues = static_cast<size_t>(nBufXSize) * nBufYSize;
+    const double dfInitValue = m_bNoDataValueSet ? m_dfNoDataValue : 0.0;
+
+    /* ---- Load values for sources into packed double buffers ---- */
+    std::vector<double *> apadfSources( nUsedSources + 1, NULL );
+    double *padfResult = static_cast<double *>(
+        VSI_MALLOC2_VERBOSE( nValues, sizeof(double) ) );
+    CPLErr eErr = padfResult != NULL ? CE_None : CE_Failure;
+
+    GDALRasterIOExtraArg sExtraArg;
+    INIT_RASTERIO_EXTRA_ARG(sExtraArg);
+
+    for( int iSource = 0; iSource < nUsedSources && eErr == CE_None;
+         iSource++ )
+    {
+        apadfSources[iSource] = static_cast<double *>(
+            VSI_MALLOC2_VERBOSE( nValues, sizeof(double) ) );
+        if( apadfSources[iSource] == NULL )
+        {
+            eErr = CE_Failure;
+            break;
+        }
+        for( size_t i = 0; i < nValues; i++ )
+            apadfSources[iSource][i] = dfInitValue;
+
+        eErr = reinterpret_cast<VRTSource *>(
+            papoSources[iSource] )->RasterIO(
+                nXOff, nYOff, nXSize, nYSize,
+                apadfSources[iSource], nBufXSize, nBufYSize,
+                GDT_Float64, sizeof(double), sizeof(double) * nBufXSize,
+                &sExtraArg );
+    }
+
+    if( eErr == CE_None )
+    {
+        /* ---- Apply expression ---- */
+        poExpression->Evaluate( &apadfSources[0], padfResult, nValues );
+
+        /* ---- Propagate nodata ---- */
+        if( m_bNoDataValueSet )
+        {
+            const double dfNoData = m_dfNoDataValue;
+            const bool bNoDataIsNan = CPL_TO_BOOL(CPLIsNan(dfNoData));
+            for( int iSource = 0; iSource < nUsedSources; iSource++ )
+            {
+                const double *padfSource = apadfSources[iSource];
+                if( bNoDataIsNan )
+                {
+                    for( size_t i = 0; i < nValues; i++ )
+                    {
+                        if( CPLIsNan(padfSource[i]) )
+                            padfResult[i] = dfNoData;
+                    }
+                }
+                else
+                {
+                    for( size_t i = 0; i < nValues; i++ )
+                    {
+                        if( padfSource[i] == dfNoData )
+                            padfResult[i] = dfNoData;
+                    }
+                }
+            }
+        }
+
+        /* ---- Write the result into the output buffer ---- */
+        for( int iLine = 0; iLine < nBufYSize; iLine++ )
+        {
+            GDALCopyWords( padfResult + static_cast<size_t>(iLine) * nBufXSize,
+                           GDT_Float64, sizeof(double),
+                           static_cast<GByte *>( pData ) + nLineSpace * iLine,
+                           eBufType, static_cast<int>(nPixelSpace),
+                           nBufXSize );
+        }
+    }
+
+    /* ---- Release buffers ---- */
+    for( int iSource = 0; iSource < nUsedSources; iSource++ )
+        VSIFree( apadfSources[iSource] );
+    VSIFree( padfResult );
+
+    return eErr;
+}
+
 /************************************************************************/
 /*                              XMLInit()                               */
 /************************************************************************/
@@ -405,6 +583,12 @@ CPLErr VRTDerivedRasterBand::XMLInit( CPLXMLNode *psTree,
     /* ---- Read derived pixel function type ---- */
     SetPixelFunctionName( CPLGetXMLValue( psTree, "PixelFunctionType", NULL ) );
 
+    /* ---- Read and check the optional expression ---- */
+    SetPixelFunctionExpression(
+        CPLGetXMLValue( psTree, "PixelFunctionExpression", NULL ) );
+    if( !m_osExpression.empty() && GetCompiledExpression() == NULL )
+        return CE_Failure;
+
     /* ---- Read optional source transfer data type ---- */
     const char *pszTypeName = CPLGetXMLValue(psTree, "SourceTransferType", NULL);
     if (pszTypeName != NULL) {
@@ -432,6 +616,8 @@ CPLXMLNode *VRTDerivedRasterBand::SerializeToXML(const char *pszVRTPath)
     /* ---- Encode DerivedBand-specific fields ---- */
     if( pszFuncName != NULL && strlen(pszFuncName) > 0 )
         CPLSetXMLValue( psTree, "PixelFunctionType", pszFuncName );
+    if( !m_osExpression.empty() )
+        CPLSetXMLValue( psTree, "PixelFunctionExpression", m_osExpression );
     if( this->eSourceTransferType != GDT_Unknown)
         CPLSetXMLValue( psTree, "SourceTransferType",
 		        GDALGetDataTypeName( eSourceTransferType ) );
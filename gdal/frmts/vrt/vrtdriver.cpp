@@ -191,12 +191,43 @@ VRTCreateCopy( const char * pszFilename,
         CPLXMLNode *psDSTree = reinterpret_cast<VRTDataset *>(
             poSrcDS )->SerializeToXML( pszVRTPath );
 
+        CPLFree( pszVRTPath );
+
+    /* -------------------------------------------------------------------- */
+    /*      Write the binary encoding of the tree if asked for.             */
+    /* -------------------------------------------------------------------- */
+        if( VRTIsBinaryFilename( pszFilename ) )
+        {
+            size_t nSize = 0;
+            GByte *pabyContent = VRTSerializeBinaryTree( psDSTree, &nSize );
+            CPLDestroyXMLNode( psDSTree );
+            if( pabyContent == NULL )
+                return NULL;
+
+            VSILFILE *fpVRT = VSIFOpenL( pszFilename, "wb" );
+            if (fpVRT == NULL)
+            {
+                CPLError(CE_Failure, CPLE_AppDefined,
+                         "Cannot create %s", pszFilename);
+                CPLFree( pabyContent );
+                return NULL;
+            }
+
+            bool bRet = VSIFWriteL( pabyContent, nSize, 1, fpVRT ) > 0;
+            if( VSIFCloseL( fpVRT ) != 0 )
+                bRet = false;
+            CPLFree( pabyContent );
+
+            if( !bRet )
+                return NULL;
+            return reinterpret_cast<GDALDataset *>(
+                GDALOpen( pszFilename, GA_Update ) );
+        }
+
         char *pszXML = CPLSerializeXMLTree( psDSTree );
 
         CPLDestroyXMLNode( psDSTree );
 
-        CPLFree( pszVRTPath );
-
     /* -------------------------------------------------------------------- */
     /*      Write to disk.                                                  */
     /* -------------------------------------------------------------------- */
@@ -367,6 +398,7 @@ void GDALRegister_VRT()
     poDriver->SetMetadataItem( GDAL_DCAP_RASTER, "YES" );
     poDriver->SetMetadataItem( GDAL_DMD_LONGNAME, "Virtual Raster" );
     poDriver->SetMetadataItem( GDAL_DMD_EXTENSION, "vrt" );
+    poDriver->SetMetadataItem( GDAL_DMD_EXTENSIONS, "vrt vrtb" );
     poDriver->SetMetadataItem( GDAL_DMD_HELPTOPIC, "gdal_vrttut.html" );
     poDriver->SetMetadataItem( GDAL_DMD_CREATIONDATATYPES,
                                "Byte Int16 UInt16 Int32 UInt32 Float32 Float64 "
@@ -0,0 +1,866 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  Virtual GDAL Datasets
+ * Purpose:  Expressions and built-in pixel functions of derived bands.
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "vrtdataset.h"
+#include "cpl_string.h"
+
+#include <algorithm>
+#include <cmath>
+
+CPL_CVSID("$Id$");
+
+/*
+ * An expression is compiled once into a program for a stack machine, in
+ * postfix order. The program is not run pixel per pixel: each instruction is
+ * applied to a chunk of values before the next one, so the dispatch cost is
+ * paid once per chunk and the inner loops are simple enough to be vectorized
+ * by the compiler. Constant operands are kept as scalars and not expanded.
+ */
+
+/* Number of values processed by each instruction at once. Small enough for */
+/* the operand stack to stay in the L1 cache. */
+static const size_t VRT_EXPR_CHUNK_SIZE = 256;
+
+/* Protection against pathological expressions */
+static const int VRT_EXPR_MAX_DEPTH = 64;
+
+typedef struct
+{
+    const char                  *pszName;
+    VRTPixelExpression::Opcode   eOp;
+    int                          nArgs;
+} VRTExprFunction;
+
+static const VRTExprFunction asVRTExprFunctions[] =
+{
+    { "abs",   VRTPixelExpression::OP_ABS,   1 },
+    { "sqrt",  VRTPixelExpression::OP_SQRT,  1 },
+    { "exp",   VRTPixelExpression::OP_EXP,   1 },
+    { "log",   VRTPixelExpression::OP_LOG,   1 },
+    { "log10", VRTPixelExpression::OP_LOG10, 1 },
+    { "sin",   VRTPixelExpression::OP_SIN,   1 },
+    { "cos",   VRTPixelExpression::OP_COS,   1 },
+    { "tan",   VRTPixelExpression::OP_TAN,   1 },
+    { "asin",  VRTPixelExpression::OP_ASIN,  1 },
+    { "acos",  VRTPixelExpression::OP_ACOS,  1 },
+    { "atan",  VRTPixelExpression::OP_ATAN,  1 },
+    { "floor", VRTPixelExpression::OP_FLOOR, 1 },
+    { "ceil",  VRTPixelExpression::OP_CEIL,  1 },
+    { "isnan", VRTPixelExpression::OP_ISNAN, 1 },
+    { "pow",   VRTPixelExpression::OP_POW,   2 },
+    { "atan2", VRTPixelExpression::OP_ATAN2, 2 },
+    { "min",   VRTPixelExpression::OP_MIN,   2 },
+    { "max",   VRTPixelExpression::OP_MAX,   2 },
+    { "if",    VRTPixelExpression::OP_IF,    3 }
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                         VRTExpressionParser                          */
+/* ==================================================================== */
+/************************************************************************/
+
+/*
+ * Recursive descent parser, from the lowest to the highest precedence:
+ *
+ *   or      := and ( '||' and )*
+ *   and     := compare ( '&&' compare )*
+ *   compare := sum ( ( '<' | '<=' | '>' | '>=' | '==' | '!=' ) sum )*
+ *   sum     := product ( ( '+' | '-' ) product )*
+ *   product := unary ( ( '*' | '/' ) unary )*
+ *   unary   := ( '-' | '+' | '!' ) unary | power
+ *   power   := primary ( '^' unary )?
+ *   primary := number | 'B'n | function '(' or ( ',' or )* ')' | '(' or ')'
+ */
+
+class VRTExpressionParser
+{
+    const char                                *m_pszExpression;
+    const char                                *m_pszCur;
+    std::vector<VRTPixelExpression::Instruction> &m_aoProgram;
+    int                                        m_nDepth;
+    int                                        m_nMaxDepth;
+    int                                        m_nMaxSource;
+    int                                        m_nNesting;
+    bool                                       m_bError;
+
+    void        SkipSpaces();
+    bool        Accept( const char *pszToken );
+    void        Error( const char *pszMsg );
+    void        Emit( VRTPixelExpression::Opcode eOp, int nPopped,
+                      int nPushed, double dfValue = 0.0, int nSource = 0 );
+
+    void        ParseOr();
+    void        ParseAnd();
+    void        ParseCompare();
+    void        ParseSum();
+    void        ParseProduct();
+    void        ParseUnary();
+    void        ParsePower();
+    void        ParsePrimary();
+
+  public:
+    VRTExpressionParser( const char *pszExpression,
+                         std::vector<VRTPixelExpression::Instruction>& aoProgram ) :
+        m_pszExpression(pszExpression), m_pszCur(pszExpression),
+        m_aoProgram(aoProgram), m_nDepth(0), m_nMaxDepth(0), m_nMaxSource(0),
+        m_nNesting(0), m_bError(false) {}
+
+    bool        Parse();
+    int         GetMaxDepth() const { return m_nMaxDepth; }
+    int         GetMaxSource() const { return m_nMaxSource; }
+};
+
+/************************************************************************/
+/*                             SkipSpaces()                             */
+/************************************************************************/
+
+void VRTExpressionParser::SkipSpaces()
+{
+    while( *m_pszCur == ' ' || *m_pszCur == '\t' ||
+           *m_pszCur == '\n' || *m_pszCur == '\r' )
+        m_pszCur ++;
+}
+
+/************************************************************************/
+/*                               Accept()                               */
+/*                                                                      */
+/*      Consume pszToken if it is the next token.                       */
+/************************************************************************/
+
+bool VRTExpressionParser::Accept( const char *pszToken )
+{
+    SkipSpaces();
+    const size_t nLen = strlen(pszToken);
+    if( strncmp( m_pszCur, pszToken, nLen ) != 0 )
+        return false;
+    // Do not take the beginning of '<=', '>=' or '!=' for '<', '>' or '!'.
+    if( nLen == 1 && strchr( "<>!", pszToken[0] ) != NULL &&
+        m_pszCur[1] == '=' )
+        return false;
+    m_pszCur += nLen;
+    return true;
+}
+
+/************************************************************************/
+/*                               Error()                                */
+/************************************************************************/
+
+void VRTExpressionParser::Error( const char *pszMsg )
+{
+    if( m_bError )
+        return;
+    m_bError = true;
+    CPLError( CE_Failure, CPLE_AppDefined,
+              "Invalid pixel function expression '%s': %s at offset %d.",
+              m_pszExpression, pszMsg,
+              static_cast<int>(m_pszCur - m_pszExpression) );
+}
+
+/************************************************************************/
+/*                                Emit()                                */
+/************************************************************************/
+
+void VRTExpressionParser::Emit( VRTPixelExpression::Opcode eOp,
+                                int nPopped, int nPushed,
+                                double dfValue, int nSource )
+{
+    if( m_bError )
+        return;
+
+    VRTPixelExpression::Instruction sInstr;
+    sInstr.eOp = eOp;
+    sInstr.dfValue = dfValue;
+    sInstr.nSource = nSource;
+    m_aoProgram.push_back( sInstr );
+
+    m_nDepth += nPushed - nPopped;
+    if( m_nDepth > m_nMaxDepth )
+        m_nMaxDepth = m_nDepth;
+    if( m_nMaxDepth > VRT_EXPR_MAX_DEPTH )
+        Error( "too complex expression" );
+}
+
+/************************************************************************/
+/*                                Parse()                               */
+/************************************************************************/
+
+bool VRTExpressionParser::Parse()
+{
+    ParseOr();
+    SkipSpaces();
+    if( !m_bError && *m_pszCur != '\0' )
+        Error( "unexpected character" );
+    return !m_bError;
+}
+
+/************************************************************************/
+/*                              ParseOr()                               */
+/************************************************************************/
+
+void VRTExpressionParser::ParseOr()
+{
+    ParseAnd();
+    while( !m_bError && Accept("||") )
+    {
+        ParseAnd();
+        Emit( VRTPixelExpression::OP_OR, 2, 1 );
+    }
+}
+
+/************************************************************************/
+/*                              ParseAnd()                              */
+/************************************************************************/
+
+void VRTExpressionParser::ParseAnd()
+{
+    ParseCompare();
+    while( !m_bError && Accept("&&") )
+    {
+        ParseCompare();
+        Emit( VRTPixelExpression::OP_AND, 2, 1 );
+    }
+}
+
+/************************************************************************/
+/*                            ParseCompare()                            */
+/************************************************************************/
+
+void VRTExpressionParser::ParseCompare()
+{
+    ParseSum();
+    while( !m_bError )
+    {
+        VRTPixelExpression::Opcode eOp;
+        if( Accept("<=") )
+            eOp = VRTPixelExpression::OP_LE;
+        else if( Accept(">=") )
+            eOp = VRTPixelExpression::OP_GE;
+        else if( Accept("==") )
+            eOp = VRTPixelExpression::OP_EQ;
+        else if( Accept("!=") )
+            eOp = VRTPixelExpression::OP_NE;
+        else if( Accept("<") )
+            eOp = VRTPixelExpression::OP_LT;
+        else if( Accept(">") )
+            eOp = VRTPixelExpression::OP_GT;
+        else
+            break;
+        ParseSum();
+        Emit( eOp, 2, 1 );
+    }
+}
+
+/************************************************************************/
+/*                              ParseSum()                              */
+/************************************************************************/
+
+void VRTExpressionParser::ParseSum()
+{
+    ParseProduct();
+    while( !m_bError )
+    {
+        VRTPixelExpression::Opcode eOp;
+        if( Accept("+") )
+            eOp = VRTPixelExpression::OP_ADD;
+        else if( Accept("-") )
+            eOp = VRTPixelExpression::OP_SUB;
+        else
+            break;
+        ParseProduct();
+        Emit( eOp, 2, 1 );
+    }
+}
+
+/************************************************************************/
+/*                            ParseProduct()                            */
+/************************************************************************/
+
+void VRTExpressionParser::ParseProduct()
+{
+    ParseUnary();
+    while( !m_bError )
+    {
+        VRTPixelExpression::Opcode eOp;
+        if( Accept("*") )
+            eOp = VRTPixelExpression::OP_MUL;
+        else if( Accept("/") )
+            eOp = VRTPixelExpression::OP_DIV;
+        else
+            break;
+        ParseUnary();
+        Emit( eOp, 2, 1 );
+    }
+}
+
+/************************************************************************/
+/*                             ParseUnary()                             */
+/************************************************************************/
+
+void VRTExpressionParser::ParseUnary()
+{
+    if( ++m_nNesting > VRT_EXPR_MAX_DEPTH )
+    {
+        Error( "too deeply nested expression" );
+        return;
+    }
+
+    if( Accept("-") )
+    {
+        ParseUnary();
+        Emit( VRTPixelExpression::OP_NEG, 1, 1 );
+    }
+    else if( Accept("+") )
+    {
+        ParseUnary();
+    }
+    else if( Accept("!") )
+    {
+        ParseUnary();
+        Emit( VRTPixelExpression::OP_NOT, 1, 1 );
+    }
+    else
+    {
+        ParsePower();
+    }
+
+    m_nNesting --;
+}
+
+/************************************************************************/
+/*                             ParsePower()                             */
+/************************************************************************/
+
+void VRTExpressionParser::ParsePower()
+{
+    ParsePrimary();
+    if( !m_bError && Accept("^") )
+    {
+        // Right associative: 2^3^2 = 2^(3^2)
+        ParseUnary();
+        Emit( VRTPixelExpression::OP_POW, 2, 1 );
+    }
+}
+
+/************************************************************************/
+/*                            ParsePrimary()                            */
+/************************************************************************/
+
+void VRTExpressionParser::ParsePrimary()
+{
+    if( m_bError )
+        return;
+
+    SkipSpaces();
+
+/* -------------------------------------------------------------------- */
+/*      Parenthesized expression.                                       */
+/* -------------------------------------------------------------------- */
+    if( Accept("(") )
+    {
+        ParseOr();
+        if( !m_bError && !Accept(")") )
+            Error( "')' expected" );
+        return;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Number.                                                         */
+/* -------------------------------------------------------------------- */
+    if( (*m_pszCur >= '0' && *m_pszCur <= '9') || *m_pszCur == '.' )
+    {
+        char *pszEnd = NULL;
+        const double dfValue = CPLStrtod( m_pszCur, &pszEnd );
+        if( pszEnd == m_pszCur )
+        {
+            Error( "invalid number" );
+            return;
+        }
+        m_pszCur = pszEnd;
+        Emit( VRTPixelExpression::OP_CONST, 0, 1, dfValue );
+        return;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Identifier: source or function.                                 */
+/* -------------------------------------------------------------------- */
+    const char *pszStart = m_pszCur;
+    while( (*m_pszCur >= 'a' && *m_pszCur <= 'z') ||
+           (*m_pszCur >= 'A' && *m_pszCur <= 'Z') ||
+           (*m_pszCur >= '0' && *m_pszCur <= '9') || *m_pszCur == '_' )
+        m_pszCur ++;
+    const CPLString osName( std::string( pszStart, m_pszCur - pszStart ) );
+    if( osName.empty() )
+    {
+        Error( "operand expected" );
+        return;
+    }
+
+    if( (osName[0] == 'B' || osName[0] == 'b') && osName.size() > 1 &&
+        osName.find_first_not_of( "0123456789", 1 ) == std::string::npos )
+    {
+        const int nSource = atoi( osName.c_str() + 1 );
+        if( nSource < 1 || osName.size() > 6 )
+        {
+            Error( "invalid source number" );
+            return;
+        }
+        if( nSource > m_nMaxSource )
+            m_nMaxSource = nSource;
+        Emit( VRTPixelExpression::OP_SOURCE, 0, 1, 0.0, nSource - 1 );
+        return;
+    }
+
+    const VRTExprFunction *psFunc = NULL;
+    for( size_t i = 0; i < CPL_ARRAYSIZE(asVRTExprFunctions); i++ )
+    {
+        if( EQUAL( osName, asVRTExprFunctions[i].pszName ) )
+            psFunc = asVRTExprFunctions + i;
+    }
+    if( psFunc == NULL )
+    {
+        Error( CPLSPrintf( "unknown identifier '%s'", osName.c_str() ) );
+        return;
+    }
+
+    if( !Accept("(") )
+    {
+        Error( "'(' expected" );
+        return;
+    }
+    for( int iArg = 0; iArg < psFunc->nArgs && !m_bError; iArg++ )
+    {
+        if( iArg > 0 && !Accept(",") )
+        {
+            Error( CPLSPrintf( "%s() expects %d arguments",
+                               psFunc->pszName, psFunc->nArgs ) );
+            return;
+        }
+        ParseOr();
+    }
+    if( !m_bError && !Accept(")") )
+    {
+        Error( CPLSPrintf( "%s() expects %d arguments",
+                           psFunc->pszName, psFunc->nArgs ) );
+        return;
+    }
+    Emit( psFunc->eOp, psFunc->nArgs, 1 );
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                          VRTPixelExpression                          */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                         VRTPixelExpression()                         */
+/************************************************************************/
+
+VRTPixelExpression::VRTPixelExpression() :
+    m_nMaxStackDepth(0),
+    m_nMaxSource(0)
+{}
+
+/************************************************************************/
+/*                              Compile()                               */
+/*                                                                      */
+/*      Returns NULL, after emitting an error, if the expression is     */
+/*      invalid.                                                        */
+/************************************************************************/
+
+VRTPixelExpression *VRTPixelExpression::Compile( const char *pszExpression )
+
+{
+    VRTPixelExpression *poExpr = new VRTPixelExpression();
+    poExpr->m_osExpression = pszExpression;
+
+    VRTExpressionParser oParser( pszExpression, poExpr->m_aoProgram );
+    if( !oParser.Parse() )
+    {
+        delete poExpr;
+        return NULL;
+    }
+
+    poExpr->m_nMaxStackDepth = oParser.GetMaxDepth();
+    poExpr->m_nMaxSource = oParser.GetMaxSource();
+
+    return poExpr;
+}
+
+/************************************************************************/
+/*                          Operand and kernels                         */
+/************************************************************************/
+
+namespace {
+
+/* An entry of the operand stack: a chunk of values, or a scalar */
+typedef struct
+{
+    const double *padfValues;
+    double        dfScalar;
+    bool          bIsScalar;
+} VRTExprOperand;
+
+inline double GetValue( const VRTExprOperand& sOp, size_t i )
+{
+    return sOp.bIsScalar ? sOp.dfScalar : sOp.padfValues[i];
+}
+
+struct NegOp   { static double Do( double a ) { return -a; } };
+struct NotOp   { static double Do( double a ) { return a == 0.0 ? 1.0 : 0.0; } };
+struct AbsOp   { static double Do( double a ) { return fabs(a); } };
+struct SqrtOp  { static double Do( double a ) { return sqrt(a); } };
+struct ExpOp   { static double Do( double a ) { return exp(a); } };
+struct LogOp   { static double Do( double a ) { return log(a); } };
+struct Log10Op { static double Do( double a ) { return log10(a); } };
+struct SinOp   { static double Do( double a ) { return sin(a); } };
+struct CosOp   { static double Do( double a ) { return cos(a); } };
+struct TanOp   { static double Do( double a ) { return tan(a); } };
+struct AsinOp  { static double Do( double a ) { return asin(a); } };
+struct AcosOp  { static double Do( double a ) { return acos(a); } };
+struct AtanOp  { static double Do( double a ) { return atan(a); } };
+struct FloorOp { static double Do( double a ) { return floor(a); } };
+struct CeilOp  { static double Do( double a ) { return ceil(a); } };
+struct IsNanOp { static double Do( double a ) { return CPLIsNan(a) ? 1.0 : 0.0; } };
+
+struct AddOp   { static double Do( double a, double b ) { return a + b; } };
+struct SubOp   { static double Do( double a, double b ) { return a - b; } };
+struct MulOp   { static double Do( double a, double b ) { return a * b; } };
+struct DivOp   { static double Do( double a, double b ) { return a / b; } };
+struct PowOp   { static double Do( double a, double b ) { return pow(a, b); } };
+struct Atan2Op { static double Do( double a, double b ) { return atan2(a, b); } };
+struct MinOp   { static double Do( double a, double b ) { return b < a ? b : a; } };
+struct MaxOp   { static double Do( double a, double b ) { return b > a ? b : a; } };
+struct LtOp    { static double Do( double a, double b ) { return a < b ? 1.0 : 0.0; } };
+struct LeOp    { static double Do( double a, double b ) { return a <= b ? 1.0 : 0.0; } };
+struct GtOp    { static double Do( double a, double b ) { return a > b ? 1.0 : 0.0; } };
+struct GeOp    { static double Do( double a, double b ) { return a >= b ? 1.0 : 0.0; } };
+struct EqOp    { static double Do( double a, double b ) { return a == b ? 1.0 : 0.0; } };
+struct NeOp    { static double Do( double a, double b ) { return a != b ? 1.0 : 0.0; } };
+struct AndOp   { static double Do( double a, double b ) { return (a != 0.0 && b != 0.0) ? 1.0 : 0.0; } };
+struct OrOp    { static double Do( double a, double b ) { return (a != 0.0 || b != 0.0) ? 1.0 : 0.0; } };
+
+/************************************************************************/
+/*                              ApplyUnary()                            */
+/************************************************************************/
+
+template<class Op> void ApplyUnary( VRTExprOperand& sA, double *padfOut,
+                                    size_t nValues )
+{
+    if( sA.bIsScalar )
+    {
+        sA.dfScalar = Op::Do( sA.dfScalar );
+        return;
+    }
+
+    const double *padfA = sA.padfValues;
+    for( size_t i = 0; i < nValues; i++ )
+        padfOut[i] = Op::Do( padfA[i] );
+    sA.padfValues = padfOut;
+}
+
+/************************************************************************/
+/*                             ApplyBinary()                            */
+/*                                                                      */
+/*      The result replaces sA.                                         */
+/************************************************************************/
+
+template<class Op> void ApplyBinary( VRTExprOperand& sA,
+                                     const VRTExprOperand& sB,
+                                     double *padfOut, size_t nValues )
+{
+    if( sA.bIsScalar && sB.bIsScalar )
+    {
+        sA.dfScalar = Op::Do( sA.dfScalar, sB.dfScalar );
+        return;
+    }
+
+    if( sA.bIsScalar )
+    {
+        const double dfA = sA.dfScalar;
+        const double *padfB = sB.padfValues;
+        for( size_t i = 0; i < nValues; i++ )
+            padfOut[i] = Op::Do( dfA, padfB[i] );
+    }
+    else if( sB.bIsScalar )
+    {
+        const double *padfA = sA.padfValues;
+        const double dfB = sB.dfScalar;
+        for( size_t i = 0; i < nValues; i++ )
+            padfOut[i] = Op::Do( padfA[i], dfB );
+    }
+    else
+    {
+        const double *padfA = sA.padfValues;
+        const double *padfB = sB.padfValues;
+        for( size_t i = 0; i < nValues; i++ )
+            padfOut[i] = Op::Do( padfA[i], padfB[i] );
+    }
+    sA.padfValues = padfOut;
+    sA.bIsScalar = false;
+}
+
+} // namespace
+
+/************************************************************************/
+/*                              Evaluate()                              */
+/*                                                                      */
+/*      Compute nValues values of the expression, the N-th source       */
+/*      being papadfSources[N-1]. papadfSources must have at least      */
+/*      GetSourceCount() entries.                                       */
+/************************************************************************/
+
+void VRTPixelExpression::Evaluate( const double * const *papadfSources,
+                                   double *padfDst, size_t nValues ) const
+
+{
+    const int nDepth = std::max( 1, m_nMaxStackDepth );
+    std::vector<VRTExprOperand> asStack( nDepth );
+    // The bottom of the stack is computed directly in the output buffer.
+    std::vector<double> adfScratch( (nDepth - 1) * VRT_EXPR_CHUNK_SIZE + 1 );
+
+    for( size_t nOffset = 0; nOffset < nValues;
+         nOffset += VRT_EXPR_CHUNK_SIZE )
+    {
+        const size_t nCount =
+            std::min( VRT_EXPR_CHUNK_SIZE, nValues - nOffset );
+        double * const padfChunkDst = padfDst + nOffset;
+        int iTop = -1;
+
+        for( size_t iInstr = 0; iInstr < m_aoProgram.size(); iInstr++ )
+        {
+            const Instruction& sInstr = m_aoProgram[iInstr];
+
+            // Output buffer of the entry that will hold the result.
+            int iOut = iTop;
+            switch( sInstr.eOp )
+            {
+                case OP_CONST: case OP_SOURCE: iOut = iTop + 1; break;
+                case OP_IF: iOut = iTop - 2; break;
+                default:
+                    if( sInstr.eOp >= OP_ADD )
+                        iOut = iTop - 1;
+                    break;
+            }
+            double * const padfOut = iOut == 0 ? padfChunkDst :
+                &adfScratch[(iOut - 1) * VRT_EXPR_CHUNK_SIZE];
+
+            switch( sInstr.eOp )
+            {
+                case OP_CONST:
+                    iTop ++;
+                    asStack[iTop].bIsScalar = true;
+                    asStack[iTop].dfScalar = sInstr.dfValue;
+                    asStack[iTop].padfValues = NULL;
+                    break;
+
+                case OP_SOURCE:
+                    iTop ++;
+                    asStack[iTop].bIsScalar = false;
+                    asStack[iTop].padfValues =
+                        papadfSources[sInstr.nSource] + nOffset;
+                    break;
+
+#define UNARY_CASE(op, cls) \
+                case op: \
+                    ApplyUnary<cls>( asStack[iTop], padfOut, nCount ); \
+                    break;
+
+                UNARY_CASE(OP_NEG, NegOp)
+                UNARY_CASE(OP_NOT, NotOp)
+                UNARY_CASE(OP_ABS, AbsOp)
+                UNARY_CASE(OP_SQRT, SqrtOp)
+                UNARY_CASE(OP_EXP, ExpOp)
+                UNARY_CASE(OP_LOG, LogOp)
+                UNARY_CASE(OP_LOG10, Log10Op)
+                UNARY_CASE(OP_SIN, SinOp)
+                UNARY_CASE(OP_COS, CosOp)
+                UNARY_CASE(OP_TAN, TanOp)
+                UNARY_CASE(OP_ASIN, AsinOp)
+                UNARY_CASE(OP_ACOS, AcosOp)
+                UNARY_CASE(OP_ATAN, AtanOp)
+                UNARY_CASE(OP_FLOOR, FloorOp)
+                UNARY_CASE(OP_CEIL, CeilOp)
+                UNARY_CASE(OP_ISNAN, IsNanOp)
+#undef UNARY_CASE
+
+#define BINARY_CASE(op, cls) \
+                case op: \
+                    iTop --; \
+                    ApplyBinary<cls>( asStack[iTop], asStack[iTop+1], \
+                                      padfOut, nCount ); \
+                    break;
+
+                BINARY_CASE(OP_ADD, AddOp)
+                BINARY_CASE(OP_SUB, SubOp)
+                BINARY_CASE(OP_MUL, MulOp)
+                BINARY_CASE(OP_DIV, DivOp)
+                BINARY_CASE(OP_POW, PowOp)
+                BINARY_CASE(OP_ATAN2, Atan2Op)
+                BINARY_CASE(OP_MIN, MinOp)
+                BINARY_CASE(OP_MAX, MaxOp)
+                BINARY_CASE(OP_LT, LtOp)
+                BINARY_CASE(OP_LE, LeOp)
+                BINARY_CASE(OP_GT, GtOp)
+                BINARY_CASE(OP_GE, GeOp)
+                BINARY_CASE(OP_EQ, EqOp)
+                BINARY_CASE(OP_NE, NeOp)
+                BINARY_CASE(OP_AND, AndOp)
+                BINARY_CASE(OP_OR, OrOp)
+#undef BINARY_CASE
+
+                case OP_IF:
+                {
+                    iTop -= 2;
+                    VRTExprOperand& sCond = asStack[iTop];
+                    const VRTExprOperand& sThen = asStack[iTop + 1];
+                    const VRTExprOperand& sElse = asStack[iTop + 2];
+                    if( sCond.bIsScalar )
+                    {
+                        // The chosen operand may live in a buffer of an
+                        // upper entry of the stack, which is reused by the
+                        // next instructions: copy it in the buffer of this
+                        // entry.
+                        const VRTExprOperand& sChosen =
+                            sCond.dfScalar != 0.0 ? sThen : sElse;
+                        if( sChosen.bIsScalar )
+                            sCond.dfScalar = sChosen.dfScalar;
+                        else
+                        {
+                            memcpy( padfOut, sChosen.padfValues,
+                                    nCount * sizeof(double) );
+                            sCond.padfValues = padfOut;
+                            sCond.bIsScalar = false;
+                        }
+                    }
+                    else
+                    {
+                        const double *padfCond = sCond.padfValues;
+                        for( size_t i = 0; i < nCount; i++ )
+                            padfOut[i] = padfCond[i] != 0.0 ?
+                                GetValue( sThen, i ) : GetValue( sElse, i );
+                        sCond.padfValues = padfOut;
+                    }
+                    break;
+                }
+            }
+        }
+
+        const VRTExprOperand& sResult = asStack[0];
+        if( sResult.bIsScalar )
+        {
+            for( size_t i = 0; i < nCount; i++ )
+                padfChunkDst[i] = sResult.dfScalar;
+        }
+        else if( sResult.padfValues != padfChunkDst )
+        {
+            memcpy( padfChunkDst, sResult.padfValues,
+                    nCount * sizeof(double) );
+        }
+    }
+}
+
+/************************************************************************/
+/*                VRTGetBuiltinPixelFunctionExpression()                */
+/*                                                                      */
+/*      Built-in pixel functions are defined as expressions of the      */
+/*      sources. Returns FALSE if pszFuncName is not a built-in         */
+/*      function, and TRUE otherwise, osExpression being left empty,    */
+/*      after emitting an error, if the number of sources does not      */
+/*      suit the function.                                              */
+/************************************************************************/
+
+typedef struct
+{
+    const char *pszName;
+    const char *pszExpression;  /* NULL for the n-ary ones */
+    const char *pszOperator;    /* for the n-ary ones */
+    int         nSources;       /* 0 for the n-ary ones */
+} VRTBuiltinPixelFunction;
+
+static const VRTBuiltinPixelFunction asVRTBuiltinPixelFunctions[] =
+{
+    { "real",      "B1",             NULL, 1 },
+    { "mod",       "abs(B1)",        NULL, 1 },
+    { "intensity", "B1*B1",          NULL, 1 },
+    { "sum",       NULL,             "+",  0 },
+    { "mul",       NULL,             "*",  0 },
+    { "diff",      "B1-B2",          NULL, 2 },
+    { "div",       "B1/B2",          NULL, 2 },
+    { "inv",       "1/B1",           NULL, 1 },
+    { "sqrt",      "sqrt(B1)",       NULL, 1 },
+    { "log10",     "log10(B1)",      NULL, 1 },
+    { "dB2amp",    "10^(B1/20)",     NULL, 1 },
+    { "dB2pow",    "10^(B1/10)",     NULL, 1 }
+};
+
+int VRTGetBuiltinPixelFunctionExpression( const char *pszFuncName,
+                                          int nSources,
+                                          CPLString &osExpression )
+
+{
+    osExpression.clear();
+    if( pszFuncName == NULL )
+        return FALSE;
+
+    for( size_t i = 0; i < CPL_ARRAYSIZE(asVRTBuiltinPixelFunctions); i++ )
+    {
+        const VRTBuiltinPixelFunction &sFunc = asVRTBuiltinPixelFunctions[i];
+        if( !EQUAL( pszFuncName, sFunc.pszName ) )
+            continue;
+
+        if( sFunc.pszExpression != NULL )
+        {
+            if( nSources != sFunc.nSources )
+            {
+                CPLError( CE_Failure, CPLE_AppDefined,
+                          "Pixel function '%s' requires %d source(s), "
+                          "got %d.", sFunc.pszName, sFunc.nSources,
+                          nSources );
+                return TRUE;
+            }
+            osExpression = sFunc.pszExpression;
+            return TRUE;
+        }
+
+        if( nSources < 1 )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Pixel function '%s' requires at least one source.",
+                      sFunc.pszName );
+            return TRUE;
+        }
+        osExpression = "B1";
+        for( int iSource = 2; iSource <= nSources; iSource++ )
+            osExpression += CPLSPrintf( "%sB%d", sFunc.pszOperator, iSource );
+        return TRUE;
+    }
+
+    return FALSE;
+}
@@ -128,6 +128,9 @@ VRTFilteredSource::RasterIO( int nXOff, int nYOff, int nXSize, int nYSize,
                                            eBufType, nPixelSpace, nLineSpace, psExtraArg );
     }
 
+    if( !OpenPendingSource() )
+        return CE_Failure;
+
     // The window we will actually request from the source raster band.
     double dfReqXOff, dfReqYOff, dfReqXSize, dfReqYSize;
     int nReqXOff, nReqYOff, nReqXSize, nReqYSize;
@@ -32,8 +32,14 @@
 #include "cpl_minixml.h"
 #include "cpl_string.h"
 
+#include <algorithm>
+
 CPL_CVSID("$Id$");
 
+/* Below this number of sources, looping over all of them is cheap enough */
+/* and no spatial index is built */
+static const int VRT_MIN_SOURCES_FOR_INDEX = 64;
+
 /************************************************************************/
 /* ==================================================================== */
 /*                          VRTSourcedRasterBand                        */
@@ -97,6 +103,7 @@ void VRTSourcedRasterBand::Initialize( int nXSize, int nYSize )
     bEqualAreas = FALSE;
     m_nRecursionCounter = 0;
     m_papszSourceList = NULL;
+    m_hSourceIndex = NULL;
 }
 
 /************************************************************************/
@@ -107,6 +114,7 @@ VRTSourcedRasterBand::~VRTSourcedRasterBand()
 
 {
     CloseDependentDatasets();
+    InvalidateSourceIndex();
     CSLDestroy(m_papszSourceList);
 }
 
@@ -163,8 +171,11 @@ CPLErr VRTSourcedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
         psExtraArg->eResampleAlg != GRIORA_NearestNeighbour &&
         m_bNoDataValueSet )
     {
-        for( int i = 0; i < nSources; i++ )
+        std::vector<int> anSources;
+        GetSourcesInWindow( nXOff, nYOff, nXSize, nYSize, anSources );
+        for( size_t iCandidate = 0; iCandidate < anSources.size(); iCandidate++ )
         {
+            const int i = anSources[iCandidate];
             bool bFallbackToBase = false;
             if( !papoSources[i]->IsSimpleSource() )
             {
@@ -198,9 +209,10 @@ CPLErr VRTSourcedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
                 {
                     continue;
                 }
+                GDALRasterBand* poSrcBand = poSource->GetBand();
                 int bSrcHasNoData = FALSE;
-                const double dfSrcNoData =
-                    poSource->GetBand()->GetNoDataValue(&bSrcHasNoData);
+                const double dfSrcNoData = poSrcBand != NULL ?
+                    poSrcBand->GetNoDataValue(&bSrcHasNoData) : 0.0;
                 if( !bSrcHasNoData || dfSrcNoData != m_dfNoDataValue )
                     bFallbackToBase = true;
             }
@@ -262,13 +274,19 @@ CPLErr VRTSourcedRasterBand::IRasterIO( GDALRWFlag eRWFlag,
 /* -------------------------------------------------------------------- */
 /*      Overlay each source in turn over top this.                      */
 /* -------------------------------------------------------------------- */
+    std::vector<int> anSources;
+    GetSourcesInWindow( nXOff, nYOff, nXSize, nYSize, anSources );
+    const int nCandidates = static_cast<int>(anSources.size());
+
     CPLErr eErr = CE_None;
-    for( int iSource = 0; eErr == CE_None && iSource < nSources; iSource++ )
+    for( int iCandidate = 0; eErr == CE_None && iCandidate < nCandidates;
+         iCandidate++ )
     {
+        const int iSource = anSources[iCandidate];
         psExtraArg->pfnProgress = GDALScaledProgress;
         psExtraArg->pProgressData =
-                GDALCreateScaledProgress( 1.0 * iSource / nSources,
-                                        1.0 * (iSource + 1) / nSources,
+                GDALCreateScaledProgress( 1.0 * iCandidate / nCandidates,
+                                        1.0 * (iCandidate + 1) / nCandidates,
                                         pfnProgressGlobal,
                                         pProgressDataGlobal );
         if( psExtraArg->pProgressData == NULL )
@@ -324,6 +342,193 @@ CPLErr VRTSourcedRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
 }
 
 
+/************************************************************************/
+/*                         GetSourcesInWindow()                         */
+/************************************************************************/
+
+/**
+ * Return the indices, in increasing order, of the sources that may
+ * contribute to a window of the band.
+ *
+ * Sources that cannot contribute to the window may still be returned, but
+ * not the other way round, so that callers can still rely on
+ * VRTSimpleSource::GetSrcDstWindow(). With many sources, a spatial index
+ * over their destination windows is used, so that the cost does not grow
+ * linearly with the number of sources. The index is rebuilt when a source
+ * is added, removed or replaced, or when its destination window changes.
+ *
+ * @since GDAL 2.2
+ */
+
+void VRTSourcedRasterBand::GetSourcesInWindow( int nXOff, int nYOff,
+                                               int nXSize, int nYSize,
+                                               std::vector<int>& anSources )
+{
+    anSources.clear();
+
+    if( nSources < VRT_MIN_SOURCES_FOR_INDEX )
+    {
+        for( int iSource = 0; iSource < nSources; iSource++ )
+            anSources.push_back(iSource);
+        return;
+    }
+
+    if( !IsSourceIndexUpToDate() )
+        BuildSourceIndex();
+
+    CPLRectObj sAoi;
+    sAoi.minx = nXOff;
+    sAoi.miny = nYOff;
+    sAoi.maxx = static_cast<double>(nXOff) + nXSize;
+    sAoi.maxy = static_cast<double>(nYOff) + nYSize;
+
+    int nFeatureCount = 0;
+    void** pahFeatures = CPLQuadTreeSearch(m_hSourceIndex, &sAoi,
+                                           &nFeatureCount);
+
+    anSources = m_anUnindexedSources;
+    for( int i = 0; i < nFeatureCount; i++ )
+        anSources.push_back(static_cast<int>((size_t)pahFeatures[i]));
+    CPLFree(pahFeatures);
+
+    std::sort(anSources.begin(), anSources.end());
+}
+
+/************************************************************************/
+/*                       GetSourceDstWindow()                           */
+/************************************************************************/
+
+/* Fetch the destination window of a source as recorded by the index.   */
+/* Sources that are not simple sources get an empty window.             */
+
+static int GetSourceDstWindow( VRTSource* poSource, double* padfDstWindow )
+{
+    padfDstWindow[0] = 0.0;
+    padfDstWindow[1] = 0.0;
+    padfDstWindow[2] = 0.0;
+    padfDstWindow[3] = 0.0;
+    if( !poSource->IsSimpleSource() )
+        return FALSE;
+    return reinterpret_cast<VRTSimpleSource *>( poSource )->GetDstWindow(
+        &padfDstWindow[0], &padfDstWindow[1],
+        &padfDstWindow[2], &padfDstWindow[3]);
+}
+
+/************************************************************************/
+/*                        IsSourceIndexUpToDate()                       */
+/************************************************************************/
+
+/* papoSources and the sources themselves are reachable from outside    */
+/* the band (VRTSimpleSource::SetDstWindow() in particular), so check   */
+/* that neither the sources nor their destination windows have changed  */
+/* since the index was built. This is much cheaper than testing each    */
+/* source against the requested window.                                 */
+
+int VRTSourcedRasterBand::IsSourceIndexUpToDate()
+{
+    if( m_hSourceIndex == NULL ||
+        m_apoIndexedSources.size() != static_cast<size_t>(nSources) )
+        return FALSE;
+
+    for( int iSource = 0; iSource < nSources; iSource++ )
+    {
+        if( m_apoIndexedSources[iSource] != papoSources[iSource] )
+            return FALSE;
+
+        double adfDstWindow[4];
+        GetSourceDstWindow( papoSources[iSource], adfDstWindow );
+        // Compare the bit patterns, so that a NaN window does not force
+        // a rebuild at each call.
+        if( memcmp( adfDstWindow, &m_adfIndexedDstWindows[4 * iSource],
+                    sizeof(adfDstWindow) ) != 0 )
+            return FALSE;
+    }
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                          BuildSourceIndex()                          */
+/************************************************************************/
+
+/* Index the destination windows of the simple sources. The other       */
+/* sources, and those whose destination window is not set (whole band)  */
+/* or not usable, are always returned by GetSourcesInWindow().          */
+
+void VRTSourcedRasterBand::BuildSourceIndex()
+{
+    InvalidateSourceIndex();
+
+    CPLRectObj sGlobalBounds;
+    sGlobalBounds.minx = 0;
+    sGlobalBounds.miny = 0;
+    sGlobalBounds.maxx = nRasterXSize;
+    sGlobalBounds.maxy = nRasterYSize;
+
+    m_apoIndexedSources.resize(nSources);
+    m_adfIndexedDstWindows.resize(4 * static_cast<size_t>(nSources));
+
+    std::vector<int> anIndexedSources;
+    std::vector<CPLRectObj> asBounds;
+    for( int iSource = 0; iSource < nSources; iSource++ )
+    {
+        double* padfDstWindow = &m_adfIndexedDstWindows[4 * iSource];
+        m_apoIndexedSources[iSource] = papoSources[iSource];
+        const int bHasDstWindow =
+            GetSourceDstWindow( papoSources[iSource], padfDstWindow );
+
+        const double dfDstXOff = padfDstWindow[0];
+        const double dfDstYOff = padfDstWindow[1];
+        const double dfDstXSize = padfDstWindow[2];
+        const double dfDstYSize = padfDstWindow[3];
+        if( !bHasDstWindow ||
+            !CPLIsFinite(dfDstXOff) || !CPLIsFinite(dfDstYOff) ||
+            !CPLIsFinite(dfDstXSize) || !CPLIsFinite(dfDstYSize) ||
+            dfDstXSize < 0 || dfDstYSize < 0 )
+        {
+            m_anUnindexedSources.push_back(iSource);
+            continue;
+        }
+
+        CPLRectObj sBounds;
+        sBounds.minx = dfDstXOff;
+        sBounds.miny = dfDstYOff;
+        sBounds.maxx = dfDstXOff + dfDstXSize;
+        sBounds.maxy = dfDstYOff + dfDstYSize;
+        sGlobalBounds.minx = MIN(sGlobalBounds.minx, sBounds.minx);
+        sGlobalBounds.miny = MIN(sGlobalBounds.miny, sBounds.miny);
+        sGlobalBounds.maxx = MAX(sGlobalBounds.maxx, sBounds.maxx);
+        sGlobalBounds.maxy = MAX(sGlobalBounds.maxy, sBounds.maxy);
+        anIndexedSources.push_back(iSource);
+        asBounds.push_back(sBounds);
+    }
+
+    m_hSourceIndex = CPLQuadTreeCreate(&sGlobalBounds, NULL);
+    CPLQuadTreeSetMaxDepth(m_hSourceIndex,
+        CPLQuadTreeGetAdvisedMaxDepth(
+            static_cast<int>(anIndexedSources.size())));
+    for( size_t i = 0; i < anIndexedSources.size(); i++ )
+    {
+        CPLQuadTreeInsertWithBounds(m_hSourceIndex,
+                                    (void*)(size_t)anIndexedSources[i],
+                                    &asBounds[i]);
+    }
+}
+
+/************************************************************************/
+/*                        InvalidateSourceIndex()                       */
+/************************************************************************/
+
+void VRTSourcedRasterBand::InvalidateSourceIndex()
+{
+    if( m_hSourceIndex != NULL )
+        CPLQuadTreeDestroy(m_hSourceIndex);
+    m_hSourceIndex = NULL;
+    m_apoIndexedSources.clear();
+    m_adfIndexedDstWindows.clear();
+    m_anUnindexedSources.clear();
+}
+
 /************************************************************************/
 /*                    CanUseSourcesMinMaxImplementations()              */
 /************************************************************************/
@@ -733,6 +938,7 @@ CPLErr VRTSourcedRasterBand::AddSource( VRTSource *poNewSource )
     papoSources = reinterpret_cast<VRTSource **>(
         CPLRealloc(papoSources, sizeof(void*) * nSources) );
     papoSources[nSources-1] = poNewSource;
+    InvalidateSourceIndex();
 
     reinterpret_cast<VRTDataset *>( poDS )->SetNeedsFlush();
 
@@ -1363,6 +1569,7 @@ CPLErr VRTSourcedRasterBand::SetMetadataItem( const char *pszName,
         {
             delete papoSources[iSource];
             papoSources[iSource] = poSource;
+            InvalidateSourceIndex();
             reinterpret_cast<VRTDataset *>( poDS )->SetNeedsFlush();
             return CE_None;
         }
@@ -1394,6 +1601,7 @@ CPLErr VRTSourcedRasterBand::SetMetadata( char **papszNewMD, const char *pszDoma
             CPLFree( papoSources );
             papoSources = NULL;
             nSources = 0;
+            InvalidateSourceIndex();
         }
 
         for( int i = 0; i < CSLCount(papszNewMD); i++ )
@@ -1453,6 +1661,7 @@ int VRTSourcedRasterBand::CloseDependentDatasets()
     CPLFree( papoSources );
     papoSources = NULL;
     nSources = 0;
+    InvalidateSourceIndex();
 
     return TRUE;
 }
@@ -92,6 +92,16 @@ VRTSimpleSource::VRTSimpleSource() :
     m_dfNoDataValue = VRT_NODATA_UNSET;
     m_bRelativeToVRTOri = -1;
     m_nMaxValue = 0;
+    m_bSrcDSPending = FALSE;
+    m_nSrcBand = 0;
+    m_bGetMaskBand = FALSE;
+    m_bSharedSrcDS = FALSE;
+    m_papszSrcOpenOptions = NULL;
+    m_nSrcRasterXSize = 0;
+    m_nSrcRasterYSize = 0;
+    m_eSrcDataType = GDT_Unknown;
+    m_nSrcBlockXSize = 0;
+    m_nSrcBlockYSize = 0;
 }
 
 /************************************************************************/
@@ -101,6 +111,9 @@ VRTSimpleSource::VRTSimpleSource() :
 VRTSimpleSource::VRTSimpleSource(const VRTSimpleSource* poSrcSource,
                                  double dfXDstRatio, double dfYDstRatio)
 {
+    // The copy shares the source band, so make sure it exists.
+    const_cast<VRTSimpleSource*>(poSrcSource)->OpenPendingSource();
+
     m_poRasterBand = poSrcSource->m_poRasterBand;
     m_poMaskBandMainBand = poSrcSource->m_poMaskBandMainBand;
     m_bNoDataSet = poSrcSource->m_bNoDataSet;
@@ -115,6 +128,16 @@ VRTSimpleSource::VRTSimpleSource(const VRTSimpleSource* poSrcSource,
     m_dfDstYSize = poSrcSource->m_dfDstYSize * dfYDstRatio;
     m_bRelativeToVRTOri = -1;
     m_nMaxValue = poSrcSource->m_nMaxValue;
+    m_bSrcDSPending = FALSE;
+    m_nSrcBand = poSrcSource->m_nSrcBand;
+    m_bGetMaskBand = poSrcSource->m_bGetMaskBand;
+    m_bSharedSrcDS = poSrcSource->m_bSharedSrcDS;
+    m_papszSrcOpenOptions = NULL;
+    m_nSrcRasterXSize = 0;
+    m_nSrcRasterYSize = 0;
+    m_eSrcDataType = GDT_Unknown;
+    m_nSrcBlockXSize = 0;
+    m_nSrcBlockYSize = 0;
 }
 
 /************************************************************************/
@@ -144,6 +167,7 @@ VRTSimpleSource::~VRTSimpleSource()
         else
             m_poRasterBand->GetDataset()->Dereference();
     }
+    CSLDestroy( m_papszSrcOpenOptions );
 }
 
 /************************************************************************/
@@ -217,6 +241,26 @@ void VRTSimpleSource::SetDstWindow( double dfNewXOff, double dfNewYOff,
     m_dfDstYSize = RoundIfCloseToInt(dfNewYSize);
 }
 
+/************************************************************************/
+/*                            GetDstWindow()                            */
+/************************************************************************/
+
+/* Returns FALSE if no destination window is set, in which case the     */
+/* source covers the whole band.                                        */
+
+int VRTSimpleSource::GetDstWindow( double *pdfDstXOff, double *pdfDstYOff,
+                                   double *pdfDstXSize, double *pdfDstYSize )
+
+{
+    *pdfDstXOff = m_dfDstXOff;
+    *pdfDstYOff = m_dfDstYOff;
+    *pdfDstXSize = m_dfDstXSize;
+    *pdfDstYSize = m_dfDstYSize;
+
+    return m_dfDstXOff != -1 || m_dfDstXSize != -1
+        || m_dfDstYOff != -1 || m_dfDstYSize != -1;
+}
+
 /************************************************************************/
 /*                           SetNoDataValue()                           */
 /************************************************************************/
@@ -256,7 +300,7 @@ CPLXMLNode *VRTSimpleSource::SerializeToXML( const char *pszVRTPath )
     const char      *pszRelativePath;
     int              nBlockXSize, nBlockYSize;
 
-    if( m_poRasterBand == NULL )
+    if( !OpenPendingSource() )
         return NULL;
 
     GDALDataset     *poDS;
@@ -579,23 +623,88 @@ CPLErr VRTSimpleSource::XMLInit( CPLXMLNode *psSrc, const char *pszVRTPath )
         }
     }
 
-    char** papszOpenOptions = GDALDeserializeOpenOptionsFromXML(psSrc);
-    if( strstr(pszSrcDSName,"<VRTDataset") != NULL )
-        papszOpenOptions = CSLSetNameValue(papszOpenOptions, "ROOT_PATH", pszVRTPath);
+    m_osSrcDSName = pszSrcDSName;
+    CPLFree( pszSrcDSName );
+    m_nSrcBand = nSrcBand;
+    m_bGetMaskBand = bGetMaskBand;
+    m_bSharedSrcDS = bShared;
+    m_nSrcRasterXSize = nRasterXSize;
+    m_nSrcRasterYSize = nRasterYSize;
+    m_eSrcDataType = eDataType;
+    m_nSrcBlockXSize = nBlockXSize;
+    m_nSrcBlockYSize = nBlockYSize;
+
+    CSLDestroy( m_papszSrcOpenOptions );
+    m_papszSrcOpenOptions = GDALDeserializeOpenOptionsFromXML(psSrc);
+    if( strstr(m_osSrcDSName,"<VRTDataset") != NULL )
+        m_papszSrcOpenOptions = CSLSetNameValue(m_papszSrcOpenOptions,
+                                                "ROOT_PATH", pszVRTPath);
+
+/* -------------------------------------------------------------------- */
+/*      Set characteristics.                                            */
+/* -------------------------------------------------------------------- */
+    CPLXMLNode* psSrcRect = CPLGetXMLNode(psSrc,"SrcRect");
+    if (psSrcRect)
+    {
+        SetSrcWindow( CPLAtof(CPLGetXMLValue(psSrcRect,"xOff","-1")),
+                      CPLAtof(CPLGetXMLValue(psSrcRect,"yOff","-1")),
+                      CPLAtof(CPLGetXMLValue(psSrcRect,"xSize","-1")),
+                      CPLAtof(CPLGetXMLValue(psSrcRect,"ySize","-1")) );
+    }
+    else
+    {
+        m_dfSrcXOff = m_dfSrcYOff = m_dfSrcXSize = m_dfSrcYSize = -1;
+    }
+
+    CPLXMLNode* psDstRect = CPLGetXMLNode(psSrc,"DstRect");
+    if (psDstRect)
+    {
+        SetDstWindow( CPLAtof(CPLGetXMLValue(psDstRect,"xOff","-1")),
+                      CPLAtof(CPLGetXMLValue(psDstRect,"yOff","-1")),
+                      CPLAtof(CPLGetXMLValue(psDstRect,"xSize","-1")),
+                      CPLAtof(CPLGetXMLValue(psDstRect,"ySize","-1")) );
+    }
+    else
+    {
+        m_dfDstXOff = m_dfDstYOff = m_dfDstXSize = m_dfDstYSize = -1;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      With huge mosaics, defer the opening of the source to the       */
+/*      first access to it.                                             */
+/* -------------------------------------------------------------------- */
+    if( CPLTestBool(CPLGetConfigOption("VRT_LAZY_SOURCE_OPENING", "NO")) )
+    {
+        m_bSrcDSPending = TRUE;
+        return CE_None;
+    }
+
+    return OpenSourceDataset();
+}
+
+/************************************************************************/
+/*                         OpenSourceDataset()                          */
+/************************************************************************/
+
+CPLErr VRTSimpleSource::OpenSourceDataset()
+
+{
+    m_bSrcDSPending = FALSE;
 
     GDALDataset *poSrcDS;
-    if (nRasterXSize == 0 || nRasterYSize == 0 || eDataType == (GDALDataType)-1 ||
-        nBlockXSize == 0 || nBlockYSize == 0)
+    if (m_nSrcRasterXSize == 0 || m_nSrcRasterYSize == 0 ||
+        m_eSrcDataType == (GDALDataType)-1 ||
+        m_nSrcBlockXSize == 0 || m_nSrcBlockYSize == 0)
     {
         /* -------------------------------------------------------------------- */
         /*      Open the file (shared).                                         */
         /* -------------------------------------------------------------------- */
         int nOpenFlags = GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR;
-        if( bShared )
+        if( m_bSharedSrcDS )
             nOpenFlags |= GDAL_OF_SHARED;
         poSrcDS = (GDALDataset *) GDALOpenEx(
-                    pszSrcDSName, nOpenFlags, NULL,
-                    (const char* const* )papszOpenOptions, NULL );
+                    m_osSrcDSName, nOpenFlags, NULL,
+                    (const char* const* )m_papszSrcOpenOptions, NULL );
     }
     else
     {
@@ -603,21 +712,20 @@ CPLErr VRTSimpleSource::XMLInit( CPLXMLNode *psSrc, const char *pszVRTPath )
         /*      Create a proxy dataset                                          */
         /* -------------------------------------------------------------------- */
         int i;
-        GDALProxyPoolDataset* proxyDS = new GDALProxyPoolDataset(pszSrcDSName, nRasterXSize, nRasterYSize, GA_ReadOnly, bShared);
-        proxyDS->SetOpenOptions(papszOpenOptions);
+        GDALProxyPoolDataset* proxyDS = new GDALProxyPoolDataset(m_osSrcDSName, m_nSrcRasterXSize, m_nSrcRasterYSize, GA_ReadOnly, m_bSharedSrcDS);
+        proxyDS->SetOpenOptions(m_papszSrcOpenOptions);
         poSrcDS = proxyDS;
 
         /* Only the information of rasterBand nSrcBand will be accurate */
         /* but that's OK since we only use that band afterwards */
-        for(i=1;i<=nSrcBand;i++)
-            proxyDS->AddSrcBandDescription(eDataType, nBlockXSize, nBlockYSize);
-        if (bGetMaskBand)
-            ((GDALProxyPoolRasterBand*)proxyDS->GetRasterBand(nSrcBand))->AddSrcMaskBandDescription(eDataType, nBlockXSize, nBlockYSize);
+        for(i=1;i<=m_nSrcBand;i++)
+            proxyDS->AddSrcBandDescription(m_eSrcDataType, m_nSrcBlockXSize, m_nSrcBlockYSize);
+        if (m_bGetMaskBand)
+            ((GDALProxyPoolRasterBand*)proxyDS->GetRasterBand(m_nSrcBand))->AddSrcMaskBandDescription(m_eSrcDataType, m_nSrcBlockXSize, m_nSrcBlockYSize);
     }
 
-    CSLDestroy(papszOpenOptions);
-
-    CPLFree( pszSrcDSName );
+    CSLDestroy(m_papszSrcOpenOptions);
+    m_papszSrcOpenOptions = NULL;
 
     if( poSrcDS == NULL )
         return CE_Failure;
@@ -626,14 +734,14 @@ CPLErr VRTSimpleSource::XMLInit( CPLXMLNode *psSrc, const char *pszVRTPath )
 /*      Get the raster band.                                            */
 /* -------------------------------------------------------------------- */
 
-    m_poRasterBand = poSrcDS->GetRasterBand(nSrcBand);
+    m_poRasterBand = poSrcDS->GetRasterBand(m_nSrcBand);
     if( m_poRasterBand == NULL )
     {
         if( poSrcDS->GetShared() )
             GDALClose( (GDALDatasetH) poSrcDS );
         return CE_Failure;
     }
-    if (bGetMaskBand)
+    if (m_bGetMaskBand)
     {
         m_poMaskBandMainBand = m_poRasterBand;
         m_poRasterBand = m_poRasterBand->GetMaskBand();
@@ -641,36 +749,55 @@ CPLErr VRTSimpleSource::XMLInit( CPLXMLNode *psSrc, const char *pszVRTPath )
             return CE_Failure;
     }
 
+    return CE_None;
+}
+
+/************************************************************************/
+/*                         OpenPendingSource()                          */
+/*                                                                      */
+/*      Open the source dataset if this has been deferred. Returns      */
+/*      TRUE if the source band is available.                           */
+/************************************************************************/
+
+int VRTSimpleSource::OpenPendingSource()
+
+{
+    if( !m_bSrcDSPending )
+        return m_poRasterBand != NULL;
+
 /* -------------------------------------------------------------------- */
-/*      Set characteristics.                                            */
+/*      If the properties of the source are not known, fetch them       */
+/*      now, so that the dataset handle can be managed by the pool of   */
+/*      proxy datasets (see GDAL_MAX_DATASET_POOL_SIZE) rather than     */
+/*      being kept opened for the lifetime of the VRT.                  */
 /* -------------------------------------------------------------------- */
-    CPLXMLNode* psSrcRect = CPLGetXMLNode(psSrc,"SrcRect");
-    if (psSrcRect)
-    {
-        SetSrcWindow( CPLAtof(CPLGetXMLValue(psSrcRect,"xOff","-1")),
-                      CPLAtof(CPLGetXMLValue(psSrcRect,"yOff","-1")),
-                      CPLAtof(CPLGetXMLValue(psSrcRect,"xSize","-1")),
-                      CPLAtof(CPLGetXMLValue(psSrcRect,"ySize","-1")) );
-    }
-    else
-    {
-        m_dfSrcXOff = m_dfSrcYOff = m_dfSrcXSize = m_dfSrcYSize = -1;
-    }
-
-    CPLXMLNode* psDstRect = CPLGetXMLNode(psSrc,"DstRect");
-    if (psDstRect)
+    if (m_nSrcRasterXSize == 0 || m_nSrcRasterYSize == 0 ||
+        m_eSrcDataType == (GDALDataType)-1 ||
+        m_nSrcBlockXSize == 0 || m_nSrcBlockYSize == 0)
     {
-        SetDstWindow( CPLAtof(CPLGetXMLValue(psDstRect,"xOff","-1")),
-                      CPLAtof(CPLGetXMLValue(psDstRect,"yOff","-1")),
-                      CPLAtof(CPLGetXMLValue(psDstRect,"xSize","-1")),
-                      CPLAtof(CPLGetXMLValue(psDstRect,"ySize","-1")) );
-    }
-    else
-    {
-        m_dfDstXOff = m_dfDstYOff = m_dfDstXSize = m_dfDstYSize = -1;
+        int nOpenFlags = GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR;
+        if( m_bSharedSrcDS )
+            nOpenFlags |= GDAL_OF_SHARED;
+        GDALDataset* poSrcDS = (GDALDataset *) GDALOpenEx(
+                    m_osSrcDSName, nOpenFlags, NULL,
+                    (const char* const* )m_papszSrcOpenOptions, NULL );
+        if( poSrcDS == NULL )
+        {
+            m_bSrcDSPending = FALSE;
+            return FALSE;
+        }
+        GDALRasterBand* poSrcBand = poSrcDS->GetRasterBand(m_nSrcBand);
+        if( poSrcBand != NULL )
+        {
+            m_nSrcRasterXSize = poSrcDS->GetRasterXSize();
+            m_nSrcRasterYSize = poSrcDS->GetRasterYSize();
+            m_eSrcDataType = poSrcBand->GetRasterDataType();
+            poSrcBand->GetBlockSize(&m_nSrcBlockXSize, &m_nSrcBlockYSize);
+        }
+        GDALClose( (GDALDatasetH) poSrcDS );
     }
 
-    return CE_None;
+    return OpenSourceDataset() == CE_None;
 }
 
 /************************************************************************/
@@ -680,9 +807,13 @@ CPLErr VRTSimpleSource::XMLInit( CPLXMLNode *psSrc, const char *pszVRTPath )
 void VRTSimpleSource::GetFileList(char*** ppapszFileList, int *pnSize,
                                   int *pnMaxSize, CPLHashSet* hSetFiles)
 {
-    const char* pszFilename;
-    if (m_poRasterBand != NULL && m_poRasterBand->GetDataset() != NULL &&
-        (pszFilename = m_poRasterBand->GetDataset()->GetDescription()) != NULL)
+    const char* pszFilename = NULL;
+    /* Do not open a pending source just to know its name */
+    if( m_bSrcDSPending )
+        pszFilename = m_osSrcDSName.c_str();
+    else if( m_poRasterBand != NULL && m_poRasterBand->GetDataset() != NULL )
+        pszFilename = m_poRasterBand->GetDataset()->GetDescription();
+    if( pszFilename != NULL )
     {
 /* -------------------------------------------------------------------- */
 /*      Is the filename even a real filesystem object?                  */
@@ -733,6 +864,7 @@ void VRTSimpleSource::GetFileList(char*** ppapszFileList, int *pnSize,
 
 GDALRasterBand* VRTSimpleSource::GetBand()
 {
+    OpenPendingSource();
     return m_poMaskBandMainBand ? NULL : m_poRasterBand;
 }
 
@@ -834,6 +966,9 @@ VRTSimpleSource::GetSrcDstWindow( int nXOff, int nYOff, int nXSize, int nYSize,
             return FALSE;
     }
 
+    if( !OpenPendingSource() )
+        return FALSE;
+
 /* -------------------------------------------------------------------- */
 /*      This request window corresponds to the whole output buffer.     */
 /* -------------------------------------------------------------------- */
@@ -1088,6 +1223,9 @@ VRTSimpleSource::RasterIO( int nXOff, int nYOff, int nXSize, int nYSize,
                            GDALRasterIOExtraArg* psExtraArgIn )
 
 {
+    if( !OpenPendingSource() )
+        return CE_Failure;
+
     GDALRasterIOExtraArg sExtraArg;
 
     INIT_RASTERIO_EXTRA_ARG(sExtraArg);
@@ -1359,6 +1497,9 @@ CPLErr VRTSimpleSource::DatasetRasterIO(
                                GSpacing nBandSpace,
                                GDALRasterIOExtraArg* psExtraArgIn)
 {
+    if( !OpenPendingSource() )
+        return CE_Failure;
+
     if (!EQUAL(GetType(), "SimpleSource"))
     {
         CPLError(CE_Failure, CPLE_NotSupported,
@@ -1496,6 +1637,9 @@ VRTAveragedSource::RasterIO( int nXOff, int nYOff, int nXSize, int nYSize,
                            GDALRasterIOExtraArg* psExtraArgIn )
 
 {
+    if( !OpenPendingSource() )
+        return CE_Failure;
+
     GDALRasterIOExtraArg sExtraArg;
 
     INIT_RASTERIO_EXTRA_ARG(sExtraArg);
@@ -2087,6 +2231,9 @@ VRTComplexSource::RasterIO( int nXOff, int nYOff, int nXSize, int nYSize,
                             GDALRasterIOExtraArg* psExtraArgIn)
 
 {
+    if( !OpenPendingSource() )
+        return CE_Failure;
+
     GDALRasterIOExtraArg sExtraArg;
 
     INIT_RASTERIO_EXTRA_ARG(sExtraArg);
@@ -155,9 +155,16 @@ typedef struct
     double                 dfXSize;
     /*! Height in pixels of the area of interest. Only valid if bFloatingPointWindowValidity = TRUE */
     double                 dfYSize;
+
+    /*! Hint that, for a non-resampled read, blocks may be decoded directly
+        into the buffer without going through the block cache, when the
+        driver supports it. Blocks already in the cache are still used.
+        Only valid if nVersion >= 2.
+        @since GDAL 2.2 */
+    int                    bDirectRead;
 } GDALRasterIOExtraArg;
 
-#define RASTERIO_EXTRA_ARG_CURRENT_VERSION  1
+#define RASTERIO_EXTRA_ARG_CURRENT_VERSION  2
 
 /** Macro to initialize an instance of GDALRasterIOExtraArg structure.
   * @since GDAL 2.0
@@ -167,7 +174,8 @@ typedef struct
          (s).eResampleAlg = GRIORA_NearestNeighbour; \
          (s).pfnProgress = NULL; \
          (s).pProgressData = NULL; \
-         (s).bFloatingPointWindowValidity = FALSE; } while(0)
+         (s).bFloatingPointWindowValidity = FALSE; \
+         (s).bDirectRead = FALSE; } while(0)
 
 /*! Types of color interpretation for raster bands. */
 typedef enum
@@ -1060,6 +1068,28 @@ void CPL_DLL CPL_STDCALL GDALSetCacheMax64( GIntBig nBytes );
 GIntBig CPL_DLL CPL_STDCALL GDALGetCacheMax64(void);
 GIntBig CPL_DLL CPL_STDCALL GDALGetCacheUsed64(void);
 
+int CPL_DLL CPL_STDCALL GDALGetCacheShardCount(void);
+int CPL_DLL CPL_STDCALL GDALGetCacheShardStatistics( int iShard,
+                                                     GIntBig* pnCacheUsed,
+                                                     GIntBig* pnHits,
+                                                     GIntBig* pnMisses,
+                                                     GIntBig* pnEvictions );
+
+void CPL_DLL CPL_STDCALL GDALSetCompressedCacheMax( int nBytes );
+void CPL_DLL CPL_STDCALL GDALSetCompressedCacheMax64( GIntBig nBytes );
+GIntBig CPL_DLL CPL_STDCALL GDALGetCompressedCacheMax64(void);
+void CPL_DLL CPL_STDCALL GDALGetCompressedCacheStatistics( GIntBig* pnCacheUsed,
+                                                          GIntBig* pnHits,
+                                                          GIntBig* pnMisses );
+
+void CPL_DLL CPL_STDCALL GDALDatasetSetCacheMax( GDALDatasetH hDS,
+                                                 GIntBig nBytes );
+GIntBig CPL_DLL CPL_STDCALL GDALDatasetGetCacheMax( GDALDatasetH hDS );
+void CPL_DLL CPL_STDCALL GDALDatasetGetCacheStatistics( GDALDatasetH hDS,
+                                                        GIntBig* pnCacheUsed,
+                                                        GIntBig* pnHits,
+                                                        GIntBig* pnMisses );
+
 int CPL_DLL CPL_STDCALL GDALFlushCacheBlock(void);
 
 /* ==================================================================== */
@@ -414,6 +414,12 @@ class CPL_DLL GDALDataset : public GDALMajorObject
     int          AcquireMutex();
     void         ReleaseMutex();
 
+    friend class GDALRasterBlock;
+
+    void         UpdateBlockCacheStatistics( GIntBig nSizeDelta,
+                                             int nHits, int nMisses );
+    bool         IsBlockCacheQuotaExceeded();
+
   public:
     virtual     ~GDALDataset();
 
@@ -484,6 +490,12 @@ class CPL_DLL GDALDataset : public GDALMajorObject
 
     static GDALDataset **GetOpenDatasets( int *pnDatasetCount );
 
+    void          SetBlockCacheMax( GIntBig nBytes );
+    GIntBig       GetBlockCacheMax();
+    void          GetBlockCacheStatistics( GIntBig* pnCacheUsed,
+                                           GIntBig* pnHits,
+                                           GIntBig* pnMisses );
+
     CPLErr BuildOverviews( const char *, int, int *,
                            int, int *, GDALProgressFunc, void * );
 
@@ -595,10 +607,19 @@ class CPL_DLL GDALRasterBlock
     GDALRasterBlock     *poPrevious;
 
     int                  bMustDetach;
+    int                  nShard;
+    int                  nCacheList;
 
     void        Detach_unlocked( void );
+    void        Unlink_unlocked( void );
     void        Touch_unlocked( void );
 
+    static GDALRasterBlock* SelectBlockToEvict_unlocked( int iShard,
+                                                         int bDirtyBlocksOnly,
+                                                         GDALDataset* poDS = NULL );
+    static void FreeEvictedBlock( GDALRasterBlock* poTarget );
+    void        StoreInCompressedCache( void );
+
     void        RecycleFor( int nXOffIn, int nYOffIn );
 
   public:
@@ -630,14 +651,22 @@ class CPL_DLL GDALRasterBlock
     int          TakeLock();
     int          DropLockForRemovalFromStorage();
 
+    int          RestoreFromCompressedCache( int bRestoreData = TRUE );
+
     /// @brief Accessor to source GDALRasterBand object.
     /// @return source raster band of the raster block.
     GDALRasterBand *GetBand() { return poBand; }
 
     static void FlushDirtyBlocks();
     static int  FlushCacheBlock(int bDirtyBlocksOnly = FALSE);
+    static void FlushDatasetExcessBlocks(GDALDataset* poDS);
+    static void DropCompressedBlocks(GDALRasterBand* poBand);
+    static void DropGhostEntries(GDALRasterBand* poBand);
     static void Verify();
 
+    /* Should only be called by GDALSetCacheMax64() */
+    static int  FlushCacheBlockFromShard(int iShard, int bDirtyBlocksOnly);
+
 #ifdef notdef
     static void CheckNonOrphanedBlocks(GDALRasterBand* poBand);
     void        DumpBlock();
@@ -812,6 +841,12 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
 
     int            InitBlockInfo();
 
+    virtual int    CanDirectReadBlocks();
+    CPLErr         DirectReadBlocks( int nXOff, int nYOff, int nXSize, int nYSize,
+                                     void * pData, GDALDataType eBufType,
+                                     GSpacing nPixelSpace, GSpacing nLineSpace,
+                                     GDALRasterIOExtraArg* psExtraArg ) CPL_WARN_UNUSED_RESULT;
+
     CPLErr         AdoptBlock( GDALRasterBlock * );
     GDALRasterBlock *TryGetLockedBlockRef( int nXBlockOff, int nYBlockYOff );
     void           AddBlockToFreeList( GDALRasterBlock * );
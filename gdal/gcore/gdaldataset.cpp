@@ -80,9 +80,21 @@ class GDALDatasetPrivate
 #endif
         GDALAllowReadWriteMutexState eStateReadWriteMutex;
 
+        // Block cache quota and statistics, protected by hBlockCacheLock
+        CPLLock* hBlockCacheLock;
+        GIntBig  nBlockCacheMax;
+        GIntBig  nBlockCacheUsed;
+        GIntBig  nBlockCacheHits;
+        GIntBig  nBlockCacheMisses;
+
         GDALDatasetPrivate() :
             hMutex(NULL),
-            eStateReadWriteMutex(RW_MUTEX_STATE_UNKNOWN) {}
+            eStateReadWriteMutex(RW_MUTEX_STATE_UNKNOWN),
+            hBlockCacheLock(NULL),
+            nBlockCacheMax(0),
+            nBlockCacheUsed(0),
+            nBlockCacheHits(0),
+            nBlockCacheMisses(0) {}
 
 };
 
@@ -226,6 +238,28 @@ void GDALDataset::Init(int bForceCachedIOIn)
 
     m_poStyleTable = NULL;
     m_hPrivateData = new (std::nothrow) GDALDatasetPrivate;
+
+/* -------------------------------------------------------------------- */
+/*      Default block cache quota, either in MB (or bytes if greater    */
+/*      than 100000) or as a percentage of the global cache size.       */
+/* -------------------------------------------------------------------- */
+    const char* pszDatasetCacheMax =
+        CPLGetConfigOption("GDAL_DATASET_CACHEMAX", NULL);
+    if( pszDatasetCacheMax != NULL && m_hPrivateData != NULL )
+    {
+        GIntBig nCacheMax;
+        if( strchr(pszDatasetCacheMax, '%') != NULL )
+            nCacheMax = static_cast<GIntBig>(
+                GDALGetCacheMax64() * CPLAtof(pszDatasetCacheMax) / 100.0);
+        else
+        {
+            nCacheMax = CPLAtoGIntBig(pszDatasetCacheMax);
+            if( nCacheMax < 100000 )
+                nCacheMax *= 1024 * 1024;
+        }
+        if( nCacheMax > 0 )
+            SetBlockCacheMax(nCacheMax);
+    }
 }
 
 /************************************************************************/
@@ -333,6 +367,8 @@ GDALDataset::~GDALDataset()
     GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
     if( psPrivate != NULL && psPrivate->hMutex != NULL )
         CPLDestroyMutex( psPrivate->hMutex );
+    if( psPrivate != NULL && psPrivate->hBlockCacheLock != NULL )
+        CPLDestroyLock( psPrivate->hBlockCacheLock );
     delete psPrivate;
 
     CSLDestroy( papszOpenOptions );
@@ -1905,12 +1941,19 @@ CPLErr GDALDataset::RasterIO( GDALRWFlag eRWFlag,
         INIT_RASTERIO_EXTRA_ARG(sExtraArg);
         psExtraArg = &sExtraArg;
     }
-    else if( psExtraArg->nVersion != RASTERIO_EXTRA_ARG_CURRENT_VERSION )
+    else if( psExtraArg->nVersion < 1 ||
+             psExtraArg->nVersion > RASTERIO_EXTRA_ARG_CURRENT_VERSION )
     {
         ReportError( CE_Failure, CPLE_AppDefined,
                      "Unhandled version of GDALRasterIOExtraArg" );
         return CE_Failure;
     }
+    else if( psExtraArg->nVersion < RASTERIO_EXTRA_ARG_CURRENT_VERSION )
+    {
+        // Structure from an older version: default the newer members.
+        GDALCopyRasterIOExtraArg(&sExtraArg, psExtraArg);
+        psExtraArg = &sExtraArg;
+    }
 
     GDALRasterIOExtraArgSetResampleAlg(psExtraArg, nXSize, nYSize,
                                        nBufXSize, nBufYSize);
@@ -6244,3 +6287,195 @@ void GDALDataset::ReleaseMutex()
     if( psPrivate )
         CPLReleaseMutex(psPrivate->hMutex);
 }
+
+/************************************************************************/
+/*                          SetBlockCacheMax()                          */
+/************************************************************************/
+
+/**
+ * \brief Set the maximum amount of the block cache this dataset may use.
+ *
+ * When caching a new block of one of the bands of the dataset would make
+ * the size of the blocks of the dataset in the global block cache exceed
+ * this quota, the least recently used blocks of the dataset are evicted
+ * first, instead of blocks of other datasets. The quota is enforced in
+ * addition to the global limit set with GDALSetCacheMax64().
+ *
+ * The default quota can be set with the GDAL_DATASET_CACHEMAX configuration
+ * option, either in MB or as a percentage of the global cache size
+ * (e.g. "10%"). By default datasets have no quota.
+ *
+ * This method is the same as the C function GDALDatasetSetCacheMax().
+ *
+ * @param nBytes the maximum number of bytes, or 0 for no quota.
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALDataset::SetBlockCacheMax( GIntBig nBytes )
+{
+    GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
+    if( psPrivate == NULL )
+        return;
+    {
+        CPLLockHolderD( &(psPrivate->hBlockCacheLock), LOCK_SPIN );
+        psPrivate->nBlockCacheMax = MAX(0, nBytes);
+    }
+    GDALRasterBlock::FlushDatasetExcessBlocks(this);
+}
+
+/************************************************************************/
+/*                        GDALDatasetSetCacheMax()                      */
+/************************************************************************/
+
+/**
+ * \brief Set the maximum amount of the block cache a dataset may use.
+ *
+ * @see GDALDataset::SetBlockCacheMax()
+ * @since GDAL 2.2
+ */
+
+void CPL_STDCALL GDALDatasetSetCacheMax( GDALDatasetH hDS, GIntBig nBytes )
+{
+    VALIDATE_POINTER0( hDS, "GDALDatasetSetCacheMax" );
+
+    ((GDALDataset *) hDS)->SetBlockCacheMax( nBytes );
+}
+
+/************************************************************************/
+/*                          GetBlockCacheMax()                          */
+/************************************************************************/
+
+/**
+ * \brief Get the maximum amount of the block cache this dataset may use.
+ *
+ * This method is the same as the C function GDALDatasetGetCacheMax().
+ *
+ * @return the quota in bytes, or 0 if there is none.
+ *
+ * @since GDAL 2.2
+ */
+
+GIntBig GDALDataset::GetBlockCacheMax()
+{
+    GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
+    if( psPrivate == NULL )
+        return 0;
+    CPLLockHolderD( &(psPrivate->hBlockCacheLock), LOCK_SPIN );
+    return psPrivate->nBlockCacheMax;
+}
+
+/************************************************************************/
+/*                        GDALDatasetGetCacheMax()                      */
+/************************************************************************/
+
+/**
+ * \brief Get the maximum amount of the block cache a dataset may use.
+ *
+ * @see GDALDataset::GetBlockCacheMax()
+ * @since GDAL 2.2
+ */
+
+GIntBig CPL_STDCALL GDALDatasetGetCacheMax( GDALDatasetH hDS )
+{
+    VALIDATE_POINTER1( hDS, "GDALDatasetGetCacheMax", 0 );
+
+    return ((GDALDataset *) hDS)->GetBlockCacheMax();
+}
+
+/************************************************************************/
+/*                      GetBlockCacheStatistics()                       */
+/************************************************************************/
+
+/**
+ * \brief Get block cache usage statistics of this dataset.
+ *
+ * The statistics are accumulated over the blocks of all the bands of the
+ * dataset since it was opened. A hit is counted each time a block already
+ * in the cache is requested, and a miss each time a block must be allocated
+ * in the cache.
+ *
+ * This method is the same as the C function GDALDatasetGetCacheStatistics().
+ *
+ * @param pnCacheUsed pointer to the number of bytes cached, or NULL.
+ * @param pnHits pointer to the number of hits, or NULL.
+ * @param pnMisses pointer to the number of misses, or NULL.
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALDataset::GetBlockCacheStatistics( GIntBig* pnCacheUsed,
+                                           GIntBig* pnHits,
+                                           GIntBig* pnMisses )
+{
+    GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
+    GIntBig nCacheUsed = 0, nHits = 0, nMisses = 0;
+    if( psPrivate != NULL )
+    {
+        CPLLockHolderD( &(psPrivate->hBlockCacheLock), LOCK_SPIN );
+        nCacheUsed = psPrivate->nBlockCacheUsed;
+        nHits = psPrivate->nBlockCacheHits;
+        nMisses = psPrivate->nBlockCacheMisses;
+    }
+    if( pnCacheUsed )
+        *pnCacheUsed = nCacheUsed;
+    if( pnHits )
+        *pnHits = nHits;
+    if( pnMisses )
+        *pnMisses = nMisses;
+}
+
+/************************************************************************/
+/*                    GDALDatasetGetCacheStatistics()                   */
+/************************************************************************/
+
+/**
+ * \brief Get block cache usage statistics of a dataset.
+ *
+ * @see GDALDataset::GetBlockCacheStatistics()
+ * @since GDAL 2.2
+ */
+
+void CPL_STDCALL GDALDatasetGetCacheStatistics( GDALDatasetH hDS,
+                                                GIntBig* pnCacheUsed,
+                                                GIntBig* pnHits,
+                                                GIntBig* pnMisses )
+{
+    VALIDATE_POINTER0( hDS, "GDALDatasetGetCacheStatistics" );
+
+    ((GDALDataset *) hDS)->GetBlockCacheStatistics( pnCacheUsed, pnHits,
+                                                    pnMisses );
+}
+
+/************************************************************************/
+/*                     UpdateBlockCacheStatistics()                     */
+/*                                                                      */
+/*      Called by GDALRasterBlock when blocks of the dataset enter or   */
+/*      leave the block cache, or are requested.                        */
+/************************************************************************/
+
+void GDALDataset::UpdateBlockCacheStatistics( GIntBig nSizeDelta,
+                                              int nHits, int nMisses )
+{
+    GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
+    if( psPrivate == NULL )
+        return;
+    CPLLockHolderD( &(psPrivate->hBlockCacheLock), LOCK_SPIN );
+    psPrivate->nBlockCacheUsed += nSizeDelta;
+    psPrivate->nBlockCacheHits += nHits;
+    psPrivate->nBlockCacheMisses += nMisses;
+}
+
+/************************************************************************/
+/*                      IsBlockCacheQuotaExceeded()                     */
+/************************************************************************/
+
+bool GDALDataset::IsBlockCacheQuotaExceeded()
+{
+    GDALDatasetPrivate* psPrivate = (GDALDatasetPrivate* )m_hPrivateData;
+    if( psPrivate == NULL )
+        return false;
+    CPLLockHolderD( &(psPrivate->hBlockCacheLock), LOCK_SPIN );
+    return psPrivate->nBlockCacheMax > 0 &&
+           psPrivate->nBlockCacheUsed > psPrivate->nBlockCacheMax;
+}
@@ -193,12 +193,19 @@ CPLErr GDALRasterBand::RasterIO( GDALRWFlag eRWFlag,
         INIT_RASTERIO_EXTRA_ARG(sExtraArg);
         psExtraArg = &sExtraArg;
     }
-    else if( psExtraArg->nVersion != RASTERIO_EXTRA_ARG_CURRENT_VERSION )
+    else if( psExtraArg->nVersion < 1 ||
+             psExtraArg->nVersion > RASTERIO_EXTRA_ARG_CURRENT_VERSION )
     {
         ReportError( CE_Failure, CPLE_AppDefined,
                      "Unhandled version of GDALRasterIOExtraArg" );
         return CE_Failure;
     }
+    else if( psExtraArg->nVersion < RASTERIO_EXTRA_ARG_CURRENT_VERSION )
+    {
+        // Structure from an older version: default the newer members.
+        GDALCopyRasterIOExtraArg(&sExtraArg, psExtraArg);
+        psExtraArg = &sExtraArg;
+    }
 
     GDALRasterIOExtraArgSetResampleAlg(psExtraArg, nXSize, nYSize,
                                        nBufXSize, nBufYSize);
@@ -861,7 +868,15 @@ CPLErr GDALRasterBand::FlushCache()
     if (poBandBlockCache == NULL || !poBandBlockCache->IsInitOK())
         return eGlobalErr;
 
-    return poBandBlockCache->FlushCache();
+    CPLErr eErr = poBandBlockCache->FlushCache();
+
+    // Now that no block of the band can be evicted anymore, forget the
+    // copies of the blocks kept by the compressed cache tier, and the keys
+    // remembered by the 2Q policy.
+    GDALRasterBlock::DropCompressedBlocks(this);
+    GDALRasterBlock::DropGhostEntries(this);
+
+    return eErr;
 }
 
 /************************************************************************/
@@ -1140,7 +1155,10 @@ GDALRasterBlock * GDALRasterBand::GetLockedBlockRef( int nXBlockOff,
             return( NULL );
         }
 
-        if( !bJustInitialize )
+        /* Restore the block if it was evicted earlier and kept compressed */
+        const bool bRestored =
+            CPL_TO_BOOL(poBlock->RestoreFromCompressedCache(!bJustInitialize));
+        if( !bJustInitialize && !bRestored )
         {
             int bCallLeaveReadWrite = EnterReadWrite(GF_Read);
             eErr = IReadBlock(nXBlockOff,nYBlockOff,poBlock->GetDataRef());
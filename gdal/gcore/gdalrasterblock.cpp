@@ -30,25 +30,103 @@
  ****************************************************************************/
 
 #include "gdal_priv.h"
+#include "cpl_hash_set.h"
 #include "cpl_multiproc.h"
 
+#include <algorithm>
+#include <map>
+
 CPL_CVSID("$Id$");
 
 static bool bCacheMaxInitialized = false;
 static GIntBig nCacheMax = 40 * 1024*1024; /* Will later be overridden by the default 5% if GDAL_CACHEMAX not defined */
-static volatile GIntBig nCacheUsed = 0;
 
-static GDALRasterBlock *poOldest = NULL;    /* tail */
-static GDALRasterBlock *poNewest = NULL;    /* head */
+/* -------------------------------------------------------------------- */
+/*      The global block cache is made of one or several shards, each   */
+/*      with its own lock, LRU list and share of the cache budget.      */
+/*      By default there is a single shard, which is the historical     */
+/*      behaviour. GDAL_RB_CACHE_SHARDS=N selects N shards, so that     */
+/*      threads working on unrelated blocks rarely contend on the same  */
+/*      lock. A block is assigned to a shard from a hash of its band    */
+/*      and block coordinates.                                          */
+/* -------------------------------------------------------------------- */
 
-#if 0
-static CPLMutex *hRBLock = NULL;
-#define INITIALIZE_LOCK         CPLMutexHolderD( &hRBLock )
-#define TAKE_LOCK               CPLMutexHolderOptionalLockD( hRBLock )
-#define DESTROY_LOCK            CPLDestroyMutex( hRBLock )
-#else
+#define MAX_RB_CACHE_SHARDS     64
+
+/* -------------------------------------------------------------------- */
+/*      Replacement policy of the shards, selected once per process     */
+/*      with GDAL_RB_CACHE_POLICY.                                      */
+/*                                                                      */
+/*      LRU (default): a single least recently used list.               */
+/*                                                                      */
+/*      2Q: blocks requested for the first time go to the A1in FIFO     */
+/*      list, limited to a quarter of the shard budget. Blocks evicted  */
+/*      from A1in leave their key in the A1out ghost list, and are      */
+/*      promoted to the main LRU list (Am) if they are requested again  */
+/*      while still remembered there. So blocks read only once, such as */
+/*      in a full scan of a big raster, cannot evict the blocks of Am.  */
+/* -------------------------------------------------------------------- */
+
+#define RB_POLICY_LRU           0
+#define RB_POLICY_2Q            1
+
+/* List of the shard a block belongs to */
+#define RB_LIST_NONE            -1
+#define RB_LIST_MAIN            0   /* LRU list, or Am list in 2Q */
+#define RB_LIST_A1IN            1
+
+/* Budget of the A1in list, and of the A1out ghost list, as a fraction of */
+/* the shard budget */
+#define RB_2Q_A1IN_RATIO        0.25
+#define RB_2Q_A1OUT_RATIO       0.50
+
+typedef struct _GDALRBGhostEntry GDALRBGhostEntry;
+struct _GDALRBGhostEntry
+{
+    /* Only used as a key. Never dereferenced */
+    const GDALRasterBand *poBand;
+    int                   nXOff;
+    int                   nYOff;
+    int                   nSize;
+
+    GDALRBGhostEntry     *psOlder;
+    GDALRBGhostEntry     *psNewer;
+
+    /* Entries of the same band in the shard */
+    GDALRBGhostEntry     *psPrevOfBand;
+    GDALRBGhostEntry     *psNextOfBand;
+};
+
+typedef struct
+{
+    CPLLock            *hLock;
+    GDALRasterBlock    *poOldest;    /* tail */
+    GDALRasterBlock    *poNewest;    /* head */
+    volatile GIntBig    nCacheUsed;
+
+    /* A1in and A1out lists of the 2Q policy */
+    GDALRasterBlock    *poOldestA1In;
+    GDALRasterBlock    *poNewestA1In;
+    GIntBig             nCacheUsedA1In;
+    CPLHashSet         *hGhostSet;
+    GDALRBGhostEntry   *psOldestGhost;
+    GDALRBGhostEntry   *psNewestGhost;
+    GIntBig             nGhostSize;
+    /* First ghost entry of each band, so that they can be purged when */
+    /* the band is flushed or destroyed */
+    std::map<const GDALRasterBand*, GDALRBGhostEntry*> *poMapBandGhosts;
+
+    /* Statistics. Updated under hLock */
+    GIntBig             nHits;
+    GIntBig             nMisses;
+    GIntBig             nEvictions;
+} GDALRBCacheShard;
+
+static GDALRBCacheShard asShards[MAX_RB_CACHE_SHARDS];
+static int nShards = 0;
+static volatile int nFlushCacheBlockCalls = 0;
+static int nCachePolicy = -1;
 
-static CPLLock* hRBLock = NULL;
 static int bDebugContention = FALSE;
 static bool bSleepsForBockCacheDebug = false;
 static CPLLockType GetLockType()
@@ -75,12 +153,378 @@ static CPLLockType GetLockType()
     return (CPLLockType) nLockType;
 }
 
-#define INITIALIZE_LOCK         CPLLockHolderD( &hRBLock, GetLockType() ); \
-                                CPLLockSetDebugPerf(hRBLock, bDebugContention)
-#define TAKE_LOCK               CPLLockHolderOptionalLockD( hRBLock )
-#define DESTROY_LOCK            CPLDestroyLock( hRBLock )
+#define INITIALIZE_LOCK(psShard) CPLLockHolderD( &((psShard)->hLock), GetLockType() ); \
+                                 CPLLockSetDebugPerf((psShard)->hLock, bDebugContention)
+#define TAKE_LOCK(psShard)       CPLLockHolderOptionalLockD( (psShard)->hLock )
+#define DESTROY_LOCK(psShard)    CPLDestroyLock( (psShard)->hLock )
 
-#endif
+/************************************************************************/
+/*                           GetShardCount()                            */
+/*                                                                      */
+/*      The number of shards is read once from GDAL_RB_CACHE_SHARDS     */
+/*      and can no longer change afterwards, since blocks keep the      */
+/*      index of the shard they belong to.                              */
+/************************************************************************/
+
+static int GetShardCount()
+{
+    if( nShards == 0 )
+    {
+        int nCount = atoi(CPLGetConfigOption("GDAL_RB_CACHE_SHARDS", "1"));
+        if( nCount < 1 )
+            nCount = 1;
+        else if( nCount > MAX_RB_CACHE_SHARDS )
+        {
+            CPLError(CE_Warning, CPLE_NotSupported,
+                     "GDAL_RB_CACHE_SHARDS=%d is too large. Using %d",
+                     nCount, MAX_RB_CACHE_SHARDS);
+            nCount = MAX_RB_CACHE_SHARDS;
+        }
+        if( nCount > 1 )
+            CPLDebug("GDAL", "Using %d block cache shards", nCount);
+        nShards = nCount;
+    }
+    return nShards;
+}
+
+/************************************************************************/
+/*                           GetShardIndex()                            */
+/************************************************************************/
+
+static GUInt32 HashBlockKey( const GDALRasterBand* poBand,
+                             int nXOff, int nYOff )
+{
+    GUInt32 nHash = static_cast<GUInt32>(
+                        reinterpret_cast<size_t>(poBand) >> 4 );
+    nHash = nHash * 31 + static_cast<GUInt32>(nXOff);
+    nHash = nHash * 31 + static_cast<GUInt32>(nYOff);
+    /* Final mixing from MurmurHash3 so that neighbouring blocks are spread */
+    nHash ^= nHash >> 16;
+    nHash *= 0x85ebca6bU;
+    nHash ^= nHash >> 13;
+    nHash *= 0xc2b2ae35U;
+    nHash ^= nHash >> 16;
+    return nHash;
+}
+
+static int GetShardIndex( const GDALRasterBand* poBand, int nXOff, int nYOff )
+{
+    const int nCount = GetShardCount();
+    if( nCount == 1 )
+        return 0;
+
+    return static_cast<int>(HashBlockKey(poBand, nXOff, nYOff) %
+                            static_cast<GUInt32>(nCount));
+}
+
+/************************************************************************/
+/*                          GetShardCacheMax()                          */
+/************************************************************************/
+
+/* Each shard gets an equal share of the global budget */
+static GIntBig GetShardCacheMax( GIntBig nGlobalCacheMax )
+{
+    return nGlobalCacheMax / GetShardCount();
+}
+
+/************************************************************************/
+/*                           GetCachePolicy()                           */
+/************************************************************************/
+
+static int GetCachePolicy()
+{
+    if( nCachePolicy < 0 )
+    {
+        const char* pszPolicy = CPLGetConfigOption("GDAL_RB_CACHE_POLICY", "LRU");
+        if( EQUAL(pszPolicy, "LRU") )
+            nCachePolicy = RB_POLICY_LRU;
+        else if( EQUAL(pszPolicy, "2Q") )
+        {
+            CPLDebug("GDAL", "Using 2Q block cache replacement policy");
+            nCachePolicy = RB_POLICY_2Q;
+        }
+        else
+        {
+            CPLError(CE_Warning, CPLE_NotSupported,
+                     "GDAL_RB_CACHE_POLICY=%s not supported. Falling back to LRU",
+                     pszPolicy);
+            nCachePolicy = RB_POLICY_LRU;
+        }
+    }
+    return nCachePolicy;
+}
+
+/************************************************************************/
+/*                         Ghost list management                        */
+/*                                                                      */
+/*      The A1out ghost list of the 2Q policy is a FIFO of the keys of  */
+/*      the blocks recently evicted from the A1in list, indexed by a    */
+/*      hash set, and chained per band so that the entries of a band    */
+/*      can be purged when it is flushed. It must be manipulated under  */
+/*      the lock of the shard.                                          */
+/************************************************************************/
+
+static unsigned long GhostEntryHash( const void* elt )
+{
+    const GDALRBGhostEntry* psEntry =
+        static_cast<const GDALRBGhostEntry*>(elt);
+    return HashBlockKey(psEntry->poBand, psEntry->nXOff, psEntry->nYOff);
+}
+
+static int GhostEntryEqual( const void* elt1, const void* elt2 )
+{
+    const GDALRBGhostEntry* psEntry1 =
+        static_cast<const GDALRBGhostEntry*>(elt1);
+    const GDALRBGhostEntry* psEntry2 =
+        static_cast<const GDALRBGhostEntry*>(elt2);
+    return psEntry1->poBand == psEntry2->poBand &&
+           psEntry1->nXOff == psEntry2->nXOff &&
+           psEntry1->nYOff == psEntry2->nYOff;
+}
+
+static void RemoveGhostEntry( GDALRBCacheShard* psShard,
+                              GDALRBGhostEntry* psEntry )
+{
+    if( psEntry->psOlder )
+        psEntry->psOlder->psNewer = psEntry->psNewer;
+    else
+        psShard->psOldestGhost = psEntry->psNewer;
+    if( psEntry->psNewer )
+        psEntry->psNewer->psOlder = psEntry->psOlder;
+    else
+        psShard->psNewestGhost = psEntry->psOlder;
+
+    if( psEntry->psNextOfBand )
+        psEntry->psNextOfBand->psPrevOfBand = psEntry->psPrevOfBand;
+    if( psEntry->psPrevOfBand )
+        psEntry->psPrevOfBand->psNextOfBand = psEntry->psNextOfBand;
+    else if( psEntry->psNextOfBand )
+        (*psShard->poMapBandGhosts)[psEntry->poBand] = psEntry->psNextOfBand;
+    else
+        psShard->poMapBandGhosts->erase(psEntry->poBand);
+
+    psShard->nGhostSize -= psEntry->nSize;
+    CPLHashSetRemove(psShard->hGhostSet, psEntry);
+    CPLFree(psEntry);
+}
+
+static void AddGhostEntry( GDALRBCacheShard* psShard,
+                           const GDALRasterBand* poBand,
+                           int nXOff, int nYOff, int nSize )
+{
+    if( psShard->hGhostSet == NULL )
+    {
+        psShard->hGhostSet = CPLHashSetNew(GhostEntryHash, GhostEntryEqual,
+                                           NULL);
+        psShard->poMapBandGhosts =
+            new std::map<const GDALRasterBand*, GDALRBGhostEntry*>();
+    }
+
+    GDALRBGhostEntry* psEntry = static_cast<GDALRBGhostEntry*>(
+        VSI_MALLOC_VERBOSE(sizeof(GDALRBGhostEntry)));
+    if( psEntry == NULL )
+        return;
+    psEntry->poBand = poBand;
+    psEntry->nXOff = nXOff;
+    psEntry->nYOff = nYOff;
+    psEntry->nSize = nSize;
+    psEntry->psOlder = psShard->psNewestGhost;
+    psEntry->psNewer = NULL;
+
+    GDALRBGhostEntry* psExisting = static_cast<GDALRBGhostEntry*>(
+        CPLHashSetLookup(psShard->hGhostSet, psEntry));
+    if( psExisting != NULL )
+        RemoveGhostEntry(psShard, psExisting);
+
+    if( psShard->psNewestGhost )
+        psShard->psNewestGhost->psNewer = psEntry;
+    else
+        psShard->psOldestGhost = psEntry;
+    psShard->psNewestGhost = psEntry;
+    psShard->nGhostSize += nSize;
+    CPLHashSetInsert(psShard->hGhostSet, psEntry);
+
+    GDALRBGhostEntry*& psFirstOfBand = (*psShard->poMapBandGhosts)[poBand];
+    psEntry->psPrevOfBand = NULL;
+    psEntry->psNextOfBand = psFirstOfBand;
+    if( psFirstOfBand )
+        psFirstOfBand->psPrevOfBand = psEntry;
+    psFirstOfBand = psEntry;
+
+    const GIntBig nGhostMax = static_cast<GIntBig>(
+        GetShardCacheMax(nCacheMax) * RB_2Q_A1OUT_RATIO);
+    while( psShard->nGhostSize > nGhostMax &&
+           psShard->psOldestGhost != NULL )
+    {
+        RemoveGhostEntry(psShard, psShard->psOldestGhost);
+    }
+}
+
+/* Returns whether the key of the block was in the ghost list, and */
+/* forgets it */
+static bool TakeGhostEntry( GDALRBCacheShard* psShard,
+                            const GDALRasterBand* poBand,
+                            int nXOff, int nYOff )
+{
+    if( psShard->hGhostSet == NULL )
+        return false;
+
+    GDALRBGhostEntry sKey;
+    sKey.poBand = poBand;
+    sKey.nXOff = nXOff;
+    sKey.nYOff = nYOff;
+    GDALRBGhostEntry* psEntry = static_cast<GDALRBGhostEntry*>(
+        CPLHashSetLookup(psShard->hGhostSet, &sKey));
+    if( psEntry == NULL )
+        return false;
+    RemoveGhostEntry(psShard, psEntry);
+    return true;
+}
+
+/************************************************************************/
+/*                       Compressed cache tier                          */
+/*                                                                      */
+/*      Optional second tier of the cache, holding the data of clean    */
+/*      blocks of read-only bands evicted from the shards, compressed   */
+/*      with DEFLATE at its fastest level. It is disabled unless a      */
+/*      budget is set with GDAL_RB_COMPRESSED_CACHEMAX or               */
+/*      GDALSetCompressedCacheMax64(). Requesting such a block again    */
+/*      then costs a decompression instead of a read from the dataset. */
+/*      Entries are indexed by a hash set, chained per band so that     */
+/*      the entries of a band can be dropped when it is flushed, and    */
+/*      evicted in least recently stored order. They must be            */
+/*      manipulated under the lock of the tier.                         */
+/************************************************************************/
+
+typedef struct _GDALRBCompressedEntry GDALRBCompressedEntry;
+struct _GDALRBCompressedEntry
+{
+    /* Only used as a key. Never dereferenced */
+    const GDALRasterBand   *poBand;
+    int                     nXOff;
+    int                     nYOff;
+
+    GByte                  *pabyData;
+    size_t                  nDataSize;
+
+    GDALRBCompressedEntry  *psOlder;
+    GDALRBCompressedEntry  *psNewer;
+
+    /* Entries of the same band */
+    GDALRBCompressedEntry  *psPrevOfBand;
+    GDALRBCompressedEntry  *psNextOfBand;
+};
+
+typedef struct
+{
+    CPLLock                *hLock;
+    CPLHashSet             *hSet;
+    GDALRBCompressedEntry  *psOldest;
+    GDALRBCompressedEntry  *psNewest;
+    volatile GIntBig        nCacheUsed;
+    /* First entry of each band */
+    std::map<const GDALRasterBand*, GDALRBCompressedEntry*> *poMapBandEntries;
+
+    /* Statistics. Updated under hLock */
+    GIntBig                 nHits;
+    GIntBig                 nMisses;
+} GDALRBCompressedCache;
+
+static GDALRBCompressedCache sCompressedCache;
+static bool bCompressedCacheMaxInitialized = false;
+static GIntBig nCompressedCacheMax = 0;
+
+/* DEFLATE level used to compress blocks: favour speed over ratio */
+#define RB_COMPRESSED_CACHE_LEVEL   1
+
+static GIntBig GetCompressedCacheMax()
+{
+    if( !bCompressedCacheMaxInitialized )
+    {
+        INITIALIZE_LOCK(&sCompressedCache);
+
+        const char* pszCacheMax =
+            CPLGetConfigOption("GDAL_RB_COMPRESSED_CACHEMAX", "0");
+        GIntBig nNewCacheMax = CPLAtoGIntBig(pszCacheMax);
+        if( nNewCacheMax < 0 )
+        {
+            CPLError(CE_Failure, CPLE_NotSupported,
+                     "Invalid value for GDAL_RB_COMPRESSED_CACHEMAX. "
+                     "Disabling the compressed cache.");
+            nNewCacheMax = 0;
+        }
+        else if( nNewCacheMax < 100000 )
+        {
+            nNewCacheMax *= 1024 * 1024;
+        }
+        nCompressedCacheMax = nNewCacheMax;
+        bCompressedCacheMaxInitialized = true;
+    }
+    return nCompressedCacheMax;
+}
+
+static unsigned long CompressedEntryHash( const void* elt )
+{
+    const GDALRBCompressedEntry* psEntry =
+        static_cast<const GDALRBCompressedEntry*>(elt);
+    return HashBlockKey(psEntry->poBand, psEntry->nXOff, psEntry->nYOff);
+}
+
+static int CompressedEntryEqual( const void* elt1, const void* elt2 )
+{
+    const GDALRBCompressedEntry* psEntry1 =
+        static_cast<const GDALRBCompressedEntry*>(elt1);
+    const GDALRBCompressedEntry* psEntry2 =
+        static_cast<const GDALRBCompressedEntry*>(elt2);
+    return psEntry1->poBand == psEntry2->poBand &&
+           psEntry1->nXOff == psEntry2->nXOff &&
+           psEntry1->nYOff == psEntry2->nYOff;
+}
+
+/* Remove the entry from the tier, and return it to the caller that must */
+/* free it with FreeCompressedEntry() */
+static GDALRBCompressedEntry* UnlinkCompressedEntry(
+                                        GDALRBCompressedEntry* psEntry )
+{
+    if( psEntry->psOlder )
+        psEntry->psOlder->psNewer = psEntry->psNewer;
+    else
+        sCompressedCache.psOldest = psEntry->psNewer;
+    if( psEntry->psNewer )
+        psEntry->psNewer->psOlder = psEntry->psOlder;
+    else
+        sCompressedCache.psNewest = psEntry->psOlder;
+
+    if( psEntry->psNextOfBand )
+        psEntry->psNextOfBand->psPrevOfBand = psEntry->psPrevOfBand;
+    if( psEntry->psPrevOfBand )
+        psEntry->psPrevOfBand->psNextOfBand = psEntry->psNextOfBand;
+    else if( psEntry->psNextOfBand )
+        (*sCompressedCache.poMapBandEntries)[psEntry->poBand] =
+            psEntry->psNextOfBand;
+    else
+        sCompressedCache.poMapBandEntries->erase(psEntry->poBand);
+
+    sCompressedCache.nCacheUsed -= psEntry->nDataSize;
+    CPLHashSetRemove(sCompressedCache.hSet, psEntry);
+    return psEntry;
+}
+
+static void FreeCompressedEntry( GDALRBCompressedEntry* psEntry )
+{
+    VSIFree(psEntry->pabyData);
+    CPLFree(psEntry);
+}
+
+/* Evict the oldest entries till the tier is within nMax bytes */
+static void TrimCompressedCache_unlocked( GIntBig nMax )
+{
+    while( sCompressedCache.nCacheUsed > nMax &&
+           sCompressedCache.psOldest != NULL )
+    {
+        FreeCompressedEntry(UnlinkCompressedEntry(sCompressedCache.psOldest));
+    }
+}
 
 //#define ENABLE_DEBUG
 
@@ -138,24 +582,27 @@ void CPL_STDCALL GDALSetCacheMax64( GIntBig nNewSizeInBytes )
     }
 #endif
 
+    const int nCount = GetShardCount();
+    for( int iShard = 0; iShard < nCount; iShard++ )
     {
-        INITIALIZE_LOCK;
-    }   
+        INITIALIZE_LOCK(&asShards[iShard]);
+    }
     bCacheMaxInitialized = true;
     nCacheMax = nNewSizeInBytes;
 
 /* -------------------------------------------------------------------- */
-/*      Flush blocks till we are under the new limit or till we         */
+/*      Flush blocks till each shard is under its new limit or till we  */
 /*      can't seem to flush anymore.                                    */
 /* -------------------------------------------------------------------- */
-    while( nCacheUsed > nCacheMax )
+    const GIntBig nShardCacheMax = GetShardCacheMax(nCacheMax);
+    for( int iShard = 0; iShard < nCount; iShard++ )
     {
-        GIntBig nOldCacheUsed = nCacheUsed;
-
-        GDALFlushCacheBlock();
-
-        if( nCacheUsed == nOldCacheUsed )
-            break;
+        GDALRBCacheShard* psShard = &asShards[iShard];
+        while( psShard->nCacheUsed > nShardCacheMax )
+        {
+            if( !GDALRasterBlock::FlushCacheBlockFromShard(iShard, FALSE) )
+                break;
+        }
     }
 }
 
@@ -224,10 +671,13 @@ GIntBig CPL_STDCALL GDALGetCacheMax64()
 {
     if( !bCacheMaxInitialized )
     {
+        const int nCount = GetShardCount();
+        for( int iShard = 0; iShard < nCount; iShard++ )
         {
-            INITIALIZE_LOCK;
+            INITIALIZE_LOCK(&asShards[iShard]);
         }
         bSleepsForBockCacheDebug = CPLTestBool(CPLGetConfigOption("GDAL_DEBUG_BLOCK_CACHE", "NO"));
+        GetCachePolicy();
 
         const char* pszCacheMax = CPLGetConfigOption("GDAL_CACHEMAX","5%");
 
@@ -289,6 +739,7 @@ GIntBig CPL_STDCALL GDALGetCacheMax64()
 
 int CPL_STDCALL GDALGetCacheUsed()
 {
+    GIntBig nCacheUsed = GDALGetCacheUsed64();
     if (nCacheUsed > INT_MAX)
     {
         static bool bHasWarned = false;
@@ -319,9 +770,193 @@ int CPL_STDCALL GDALGetCacheUsed()
 
 GIntBig CPL_STDCALL GDALGetCacheUsed64()
 {
+    GIntBig nCacheUsed = 0;
+    const int nCount = GetShardCount();
+    for( int iShard = 0; iShard < nCount; iShard++ )
+        nCacheUsed += asShards[iShard].nCacheUsed;
     return nCacheUsed;
 }
 
+/************************************************************************/
+/*                       GDALGetCacheShardCount()                       */
+/************************************************************************/
+
+/**
+ * \brief Get the number of shards of the raster block cache.
+ *
+ * The block cache is split into the number of shards specified by the
+ * GDAL_RB_CACHE_SHARDS configuration option (1 by default), each with its
+ * own lock, least recently used list and an equal share of the budget set
+ * with GDALSetCacheMax64(). The option must be set before the first
+ * block is cached and cannot be changed afterwards.
+ *
+ * @return the number of shards (at least 1).
+ *
+ * @since GDAL 2.2
+ */
+
+int CPL_STDCALL GDALGetCacheShardCount()
+{
+    return GetShardCount();
+}
+
+/************************************************************************/
+/*                    GDALGetCacheShardStatistics()                     */
+/************************************************************************/
+
+/**
+ * \brief Get usage statistics of a shard of the raster block cache.
+ *
+ * A hit is counted each time a block already in the cache is requested, a
+ * miss each time a block must be allocated in the cache, and an eviction
+ * each time a block is removed from the cache to make room for another one
+ * or by GDALFlushCacheBlock().
+ *
+ * @param iShard index of the shard, between 0 and GDALGetCacheShardCount()-1.
+ * @param pnCacheUsed pointer to the number of bytes cached, or NULL.
+ * @param pnHits pointer to the number of hits, or NULL.
+ * @param pnMisses pointer to the number of misses, or NULL.
+ * @param pnEvictions pointer to the number of evictions, or NULL.
+ *
+ * @return TRUE on success, or FALSE if iShard is invalid.
+ *
+ * @since GDAL 2.2
+ */
+
+int CPL_STDCALL GDALGetCacheShardStatistics( int iShard,
+                                             GIntBig* pnCacheUsed,
+                                             GIntBig* pnHits,
+                                             GIntBig* pnMisses,
+                                             GIntBig* pnEvictions )
+{
+    if( iShard < 0 || iShard >= GetShardCount() )
+    {
+        CPLError(CE_Failure, CPLE_IllegalArg,
+                 "Invalid shard index: %d", iShard);
+        return FALSE;
+    }
+
+    GDALRBCacheShard* psShard = &asShards[iShard];
+    TAKE_LOCK(psShard);
+    if( pnCacheUsed )
+        *pnCacheUsed = psShard->nCacheUsed;
+    if( pnHits )
+        *pnHits = psShard->nHits;
+    if( pnMisses )
+        *pnMisses = psShard->nMisses;
+    if( pnEvictions )
+        *pnEvictions = psShard->nEvictions;
+    return TRUE;
+}
+
+/************************************************************************/
+/*                     GDALSetCompressedCacheMax()                      */
+/************************************************************************/
+
+/**
+ * \brief Set maximum memory of the compressed cache tier.
+ *
+ * Same as GDALSetCompressedCacheMax64(), but limited to 2GB.
+ *
+ * @param nNewSizeInBytes the maximum number of bytes of compressed data.
+ *
+ * @since GDAL 2.2
+ */
+
+void CPL_STDCALL GDALSetCompressedCacheMax( int nNewSizeInBytes )
+
+{
+    GDALSetCompressedCacheMax64(nNewSizeInBytes);
+}
+
+/************************************************************************/
+/*                    GDALSetCompressedCacheMax64()                     */
+/************************************************************************/
+
+/**
+ * \brief Set maximum memory of the compressed cache tier.
+ *
+ * When a clean block of a band opened in read-only mode is evicted from the
+ * raster block cache, its data can be kept in a second tier, compressed
+ * with DEFLATE at the fastest level, so that requesting it again only
+ * requires decompressing it instead of reading it from the dataset.
+ * This is mostly useful when the budget set with GDALSetCacheMax64() is
+ * small compared to the working set, and when decoding blocks is expensive.
+ *
+ * The tier is disabled by default. The first time this function or
+ * GDALGetCompressedCacheMax64() is called, the initial budget is read from
+ * the GDAL_RB_COMPRESSED_CACHEMAX configuration option, as a value in MB
+ * (or in bytes if greater than 100000). Setting the budget to 0 disables
+ * the tier and releases its content.
+ *
+ * @param nNewSizeInBytes the maximum number of bytes of compressed data.
+ *
+ * @since GDAL 2.2
+ */
+
+void CPL_STDCALL GDALSetCompressedCacheMax64( GIntBig nNewSizeInBytes )
+
+{
+    GetCompressedCacheMax();
+
+    TAKE_LOCK(&sCompressedCache);
+    nCompressedCacheMax = std::max(nNewSizeInBytes, static_cast<GIntBig>(0));
+    TrimCompressedCache_unlocked(nCompressedCacheMax);
+}
+
+/************************************************************************/
+/*                    GDALGetCompressedCacheMax64()                     */
+/************************************************************************/
+
+/**
+ * \brief Get maximum memory of the compressed cache tier.
+ *
+ * See GDALSetCompressedCacheMax64().
+ *
+ * @return maximum in bytes, or 0 if the tier is disabled.
+ *
+ * @since GDAL 2.2
+ */
+
+GIntBig CPL_STDCALL GDALGetCompressedCacheMax64()
+{
+    return GetCompressedCacheMax();
+}
+
+/************************************************************************/
+/*                  GDALGetCompressedCacheStatistics()                  */
+/************************************************************************/
+
+/**
+ * \brief Get usage statistics of the compressed cache tier.
+ *
+ * A hit is counted each time a block missing from the raster block cache is
+ * restored from the compressed tier, and a miss each time it must be read
+ * from its dataset instead, while the tier is enabled.
+ *
+ * @param pnCacheUsed pointer to the number of bytes of compressed data, or
+ *                    NULL.
+ * @param pnHits pointer to the number of hits, or NULL.
+ * @param pnMisses pointer to the number of misses, or NULL.
+ *
+ * @since GDAL 2.2
+ */
+
+void CPL_STDCALL GDALGetCompressedCacheStatistics( GIntBig* pnCacheUsed,
+                                                   GIntBig* pnHits,
+                                                   GIntBig* pnMisses )
+{
+    GetCompressedCacheMax();
+
+    TAKE_LOCK(&sCompressedCache);
+    if( pnCacheUsed )
+        *pnCacheUsed = sCompressedCache.nCacheUsed;
+    if( pnHits )
+        *pnHits = sCompressedCache.nHits;
+    if( pnMisses )
+        *pnMisses = sCompressedCache.nMisses;
+}
+
 /************************************************************************/
 /*                        GDALFlushCacheBlock()                         */
 /*                                                                      */
@@ -358,6 +993,13 @@ int CPL_STDCALL GDALFlushCacheBlock()
  * across zero or more GDALDataset objects in a global raster cache with
  * a least recently used (LRU) list and an upper cache limit (see
  * GDALSetCacheMax()) under which the cache size is normally kept.
+ * The global cache may be split into several independent shards (see
+ * GDALGetCacheShardCount()), each having its own LRU list. The
+ * GDAL_RB_CACHE_POLICY configuration option can be set to 2Q instead of
+ * the default LRU, so that blocks that are only used once, for example
+ * during a full scan of a big raster, do not evict blocks that are used
+ * repeatedly. Clean blocks evicted from the cache can optionally be kept
+ * in a compressed form in a second tier (see GDALSetCompressedCacheMax64()).
  *
  * Some blocks in the cache may be modified relative to the state on disk
  * (they are marked "Dirty") and must be flushed to disk before they can
@@ -399,21 +1041,35 @@ int CPL_STDCALL GDALFlushCacheBlock()
 int GDALRasterBlock::FlushCacheBlock(int bDirtyBlocksOnly)
 
 {
+    // Start from a different shard at each call, so that all of them are
+    // trimmed in turn. FlushCacheBlock() can be called by several threads.
+    const int nCount = GetShardCount();
+    const int iFirstShard = static_cast<int>(
+        static_cast<unsigned int>(CPLAtomicInc(&nFlushCacheBlockCalls)) %
+        static_cast<unsigned int>(nCount));
+
+    for( int i = 0; i < nCount; i++ )
+    {
+        if( FlushCacheBlockFromShard((iFirstShard + i) % nCount,
+                                     bDirtyBlocksOnly) )
+            return TRUE;
+    }
+    return FALSE;
+}
+
+/************************************************************************/
+/*                      FlushCacheBlockFromShard()                      */
+/************************************************************************/
+
+int GDALRasterBlock::FlushCacheBlockFromShard(int iShard, int bDirtyBlocksOnly)
+
+{
+    GDALRBCacheShard* psShard = &asShards[iShard];
     GDALRasterBlock *poTarget;
 
     {
-        INITIALIZE_LOCK;
-        poTarget = poOldest;
-
-        while( poTarget != NULL )
-        {
-            if( !bDirtyBlocksOnly || poTarget->GetDirty() )
-            {
-                if( CPLAtomicCompareAndExchange(&(poTarget->nLockCount), 0, -1) )
-                    break;
-            }
-            poTarget = poTarget->poPrevious;
-        }
+        INITIALIZE_LOCK(psShard);
+        poTarget = SelectBlockToEvict_unlocked(iShard, bDirtyBlocksOnly);
 
         if( poTarget == NULL )
             return FALSE;
@@ -427,6 +1083,21 @@ int GDALRasterBlock::FlushCacheBlock(int bDirtyBlocksOnly)
     if( bSleepsForBockCacheDebug )
         CPLSleep(CPLAtof(CPLGetConfigOption("GDAL_RB_FLUSHBLOCK_SLEEP_AFTER_RB_LOCK", "0")));
 
+    FreeEvictedBlock(poTarget);
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                          FreeEvictedBlock()                          */
+/*                                                                      */
+/*      Write a block that has been detached and unreferenced from its  */
+/*      band if it is dirty, or keep a compressed copy of it if it is   */
+/*      clean, free its data and pass it back to its band.              */
+/************************************************************************/
+
+void GDALRasterBlock::FreeEvictedBlock( GDALRasterBlock* poTarget )
+{
     if( poTarget->GetDirty() )
     {
         CPLErr eErr = poTarget->Write();
@@ -436,12 +1107,353 @@ int GDALRasterBlock::FlushCacheBlock(int bDirtyBlocksOnly)
             poTarget->GetBand()->SetFlushBlockErr(eErr);
         }
     }
+    else
+    {
+        poTarget->StoreInCompressedCache();
+    }
 
     VSIFree(poTarget->pData);
     poTarget->pData = NULL;
     poTarget->GetBand()->AddBlockToFreeList(poTarget);
+}
 
-    return TRUE;
+/************************************************************************/
+/*                       StoreInCompressedCache()                       */
+/*                                                                      */
+/*      Keep a compressed copy of the data of a block that has been     */
+/*      detached and unreferenced from its band, if the compressed      */
+/*      tier is enabled and the block can be restored as is.            */
+/************************************************************************/
+
+void GDALRasterBlock::StoreInCompressedCache()
+{
+    if( pData == NULL || bDirty || GetCompressedCacheMax() == 0 ||
+        poBand->GetAccess() != GA_ReadOnly )
+        return;
+
+    const int nSizeInBytes = GetBlockSize();
+    if( nSizeInBytes > nCompressedCacheMax )
+        return;
+
+    // Blocks that do not shrink are not worth keeping
+    GByte* pabyCompressed = static_cast<GByte*>(VSIMalloc(nSizeInBytes));
+    if( pabyCompressed == NULL )
+        return;
+    size_t nCompressedSize = 0;
+    if( CPLZLibDeflate(pData, nSizeInBytes, RB_COMPRESSED_CACHE_LEVEL,
+                       pabyCompressed, nSizeInBytes,
+                       &nCompressedSize) == NULL )
+    {
+        VSIFree(pabyCompressed);
+        return;
+    }
+    GByte* pabyShrunk = static_cast<GByte*>(
+        VSIRealloc(pabyCompressed, nCompressedSize));
+    if( pabyShrunk != NULL )
+        pabyCompressed = pabyShrunk;
+
+    GDALRBCompressedEntry* psEntry = static_cast<GDALRBCompressedEntry*>(
+        VSI_MALLOC_VERBOSE(sizeof(GDALRBCompressedEntry)));
+    if( psEntry == NULL )
+    {
+        VSIFree(pabyCompressed);
+        return;
+    }
+    psEntry->poBand = poBand;
+    psEntry->nXOff = nXOff;
+    psEntry->nYOff = nYOff;
+    psEntry->pabyData = pabyCompressed;
+    psEntry->nDataSize = nCompressedSize;
+    psEntry->psNewer = NULL;
+
+    TAKE_LOCK(&sCompressedCache);
+    if( sCompressedCache.hSet == NULL )
+    {
+        sCompressedCache.hSet = CPLHashSetNew(CompressedEntryHash,
+                                              CompressedEntryEqual, NULL);
+        sCompressedCache.poMapBandEntries =
+            new std::map<const GDALRasterBand*, GDALRBCompressedEntry*>();
+    }
+
+    GDALRBCompressedEntry* psExisting = static_cast<GDALRBCompressedEntry*>(
+        CPLHashSetLookup(sCompressedCache.hSet, psEntry));
+    if( psExisting != NULL )
+        FreeCompressedEntry(UnlinkCompressedEntry(psExisting));
+
+    psEntry->psOlder = sCompressedCache.psNewest;
+    if( sCompressedCache.psNewest )
+        sCompressedCache.psNewest->psNewer = psEntry;
+    else
+        sCompressedCache.psOldest = psEntry;
+    sCompressedCache.psNewest = psEntry;
+    sCompressedCache.nCacheUsed += nCompressedSize;
+    CPLHashSetInsert(sCompressedCache.hSet, psEntry);
+
+    GDALRBCompressedEntry*& psFirstOfBand =
+        (*sCompressedCache.poMapBandEntries)[poBand];
+    psEntry->psPrevOfBand = NULL;
+    psEntry->psNextOfBand = psFirstOfBand;
+    if( psFirstOfBand )
+        psFirstOfBand->psPrevOfBand = psEntry;
+    psFirstOfBand = psEntry;
+
+    TrimCompressedCache_unlocked(nCompressedCacheMax);
+}
+
+/************************************************************************/
+/*                     RestoreFromCompressedCache()                     */
+/************************************************************************/
+
+/**
+ * \brief Restore the data of the block from the compressed cache tier.
+ *
+ * Should only be called by GDALRasterBand::GetLockedBlockRef(), on a block
+ * that has just been internalized. The copy of the block in the compressed
+ * tier, if any, is removed from it.
+ *
+ * @param bRestoreData FALSE if the content of the block is going to be
+ *                     initialized by the caller, in which case only the
+ *                     stale copy is discarded.
+ *
+ * @return TRUE if the data of the block has been restored.
+ *
+ * @since GDAL 2.2
+ */
+
+int GDALRasterBlock::RestoreFromCompressedCache( int bRestoreData )
+{
+    if( sCompressedCache.nCacheUsed == 0 && GetCompressedCacheMax() == 0 )
+        return FALSE;
+
+    GDALRBCompressedEntry* psEntry = NULL;
+    {
+        TAKE_LOCK(&sCompressedCache);
+        if( sCompressedCache.hSet != NULL )
+        {
+            GDALRBCompressedEntry sKey;
+            sKey.poBand = poBand;
+            sKey.nXOff = nXOff;
+            sKey.nYOff = nYOff;
+            psEntry = static_cast<GDALRBCompressedEntry*>(
+                CPLHashSetLookup(sCompressedCache.hSet, &sKey));
+            if( psEntry != NULL )
+                UnlinkCompressedEntry(psEntry);
+        }
+        if( bRestoreData )
+        {
+            if( psEntry != NULL )
+                sCompressedCache.nHits++;
+            else
+                sCompressedCache.nMisses++;
+        }
+    }
+
+    if( psEntry == NULL )
+        return FALSE;
+
+    int bRet = FALSE;
+    if( bRestoreData && pData != NULL )
+    {
+        const size_t nSizeInBytes = GetBlockSize();
+        size_t nOutBytes = 0;
+        bRet = CPLZLibInflate(psEntry->pabyData, psEntry->nDataSize,
+                              pData, nSizeInBytes, &nOutBytes) != NULL &&
+               nOutBytes == nSizeInBytes;
+    }
+    FreeCompressedEntry(psEntry);
+    return bRet;
+}
+
+/************************************************************************/
+/*                        DropCompressedBlocks()                        */
+/************************************************************************/
+
+/**
+ * \brief Discard the blocks of a band from the compressed cache tier.
+ *
+ * Should only be called by GDALRasterBand::FlushCache(), which the
+ * GDALRasterBand destructor also goes through, once no block of the band
+ * can be evicted anymore.
+ *
+ * @param poBand the band.
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALRasterBlock::DropCompressedBlocks( GDALRasterBand* poBand )
+{
+    if( sCompressedCache.nCacheUsed == 0 )
+        return;
+
+    TAKE_LOCK(&sCompressedCache);
+    if( sCompressedCache.poMapBandEntries == NULL )
+        return;
+    std::map<const GDALRasterBand*, GDALRBCompressedEntry*>::iterator oIter =
+        sCompressedCache.poMapBandEntries->find(poBand);
+    if( oIter == sCompressedCache.poMapBandEntries->end() )
+        return;
+    GDALRBCompressedEntry* psEntry = oIter->second;
+    while( psEntry != NULL )
+    {
+        GDALRBCompressedEntry* psNext = psEntry->psNextOfBand;
+        FreeCompressedEntry(UnlinkCompressedEntry(psEntry));
+        psEntry = psNext;
+    }
+}
+
+/************************************************************************/
+/*                          DropGhostEntries()                          */
+/************************************************************************/
+
+/**
+ * \brief Forget the blocks of a band remembered by the 2Q cache policy.
+ *
+ * The ghost list of the 2Q policy only keeps the keys of recently evicted
+ * blocks. Once the band is flushed, those keys are stale, and could even
+ * match the blocks of another band later allocated at the same address.
+ * Should only be called by GDALRasterBand::FlushCache().
+ *
+ * @param poBand the band.
+ *
+ * @since GDAL 2.2
+ */
+
+void GDALRasterBlock::DropGhostEntries( GDALRasterBand* poBand )
+{
+    if( nCachePolicy != RB_POLICY_2Q )
+        return;
+
+    const int nCount = GetShardCount();
+    for( int iShard = 0; iShard < nCount; iShard++ )
+    {
+        GDALRBCacheShard* psShard = &asShards[iShard];
+        TAKE_LOCK(psShard);
+        if( psShard->poMapBandGhosts == NULL )
+            continue;
+        std::map<const GDALRasterBand*, GDALRBGhostEntry*>::iterator oIter =
+            psShard->poMapBandGhosts->find(poBand);
+        if( oIter == psShard->poMapBandGhosts->end() )
+            continue;
+        GDALRBGhostEntry* psEntry = oIter->second;
+        while( psEntry != NULL )
+        {
+            GDALRBGhostEntry* psNext = psEntry->psNextOfBand;
+            RemoveGhostEntry(psShard, psEntry);
+            psEntry = psNext;
+        }
+    }
+}
+
+/************************************************************************/
+/*                      FlushDatasetExcessBlocks()                      */
+/************************************************************************/
+
+/**
+ * \brief Flush blocks of a dataset until it is within its cache quota.
+ *
+ * The least recently used blocks of the dataset are evicted until the
+ * size of its cached blocks is within the limit set with
+ * GDALDataset::SetBlockCacheMax(), or until no more blocks can be flushed.
+ *
+ * @param poDS the dataset.
+ * @since GDAL 2.2
+ */
+
+void GDALRasterBlock::FlushDatasetExcessBlocks( GDALDataset* poDS )
+
+{
+    const int nCount = GetShardCount();
+    for( int iShard = 0;
+         iShard < nCount && poDS->IsBlockCacheQuotaExceeded();
+         iShard++ )
+    {
+        GDALRBCacheShard* psShard = &asShards[iShard];
+        int nBlocksToFree;
+        do
+        {
+            GDALRasterBlock* apoBlocksToFree[64];
+            nBlocksToFree = 0;
+            {
+                TAKE_LOCK(psShard);
+                while( nBlocksToFree < 64 &&
+                       poDS->IsBlockCacheQuotaExceeded() )
+                {
+                    GDALRasterBlock* poTarget =
+                        SelectBlockToEvict_unlocked(iShard, FALSE, poDS);
+                    if( poTarget == NULL )
+                        break;
+
+                    poTarget->Detach_unlocked();
+                    poTarget->GetBand()->UnreferenceBlock(poTarget);
+
+                    apoBlocksToFree[nBlocksToFree++] = poTarget;
+                    // Only free one dirty block at a time, as in Internalize()
+                    if( poTarget->GetDirty() )
+                        break;
+                }
+            }
+
+            for( int i = 0; i < nBlocksToFree; i++ )
+                FreeEvictedBlock(apoBlocksToFree[i]);
+        }
+        while( nBlocksToFree > 0 && poDS->IsBlockCacheQuotaExceeded() );
+    }
+}
+
+/************************************************************************/
+/*                    SelectBlockToEvict_unlocked()                     */
+/*                                                                      */
+/*      Find the least recently used block of the shard that is not     */
+/*      locked, and mark it as being evicted (lock count of -1). With   */
+/*      the 2Q policy, the A1in list is drained first when it exceeds   */
+/*      its budget, and the key of blocks evicted from it is added to   */
+/*      the ghost list. If poDS is not NULL, only blocks of bands of    */
+/*      that dataset are considered. Must be called under the lock of   */
+/*      the shard.                                                      */
+/************************************************************************/
+
+GDALRasterBlock* GDALRasterBlock::SelectBlockToEvict_unlocked(
+                                        int iShard, int bDirtyBlocksOnly,
+                                        GDALDataset* poDS )
+{
+    GDALRBCacheShard* psShard = &asShards[iShard];
+
+    GDALRasterBlock* apoOldest[2] = { psShard->poOldest,
+                                      psShard->poOldestA1In };
+    if( psShard->nCacheUsedA1In >
+            GetShardCacheMax(nCacheMax) * RB_2Q_A1IN_RATIO )
+    {
+        std::swap(apoOldest[0], apoOldest[1]);
+    }
+
+    for( int i = 0; i < 2; i++ )
+    {
+        GDALRasterBlock* poTarget = apoOldest[i];
+        while( poTarget != NULL )
+        {
+            if( (!bDirtyBlocksOnly || poTarget->GetDirty()) &&
+                (poDS == NULL || poTarget->poBand->GetDataset() == poDS) )
+            {
+                if( CPLAtomicCompareAndExchange(&(poTarget->nLockCount), 0, -1) )
+                    break;
+            }
+            poTarget = poTarget->poPrevious;
+        }
+
+        if( poTarget != NULL )
+        {
+            psShard->nEvictions++;
+            if( poTarget->nCacheList == RB_LIST_A1IN )
+            {
+                AddGhostEntry(psShard, poTarget->poBand,
+                              poTarget->nXOff, poTarget->nYOff,
+                              poTarget->GetBlockSize());
+            }
+            return poTarget;
+        }
+    }
+
+    return NULL;
 }
 
 /************************************************************************/
@@ -508,6 +1520,8 @@ GDALRasterBlock::GDALRasterBlock( GDALRasterBand *poBandIn,
 
     nXOff = nXOffIn;
     nYOff = nYOffIn;
+    nShard = GetShardIndex(poBand, nXOff, nYOff);
+    nCacheList = RB_LIST_NONE;
     bMustDetach = TRUE;
 }
 
@@ -543,6 +1557,8 @@ GDALRasterBlock::GDALRasterBlock( int nXOffIn, int nYOffIn )
 
     nXOff = nXOffIn;
     nYOff = nYOffIn;
+    nShard = 0;
+    nCacheList = RB_LIST_NONE;
     bMustDetach = FALSE;
 }
 
@@ -567,6 +1583,8 @@ void GDALRasterBlock::RecycleFor( int nXOffIn, int nYOffIn )
 
     nXOff = nXOffIn;
     nYOff = nYOffIn;
+    nShard = GetShardIndex(poBand, nXOff, nYOff);
+    nCacheList = RB_LIST_NONE;
     bMustDetach = TRUE;
 }
 
@@ -615,19 +1633,53 @@ void GDALRasterBlock::Detach()
 {
     if( bMustDetach )
     {
-        TAKE_LOCK;
+        TAKE_LOCK(&asShards[nShard]);
         Detach_unlocked();
     }
 }
 
 void GDALRasterBlock::Detach_unlocked()
 {
-    if( poOldest == this )
-        poOldest = poPrevious;
+    Unlink_unlocked();
+    bMustDetach = FALSE;
 
-    if( poNewest == this )
+    if( pData )
     {
-        poNewest = poNext;
+        asShards[nShard].nCacheUsed -= GetBlockSize();
+        if( poBand->GetDataset() != NULL )
+            poBand->GetDataset()->UpdateBlockCacheStatistics(
+                -GetBlockSize(), 0, 0 );
+    }
+
+#ifdef ENABLE_DEBUG
+    Verify();
+#endif
+}
+
+/************************************************************************/
+/*                          Unlink_unlocked()                           */
+/*                                                                      */
+/*      Remove the block from the list of its shard it is in, if any.   */
+/************************************************************************/
+
+void GDALRasterBlock::Unlink_unlocked()
+{
+    GDALRBCacheShard* psShard = &asShards[nShard];
+    GDALRasterBlock** ppoOldest = &(psShard->poOldest);
+    GDALRasterBlock** ppoNewest = &(psShard->poNewest);
+    if( nCacheList == RB_LIST_A1IN )
+    {
+        ppoOldest = &(psShard->poOldestA1In);
+        ppoNewest = &(psShard->poNewestA1In);
+        psShard->nCacheUsedA1In -= GetBlockSize();
+    }
+
+    if( *ppoOldest == this )
+        *ppoOldest = poPrevious;
+
+    if( *ppoNewest == this )
+    {
+        *ppoNewest = poNext;
     }
 
     if( poPrevious != NULL )
@@ -638,14 +1690,7 @@ void GDALRasterBlock::Detach_unlocked()
 
     poPrevious = NULL;
     poNext = NULL;
-    bMustDetach = FALSE;
-
-    if( pData )
-        nCacheUsed -= GetBlockSize();
-
-#ifdef ENABLE_DEBUG
-    Verify();
-#endif
+    nCacheList = RB_LIST_NONE;
 }
 
 /************************************************************************/
@@ -661,27 +1706,41 @@ void GDALRasterBlock::Detach_unlocked()
 void GDALRasterBlock::Verify()
 
 {
-    TAKE_LOCK;
-
-    CPLAssert( (poNewest == NULL && poOldest == NULL)
-               || (poNewest != NULL && poOldest != NULL) );
-
-    if( poNewest != NULL )
+    for( int iShard = 0; iShard < GetShardCount(); iShard++ )
     {
-        CPLAssert( poNewest->poPrevious == NULL );
-        CPLAssert( poOldest->poNext == NULL );
+        GDALRBCacheShard* psShard = &asShards[iShard];
+        TAKE_LOCK(psShard);
 
-        GDALRasterBlock* poLast = NULL;
-        for( GDALRasterBlock *poBlock = poNewest;
-             poBlock != NULL;
-             poBlock = poBlock->poNext )
+        for( int iList = RB_LIST_MAIN; iList <= RB_LIST_A1IN; iList++ )
         {
-            CPLAssert( poBlock->poPrevious == poLast );
+            GDALRasterBlock* poNewest = ( iList == RB_LIST_MAIN ) ?
+                psShard->poNewest : psShard->poNewestA1In;
+            GDALRasterBlock* poOldest = ( iList == RB_LIST_MAIN ) ?
+                psShard->poOldest : psShard->poOldestA1In;
 
-            poLast = poBlock;
-        }
+            CPLAssert( (poNewest == NULL && poOldest == NULL)
+                    || (poNewest != NULL && poOldest != NULL) );
+
+            if( poNewest != NULL )
+            {
+                CPLAssert( poNewest->poPrevious == NULL );
+                CPLAssert( poOldest->poNext == NULL );
+
+                GDALRasterBlock* poLast = NULL;
+                for( GDALRasterBlock *poBlock = poNewest;
+                    poBlock != NULL;
+                    poBlock = poBlock->poNext )
+                {
+                    CPLAssert( poBlock->poPrevious == poLast );
+                    CPLAssert( poBlock->nShard == iShard );
+                    CPLAssert( poBlock->nCacheList == iList );
 
-        CPLAssert( poOldest == poLast );
+                    poLast = poBlock;
+                }
+
+                CPLAssert( poOldest == poLast );
+            }
+        }
     }
 }
 
@@ -692,24 +1751,34 @@ void GDALRasterBlock::Verify() {}
 #if 0
 void GDALRasterBlock::CheckNonOrphanedBlocks(GDALRasterBand* poBand)
 {
-    TAKE_LOCK;
-    for( GDALRasterBlock *poBlock = poNewest;
-                          poBlock != NULL;
-                          poBlock = poBlock->poNext )
+    for( int iShard = 0; iShard < GetShardCount(); iShard++ )
     {
-        if ( poBlock->GetBand() == poBand )
+        GDALRBCacheShard* psShard = &asShards[iShard];
+        TAKE_LOCK(psShard);
+
+        for( int iList = RB_LIST_MAIN; iList <= RB_LIST_A1IN; iList++ )
         {
-            printf("Cache has still blocks of band %p\n", poBand);
-            printf("Band : %d\n", poBand->GetBand());
-            printf("nRasterXSize = %d\n", poBand->GetXSize());
-            printf("nRasterYSize = %d\n", poBand->GetYSize());
-            int nBlockXSize, nBlockYSize;
-            poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
-            printf("nBlockXSize = %d\n", nBlockXSize);
-            printf("nBlockYSize = %d\n", nBlockYSize);
-            printf("Dataset : %p\n", poBand->GetDataset());
-            if( poBand->GetDataset() )
-                printf("Dataset : %s\n", poBand->GetDataset()->GetDescription());
+            for( GDALRasterBlock *poBlock = ( iList == RB_LIST_MAIN ) ?
+                        psShard->poNewest : psShard->poNewestA1In;
+                 poBlock != NULL;
+                 poBlock = poBlock->poNext )
+            {
+                if ( poBlock->GetBand() == poBand )
+                {
+                    printf("Cache has still blocks of band %p\n", poBand);
+                    printf("Band : %d\n", poBand->GetBand());
+                    printf("nRasterXSize = %d\n", poBand->GetXSize());
+                    printf("nRasterYSize = %d\n", poBand->GetYSize());
+                    int nBlockXSize, nBlockYSize;
+                    poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+                    printf("nBlockXSize = %d\n", nBlockXSize);
+                    printf("nBlockYSize = %d\n", nBlockYSize);
+                    printf("Dataset : %p\n", poBand->GetDataset());
+                    if( poBand->GetDataset() )
+                        printf("Dataset : %s\n",
+                               poBand->GetDataset()->GetDescription());
+                }
+            }
         }
     }
 }
@@ -765,7 +1834,7 @@ CPLErr GDALRasterBlock::Write()
 void GDALRasterBlock::Touch()
 
 {
-    TAKE_LOCK;
+    TAKE_LOCK(&asShards[nShard]);
     Touch_unlocked();
 }
 
@@ -773,7 +1842,22 @@ void GDALRasterBlock::Touch()
 void GDALRasterBlock::Touch_unlocked()
 
 {
-    if( poNewest == this )
+    GDALRBCacheShard* psShard = &asShards[nShard];
+
+    // With the 2Q policy, the A1in list is a FIFO: new references to a block
+    // in it are usually correlated to the first one (e.g. the lines of a
+    // block read one at a time), and must not be considered as a reuse.
+    if( nCacheList == RB_LIST_A1IN )
+        return;
+
+    int nTargetList = RB_LIST_MAIN;
+    if( nCacheList == RB_LIST_NONE && GetCachePolicy() == RB_POLICY_2Q &&
+        !TakeGhostEntry(psShard, poBand, nXOff, nYOff) )
+    {
+        nTargetList = RB_LIST_A1IN;
+    }
+
+    if( nTargetList == RB_LIST_MAIN && psShard->poNewest == this )
         return;
 
     // In theory, we should not try to touch a block that has been detached
@@ -781,34 +1865,42 @@ void GDALRasterBlock::Touch_unlocked()
     if( !bMustDetach )
     {
         if( pData )
-            nCacheUsed += GetBlockSize();
+        {
+            psShard->nCacheUsed += GetBlockSize();
+            if( poBand->GetDataset() != NULL )
+                poBand->GetDataset()->UpdateBlockCacheStatistics(
+                    GetBlockSize(), 0, 0 );
+        }
 
         bMustDetach = TRUE;
     }
 
-    if( poOldest == this )
-        poOldest = this->poPrevious;
-
-    if( poPrevious != NULL )
-        poPrevious->poNext = poNext;
+    Unlink_unlocked();
 
-    if( poNext != NULL )
-        poNext->poPrevious = poPrevious;
+    GDALRasterBlock** ppoOldest = &(psShard->poOldest);
+    GDALRasterBlock** ppoNewest = &(psShard->poNewest);
+    if( nTargetList == RB_LIST_A1IN )
+    {
+        ppoOldest = &(psShard->poOldestA1In);
+        ppoNewest = &(psShard->poNewestA1In);
+        psShard->nCacheUsedA1In += GetBlockSize();
+    }
+    nCacheList = nTargetList;
 
     poPrevious = NULL;
-    poNext = poNewest;
+    poNext = *ppoNewest;
 
-    if( poNewest != NULL )
+    if( *ppoNewest != NULL )
     {
-        CPLAssert( poNewest->poPrevious == NULL );
-        poNewest->poPrevious = this;
+        CPLAssert( (*ppoNewest)->poPrevious == NULL );
+        (*ppoNewest)->poPrevious = this;
     }
-    poNewest = this;
+    *ppoNewest = this;
 
-    if( poOldest == NULL )
+    if( *ppoOldest == NULL )
     {
         CPLAssert( poPrevious == NULL && poNext == NULL );
-        poOldest = this;
+        *ppoOldest = this;
     }
 #ifdef ENABLE_DEBUG
     Verify();
@@ -823,9 +1915,10 @@ void GDALRasterBlock::Touch_unlocked()
  * Allocate memory for block.
  *
  * This method allocates memory for the block, and attempts to flush other
- * blocks, if necessary, to bring the total cache size back within the limits.
+ * blocks of the same cache shard, if necessary, to bring the size of the
+ * shard back within its share of the limits.
  * The newly allocated block is touched and will be considered most recently
- * used in the LRU list.
+ * used in the LRU list (or in the A1in list with the 2Q policy).
  *
  * @return CE_None on success or CE_Failure if memory allocation fails.
  */
@@ -838,9 +1931,11 @@ CPLErr GDALRasterBlock::Internalize()
 
     CPLAssert( pData == NULL );
 
-    // This call will initialize the hRBLock mutex. Other call places can
+    // This call will initialize the shard locks. Other call places can
     // only be called if we have go through there.
-    GIntBig     nCurCacheMax = GDALGetCacheMax64();
+    GIntBig     nCurCacheMax = GetShardCacheMax(GDALGetCacheMax64());
+    GDALRBCacheShard* psShard = &asShards[nShard];
+    GDALDataset* poDS = poBand->GetDataset();
 
     /* No risk of overflow as it is checked in GDALRasterBand::InitBlockInfo() */
     nSizeInBytes = GetBlockSize();
@@ -856,49 +1951,42 @@ CPLErr GDALRasterBlock::Internalize()
         GDALRasterBlock* apoBlocksToFree[64];
         int nBlocksToFree = 0;
         {
-            TAKE_LOCK;
+            TAKE_LOCK(psShard);
 
             if( bFirstIter )
-                nCacheUsed += nSizeInBytes;
-            GDALRasterBlock *poTarget = poOldest;
-            while( nCacheUsed > nCurCacheMax )
             {
-                while( poTarget != NULL )
-                {
-                    if( CPLAtomicCompareAndExchange(&(poTarget->nLockCount), 0, -1) )
-                        break;
-                    poTarget = poTarget->poPrevious;
-                }
-
-                if( poTarget != NULL )
-                {
-                    if( bSleepsForBockCacheDebug )
-                        CPLSleep(CPLAtof(CPLGetConfigOption("GDAL_RB_INTERNALIZE_SLEEP_AFTER_DROP_LOCK", "0")));
-
-                    GDALRasterBlock* _poPrevious = poTarget->poPrevious;
+                psShard->nCacheUsed += nSizeInBytes;
+                psShard->nMisses++;
+                if( poDS != NULL )
+                    poDS->UpdateBlockCacheStatistics(nSizeInBytes, 0, 1);
+            }
+            while( psShard->nCacheUsed > nCurCacheMax )
+            {
+                GDALRasterBlock *poTarget =
+                    SelectBlockToEvict_unlocked(nShard, FALSE);
+                if( poTarget == NULL )
+                    break;
 
-                    poTarget->Detach_unlocked();
-                    poTarget->GetBand()->UnreferenceBlock(poTarget);
+                if( bSleepsForBockCacheDebug )
+                    CPLSleep(CPLAtof(CPLGetConfigOption("GDAL_RB_INTERNALIZE_SLEEP_AFTER_DROP_LOCK", "0")));
 
-                    apoBlocksToFree[nBlocksToFree++] = poTarget;
-                    if( poTarget->GetDirty() )
-                    {
-                        // Only free one dirty block at a time so that
-                        // other dirty blocks of other bands with the same coordinates
-                        // can be found with TryGetLockedBlock()
-                        bLoopAgain = ( nCacheUsed > nCurCacheMax );
-                        break;
-                    }
-                    if( nBlocksToFree == 64 )
-                    {
-                        bLoopAgain = ( nCacheUsed > nCurCacheMax );
-                        break;
-                    }
+                poTarget->Detach_unlocked();
+                poTarget->GetBand()->UnreferenceBlock(poTarget);
 
-                    poTarget = _poPrevious;
+                apoBlocksToFree[nBlocksToFree++] = poTarget;
+                if( poTarget->GetDirty() )
+                {
+                    // Only free one dirty block at a time so that
+                    // other dirty blocks of other bands with the same coordinates
+                    // can be found with TryGetLockedBlock()
+                    bLoopAgain = ( psShard->nCacheUsed > nCurCacheMax );
+                    break;
                 }
-                else
+                if( nBlocksToFree == 64 )
+                {
+                    bLoopAgain = ( psShard->nCacheUsed > nCurCacheMax );
                     break;
+                }
             }
 
         /* -------------------------------------------------------------------- */
@@ -924,6 +2012,10 @@ CPLErr GDALRasterBlock::Internalize()
                     poBlock->GetBand()->SetFlushBlockErr(eErr);
                 }
             }
+            else
+            {
+                poBlock->StoreInCompressedCache();
+            }
 
             /* Try to recycle the data of an existing block */
             void* pDataBlock = poBlock->pData;
@@ -943,6 +2035,12 @@ CPLErr GDALRasterBlock::Internalize()
     }
     while(bLoopAgain);
 
+/* -------------------------------------------------------------------- */
+/*      Flush old blocks of the dataset if it is over its own quota.    */
+/* -------------------------------------------------------------------- */
+    if( poDS != NULL && poDS->IsBlockCacheQuotaExceeded() )
+        FlushDatasetExcessBlocks(poDS);
+
     if( pNewData == NULL )
     {
         pNewData = VSI_MALLOC_VERBOSE( nSizeInBytes );
@@ -999,9 +2097,32 @@ void GDALRasterBlock::MarkClean()
 
 void GDALRasterBlock::DestroyRBMutex()
 {
-    if( hRBLock != NULL )
-        DESTROY_LOCK;
-    hRBLock = NULL;
+    for( int iShard = 0; iShard < MAX_RB_CACHE_SHARDS; iShard++ )
+    {
+        GDALRBCacheShard* psShard = &asShards[iShard];
+        if( psShard->hLock != NULL )
+            DESTROY_LOCK(psShard);
+        psShard->hLock = NULL;
+
+        while( psShard->psOldestGhost != NULL )
+            RemoveGhostEntry(psShard, psShard->psOldestGhost);
+        if( psShard->hGhostSet != NULL )
+            CPLHashSetDestroy(psShard->hGhostSet);
+        psShard->hGhostSet = NULL;
+        delete psShard->poMapBandGhosts;
+        psShard->poMapBandGhosts = NULL;
+    }
+
+    if( sCompressedCache.hLock != NULL )
+        DESTROY_LOCK(&sCompressedCache);
+    sCompressedCache.hLock = NULL;
+    TrimCompressedCache_unlocked(0);
+    if( sCompressedCache.hSet != NULL )
+        CPLHashSetDestroy(sCompressedCache.hSet);
+    sCompressedCache.hSet = NULL;
+    delete sCompressedCache.poMapBandEntries;
+    sCompressedCache.poMapBandEntries = NULL;
+    bCompressedCacheMaxInitialized = false;
 }
 
 /************************************************************************/
@@ -1037,11 +2158,17 @@ int GDALRasterBlock::TakeLock()
         DropLock();
 
         // wait for the block having been unreferenced
-        TAKE_LOCK;
+        TAKE_LOCK(&asShards[nShard]);
 
         return FALSE;
     }
-    Touch();
+
+    GDALRBCacheShard* psShard = &asShards[nShard];
+    TAKE_LOCK(psShard);
+    psShard->nHits++;
+    if( poBand->GetDataset() != NULL )
+        poBand->GetDataset()->UpdateBlockCacheStatistics(0, 1, 0);
+    Touch_unlocked();
     return TRUE;
 }
 
@@ -1071,7 +2198,7 @@ int GDALRasterBlock::DropLockForRemovalFromStorage()
 #endif
 
     // Wait for the block for having been unreferenced
-    TAKE_LOCK;
+    TAKE_LOCK(&asShards[nShard]);
 
     return FALSE;
 }
@@ -1079,15 +2206,26 @@ int GDALRasterBlock::DropLockForRemovalFromStorage()
 #if 0
 void GDALRasterBlock::DumpAll()
 {
-    int iBlock = 0;
-    for( GDALRasterBlock *poBlock = poNewest;
-                            poBlock != NULL;
-                            poBlock = poBlock->poNext )
+    for( int iShard = 0; iShard < GetShardCount(); iShard++ )
     {
-        printf("Block %d\n", iBlock);
-        poBlock->DumpBlock();
-        printf("\n");
-        iBlock ++;
+        GDALRBCacheShard* psShard = &asShards[iShard];
+        TAKE_LOCK(psShard);
+
+        for( int iList = RB_LIST_MAIN; iList <= RB_LIST_A1IN; iList++ )
+        {
+            int iBlock = 0;
+            for( GDALRasterBlock *poBlock = ( iList == RB_LIST_MAIN ) ?
+                        psShard->poNewest : psShard->poNewestA1In;
+                 poBlock != NULL;
+                 poBlock = poBlock->poNext )
+            {
+                printf("Shard %d, %s list, block %d\n", iShard,
+                       ( iList == RB_LIST_MAIN ) ? "main" : "A1in", iBlock);
+                poBlock->DumpBlock();
+                printf("\n");
+                iBlock ++;
+            }
+        }
     }
 }
 
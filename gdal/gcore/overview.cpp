@@ -29,9 +29,11 @@
  ****************************************************************************/
 
 #include <limits>
+#include <vector>
 
 #include "gdal_priv.h"
 #include "gdalwarper.h"
+#include "cpl_worker_thread_pool.h"
 
 CPL_CVSID("$Id$");
 
@@ -1944,23 +1946,12 @@ GDALResampleChunkC32R( int nSrcWidth, int nSrcHeight,
 }
 
 /************************************************************************/
-/*                  GDALRegenerateCascadingOverviews()                  */
-/*                                                                      */
-/*      Generate a list of overviews in order from largest to           */
-/*      smallest, computing each from the next larger.                  */
+/*                    GDALSortOverviewBandsBySize()                     */
 /************************************************************************/
 
-static CPLErr
-GDALRegenerateCascadingOverviews(
-    GDALRasterBand *poSrcBand, int nOverviews, GDALRasterBand **papoOvrBands,
-    const char * pszResampling,
-    GDALProgressFunc pfnProgress, void * pProgressData )
-
+static void GDALSortOverviewBandsBySize( int nOverviews,
+                                         GDALRasterBand **papoOvrBands )
 {
-/* -------------------------------------------------------------------- */
-/*      First, we must put the overviews in order from largest to       */
-/*      smallest.                                                       */
-/* -------------------------------------------------------------------- */
     for( int i = 0; i < nOverviews-1; i++ )
     {
         for( int j = 0; j < nOverviews - i - 1; j++ )
@@ -1976,6 +1967,27 @@ GDALRegenerateCascadingOverviews(
             }
         }
     }
+}
+
+/************************************************************************/
+/*                  GDALRegenerateCascadingOverviews()                  */
+/*                                                                      */
+/*      Generate a list of overviews in order from largest to           */
+/*      smallest, computing each from the next larger.                  */
+/************************************************************************/
+
+static CPLErr
+GDALRegenerateCascadingOverviews(
+    GDALRasterBand *poSrcBand, int nOverviews, GDALRasterBand **papoOvrBands,
+    const char * pszResampling,
+    GDALProgressFunc pfnProgress, void * pProgressData )
+
+{
+/* -------------------------------------------------------------------- */
+/*      First, we must put the overviews in order from largest to       */
+/*      smallest.                                                       */
+/* -------------------------------------------------------------------- */
+    GDALSortOverviewBandsBySize( nOverviews, papoOvrBands );
 
 /* -------------------------------------------------------------------- */
 /*      Count total pixels so we can prepare appropriate scaled         */
@@ -2190,71 +2202,1343 @@ static CPLErr GDALResampleChunk32RMultiBands_Convolution(
                         nKernelRadius,
                         fMaxVal);
 
-    CPLAssert(0);
-    return CE_Failure;
+    CPLAssert(0);
+    return CE_Failure;
+}
+
+/************************************************************************/
+/*                    GDALGetResampleFunctionMultiBands()               */
+/************************************************************************/
+
+GDALResampleFunctionMultiBands GDALGetResampleFunctionMultiBands(
+                                                 const char* pszResampling,
+                                                 int* pnRadius)
+{
+    if( pnRadius ) *pnRadius = 0;
+    if( EQUAL(pszResampling,"CUBIC") )
+    {
+        if( pnRadius ) *pnRadius = GWKGetFilterRadius(GRA_Cubic);
+        return GDALResampleChunk32RMultiBands_Convolution;
+    }
+    else if( EQUAL(pszResampling,"CUBICSPLINE") )
+    {
+        if( pnRadius ) *pnRadius = GWKGetFilterRadius(GRA_CubicSpline);
+        return GDALResampleChunk32RMultiBands_Convolution;
+    }
+    else if( EQUAL(pszResampling,"LANCZOS") )
+    {
+        if( pnRadius ) *pnRadius = GWKGetFilterRadius(GRA_Lanczos);
+        return GDALResampleChunk32RMultiBands_Convolution;
+    }
+    else if( EQUAL(pszResampling,"BILINEAR") )
+    {
+        if( pnRadius ) *pnRadius = GWKGetFilterRadius(GRA_Bilinear);
+        return GDALResampleChunk32RMultiBands_Convolution;
+    }
+    else
+    {
+        return NULL;
+    }
+}
+#endif
+
+/************************************************************************/
+/*                      GDALGetOvrWorkDataType()                        */
+/************************************************************************/
+
+GDALDataType GDALGetOvrWorkDataType(const char* pszResampling,
+                                        GDALDataType eSrcDataType)
+{
+    if( (STARTS_WITH_CI(pszResampling, "NEAR") ||
+         STARTS_WITH_CI(pszResampling, "AVER") ||
+         EQUAL(pszResampling,"CUBIC") ||
+         EQUAL(pszResampling,"CUBICSPLINE") ||
+         EQUAL(pszResampling,"LANCZOS") ||
+         EQUAL(pszResampling,"BILINEAR")) &&
+        eSrcDataType == GDT_Byte)
+        return GDT_Byte;
+    else if( (STARTS_WITH_CI(pszResampling, "NEAR") ||
+         STARTS_WITH_CI(pszResampling, "AVER") ||
+         EQUAL(pszResampling,"CUBIC") ||
+         EQUAL(pszResampling,"CUBICSPLINE") ||
+         EQUAL(pszResampling,"LANCZOS") ||
+         EQUAL(pszResampling,"BILINEAR")) &&
+        eSrcDataType == GDT_UInt16)
+        return GDT_UInt16;
+    else
+        return GDT_Float32;
+}
+
+/************************************************************************/
+/*                      GDALOverviewResampleBuffer                      */
+/************************************************************************/
+
+/* In-memory stand-in for an overview band, used when chunks are        */
+/* resampled in worker threads. The resampling functions write their    */
+/* output lines into it, and the calling thread later flushes the       */
+/* accumulated window to the real overview band, so that the target     */
+/* band (and its dataset) is only ever accessed from a single thread.   */
+
+class GDALOverviewResampleBuffer : public GDALRasterBand
+{
+    GDALRasterBand *poTarget;
+    int             nWinXOff;
+    int             nWinYOff;
+    int             nWinXSize;
+    int             nWinYSize;
+    GByte          *pabyData;
+    size_t          nDataAlloc;
+
+  protected:
+    virtual CPLErr IReadBlock( int, int, void * );
+    virtual CPLErr IRasterIO( GDALRWFlag, int, int, int, int,
+                              void *, int, int, GDALDataType,
+                              GSpacing, GSpacing, GDALRasterIOExtraArg* );
+
+  public:
+    explicit GDALOverviewResampleBuffer( GDALRasterBand* poTargetIn );
+    virtual ~GDALOverviewResampleBuffer();
+
+    bool            SetWindow( int nXOff, int nYOff, int nXSize, int nYSize );
+    CPLErr          FlushToTarget();
+    const GByte    *GetWindowData() const { return pabyData; }
+};
+
+/************************************************************************/
+/*                     GDALOverviewResampleBuffer()                     */
+/************************************************************************/
+
+GDALOverviewResampleBuffer::GDALOverviewResampleBuffer(
+                                        GDALRasterBand* poTargetIn ) :
+    GDALRasterBand(FALSE),
+    poTarget(poTargetIn),
+    nWinXOff(0),
+    nWinYOff(0),
+    nWinXSize(0),
+    nWinYSize(0),
+    pabyData(NULL),
+    nDataAlloc(0)
+{
+    nRasterXSize = poTarget->GetXSize();
+    nRasterYSize = poTarget->GetYSize();
+    eDataType = poTarget->GetRasterDataType();
+    eAccess = GA_Update;
+    nBlockXSize = nRasterXSize;
+    nBlockYSize = 1;
+
+    // Fetched here, from the calling thread, since the convolution
+    // resampling functions query it.
+    const char* pszNBITS =
+        poTarget->GetMetadataItem("NBITS", "IMAGE_STRUCTURE");
+    if( pszNBITS != NULL )
+        SetMetadataItem("NBITS", pszNBITS, "IMAGE_STRUCTURE");
+}
+
+/************************************************************************/
+/*                    ~GDALOverviewResampleBuffer()                     */
+/************************************************************************/
+
+GDALOverviewResampleBuffer::~GDALOverviewResampleBuffer()
+{
+    VSIFree(pabyData);
+}
+
+/************************************************************************/
+/*                              SetWindow()                             */
+/************************************************************************/
+
+bool GDALOverviewResampleBuffer::SetWindow( int nXOff, int nYOff,
+                                            int nXSize, int nYSize )
+{
+    const size_t nNeeded = static_cast<size_t>(nXSize) * nYSize *
+                                GDALGetDataTypeSizeBytes(eDataType);
+    if( nNeeded > nDataAlloc )
+    {
+        GByte* pabyNew = static_cast<GByte*>(
+                                VSI_REALLOC_VERBOSE(pabyData, nNeeded));
+        if( pabyNew == NULL )
+            return false;
+        pabyData = pabyNew;
+        nDataAlloc = nNeeded;
+    }
+    if( nNeeded )
+        memset(pabyData, 0, nNeeded);
+
+    nWinXOff = nXOff;
+    nWinYOff = nYOff;
+    nWinXSize = nXSize;
+    nWinYSize = nYSize;
+    return true;
+}
+
+/************************************************************************/
+/*                             IReadBlock()                             */
+/************************************************************************/
+
+CPLErr GDALOverviewResampleBuffer::IReadBlock( int, int, void * )
+{
+    CPLError( CE_Failure, CPLE_NotSupported,
+              "GDALOverviewResampleBuffer is write-only" );
+    return CE_Failure;
+}
+
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+
+CPLErr GDALOverviewResampleBuffer::IRasterIO( GDALRWFlag eRWFlag,
+                                    int nXOff, int nYOff,
+                                    int nXSize, int nYSize,
+                                    void * pData, int nBufXSize, int nBufYSize,
+                                    GDALDataType eBufType,
+                                    GSpacing nPixelSpace, GSpacing nLineSpace,
+                                    GDALRasterIOExtraArg* /* psExtraArg */ )
+{
+    if( eRWFlag != GF_Write || nXSize != nBufXSize || nYSize != nBufYSize ||
+        nXOff < nWinXOff || nXOff + nXSize > nWinXOff + nWinXSize ||
+        nYOff < nWinYOff || nYOff + nYSize > nWinYOff + nWinYSize )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "GDALOverviewResampleBuffer: unexpected request "
+                  "(%d,%d) of size %dx%d outside of window "
+                  "(%d,%d) of size %dx%d",
+                  nXOff, nYOff, nXSize, nYSize,
+                  nWinXOff, nWinYOff, nWinXSize, nWinYSize );
+        return CE_Failure;
+    }
+
+    const int nDTSize = GDALGetDataTypeSizeBytes(eDataType);
+    for( int iLine = 0; iLine < nYSize; iLine++ )
+    {
+        GDALCopyWords( static_cast<GByte*>(pData) + iLine * nLineSpace,
+                       eBufType, static_cast<int>(nPixelSpace),
+                       pabyData +
+                        (static_cast<size_t>(nYOff - nWinYOff + iLine) *
+                            nWinXSize + (nXOff - nWinXOff)) * nDTSize,
+                       eDataType, nDTSize,
+                       nXSize );
+    }
+    return CE_None;
+}
+
+/************************************************************************/
+/*                           FlushToTarget()                            */
+/************************************************************************/
+
+CPLErr GDALOverviewResampleBuffer::FlushToTarget()
+{
+    if( nWinXSize == 0 || nWinYSize == 0 )
+        return CE_None;
+    return poTarget->RasterIO( GF_Write, nWinXOff, nWinYOff,
+                               nWinXSize, nWinYSize,
+                               pabyData, nWinXSize, nWinYSize, eDataType,
+                               0, 0, NULL );
+}
+
+/************************************************************************/
+/*                    GDALCreateOverviewThreadPool()                    */
+/************************************************************************/
+
+/* Returns a worker thread pool sized from the GDAL_NUM_THREADS         */
+/* configuration option, or NULL if overviews must be computed in the   */
+/* calling thread only.                                                 */
+
+static CPLWorkerThreadPool* GDALCreateOverviewThreadPool()
+{
+    const char* pszThreads = CPLGetConfigOption("GDAL_NUM_THREADS", "1");
+    int nThreads;
+    if( EQUAL(pszThreads, "ALL_CPUS") )
+        nThreads = CPLGetNumCPUs();
+    else
+        nThreads = atoi(pszThreads);
+    if( nThreads > 128 )
+        nThreads = 128;
+    if( nThreads <= 1 )
+        return NULL;
+
+    CPLWorkerThreadPool* poPool = new CPLWorkerThreadPool();
+    if( !poPool->Setup(nThreads, NULL, NULL) )
+    {
+        delete poPool;
+        return NULL;
+    }
+    CPLDebug("GDAL", "Using %d threads for overview computation", nThreads);
+    return poPool;
+}
+
+/************************************************************************/
+/*                         GDALWaitOverviewJob()                        */
+/************************************************************************/
+
+/* Wait until the job whose completion flag is pbFinished is done,      */
+/* nJobsInFlight being the number of submitted jobs whose result has    */
+/* not yet been consumed.                                               */
+
+static void GDALWaitOverviewJob( CPLWorkerThreadPool* poPool,
+                                 volatile int* pbFinished,
+                                 int nJobsInFlight )
+{
+    for( int nRemaining = nJobsInFlight - 1; ; nRemaining-- )
+    {
+        poPool->WaitCompletion(nRemaining);
+        if( *pbFinished || nRemaining <= 0 )
+            break;
+    }
+}
+
+/************************************************************************/
+/*                       GDALGetOverviewDstLines()                      */
+/************************************************************************/
+
+/* Figure out the line to start writing to, and the first line to not   */
+/* write to, for a chunk of the full resolution image. In theory this   */
+/* approach should ensure that every output line will be written if all */
+/* input chunks are processed.                                          */
+
+static void GDALGetOverviewDstLines( int nChunkYOff, int nFullResYChunk,
+                                     int nHeight, int nDstHeight,
+                                     int* pnDstYOff, int* pnDstYOff2 )
+{
+    const double dfYRatioDstToSrc = (double)nHeight / nDstHeight;
+    *pnDstYOff = (int) (0.5 + nChunkYOff/dfYRatioDstToSrc);
+    *pnDstYOff2 = (int)
+        (0.5 + (nChunkYOff+nFullResYChunk)/dfYRatioDstToSrc);
+
+    if( nChunkYOff + nFullResYChunk == nHeight )
+        *pnDstYOff2 = nDstHeight;
+    //CPLDebug("GDAL", "nDstYOff=%d, nDstYOff2=%d", *pnDstYOff, *pnDstYOff2);
+}
+
+/************************************************************************/
+/*                         GDALOverviewChunkJob                         */
+/************************************************************************/
+
+/* A horizontal swath of the source band, to be resampled into all the  */
+/* requested overview levels by GDALRegenerateOverviews().              */
+
+typedef struct
+{
+    GDALResampleFunction pfnResampleFn;
+    const char         *pszResampling;
+    GDALDataType        eType;
+    GDALDataType        eSrcDataType;
+    int                 nWidth;
+    int                 nHeight;
+    int                 nChunkYOff;
+    int                 nFullResYChunk;
+    int                 nChunkYOffQueried;
+    int                 nChunkYSizeQueried;
+    void               *pChunk;
+    GByte              *pabyChunkNodataMask;
+    int                 bHasNoData;
+    float               fNoDataValue;
+    GDALColorTable     *poColorTable;
+    int                 nOverviewCount;
+    // Either the overview bands, or GDALOverviewResampleBuffer in
+    // multi-threaded mode.
+    GDALRasterBand    **papoDstBands;
+    CPLErr              eErr;
+    volatile int        bFinished;
+} GDALOverviewChunkJob;
+
+/************************************************************************/
+/*                      GDALResampleOverviewChunk()                     */
+/************************************************************************/
+
+static CPLErr GDALResampleOverviewChunk( GDALOverviewChunkJob* psJob )
+{
+    CPLErr eErr = CE_None;
+    for( int iOverview = 0;
+         iOverview < psJob->nOverviewCount && eErr == CE_None;
+         iOverview++ )
+    {
+        GDALRasterBand* poDstBand = psJob->papoDstBands[iOverview];
+        const int nDstWidth = poDstBand->GetXSize();
+        const int nDstHeight = poDstBand->GetYSize();
+
+        const double dfXRatioDstToSrc = (double)psJob->nWidth / nDstWidth;
+        const double dfYRatioDstToSrc = (double)psJob->nHeight / nDstHeight;
+
+        int nDstYOff, nDstYOff2;
+        GDALGetOverviewDstLines( psJob->nChunkYOff, psJob->nFullResYChunk,
+                                 psJob->nHeight, nDstHeight,
+                                 &nDstYOff, &nDstYOff2 );
+
+        if( psJob->eType == GDT_Byte || psJob->eType == GDT_UInt16 ||
+            psJob->eType == GDT_Float32 )
+            eErr = psJob->pfnResampleFn(dfXRatioDstToSrc, dfYRatioDstToSrc,
+                                        0.0, 0.0,
+                                        psJob->eType,
+                                        psJob->pChunk,
+                                        psJob->pabyChunkNodataMask,
+                                        0, psJob->nWidth,
+                                        psJob->nChunkYOffQueried,
+                                        psJob->nChunkYSizeQueried,
+                                        0, nDstWidth,
+                                        nDstYOff, nDstYOff2,
+                                        poDstBand, psJob->pszResampling,
+                                        psJob->bHasNoData,
+                                        psJob->fNoDataValue,
+                                        psJob->poColorTable,
+                                        psJob->eSrcDataType);
+        else
+            eErr = GDALResampleChunkC32R(psJob->nWidth, psJob->nHeight,
+                                         (float*)psJob->pChunk,
+                                         psJob->nChunkYOffQueried,
+                                         psJob->nChunkYSizeQueried,
+                                         nDstYOff, nDstYOff2,
+                                         poDstBand, psJob->pszResampling);
+    }
+    return eErr;
+}
+
+/************************************************************************/
+/*                     GDALOverviewChunkJobFunc()                       */
+/************************************************************************/
+
+static void GDALOverviewChunkJobFunc( void* pData )
+{
+    GDALOverviewChunkJob* psJob = static_cast<GDALOverviewChunkJob*>(pData);
+    psJob->eErr = GDALResampleOverviewChunk(psJob);
+    psJob->bFinished = TRUE;
+}
+
+/************************************************************************/
+/*                     GDALFlushOverviewChunkJob()                      */
+/************************************************************************/
+
+/* Wait for a job submitted to the thread pool, and write its result */
+/* to the overview bands. */
+
+static CPLErr GDALFlushOverviewChunkJob( CPLWorkerThreadPool* poPool,
+                                         GDALOverviewChunkJob* psJob,
+                                         int nJobsInFlight,
+                                         CPLErr eErr )
+{
+    GDALWaitOverviewJob(poPool, &psJob->bFinished, nJobsInFlight);
+    if( eErr == CE_None )
+        eErr = psJob->eErr;
+    for( int iOverview = 0;
+         iOverview < psJob->nOverviewCount && eErr == CE_None;
+         iOverview++ )
+    {
+        eErr = static_cast<GDALOverviewResampleBuffer*>(
+                    psJob->papoDstBands[iOverview])->FlushToTarget();
+    }
+    return eErr;
+}
+
+/************************************************************************/
+/*                         GDALOverviewBlockJob                         */
+/************************************************************************/
+
+/* A block of an overview level, for all bands, to be computed by       */
+/* GDALRegenerateOverviewsMultiBand().                                  */
+
+typedef struct
+{
+    GDALResampleFunction pfnResampleFn;
+    const char         *pszResampling;
+    double              dfXRatioDstToSrc;
+    double              dfYRatioDstToSrc;
+    GDALDataType        eWrkDataType;
+    GDALDataType        eSrcDataType;
+    int                 nBands;
+    void              **papaChunk;
+    GByte              *pabyChunkNoDataMask;
+    int                 nChunkXOffQueried;
+    int                 nChunkXSizeQueried;
+    int                 nChunkYOffQueried;
+    int                 nChunkYSizeQueried;
+    int                 nDstXOff;
+    int                 nDstXCount;
+    int                 nDstYOff;
+    int                 nDstYCount;
+    const int          *pabHasNoData;
+    const float        *pafNoDataValue;
+    // Either the overview bands, or GDALOverviewResampleBuffer in
+    // multi-threaded mode.
+    GDALRasterBand    **papoDstBands;
+    CPLErr              eErr;
+    volatile int        bFinished;
+} GDALOverviewBlockJob;
+
+/************************************************************************/
+/*                      GDALResampleOverviewBlock()                     */
+/************************************************************************/
+
+static CPLErr GDALResampleOverviewBlock( GDALOverviewBlockJob* psJob )
+{
+    CPLErr eErr = CE_None;
+    for(int iBand=0;iBand<psJob->nBands && eErr == CE_None;iBand++)
+    {
+        eErr = psJob->pfnResampleFn( psJob->dfXRatioDstToSrc,
+                                     psJob->dfYRatioDstToSrc,
+                                     0.0, 0.0,
+                                     psJob->eWrkDataType,
+                                     psJob->papaChunk[iBand],
+                                     psJob->pabyChunkNoDataMask,
+                                     psJob->nChunkXOffQueried,
+                                     psJob->nChunkXSizeQueried,
+                                     psJob->nChunkYOffQueried,
+                                     psJob->nChunkYSizeQueried,
+                                     psJob->nDstXOff,
+                                     psJob->nDstXOff + psJob->nDstXCount,
+                                     psJob->nDstYOff,
+                                     psJob->nDstYOff + psJob->nDstYCount,
+                                     psJob->papoDstBands[iBand],
+                                     psJob->pszResampling,
+                                     psJob->pabHasNoData[iBand],
+                                     psJob->pafNoDataValue[iBand],
+                                     /*poColorTable*/ NULL,
+                                     psJob->eSrcDataType);
+    }
+    return eErr;
+}
+
+/************************************************************************/
+/*                     GDALOverviewBlockJobFunc()                       */
+/************************************************************************/
+
+static void GDALOverviewBlockJobFunc( void* pData )
+{
+    GDALOverviewBlockJob* psJob = static_cast<GDALOverviewBlockJob*>(pData);
+    psJob->eErr = GDALResampleOverviewBlock(psJob);
+    psJob->bFinished = TRUE;
+}
+
+/************************************************************************/
+/*                     GDALFlushOverviewBlockJob()                      */
+/************************************************************************/
+
+static CPLErr GDALFlushOverviewBlockJob( CPLWorkerThreadPool* poPool,
+                                         GDALOverviewBlockJob* psJob,
+                                         int nJobsInFlight,
+                                         CPLErr eErr )
+{
+    GDALWaitOverviewJob(poPool, &psJob->bFinished, nJobsInFlight);
+    if( eErr == CE_None )
+        eErr = psJob->eErr;
+    for(int iBand=0;iBand<psJob->nBands && eErr == CE_None;iBand++)
+    {
+        eErr = static_cast<GDALOverviewResampleBuffer*>(
+                    psJob->papoDstBands[iBand])->FlushToTarget();
+    }
+    return eErr;
+}
+
+/************************************************************************/
+/*                     GDALFreeOverviewBlockJobs()                      */
+/************************************************************************/
+
+static void GDALFreeOverviewBlockJobs( std::vector<GDALOverviewBlockJob>& asJobs,
+                                       bool bOwnDstBands )
+{
+    for( size_t iJob = 0; iJob < asJobs.size(); iJob++ )
+    {
+        GDALOverviewBlockJob* psJob = &asJobs[iJob];
+        for(int iBand=0;iBand<psJob->nBands;iBand++)
+        {
+            if( psJob->papaChunk != NULL )
+                CPLFree(psJob->papaChunk[iBand]);
+            if( bOwnDstBands && psJob->papoDstBands != NULL )
+                delete psJob->papoDstBands[iBand];
+        }
+        CPLFree(psJob->papaChunk);
+        CPLFree(psJob->papoDstBands);
+        CPLFree(psJob->pabyChunkNoDataMask);
+    }
+    asJobs.clear();
+}
+
+/************************************************************************/
+/*                       GDALComputeNoDataMask()                        */
+/************************************************************************/
+
+/* Compute a validity mask from values of data type eDT, following the  */
+/* same rules as GDALNoDataMaskBand, so that a level computed from the  */
+/* lines held in memory gets the mask it would have got if read back    */
+/* from the overview band.                                              */
+
+static void GDALComputeNoDataMask( const void* pData, GDALDataType eDT,
+                                   int nCount, double dfNoDataValue,
+                                   GByte* pabyMask )
+{
+    GDALDataType eWrkDT;
+    switch( eDT )
+    {
+      case GDT_Byte:
+        eWrkDT = GDT_Byte;
+        break;
+
+      case GDT_UInt16:
+      case GDT_UInt32:
+        eWrkDT = GDT_UInt32;
+        break;
+
+      case GDT_Int16:
+      case GDT_Int32:
+        eWrkDT = GDT_Int32;
+        break;
+
+      case GDT_Float32:
+        eWrkDT = GDT_Float32;
+        break;
+
+      default:
+        eWrkDT = GDT_Float64;
+        break;
+    }
+
+    const int bIsNoDataNan = CPLIsNan(dfNoDataValue);
+    const int nSrcDTSize = GDALGetDataTypeSizeBytes(eDT);
+    double adfWrk[256];
+    for( int iStart = 0; iStart < nCount; iStart += 256 )
+    {
+        const int nThisCount = MIN(256, nCount - iStart);
+        GDALCopyWords( static_cast<const GByte*>(pData) + iStart * nSrcDTSize,
+                       eDT, nSrcDTSize,
+                       adfWrk, eWrkDT, GDALGetDataTypeSizeBytes(eWrkDT),
+                       nThisCount );
+        GByte* pabyOut = pabyMask + iStart;
+        switch( eWrkDT )
+        {
+          case GDT_Byte:
+          {
+              const GByte byNoData = (GByte) dfNoDataValue;
+              const GByte* pabyVal = reinterpret_cast<const GByte*>(adfWrk);
+              for( int i = 0; i < nThisCount; i++ )
+                  pabyOut[i] = (pabyVal[i] == byNoData) ? 0 : 255;
+          }
+          break;
+
+          case GDT_UInt32:
+          {
+              const GUInt32 nNoData = (GUInt32) dfNoDataValue;
+              const GUInt32* panVal = reinterpret_cast<const GUInt32*>(adfWrk);
+              for( int i = 0; i < nThisCount; i++ )
+                  pabyOut[i] = (panVal[i] == nNoData) ? 0 : 255;
+          }
+          break;
+
+          case GDT_Int32:
+          {
+              const GInt32 nNoData = (GInt32) dfNoDataValue;
+              const GInt32* panVal = reinterpret_cast<const GInt32*>(adfWrk);
+              for( int i = 0; i < nThisCount; i++ )
+                  pabyOut[i] = (panVal[i] == nNoData) ? 0 : 255;
+          }
+          break;
+
+          case GDT_Float32:
+          {
+              const float fNoData = (float) dfNoDataValue;
+              const float* pafVal = reinterpret_cast<const float*>(adfWrk);
+              for( int i = 0; i < nThisCount; i++ )
+              {
+                  const float fVal = pafVal[i];
+                  if( bIsNoDataNan && CPLIsNan(fVal) )
+                      pabyOut[i] = 0;
+                  else if( ARE_REAL_EQUAL(fVal, fNoData) )
+                      pabyOut[i] = 0;
+                  else
+                      pabyOut[i] = 255;
+              }
+          }
+          break;
+
+          default:
+          {
+              for( int i = 0; i < nThisCount; i++ )
+              {
+                  const double dfVal = adfWrk[i];
+                  if( bIsNoDataNan && CPLIsNan(dfVal) )
+                      pabyOut[i] = 0;
+                  else if( ARE_REAL_EQUAL(dfVal, dfNoDataValue) )
+                      pabyOut[i] = 0;
+                  else
+                      pabyOut[i] = 255;
+              }
+          }
+          break;
+        }
+    }
+}
+
+/************************************************************************/
+/*                      GDALOverviewPyramidBuilder                      */
+/************************************************************************/
+
+/* Single-pass builder for a cascade of overview levels. The base       */
+/* raster is read once, from top to bottom. Each level is computed from */
+/* the lines of the level above it while they are still in memory,      */
+/* instead of reading them back from the overview band, so all the      */
+/* levels get written in the same pass.                                 */
+/*                                                                      */
+/* Each level keeps a rolling window of the source lines it still       */
+/* needs. Output is computed in chunks of whole overview lines, sized   */
+/* after the overview block height so that blocks are written once.    */
+/* When replacing the band per band cascade, chunks are rather cut in   */
+/* the source lines, as GDALRegenerateOverviews() does, since some      */
+/* kernels clip their window at chunk boundaries.                       */
+
+class GDALOverviewPyramidBuilder
+{
+    struct Level
+    {
+        GDALDataType        eSrcDataType;
+        int                 nSrcWidth;
+        int                 nSrcHeight;
+        int                 nDstWidth;
+        int                 nDstHeight;
+        double              dfXRatioDstToSrc;
+        double              dfYRatioDstToSrc;
+        int                 nMargin;
+        int                 nDstYChunk;
+        int                 nSrcYChunk;
+        int                 nSrcChunkYOff;
+        GDALDataType        eWrkDataType;
+        int                 nBufCapacity;
+        int                 nBufYOff;
+        int                 nBufLines;
+        std::vector<void*>  apBuf;
+        GByte              *pabyMaskBuf;
+        bool                bUseMask;
+        double              dfSrcNoDataValue;
+        std::vector<int>    abHasNoData;
+        std::vector<float>  afNoDataValue;
+        std::vector<GDALRasterBand*> apoDstBands;
+        std::vector<GDALRasterBand*> apoResampleBuffers;
+        int                 nDstYOff;
+    };
+
+    int                     nBands;
+    GDALRasterBand        **papoSrcBands;
+    int                     nLevels;
+    GDALRasterBand       ***papapoOverviewBands;
+    const char             *pszResampling;
+    bool                    bChunkOnSource;
+    GDALResampleFunction    pfnResampleFn;
+    int                     nKernelRadius;
+    CPLWorkerThreadPool    *poThreadPool;
+    std::vector<Level>      asLevels;
+
+    bool            InitLevels();
+    static bool     HasPendingChunk( const Level& oLevel );
+    int             MakeRoom( Level& oLevel );
+    void            GetChunk( const Level& oLevel, int* pnDstYCount,
+                              int* pnChunkYOffQueried,
+                              int* pnChunkYSizeQueried );
+    CPLErr          ProcessReadyChunks( int iLevel );
+    CPLErr          ResampleChunk( Level& oLevel, int nDstYCount,
+                                   int nChunkYOffQueried,
+                                   int nChunkYSizeQueried );
+    CPLErr          PushToNextLevel( int iLevel, int nDstYCount );
+
+  public:
+                    GDALOverviewPyramidBuilder( int nBands,
+                                                GDALRasterBand** papoSrcBands,
+                                                int nOverviews,
+                                                GDALRasterBand*** papapoOverviewBands,
+                                                const char* pszResampling,
+                                                bool bChunkOnSource );
+                   ~GDALOverviewPyramidBuilder();
+
+    static bool     CanHandle( int nBands, GDALRasterBand** papoSrcBands,
+                               int nOverviews,
+                               GDALRasterBand*** papapoOverviewBands,
+                               const char* pszResampling );
+    CPLErr          Run( GDALProgressFunc pfnProgress, void* pProgressData );
+};
+
+/************************************************************************/
+/*                              CanHandle()                             */
+/************************************************************************/
+
+/* Whether the single-pass builder gives the same result as computing   */
+/* each level from the previous one read back from its overview band.   */
+
+bool GDALOverviewPyramidBuilder::CanHandle( int nBands,
+                                            GDALRasterBand** papoSrcBands,
+                                            int nOverviews,
+                                            GDALRasterBand*** papapoOverviewBands,
+                                            const char* pszResampling )
+{
+    if( !CPLTestBool(CPLGetConfigOption("GDAL_OVR_SINGLE_PASS", "YES")) )
+        return false;
+
+    const bool bNearest = STARTS_WITH_CI(pszResampling, "NEAR");
+    if( !bNearest &&
+        !EQUAL(pszResampling, "AVERAGE") &&
+        !EQUAL(pszResampling, "GAUSS") &&
+        !EQUAL(pszResampling, "CUBIC") &&
+        !EQUAL(pszResampling, "CUBICSPLINE") &&
+        !EQUAL(pszResampling, "LANCZOS") &&
+        !EQUAL(pszResampling, "BILINEAR") )
+        return false;
+
+    if( nBands < 1 || nOverviews < 1 )
+        return false;
+
+    GDALRasterBand* poPrevBand = papoSrcBands[0];
+    for( int iOverview = 0; iOverview < nOverviews; iOverview++ )
+    {
+        GDALRasterBand* poOvrBand = papapoOverviewBands[0][iOverview];
+        if( GDALDataTypeIsComplex(poPrevBand->GetRasterDataType()) ||
+            GDALDataTypeIsComplex(poOvrBand->GetRasterDataType()) )
+            return false;
+
+        // Levels must go from the largest to the smallest one.
+        if( poOvrBand->GetXSize() >= poPrevBand->GetXSize() ||
+            poOvrBand->GetYSize() > poPrevBand->GetYSize() )
+            return false;
+
+        // The mask of intermediate levels is recomputed from their
+        // nodata value.
+        if( iOverview > 0 && !bNearest &&
+            poPrevBand->GetMaskFlags() != GMF_ALL_VALID &&
+            poPrevBand->GetMaskFlags() != GMF_NODATA )
+            return false;
+
+        for( int iBand = 1; iBand < nBands; iBand++ )
+        {
+            if( papapoOverviewBands[iBand][iOverview]->GetXSize() !=
+                                                    poOvrBand->GetXSize() ||
+                papapoOverviewBands[iBand][iOverview]->GetYSize() !=
+                                                    poOvrBand->GetYSize() )
+                return false;
+        }
+        poPrevBand = poOvrBand;
+    }
+    return true;
+}
+
+/************************************************************************/
+/*                     GDALOverviewPyramidBuilder()                     */
+/************************************************************************/
+
+GDALOverviewPyramidBuilder::GDALOverviewPyramidBuilder(
+                                int nBandsIn, GDALRasterBand** papoSrcBandsIn,
+                                int nOverviews,
+                                GDALRasterBand*** papapoOverviewBandsIn,
+                                const char* pszResamplingIn,
+                                bool bChunkOnSourceIn ) :
+    nBands(nBandsIn),
+    papoSrcBands(papoSrcBandsIn),
+    nLevels(nOverviews),
+    papapoOverviewBands(papapoOverviewBandsIn),
+    pszResampling(pszResamplingIn),
+    bChunkOnSource(bChunkOnSourceIn),
+    pfnResampleFn(NULL),
+    nKernelRadius(0),
+    poThreadPool(NULL)
+{
+}
+
+/************************************************************************/
+/*                    ~GDALOverviewPyramidBuilder()                     */
+/************************************************************************/
+
+GDALOverviewPyramidBuilder::~GDALOverviewPyramidBuilder()
+{
+    delete poThreadPool;
+    for( size_t iLevel = 0; iLevel < asLevels.size(); iLevel++ )
+    {
+        Level& oLevel = asLevels[iLevel];
+        for( size_t iBand = 0; iBand < oLevel.apBuf.size(); iBand++ )
+            VSIFree(oLevel.apBuf[iBand]);
+        for( size_t iBand = 0; iBand < oLevel.apoResampleBuffers.size(); iBand++ )
+            delete oLevel.apoResampleBuffers[iBand];
+        VSIFree(oLevel.pabyMaskBuf);
+    }
+}
+
+/************************************************************************/
+/*                             InitLevels()                             */
+/************************************************************************/
+
+bool GDALOverviewPyramidBuilder::InitLevels()
+{
+    pfnResampleFn = GDALGetResampleFunction(pszResampling, &nKernelRadius);
+    if( pfnResampleFn == NULL )
+        return false;
+
+    const bool bNearest = STARTS_WITH_CI(pszResampling, "NEAR");
+    asLevels.resize(nLevels);
+    for( int iLevel = 0; iLevel < nLevels; iLevel++ )
+    {
+        Level& oLevel = asLevels[iLevel];
+        oLevel.pabyMaskBuf = NULL;
+
+        GDALRasterBand* poSrcBand0 = (iLevel == 0) ? papoSrcBands[0] :
+                                    papapoOverviewBands[0][iLevel - 1];
+        GDALRasterBand* poDstBand0 = papapoOverviewBands[0][iLevel];
+
+        oLevel.eSrcDataType = poSrcBand0->GetRasterDataType();
+        oLevel.nSrcWidth = poSrcBand0->GetXSize();
+        oLevel.nSrcHeight = poSrcBand0->GetYSize();
+        oLevel.nDstWidth = poDstBand0->GetXSize();
+        oLevel.nDstHeight = poDstBand0->GetYSize();
+        oLevel.dfXRatioDstToSrc = (double)oLevel.nSrcWidth / oLevel.nDstWidth;
+        oLevel.dfYRatioDstToSrc = (double)oLevel.nSrcHeight / oLevel.nDstHeight;
+
+        int nOvrFactor = MAX( (int)(0.5 + oLevel.dfXRatioDstToSrc),
+                              (int)(0.5 + oLevel.dfYRatioDstToSrc) );
+        if( nOvrFactor == 0 ) nOvrFactor = 1;
+        oLevel.nMargin = nKernelRadius * nOvrFactor;
+
+        int nDstBlockXSize, nDstBlockYSize;
+        poDstBand0->GetBlockSize(&nDstBlockXSize, &nDstBlockYSize);
+        if( nDstBlockYSize < 16 || nDstBlockYSize > 256 )
+            oLevel.nDstYChunk = 32;
+        else
+            oLevel.nDstYChunk = nDstBlockYSize;
+
+        // Same source chunk height as GDALRegenerateOverviews().
+        oLevel.nSrcYChunk = 0;
+        oLevel.nSrcChunkYOff = 0;
+        if( bChunkOnSource )
+        {
+            int nSrcBlockXSize, nSrcBlockYSize;
+            poSrcBand0->GetBlockSize(&nSrcBlockXSize, &nSrcBlockYSize);
+            if( nSrcBlockYSize < 16 || nSrcBlockYSize > 256 )
+                oLevel.nSrcYChunk = 64;
+            else
+                oLevel.nSrcYChunk = nSrcBlockYSize;
+        }
+
+        oLevel.eWrkDataType =
+            GDALGetOvrWorkDataType(pszResampling, oLevel.eSrcDataType);
+        oLevel.nBufCapacity = 2 + 2 * oLevel.nMargin +
+            MAX( (int)(oLevel.nDstYChunk * oLevel.dfYRatioDstToSrc),
+                 oLevel.nSrcYChunk );
+        oLevel.nBufYOff = 0;
+        oLevel.nBufLines = 0;
+        oLevel.nDstYOff = 0;
+
+        if( iLevel == 0 )
+        {
+            oLevel.bUseMask = !bNearest &&
+                (poSrcBand0->GetMaskFlags() & GMF_ALL_VALID) == 0;
+            oLevel.dfSrcNoDataValue = 0.0;
+        }
+        else
+        {
+            int bHasNoData = FALSE;
+            oLevel.dfSrcNoDataValue = poSrcBand0->GetNoDataValue(&bHasNoData);
+            oLevel.bUseMask = !bNearest &&
+                poSrcBand0->GetMaskFlags() == GMF_NODATA;
+        }
+
+        for( int iBand = 0; iBand < nBands; iBand++ )
+        {
+            GDALRasterBand* poSrcBand = (iLevel == 0) ? papoSrcBands[iBand] :
+                                    papapoOverviewBands[iBand][iLevel - 1];
+            int bHasNoData = FALSE;
+            const float fNoDataValue =
+                (float) poSrcBand->GetNoDataValue(&bHasNoData);
+            oLevel.abHasNoData.push_back(bHasNoData);
+            oLevel.afNoDataValue.push_back(fNoDataValue);
+
+            void* pBuf = VSI_MALLOC3_VERBOSE(
+                oLevel.nBufCapacity, oLevel.nSrcWidth,
+                GDALGetDataTypeSizeBytes(oLevel.eWrkDataType) );
+            oLevel.apBuf.push_back(pBuf);
+            if( pBuf == NULL )
+                return false;
+
+            oLevel.apoDstBands.push_back(papapoOverviewBands[iBand][iLevel]);
+            oLevel.apoResampleBuffers.push_back(
+                new GDALOverviewResampleBuffer(
+                    papapoOverviewBands[iBand][iLevel]));
+        }
+
+        if( oLevel.bUseMask )
+        {
+            oLevel.pabyMaskBuf = (GByte*) VSI_MALLOC2_VERBOSE(
+                oLevel.nBufCapacity, oLevel.nSrcWidth );
+            if( oLevel.pabyMaskBuf == NULL )
+                return false;
+        }
+    }
+
+    poThreadPool = GDALCreateOverviewThreadPool();
+    return true;
+}
+
+/************************************************************************/
+/*                           HasPendingChunk()                          */
+/************************************************************************/
+
+bool GDALOverviewPyramidBuilder::HasPendingChunk( const Level& oLevel )
+{
+    if( oLevel.nSrcYChunk > 0 )
+        return oLevel.nSrcChunkYOff < oLevel.nSrcHeight;
+    return oLevel.nDstYOff < oLevel.nDstHeight;
+}
+
+/************************************************************************/
+/*                              GetChunk()                              */
+/************************************************************************/
+
+/* Source lines needed to compute the next chunk of a level. */
+
+void GDALOverviewPyramidBuilder::GetChunk( const Level& oLevel,
+                                           int* pnDstYCount,
+                                           int* pnChunkYOffQueried,
+                                           int* pnChunkYSizeQueried )
+{
+    int nDstYCount, nChunkYOff, nChunkYOff2;
+    if( oLevel.nSrcYChunk > 0 )
+    {
+        nChunkYOff = oLevel.nSrcChunkYOff;
+        nChunkYOff2 = MIN(nChunkYOff + oLevel.nSrcYChunk, oLevel.nSrcHeight);
+
+        int nDstYOff, nDstYOff2;
+        GDALGetOverviewDstLines( nChunkYOff, nChunkYOff2 - nChunkYOff,
+                                 oLevel.nSrcHeight, oLevel.nDstHeight,
+                                 &nDstYOff, &nDstYOff2 );
+        CPLAssert( nDstYOff == oLevel.nDstYOff );
+        nDstYCount = MAX(0, nDstYOff2 - nDstYOff);
+    }
+    else
+    {
+        const int nDstYOff = oLevel.nDstYOff;
+        nDstYCount = MIN(oLevel.nDstYChunk, oLevel.nDstHeight - nDstYOff);
+
+        nChunkYOff = (int) (0.5 + nDstYOff * oLevel.dfYRatioDstToSrc);
+        nChunkYOff2 =
+            (int) (0.5 + (nDstYOff + nDstYCount) * oLevel.dfYRatioDstToSrc);
+        if( nChunkYOff2 > oLevel.nSrcHeight ||
+            nDstYOff + nDstYCount == oLevel.nDstHeight )
+            nChunkYOff2 = oLevel.nSrcHeight;
+    }
+
+    int nChunkYOffQueried = nChunkYOff - oLevel.nMargin;
+    int nChunkYSizeQueried = nChunkYOff2 - nChunkYOff + 2 * oLevel.nMargin;
+    if( nChunkYOffQueried < 0 )
+    {
+        nChunkYSizeQueried += nChunkYOffQueried;
+        nChunkYOffQueried = 0;
+    }
+    if( nChunkYSizeQueried + nChunkYOffQueried > oLevel.nSrcHeight )
+        nChunkYSizeQueried = oLevel.nSrcHeight - nChunkYOffQueried;
+
+    *pnDstYCount = nDstYCount;
+    *pnChunkYOffQueried = nChunkYOffQueried;
+    *pnChunkYSizeQueried = nChunkYSizeQueried;
 }
 
 /************************************************************************/
-/*                    GDALGetResampleFunctionMultiBands()               */
+/*                              MakeRoom()                              */
 /************************************************************************/
 
-GDALResampleFunctionMultiBands GDALGetResampleFunctionMultiBands(
-                                                 const char* pszResampling,
-                                                 int* pnRadius)
+/* Discard the buffered source lines that the remaining chunks of the   */
+/* level no longer need, and return the number of free lines.           */
+
+int GDALOverviewPyramidBuilder::MakeRoom( Level& oLevel )
 {
-    if( pnRadius ) *pnRadius = 0;
-    if( EQUAL(pszResampling,"CUBIC") )
+    int nDrop = oLevel.nBufLines;
+    if( HasPendingChunk(oLevel) )
     {
-        if( pnRadius ) *pnRadius = GWKGetFilterRadius(GRA_Cubic);
-        return GDALResampleChunk32RMultiBands_Convolution;
+        int nDstYCount, nChunkYOffQueried, nChunkYSizeQueried;
+        GetChunk(oLevel, &nDstYCount, &nChunkYOffQueried, &nChunkYSizeQueried);
+        nDrop = MIN(nDrop, nChunkYOffQueried - oLevel.nBufYOff);
     }
-    else if( EQUAL(pszResampling,"CUBICSPLINE") )
+    if( nDrop > 0 )
     {
-        if( pnRadius ) *pnRadius = GWKGetFilterRadius(GRA_CubicSpline);
-        return GDALResampleChunk32RMultiBands_Convolution;
+        const size_t nLineSize = static_cast<size_t>(oLevel.nSrcWidth) *
+                            GDALGetDataTypeSizeBytes(oLevel.eWrkDataType);
+        for( int iBand = 0; iBand < nBands; iBand++ )
+        {
+            GByte* pabyBuf = static_cast<GByte*>(oLevel.apBuf[iBand]);
+            memmove(pabyBuf, pabyBuf + nDrop * nLineSize,
+                    (oLevel.nBufLines - nDrop) * nLineSize);
+        }
+        if( oLevel.bUseMask )
+        {
+            memmove(oLevel.pabyMaskBuf,
+                    oLevel.pabyMaskBuf +
+                        static_cast<size_t>(nDrop) * oLevel.nSrcWidth,
+                    static_cast<size_t>(oLevel.nBufLines - nDrop) *
+                        oLevel.nSrcWidth);
+        }
+        oLevel.nBufYOff += nDrop;
+        oLevel.nBufLines -= nDrop;
     }
-    else if( EQUAL(pszResampling,"LANCZOS") )
+    return oLevel.nBufCapacity - oLevel.nBufLines;
+}
+
+/************************************************************************/
+/*                            ResampleChunk()                           */
+/************************************************************************/
+
+/* Compute the next chunk of a level into its resample buffers. With a  */
+/* thread pool, the chunk is split into one job per band and group of   */
+/* lines.                                                               */
+
+CPLErr GDALOverviewPyramidBuilder::ResampleChunk( Level& oLevel,
+                                                  int nDstYCount,
+                                                  int nChunkYOffQueried,
+                                                  int nChunkYSizeQueried )
+{
+    const size_t nSkip =
+        static_cast<size_t>(nChunkYOffQueried - oLevel.nBufYOff) *
+                                                        oLevel.nSrcWidth;
+    std::vector<void*> apChunk(nBands);
+    for( int iBand = 0; iBand < nBands; iBand++ )
     {
-        if( pnRadius ) *pnRadius = GWKGetFilterRadius(GRA_Lanczos);
-        return GDALResampleChunk32RMultiBands_Convolution;
+        apChunk[iBand] = static_cast<GByte*>(oLevel.apBuf[iBand]) +
+                    nSkip * GDALGetDataTypeSizeBytes(oLevel.eWrkDataType);
+        if( !static_cast<GDALOverviewResampleBuffer*>(
+                oLevel.apoResampleBuffers[iBand])->SetWindow(
+                    0, oLevel.nDstYOff, oLevel.nDstWidth, nDstYCount) )
+            return CE_Failure;
     }
-    else if( EQUAL(pszResampling,"BILINEAR") )
+
+    int nSlices = 1;
+    if( poThreadPool != NULL )
+        nSlices = MIN(poThreadPool->GetThreadCount(), nDstYCount);
+
+    std::vector<GDALOverviewBlockJob> asJobs(nBands * nSlices);
+    memset(&asJobs[0], 0, asJobs.size() * sizeof(GDALOverviewBlockJob));
+    std::vector<void*> apJobs;
+    for( int iBand = 0; iBand < nBands; iBand++ )
     {
-        if( pnRadius ) *pnRadius = GWKGetFilterRadius(GRA_Bilinear);
-        return GDALResampleChunk32RMultiBands_Convolution;
+        for( int iSlice = 0; iSlice < nSlices; iSlice++ )
+        {
+            const int nSliceYOff = nDstYCount * iSlice / nSlices;
+            const int nSliceYOff2 = nDstYCount * (iSlice + 1) / nSlices;
+            GDALOverviewBlockJob* psJob = &asJobs[iBand * nSlices + iSlice];
+            psJob->pfnResampleFn = pfnResampleFn;
+            psJob->pszResampling = pszResampling;
+            psJob->dfXRatioDstToSrc = oLevel.dfXRatioDstToSrc;
+            psJob->dfYRatioDstToSrc = oLevel.dfYRatioDstToSrc;
+            psJob->eWrkDataType = oLevel.eWrkDataType;
+            psJob->eSrcDataType = oLevel.eSrcDataType;
+            psJob->nBands = 1;
+            psJob->papaChunk = &apChunk[iBand];
+            psJob->pabyChunkNoDataMask = oLevel.bUseMask ?
+                                    oLevel.pabyMaskBuf + nSkip : NULL;
+            psJob->nChunkXOffQueried = 0;
+            psJob->nChunkXSizeQueried = oLevel.nSrcWidth;
+            psJob->nChunkYOffQueried = nChunkYOffQueried;
+            psJob->nChunkYSizeQueried = nChunkYSizeQueried;
+            psJob->nDstXOff = 0;
+            psJob->nDstXCount = oLevel.nDstWidth;
+            psJob->nDstYOff = oLevel.nDstYOff + nSliceYOff;
+            psJob->nDstYCount = nSliceYOff2 - nSliceYOff;
+            psJob->pabHasNoData = &oLevel.abHasNoData[iBand];
+            psJob->pafNoDataValue = &oLevel.afNoDataValue[iBand];
+            psJob->papoDstBands = &oLevel.apoResampleBuffers[iBand];
+            apJobs.push_back(psJob);
+        }
+    }
+
+    CPLErr eErr = CE_None;
+    if( poThreadPool != NULL && apJobs.size() > 1 )
+    {
+        if( !poThreadPool->SubmitJobs(GDALOverviewBlockJobFunc, apJobs) )
+            return CE_Failure;
+        poThreadPool->WaitCompletion();
+        for( size_t iJob = 0; iJob < asJobs.size(); iJob++ )
+        {
+            if( asJobs[iJob].eErr != CE_None )
+                eErr = asJobs[iJob].eErr;
+        }
     }
     else
     {
-        return NULL;
+        for( size_t iJob = 0; iJob < asJobs.size() && eErr == CE_None; iJob++ )
+            eErr = GDALResampleOverviewBlock(&asJobs[iJob]);
+    }
+
+    for( int iBand = 0; iBand < nBands && eErr == CE_None; iBand++ )
+    {
+        eErr = static_cast<GDALOverviewResampleBuffer*>(
+                    oLevel.apoResampleBuffers[iBand])->FlushToTarget();
     }
+    return eErr;
 }
-#endif
 
 /************************************************************************/
-/*                      GDALGetOvrWorkDataType()                        */
+/*                           PushToNextLevel()                          */
 /************************************************************************/
 
-GDALDataType GDALGetOvrWorkDataType(const char* pszResampling,
-                                        GDALDataType eSrcDataType)
+/* Feed the lines of the chunk just computed for level iLevel to the    */
+/* level below it, converted to the working data type, as they would    */
+/* have been read back from the overview band.                          */
+
+CPLErr GDALOverviewPyramidBuilder::PushToNextLevel( int iLevel,
+                                                    int nDstYCount )
 {
-    if( (STARTS_WITH_CI(pszResampling, "NEAR") ||
-         STARTS_WITH_CI(pszResampling, "AVER") ||
-         EQUAL(pszResampling,"CUBIC") ||
-         EQUAL(pszResampling,"CUBICSPLINE") ||
-         EQUAL(pszResampling,"LANCZOS") ||
-         EQUAL(pszResampling,"BILINEAR")) &&
-        eSrcDataType == GDT_Byte)
-        return GDT_Byte;
-    else if( (STARTS_WITH_CI(pszResampling, "NEAR") ||
-         STARTS_WITH_CI(pszResampling, "AVER") ||
-         EQUAL(pszResampling,"CUBIC") ||
-         EQUAL(pszResampling,"CUBICSPLINE") ||
-         EQUAL(pszResampling,"LANCZOS") ||
-         EQUAL(pszResampling,"BILINEAR")) &&
-        eSrcDataType == GDT_UInt16)
-        return GDT_UInt16;
-    else
-        return GDT_Float32;
+    Level& oLevel = asLevels[iLevel];
+    Level& oNext = asLevels[iLevel + 1];
+    const int nWidth = oLevel.nDstWidth;
+    const int nNextDTSize = GDALGetDataTypeSizeBytes(oNext.eWrkDataType);
+
+    CPLErr eErr = CE_None;
+    int nDone = 0;
+    while( nDone < nDstYCount && eErr == CE_None )
+    {
+        const int nLines = MIN(MakeRoom(oNext), nDstYCount - nDone);
+        if( nLines <= 0 )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "GDALOverviewPyramidBuilder: buffer overflow");
+            return CE_Failure;
+        }
+
+        for( int iBand = 0; iBand < nBands; iBand++ )
+        {
+            GDALOverviewResampleBuffer* poBuffer =
+                static_cast<GDALOverviewResampleBuffer*>(
+                                        oLevel.apoResampleBuffers[iBand]);
+            const GDALDataType eDT = poBuffer->GetRasterDataType();
+            const int nDTSize = GDALGetDataTypeSizeBytes(eDT);
+            for( int iLine = 0; iLine < nLines; iLine++ )
+            {
+                const GByte* pabySrc = poBuffer->GetWindowData() +
+                    static_cast<size_t>(nDone + iLine) * nWidth * nDTSize;
+                GDALCopyWords( pabySrc, eDT, nDTSize,
+                               static_cast<GByte*>(oNext.apBuf[iBand]) +
+                                static_cast<size_t>(oNext.nBufLines + iLine) *
+                                    nWidth * nNextDTSize,
+                               oNext.eWrkDataType, nNextDTSize,
+                               nWidth );
+                if( iBand == 0 && oNext.bUseMask )
+                {
+                    GDALComputeNoDataMask( pabySrc, eDT, nWidth,
+                                           oNext.dfSrcNoDataValue,
+                                           oNext.pabyMaskBuf +
+                                            static_cast<size_t>(
+                                                oNext.nBufLines + iLine) *
+                                                                nWidth );
+                }
+            }
+        }
+        oNext.nBufLines += nLines;
+        nDone += nLines;
+
+        eErr = ProcessReadyChunks(iLevel + 1);
+    }
+    return eErr;
+}
+
+/************************************************************************/
+/*                         ProcessReadyChunks()                         */
+/************************************************************************/
+
+/* Compute all the chunks of a level whose source lines are available. */
+
+CPLErr GDALOverviewPyramidBuilder::ProcessReadyChunks( int iLevel )
+{
+    Level& oLevel = asLevels[iLevel];
+    CPLErr eErr = CE_None;
+    while( HasPendingChunk(oLevel) && eErr == CE_None )
+    {
+        int nDstYCount, nChunkYOffQueried, nChunkYSizeQueried;
+        GetChunk(oLevel, &nDstYCount, &nChunkYOffQueried, &nChunkYSizeQueried);
+        if( nChunkYOffQueried + nChunkYSizeQueried >
+                                    oLevel.nBufYOff + oLevel.nBufLines )
+            break;
+        CPLAssert( nChunkYOffQueried >= oLevel.nBufYOff );
+
+        if( nDstYCount > 0 )
+        {
+            eErr = ResampleChunk(oLevel, nDstYCount,
+                                 nChunkYOffQueried, nChunkYSizeQueried);
+            if( eErr == CE_None && iLevel + 1 < nLevels )
+                eErr = PushToNextLevel(iLevel, nDstYCount);
+        }
+        oLevel.nDstYOff += nDstYCount;
+        oLevel.nSrcChunkYOff += oLevel.nSrcYChunk;
+    }
+    return eErr;
+}
+
+/************************************************************************/
+/*                                 Run()                                */
+/************************************************************************/
+
+CPLErr GDALOverviewPyramidBuilder::Run( GDALProgressFunc pfnProgress,
+                                        void* pProgressData )
+{
+    if( pfnProgress == NULL )
+        pfnProgress = GDALDummyProgress;
+
+    if( !InitLevels() )
+        return CE_Failure;
+
+    Level& oFirst = asLevels[0];
+    const int nDTSize = GDALGetDataTypeSizeBytes(oFirst.eWrkDataType);
+    GDALRasterBand* poMaskBand =
+        oFirst.bUseMask ? papoSrcBands[0]->GetMaskBand() : NULL;
+
+    CPLErr eErr = CE_None;
+    int nSrcYOff = 0;
+    while( nSrcYOff < oFirst.nSrcHeight && eErr == CE_None )
+    {
+        if( !pfnProgress( nSrcYOff / (double) oFirst.nSrcHeight,
+                          NULL, pProgressData ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+            break;
+        }
+
+        const int nLines = MIN(MakeRoom(oFirst),
+                               oFirst.nSrcHeight - nSrcYOff);
+        if( nLines <= 0 )
+        {
+            CPLError(CE_Failure, CPLE_AppDefined,
+                     "GDALOverviewPyramidBuilder: buffer overflow");
+            eErr = CE_Failure;
+            break;
+        }
+
+        for( int iBand = 0; iBand < nBands && eErr == CE_None; iBand++ )
+        {
+            eErr = papoSrcBands[iBand]->RasterIO( GF_Read,
+                        0, nSrcYOff, oFirst.nSrcWidth, nLines,
+                        static_cast<GByte*>(oFirst.apBuf[iBand]) +
+                            static_cast<size_t>(oFirst.nBufLines) *
+                                oFirst.nSrcWidth * nDTSize,
+                        oFirst.nSrcWidth, nLines, oFirst.eWrkDataType,
+                        0, 0, NULL );
+        }
+        if( eErr == CE_None && poMaskBand != NULL )
+        {
+            eErr = poMaskBand->RasterIO( GF_Read,
+                        0, nSrcYOff, oFirst.nSrcWidth, nLines,
+                        oFirst.pabyMaskBuf +
+                            static_cast<size_t>(oFirst.nBufLines) *
+                                oFirst.nSrcWidth,
+                        oFirst.nSrcWidth, nLines, GDT_Byte,
+                        0, 0, NULL );
+        }
+        if( eErr != CE_None )
+            break;
+
+        oFirst.nBufLines += nLines;
+        nSrcYOff += nLines;
+
+        eErr = ProcessReadyChunks(0);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      It can be important to flush out data to overviews.             */
+/* -------------------------------------------------------------------- */
+    for( int iLevel = 0; iLevel < nLevels && eErr == CE_None; iLevel++ )
+    {
+        for( int iBand = 0; iBand < nBands && eErr == CE_None; iBand++ )
+            eErr = papapoOverviewBands[iBand][iLevel]->FlushCache();
+    }
+
+    if( eErr == CE_None )
+        pfnProgress( 1.0, NULL, pProgressData );
+
+    return eErr;
 }
 
 /************************************************************************/
@@ -2279,6 +3563,17 @@ GDALDataType GDALGetOvrWorkDataType(const char* pszResampling,
  * that only a given RGB triplet (in case of a RGB image) will be considered as the
  * nodata value and not each value of the triplet independently per band.
  *
+ * Starting with GDAL 2.2, the GDAL_NUM_THREADS configuration option can be
+ * set to a number of worker threads (or ALL_CPUS) so that the chunks of the
+ * source band are resampled in parallel. Output is written from the calling
+ * thread only.
+ *
+ * Starting with GDAL 2.2, when several overview levels are computed in
+ * cascade (averaging, gaussian and convolution kernels), they are all
+ * computed in a single pass over the source band, each level being fed with
+ * the lines of the previous level while they are still in memory. This can
+ * be disabled by setting the GDAL_OVR_SINGLE_PASS configuration option to NO.
+ *
  * @param hSrcBand the source (base level) band.
  * @param nOverviewCount the number of downsampled bands being generated.
  * @param pahOvrBands the list of downsampled bands to be generated.
@@ -2395,11 +3690,31 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
          EQUAL(pszResampling,"LANCZOS") ||
          EQUAL(pszResampling,"BILINEAR")) && nOverviewCount > 1
          && !(bUseNoDataMask && nMaskFlags != GMF_NODATA))
+    {
+        /* Compute all the levels in a single pass over the source band */
+        /* when possible, rather than reading back each level to */
+        /* compute the next one. */
+        GDALSortOverviewBandsBySize( nOverviewCount, papoOvrBands );
+        if( poColorTable == NULL &&
+            poSrcBand->GetColorInterpretation() != GCI_PaletteIndex &&
+            GDALOverviewPyramidBuilder::CanHandle( 1, &poSrcBand,
+                                                   nOverviewCount,
+                                                   &papoOvrBands,
+                                                   pszResampling ) )
+        {
+            GDALOverviewPyramidBuilder oBuilder( 1, &poSrcBand,
+                                                 nOverviewCount,
+                                                 &papoOvrBands,
+                                                 pszResampling, true );
+            return oBuilder.Run( pfnProgress, pProgressData );
+        }
+
         return GDALRegenerateCascadingOverviews( poSrcBand,
                                                  nOverviewCount, papoOvrBands,
                                                  pszResampling,
                                                  pfnProgress,
                                                  pProgressData );
+    }
 
 /* -------------------------------------------------------------------- */
 /*      Setup one horizontal swath to read from the raw buffer.         */
@@ -2432,31 +3747,72 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
     }
     const int nMaxChunkYSizeQueried = nFullResYChunk + 2 * nKernelRadius * nMaxOvrFactor;
 
-    GByte *pabyChunkNodataMask = NULL;
-    void *pChunk =
-        VSI_MALLOC3_VERBOSE(
-            GDALGetDataTypeSizeBytes(eType), nMaxChunkYSizeQueried, nWidth );
-    if (bUseNoDataMask)
-    {
-        pabyChunkNodataMask =
-            (GByte*) VSI_MALLOC2_VERBOSE( nMaxChunkYSizeQueried, nWidth );
-    }
+    int bHasNoData;
+    const float fNoDataValue = (float) poSrcBand->GetNoDataValue(&bHasNoData);
 
-    if( pChunk == NULL || (bUseNoDataMask && pabyChunkNodataMask == NULL))
+/* -------------------------------------------------------------------- */
+/*      With GDAL_NUM_THREADS, chunks are resampled in worker threads   */
+/*      while the calling thread keeps reading the next chunks and      */
+/*      writing the completed ones, in order. One more job than         */
+/*      threads is used so that I/O overlaps with computation.          */
+/* -------------------------------------------------------------------- */
+    CPLWorkerThreadPool* poThreadPool = GDALCreateOverviewThreadPool();
+    const int nJobCount = poThreadPool ? poThreadPool->GetThreadCount() + 1 : 1;
+
+    std::vector<GDALOverviewChunkJob> asJobs(nJobCount);
+    memset(&asJobs[0], 0, nJobCount * sizeof(GDALOverviewChunkJob));
+    bool bAllocOK = true;
+    for( int iJob = 0; iJob < nJobCount && bAllocOK; iJob++ )
     {
-        CPLFree(pChunk);
-        CPLFree(pabyChunkNodataMask);
-        return CE_Failure;
-    }
+        GDALOverviewChunkJob* psJob = &asJobs[iJob];
+        psJob->pfnResampleFn = pfnResampleFn;
+        psJob->pszResampling = pszResampling;
+        psJob->eType = eType;
+        psJob->eSrcDataType = poSrcBand->GetRasterDataType();
+        psJob->nWidth = nWidth;
+        psJob->nHeight = nHeight;
+        psJob->bHasNoData = bHasNoData;
+        psJob->fNoDataValue = fNoDataValue;
+        psJob->poColorTable = poColorTable;
+        psJob->nOverviewCount = nOverviewCount;
+
+        psJob->pChunk =
+            VSI_MALLOC3_VERBOSE(
+                GDALGetDataTypeSizeBytes(eType), nMaxChunkYSizeQueried, nWidth );
+        if (bUseNoDataMask)
+        {
+            psJob->pabyChunkNodataMask =
+                (GByte*) VSI_MALLOC2_VERBOSE( nMaxChunkYSizeQueried, nWidth );
+        }
 
-    int bHasNoData;
-    const float fNoDataValue = (float) poSrcBand->GetNoDataValue(&bHasNoData);
+        if( psJob->pChunk == NULL ||
+            (bUseNoDataMask && psJob->pabyChunkNodataMask == NULL))
+        {
+            bAllocOK = false;
+        }
+        else if( poThreadPool != NULL )
+        {
+            psJob->papoDstBands = (GDALRasterBand**)
+                CPLCalloc(sizeof(GDALRasterBand*), nOverviewCount);
+            for( int iOverview = 0; iOverview < nOverviewCount; iOverview++ )
+            {
+                psJob->papoDstBands[iOverview] =
+                    new GDALOverviewResampleBuffer(papoOvrBands[iOverview]);
+            }
+        }
+        else
+        {
+            psJob->papoDstBands = papoOvrBands;
+        }
+    }
 
 /* -------------------------------------------------------------------- */
 /*      Loop over image operating on chunks.                            */
 /* -------------------------------------------------------------------- */
     int  nChunkYOff = 0;
-    CPLErr eErr = CE_None;
+    CPLErr eErr = bAllocOK ? CE_None : CE_Failure;
+    int nJobsSubmitted = 0;
+    int nJobsInFlight = 0;
 
     for( nChunkYOff = 0;
          nChunkYOff < nHeight && eErr == CE_None;
@@ -2469,6 +3825,20 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
             eErr = CE_Failure;
         }
 
+        /* If all the jobs are busy, write the oldest one to free it */
+        if( poThreadPool != NULL && nJobsInFlight == nJobCount )
+        {
+            eErr = GDALFlushOverviewChunkJob(
+                poThreadPool,
+                &asJobs[(nJobsSubmitted - nJobsInFlight) % nJobCount],
+                nJobsInFlight, eErr );
+            nJobsInFlight --;
+        }
+
+        GDALOverviewChunkJob* psJob = &asJobs[nJobsSubmitted % nJobCount];
+        void* pChunk = psJob->pChunk;
+        GByte* pabyChunkNodataMask = psJob->pabyChunkNodataMask;
+
         if( nFullResYChunk + nChunkYOff > nHeight )
             nFullResYChunk = nHeight - nChunkYOff;
 
@@ -2566,52 +3936,74 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
             }
         }
 
+        if( eErr != CE_None )
+            break;
+
+        psJob->nChunkYOff = nChunkYOff;
+        psJob->nFullResYChunk = nFullResYChunk;
+        psJob->nChunkYOffQueried = nChunkYOffQueried;
+        psJob->nChunkYSizeQueried = nChunkYSizeQueried;
+
+        if( poThreadPool == NULL )
+        {
+            eErr = GDALResampleOverviewChunk(psJob);
+            continue;
+        }
+
         for( int iOverview = 0; iOverview < nOverviewCount && eErr == CE_None; iOverview++ )
         {
             const int nDstWidth = papoOvrBands[iOverview]->GetXSize();
             const int nDstHeight = papoOvrBands[iOverview]->GetYSize();
+            int nDstYOff, nDstYOff2;
+            GDALGetOverviewDstLines( nChunkYOff, nFullResYChunk,
+                                     nHeight, nDstHeight,
+                                     &nDstYOff, &nDstYOff2 );
+            if( !static_cast<GDALOverviewResampleBuffer*>(
+                    psJob->papoDstBands[iOverview])->SetWindow(
+                        0, nDstYOff, nDstWidth, MAX(0, nDstYOff2 - nDstYOff)) )
+            {
+                eErr = CE_Failure;
+            }
+        }
+        if( eErr != CE_None )
+            break;
 
-            const double dfXRatioDstToSrc = (double)nWidth / nDstWidth;
-            const double dfYRatioDstToSrc = (double)nHeight / nDstHeight;
+        psJob->bFinished = FALSE;
+        psJob->eErr = CE_None;
+        if( !poThreadPool->SubmitJob(GDALOverviewChunkJobFunc, psJob) )
+        {
+            eErr = CE_Failure;
+            break;
+        }
+        nJobsSubmitted ++;
+        nJobsInFlight ++;
+    }
 
 /* -------------------------------------------------------------------- */
-/*      Figure out the line to start writing to, and the first line     */
-/*      to not write to.  In theory this approach should ensure that    */
-/*      every output line will be written if all input chunks are       */
-/*      processed.                                                      */
+/*      Write the pending jobs, in order.                               */
 /* -------------------------------------------------------------------- */
-            int nDstYOff = (int) (0.5 + nChunkYOff/dfYRatioDstToSrc);
-            int nDstYOff2 = (int)
-                (0.5 + (nChunkYOff+nFullResYChunk)/dfYRatioDstToSrc);
-
-            if( nChunkYOff + nFullResYChunk == nHeight )
-                nDstYOff2 = nDstHeight;
-            //CPLDebug("GDAL", "nDstYOff=%d, nDstYOff2=%d", nDstYOff, nDstYOff2);
-
-            if( eType == GDT_Byte || eType == GDT_UInt16 || eType == GDT_Float32 )
-                eErr = pfnResampleFn(dfXRatioDstToSrc, dfYRatioDstToSrc,
-                                       0.0, 0.0,
-                                              eType,
-                                              pChunk,
-                                              pabyChunkNodataMask,
-                                              0, nWidth,
-                                              nChunkYOffQueried, nChunkYSizeQueried,
-                                              0, nDstWidth,
-                                              nDstYOff, nDstYOff2,
-                                              papoOvrBands[iOverview], pszResampling,
-                                              bHasNoData, fNoDataValue, poColorTable,
-                                              poSrcBand->GetRasterDataType());
-            else
-                eErr = GDALResampleChunkC32R(nWidth, nHeight,
-                                               (float*)pChunk,
-                                               nChunkYOffQueried, nChunkYSizeQueried,
-                                               nDstYOff, nDstYOff2,
-                                               papoOvrBands[iOverview], pszResampling);
-        }
+    while( nJobsInFlight > 0 )
+    {
+        eErr = GDALFlushOverviewChunkJob(
+            poThreadPool,
+            &asJobs[(nJobsSubmitted - nJobsInFlight) % nJobCount],
+            nJobsInFlight, eErr );
+        nJobsInFlight --;
     }
+    delete poThreadPool;
 
-    VSIFree( pChunk );
-    VSIFree( pabyChunkNodataMask );
+    for( int iJob = 0; iJob < nJobCount; iJob++ )
+    {
+        GDALOverviewChunkJob* psJob = &asJobs[iJob];
+        VSIFree( psJob->pChunk );
+        VSIFree( psJob->pabyChunkNodataMask );
+        if( psJob->papoDstBands != NULL && psJob->papoDstBands != papoOvrBands )
+        {
+            for( int iOverview = 0; iOverview < nOverviewCount; iOverview++ )
+                delete psJob->papoDstBands[iOverview];
+            CPLFree( psJob->papoDstBands );
+        }
+    }
 
 /* -------------------------------------------------------------------- */
 /*      Renormalized overview mean / stddev if needed.                  */
@@ -2673,6 +4065,18 @@ GDALRegenerateOverviews( GDALRasterBandH hSrcBand,
  * that only a given RGB triplet (in case of a RGB image) will be considered as the
  * nodata value and not each value of the triplet independently per band.
  *
+ * Starting with GDAL 2.2, the GDAL_NUM_THREADS configuration option can be
+ * set to a number of worker threads (or ALL_CPUS) so that the blocks of each
+ * overview level are computed in parallel. Output is written from the calling
+ * thread only.
+ *
+ * Starting with GDAL 2.2, when the overview levels are ordered from the
+ * largest to the smallest one, they are all computed in a single pass over
+ * the source bands, each level being fed with the lines of the previous
+ * level while they are still in memory, instead of reading them back.
+ * This can be disabled by setting the GDAL_OVR_SINGLE_PASS configuration
+ * option to NO.
+ *
  * @param nBands the number of bands, size of papoSrcBands and size of
  *               first dimension of papapoOverviewBands
  * @param papoSrcBands the list of source bands to downsample
@@ -2760,6 +4164,20 @@ GDALRegenerateOverviewsMultiBand(int nBands, GDALRasterBand** papoSrcBands,
         }
     }
 
+    /* Compute all the levels in a single pass over the source bands */
+    /* when possible, rather than reading back each level to compute */
+    /* the next one. */
+    if( GDALOverviewPyramidBuilder::CanHandle( nBands, papoSrcBands,
+                                               nOverviews,
+                                               papapoOverviewBands,
+                                               pszResampling ) )
+    {
+        GDALOverviewPyramidBuilder oBuilder( nBands, papoSrcBands,
+                                             nOverviews, papapoOverviewBands,
+                                             pszResampling, false );
+        return oBuilder.Run( pfnProgress, pProgressData );
+    }
+
     /* First pass to compute the total number of pixels to read */
     double dfTotalPixelCount = 0;
     for(int iOverview=0;iOverview<nOverviews;iOverview++)
@@ -2804,6 +4222,12 @@ GDALRegenerateOverviewsMultiBand(int nBands, GDALRasterBand** papoSrcBands,
         pafNoDataValue[iBand] = (float) papoSrcBands[iBand]->GetNoDataValue(&pabHasNoData[iBand]);
     }
 
+    /* With GDAL_NUM_THREADS, blocks are resampled in worker threads */
+    /* while the calling thread reads the next blocks and writes the */
+    /* completed ones, in order. */
+    CPLWorkerThreadPool* poThreadPool = GDALCreateOverviewThreadPool();
+    const int nJobCount = poThreadPool ? poThreadPool->GetThreadCount() + 1 : 1;
+
     /* Second pass to do the real job ! */
     double dfCurPixelCount = 0;
     CPLErr eErr = CE_None;
@@ -2840,46 +4264,65 @@ GDALRegenerateOverviewsMultiBand(int nBands, GDALRasterBand** papoSrcBands,
         int nFullResXChunkQueried = nFullResXChunk + 2 * nKernelRadius * nOvrFactor;
         int nFullResYChunkQueried = nFullResYChunk + 2 * nKernelRadius * nOvrFactor;
 
-        void** papaChunk = (void**) VSI_MALLOC_VERBOSE(nBands * sizeof(void*));
-        if( papaChunk == NULL )
-        {
-            CPLFree(pabHasNoData);
-            CPLFree(pafNoDataValue);
-            return CE_Failure;
-        }
-        GByte* pabyChunkNoDataMask = NULL;
-        for(int iBand=0;iBand<nBands;iBand++)
+        std::vector<GDALOverviewBlockJob> asJobs(nJobCount);
+        memset(&asJobs[0], 0, nJobCount * sizeof(GDALOverviewBlockJob));
+        bool bAllocOK = true;
+        for( int iJob = 0; iJob < nJobCount && bAllocOK; iJob++ )
         {
-            papaChunk[iBand] = VSI_MALLOC3_VERBOSE(
-                nFullResXChunkQueried,
-                nFullResYChunkQueried,
-                GDALGetDataTypeSizeBytes(eWrkDataType) );
-            if( papaChunk[iBand] == NULL )
+            GDALOverviewBlockJob* psJob = &asJobs[iJob];
+            psJob->pfnResampleFn = pfnResampleFn;
+            psJob->pszResampling = pszResampling;
+            psJob->dfXRatioDstToSrc = dfXRatioDstToSrc;
+            psJob->dfYRatioDstToSrc = dfYRatioDstToSrc;
+            psJob->eWrkDataType = eWrkDataType;
+            psJob->eSrcDataType = eDataType;
+            psJob->pabHasNoData = pabHasNoData;
+            psJob->pafNoDataValue = pafNoDataValue;
+
+            psJob->papaChunk = (void**) VSI_CALLOC_VERBOSE(nBands, sizeof(void*));
+            psJob->papoDstBands = (GDALRasterBand**)
+                VSI_CALLOC_VERBOSE(nBands, sizeof(GDALRasterBand*));
+            if( psJob->papaChunk == NULL || psJob->papoDstBands == NULL )
             {
-                while ( --iBand >= 0)
-                    CPLFree(papaChunk[iBand]);
-                CPLFree(papaChunk);
-                CPLFree(pabHasNoData);
-                CPLFree(pafNoDataValue);
-                return CE_Failure;
+                bAllocOK = false;
+                break;
             }
-        }
-        if (bUseNoDataMask)
-        {
-            pabyChunkNoDataMask = (GByte*) VSI_MALLOC2_VERBOSE(nFullResXChunkQueried, nFullResYChunkQueried);
-            if( pabyChunkNoDataMask == NULL )
+            psJob->nBands = nBands;
+            for(int iBand=0;iBand<nBands && bAllocOK;iBand++)
             {
-                for(int iBand=0;iBand<nBands;iBand++)
-                {
-                    CPLFree(papaChunk[iBand]);
-                }
-                CPLFree(papaChunk);
-                CPLFree(pabHasNoData);
-                CPLFree(pafNoDataValue);
-                return CE_Failure;
+                psJob->papaChunk[iBand] = VSI_MALLOC3_VERBOSE(
+                    nFullResXChunkQueried,
+                    nFullResYChunkQueried,
+                    GDALGetDataTypeSizeBytes(eWrkDataType) );
+                if( psJob->papaChunk[iBand] == NULL )
+                    bAllocOK = false;
+                else if( poThreadPool != NULL )
+                    psJob->papoDstBands[iBand] = new GDALOverviewResampleBuffer(
+                                    papapoOverviewBands[iBand][iOverview]);
+                else
+                    psJob->papoDstBands[iBand] =
+                                    papapoOverviewBands[iBand][iOverview];
             }
+            if (bUseNoDataMask && bAllocOK)
+            {
+                psJob->pabyChunkNoDataMask = (GByte*) VSI_MALLOC2_VERBOSE(
+                    nFullResXChunkQueried, nFullResYChunkQueried);
+                if( psJob->pabyChunkNoDataMask == NULL )
+                    bAllocOK = false;
+            }
+        }
+        if( !bAllocOK )
+        {
+            GDALFreeOverviewBlockJobs(asJobs, poThreadPool != NULL);
+            delete poThreadPool;
+            CPLFree(pabHasNoData);
+            CPLFree(pafNoDataValue);
+            return CE_Failure;
         }
 
+        int nJobsSubmitted = 0;
+        int nJobsInFlight = 0;
+
         int nDstYOff;
         /* Iterate on destination overview, block by block */
         for( nDstYOff = 0; nDstYOff < nDstHeight && eErr == CE_None; nDstYOff += nDstBlockYSize )
@@ -2946,6 +4389,18 @@ GDALRegenerateOverviewsMultiBand(int nBands, GDALRasterBand** papoSrcBands,
                          nChunkXOff, nChunkYOff, nXCount, nYCount,
                          nDstXOff, nDstYOff, nDstXCount, nDstYCount);*/
 
+                /* If all the jobs are busy, write the oldest one to free it */
+                if( poThreadPool != NULL && nJobsInFlight == nJobCount )
+                {
+                    eErr = GDALFlushOverviewBlockJob(
+                        poThreadPool,
+                        &asJobs[(nJobsSubmitted - nJobsInFlight) % nJobCount],
+                        nJobsInFlight, eErr );
+                    nJobsInFlight --;
+                }
+
+                GDALOverviewBlockJob* psJob = &asJobs[nJobsSubmitted % nJobCount];
+
                 /* Read the source buffers for all the bands */
                 for(int iBand=0;iBand<nBands && eErr == CE_None;iBand++)
                 {
@@ -2957,7 +4412,7 @@ GDALRegenerateOverviewsMultiBand(int nBands, GDALRasterBand** papoSrcBands,
                     eErr = poSrcBand->RasterIO( GF_Read,
                                                 nChunkXOffQueried, nChunkYOffQueried,
                                                 nChunkXSizeQueried, nChunkYSizeQueried,
-                                                papaChunk[iBand],
+                                                psJob->papaChunk[iBand],
                                                 nChunkXSizeQueried, nChunkYSizeQueried,
                                                 eWrkDataType, 0, 0, NULL );
                 }
@@ -2972,46 +4427,75 @@ GDALRegenerateOverviewsMultiBand(int nBands, GDALRasterBand** papoSrcBands,
                     eErr = poSrcBand->GetMaskBand()->RasterIO( GF_Read,
                                                                nChunkXOffQueried, nChunkYOffQueried,
                                                                nChunkXSizeQueried, nChunkYSizeQueried,
-                                                               pabyChunkNoDataMask,
+                                                               psJob->pabyChunkNoDataMask,
                                                                nChunkXSizeQueried, nChunkYSizeQueried,
                                                                GDT_Byte, 0, 0, NULL );
                 }
+                if( eErr != CE_None )
+                    break;
+
+                psJob->nChunkXOffQueried = nChunkXOffQueried;
+                psJob->nChunkXSizeQueried = nChunkXSizeQueried;
+                psJob->nChunkYOffQueried = nChunkYOffQueried;
+                psJob->nChunkYSizeQueried = nChunkYSizeQueried;
+                psJob->nDstXOff = nDstXOff;
+                psJob->nDstXCount = nDstXCount;
+                psJob->nDstYOff = nDstYOff;
+                psJob->nDstYCount = nDstYCount;
 
                 /* Compute the resulting overview block */
+                if( poThreadPool == NULL )
+                {
+                    eErr = GDALResampleOverviewBlock(psJob);
+                    continue;
+                }
+
                 for(int iBand=0;iBand<nBands && eErr == CE_None;iBand++)
                 {
-                    eErr = pfnResampleFn(   dfXRatioDstToSrc, dfYRatioDstToSrc,
-                                            0.0, 0.0,
-                                            eWrkDataType,
-                                            papaChunk[iBand],
-                                            pabyChunkNoDataMask,
-                                            nChunkXOffQueried, nChunkXSizeQueried,
-                                            nChunkYOffQueried, nChunkYSizeQueried,
-                                            nDstXOff, nDstXOff + nDstXCount,
-                                            nDstYOff, nDstYOff + nDstYCount,
-                                            papapoOverviewBands[iBand][iOverview],
-                                            pszResampling,
-                                            pabHasNoData[iBand],
-                                            pafNoDataValue[iBand],
-                                            /*poColorTable*/ NULL,
-                                            eDataType);
+                    if( !static_cast<GDALOverviewResampleBuffer*>(
+                            psJob->papoDstBands[iBand])->SetWindow(
+                                nDstXOff, nDstYOff, nDstXCount, nDstYCount) )
+                    {
+                        eErr = CE_Failure;
+                    }
+                }
+                if( eErr != CE_None )
+                    break;
+
+                psJob->bFinished = FALSE;
+                psJob->eErr = CE_None;
+                if( !poThreadPool->SubmitJob(GDALOverviewBlockJobFunc, psJob) )
+                {
+                    eErr = CE_Failure;
+                    break;
                 }
+                nJobsSubmitted ++;
+                nJobsInFlight ++;
             }
 
             dfCurPixelCount += (double)nYCount * nSrcWidth;
         }
 
+        /* Write the pending jobs, in order. This must be completed */
+        /* before the next level reads this one */
+        while( nJobsInFlight > 0 )
+        {
+            eErr = GDALFlushOverviewBlockJob(
+                poThreadPool,
+                &asJobs[(nJobsSubmitted - nJobsInFlight) % nJobCount],
+                nJobsInFlight, eErr );
+            nJobsInFlight --;
+        }
+
         /* Flush the data to overviews */
         for(int iBand=0;iBand<nBands;iBand++)
         {
-            CPLFree(papaChunk[iBand]);
             papapoOverviewBands[iBand][iOverview]->FlushCache();
         }
-        CPLFree(papaChunk);
-        CPLFree(pabyChunkNoDataMask);
-
+        GDALFreeOverviewBlockJobs(asJobs, poThreadPool != NULL);
     }
 
+    delete poThreadPool;
     CPLFree(pabHasNoData);
     CPLFree(pafNoDataValue);
 
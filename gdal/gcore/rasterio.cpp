@@ -77,6 +77,19 @@ CPLErr GDALRasterBand::IRasterIO( GDALRWFlag eRWFlag,
         return CE_Failure;
     }
 
+/* ==================================================================== */
+/*      Decode blocks directly into the buffer if the caller asked us   */
+/*      to bypass the block cache and the driver supports it.          */
+/* ==================================================================== */
+    if( eRWFlag == GF_Read && psExtraArg->bDirectRead &&
+        nBufXSize == nXSize && nBufYSize == nYSize &&
+        CanDirectReadBlocks() )
+    {
+        return DirectReadBlocks( nXOff, nYOff, nXSize, nYSize,
+                                 pData, eBufType, nPixelSpace, nLineSpace,
+                                 psExtraArg );
+    }
+
 /* ==================================================================== */
 /*      A common case is the data requested with the destination        */
 /*      is packed, and the block width is the raster width.             */
@@ -667,6 +680,148 @@ CPLErr GDALRasterBand::IRasterIO( GDALRWFlag eRWFlag,
     return( eErr );
 }
 
+/************************************************************************/
+/*                        CanDirectReadBlocks()                         */
+/************************************************************************/
+
+/**
+ * \brief Whether IReadBlock() may be called outside of the block cache.
+ *
+ * Drivers return TRUE when their IReadBlock() implementation can decode a
+ * block into any caller supplied buffer, without relying on the block being
+ * owned by the block cache (e.g. by loading other bands into the cache).
+ * This enables DirectReadBlocks() when the bDirectRead member of
+ * GDALRasterIOExtraArg is set.
+ *
+ * The default implementation returns FALSE.
+ *
+ * @return TRUE if direct block reading is supported.
+ * @since GDAL 2.2
+ */
+
+int GDALRasterBand::CanDirectReadBlocks()
+{
+    return FALSE;
+}
+
+/************************************************************************/
+/*                          DirectReadBlocks()                          */
+/************************************************************************/
+
+/**
+ * \brief Read a window without going through the block cache.
+ *
+ * Blocks already in the cache are copied from it, so that dirty blocks are
+ * honoured. Other blocks are decoded with IReadBlock() straight into the
+ * caller buffer when it has the same layout as the block (same data type,
+ * packed, and exactly one block wide), or otherwise into a single scratch
+ * block buffer from which the requested part is copied. Decoded blocks are
+ * not added to the cache.
+ *
+ * Only non-resampled reads are handled.
+ *
+ * @since GDAL 2.2
+ */
+
+CPLErr GDALRasterBand::DirectReadBlocks( int nXOff, int nYOff,
+                                         int nXSize, int nYSize,
+                                         void * pData, GDALDataType eBufType,
+                                         GSpacing nPixelSpace,
+                                         GSpacing nLineSpace,
+                                         GDALRasterIOExtraArg* psExtraArg )
+{
+    // Drivers may rely on nBlocksPerRow and friends in IReadBlock()
+    if( !InitBlockInfo() )
+        return CE_Failure;
+
+    const int nBandDataSize = GDALGetDataTypeSizeBytes( eDataType );
+    const int nBlockX1 = nXOff / nBlockXSize;
+    const int nBlockY1 = nYOff / nBlockYSize;
+    const int nBlockX2 = (nXOff + nXSize - 1) / nBlockXSize;
+    const int nBlockY2 = (nYOff + nYSize - 1) / nBlockYSize;
+    const bool bSameLayout = eBufType == eDataType &&
+                             nPixelSpace == nBandDataSize &&
+                             nLineSpace == nPixelSpace * nBlockXSize;
+    GByte* pabyScratch = NULL;
+    CPLErr eErr = CE_None;
+
+    for( int iYBlock = nBlockY1; eErr == CE_None && iYBlock <= nBlockY2; iYBlock++ )
+    {
+        const int nChunkYOff = MAX(nYOff, iYBlock * nBlockYSize);
+        const int nChunkYEnd = MIN(nYOff + nYSize, (iYBlock + 1) * nBlockYSize);
+
+        for( int iXBlock = nBlockX1; iXBlock <= nBlockX2; iXBlock++ )
+        {
+            const int nChunkXOff = MAX(nXOff, iXBlock * nBlockXSize);
+            const int nChunkXEnd = MIN(nXOff + nXSize, (iXBlock + 1) * nBlockXSize);
+            GByte* pabyDst = static_cast<GByte*>(pData) +
+                             (nChunkYOff - nYOff) * nLineSpace +
+                             (nChunkXOff - nXOff) * nPixelSpace;
+
+            GDALRasterBlock* poBlock = TryGetLockedBlockRef( iXBlock, iYBlock );
+            const GByte* pabySrc = NULL;
+            if( poBlock != NULL )
+            {
+                pabySrc = static_cast<const GByte*>(poBlock->GetDataRef());
+            }
+            else if( bSameLayout &&
+                     nChunkXOff == iXBlock * nBlockXSize &&
+                     nChunkXEnd == (iXBlock + 1) * nBlockXSize &&
+                     nChunkYOff == iYBlock * nBlockYSize &&
+                     nChunkYEnd == (iYBlock + 1) * nBlockYSize )
+            {
+                eErr = IReadBlock( iXBlock, iYBlock, pabyDst );
+                if( eErr != CE_None )
+                    break;
+                continue;
+            }
+            else
+            {
+                if( pabyScratch == NULL )
+                {
+                    pabyScratch = static_cast<GByte*>(
+                        VSI_MALLOC3_VERBOSE(nBandDataSize, nBlockXSize, nBlockYSize));
+                    if( pabyScratch == NULL )
+                    {
+                        eErr = CE_Failure;
+                        break;
+                    }
+                }
+                eErr = IReadBlock( iXBlock, iYBlock, pabyScratch );
+                if( eErr != CE_None )
+                    break;
+                pabySrc = pabyScratch;
+            }
+
+            for( int iY = nChunkYOff; iY < nChunkYEnd; iY++ )
+            {
+                const size_t nSrcOffset =
+                    (static_cast<size_t>(iY - iYBlock * nBlockYSize) * nBlockXSize +
+                     (nChunkXOff - iXBlock * nBlockXSize)) * nBandDataSize;
+                GDALCopyWords( pabySrc + nSrcOffset, eDataType, nBandDataSize,
+                               pabyDst + (iY - nChunkYOff) * nLineSpace,
+                               eBufType, static_cast<int>(nPixelSpace),
+                               nChunkXEnd - nChunkXOff );
+            }
+
+            if( poBlock != NULL )
+                poBlock->DropLock();
+        }
+
+        if( eErr == CE_None && psExtraArg->pfnProgress != NULL &&
+            !psExtraArg->pfnProgress(1.0 * (nChunkYEnd - nYOff) / nYSize, "",
+                                     psExtraArg->pProgressData) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            eErr = CE_Failure;
+        }
+    }
+
+    CPLFree( pabyScratch );
+
+    return eErr;
+}
+
 /************************************************************************/
 /*                         GDALRasterIOTransformer()                    */
 /************************************************************************/
@@ -1796,6 +1951,432 @@ static void GDALCopyWordsT(const float* const CPL_RESTRICT pSrcData, int nSrcPix
                             pDstData, nDstPixelStride, nWordCount);
 }
 
+// Needs SSE2, which is always available on x86_64
+#if defined(__x86_64) || defined(_M_X64)
+
+/************************************************************************/
+/*                      GDALCopyPackedWordsSSE2()                       */
+/************************************************************************/
+/**
+ * SSE2 kernels for packed buffers. Each overload converts as many words
+ * as fit in whole vectors and returns the number of words processed, so
+ * that the caller can finish the remaining ones with the scalar path.
+ * The results must be identical to the ones of GDALCopyWord().
+ */
+
+static int GDALCopyPackedWordsSSE2(const GByte* CPL_RESTRICT pabySrc,
+                                   GUInt16* CPL_RESTRICT panDst,
+                                   int nWordCount)
+{
+    const __m128i xmm_zero = _mm_setzero_si128();
+    int n = 0;
+    for( ; n < nWordCount - 15; n += 16 )
+    {
+        __m128i xmm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pabySrc + n));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(panDst + n),
+                         _mm_unpacklo_epi8(xmm, xmm_zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(panDst + n + 8),
+                         _mm_unpackhi_epi8(xmm, xmm_zero));
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const GByte* CPL_RESTRICT pabySrc,
+                                   GInt16* CPL_RESTRICT panDst,
+                                   int nWordCount)
+{
+    return GDALCopyPackedWordsSSE2(pabySrc,
+                                   reinterpret_cast<GUInt16*>(panDst),
+                                   nWordCount);
+}
+
+static int GDALCopyPackedWordsSSE2(const GByte* CPL_RESTRICT pabySrc,
+                                   float* CPL_RESTRICT pafDst,
+                                   int nWordCount)
+{
+    const __m128i xmm_zero = _mm_setzero_si128();
+    int n = 0;
+    for( ; n < nWordCount - 15; n += 16 )
+    {
+        __m128i xmm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pabySrc + n));
+        __m128i xmm_lo = _mm_unpacklo_epi8(xmm, xmm_zero);
+        __m128i xmm_hi = _mm_unpackhi_epi8(xmm, xmm_zero);
+        _mm_storeu_ps(pafDst + n, _mm_cvtepi32_ps(_mm_unpacklo_epi16(xmm_lo, xmm_zero)));
+        _mm_storeu_ps(pafDst + n + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(xmm_lo, xmm_zero)));
+        _mm_storeu_ps(pafDst + n + 8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(xmm_hi, xmm_zero)));
+        _mm_storeu_ps(pafDst + n + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(xmm_hi, xmm_zero)));
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const GInt16* CPL_RESTRICT panSrc,
+                                   GByte* CPL_RESTRICT pabyDst,
+                                   int nWordCount)
+{
+    int n = 0;
+    for( ; n < nWordCount - 15; n += 16 )
+    {
+        __m128i xmm0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(panSrc + n));
+        __m128i xmm1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(panSrc + n + 8));
+        // Saturating pack does the [0,255] clamping
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pabyDst + n),
+                         _mm_packus_epi16(xmm0, xmm1));
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const GInt16* CPL_RESTRICT panSrc,
+                                   GUInt16* CPL_RESTRICT panDst,
+                                   int nWordCount)
+{
+    const __m128i xmm_zero = _mm_setzero_si128();
+    int n = 0;
+    for( ; n < nWordCount - 7; n += 8 )
+    {
+        __m128i xmm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(panSrc + n));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(panDst + n),
+                         _mm_max_epi16(xmm, xmm_zero));
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const GInt16* CPL_RESTRICT panSrc,
+                                   GInt32* CPL_RESTRICT panDst,
+                                   int nWordCount)
+{
+    int n = 0;
+    for( ; n < nWordCount - 7; n += 8 )
+    {
+        __m128i xmm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(panSrc + n));
+        // Sign extension: put each word in the high half and shift back
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(panDst + n),
+                         _mm_srai_epi32(_mm_unpacklo_epi16(xmm, xmm), 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(panDst + n + 4),
+                         _mm_srai_epi32(_mm_unpackhi_epi16(xmm, xmm), 16));
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const GInt16* CPL_RESTRICT panSrc,
+                                   float* CPL_RESTRICT pafDst,
+                                   int nWordCount)
+{
+    int n = 0;
+    for( ; n < nWordCount - 7; n += 8 )
+    {
+        __m128i xmm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(panSrc + n));
+        _mm_storeu_ps(pafDst + n,
+            _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(xmm, xmm), 16)));
+        _mm_storeu_ps(pafDst + n + 4,
+            _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(xmm, xmm), 16)));
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const GUInt16* CPL_RESTRICT panSrc,
+                                   GByte* CPL_RESTRICT pabyDst,
+                                   int nWordCount)
+{
+    const __m128i xmm_max = _mm_set1_epi16(255);
+    int n = 0;
+    for( ; n < nWordCount - 15; n += 16 )
+    {
+        __m128i xmm0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(panSrc + n));
+        __m128i xmm1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(panSrc + n + 8));
+        // No unsigned 16 bit min in SSE2: min(x,255) = x - max(x-255,0)
+        xmm0 = _mm_sub_epi16(xmm0, _mm_subs_epu16(xmm0, xmm_max));
+        xmm1 = _mm_sub_epi16(xmm1, _mm_subs_epu16(xmm1, xmm_max));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pabyDst + n),
+                         _mm_packus_epi16(xmm0, xmm1));
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const GUInt16* CPL_RESTRICT panSrc,
+                                   GInt16* CPL_RESTRICT panDst,
+                                   int nWordCount)
+{
+    const __m128i xmm_max = _mm_set1_epi16(32767);
+    int n = 0;
+    for( ; n < nWordCount - 7; n += 8 )
+    {
+        __m128i xmm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(panSrc + n));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(panDst + n),
+                         _mm_sub_epi16(xmm, _mm_subs_epu16(xmm, xmm_max)));
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const GUInt16* CPL_RESTRICT panSrc,
+                                   GUInt32* CPL_RESTRICT panDst,
+                                   int nWordCount)
+{
+    const __m128i xmm_zero = _mm_setzero_si128();
+    int n = 0;
+    for( ; n < nWordCount - 7; n += 8 )
+    {
+        __m128i xmm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(panSrc + n));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(panDst + n),
+                         _mm_unpacklo_epi16(xmm, xmm_zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(panDst + n + 4),
+                         _mm_unpackhi_epi16(xmm, xmm_zero));
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const GUInt16* CPL_RESTRICT panSrc,
+                                   GInt32* CPL_RESTRICT panDst,
+                                   int nWordCount)
+{
+    return GDALCopyPackedWordsSSE2(panSrc,
+                                   reinterpret_cast<GUInt32*>(panDst),
+                                   nWordCount);
+}
+
+static int GDALCopyPackedWordsSSE2(const GUInt16* CPL_RESTRICT panSrc,
+                                   float* CPL_RESTRICT pafDst,
+                                   int nWordCount)
+{
+    const __m128i xmm_zero = _mm_setzero_si128();
+    int n = 0;
+    for( ; n < nWordCount - 7; n += 8 )
+    {
+        __m128i xmm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(panSrc + n));
+        _mm_storeu_ps(pafDst + n,
+                      _mm_cvtepi32_ps(_mm_unpacklo_epi16(xmm, xmm_zero)));
+        _mm_storeu_ps(pafDst + n + 4,
+                      _mm_cvtepi32_ps(_mm_unpackhi_epi16(xmm, xmm_zero)));
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const GInt32* CPL_RESTRICT panSrc,
+                                   float* CPL_RESTRICT pafDst,
+                                   int nWordCount)
+{
+    int n = 0;
+    for( ; n < nWordCount - 3; n += 4 )
+    {
+        __m128i xmm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(panSrc + n));
+        _mm_storeu_ps(pafDst + n, _mm_cvtepi32_ps(xmm));
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const GInt32* CPL_RESTRICT panSrc,
+                                   double* CPL_RESTRICT padfDst,
+                                   int nWordCount)
+{
+    int n = 0;
+    for( ; n < nWordCount - 3; n += 4 )
+    {
+        __m128i xmm = _mm_loadu_si128(reinterpret_cast<const __m128i*>(panSrc + n));
+        _mm_storeu_pd(padfDst + n, _mm_cvtepi32_pd(xmm));
+        _mm_storeu_pd(padfDst + n + 2, _mm_cvtepi32_pd(_mm_srli_si128(xmm, 8)));
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const float* CPL_RESTRICT pafSrc,
+                                   double* CPL_RESTRICT padfDst,
+                                   int nWordCount)
+{
+    int n = 0;
+    for( ; n < nWordCount - 3; n += 4 )
+    {
+        __m128 xmm = _mm_loadu_ps(pafSrc + n);
+        _mm_storeu_pd(padfDst + n, _mm_cvtps_pd(xmm));
+        _mm_storeu_pd(padfDst + n + 2, _mm_cvtps_pd(_mm_movehl_ps(xmm, xmm)));
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const double* CPL_RESTRICT padfSrc,
+                                   float* CPL_RESTRICT pafDst,
+                                   int nWordCount)
+{
+    int n = 0;
+    for( ; n < nWordCount - 3; n += 4 )
+    {
+        __m128 xmm_lo = _mm_cvtpd_ps(_mm_loadu_pd(padfSrc + n));
+        __m128 xmm_hi = _mm_cvtpd_ps(_mm_loadu_pd(padfSrc + n + 2));
+        _mm_storeu_ps(pafDst + n, _mm_movelh_ps(xmm_lo, xmm_hi));
+    }
+    return n;
+}
+
+/* Rounds and clamps 4 doubles the same way as GDALCopyWord(double, Tout) */
+/* and returns them as 4 packed int32. NaN is converted to 0 when */
+/* bNaNToZero is set, which is what the scalar path ends up with for */
+/* types smaller than 32 bits. */
+template<bool bSymmetricRounding, bool bNaNToZero>
+static inline __m128i GDALRound4DoublesSSE2(const double* CPL_RESTRICT padfSrc,
+                                            const __m128d xmm_min,
+                                            const __m128d xmm_max)
+{
+    const __m128d p0d5 = _mm_set1_pd(0.5);
+    __m128d xmm_lo = _mm_loadu_pd(padfSrc);
+    __m128d xmm_hi = _mm_loadu_pd(padfSrc + 2);
+    if( bNaNToZero )
+    {
+        xmm_lo = _mm_and_pd(xmm_lo, _mm_cmpord_pd(xmm_lo, xmm_lo));
+        xmm_hi = _mm_and_pd(xmm_hi, _mm_cmpord_pd(xmm_hi, xmm_hi));
+    }
+    if( bSymmetricRounding )
+    {
+        /* f >= 0.0 ? f + 0.5 : f - 0.5 */
+        const __m128d m0d5 = _mm_set1_pd(-0.5);
+        const __m128d xmm_zero = _mm_setzero_pd();
+        __m128d mask = _mm_cmpge_pd(xmm_lo, xmm_zero);
+        xmm_lo = _mm_add_pd(xmm_lo, _mm_or_pd(_mm_and_pd(mask, p0d5),
+                                              _mm_andnot_pd(mask, m0d5)));
+        mask = _mm_cmpge_pd(xmm_hi, xmm_zero);
+        xmm_hi = _mm_add_pd(xmm_hi, _mm_or_pd(_mm_and_pd(mask, p0d5),
+                                              _mm_andnot_pd(mask, m0d5)));
+    }
+    else
+    {
+        xmm_lo = _mm_add_pd(xmm_lo, p0d5);
+        xmm_hi = _mm_add_pd(xmm_hi, p0d5);
+    }
+    // The operand order lets NaN go through, as GDALClampValue() does
+    xmm_lo = _mm_max_pd(xmm_min, _mm_min_pd(xmm_max, xmm_lo));
+    xmm_hi = _mm_max_pd(xmm_min, _mm_min_pd(xmm_max, xmm_hi));
+    return _mm_unpacklo_epi64(_mm_cvttpd_epi32(xmm_lo),
+                              _mm_cvttpd_epi32(xmm_hi));
+}
+
+static int GDALCopyPackedWordsSSE2(const double* CPL_RESTRICT padfSrc,
+                                   GByte* CPL_RESTRICT pabyDst,
+                                   int nWordCount)
+{
+    const __m128d xmm_min = _mm_set1_pd(0.0);
+    const __m128d xmm_max = _mm_set1_pd(255.0);
+    int n = 0;
+    for( ; n < nWordCount - 7; n += 8 )
+    {
+        __m128i xmm0 = GDALRound4DoublesSSE2<false, false>(padfSrc + n, xmm_min, xmm_max);
+        __m128i xmm1 = GDALRound4DoublesSSE2<false, false>(padfSrc + n + 4, xmm_min, xmm_max);
+        // NaN gives INT_MIN, which the saturating packs turn into 0
+        __m128i xmm = _mm_packus_epi16(_mm_packs_epi32(xmm0, xmm1), xmm0);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(pabyDst + n), xmm);
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const double* CPL_RESTRICT padfSrc,
+                                   GInt16* CPL_RESTRICT panDst,
+                                   int nWordCount)
+{
+    const __m128d xmm_min = _mm_set1_pd(-32768.0);
+    const __m128d xmm_max = _mm_set1_pd(32767.0);
+    int n = 0;
+    for( ; n < nWordCount - 7; n += 8 )
+    {
+        __m128i xmm0 = GDALRound4DoublesSSE2<true, true>(padfSrc + n, xmm_min, xmm_max);
+        __m128i xmm1 = GDALRound4DoublesSSE2<true, true>(padfSrc + n + 4, xmm_min, xmm_max);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(panDst + n),
+                         _mm_packs_epi32(xmm0, xmm1));
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const double* CPL_RESTRICT padfSrc,
+                                   GUInt16* CPL_RESTRICT panDst,
+                                   int nWordCount)
+{
+    const __m128d xmm_min = _mm_set1_pd(0.0);
+    const __m128d xmm_max = _mm_set1_pd(65535.0);
+    const __m128i xmm_32768_epi32 = _mm_set1_epi32(32768);
+    const __m128i xmm_32768_epi16 = _mm_set1_epi16(-32768);
+    int n = 0;
+    for( ; n < nWordCount - 7; n += 8 )
+    {
+        __m128i xmm0 = GDALRound4DoublesSSE2<false, true>(padfSrc + n, xmm_min, xmm_max);
+        __m128i xmm1 = GDALRound4DoublesSSE2<false, true>(padfSrc + n + 4, xmm_min, xmm_max);
+        // No unsigned 32->16 bit pack in SSE2, so shift to the signed range
+        xmm0 = _mm_sub_epi32(xmm0, xmm_32768_epi32);
+        xmm1 = _mm_sub_epi32(xmm1, xmm_32768_epi32);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(panDst + n),
+                         _mm_add_epi16(_mm_packs_epi32(xmm0, xmm1), xmm_32768_epi16));
+    }
+    return n;
+}
+
+static int GDALCopyPackedWordsSSE2(const double* CPL_RESTRICT padfSrc,
+                                   GInt32* CPL_RESTRICT panDst,
+                                   int nWordCount)
+{
+    const __m128d xmm_min = _mm_set1_pd(-2147483648.0);
+    const __m128d xmm_max = _mm_set1_pd(2147483647.0);
+    int n = 0;
+    for( ; n < nWordCount - 3; n += 4 )
+    {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(panDst + n),
+            GDALRound4DoublesSSE2<true, false>(padfSrc + n, xmm_min, xmm_max));
+    }
+    return n;
+}
+
+/************************************************************************/
+/*                       GDALCopyWordsPackedT()                         */
+/************************************************************************/
+
+/* Use the SSE2 kernel for packed buffers, and the generic template for */
+/* the remaining words or for strided buffers. */
+template <class Tin, class Tout>
+static void GDALCopyWordsPackedT(const Tin* const CPL_RESTRICT pSrcData, int nSrcPixelStride,
+                                 Tout* const CPL_RESTRICT pDstData, int nDstPixelStride,
+                                 int nWordCount)
+{
+    int n = 0;
+    if( nSrcPixelStride == (int)sizeof(Tin) && nDstPixelStride == (int)sizeof(Tout) )
+        n = GDALCopyPackedWordsSSE2(pSrcData, pDstData, nWordCount);
+    if( n < nWordCount )
+    {
+        GDALCopyWordsT<Tin, Tout>(
+            reinterpret_cast<const Tin*>(reinterpret_cast<const GByte*>(pSrcData) +
+                                         static_cast<std::ptrdiff_t>(n) * nSrcPixelStride),
+            nSrcPixelStride,
+            reinterpret_cast<Tout*>(reinterpret_cast<GByte*>(pDstData) +
+                                    static_cast<std::ptrdiff_t>(n) * nDstPixelStride),
+            nDstPixelStride,
+            nWordCount - n);
+    }
+}
+
+#define DEFINE_GDALCOPYWORDST_SSE2(Tin, Tout) \
+static void GDALCopyWordsT(const Tin* const CPL_RESTRICT pSrcData, int nSrcPixelStride, \
+                           Tout* const CPL_RESTRICT pDstData, int nDstPixelStride, \
+                           int nWordCount) \
+{ \
+    GDALCopyWordsPackedT(pSrcData, nSrcPixelStride, \
+                         pDstData, nDstPixelStride, nWordCount); \
+}
+
+DEFINE_GDALCOPYWORDST_SSE2(GByte, GUInt16)
+DEFINE_GDALCOPYWORDST_SSE2(GByte, GInt16)
+DEFINE_GDALCOPYWORDST_SSE2(GByte, float)
+DEFINE_GDALCOPYWORDST_SSE2(GInt16, GByte)
+DEFINE_GDALCOPYWORDST_SSE2(GInt16, GUInt16)
+DEFINE_GDALCOPYWORDST_SSE2(GInt16, GInt32)
+DEFINE_GDALCOPYWORDST_SSE2(GInt16, float)
+DEFINE_GDALCOPYWORDST_SSE2(GUInt16, GByte)
+DEFINE_GDALCOPYWORDST_SSE2(GUInt16, GInt16)
+DEFINE_GDALCOPYWORDST_SSE2(GUInt16, GUInt32)
+DEFINE_GDALCOPYWORDST_SSE2(GUInt16, GInt32)
+DEFINE_GDALCOPYWORDST_SSE2(GUInt16, float)
+DEFINE_GDALCOPYWORDST_SSE2(GInt32, float)
+DEFINE_GDALCOPYWORDST_SSE2(GInt32, double)
+DEFINE_GDALCOPYWORDST_SSE2(float, double)
+DEFINE_GDALCOPYWORDST_SSE2(double, float)
+DEFINE_GDALCOPYWORDST_SSE2(double, GByte)
+DEFINE_GDALCOPYWORDST_SSE2(double, GInt16)
+DEFINE_GDALCOPYWORDST_SSE2(double, GUInt16)
+DEFINE_GDALCOPYWORDST_SSE2(double, GInt32)
+
+#endif //  defined(__x86_64) || defined(_M_X64)
+
 /************************************************************************/
 /*                   GDALCopyWordsComplexT()                            */
 /************************************************************************/
@@ -2094,97 +2675,149 @@ void GDALReplicateWord(const void * CPL_RESTRICT pSrcData, GDALDataType eSrcType
 }
 
 /************************************************************************/
-/*                        GDALUnrolledByteCopy()                        */
+/*                          GDALUnrolledCopy()                          */
 /************************************************************************/
 
-template<int srcStride, int dstStride>
-static inline void GDALUnrolledByteCopy(GByte* CPL_RESTRICT pabyDest,
-                                    const GByte* CPL_RESTRICT pabySrc,
+template<class T, int srcStride, int dstStride>
+static inline void GDALUnrolledCopy(T* CPL_RESTRICT pDest,
+                                    const T* CPL_RESTRICT pSrc,
                                     int nIters)
 {
     if (nIters >= 16)
     {
         for ( int i = nIters / 16; i != 0; i -- )
         {
-            pabyDest[0*dstStride] = pabySrc[0*srcStride];
-            pabyDest[1*dstStride] = pabySrc[1*srcStride];
-            pabyDest[2*dstStride] = pabySrc[2*srcStride];
-            pabyDest[3*dstStride] = pabySrc[3*srcStride];
-            pabyDest[4*dstStride] = pabySrc[4*srcStride];
-            pabyDest[5*dstStride] = pabySrc[5*srcStride];
-            pabyDest[6*dstStride] = pabySrc[6*srcStride];
-            pabyDest[7*dstStride] = pabySrc[7*srcStride];
-            pabyDest[8*dstStride] = pabySrc[8*srcStride];
-            pabyDest[9*dstStride] = pabySrc[9*srcStride];
-            pabyDest[10*dstStride] = pabySrc[10*srcStride];
-            pabyDest[11*dstStride] = pabySrc[11*srcStride];
-            pabyDest[12*dstStride] = pabySrc[12*srcStride];
-            pabyDest[13*dstStride] = pabySrc[13*srcStride];
-            pabyDest[14*dstStride] = pabySrc[14*srcStride];
-            pabyDest[15*dstStride] = pabySrc[15*srcStride];
-            pabyDest += 16*dstStride;
-            pabySrc += 16*srcStride;
+            pDest[0*dstStride] = pSrc[0*srcStride];
+            pDest[1*dstStride] = pSrc[1*srcStride];
+            pDest[2*dstStride] = pSrc[2*srcStride];
+            pDest[3*dstStride] = pSrc[3*srcStride];
+            pDest[4*dstStride] = pSrc[4*srcStride];
+            pDest[5*dstStride] = pSrc[5*srcStride];
+            pDest[6*dstStride] = pSrc[6*srcStride];
+            pDest[7*dstStride] = pSrc[7*srcStride];
+            pDest[8*dstStride] = pSrc[8*srcStride];
+            pDest[9*dstStride] = pSrc[9*srcStride];
+            pDest[10*dstStride] = pSrc[10*srcStride];
+            pDest[11*dstStride] = pSrc[11*srcStride];
+            pDest[12*dstStride] = pSrc[12*srcStride];
+            pDest[13*dstStride] = pSrc[13*srcStride];
+            pDest[14*dstStride] = pSrc[14*srcStride];
+            pDest[15*dstStride] = pSrc[15*srcStride];
+            pDest += 16*dstStride;
+            pSrc += 16*srcStride;
         }
         nIters = nIters % 16;
     }
     for( int i = 0; i < nIters; i++ )
     {
-        pabyDest[i*dstStride] = *pabySrc;
-        pabySrc += srcStride;
+        pDest[i*dstStride] = *pSrc;
+        pSrc += srcStride;
     }
 }
 
+#if defined(__x86_64) || defined(_M_X64)
+
 /************************************************************************/
-/*                         GDALFastByteCopy()                           */
+/*                   GDALUnrolledCopy<GByte, 4, 1>()                    */
 /************************************************************************/
 
-static inline void GDALFastByteCopy(GByte* CPL_RESTRICT pabyDest,
-                                    int nDestStride,
-                                    const GByte* CPL_RESTRICT pabySrc,
-                                    int nSrcStride,
-                                    int nIters)
+/* Extraction of one band from a pixel-interleaved 4-band buffer */
+template<>
+inline void GDALUnrolledCopy<GByte, 4, 1>(GByte* CPL_RESTRICT pDest,
+                                          const GByte* CPL_RESTRICT pSrc,
+                                          int nIters)
+{
+    const __m128i xmm_mask = _mm_set1_epi32(0xff);
+    int i = 0;
+    // The last 16 words are left to the scalar loop, as the 64 byte loads
+    // go 3 bytes past the last source word
+    for( ; i < nIters - 16; i += 16 )
+    {
+        __m128i xmm0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + 0));
+        __m128i xmm1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + 16));
+        __m128i xmm2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + 32));
+        __m128i xmm3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + 48));
+        xmm0 = _mm_and_si128(xmm0, xmm_mask);
+        xmm1 = _mm_and_si128(xmm1, xmm_mask);
+        xmm2 = _mm_and_si128(xmm2, xmm_mask);
+        xmm3 = _mm_and_si128(xmm3, xmm_mask);
+        // Values are in [0,255] so the saturating packs are exact
+        xmm0 = _mm_packs_epi32(xmm0, xmm1);
+        xmm2 = _mm_packs_epi32(xmm2, xmm3);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(pDest + i),
+                         _mm_packus_epi16(xmm0, xmm2));
+        pSrc += 64;
+    }
+    for( ; i < nIters; i++ )
+    {
+        pDest[i] = *pSrc;
+        pSrc += 4;
+    }
+}
+
+#endif //  defined(__x86_64) || defined(_M_X64)
+
+/************************************************************************/
+/*                            GDALFastCopy()                            */
+/************************************************************************/
+
+/* Copy words of the same type. Strides are expressed in words. */
+template<class T>
+static inline void GDALFastCopy(T* CPL_RESTRICT pDest,
+                                int nDestStride,
+                                const T* CPL_RESTRICT pSrc,
+                                int nSrcStride,
+                                int nIters)
 {
     if( nDestStride == 1 )
     {
         if( nSrcStride == 1 )
         {
-            memcpy(pabyDest, pabySrc, nIters);
+            memcpy(pDest, pSrc, nIters * sizeof(T));
+        }
+        else if( nSrcStride == 2 )
+        {
+            GDALUnrolledCopy<T, 2,1>(pDest, pSrc, nIters);
         }
         else if( nSrcStride == 3 )
         {
-            GDALUnrolledByteCopy<3,1>(pabyDest, pabySrc, nIters);
+            GDALUnrolledCopy<T, 3,1>(pDest, pSrc, nIters);
         }
         else if( nSrcStride == 4 )
         {
-            GDALUnrolledByteCopy<4,1>(pabyDest, pabySrc, nIters);
+            GDALUnrolledCopy<T, 4,1>(pDest, pSrc, nIters);
         }
         else
         {
             while( nIters-- > 0 )
             {
-                *pabyDest = *pabySrc;
-                pabySrc += nSrcStride;
-                pabyDest ++;
+                *pDest = *pSrc;
+                pSrc += nSrcStride;
+                pDest ++;
             }
         }
     }
     else if( nSrcStride == 1 )
     {
-        if( nDestStride == 3 )
+        if( nDestStride == 2 )
+        {
+            GDALUnrolledCopy<T, 1,2>(pDest, pSrc, nIters);
+        }
+        else if( nDestStride == 3 )
         {
-            GDALUnrolledByteCopy<1,3>(pabyDest, pabySrc, nIters);
+            GDALUnrolledCopy<T, 1,3>(pDest, pSrc, nIters);
         }
         else if( nDestStride == 4 )
         {
-            GDALUnrolledByteCopy<1,4>(pabyDest, pabySrc, nIters);
+            GDALUnrolledCopy<T, 1,4>(pDest, pSrc, nIters);
         }
         else
         {
             while( nIters-- > 0 )
             {
-                *pabyDest = *pabySrc;
-                pabySrc ++;
-                pabyDest += nDestStride;
+                *pDest = *pSrc;
+                pSrc ++;
+                pDest += nDestStride;
             }
         }
     }
@@ -2192,13 +2825,53 @@ static inline void GDALFastByteCopy(GByte* CPL_RESTRICT pabyDest,
     {
         while( nIters-- > 0 )
         {
-            *pabyDest = *pabySrc;
-            pabySrc += nSrcStride;
-            pabyDest += nDestStride;
+            *pDest = *pSrc;
+            pSrc += nSrcStride;
+            pDest += nDestStride;
         }
     }
 }
 
+/************************************************************************/
+/*                          GDALFastWordCopy()                          */
+/************************************************************************/
+
+/* Same type copy between buffers whose strides are multiple of the */
+/* word size, typically between pixel and band interleaved buffers. */
+/* Returns FALSE if the strides do not allow it. */
+static int GDALFastWordCopy(void* CPL_RESTRICT pDstData, int nDstPixelStride,
+                            const void* CPL_RESTRICT pSrcData, int nSrcPixelStride,
+                            int nWordSize, int nWordCount)
+{
+    if( nSrcPixelStride <= 0 || nDstPixelStride <= 0 ||
+        (nSrcPixelStride % nWordSize) != 0 ||
+        (nDstPixelStride % nWordSize) != 0 )
+        return FALSE;
+
+    const int nSrcStride = nSrcPixelStride / nWordSize;
+    const int nDstStride = nDstPixelStride / nWordSize;
+    switch( nWordSize )
+    {
+        case 2:
+            GDALFastCopy(static_cast<GUInt16*>(pDstData), nDstStride,
+                         static_cast<const GUInt16*>(pSrcData), nSrcStride,
+                         nWordCount);
+            return TRUE;
+        case 4:
+            GDALFastCopy(static_cast<GUInt32*>(pDstData), nDstStride,
+                         static_cast<const GUInt32*>(pSrcData), nSrcStride,
+                         nWordCount);
+            return TRUE;
+        case 8:
+            GDALFastCopy(static_cast<GUIntBig*>(pDstData), nDstStride,
+                         static_cast<const GUIntBig*>(pSrcData), nSrcStride,
+                         nWordCount);
+            return TRUE;
+        default:
+            return FALSE;
+    }
+}
+
 /************************************************************************/
 /*                           GDALCopyWords()                            */
 /************************************************************************/
@@ -2304,8 +2977,8 @@ GDALCopyWords( const void * CPL_RESTRICT pSrcData, GDALDataType eSrcType, int nS
     {
         if( eSrcType == GDT_Byte )
         {
-            GDALFastByteCopy((GByte*)pDstData, nDstPixelStride,
-                             (const GByte*)pSrcData, nSrcPixelStride, nWordCount);
+            GDALFastCopy((GByte*)pDstData, nDstPixelStride,
+                         (const GByte*)pSrcData, nSrcPixelStride, nWordCount);
             return;
         }
 
@@ -2334,6 +3007,12 @@ GDALCopyWords( const void * CPL_RESTRICT pSrcData, GDALDataType eSrcType, int nS
                 return;
             }
         }
+
+        // Pixel interleaved <--> band sequential copies
+        if( GDALFastWordCopy(pDstData, nDstPixelStride,
+                             pSrcData, nSrcPixelStride,
+                             nSrcDataTypeSize, nWordCount) )
+            return;
     }
 
     // Handle the more general case -- deals with conversion of data types
@@ -3817,5 +4496,7 @@ void GDALCopyRasterIOExtraArg(GDALRasterIOExtraArg* psDestArg,
             psDestArg->dfXSize = psSrcArg->dfXSize;
             psDestArg->dfYSize = psSrcArg->dfYSize;
         }
+        if( psSrcArg->nVersion >= 2 )
+            psDestArg->bDirectRead = psSrcArg->bDirectRead;
     }
 }
@@ -463,6 +463,9 @@ class CPL_DLL OGRFeatureQuery
   private:
     OGRFeatureDefn *poTargetDefn;
     void           *pSWQExpr;
+    void           *pSWQProgram;
+    int             bSWQExprChecked;
+    int             bSWQProgramTried;
 
     char          **FieldCollector( void *, char ** );
 
@@ -484,7 +487,8 @@ class CPL_DLL OGRFeatureQuery
 
     char      **GetUsedFields();
 
-    void       *GetSWQExpr() { return pSWQExpr; }
+    void       *GetSWQExpr() const;
+    void        ResetProgram();
 };
 
 #endif /* ndef OGR_FEATURE_H_INCLUDED */
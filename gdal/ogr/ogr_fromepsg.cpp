@@ -41,6 +41,8 @@ extern void OGRsnPrintDouble( char * pszStrBuf, size_t size, double dfValue );
 
 int EPSGGetWGS84Transform( int nGeogCS, std::vector<CPLString>& asTransform );
 void OGREPSGDatumNameMassage( char ** ppszDatum );
+bool EPSGCacheFetch( int nCode, CPLString &osWKT );
+void EPSGCacheStore( int nCode, const char *pszWKT );
 
 static const char * const apszDatumEquiv[] =
 {
@@ -2052,9 +2054,11 @@ static OGRErr SetEPSGGeocCS( OGRSpatialReference * poSRS, int nGCSCode )
  * or in the directory identified by the GDAL_DATA configuration option.
  * See CPLFindFile() for details.
  *
- * This method is relatively expensive, and generally involves quite a bit
- * of text file scanning.  Reasonable efforts should be made to avoid calling
- * it many times for the same coordinate system.
+ * The first call for a given code is relatively expensive, and generally
+ * involves quite a bit of text file scanning.  Starting with GDAL 2.2, the
+ * resulting definitions are cached in the process, and if a binary EPSG
+ * dictionary (epsg_wkt.bin, see OSRWriteEPSGDictionary()) is found next to
+ * gcs.csv, it is used instead of the text files.
  *
  * This method is similar to importFromEPSGA() except that EPSG preferred
  * axis ordering will *not* be applied for geographic coordinate systems.
@@ -2148,6 +2152,21 @@ OGRErr OGRSpatialReference::importFromEPSGA( int nCode )
         poRoot = NULL;
     }
 
+/* -------------------------------------------------------------------- */
+/*      Use the definition built by a previous call, or found in the    */
+/*      binary EPSG dictionary, if there is one.                        */
+/* -------------------------------------------------------------------- */
+    CPLString osCachedWKT;
+    if( EPSGCacheFetch( nCode, osCachedWKT ) )
+    {
+        char *pszWKT = const_cast<char *>(osCachedWKT.c_str());
+        if( importFromWkt( &pszWKT ) == OGRERR_NONE )
+            return OGRERR_NONE;
+
+        delete poRoot;
+        poRoot = NULL;
+    }
+
 /* -------------------------------------------------------------------- */
 /*      Verify that we can find the required filename(s).               */
 /* -------------------------------------------------------------------- */
@@ -2245,6 +2264,17 @@ OGRErr OGRSpatialReference::importFromEPSGA( int nCode )
         eErr = FixupOrdering();
     }
 
+/* -------------------------------------------------------------------- */
+/*      Remember the definition for the next calls.                     */
+/* -------------------------------------------------------------------- */
+    if( eErr == OGRERR_NONE )
+    {
+        char *pszWKT = NULL;
+        if( exportToWkt( &pszWKT ) == OGRERR_NONE )
+            EPSGCacheStore( nCode, pszWKT );
+        CPLFree( pszWKT );
+    }
+
     return eErr;
 }
 
@@ -136,6 +136,7 @@ extern const swq_field_type SpecialFieldTypes[SPECIAL_FIELD_COUNT];
 /************************************************************************/
 
 OGRErr CPL_DLL OSRGetEllipsoidInfo( int, char **, double *, double *);
+OGRErr CPL_DLL OSRWriteEPSGDictionary( const char *pszFilename );
 
 /* Fast atof function */
 double OGRFastAtof(const char* pszStr);
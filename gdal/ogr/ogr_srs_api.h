@@ -766,10 +766,14 @@ OCTTransformEx( OGRCoordinateTransformationH hCT,
                 int nCount, double *x, double *y, double *z,
                 int *pabSuccess );
 
+void CPL_DLL OCTGetCacheStatistics( int *pnEntries, GIntBig *pnHits,
+                                    GIntBig *pnMisses );
+
 /* this is really private to OGR. */
 char *OCTProj4Normalize( const char *pszProj4Src );
 
 void OCTCleanupProjMutex( void );
+void OCTCleanupTransformationCache( void );
 
 /* -------------------------------------------------------------------- */
 /*      Projection transform dictionary query.                          */
@@ -0,0 +1,682 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  In-process cache of EPSG coordinate systems, and precompiled
+ *           binary dictionary of the WKT built from the EPSG support files.
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "cpl_conv.h"
+#include "cpl_csv.h"
+#include "cpl_multiproc.h"
+#include "cpl_vsi.h"
+#include "gdal_version.h"
+#include "ogr_p.h"
+#include "ogr_spatialref.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+CPL_CVSID("$Id$");
+
+bool EPSGCacheFetch( int nCode, CPLString &osWKT );
+void EPSGCacheStore( int nCode, const char *pszWKT );
+void EPSGCacheCleanup();
+
+/*
+ * The binary dictionary (epsg_wkt.bin) is written next to gcs.csv and
+ * holds the WKT that importFromEPSGA() produces for every code of the
+ * EPSG support files.  All integers are little endian.
+ *
+ *   Header:
+ *     "GDALEPSG"                         8 bytes
+ *     format version                     uint32
+ *     GDAL_VERSION_NUM of the writer     uint32
+ *     size of each file of
+ *     apszEPSGDictSources[]              uint32 each
+ *     bucket count (power of two)        uint32
+ *     block count                        uint32
+ *
+ *   Bucket table, open addressing with linear probing, code 0 = empty:
+ *     code                               int32
+ *     block index                        uint32
+ *     offset of the WKT in the block     uint32
+ *     size of the WKT                    uint32
+ *
+ *   Block table:
+ *     offset of the compressed block     uint32
+ *     compressed size                    uint32
+ *     uncompressed size                  uint32
+ *
+ *   Zlib compressed blocks.
+ *
+ * The WKT strings are concatenated in code order, and compressed by blocks
+ * of EPSG_DICT_BLOCK_ENTRIES so that the many similar definitions of
+ * neighbouring codes (UTM zones, ...) compress well.
+ */
+
+static const char szEPSGDictSignature[] = "GDALEPSG";
+static const GUInt32 EPSG_DICT_VERSION = 2;
+static const char EPSG_DICT_FILENAME[] = "epsg_wkt.bin";
+static const int EPSG_DICT_BUCKET_SIZE = 16;
+static const int EPSG_DICT_BLOCK_SIZE = 12;
+static const int EPSG_DICT_BLOCK_ENTRIES = 16;
+
+static const char * const apszEPSGDictSources[] =
+{
+    "gcs.csv", "gcs.override.csv", "pcs.csv", "pcs.override.csv",
+    "vertcs.csv", "vertcs.override.csv", "compdcs.csv",
+    "compdcs.override.csv", "geoccs.csv", "ellipsoid.csv",
+    "prime_meridian.csv", "unit_of_measure.csv", "coordinate_axis.csv",
+    "epsg.wkt"
+};
+
+static const int nEPSGDictSources =
+    static_cast<int>(sizeof(apszEPSGDictSources) / sizeof(char*));
+static const int nEPSGDictHeaderSize = 8 + 4 * (2 + nEPSGDictSources + 2);
+
+/* Process wide state, protected by hEPSGCacheMutex. */
+static CPLMutex *hEPSGCacheMutex = NULL;
+static std::map<int, CPLString> *poEPSGCache = NULL;
+static char *pszEPSGCacheKey = NULL;
+static GByte *pabyEPSGDict = NULL;
+static vsi_l_offset nEPSGDictSize = 0;
+static bool bEPSGDictTried = false;
+static GUInt32 iEPSGDictCurBlock = 0;
+static CPLString *posEPSGDictCurBlock = NULL;
+
+/************************************************************************/
+/*                          EPSGDictReadUInt32()                        */
+/************************************************************************/
+
+static GUInt32 EPSGDictReadUInt32( const GByte *pabyData )
+{
+    GUInt32 nVal = 0;
+    memcpy( &nVal, pabyData, 4 );
+    CPL_LSBPTR32( &nVal );
+    return nVal;
+}
+
+/************************************************************************/
+/*                          EPSGDictWriteUInt32()                       */
+/************************************************************************/
+
+static void EPSGDictWriteUInt32( std::vector<GByte> &abyData, size_t nOffset,
+                                 GUInt32 nVal )
+{
+    CPL_LSBPTR32( &nVal );
+    memcpy( &abyData[nOffset], &nVal, 4 );
+}
+
+/************************************************************************/
+/*                           EPSGDictHash()                             */
+/************************************************************************/
+
+static GUInt32 EPSGDictHash( int nCode )
+{
+    return static_cast<GUInt32>(nCode) * 2654435761U;
+}
+
+/************************************************************************/
+/*                        EPSGDictSourceSize()                          */
+/*                                                                      */
+/*      Size of one of the EPSG support files, or 0 if it does not     */
+/*      exist.                                                          */
+/************************************************************************/
+
+static GUInt32 EPSGDictSourceSize( const char *pszDataDir,
+                                   const char *pszBasename )
+{
+    VSIStatBufL sStat;
+    if( VSIStatL( CPLFormFilename( pszDataDir, pszBasename, NULL ),
+                  &sStat ) != 0 )
+        return 0;
+    return static_cast<GUInt32>(sStat.st_size);
+}
+
+/************************************************************************/
+/*                          EPSGDictLoad()                              */
+/*                                                                      */
+/*      Ingest the dictionary next to gcs.csv in a single read, and     */
+/*      check that it was built from the support files found there      */
+/*      by this version of GDAL.  Called with the mutex held.           */
+/************************************************************************/
+
+static void EPSGDictLoad( const char *pszGCSFilename )
+{
+    bEPSGDictTried = true;
+
+    CPLString osDataDir = CPLGetPath( pszGCSFilename );
+    if( osDataDir.empty() )
+        return;
+
+    CPLString osFilename =
+        CPLFormFilename( osDataDir, EPSG_DICT_FILENAME, NULL );
+    VSIStatBufL sStat;
+    if( VSIStatL( osFilename, &sStat ) != 0 )
+        return;
+
+    GByte *pabyData = NULL;
+    vsi_l_offset nSize = 0;
+    if( !VSIIngestFile( NULL, osFilename, &pabyData, &nSize, 256*1024*1024 ) )
+        return;
+
+    bool bValid = nSize >= static_cast<vsi_l_offset>(nEPSGDictHeaderSize) &&
+        memcmp( pabyData, szEPSGDictSignature, 8 ) == 0 &&
+        EPSGDictReadUInt32( pabyData + 8 ) == EPSG_DICT_VERSION &&
+        EPSGDictReadUInt32( pabyData + 12 ) ==
+            static_cast<GUInt32>(GDAL_VERSION_NUM);
+
+    for( int i = 0; bValid && i < nEPSGDictSources; i++ )
+    {
+        if( EPSGDictReadUInt32( pabyData + 16 + 4 * i ) !=
+            EPSGDictSourceSize( osDataDir, apszEPSGDictSources[i] ) )
+        {
+            CPLDebug( "OSR", "%s is out of date with %s, ignoring it.",
+                      osFilename.c_str(), apszEPSGDictSources[i] );
+            bValid = false;
+        }
+    }
+
+    if( bValid )
+    {
+        const GUInt32 nBuckets =
+            EPSGDictReadUInt32( pabyData + nEPSGDictHeaderSize - 8 );
+        const GUInt32 nBlocks =
+            EPSGDictReadUInt32( pabyData + nEPSGDictHeaderSize - 4 );
+        bValid = nBuckets != 0 && (nBuckets & (nBuckets - 1)) == 0 &&
+            nEPSGDictHeaderSize +
+            static_cast<vsi_l_offset>(nBuckets) * EPSG_DICT_BUCKET_SIZE +
+            static_cast<vsi_l_offset>(nBlocks) * EPSG_DICT_BLOCK_SIZE <= nSize;
+    }
+
+    if( !bValid )
+    {
+        CPLDebug( "OSR", "Ignoring invalid EPSG dictionary %s.",
+                  osFilename.c_str() );
+        VSIFree( pabyData );
+        return;
+    }
+
+    pabyEPSGDict = pabyData;
+    nEPSGDictSize = nSize;
+}
+
+/************************************************************************/
+/*                         EPSGDictLookup()                             */
+/*                                                                      */
+/*      Called with the mutex held.                                     */
+/************************************************************************/
+
+static bool EPSGDictLookup( int nCode, CPLString &osWKT )
+{
+    if( pabyEPSGDict == NULL || nCode <= 0 )
+        return false;
+
+    const GUInt32 nBuckets =
+        EPSGDictReadUInt32( pabyEPSGDict + nEPSGDictHeaderSize - 8 );
+    const GUInt32 nBlocks =
+        EPSGDictReadUInt32( pabyEPSGDict + nEPSGDictHeaderSize - 4 );
+    const GByte *pabyBuckets = pabyEPSGDict + nEPSGDictHeaderSize;
+    const GByte *pabyBlocks =
+        pabyBuckets + static_cast<size_t>(nBuckets) * EPSG_DICT_BUCKET_SIZE;
+
+    GUInt32 iBucket = EPSGDictHash( nCode ) & (nBuckets - 1);
+    for( GUInt32 nProbes = 0; nProbes < nBuckets; nProbes++ )
+    {
+        const GByte *pabyBucket = pabyBuckets + iBucket * EPSG_DICT_BUCKET_SIZE;
+        const int nBucketCode =
+            static_cast<int>(EPSGDictReadUInt32( pabyBucket ));
+        if( nBucketCode == 0 )
+            return false;
+
+        if( nBucketCode == nCode )
+        {
+            const GUInt32 iBlock = EPSGDictReadUInt32( pabyBucket + 4 );
+            const GUInt32 nWKTOffset = EPSGDictReadUInt32( pabyBucket + 8 );
+            const GUInt32 nWKTSize = EPSGDictReadUInt32( pabyBucket + 12 );
+            if( iBlock >= nBlocks )
+                return false;
+
+/* -------------------------------------------------------------------- */
+/*      Decompress the block, unless it is the one of the previous      */
+/*      lookup.                                                         */
+/* -------------------------------------------------------------------- */
+            if( posEPSGDictCurBlock == NULL || iEPSGDictCurBlock != iBlock )
+            {
+                const GByte *pabyBlock =
+                    pabyBlocks + iBlock * EPSG_DICT_BLOCK_SIZE;
+                const GUInt32 nOffset = EPSGDictReadUInt32( pabyBlock );
+                const GUInt32 nCompressed =
+                    EPSGDictReadUInt32( pabyBlock + 4 );
+                const GUInt32 nBlockSize = EPSGDictReadUInt32( pabyBlock + 8 );
+                if( nOffset > nEPSGDictSize ||
+                    nCompressed > nEPSGDictSize - nOffset ||
+                    nBlockSize == 0 || nBlockSize > 16 * 1024 * 1024 )
+                    return false;
+
+                if( posEPSGDictCurBlock == NULL )
+                    posEPSGDictCurBlock = new CPLString();
+                posEPSGDictCurBlock->resize( nBlockSize );
+                size_t nOutBytes = 0;
+                if( CPLZLibInflate( pabyEPSGDict + nOffset, nCompressed,
+                                    &(*posEPSGDictCurBlock)[0], nBlockSize,
+                                    &nOutBytes ) == NULL ||
+                    nOutBytes != nBlockSize )
+                {
+                    delete posEPSGDictCurBlock;
+                    posEPSGDictCurBlock = NULL;
+                    return false;
+                }
+                iEPSGDictCurBlock = iBlock;
+            }
+
+            if( nWKTSize == 0 || nWKTOffset > posEPSGDictCurBlock->size() ||
+                nWKTSize > posEPSGDictCurBlock->size() - nWKTOffset )
+                return false;
+
+            osWKT.assign( *posEPSGDictCurBlock, nWKTOffset, nWKTSize );
+            return true;
+        }
+
+        iBucket = (iBucket + 1) & (nBuckets - 1);
+    }
+
+    return false;
+}
+
+/************************************************************************/
+/*                          EPSGDictUnload()                            */
+/*                                                                      */
+/*      Called with the mutex held.                                     */
+/************************************************************************/
+
+static void EPSGDictUnload()
+{
+    VSIFree( pabyEPSGDict );
+    pabyEPSGDict = NULL;
+    nEPSGDictSize = 0;
+    bEPSGDictTried = false;
+    delete posEPSGDictCurBlock;
+    posEPSGDictCurBlock = NULL;
+}
+
+/************************************************************************/
+/*                         EPSGCacheCheckKey()                          */
+/*                                                                      */
+/*      Discard the cached definitions if the EPSG support files are    */
+/*      now found elsewhere.  Called with the mutex held.               */
+/************************************************************************/
+
+static void EPSGCacheCheckKey( const char *pszGCSFilename )
+{
+    if( pszEPSGCacheKey != NULL && strcmp(pszEPSGCacheKey, pszGCSFilename) == 0 )
+        return;
+
+    CPLFree( pszEPSGCacheKey );
+    pszEPSGCacheKey = CPLStrdup( pszGCSFilename );
+
+    if( poEPSGCache != NULL )
+        poEPSGCache->clear();
+
+    EPSGDictUnload();
+}
+
+/************************************************************************/
+/*                          EPSGCacheFetch()                            */
+/*                                                                      */
+/*      Fetch the WKT of an EPSG code from the in-process cache, or     */
+/*      from the binary dictionary.                                     */
+/************************************************************************/
+
+bool EPSGCacheFetch( int nCode, CPLString &osWKT )
+
+{
+    CPLString osGCSFilename = CSVFilename( "gcs.csv" );
+
+    CPLMutexHolderD( &hEPSGCacheMutex );
+
+    EPSGCacheCheckKey( osGCSFilename );
+
+    if( poEPSGCache != NULL )
+    {
+        std::map<int, CPLString>::const_iterator oIter =
+            poEPSGCache->find( nCode );
+        if( oIter != poEPSGCache->end() )
+        {
+            osWKT = oIter->second;
+            return true;
+        }
+    }
+
+    if( !CPLTestBool( CPLGetConfigOption( "OSR_USE_EPSG_DICTIONARY",
+                                          "YES" ) ) )
+        return false;
+
+    if( !bEPSGDictTried )
+        EPSGDictLoad( osGCSFilename );
+
+    if( !EPSGDictLookup( nCode, osWKT ) )
+        return false;
+
+    if( poEPSGCache == NULL )
+        poEPSGCache = new std::map<int, CPLString>();
+    (*poEPSGCache)[nCode] = osWKT;
+
+    return true;
+}
+
+/************************************************************************/
+/*                          EPSGCacheStore()                            */
+/************************************************************************/
+
+void EPSGCacheStore( int nCode, const char *pszWKT )
+
+{
+    CPLString osGCSFilename = CSVFilename( "gcs.csv" );
+
+    CPLMutexHolderD( &hEPSGCacheMutex );
+
+    EPSGCacheCheckKey( osGCSFilename );
+
+    if( poEPSGCache == NULL )
+        poEPSGCache = new std::map<int, CPLString>();
+    (*poEPSGCache)[nCode] = pszWKT;
+}
+
+/************************************************************************/
+/*                         EPSGCacheCleanup()                           */
+/************************************************************************/
+
+void EPSGCacheCleanup()
+
+{
+    delete poEPSGCache;
+    poEPSGCache = NULL;
+    CPLFree( pszEPSGCacheKey );
+    pszEPSGCacheKey = NULL;
+    EPSGDictUnload();
+
+    if( hEPSGCacheMutex != NULL )
+    {
+        CPLDestroyMutex( hEPSGCacheMutex );
+        hEPSGCacheMutex = NULL;
+    }
+}
+
+/************************************************************************/
+/*                       EPSGDictCollectCodes()                         */
+/*                                                                      */
+/*      Collect the COORD_REF_SYS_CODE values of a CSV table.           */
+/************************************************************************/
+
+static void EPSGDictCollectCodes( const char *pszFilename,
+                                  std::set<int> &oCodes )
+{
+    VSILFILE *fp = VSIFOpenL( pszFilename, "rb" );
+    if( fp == NULL )
+        return;
+
+    char **papszFields = CSVReadParseLineL( fp );
+    const int iCodeField =
+        CSLFindString( papszFields, "COORD_REF_SYS_CODE" );
+    CSLDestroy( papszFields );
+
+    if( iCodeField >= 0 )
+    {
+        while( (papszFields = CSVReadParseLineL( fp )) != NULL )
+        {
+            if( iCodeField < CSLCount( papszFields ) &&
+                atoi( papszFields[iCodeField] ) > 0 )
+                oCodes.insert( atoi( papszFields[iCodeField] ) );
+            CSLDestroy( papszFields );
+        }
+    }
+
+    VSIFCloseL( fp );
+}
+
+/************************************************************************/
+/*                      OSRWriteEPSGDictionary()                        */
+/************************************************************************/
+
+/**
+ * \brief Write the binary EPSG dictionary.
+ *
+ * Builds every coordinate system of the EPSG support files (gcs.csv,
+ * pcs.csv, vertcs.csv, compdcs.csv, geoccs.csv, their overrides and
+ * epsg.wkt) with importFromEPSGA(), and writes their WKT in a
+ * dictionary that importFromEPSGA() looks up in constant time instead of
+ * ingesting the CSV files.  To be used, the dictionary must be named
+ * epsg_wkt.bin and be located in the same directory as gcs.csv.  It is
+ * ignored if those files, or the version of GDAL, change.
+ *
+ * The OSR_USE_EPSG_DICTIONARY configuration option can be set to NO to
+ * disable the use of the dictionary.
+ *
+ * @param pszFilename the file to write.
+ *
+ * @return OGRERR_NONE on success.
+ *
+ * @since GDAL 2.2
+ */
+
+OGRErr OSRWriteEPSGDictionary( const char *pszFilename )
+
+{
+    const char *pszGCSFilename = CSVFilename( "gcs.csv" );
+    CPLString osDataDir = CPLGetPath( pszGCSFilename );
+    if( osDataDir.empty() )
+    {
+        CPLError( CE_Failure, CPLE_OpenFailed,
+                  "Unable to find EPSG support file gcs.csv." );
+        return OGRERR_FAILURE;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Collect the codes of all the support files.                     */
+/* -------------------------------------------------------------------- */
+    std::set<int> oCodes;
+    const char * const apszTables[] =
+        { "gcs.csv", "gcs.override.csv", "pcs.csv", "pcs.override.csv",
+          "vertcs.csv", "vertcs.override.csv", "compdcs.csv", "geoccs.csv" };
+    for( size_t i = 0; i < sizeof(apszTables) / sizeof(char*); i++ )
+        EPSGDictCollectCodes( CPLFormFilename( osDataDir, apszTables[i], NULL ),
+                              oCodes );
+
+    const char *pszDictFilename = CPLFindFile( "gdal", "epsg.wkt" );
+    VSILFILE *fpDict =
+        pszDictFilename ? VSIFOpenL( pszDictFilename, "rb" ) : NULL;
+    if( fpDict != NULL )
+    {
+        const char *pszLine = NULL;
+        while( (pszLine = CPLReadLineL( fpDict )) != NULL )
+        {
+            if( pszLine[0] != '#' && atoi(pszLine) > 0 )
+                oCodes.insert( atoi(pszLine) );
+        }
+        VSIFCloseL( fpDict );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Build the definitions from the support files only.              */
+/* -------------------------------------------------------------------- */
+    CPLString osOldUseDict = CPLGetThreadLocalConfigOption(
+        "OSR_USE_EPSG_DICTIONARY", "" );
+    CPLSetThreadLocalConfigOption( "OSR_USE_EPSG_DICTIONARY", "NO" );
+    {
+        CPLMutexHolderD( &hEPSGCacheMutex );
+        if( poEPSGCache != NULL )
+            poEPSGCache->clear();
+    }
+
+    std::vector<int> anCodes;
+    std::vector<CPLString> aosWKT;
+
+    CPLPushErrorHandler( CPLQuietErrorHandler );
+    for( std::set<int>::const_iterator oIter = oCodes.begin();
+         oIter != oCodes.end(); ++oIter )
+    {
+        OGRSpatialReference oSRS;
+        if( oSRS.importFromEPSGA( *oIter ) != OGRERR_NONE )
+            continue;
+
+        char *pszWKT = NULL;
+        if( oSRS.exportToWkt( &pszWKT ) == OGRERR_NONE && pszWKT[0] != '\0' )
+        {
+            anCodes.push_back( *oIter );
+            aosWKT.push_back( pszWKT );
+        }
+        CPLFree( pszWKT );
+    }
+    CPLPopErrorHandler();
+
+    CPLSetThreadLocalConfigOption( "OSR_USE_EPSG_DICTIONARY",
+        osOldUseDict.empty() ? NULL : osOldUseDict.c_str() );
+
+    if( anCodes.empty() )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "No coordinate system could be built from the EPSG "
+                  "support files." );
+        return OGRERR_FAILURE;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Lay out the header, the bucket table, with a load factor of     */
+/*      at most three quarters, and the block table.                    */
+/* -------------------------------------------------------------------- */
+    GUInt32 nBuckets = 1;
+    while( 3 * static_cast<size_t>(nBuckets) < 4 * anCodes.size() )
+        nBuckets *= 2;
+    const GUInt32 nBlocks = static_cast<GUInt32>(
+        (anCodes.size() + EPSG_DICT_BLOCK_ENTRIES - 1) /
+        EPSG_DICT_BLOCK_ENTRIES );
+
+    const size_t nBucketsOffset = nEPSGDictHeaderSize;
+    const size_t nBlocksOffset =
+        nBucketsOffset + static_cast<size_t>(nBuckets) * EPSG_DICT_BUCKET_SIZE;
+    std::vector<GByte> abyData(
+        nBlocksOffset + static_cast<size_t>(nBlocks) * EPSG_DICT_BLOCK_SIZE,
+        0 );
+
+    memcpy( &abyData[0], szEPSGDictSignature, 8 );
+    EPSGDictWriteUInt32( abyData, 8, EPSG_DICT_VERSION );
+    EPSGDictWriteUInt32( abyData, 12, static_cast<GUInt32>(GDAL_VERSION_NUM) );
+    for( int i = 0; i < nEPSGDictSources; i++ )
+        EPSGDictWriteUInt32( abyData, 16 + 4 * i,
+            EPSGDictSourceSize( osDataDir, apszEPSGDictSources[i] ) );
+    EPSGDictWriteUInt32( abyData, nEPSGDictHeaderSize - 8, nBuckets );
+    EPSGDictWriteUInt32( abyData, nEPSGDictHeaderSize - 4, nBlocks );
+
+/* -------------------------------------------------------------------- */
+/*      Fill the buckets, and append the compressed blocks.             */
+/* -------------------------------------------------------------------- */
+    for( GUInt32 iBlock = 0; iBlock < nBlocks; iBlock++ )
+    {
+        CPLString osBlock;
+        const size_t iFirst =
+            static_cast<size_t>(iBlock) * EPSG_DICT_BLOCK_ENTRIES;
+        for( size_t i = iFirst;
+             i < anCodes.size() && i < iFirst + EPSG_DICT_BLOCK_ENTRIES; i++ )
+        {
+            GUInt32 iBucket = EPSGDictHash( anCodes[i] ) & (nBuckets - 1);
+            while( EPSGDictReadUInt32( &abyData[nBucketsOffset +
+                                       iBucket * EPSG_DICT_BUCKET_SIZE] ) != 0 )
+                iBucket = (iBucket + 1) & (nBuckets - 1);
+
+            const size_t nBucketOffset =
+                nBucketsOffset + iBucket * EPSG_DICT_BUCKET_SIZE;
+            EPSGDictWriteUInt32( abyData, nBucketOffset,
+                                 static_cast<GUInt32>(anCodes[i]) );
+            EPSGDictWriteUInt32( abyData, nBucketOffset + 4, iBlock );
+            EPSGDictWriteUInt32( abyData, nBucketOffset + 8,
+                                 static_cast<GUInt32>(osBlock.size()) );
+            EPSGDictWriteUInt32( abyData, nBucketOffset + 12,
+                                 static_cast<GUInt32>(aosWKT[i].size()) );
+            osBlock += aosWKT[i];
+        }
+
+        size_t nCompressed = 0;
+        void *pCompressed = CPLZLibDeflate( osBlock.data(), osBlock.size(), 9,
+                                            NULL, 0, &nCompressed );
+        if( pCompressed == NULL )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                      "Cannot compress the EPSG dictionary." );
+            return OGRERR_FAILURE;
+        }
+
+        const size_t nBlockOffset =
+            nBlocksOffset + iBlock * EPSG_DICT_BLOCK_SIZE;
+        EPSGDictWriteUInt32( abyData, nBlockOffset,
+                             static_cast<GUInt32>(abyData.size()) );
+        EPSGDictWriteUInt32( abyData, nBlockOffset + 4,
+                             static_cast<GUInt32>(nCompressed) );
+        EPSGDictWriteUInt32( abyData, nBlockOffset + 8,
+                             static_cast<GUInt32>(osBlock.size()) );
+        abyData.insert( abyData.end(), static_cast<GByte *>(pCompressed),
+                        static_cast<GByte *>(pCompressed) + nCompressed );
+        VSIFree( pCompressed );
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Write the file.                                                 */
+/* -------------------------------------------------------------------- */
+    VSILFILE *fp = VSIFOpenL( pszFilename, "wb" );
+    if( fp == NULL )
+    {
+        CPLError( CE_Failure, CPLE_OpenFailed,
+                  "Cannot create %s.", pszFilename );
+        return OGRERR_FAILURE;
+    }
+
+    bool bOK = VSIFWriteL( &abyData[0], 1, abyData.size(), fp ) ==
+               abyData.size();
+    if( VSIFCloseL( fp ) != 0 )
+        bOK = false;
+
+    if( !bOK )
+    {
+        CPLError( CE_Failure, CPLE_FileIO, "Cannot write %s.", pszFilename );
+        return OGRERR_FAILURE;
+    }
+
+    CPLDebug( "OSR", "Wrote %d EPSG coordinate systems in %s.",
+              static_cast<int>(anCodes.size()), pszFilename );
+
+/* -------------------------------------------------------------------- */
+/*      Release the definitions cached while building, and make sure    */
+/*      the new dictionary gets reloaded if it replaces the one in use. */
+/* -------------------------------------------------------------------- */
+    {
+        CPLMutexHolderD( &hEPSGCacheMutex );
+        if( poEPSGCache != NULL )
+            poEPSGCache->clear();
+        EPSGDictUnload();
+    }
+
+    return OGRERR_NONE;
+}
@@ -34,6 +34,10 @@
 #include "cpl_conv.h"
 #include "cpl_string.h"
 #include "cpl_multiproc.h"
+#include "ogrct_fastpath.h"
+
+#include <map>
+#include <vector>
 
 #ifdef PROJ_STATIC
 #include "proj_api.h"
@@ -146,8 +150,16 @@ class OGRProj4CT : public OGRCoordinateTransformation
 
     projCtx     pjctx;
 
+    CPLString   osCacheKey;
+
+    OGRProj4FastPath *poFastPath;
+
     int         InitializeNoLock( OGRSpatialReference *poSource,
                                   OGRSpatialReference *poTarget );
+    int         ExportToProj4Defns( char **ppszSrcProj4Defn,
+                                    char **ppszDstProj4Defn );
+    void        CreateFastPath( const char *pszSrcProj4Defn,
+                                const char *pszDstProj4Defn );
 
     int         nMaxCount;
     double     *padfOriX;
@@ -353,6 +365,312 @@ char *OCTProj4Normalize( const char *pszProj4Src )
 
 }
 
+/************************************************************************/
+/*                        Transformation cache                          */
+/*                                                                      */
+/*      The PROJ.4 definitions of the transformations are cached,       */
+/*      keyed by the WKT of their source and target SRS, so that        */
+/*      creating again a transformation between the same SRS does not  */
+/*      go through exportToProj4().  The PROJ.4 handles of destroyed    */
+/*      transformations are also kept, along with their PROJ.4          */
+/*      context, and handed over to the next transformation created     */
+/*      with the same key, which saves the pj_init_plus() calls.  A     */
+/*      set of handles is only ever owned by one transformation at a    */
+/*      time, so it does not need more locking than before.            */
+/************************************************************************/
+
+/* Number of handles of destroyed transformations kept per key. */
+#define OCT_CACHE_MAX_IDLE_HANDLES  8
+
+typedef struct
+{
+    projCtx     pjctx;
+    projPJ      psPJSource;
+    projPJ      psPJTarget;
+} OCTProj4Handles;
+
+typedef struct
+{
+    CPLString   osSrcProj4Defn;
+    CPLString   osDstProj4Defn;
+    bool        bWebMercatorToWGS84;
+    GIntBig     nLastUse;
+    std::vector<OCTProj4Handles> asIdleHandles;
+} OCTCacheEntry;
+
+/* Process wide state, protected by hCTCacheMutex. */
+static CPLMutex *hCTCacheMutex = NULL;
+static std::map<CPLString, OCTCacheEntry> *poCTCache = NULL;
+static GIntBig nCTCacheUseCounter = 0;
+static GIntBig nCTCacheHits = 0;
+static GIntBig nCTCacheMisses = 0;
+
+/************************************************************************/
+/*                        OCTFreeProj4Handles()                         */
+/************************************************************************/
+
+static void OCTFreeProj4Handles( const std::vector<OCTProj4Handles>& asHandles )
+
+{
+    for( size_t i = 0; i < asHandles.size(); i++ )
+    {
+        const OCTProj4Handles& sHandles = asHandles[i];
+        if( sHandles.pjctx != NULL )
+        {
+            pfn_pj_free( sHandles.psPJSource );
+            pfn_pj_free( sHandles.psPJTarget );
+            pfn_pj_ctx_free( sHandles.pjctx );
+        }
+        else
+        {
+            CPLMutexHolderD( &hPROJMutex );
+            pfn_pj_free( sHandles.psPJSource );
+            pfn_pj_free( sHandles.psPJTarget );
+        }
+    }
+}
+
+/************************************************************************/
+/*                          OCTGetCacheSize()                           */
+/************************************************************************/
+
+static int OCTGetCacheSize()
+
+{
+    return atoi( CPLGetConfigOption( "OGR_CT_CACHE_SIZE", "64" ) );
+}
+
+/************************************************************************/
+/*                           OCTCacheKey()                              */
+/************************************************************************/
+
+static CPLString OCTCacheKey( OGRSpatialReference *poSource,
+                              OGRSpatialReference *poTarget )
+
+{
+    CPLString osKey;
+    char *pszSrcWKT = NULL;
+    char *pszDstWKT = NULL;
+
+    if( poSource->exportToWkt( &pszSrcWKT ) == OGRERR_NONE &&
+        poTarget->exportToWkt( &pszDstWKT ) == OGRERR_NONE )
+    {
+        osKey = pszSrcWKT;
+        osKey += '\n';
+        osKey += pszDstWKT;
+
+        // exportToProj4() depends on those options.
+        osKey += '\n';
+        osKey += CPLGetConfigOption( "OSR_USE_ETMERC", "" );
+        osKey += '\n';
+        osKey += CPLGetConfigOption( "OVERRIDE_PROJ_DATUM_WITH_TOWGS84", "" );
+    }
+
+    CPLFree( pszSrcWKT );
+    CPLFree( pszDstWKT );
+
+    return osKey;
+}
+
+/************************************************************************/
+/*                           OCTCacheFetch()                            */
+/*                                                                      */
+/*      Returns the definitions cached for osKey, and if there are      */
+/*      some, idle handles that the caller then owns.                   */
+/************************************************************************/
+
+static bool OCTCacheFetch( const CPLString& osKey,
+                           CPLString& osSrcProj4Defn,
+                           CPLString& osDstProj4Defn,
+                           bool& bWebMercatorToWGS84,
+                           OCTProj4Handles& sHandles,
+                           bool& bGotHandles )
+
+{
+    CPLMutexHolderD( &hCTCacheMutex );
+
+    bGotHandles = false;
+
+    std::map<CPLString, OCTCacheEntry>::iterator oIter;
+    if( poCTCache == NULL ||
+        (oIter = poCTCache->find( osKey )) == poCTCache->end() )
+    {
+        nCTCacheMisses++;
+        return false;
+    }
+
+    nCTCacheHits++;
+
+    OCTCacheEntry& oEntry = oIter->second;
+    oEntry.nLastUse = ++nCTCacheUseCounter;
+    osSrcProj4Defn = oEntry.osSrcProj4Defn;
+    osDstProj4Defn = oEntry.osDstProj4Defn;
+    bWebMercatorToWGS84 = oEntry.bWebMercatorToWGS84;
+
+    if( !oEntry.asIdleHandles.empty() )
+    {
+        sHandles = oEntry.asIdleHandles.back();
+        oEntry.asIdleHandles.pop_back();
+        bGotHandles = true;
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                           OCTCacheStore()                            */
+/************************************************************************/
+
+static void OCTCacheStore( const CPLString& osKey,
+                           const char *pszSrcProj4Defn,
+                           const char *pszDstProj4Defn,
+                           bool bWebMercatorToWGS84,
+                           int nCacheSize )
+
+{
+    std::vector<OCTProj4Handles> asEvictedHandles;
+
+    {
+        CPLMutexHolderD( &hCTCacheMutex );
+
+        if( poCTCache == NULL )
+            poCTCache = new std::map<CPLString, OCTCacheEntry>();
+
+        std::map<CPLString, OCTCacheEntry>::iterator oIter =
+            poCTCache->find( osKey );
+        if( oIter != poCTCache->end() )
+        {
+            oIter->second.nLastUse = ++nCTCacheUseCounter;
+            return;
+        }
+
+        // Evict the least recently used entries.
+        while( !poCTCache->empty() &&
+               static_cast<int>(poCTCache->size()) >= nCacheSize )
+        {
+            std::map<CPLString, OCTCacheEntry>::iterator oOldest =
+                poCTCache->begin();
+            for( oIter = poCTCache->begin(); oIter != poCTCache->end(); ++oIter )
+            {
+                if( oIter->second.nLastUse < oOldest->second.nLastUse )
+                    oOldest = oIter;
+            }
+            asEvictedHandles.insert( asEvictedHandles.end(),
+                                     oOldest->second.asIdleHandles.begin(),
+                                     oOldest->second.asIdleHandles.end() );
+            poCTCache->erase( oOldest );
+        }
+
+        OCTCacheEntry& oEntry = (*poCTCache)[osKey];
+        oEntry.osSrcProj4Defn = pszSrcProj4Defn;
+        oEntry.osDstProj4Defn = pszDstProj4Defn;
+        oEntry.bWebMercatorToWGS84 = bWebMercatorToWGS84;
+        oEntry.nLastUse = ++nCTCacheUseCounter;
+    }
+
+    // Done out of hCTCacheMutex, since this may take hPROJMutex.
+    OCTFreeProj4Handles( asEvictedHandles );
+}
+
+/************************************************************************/
+/*                          OCTCacheRelease()                           */
+/*                                                                      */
+/*      Gives back the handles of a destroyed transformation.  Returns  */
+/*      false if they were not kept and must be freed by the caller.    */
+/************************************************************************/
+
+static bool OCTCacheRelease( const CPLString& osKey,
+                             const OCTProj4Handles& sHandles )
+
+{
+    CPLMutexHolderD( &hCTCacheMutex );
+
+    if( poCTCache == NULL )
+        return false;
+
+    std::map<CPLString, OCTCacheEntry>::iterator oIter =
+        poCTCache->find( osKey );
+    if( oIter == poCTCache->end() ||
+        oIter->second.asIdleHandles.size() >= OCT_CACHE_MAX_IDLE_HANDLES )
+        return false;
+
+    oIter->second.asIdleHandles.push_back( sHandles );
+    return true;
+}
+
+/************************************************************************/
+/*                   OCTCleanupTransformationCache()                    */
+/************************************************************************/
+
+void OCTCleanupTransformationCache()
+
+{
+    std::vector<OCTProj4Handles> asIdleHandles;
+
+    if( hCTCacheMutex != NULL )
+    {
+        CPLMutexHolderD( &hCTCacheMutex );
+
+        if( poCTCache != NULL )
+        {
+            std::map<CPLString, OCTCacheEntry>::iterator oIter;
+            for( oIter = poCTCache->begin(); oIter != poCTCache->end(); ++oIter )
+            {
+                asIdleHandles.insert( asIdleHandles.end(),
+                                      oIter->second.asIdleHandles.begin(),
+                                      oIter->second.asIdleHandles.end() );
+            }
+            delete poCTCache;
+            poCTCache = NULL;
+        }
+    }
+
+    OCTFreeProj4Handles( asIdleHandles );
+
+    if( hCTCacheMutex != NULL )
+    {
+        CPLDestroyMutex( hCTCacheMutex );
+        hCTCacheMutex = NULL;
+    }
+}
+
+/************************************************************************/
+/*                       OCTGetCacheStatistics()                        */
+/************************************************************************/
+
+/**
+ * \brief Fetch statistics of the coordinate transformation cache.
+ *
+ * OGRCreateCoordinateTransformation() caches the PROJ.4 definitions of
+ * the transformations it creates, keyed by the WKT of their source and
+ * target SRS, and keeps the initialized PROJ.4 state of the destroyed ones
+ * so that later transformations between the same SRS can reuse it.  The
+ * maximum number of cached SRS pairs is set with the OGR_CT_CACHE_SIZE
+ * configuration option (64 by default, 0 to disable the cache).
+ *
+ * @param pnEntries pointer to the number of cached SRS pairs, or NULL.
+ * @param pnHits pointer to the number of transformations created from the
+ * cache, or NULL.
+ * @param pnMisses pointer to the number of transformations created while
+ * the cache was enabled but not from it, or NULL.
+ *
+ * @since GDAL 2.2
+ */
+
+void OCTGetCacheStatistics( int *pnEntries, GIntBig *pnHits,
+                            GIntBig *pnMisses )
+
+{
+    CPLMutexHolderD( &hCTCacheMutex );
+
+    if( pnEntries != NULL )
+        *pnEntries = poCTCache != NULL ? static_cast<int>(poCTCache->size()) : 0;
+    if( pnHits != NULL )
+        *pnHits = nCTCacheHits;
+    if( pnMisses != NULL )
+        *pnMisses = nCTCacheMisses;
+}
+
 /************************************************************************/
 /*                 OCTDestroyCoordinateTransformation()                 */
 /************************************************************************/
@@ -414,6 +732,17 @@ void OGRCoordinateTransformation::DestroyCT(OGRCoordinateTransformation* poCT)
  *
  * The PROJ.4 library must be available at run-time.
  *
+ * Starting with GDAL 2.2, the PROJ.4 state of the transformations is
+ * cached, so that creating again a transformation between the same SRS is
+ * much cheaper.  See OCTGetCacheStatistics().
+ *
+ * Starting with GDAL 2.2, transformations between geographic, Mercator
+ * and Transverse Mercator (including UTM) coordinate systems that do not
+ * involve a datum shift are computed by a batched implementation of the
+ * PROJ.4 formulas, that gives the same results without going through
+ * pj_transform().  It can be disabled by setting the OGR_CT_FAST_PATH
+ * configuration option to NO.
+ *
  * @param poSource source spatial reference system.
  * @param poTarget target spatial reference system.
  * @return NULL on failure or a ready to use transformation object.
@@ -491,7 +820,8 @@ OGRProj4CT::OGRProj4CT() :
     poSRSTarget(NULL), psPJTarget(NULL), bTargetLatLong(FALSE),
     dfTargetFromRadians(0.0), bTargetWrap(FALSE), dfTargetWrapLong(0.0),
     bIdentityTransform(FALSE), bWebMercatorToWGS84(FALSE), nErrorCount(0),
-    bCheckWithInvertProj(FALSE), dfThreshold(0.0), pjctx(NULL), nMaxCount(0),
+    bCheckWithInvertProj(FALSE), dfThreshold(0.0), pjctx(NULL),
+    poFastPath(NULL), nMaxCount(0),
     padfOriX(NULL), padfOriY(NULL), padfOriZ(NULL), padfTargetX(NULL),
     padfTargetY(NULL), padfTargetZ(NULL)
 {
@@ -518,6 +848,22 @@ OGRProj4CT::~OGRProj4CT()
             delete poSRSTarget;
     }
 
+    delete poFastPath;
+
+    if( !osCacheKey.empty() && psPJSource != NULL && psPJTarget != NULL )
+    {
+        OCTProj4Handles sHandles;
+        sHandles.pjctx = pjctx;
+        sHandles.psPJSource = psPJSource;
+        sHandles.psPJTarget = psPJTarget;
+        if( OCTCacheRelease( osCacheKey, sHandles ) )
+        {
+            pjctx = NULL;
+            psPJSource = NULL;
+            psPJTarget = NULL;
+        }
+    }
+
     if (pjctx != NULL)
     {
         pfn_pj_ctx_free(pjctx);
@@ -528,7 +874,7 @@ OGRProj4CT::~OGRProj4CT()
         if( psPJTarget != NULL )
             pfn_pj_free( psPJTarget );
     }
-    else
+    else if( psPJSource != NULL || psPJTarget != NULL )
     {
         CPLMutexHolderD( &hPROJMutex );
 
@@ -665,6 +1011,189 @@ int OGRProj4CT::InitializeNoLock( OGRSpatialReference * poSourceIn,
     // means debug output could be one "increment" late.
     static int   nDebugReportCount = 0;
 
+    char        *pszSrcProj4Defn = NULL;
+    char        *pszDstProj4Defn = NULL;
+
+/* -------------------------------------------------------------------- */
+/*      Reuse the PROJ.4 definitions, and if possible the PROJ.4        */
+/*      handles, of a previous transformation between the same SRS.    */
+/* -------------------------------------------------------------------- */
+    const int nCacheSize = OCTGetCacheSize();
+    bool bFromCache = false;
+
+    if( nCacheSize > 0 )
+        osCacheKey = OCTCacheKey( poSRSSource, poSRSTarget );
+
+    if( !osCacheKey.empty() )
+    {
+        CPLString osSrcProj4Defn;
+        CPLString osDstProj4Defn;
+        bool bCachedWebMercatorToWGS84 = false;
+        OCTProj4Handles sHandles;
+        bool bGotHandles = false;
+
+        if( OCTCacheFetch( osCacheKey, osSrcProj4Defn, osDstProj4Defn,
+                           bCachedWebMercatorToWGS84, sHandles, bGotHandles ) )
+        {
+            bFromCache = true;
+            bWebMercatorToWGS84 = bCachedWebMercatorToWGS84;
+
+            if( bGotHandles )
+            {
+                bIdentityTransform = (osSrcProj4Defn == osDstProj4Defn);
+                if( pjctx != NULL )
+                    pfn_pj_ctx_free( pjctx );
+                pjctx = sHandles.pjctx;
+                psPJSource = sHandles.psPJSource;
+                psPJTarget = sHandles.psPJTarget;
+                CreateFastPath( osSrcProj4Defn, osDstProj4Defn );
+                return TRUE;
+            }
+
+            pszSrcProj4Defn = CPLStrdup( osSrcProj4Defn );
+            pszDstProj4Defn = CPLStrdup( osDstProj4Defn );
+        }
+    }
+
+    if( !bFromCache &&
+        !ExportToProj4Defns( &pszSrcProj4Defn, &pszDstProj4Defn ) )
+        return FALSE;
+
+/* -------------------------------------------------------------------- */
+/*      Establish PROJ.4 handle for source if projection.               */
+/* -------------------------------------------------------------------- */
+    if( !bWebMercatorToWGS84 )
+    {
+        if (pjctx)
+            psPJSource = pfn_pj_init_plus_ctx( pjctx, pszSrcProj4Defn );
+        else
+            psPJSource = pfn_pj_init_plus( pszSrcProj4Defn );
+
+        if( psPJSource == NULL )
+        {
+            if( pjctx != NULL)
+            {
+                int pj_errno = pfn_pj_ctx_get_errno(pjctx);
+
+                /* pfn_pj_strerrno not yet thread-safe in PROJ 4.8.0 */
+                CPLMutexHolderD(&hPROJMutex);
+                CPLError( CE_Failure, CPLE_NotSupported,
+                        "Failed to initialize PROJ.4 with `%s'.\n%s",
+                        pszSrcProj4Defn, pfn_pj_strerrno(pj_errno) );
+            }
+            else if( pfn_pj_get_errno_ref != NULL
+                && pfn_pj_strerrno != NULL )
+            {
+                int *p_pj_errno = pfn_pj_get_errno_ref();
+
+                CPLError( CE_Failure, CPLE_NotSupported,
+                        "Failed to initialize PROJ.4 with `%s'.\n%s",
+                        pszSrcProj4Defn, pfn_pj_strerrno(*p_pj_errno) );
+            }
+            else
+            {
+                CPLError( CE_Failure, CPLE_NotSupported,
+                        "Failed to initialize PROJ.4 with `%s'.\n",
+                        pszSrcProj4Defn );
+            }
+        }
+    }
+
+    if( nDebugReportCount < 10 )
+        CPLDebug( "OGRCT", "Source: %s", pszSrcProj4Defn );
+
+    if( !bWebMercatorToWGS84 && psPJSource == NULL )
+    {
+        CPLFree( pszSrcProj4Defn );
+        CPLFree( pszDstProj4Defn );
+        return FALSE;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Establish PROJ.4 handle for target if projection.               */
+/* -------------------------------------------------------------------- */
+    if( !bWebMercatorToWGS84 )
+    {
+        if (pjctx)
+            psPJTarget = pfn_pj_init_plus_ctx( pjctx, pszDstProj4Defn );
+        else
+            psPJTarget = pfn_pj_init_plus( pszDstProj4Defn );
+
+        if( psPJTarget == NULL )
+            CPLError( CE_Failure, CPLE_NotSupported,
+                    "Failed to initialize PROJ.4 with `%s'.",
+                    pszDstProj4Defn );
+    }
+    if( nDebugReportCount < 10 )
+    {
+        CPLDebug( "OGRCT", "Target: %s", pszDstProj4Defn );
+        nDebugReportCount++;
+    }
+
+    if( !bWebMercatorToWGS84 && psPJTarget == NULL )
+    {
+        CPLFree( pszSrcProj4Defn );
+        CPLFree( pszDstProj4Defn );
+        return FALSE;
+    }
+
+    /* Determine if we really have a transformation to do */
+    bIdentityTransform = (strcmp(pszSrcProj4Defn, pszDstProj4Defn) == 0);
+
+#if 0
+    /* In case of identity transform, under the following conditions, */
+    /* we can also avoid transforming from degrees <--> radians. */
+    if( bIdentityTransform && bSourceLatLong && !bSourceWrap &&
+        bTargetLatLong && !bTargetWrap &&
+        fabs(dfSourceToRadians * dfTargetFromRadians - 1.0) < 1e-10 )
+    {
+        /*bSourceLatLong = FALSE;
+        bTargetLatLong = FALSE;*/
+    }
+#endif
+
+    if( !bFromCache && !osCacheKey.empty() )
+        OCTCacheStore( osCacheKey, pszSrcProj4Defn, pszDstProj4Defn,
+                       CPL_TO_BOOL(bWebMercatorToWGS84), nCacheSize );
+
+    CreateFastPath( pszSrcProj4Defn, pszDstProj4Defn );
+
+    CPLFree( pszSrcProj4Defn );
+    CPLFree( pszDstProj4Defn );
+
+    return TRUE;
+}
+
+/************************************************************************/
+/*                          CreateFastPath()                            */
+/*                                                                      */
+/*      Setup the batched implementation of the transformation, for     */
+/*      the common projections that OGRProj4FastPath handles.  It can   */
+/*      be disabled with OGR_CT_FAST_PATH=NO.                           */
+/************************************************************************/
+
+void OGRProj4CT::CreateFastPath( const char *pszSrcProj4Defn,
+                                 const char *pszDstProj4Defn )
+
+{
+    if( bWebMercatorToWGS84 || bIdentityTransform ||
+        !CPLTestBool( CPLGetConfigOption( "OGR_CT_FAST_PATH", "YES" ) ) )
+        return;
+
+    poFastPath = OGRProj4FastPath::Create( pszSrcProj4Defn, pszDstProj4Defn );
+}
+
+/************************************************************************/
+/*                        ExportToProj4Defns()                          */
+/*                                                                      */
+/*      Export the source and target SRS to the PROJ.4 definitions      */
+/*      used to initialize the PROJ.4 handles.                          */
+/************************************************************************/
+
+int OGRProj4CT::ExportToProj4Defns( char **ppszSrcProj4Defn,
+                                    char **ppszDstProj4Defn )
+
+{
     char        *pszSrcProj4Defn = NULL;
 
     if( poSRSSource->exportToProj4( &pszSrcProj4Defn ) != OGRERR_NONE )
@@ -777,101 +1306,8 @@ int OGRProj4CT::InitializeNoLock( OGRSpatialReference * poSourceIn,
             strcmp(pszSrcProj4Defn, "+proj=merc +a=6378137 +b=6378137 +lat_ts=0.0 +lon_0=0.0 +x_0=0.0 +y_0=0 +k=1.0 +units=m +no_defs") == 0;
     }
 
-/* -------------------------------------------------------------------- */
-/*      Establish PROJ.4 handle for source if projection.               */
-/* -------------------------------------------------------------------- */
-    if( !bWebMercatorToWGS84 )
-    {
-        if (pjctx)
-            psPJSource = pfn_pj_init_plus_ctx( pjctx, pszSrcProj4Defn );
-        else
-            psPJSource = pfn_pj_init_plus( pszSrcProj4Defn );
-
-        if( psPJSource == NULL )
-        {
-            if( pjctx != NULL)
-            {
-                int pj_errno = pfn_pj_ctx_get_errno(pjctx);
-
-                /* pfn_pj_strerrno not yet thread-safe in PROJ 4.8.0 */
-                CPLMutexHolderD(&hPROJMutex);
-                CPLError( CE_Failure, CPLE_NotSupported,
-                        "Failed to initialize PROJ.4 with `%s'.\n%s",
-                        pszSrcProj4Defn, pfn_pj_strerrno(pj_errno) );
-            }
-            else if( pfn_pj_get_errno_ref != NULL
-                && pfn_pj_strerrno != NULL )
-            {
-                int *p_pj_errno = pfn_pj_get_errno_ref();
-
-                CPLError( CE_Failure, CPLE_NotSupported,
-                        "Failed to initialize PROJ.4 with `%s'.\n%s",
-                        pszSrcProj4Defn, pfn_pj_strerrno(*p_pj_errno) );
-            }
-            else
-            {
-                CPLError( CE_Failure, CPLE_NotSupported,
-                        "Failed to initialize PROJ.4 with `%s'.\n",
-                        pszSrcProj4Defn );
-            }
-        }
-    }
-
-    if( nDebugReportCount < 10 )
-        CPLDebug( "OGRCT", "Source: %s", pszSrcProj4Defn );
-
-    if( !bWebMercatorToWGS84 && psPJSource == NULL )
-    {
-        CPLFree( pszSrcProj4Defn );
-        CPLFree( pszDstProj4Defn );
-        return FALSE;
-    }
-
-/* -------------------------------------------------------------------- */
-/*      Establish PROJ.4 handle for target if projection.               */
-/* -------------------------------------------------------------------- */
-    if( !bWebMercatorToWGS84 )
-    {
-        if (pjctx)
-            psPJTarget = pfn_pj_init_plus_ctx( pjctx, pszDstProj4Defn );
-        else
-            psPJTarget = pfn_pj_init_plus( pszDstProj4Defn );
-
-        if( psPJTarget == NULL )
-            CPLError( CE_Failure, CPLE_NotSupported,
-                    "Failed to initialize PROJ.4 with `%s'.",
-                    pszDstProj4Defn );
-    }
-    if( nDebugReportCount < 10 )
-    {
-        CPLDebug( "OGRCT", "Target: %s", pszDstProj4Defn );
-        nDebugReportCount++;
-    }
-
-    if( !bWebMercatorToWGS84 && psPJTarget == NULL )
-    {
-        CPLFree( pszSrcProj4Defn );
-        CPLFree( pszDstProj4Defn );
-        return FALSE;
-    }
-
-    /* Determine if we really have a transformation to do */
-    bIdentityTransform = (strcmp(pszSrcProj4Defn, pszDstProj4Defn) == 0);
-
-#if 0
-    /* In case of identity transform, under the following conditions, */
-    /* we can also avoid transforming from degrees <--> radians. */
-    if( bIdentityTransform && bSourceLatLong && !bSourceWrap &&
-        bTargetLatLong && !bTargetWrap &&
-        fabs(dfSourceToRadians * dfTargetFromRadians - 1.0) < 1e-10 )
-    {
-        /*bSourceLatLong = FALSE;
-        bTargetLatLong = FALSE;*/
-    }
-#endif
-
-    CPLFree( pszSrcProj4Defn );
-    CPLFree( pszDstProj4Defn );
+    *ppszSrcProj4Defn = pszSrcProj4Defn;
+    *ppszDstProj4Defn = pszDstProj4Defn;
 
     return TRUE;
 }
@@ -1037,6 +1473,9 @@ int OGRProj4CT::TransformEx( int nCount, double *x, double *y, double *z,
     }
     else if( bIdentityTransform )
         bTransformDone = true;
+    else if( poFastPath != NULL && !bCheckWithInvertProj &&
+             poFastPath->Transform( nCount, x, y ) )
+        bTransformDone = true;
 
 /* -------------------------------------------------------------------- */
 /*      Do the transformation (or not...) using PROJ.4.                 */
@@ -0,0 +1,951 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Batched implementation of common PROJ.4 transformations.
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, GDAL contributors
+ *
+ * The projection formulas are those of PROJ.4 (PJ_merc.c, PJ_tmerc.c,
+ * proj_etmerc.c, pj_mlfn.c, pj_tsfn.c, pj_phi2.c and adjlon.c):
+ * Copyright (c) 1995, Gerald Evenden
+ * Copyright (c) 2008, Gerald I. Evenden, Knud Poder and Karsten Engsager
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "ogrct_fastpath.h"
+#include "cpl_conv.h"
+#include "cpl_string.h"
+
+#include <cmath>
+
+CPL_CVSID("$Id$");
+
+/* Same values as in PROJ.4 */
+#define FP_HALFPI       1.57079632679489661923
+#define FP_FORTPI       0.78539816339744830962
+#define FP_DEG_TO_RAD   .0174532925199432958
+
+enum
+{
+    FP_LONGLAT,
+    FP_MERC,
+    FP_TMERC,
+    FP_ETMERC
+};
+
+/************************************************************************/
+/*                        PROJ.4 support functions                      */
+/************************************************************************/
+
+static double FPAdjLon( double lon )
+{
+    if( fabs(lon) <= 3.14159265359 )
+        return lon;
+    lon += 3.14159265358979323846;
+    lon -= 6.2831853071795864769 * floor(lon / 6.2831853071795864769);
+    lon -= 3.14159265358979323846;
+    return lon;
+}
+
+static double FPMlfn( double phi, double sphi, double cphi, const double *en )
+{
+    cphi *= sphi;
+    sphi *= sphi;
+    return en[0] * phi - cphi * (en[1] + sphi*(en[2]
+        + sphi*(en[3] + sphi*en[4])));
+}
+
+static bool FPInvMlfn( double arg, double es, const double *en, double &phi )
+{
+    const double k = 1./(1.-es);
+
+    phi = arg;
+    for( int i = 10; i; --i )
+    {
+        const double s = sin(phi);
+        double t = 1. - es * s * s;
+        phi -= t = (FPMlfn(phi, s, cos(phi), en) - arg) * (t * sqrt(t)) * k;
+        if( fabs(t) < 1e-11 )
+            return true;
+    }
+    return false;
+}
+
+static double FPTsfn( double phi, double sinphi, double e )
+{
+    sinphi *= e;
+    return tan(.5 * (FP_HALFPI - phi)) /
+        pow((1. - sinphi) / (1. + sinphi), .5 * e);
+}
+
+static bool FPPhi2( double ts, double e, double &Phi )
+{
+    const double eccnth = .5 * e;
+    double dphi;
+    int i = 15;
+
+    Phi = FP_HALFPI - 2. * atan(ts);
+    do {
+        const double con = e * sin(Phi);
+        dphi = FP_HALFPI - 2. * atan(ts * pow((1. - con) /
+           (1. + con), eccnth)) - Phi;
+        Phi += dphi;
+    } while( fabs(dphi) > 1.0e-10 && --i );
+    return i > 0;
+}
+
+static double FPLog1py( double x )
+{
+    volatile double y = 1 + x;
+    volatile double z = y - 1;
+    return z == 0 ? x : x * log(y) / z;
+}
+
+static double FPAsinhy( double x )
+{
+    double y = fabs(x);
+    y = FPLog1py(y * (1 + y/(hypot(1.0, y) + 1)));
+    return x < 0 ? -y : y;
+}
+
+static double FPGatg( const double *p1, int len_p1, double B )
+{
+    const double *p;
+    double h = 0, h1, h2 = 0;
+    const double cos_2B = 2*cos(2*B);
+    for( p = p1 + len_p1, h1 = *--p; p - p1; h2 = h1, h1 = h )
+        h = -h2 + cos_2B*h1 + *--p;
+    return B + h*sin(2*B);
+}
+
+static double FPClenS( const double *a, int size, double arg_r, double arg_i,
+                       double *R, double *I )
+{
+    const double *p = a + size;
+    const double sin_arg_r = sin(arg_r);
+    const double cos_arg_r = cos(arg_r);
+    const double sinh_arg_i = sinh(arg_i);
+    const double cosh_arg_i = cosh(arg_i);
+    double r = 2*cos_arg_r*cosh_arg_i;
+    double i = -2*sin_arg_r*sinh_arg_i;
+    double hr, hr1, hr2, hi, hi1, hi2;
+    for( hi1 = hr1 = hi = 0, hr = *--p; a - p; )
+    {
+        hr2 = hr1;
+        hi2 = hi1;
+        hr1 = hr;
+        hi1 = hi;
+        hr  = -hr2 + r*hr1 - i*hi1 + *--p;
+        hi  = -hi2 + i*hr1 + r*hi1;
+    }
+    r = sin_arg_r*cosh_arg_i;
+    i = cos_arg_r*sinh_arg_i;
+    *R = r*hr - i*hi;
+    *I = r*hi + i*hr;
+    return *R;
+}
+
+static double FPClens( const double *a, int size, double arg_r )
+{
+    const double *p = a + size;
+    const double r = 2*cos(arg_r);
+    double hr, hr1, hr2;
+    for( hr1 = 0, hr = *--p; a - p; )
+    {
+        hr2 = hr1;
+        hr1 = hr;
+        hr  = -hr2 + r*hr1 + *--p;
+    }
+    return sin(arg_r)*hr;
+}
+
+/************************************************************************/
+/*                          Projection kernels                          */
+/*                                                                      */
+/*      Forward() and Inverse() work on normalized coordinates, as the  */
+/*      fwd and inv functions of PROJ.4, and return false where PROJ.4  */
+/*      sets an error.                                                  */
+/************************************************************************/
+
+struct FPMercSphere
+{
+    static inline bool Forward( const OGRProj4FastProj &P, double lam,
+                                double phi, double &x, double &y )
+    {
+        if( fabs(fabs(phi) - FP_HALFPI) <= 1.e-10 )
+            return false;
+        x = P.dfK0 * lam;
+        y = P.dfK0 * log(tan(FP_FORTPI + .5 * phi));
+        return true;
+    }
+
+    static inline bool Inverse( const OGRProj4FastProj &P, double x,
+                                double y, double &lam, double &phi )
+    {
+        phi = FP_HALFPI - 2. * atan(exp(-y / P.dfK0));
+        lam = x / P.dfK0;
+        return true;
+    }
+};
+
+struct FPMercEllipsoid
+{
+    static inline bool Forward( const OGRProj4FastProj &P, double lam,
+                                double phi, double &x, double &y )
+    {
+        if( fabs(fabs(phi) - FP_HALFPI) <= 1.e-10 )
+            return false;
+        x = P.dfK0 * lam;
+        y = - P.dfK0 * log(FPTsfn(phi, sin(phi), P.dfE));
+        return true;
+    }
+
+    static inline bool Inverse( const OGRProj4FastProj &P, double x,
+                                double y, double &lam, double &phi )
+    {
+        if( !FPPhi2(exp(- y / P.dfK0), P.dfE, phi) )
+            return false;
+        lam = x / P.dfK0;
+        return true;
+    }
+};
+
+#define FC1 1.
+#define FC2 .5
+#define FC3 .16666666666666666666
+#define FC4 .08333333333333333333
+#define FC5 .05
+#define FC6 .03333333333333333333
+#define FC7 .02380952380952380952
+#define FC8 .01785714285714285714
+
+struct FPTMerc
+{
+    static inline bool Forward( const OGRProj4FastProj &P, double lam,
+                                double phi, double &x, double &y )
+    {
+        if( lam < -FP_HALFPI || lam > FP_HALFPI )
+            return false;
+
+        const double sinphi = sin(phi);
+        const double cosphi = cos(phi);
+        double t = fabs(cosphi) > 1e-10 ? sinphi/cosphi : 0.;
+        t *= t;
+        double al = cosphi * lam;
+        const double als = al * al;
+        al /= sqrt(1. - P.dfES * sinphi * sinphi);
+        const double n = P.dfEsp * cosphi * cosphi;
+        x = P.dfK0 * al * (FC1 +
+            FC3 * als * (1. - t + n +
+            FC5 * als * (5. + t * (t - 18.) + n * (14. - 58. * t)
+            + FC7 * als * (61. + t * ( t * (179. - t) - 479. ) )
+            )));
+        y = P.dfK0 * (FPMlfn(phi, sinphi, cosphi, P.adfEn) - P.dfMl0 +
+            sinphi * al * lam * FC2 * ( 1. +
+            FC4 * als * (5. - t + n * (9. + 4. * n) +
+            FC6 * als * (61. + t * (t - 58.) + n * (270. - 330 * t)
+            + FC8 * als * (1385. + t * ( t * (543. - t) - 3111.) )
+            ))));
+        return true;
+    }
+
+    static inline bool Inverse( const OGRProj4FastProj &P, double x,
+                                double y, double &lam, double &phi )
+    {
+        const bool bConverged =
+            FPInvMlfn(P.dfMl0 + y / P.dfK0, P.dfES, P.adfEn, phi);
+        if( fabs(phi) >= FP_HALFPI )
+        {
+            phi = y < 0. ? -FP_HALFPI : FP_HALFPI;
+            lam = 0.;
+        }
+        else
+        {
+            const double sinphi = sin(phi);
+            const double cosphi = cos(phi);
+            double t = fabs(cosphi) > 1e-10 ? sinphi/cosphi : 0.;
+            const double n = P.dfEsp * cosphi * cosphi;
+            double con = 1. - P.dfES * sinphi * sinphi;
+            const double d = x * sqrt(con) / P.dfK0;
+            con *= t;
+            t *= t;
+            const double ds = d * d;
+            phi -= (con * ds / (1.-P.dfES)) * FC2 * (1. -
+                ds * FC4 * (5. + t * (3. - 9. *  n) + n * (1. - 4 * n) -
+                ds * FC6 * (61. + t * (90. - 252. * n +
+                    45. * t) + 46. * n
+               - ds * FC8 * (1385. + t * (3633. + t * (4095. + 1574. * t)) )
+                )));
+            lam = d*(FC1 -
+                ds*FC3*( 1. + 2.*t + n -
+                ds*FC5*(5. + t*(28. + 24.*t + 8.*n) + 6.*n
+               - ds * FC7 * (61. + t * (662. + t * (1320. + 720. * t)) )
+            ))) / cosphi;
+        }
+        return bConverged;
+    }
+};
+
+#define ETMERC_ORDER 6
+
+struct FPETMerc
+{
+    static inline bool Forward( const OGRProj4FastProj &P, double lam,
+                                double phi, double &x, double &y )
+    {
+        double dCn, dCe;
+        double Cn = FPGatg(P.adfCbg, ETMERC_ORDER, phi);
+        double Ce = lam;
+        const double sin_Cn = sin(Cn);
+        const double cos_Cn = cos(Cn);
+        const double sin_Ce = sin(Ce);
+        const double cos_Ce = cos(Ce);
+        Cn = atan2(sin_Cn, cos_Ce*cos_Cn);
+        Ce = atan2(sin_Ce*cos_Cn, hypot(sin_Cn, cos_Cn*cos_Ce));
+        Ce = FPAsinhy(tan(Ce));
+        Cn += FPClenS(P.adfGtu, ETMERC_ORDER, 2*Cn, 2*Ce, &dCn, &dCe);
+        Ce += dCe;
+        if( fabs(Ce) <= 2.623395162778 )
+        {
+            y = P.dfQn * Cn + P.dfZb;
+            x = P.dfQn * Ce;
+        }
+        else
+            x = y = HUGE_VAL;
+        return true;
+    }
+
+    static inline bool Inverse( const OGRProj4FastProj &P, double x,
+                                double y, double &lam, double &phi )
+    {
+        double dCn, dCe;
+        double Cn = (y - P.dfZb)/P.dfQn;
+        double Ce = x/P.dfQn;
+        if( fabs(Ce) <= 2.623395162778 )
+        {
+            Cn += FPClenS(P.adfUtg, ETMERC_ORDER, 2*Cn, 2*Ce, &dCn, &dCe);
+            Ce += dCe;
+            Ce = atan(sinh(Ce));
+            const double sin_Cn = sin(Cn);
+            const double cos_Cn = cos(Cn);
+            const double sin_Ce = sin(Ce);
+            const double cos_Ce = cos(Ce);
+            Ce = atan2(sin_Ce, cos_Ce*cos_Cn);
+            Cn = atan2(sin_Cn*cos_Ce, hypot(sin_Ce, cos_Ce*cos_Cn));
+            phi = FPGatg(P.adfCgb, ETMERC_ORDER, Cn);
+            lam = Ce;
+        }
+        else
+            phi = lam = HUGE_VAL;
+        return true;
+    }
+};
+
+/************************************************************************/
+/*                            ForwardLoop()                             */
+/*                                                                      */
+/*      Same as the forward projection loop of pj_transform(), with     */
+/*      the checks of pj_fwd().  Returns false if some points failed    */
+/*      with an error.                                                  */
+/************************************************************************/
+
+template<class Kernel>
+static bool ForwardLoop( const OGRProj4FastProj &P, int nCount,
+                         double *x, double *y )
+{
+    bool bOK = true;
+
+    for( int i = 0; i < nCount; i++ )
+    {
+        if( x[i] == HUGE_VAL )
+            continue;
+
+        double lam = x[i];
+        double phi = y[i];
+        const double t = fabs(phi) - FP_HALFPI;
+        double dfX, dfY;
+
+        if( t > 1.0e-12 || fabs(lam) > 10. )
+        {
+            x[i] = y[i] = HUGE_VAL;
+            bOK = false;
+            continue;
+        }
+        if( fabs(t) <= 1.0e-12 )
+            phi = phi < 0. ? -FP_HALFPI : FP_HALFPI;
+        lam = FPAdjLon(lam - P.dfLam0);
+
+        if( !Kernel::Forward(P, lam, phi, dfX, dfY) )
+        {
+            x[i] = y[i] = HUGE_VAL;
+            bOK = false;
+            continue;
+        }
+        x[i] = P.dfA * dfX + P.dfX0;
+        y[i] = P.dfA * dfY + P.dfY0;
+    }
+
+    return bOK;
+}
+
+/************************************************************************/
+/*                            InverseLoop()                             */
+/*                                                                      */
+/*      Same as the inverse projection loop of pj_transform(), with     */
+/*      the checks of pj_inv().                                         */
+/************************************************************************/
+
+template<class Kernel>
+static bool InverseLoop( const OGRProj4FastProj &P, int nCount,
+                         double *x, double *y )
+{
+    const double dfRA = 1. / P.dfA;
+    bool bOK = true;
+
+    for( int i = 0; i < nCount; i++ )
+    {
+        if( x[i] == HUGE_VAL )
+            continue;
+
+        double lam, phi;
+        if( y[i] == HUGE_VAL ||
+            !Kernel::Inverse(P, (x[i] - P.dfX0) * dfRA,
+                             (y[i] - P.dfY0) * dfRA, lam, phi) )
+        {
+            x[i] = y[i] = HUGE_VAL;
+            bOK = false;
+            continue;
+        }
+        if( lam == HUGE_VAL )
+        {
+            x[i] = y[i] = HUGE_VAL;
+            continue;
+        }
+        x[i] = FPAdjLon(lam + P.dfLam0);
+        y[i] = phi;
+    }
+
+    return bOK;
+}
+
+/************************************************************************/
+/*                         ForwardProjection()                          */
+/************************************************************************/
+
+static bool ForwardProjection( const OGRProj4FastProj &P, int nCount,
+                               double *x, double *y )
+{
+    switch( P.eType )
+    {
+        case FP_MERC:
+            if( P.dfES != 0.0 )
+                return ForwardLoop<FPMercEllipsoid>(P, nCount, x, y);
+            return ForwardLoop<FPMercSphere>(P, nCount, x, y);
+        case FP_TMERC:
+            return ForwardLoop<FPTMerc>(P, nCount, x, y);
+        case FP_ETMERC:
+            return ForwardLoop<FPETMerc>(P, nCount, x, y);
+        default:
+            return true;
+    }
+}
+
+/************************************************************************/
+/*                         InverseProjection()                          */
+/************************************************************************/
+
+static bool InverseProjection( const OGRProj4FastProj &P, int nCount,
+                               double *x, double *y )
+{
+    switch( P.eType )
+    {
+        case FP_MERC:
+            if( P.dfES != 0.0 )
+                return InverseLoop<FPMercEllipsoid>(P, nCount, x, y);
+            return InverseLoop<FPMercSphere>(P, nCount, x, y);
+        case FP_TMERC:
+            return InverseLoop<FPTMerc>(P, nCount, x, y);
+        case FP_ETMERC:
+            return InverseLoop<FPETMerc>(P, nCount, x, y);
+        default:
+            return true;
+    }
+}
+
+/************************************************************************/
+/*                             Transform()                              */
+/************************************************************************/
+
+/**
+ * Transform points.
+ *
+ * Points where PROJ.4 fails are set to HUGE_VAL, except when a single
+ * point is transformed: pj_transform() then reports an error, so the
+ * point is left untouched and false is returned, for the caller to
+ * fallback to pj_transform().
+ */
+
+bool OGRProj4FastPath::Transform( int nCount, double *x, double *y ) const
+
+{
+    if( nCount <= 0 )
+        return true;
+
+    const double dfX = x[0];
+    const double dfY = y[0];
+    bool bOK = true;
+
+    if( sSource.eType != FP_LONGLAT )
+        bOK = InverseProjection( sSource, nCount, x, y );
+    if( sTarget.eType != FP_LONGLAT )
+        bOK &= ForwardProjection( sTarget, nCount, x, y );
+
+    if( !bOK && nCount == 1 )
+    {
+        x[0] = dfX;
+        y[0] = dfY;
+        return false;
+    }
+
+    return true;
+}
+
+/************************************************************************/
+/*                          Ellipsoids and datums                       */
+/************************************************************************/
+
+typedef struct
+{
+    const char *pszName;
+    double      dfA;
+    double      dfRf;
+    double      dfB;
+} FPEllipsoid;
+
+static const FPEllipsoid asEllipsoids[] =
+{
+    { "WGS84",      6378137.0,      298.257223563,      0.0 },
+    { "GRS80",      6378137.0,      298.257222101,      0.0 },
+    { "WGS72",      6378135.0,      298.26,             0.0 },
+    { "GRS67",      6378160.0,      298.2471674270,     0.0 },
+    { "aust_SA",    6378160.0,      298.25,             0.0 },
+    { "bessel",     6377397.155,    299.1528128,        0.0 },
+    { "clrk66",     6378206.4,      0.0,                6356583.8 },
+    { "clrk80",     6378249.145,    293.4663,           0.0 },
+    { "clrk80ign",  6378249.2,      293.4660212936269,  0.0 },
+    { "helmert",    6378200.,       298.3,              0.0 },
+    { "intl",       6378388.0,      297.,               0.0 },
+    { "krass",      6378245.0,      298.3,              0.0 },
+    { "airy",       6377563.396,    0.0,                6356256.910 },
+    { "mod_airy",   6377340.189,    0.0,                6356034.446 }
+};
+
+/* Ellipsoid of the datums of pj_datums.c */
+static const char * const apszDatumEllipsoids[] =
+{
+    "WGS84", "WGS84",
+    "GGRS87", "GRS80",
+    "NAD83", "GRS80",
+    "NAD27", "clrk66",
+    "potsdam", "bessel",
+    "carthage", "clrk80ign",
+    "hermannskogel", "bessel",
+    "ire65", "mod_airy",
+    "nzgd49", "intl",
+    "OSGB36", "airy"
+};
+
+static bool FPSetEllipsoid( const char *pszName, double &dfA, double &dfES )
+{
+    for( size_t i = 0; i < CPL_ARRAYSIZE(asEllipsoids); i++ )
+    {
+        if( strcmp(asEllipsoids[i].pszName, pszName) != 0 )
+            continue;
+        dfA = asEllipsoids[i].dfA;
+        if( asEllipsoids[i].dfRf != 0.0 )
+        {
+            dfES = 1. / asEllipsoids[i].dfRf;
+            dfES = dfES * (2. - dfES);
+        }
+        else
+            dfES = 1. - (asEllipsoids[i].dfB * asEllipsoids[i].dfB) /
+                (dfA * dfA);
+        return true;
+    }
+    return false;
+}
+
+/************************************************************************/
+/*                             FPParseDouble()                          */
+/************************************************************************/
+
+static bool FPParseDouble( const char *pszValue, double &dfValue )
+{
+    char *pszEnd = NULL;
+    if( pszValue == NULL || *pszValue == '\0' )
+        return false;
+    dfValue = CPLStrtod( pszValue, &pszEnd );
+    return *pszEnd == '\0';
+}
+
+/************************************************************************/
+/*                          FPParseProj4Defn()                          */
+/*                                                                      */
+/*      Compute the parameters of a PROJ.4 definition, and the string   */
+/*      identifying its datum (empty if it has none).  Definitions      */
+/*      that use anything else than the parameters explicitly handled   */
+/*      here are rejected.                                              */
+/************************************************************************/
+
+static bool FPParseProj4Defn( const char *pszDefn, OGRProj4FastProj &P,
+                              CPLString &osDatum )
+
+{
+    char **papszTokens = CSLTokenizeString2( pszDefn, " ", 0 );
+    char **papszParms = NULL;
+    bool bOK = true;
+
+    for( int i = 0; papszTokens[i] != NULL && bOK; i++ )
+    {
+        const char *pszToken = papszTokens[i];
+        if( pszToken[0] != '+' )
+        {
+            bOK = false;
+            break;
+        }
+
+        char *pszKey = NULL;
+        const char *pszValue = CPLParseNameValue( pszToken + 1, &pszKey );
+        if( pszKey == NULL )
+        {
+            pszKey = CPLStrdup( pszToken + 1 );
+            pszValue = "";
+        }
+
+        static const char * const apszKnownKeys[] = {
+            "proj", "ellps", "datum", "towgs84", "nadgrids", "a", "b", "rf",
+            "f", "R", "lat_0", "lon_0", "lat_ts", "k", "k_0", "x_0", "y_0",
+            "zone", "south", "units", "no_defs", "wktext" };
+        bool bKnown = false;
+        for( size_t j = 0; j < CPL_ARRAYSIZE(apszKnownKeys); j++ )
+            bKnown |= strcmp(pszKey, apszKnownKeys[j]) == 0;
+
+        // PROJ.4 uses the first occurrence of a parameter.
+        if( !bKnown || CSLFetchNameValue( papszParms, pszKey ) != NULL )
+            bOK = false;
+        else
+            papszParms = CSLSetNameValue( papszParms, pszKey, pszValue );
+        CPLFree( pszKey );
+    }
+    CSLDestroy( papszTokens );
+
+    const char *pszProj = CSLFetchNameValue( papszParms, "proj" );
+    const char *pszEllps = CSLFetchNameValue( papszParms, "ellps" );
+    const char *pszDatum = CSLFetchNameValue( papszParms, "datum" );
+    const char *pszTOWGS84 = CSLFetchNameValue( papszParms, "towgs84" );
+    const char *pszNadgrids = CSLFetchNameValue( papszParms, "nadgrids" );
+    const char *pszUnits = CSLFetchNameValue( papszParms, "units" );
+    const bool bHasExplicitAxes =
+        CSLFetchNameValue( papszParms, "a" ) != NULL ||
+        CSLFetchNameValue( papszParms, "b" ) != NULL ||
+        CSLFetchNameValue( papszParms, "rf" ) != NULL ||
+        CSLFetchNameValue( papszParms, "f" ) != NULL;
+    double dfValue = 0.0;
+
+    // Without +no_defs, proj_def.dat could add parameters.
+    if( !bOK || pszProj == NULL ||
+        CSLFetchNameValue( papszParms, "no_defs" ) == NULL ||
+        (pszUnits != NULL && strcmp(pszUnits, "m") != 0) )
+    {
+        CSLDestroy( papszParms );
+        return false;
+    }
+
+    memset( &P, 0, sizeof(P) );
+
+/* -------------------------------------------------------------------- */
+/*      Ellipsoid, as in pj_ell_set().                                  */
+/* -------------------------------------------------------------------- */
+    if( CSLFetchNameValue( papszParms, "R" ) != NULL )
+    {
+        bOK = pszEllps == NULL && pszDatum == NULL && !bHasExplicitAxes &&
+              FPParseDouble( CSLFetchNameValue( papszParms, "R" ), P.dfA );
+    }
+    else if( pszEllps != NULL || pszDatum != NULL )
+    {
+        bOK = !bHasExplicitAxes && (pszEllps == NULL || pszDatum == NULL);
+        if( bOK && pszDatum != NULL )
+        {
+            pszEllps = NULL;
+            for( size_t i = 0; i < CPL_ARRAYSIZE(apszDatumEllipsoids); i += 2 )
+            {
+                if( strcmp(apszDatumEllipsoids[i], pszDatum) == 0 )
+                    pszEllps = apszDatumEllipsoids[i+1];
+            }
+        }
+        bOK = bOK && pszEllps != NULL &&
+              FPSetEllipsoid( pszEllps, P.dfA, P.dfES );
+    }
+    else
+    {
+        const char *pszB = CSLFetchNameValue( papszParms, "b" );
+        const char *pszRf = CSLFetchNameValue( papszParms, "rf" );
+        const char *pszF = CSLFetchNameValue( papszParms, "f" );
+
+        bOK = FPParseDouble( CSLFetchNameValue( papszParms, "a" ), P.dfA ) &&
+              (pszB != NULL) + (pszRf != NULL) + (pszF != NULL) <= 1;
+        if( bOK && pszRf != NULL )
+        {
+            bOK = FPParseDouble( pszRf, dfValue ) && dfValue != 0.0;
+            P.dfES = 1. / dfValue;
+            P.dfES = P.dfES * (2. - P.dfES);
+        }
+        else if( bOK && pszF != NULL )
+        {
+            bOK = FPParseDouble( pszF, dfValue );
+            P.dfES = dfValue * (2. - dfValue);
+        }
+        else if( bOK && pszB != NULL )
+        {
+            bOK = FPParseDouble( pszB, dfValue );
+            P.dfES = 1. - (dfValue * dfValue) / (P.dfA * P.dfA);
+        }
+    }
+    bOK = bOK && P.dfES >= 0. && P.dfA > 0.;
+    P.dfE = sqrt( P.dfES );
+
+/* -------------------------------------------------------------------- */
+/*      Datum, as in pj_datum_set().                                    */
+/* -------------------------------------------------------------------- */
+    osDatum = "";
+    if( pszDatum != NULL )
+    {
+        bOK = bOK && pszTOWGS84 == NULL && pszNadgrids == NULL;
+        osDatum.Printf( "datum=%s", pszDatum );
+    }
+    else if( pszNadgrids != NULL )
+    {
+        bOK = bOK && pszTOWGS84 == NULL;
+        osDatum.Printf( "nadgrids=%s", pszNadgrids );
+    }
+    else if( pszTOWGS84 != NULL )
+        osDatum.Printf( "towgs84=%s", pszTOWGS84 );
+
+/* -------------------------------------------------------------------- */
+/*      Common projection parameters, as in pj_init().                  */
+/* -------------------------------------------------------------------- */
+    const char *pszLat0 = CSLFetchNameValue( papszParms, "lat_0" );
+    const char *pszLon0 = CSLFetchNameValue( papszParms, "lon_0" );
+    const char *pszLatTS = CSLFetchNameValue( papszParms, "lat_ts" );
+    const char *pszK = CSLFetchNameValue( papszParms, "k" );
+    const char *pszK0 = CSLFetchNameValue( papszParms, "k_0" );
+    const char *pszX0 = CSLFetchNameValue( papszParms, "x_0" );
+    const char *pszY0 = CSLFetchNameValue( papszParms, "y_0" );
+    const char *pszZone = CSLFetchNameValue( papszParms, "zone" );
+    const bool bSouth = CSLFetchNameValue( papszParms, "south" ) != NULL;
+
+    P.dfK0 = 1.0;
+    if( pszLat0 != NULL )
+    {
+        bOK = bOK && FPParseDouble( pszLat0, P.dfPhi0 );
+        P.dfPhi0 *= FP_DEG_TO_RAD;
+    }
+    if( pszLon0 != NULL )
+    {
+        bOK = bOK && FPParseDouble( pszLon0, P.dfLam0 );
+        P.dfLam0 *= FP_DEG_TO_RAD;
+    }
+    if( pszK != NULL || pszK0 != NULL )
+        bOK = bOK && (pszK == NULL || pszK0 == NULL) &&
+              FPParseDouble( pszK ? pszK : pszK0, P.dfK0 ) && P.dfK0 > 0.;
+    if( pszX0 != NULL )
+        bOK = bOK && FPParseDouble( pszX0, P.dfX0 );
+    if( pszY0 != NULL )
+        bOK = bOK && FPParseDouble( pszY0, P.dfY0 );
+
+/* -------------------------------------------------------------------- */
+/*      Projection specific setup.                                      */
+/* -------------------------------------------------------------------- */
+    const bool bProjected = pszLat0 || pszLon0 || pszLatTS || pszK ||
+                            pszK0 || pszX0 || pszY0 || pszZone || bSouth ||
+                            pszUnits;
+
+    if( EQUAL(pszProj, "longlat") || EQUAL(pszProj, "latlong") )
+    {
+        P.eType = FP_LONGLAT;
+        bOK = bOK && !bProjected;
+    }
+    else if( EQUAL(pszProj, "merc") )
+    {
+        P.eType = FP_MERC;
+        bOK = bOK && pszZone == NULL && !bSouth;
+        if( bOK && pszLatTS != NULL )
+        {
+            bOK = FPParseDouble( pszLatTS, dfValue );
+            const double phits = fabs( dfValue * FP_DEG_TO_RAD );
+            bOK = bOK && phits < FP_HALFPI;
+            if( P.dfES != 0.0 )
+                P.dfK0 = cos(phits) / sqrt(1. - P.dfES * sin(phits) * sin(phits));
+            else
+                P.dfK0 = cos(phits);
+        }
+    }
+    else if( EQUAL(pszProj, "tmerc") )
+    {
+        P.eType = FP_TMERC;
+        // The spherical formulas of tmerc are not implemented.
+        bOK = bOK && pszZone == NULL && !bSouth && pszLatTS == NULL &&
+              P.dfES != 0.0;
+        const double es = P.dfES;
+        double t;
+        P.adfEn[0] = 1. - es * (.25 + es * (.046875 + es * (.01953125 + es * .01068115234375)));
+        P.adfEn[1] = es * (.75 - es * (.046875 + es * (.01953125 + es * .01068115234375)));
+        P.adfEn[2] = (t = es * es) * (.46875 - es * (.01302083333333333333 + es * .00712076822916666666));
+        P.adfEn[3] = (t *= es) * (.36458333333333333333 - es * .00569661458333333333);
+        P.adfEn[4] = t * es * .3076171875;
+        P.dfMl0 = FPMlfn( P.dfPhi0, sin(P.dfPhi0), cos(P.dfPhi0), P.adfEn );
+        P.dfEsp = es / (1. - es);
+    }
+    else if( EQUAL(pszProj, "etmerc") || EQUAL(pszProj, "utm") )
+    {
+        P.eType = FP_ETMERC;
+        bOK = bOK && pszLatTS == NULL && P.dfES > 0.0;
+        if( EQUAL(pszProj, "utm") )
+        {
+            // utm sets its own parameters, and may derive the zone from
+            // lon_0, which we do not bother doing.
+            const int nZone = pszZone ? atoi(pszZone) : 0;
+            bOK = bOK && !pszLat0 && !pszLon0 && !pszK && !pszK0 &&
+                  !pszX0 && !pszY0 && nZone > 0 && nZone <= 60 &&
+                  FPParseDouble( pszZone, dfValue );
+            P.dfY0 = bSouth ? 10000000. : 0.;
+            P.dfX0 = 500000.;
+            P.dfLam0 = (nZone - 1 + .5) * M_PI / 30. - M_PI;
+            P.dfK0 = 0.9996;
+            P.dfPhi0 = 0.;
+        }
+        else
+            bOK = bOK && pszZone == NULL && !bSouth;
+
+        /* Same as setup() of proj_etmerc.c */
+        const double f = P.dfES / (1 + sqrt(1 - P.dfES));
+        double np, n;
+        np = n = f/(2 - f);
+        P.adfCgb[0] = n*( 2 + n*(-2/3.0  + n*(-2      + n*(116/45.0 + n*(26/45.0 +
+                    n*(-2854/675.0 ))))));
+        P.adfCbg[0] = n*(-2 + n*( 2/3.0  + n*( 4/3.0  + n*(-82/45.0 + n*(32/45.0 +
+                    n*( 4642/4725.0))))));
+        np     *= n;
+        P.adfCgb[1] = np*(7/3.0 + n*( -8/5.0  + n*(-227/45.0 + n*(2704/315.0 +
+                    n*( 2323/945.0)))));
+        P.adfCbg[1] = np*(5/3.0 + n*(-16/15.0 + n*( -13/9.0  + n*( 904/315.0 +
+                    n*(-1522/945.0)))));
+        np     *= n;
+        P.adfCgb[2] = np*( 56/15.0  + n*(-136/35.0 + n*(-1262/105.0 +
+                    n*( 73814/2835.0))));
+        P.adfCbg[2] = np*(-26/15.0  + n*(  34/21.0 + n*(    8/5.0   +
+                    n*(-12686/2835.0))));
+        np     *= n;
+        P.adfCgb[3] = np*(4279/630.0 + n*(-332/35.0 + n*(-399572/14175.0)));
+        P.adfCbg[3] = np*(1237/630.0 + n*( -12/5.0  + n*( -24832/14175.0)));
+        np     *= n;
+        P.adfCgb[4] = np*(4174/315.0 + n*(-144838/6237.0 ));
+        P.adfCbg[4] = np*(-734/315.0 + n*( 109598/31185.0));
+        np     *= n;
+        P.adfCgb[5] = np*(601676/22275.0 );
+        P.adfCbg[5] = np*(444337/155925.0);
+
+        np = n*n;
+        P.dfQn = P.dfK0/(1 + n) * (1 + np*(1/4.0 + np*(1/64.0 + np/256.0)));
+        P.adfUtg[0] = n*(-0.5  + n*( 2/3.0 + n*(-37/96.0 + n*( 1/360.0 +
+                    n*(  81/512.0 + n*(-96199/604800.0))))));
+        P.adfGtu[0] = n*( 0.5  + n*(-2/3.0 + n*(  5/16.0 + n*(41/180.0 +
+                    n*(-127/288.0 + n*(  7891/37800.0 ))))));
+        P.adfUtg[1] = np*(-1/48.0 + n*(-1/15.0 + n*(437/1440.0 + n*(-46/105.0 +
+                    n*( 1118711/3870720.0)))));
+        P.adfGtu[1] = np*(13/48.0 + n*(-3/5.0  + n*(557/1440.0 + n*(281/630.0 +
+                    n*(-1983433/1935360.0)))));
+        np      *= n;
+        P.adfUtg[2] = np*(-17/480.0 + n*(  37/840.0 + n*(  209/4480.0  +
+                    n*( -5569/90720.0 ))));
+        P.adfGtu[2] = np*( 61/240.0 + n*(-103/140.0 + n*(15061/26880.0 +
+                    n*(167603/181440.0))));
+        np      *= n;
+        P.adfUtg[3] = np*(-4397/161280.0 + n*(  11/504.0 + n*( 830251/7257600.0)));
+        P.adfGtu[3] = np*(49561/161280.0 + n*(-179/168.0 + n*(6601661/7257600.0)));
+        np     *= n;
+        P.adfUtg[4] = np*(-4583/161280.0 + n*(  108847/3991680.0));
+        P.adfGtu[4] = np*(34729/80640.0  + n*(-3418889/1995840.0));
+        np     *= n;
+        P.adfUtg[5] = np*(-20648693/638668800.0);
+        P.adfGtu[5] = np*(212378941/319334400.0);
+
+        const double Z = FPGatg( P.adfCbg, ETMERC_ORDER, P.dfPhi0 );
+        P.dfZb = - P.dfQn*(Z + FPClens(P.adfGtu, ETMERC_ORDER, 2*Z));
+    }
+    else
+        bOK = false;
+
+    CSLDestroy( papszParms );
+    return bOK;
+}
+
+/************************************************************************/
+/*                               Create()                               */
+/************************************************************************/
+
+/**
+ * Create a fast path for the transformation between two PROJ.4
+ * definitions, or return NULL if it is not handled.
+ */
+
+OGRProj4FastPath *OGRProj4FastPath::Create( const char *pszSrcProj4Defn,
+                                            const char *pszDstProj4Defn )
+
+{
+    OGRProj4FastPath *poFastPath = new OGRProj4FastPath();
+    CPLString osSrcDatum;
+    CPLString osDstDatum;
+
+    if( !FPParseProj4Defn( pszSrcProj4Defn, poFastPath->sSource, osSrcDatum ) ||
+        !FPParseProj4Defn( pszDstProj4Defn, poFastPath->sTarget, osDstDatum ) )
+    {
+        delete poFastPath;
+        return NULL;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      pj_datum_transform() does nothing if either side has no datum,  */
+/*      or if they are the same.                                        */
+/* -------------------------------------------------------------------- */
+    const OGRProj4FastProj &sSrc = poFastPath->sSource;
+    const OGRProj4FastProj &sDst = poFastPath->sTarget;
+    if( !osSrcDatum.empty() && !osDstDatum.empty() &&
+        (osSrcDatum != osDstDatum || sSrc.dfA != sDst.dfA ||
+         sSrc.dfES != sDst.dfES) )
+    {
+        delete poFastPath;
+        return NULL;
+    }
+
+    return poFastPath;
+}
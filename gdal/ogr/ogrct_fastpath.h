@@ -0,0 +1,87 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Batched implementation of common PROJ.4 transformations.
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#ifndef OGRCT_FASTPATH_H_INCLUDED
+#define OGRCT_FASTPATH_H_INCLUDED
+
+#include "cpl_port.h"
+
+/* Projection parameters, as computed by pj_init() and the PROJ.4 setup */
+/* function of the projection. */
+typedef struct
+{
+    int         eType;
+    double      dfA;
+    double      dfES;
+    double      dfE;
+    double      dfLam0;
+    double      dfPhi0;
+    double      dfK0;
+    double      dfX0;
+    double      dfY0;
+
+    /* tmerc */
+    double      adfEn[5];
+    double      dfMl0;
+    double      dfEsp;
+
+    /* etmerc and utm */
+    double      dfQn;
+    double      dfZb;
+    double      adfCgb[6];
+    double      adfCbg[6];
+    double      adfUtg[6];
+    double      adfGtu[6];
+} OGRProj4FastProj;
+
+/************************************************************************/
+/*                           OGRProj4FastPath                           */
+/*                                                                      */
+/*      Transforms arrays of points between geographic, Mercator and    */
+/*      transverse Mercator (tmerc, etmerc, utm) coordinate systems     */
+/*      that do not involve a datum shift, with the same formulas as    */
+/*      PROJ.4 but without its per point dispatching.  It takes the     */
+/*      place of pj_transform(), and so uses the same units: radians    */
+/*      for geographic coordinates, meters otherwise.                   */
+/************************************************************************/
+
+class CPL_DLL OGRProj4FastPath
+{
+    OGRProj4FastProj sSource;
+    OGRProj4FastProj sTarget;
+
+                OGRProj4FastPath() {}
+
+public:
+    static OGRProj4FastPath *Create( const char *pszSrcProj4Defn,
+                                     const char *pszDstProj4Defn );
+
+    bool        Transform( int nCount, double *x, double *y ) const;
+};
+
+#endif /* ndef OGRCT_FASTPATH_H_INCLUDED */
@@ -55,6 +55,9 @@ OGRFeatureQuery::OGRFeatureQuery()
 {
     poTargetDefn = NULL;
     pSWQExpr = NULL;
+    pSWQProgram = NULL;
+    bSWQExprChecked = FALSE;
+    bSWQProgramTried = FALSE;
 }
 
 /************************************************************************/
@@ -64,9 +67,36 @@ OGRFeatureQuery::OGRFeatureQuery()
 OGRFeatureQuery::~OGRFeatureQuery()
 
 {
+    ResetProgram();
     delete (swq_expr_node *) pSWQExpr;
 }
 
+/************************************************************************/
+/*                            ResetProgram()                            */
+/*                                                                      */
+/*      Drop the program compiled from the expression, so that it is    */
+/*      compiled again on the next Evaluate(). To be called after       */
+/*      modifying the tree returned by GetSWQExpr().                    */
+/************************************************************************/
+
+void OGRFeatureQuery::ResetProgram()
+
+{
+    delete (swq_expr_program *) pSWQProgram;
+    pSWQProgram = NULL;
+    bSWQProgramTried = FALSE;
+}
+
+/************************************************************************/
+/*                             GetSWQExpr()                             */
+/************************************************************************/
+
+void *OGRFeatureQuery::GetSWQExpr() const
+
+{
+    return pSWQExpr;
+}
+
 /************************************************************************/
 /*                                Parse                                 */
 /************************************************************************/
@@ -80,6 +110,8 @@ OGRErr OGRFeatureQuery::Compile( OGRFeatureDefn *poDefn,
 /* -------------------------------------------------------------------- */
 /*      Clear any existing expression.                                  */
 /* -------------------------------------------------------------------- */
+    ResetProgram();
+    bSWQExprChecked = FALSE;
     if( pSWQExpr != NULL )
     {
         delete (swq_expr_node *) pSWQExpr;
@@ -182,6 +214,8 @@ OGRErr OGRFeatureQuery::Compile( OGRFeatureDefn *poDefn,
         eErr = OGRERR_CORRUPT_DATA;
         pSWQExpr = NULL;
     }
+    else
+        bSWQExprChecked = bCheck;
 
     CPLFree( papszFieldNames );
     CPLFree( paeFieldTypes );
@@ -236,6 +270,43 @@ static swq_expr_node *OGRFeatureFetcher( swq_expr_node *op, void *pFeatureIn )
     return poRetNode;
 }
 
+/************************************************************************/
+/*                       OGRFeatureValueFetcher()                       */
+/*                                                                      */
+/*      Same as OGRFeatureFetcher(), for compiled programs.             */
+/************************************************************************/
+
+static int OGRFeatureValueFetcher( swq_expr_node *op, void *pFeatureIn,
+                                   swq_value *psValue )
+
+{
+    OGRFeature *poFeature = (OGRFeature *) pFeatureIn;
+
+    switch( op->field_type )
+    {
+      case SWQ_INTEGER:
+      case SWQ_BOOLEAN:
+        psValue->int_value = poFeature->GetFieldAsInteger(op->field_index);
+        break;
+
+      case SWQ_INTEGER64:
+        psValue->int_value = poFeature->GetFieldAsInteger64(op->field_index);
+        break;
+
+      case SWQ_FLOAT:
+        psValue->float_value = poFeature->GetFieldAsDouble(op->field_index);
+        break;
+
+      default:
+        psValue->string_value = poFeature->GetFieldAsString(op->field_index);
+        break;
+    }
+
+    psValue->is_null = !(poFeature->IsFieldSet(op->field_index));
+
+    return TRUE;
+}
+
 /************************************************************************/
 /*                              Evaluate()                              */
 /************************************************************************/
@@ -246,6 +317,32 @@ int OGRFeatureQuery::Evaluate( OGRFeature *poFeature )
     if( pSWQExpr == NULL )
         return FALSE;
 
+/* -------------------------------------------------------------------- */
+/*      Use the flat program when the expression can be compiled.       */
+/* -------------------------------------------------------------------- */
+    if( pSWQProgram == NULL && bSWQExprChecked && !bSWQProgramTried )
+    {
+        pSWQProgram =
+            swq_expr_program::Compile( (swq_expr_node *) pSWQExpr );
+        bSWQProgramTried = TRUE;
+    }
+
+    if( pSWQProgram != NULL )
+    {
+        const swq_value *psResult = ((swq_expr_program *) pSWQProgram)->
+            Evaluate( OGRFeatureValueFetcher, (void *) poFeature );
+
+        if( psResult == NULL )
+            return FALSE;
+
+        if( psResult->field_type == SWQ_INTEGER ||
+            psResult->field_type == SWQ_INTEGER64 ||
+            psResult->field_type == SWQ_BOOLEAN )
+            return (int)psResult->int_value;
+
+        return FALSE;
+    }
+
     swq_expr_node *poResult;
 
     poResult = ((swq_expr_node *) pSWQExpr)->Evaluate( OGRFeatureFetcher,
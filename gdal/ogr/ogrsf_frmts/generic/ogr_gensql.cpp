@@ -92,7 +92,8 @@ OGRGenSQLResultsLayer::OGRGenSQLResultsLayer( GDALDataset *poSrcDSIn,
     poSrcLayer(NULL), pszWHERE(NULL), papoTableLayers(NULL), poDefn(NULL),
     panGeomFieldToSrcGeomField(NULL), nIndexSize(0),
     panFIDIndex(NULL), bOrderByValid(FALSE), nNextIndexFID(0),
-    poSummaryFeature(NULL), iFIDFieldIndex(), nExtraDSCount(0), papoExtraDS(NULL)
+    poSummaryFeature(NULL), iFIDFieldIndex(), nExtraDSCount(0), papoExtraDS(NULL),
+    papoColumnPrograms(NULL)
 {
     swq_select *psSelectInfo = (swq_select *) pSelectInfoIn;
 
@@ -506,6 +507,15 @@ OGRGenSQLResultsLayer::~OGRGenSQLResultsLayer()
     CPLFree( panGeomFieldToSrcGeomField );
 
     delete poSummaryFeature;
+
+    if( papoColumnPrograms != NULL )
+    {
+        for( int iField = 0;
+             iField < ((swq_select *) pSelectInfo)->result_columns; iField++ )
+            delete papoColumnPrograms[iField];
+        CPLFree( papoColumnPrograms );
+    }
+
     delete (swq_select *) pSelectInfo;
 
     if( poDefn != NULL )
@@ -1146,6 +1156,62 @@ static swq_expr_node *OGRMultiFeatureFetcher( swq_expr_node *op,
     return poRetNode;
 }
 
+/************************************************************************/
+/*                    OGRMultiFeatureValueFetcher()                     */
+/*                                                                      */
+/*      Same as OGRMultiFeatureFetcher(), for compiled programs.        */
+/************************************************************************/
+
+static int OGRMultiFeatureValueFetcher( swq_expr_node *op, void *pFeatureList,
+                                        swq_value *psValue )
+
+{
+    std::vector<OGRFeature*> *papoFeatures =
+        (std::vector<OGRFeature*> *) pFeatureList;
+
+    if( op->table_index < 0 || op->table_index >= (int)papoFeatures->size() )
+    {
+        CPLError( CE_Failure, CPLE_AppDefined,
+                  "Request for unexpected table_index (%d) in field fetcher.",
+                  op->table_index );
+        return FALSE;
+    }
+
+    OGRFeature *poFeature = (*papoFeatures)[op->table_index];
+
+    psValue->is_null = poFeature == NULL ||
+                       !poFeature->IsFieldSet(op->field_index);
+    if( psValue->is_null )
+    {
+        psValue->int_value = 0;
+        psValue->float_value = 0.0;
+        psValue->string_value = "";
+        return TRUE;
+    }
+
+    switch( op->field_type )
+    {
+      case SWQ_INTEGER:
+      case SWQ_BOOLEAN:
+        psValue->int_value = poFeature->GetFieldAsInteger(op->field_index);
+        break;
+
+      case SWQ_INTEGER64:
+        psValue->int_value = poFeature->GetFieldAsInteger64(op->field_index);
+        break;
+
+      case SWQ_FLOAT:
+        psValue->float_value = poFeature->GetFieldAsDouble(op->field_index);
+        break;
+
+      default:
+        psValue->string_value = poFeature->GetFieldAsString(op->field_index);
+        break;
+    }
+
+    return TRUE;
+}
+
 /************************************************************************/
 /*                          GetFilterForJoin()                          */
 /************************************************************************/
@@ -1325,6 +1391,20 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
 /* -------------------------------------------------------------------- */
 /*      Evaluate fields that are complex expressions.                   */
 /* -------------------------------------------------------------------- */
+    if( papoColumnPrograms == NULL )
+    {
+        papoColumnPrograms = (swq_expr_program **)
+            CPLCalloc( sizeof(swq_expr_program *),
+                       MAX(1, psSelectInfo->result_columns) );
+        for( int iField = 0; iField < psSelectInfo->result_columns; iField++ )
+        {
+            swq_col_def *psColDef = psSelectInfo->column_defs + iField;
+            if( psColDef->field_index == -1 )
+                papoColumnPrograms[iField] =
+                    swq_expr_program::Compile( psColDef->expr );
+        }
+    }
+
     int iRegularField = 0;
     int iGeomField = 0;
     for( int iField = 0; iField < psSelectInfo->result_columns; iField++ )
@@ -1342,6 +1422,32 @@ OGRFeature *OGRGenSQLResultsLayer::TranslateFeature( OGRFeature *poSrcFeat )
             continue;
         }
 
+        if( papoColumnPrograms[iField] != NULL )
+        {
+            const swq_value *psValue = papoColumnPrograms[iField]->
+                Evaluate( OGRMultiFeatureValueFetcher, (void *) &apoFeatures );
+
+            if( psValue == NULL )
+            {
+                delete poDstFeat;
+                return NULL;
+            }
+
+            if( psValue->is_null )
+                iRegularField++;
+            else if( psValue->field_type == SWQ_INTEGER ||
+                     psValue->field_type == SWQ_BOOLEAN )
+                poDstFeat->SetField( iRegularField++,
+                                     (int)psValue->int_value );
+            else if( psValue->field_type == SWQ_INTEGER64 )
+                poDstFeat->SetField( iRegularField++, psValue->int_value );
+            else if( psValue->field_type == SWQ_FLOAT )
+                poDstFeat->SetField( iRegularField++, psValue->float_value );
+            else
+                poDstFeat->SetField( iRegularField++, psValue->string_value );
+            continue;
+        }
+
         poResult = psColDef->expr->Evaluate( OGRMultiFeatureFetcher,
                                              (void *) &apoFeatures );
 
@@ -76,6 +76,8 @@ class CPL_DLL OGRGenSQLResultsLayer : public OGRLayer
     int         nExtraDSCount;
     GDALDataset **papoExtraDS;
 
+    swq_expr_program **papoColumnPrograms;
+
     int         PrepareSummary();
 
     OGRFeature *TranslateFeature( OGRFeature * );
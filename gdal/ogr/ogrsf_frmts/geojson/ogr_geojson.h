@@ -41,6 +41,7 @@
 #define SPACE_FOR_BBOX  130
 
 class OGRGeoJSONDataSource;
+class OGRGeoJSONReader;
 
 /************************************************************************/
 /*                           OGRGeoJSONLayer                            */
@@ -67,16 +68,26 @@ public:
     virtual int         TestCapability( const char * pszCap );
 
     virtual OGRErr      SyncToDisk();
+
+    virtual void        ResetReading();
+    virtual OGRFeature* GetNextFeature();
+    virtual OGRErr      SetNextByIndex( GIntBig nIndex );
+    virtual OGRFeature* GetFeature( GIntBig nFID );
+    virtual GIntBig     GetFeatureCount( int bForce );
     //
     // OGRGeoJSONLayer Interface
     //
     void SetFIDColumn( const char* pszFIDColumn );
     void AddFeature( OGRFeature* poFeature );
     void DetectGeometryType();
+    void SetStreamingReader( OGRGeoJSONReader* poReader );
 
 private:
 
     OGRGeoJSONDataSource* poDS_;
+    // Reader of the file when features are streamed rather than held
+    // in memory.
+    OGRGeoJSONReader* poReader_;
     CPLString sFIDColumn_;
     bool bUpdated_;
     bool bOriginalIdModified_;
@@ -121,6 +132,11 @@ private:
 
     int nCoordPrecision_;
     int nSignificantFigures_;
+
+    bool bDirectWrite_;
+    CPLString osWriteBuffer_;
+
+    bool FlushWriteBuffer();
 };
 
 /************************************************************************/
@@ -208,8 +224,10 @@ private:
     //
     void Clear();
     int ReadFromFile( GDALOpenInfo* poOpenInfo );
+    int ReadFromFileStreaming( GDALOpenInfo* poOpenInfo );
     int ReadFromService( const char* pszSource );
     void LoadLayers(char** papszOpenOptions);
+    void SetOptionsOnReader(OGRGeoJSONReader& reader, char** papszOpenOptions);
 };
 
 
@@ -87,6 +87,8 @@ int OGRGeoJSONDataSource::Open( GDALOpenInfo* poOpenInfo,
     }
     else if( eGeoJSONSourceFile == nSrcType )
     {
+        if( ReadFromFileStreaming( poOpenInfo ) )
+            return TRUE;
         if( !ReadFromFile( poOpenInfo ) )
             return FALSE;
     }
@@ -463,6 +465,92 @@ int OGRGeoJSONDataSource::ReadFromFile( GDALOpenInfo* poOpenInfo )
     return TRUE;
 }
 
+/************************************************************************/
+/*                        ReadFromFileStreaming()                       */
+/*                                                                      */
+/*      Open a FeatureCollection file without ingesting it, so that     */
+/*      features are read from the file on demand. This is done by     */
+/*      default for files of at least 10 MB opened in read-only mode,   */
+/*      and can be forced or disabled with OGR_GEOJSON_STREAMING.       */
+/*      Returns FALSE if the file must be loaded in memory instead.     */
+/************************************************************************/
+
+int OGRGeoJSONDataSource::ReadFromFileStreaming( GDALOpenInfo* poOpenInfo )
+{
+    if( poOpenInfo->eAccess == GA_Update || poOpenInfo->fpL == NULL )
+        return FALSE;
+
+    const char* pszStreaming = CPLGetConfigOption("OGR_GEOJSON_STREAMING", NULL);
+    if( pszStreaming != NULL )
+    {
+        if( !CPLTestBool(pszStreaming) )
+            return FALSE;
+    }
+    else
+    {
+        VSIStatBufL sStat;
+        if( VSIStatL(poOpenInfo->pszFilename, &sStat) != 0 ||
+            sStat.st_size < 10 * 1024 * 1024 )
+            return FALSE;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Leave JSONP, CouchDB, ESRI and TopoJSON content to the          */
+/*      in-memory reader. The scan only accepts FeatureCollections      */
+/*      anyway, but this avoids it in the obvious cases.                */
+/* -------------------------------------------------------------------- */
+    const char* pszHeader = reinterpret_cast<const char*>(poOpenInfo->pabyHeader);
+    if( STARTS_WITH(pszHeader, "\xEF\xBB\xBF") )
+        pszHeader += 3;
+    while( *pszHeader != '\0' && isspace((unsigned char)*pszHeader) )
+        pszHeader ++;
+    if( *pszHeader != '{' ||
+        STARTS_WITH(pszHeader, "{\"couchdb\":\"Welcome\"") ||
+        STARTS_WITH(pszHeader, "{\"db_name\":\"") ||
+        STARTS_WITH(pszHeader, "{\"total_rows\":") ||
+        STARTS_WITH(pszHeader, "{\"rows\":[") ||
+        strstr(pszHeader, "esriGeometry") != NULL ||
+        strstr(pszHeader, "esriFieldType") != NULL ||
+        strstr(pszHeader, "\"Topology\"") != NULL )
+    {
+        return FALSE;
+    }
+
+    VSILFILE* fp = VSIFOpenL(poOpenInfo->pszFilename, "rb");
+    if( fp == NULL )
+        return FALSE;
+
+    pszName_ = CPLStrdup( poOpenInfo->pszFilename );
+
+    OGRGeoJSONReader* poReader = new OGRGeoJSONReader();
+    SetOptionsOnReader( *poReader, poOpenInfo->papszOpenOptions );
+
+    OGRGeoJSONLayer* poLayer = poReader->FirstPassReadLayer( this, fp );
+    if( poLayer == NULL )
+    {
+        delete poReader;
+        CPLFree( pszName_ );
+        pszName_ = NULL;
+        return FALSE;
+    }
+
+    json_object* poProperties =
+        json_object_object_get(poReader->GetJSonObject(), "properties");
+    if( poProperties && json_object_get_type(poProperties) == json_type_object )
+    {
+        json_object* poExceededTransferLimit =
+            json_object_object_get(poProperties, "exceededTransferLimit");
+        if( poExceededTransferLimit && json_object_get_type(poExceededTransferLimit) == json_type_boolean )
+          bOtherPages_ = CPL_TO_BOOL(
+              json_object_get_boolean(poExceededTransferLimit) );
+    }
+
+    poLayer->SetStreamingReader( poReader );
+    AddLayer( poLayer );
+
+    return TRUE;
+}
+
 /************************************************************************/
 /*                           ReadFromService()                          */
 /************************************************************************/
@@ -620,30 +708,7 @@ void OGRGeoJSONDataSource::LoadLayers(char** papszOpenOptionsIn)
 /*      Configure GeoJSON format translator.                            */
 /* -------------------------------------------------------------------- */
     OGRGeoJSONReader reader;
-
-    if( eGeometryAsCollection == flTransGeom_ )
-    {
-        reader.SetPreserveGeometryType( false );
-        CPLDebug( "GeoJSON", "Geometry as OGRGeometryCollection type." );
-    }
-
-    if( eAttributesSkip == flTransAttrs_ )
-    {
-        reader.SetSkipAttributes( true );
-        CPLDebug( "GeoJSON", "Skip all attributes." );
-    }
-
-    reader.SetFlattenNestedAttributes(
-        CPL_TO_BOOL(CSLFetchBoolean(papszOpenOptionsIn, "FLATTEN_NESTED_ATTRIBUTES", FALSE)),
-        CSLFetchNameValueDef(papszOpenOptionsIn, "NESTED_ATTRIBUTE_SEPARATOR", "_")[0]);
-
-    const int bDefaultNativeData = bUpdatable_ ? TRUE : FALSE ;
-    reader.SetStoreNativeData(
-        CPL_TO_BOOL(CSLFetchBoolean(papszOpenOptionsIn, "NATIVE_DATA", bDefaultNativeData)));
-
-    reader.SetArrayAsString(
-        CPLTestBool(CSLFetchNameValueDef(papszOpenOptionsIn, "ARRAY_AS_STRING",
-                CPLGetConfigOption("OGR_GEOJSON_ARRAY_AS_STRING", "NO"))));
+    SetOptionsOnReader( reader, papszOpenOptionsIn );
 
 /* -------------------------------------------------------------------- */
 /*      Parse GeoJSON and build valid OGRLayer instance.                */
@@ -671,6 +736,38 @@ void OGRGeoJSONDataSource::LoadLayers(char** papszOpenOptionsIn)
     return;
 }
 
+/************************************************************************/
+/*                         SetOptionsOnReader()                         */
+/************************************************************************/
+
+void OGRGeoJSONDataSource::SetOptionsOnReader(OGRGeoJSONReader& reader,
+                                              char** papszOpenOptionsIn)
+{
+    if( eGeometryAsCollection == flTransGeom_ )
+    {
+        reader.SetPreserveGeometryType( false );
+        CPLDebug( "GeoJSON", "Geometry as OGRGeometryCollection type." );
+    }
+
+    if( eAttributesSkip == flTransAttrs_ )
+    {
+        reader.SetSkipAttributes( true );
+        CPLDebug( "GeoJSON", "Skip all attributes." );
+    }
+
+    reader.SetFlattenNestedAttributes(
+        CPL_TO_BOOL(CSLFetchBoolean(papszOpenOptionsIn, "FLATTEN_NESTED_ATTRIBUTES", FALSE)),
+        CSLFetchNameValueDef(papszOpenOptionsIn, "NESTED_ATTRIBUTE_SEPARATOR", "_")[0]);
+
+    const int bDefaultNativeData = bUpdatable_ ? TRUE : FALSE ;
+    reader.SetStoreNativeData(
+        CPL_TO_BOOL(CSLFetchBoolean(papszOpenOptionsIn, "NATIVE_DATA", bDefaultNativeData)));
+
+    reader.SetArrayAsString(
+        CPLTestBool(CSLFetchNameValueDef(papszOpenOptionsIn, "ARRAY_AS_STRING",
+                CPLGetConfigOption("OGR_GEOJSON_ARRAY_AS_STRING", "NO"))));
+}
+
 /************************************************************************/
 /*                            AddLayer()                                */
 /************************************************************************/
@@ -30,6 +30,7 @@
 #include <algorithm> // for_each, find_if
 #include <json.h> // JSON-C
 #include "ogr_geojson.h"
+#include "ogrgeojsonreader.h"
 
 /* Remove annoying warnings Microsoft Visual C++ */
 #if defined(_MSC_VER)
@@ -51,7 +52,8 @@ OGRGeoJSONLayer::OGRGeoJSONLayer( const char* pszName,
                                   OGRSpatialReference* poSRSIn,
                                   OGRwkbGeometryType eGType,
                                   OGRGeoJSONDataSource* poDS )
-  : OGRMemLayer( pszName, poSRSIn, eGType), poDS_(poDS), bUpdated_(false),
+  : OGRMemLayer( pszName, poSRSIn, eGType), poDS_(poDS), poReader_(NULL),
+    bUpdated_(false),
     bOriginalIdModified_(false)
 {
     SetAdvertizeUTF8(true);
@@ -64,6 +66,7 @@ OGRGeoJSONLayer::OGRGeoJSONLayer( const char* pszName,
 
 OGRGeoJSONLayer::~OGRGeoJSONLayer()
 {
+    delete poReader_;
 }
 
 /************************************************************************/
@@ -93,9 +96,101 @@ int OGRGeoJSONLayer::TestCapability( const char * pszCap )
 {
     if( EQUAL(pszCap, OLCCurveGeometries) )
         return FALSE;
+    if( poReader_ != NULL &&
+        (EQUAL(pszCap, OLCFastFeatureCount) ||
+         EQUAL(pszCap, OLCFastSetNextByIndex)) )
+        return m_poFilterGeom == NULL && m_poAttrQuery == NULL;
     return OGRMemLayer::TestCapability(pszCap);
 }
 
+/************************************************************************/
+/*                         SetStreamingReader()                         */
+/*                                                                      */
+/*      Features are then read from the file by the reader, which the   */
+/*      layer takes ownership of, instead of being held in memory.      */
+/************************************************************************/
+
+void OGRGeoJSONLayer::SetStreamingReader( OGRGeoJSONReader* poReader )
+{
+    CPLAssert( poReader_ == NULL && GetFeatureCount(FALSE) == 0 );
+    poReader_ = poReader;
+}
+
+/************************************************************************/
+/*                           ResetReading()                             */
+/************************************************************************/
+
+void OGRGeoJSONLayer::ResetReading()
+{
+    if( poReader_ != NULL )
+        poReader_->ResetReading();
+    else
+        OGRMemLayer::ResetReading();
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONLayer::GetNextFeature()
+{
+    if( poReader_ == NULL )
+        return OGRMemLayer::GetNextFeature();
+
+    while( true )
+    {
+        OGRFeature* poFeature = poReader_->GetNextFeature(this);
+        if( poFeature == NULL )
+            return NULL;
+
+        if((m_poFilterGeom == NULL
+            || FilterGeometry( poFeature->GetGeometryRef() ) )
+        && (m_poAttrQuery == NULL
+            || m_poAttrQuery->Evaluate( poFeature )) )
+        {
+            return poFeature;
+        }
+        delete poFeature;
+    }
+}
+
+/************************************************************************/
+/*                           SetNextByIndex()                           */
+/************************************************************************/
+
+OGRErr OGRGeoJSONLayer::SetNextByIndex( GIntBig nIndex )
+{
+    if( poReader_ == NULL )
+        return OGRMemLayer::SetNextByIndex(nIndex);
+    if( m_poFilterGeom != NULL || m_poAttrQuery != NULL )
+        return OGRLayer::SetNextByIndex(nIndex);
+    return poReader_->SetNextByIndex(nIndex);
+}
+
+/************************************************************************/
+/*                             GetFeature()                             */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONLayer::GetFeature( GIntBig nFID )
+{
+    if( poReader_ == NULL )
+        return OGRMemLayer::GetFeature(nFID);
+    return poReader_->GetFeature(this, nFID);
+}
+
+/************************************************************************/
+/*                          GetFeatureCount()                           */
+/************************************************************************/
+
+GIntBig OGRGeoJSONLayer::GetFeatureCount( int bForce )
+{
+    if( poReader_ == NULL )
+        return OGRMemLayer::GetFeatureCount(bForce);
+    if( m_poFilterGeom != NULL || m_poAttrQuery != NULL )
+        return OGRLayer::GetFeatureCount(bForce);
+    return poReader_->GetFeatureCount();
+}
+
 /************************************************************************/
 /*                           SyncToDisk()                               */
 /************************************************************************/
@@ -165,7 +260,8 @@ void OGRGeoJSONLayer::AddFeature( OGRFeature* poFeature )
 
 void OGRGeoJSONLayer::DetectGeometryType()
 {
-    if (GetLayerDefn()->GetGeomType() != wkbUnknown)
+    // Already detected by the streaming reader while scanning the file.
+    if (GetLayerDefn()->GetGeomType() != wkbUnknown || poReader_ != NULL)
         return;
 
     ResetReading();
@@ -32,6 +32,7 @@
 #include "ogr_geojson.h"
 #include <json.h> // JSON-C
 #include <ogr_api.h>
+#include <algorithm>
 
 /************************************************************************/
 /*                           OGRGeoJSONReader                           */
@@ -39,6 +40,12 @@
 
 OGRGeoJSONReader::OGRGeoJSONReader() :
     poGJObject_(NULL),
+    fpStream_(NULL),
+    nNextFeatureIdx_(0),
+    pabyStreamBuf_(NULL),
+    nStreamBufAlloc_(0),
+    nStreamBufSize_(0),
+    nStreamBufOffset_(0),
     bGeometryPreserve_(true),
     bAttributesSkip_(false),
     bFlattenNestedAttributes_(false),
@@ -65,6 +72,10 @@ OGRGeoJSONReader::~OGRGeoJSONReader()
     }
 
     poGJObject_ = NULL;
+
+    if( fpStream_ != NULL )
+        VSIFCloseL(fpStream_);
+    CPLFree(pabyStreamBuf_);
 }
 
 /************************************************************************/
@@ -436,6 +447,17 @@ bool OGRGeoJSONReader::GenerateLayerDefn( OGRGeoJSONLayer* poLayer, json_object*
         }
     }
 
+    SetFIDColumnFromIdField( poLayer );
+
+    return bSuccess;
+}
+
+/************************************************************************/
+/*                      SetFIDColumnFromIdField()                       */
+/************************************************************************/
+
+void OGRGeoJSONReader::SetFIDColumnFromIdField( OGRGeoJSONLayer* poLayer )
+{
 /* -------------------------------------------------------------------- */
 /*      Validate and add FID column if necessary.                       */
 /* -------------------------------------------------------------------- */
@@ -454,8 +476,6 @@ bool OGRGeoJSONReader::GenerateLayerDefn( OGRGeoJSONLayer* poLayer, json_object*
             }
         }
     }
-
-    return bSuccess;
 }
 
 /************************************************************************/
@@ -1205,6 +1225,531 @@ OGRGeoJSONReader::ReadFeatureCollection( OGRGeoJSONLayer* poLayer, json_object*
     }
 }
 
+/************************************************************************/
+/*                         FirstPassReadLayer()                         */
+/*                                                                      */
+/*      Scan a FeatureCollection file by chunks without building the    */
+/*      json-c tree of the whole document. Each member of the           */
+/*      "features" array is parsed on its own to build the layer        */
+/*      schema, and its offset and size are recorded so that it can be  */
+/*      read again lazily by GetNextFeature() and GetFeature(). The     */
+/*      other members of the top-level object are kept in a skeleton    */
+/*      document whose "features" array is empty.                       */
+/*                                                                      */
+/*      Returns NULL if the file is not a well-formed FeatureCollection */
+/*      so that the caller can fall back to the in-memory reader. The   */
+/*      reader takes ownership of fp in all cases.                      */
+/************************************************************************/
+
+#define STREAM_CHUNK_SIZE 65536
+
+OGRGeoJSONLayer* OGRGeoJSONReader::FirstPassReadLayer( OGRGeoJSONDataSource* poDS,
+                                                      VSILFILE* fp )
+{
+    CPLAssert( NULL == fpStream_ );
+    fpStream_ = fp;
+
+    // The SRS may only be known once all features have been scanned, so it
+    // is attached to the layer at the end.
+    OGRGeoJSONLayer* poLayer = new OGRGeoJSONLayer( OGRGeoJSONLayer::DefaultName,
+                                    NULL,
+                                    OGRGeoJSONLayer::DefaultGeometryType,
+                                    poDS );
+
+    std::vector<GIntBig> anRawIds;
+    std::vector<bool> abHasId;
+    OGRwkbGeometryType eLayerGeomType = wkbUnknown;
+    bool bFirstGeometry = true;
+    bool bMixedGeometry = false;
+
+    enum { SINK_SKELETON, SINK_NONE, SINK_FEATURE } eSink = SINK_SKELETON;
+    CPLString osSkeleton;
+    CPLString osFeature;
+    CPLString osString;     // Current top-level key or string value.
+    CPLString osLastString;
+    vsi_l_offset nFeatureOffset = 0;
+    int nDepth = 0;
+    bool bInString = false;
+    bool bEscape = false;
+    bool bInFeatures = false;
+    bool bFoundFeatures = false;
+    bool bEnded = false;
+    bool bOK = true;
+
+    CPLErrorReset();
+
+    GByte* pabyChunk = static_cast<GByte*>(CPLMalloc(STREAM_CHUNK_SIZE));
+    const char* pszChunk = reinterpret_cast<const char*>(pabyChunk);
+    vsi_l_offset nChunkOffset = 0;
+    if( VSIFSeekL( fp, 0, SEEK_SET ) != 0 )
+        bOK = false;
+
+    while( bOK && !bEnded )
+    {
+        const size_t nRead = VSIFReadL( pabyChunk, 1, STREAM_CHUNK_SIZE, fp );
+        if( nRead == 0 )
+            break;
+
+        size_t i = 0;
+        /* Skip UTF-8 BOM (#5630) */
+        if( nChunkOffset == 0 && nRead >= 3 && pabyChunk[0] == 0xEF &&
+            pabyChunk[1] == 0xBB && pabyChunk[2] == 0xBF )
+        {
+            i = 3;
+        }
+
+        // Characters from nSegStart are appended to the current sink when
+        // it changes or at the end of the chunk.
+        size_t nSegStart = i;
+        for( ; bOK && i < nRead; i++ )
+        {
+            const char ch = pszChunk[i];
+            if( bInString )
+            {
+                if( bEscape )
+                    bEscape = false;
+                else if( ch == '\\' )
+                    bEscape = true;
+                else if( ch == '"' )
+                {
+                    bInString = false;
+                    if( nDepth == 1 )
+                        osLastString = osString;
+                    continue;
+                }
+                if( nDepth == 1 && osString.size() < 64 )
+                    osString += ch;
+                continue;
+            }
+
+            switch( ch )
+            {
+                case '"':
+                    if( eSink == SINK_NONE )
+                        bOK = false;
+                    bInString = true;
+                    if( nDepth == 1 )
+                        osString.clear();
+                    break;
+
+                case '{':
+                case '[':
+                    if( nDepth == 0 && ch != '{' )
+                    {
+                        bOK = false;
+                    }
+                    else if( eSink == SINK_NONE )
+                    {
+                        if( ch != '{' )
+                        {
+                            bOK = false;
+                            break;
+                        }
+                        nSegStart = i;
+                        eSink = SINK_FEATURE;
+                        nFeatureOffset = nChunkOffset + i;
+                        osFeature.clear();
+                    }
+                    else if( nDepth == 1 && ch == '[' && !bFoundFeatures &&
+                             osLastString == "features" )
+                    {
+                        // Keep the bracket in the skeleton and drop the
+                        // content of the array.
+                        osSkeleton.append( pszChunk + nSegStart,
+                                           i + 1 - nSegStart );
+                        nSegStart = i + 1;
+                        eSink = SINK_NONE;
+                        bInFeatures = true;
+                        bFoundFeatures = true;
+                    }
+                    nDepth++;
+                    break;
+
+                case '}':
+                case ']':
+                    nDepth--;
+                    if( nDepth < 0 )
+                    {
+                        bOK = false;
+                    }
+                    else if( eSink == SINK_FEATURE && nDepth == 2 )
+                    {
+                        osFeature.append( pszChunk + nSegStart,
+                                          i + 1 - nSegStart );
+                        nSegStart = i + 1;
+                        eSink = SINK_NONE;
+                        bOK = IngestStreamedFeature( poLayer, osFeature,
+                                                     nFeatureOffset,
+                                                     osFeature.size(),
+                                                     anRawIds, abHasId,
+                                                     eLayerGeomType,
+                                                     bFirstGeometry,
+                                                     bMixedGeometry );
+                    }
+                    else if( bInFeatures && nDepth == 1 )
+                    {
+                        bInFeatures = false;
+                        nSegStart = i;
+                        eSink = SINK_SKELETON;
+                    }
+                    else if( nDepth == 0 )
+                    {
+                        bEnded = true;
+                    }
+                    break;
+
+                case ' ':
+                case '\t':
+                case '\r':
+                case '\n':
+                case ',':
+                    break;
+
+                default:
+                    // Only objects are expected in the features array.
+                    if( nDepth == 0 || eSink == SINK_NONE )
+                        bOK = false;
+                    break;
+            }
+
+            if( bEnded )
+            {
+                i++;
+                break;
+            }
+        }
+
+        if( eSink == SINK_SKELETON )
+            osSkeleton.append( pszChunk + nSegStart, i - nSegStart );
+        else if( eSink == SINK_FEATURE )
+            osFeature.append( pszChunk + nSegStart, i - nSegStart );
+        nChunkOffset += nRead;
+    }
+    CPLFree( pabyChunk );
+
+/* -------------------------------------------------------------------- */
+/*      Parse the skeleton, which holds the SRS and the other members   */
+/*      of the FeatureCollection.                                       */
+/* -------------------------------------------------------------------- */
+    if( !bOK || !bEnded || !bFoundFeatures ||
+        !OGRJSonParse( osSkeleton, &poGJObject_, false ) ||
+        GeoJSONObject::eFeatureCollection != OGRGeoJSONGetType( poGJObject_ ) )
+    {
+        CPLDebug( "GeoJSON", "Cannot stream %s, loading it in memory.",
+                  poDS->GetName() );
+        delete poLayer;
+        return NULL;
+    }
+
+    OGRSpatialReference* poSRS
+        = OGRGeoJSONReadSpatialReference( poGJObject_ );
+    if (poSRS == NULL ) {
+        // If there is none defined, we use 4326
+        poSRS = new OGRSpatialReference();
+        if( OGRERR_NONE != poSRS->importFromEPSG( 4326 ) )
+        {
+            delete poSRS;
+            poSRS = NULL;
+        }
+    }
+    if( poSRS != NULL )
+    {
+        poLayer->GetLayerDefn()->GetGeomFieldDefn(0)->SetSpatialRef( poSRS );
+        poSRS->Release();
+    }
+
+    if( !bAttributesSkip_ )
+        SetFIDColumnFromIdField( poLayer );
+
+    AssignStreamedFIDs( poLayer, anRawIds, abHasId );
+
+    if( bMixedGeometry )
+    {
+        CPLDebug( "GeoJSON",
+                  "Detected layer of mixed-geometry type features." );
+    }
+    else if( !bFirstGeometry )
+    {
+        poLayer->GetLayerDefn()->SetGeomType( eLayerGeomType );
+    }
+
+    // The features array of the skeleton is empty, so this only stores
+    // the layer level native data.
+    ReadFeatureCollection( poLayer, poGJObject_ );
+
+    if( CPLGetLastErrorType() != CE_Warning )
+        CPLErrorReset();
+
+    return poLayer;
+}
+
+/************************************************************************/
+/*                        IngestStreamedFeature()                       */
+/************************************************************************/
+
+bool OGRGeoJSONReader::IngestStreamedFeature( OGRGeoJSONLayer* poLayer,
+                                              const char* pszText,
+                                              vsi_l_offset nOffset,
+                                              size_t nSize,
+                                              std::vector<GIntBig>& anRawIds,
+                                              std::vector<bool>& abHasId,
+                                              OGRwkbGeometryType& eLayerGeomType,
+                                              bool& bFirstGeometry,
+                                              bool& bMixedGeometry )
+{
+    if( nSize > 0x7FFFFFFFU )
+        return false;
+
+    json_object* poObj = NULL;
+    if( !OGRJSonParse( pszText, &poObj, false ) )
+        return false;
+
+    if( !bAttributesSkip_ && !GenerateFeatureDefn( poLayer, poObj ) )
+    {
+        CPLDebug( "GeoJSON", "Create feature schema failure." );
+        json_object_put( poObj );
+        return false;
+    }
+
+    // The FIDs can only be assigned once it is known whether the "id"
+    // members are used as FID, which may change up to the last feature.
+    json_object* poObjId = OGRGeoJSONFindMemberByName( poObj, "id" );
+    abHasId.push_back( NULL != poObjId );
+    anRawIds.push_back( NULL != poObjId ?
+                        static_cast<GIntBig>(json_object_get_int64( poObjId )) :
+                        -1 );
+
+/* -------------------------------------------------------------------- */
+/*      Detect the layer geometry type as DetectGeometryType() does,    */
+/*      silently since errors are reported when reading features.       */
+/* -------------------------------------------------------------------- */
+    if( !bMixedGeometry )
+    {
+        json_object* poObjGeom = OGRGeoJSONFindMemberByName( poObj, "geometry" );
+        if( NULL != poObjGeom )
+        {
+            CPLPushErrorHandler( CPLQuietErrorHandler );
+            OGRGeometry* poGeometry = ReadGeometry( poObjGeom );
+            CPLPopErrorHandler();
+            if( NULL != poGeometry )
+            {
+                const OGRwkbGeometryType eGeomType
+                    = poGeometry->getGeometryType();
+                if( bFirstGeometry )
+                {
+                    eLayerGeomType = eGeomType;
+                    bFirstGeometry = false;
+                }
+                else if( eGeomType != eLayerGeomType )
+                {
+                    bMixedGeometry = true;
+                }
+                delete poGeometry;
+            }
+        }
+    }
+
+    json_object_put( poObj );
+
+    anFeatureOffsets_.push_back( nOffset );
+    anFeatureSizes_.push_back( static_cast<GUInt32>(nSize) );
+
+    return true;
+}
+
+/************************************************************************/
+/*                         AssignStreamedFIDs()                         */
+/*                                                                      */
+/*      Assign FIDs the same way OGRGeoJSONLayer::AddFeature() does for */
+/*      features held in memory, and build the index, sorted by FID,    */
+/*      used by GetFeature(). Nothing is kept when the FID of each      */
+/*      feature is its index.                                           */
+/************************************************************************/
+
+void OGRGeoJSONReader::AssignStreamedFIDs( OGRGeoJSONLayer* poLayer,
+                                           const std::vector<GIntBig>& anRawIds,
+                                           const std::vector<bool>& abHasId )
+{
+    if( !bFoundFeatureId )
+        return;
+
+    const int nFeatures = static_cast<int>(anRawIds.size());
+    std::set<GIntBig> oSetUsedFIDs;
+    bool bSequential = true;
+    bool bWarned = false;
+
+    anFIDs_.resize( nFeatures );
+    for( int i = 0; i < nFeatures; i++ )
+    {
+        GIntBig nFID = abHasId[i] ? anRawIds[i] : -1;
+        if( -1 != nFID && oSetUsedFIDs.find( nFID ) != oSetUsedFIDs.end() )
+        {
+            if( !bWarned )
+            {
+                CPLError(CE_Warning, CPLE_AppDefined,
+                         "Several features with id = " CPL_FRMT_GIB " have been found. "
+                         "Altering it to be unique. This warning will not be emitted for this layer",
+                         nFID);
+                bWarned = true;
+            }
+            nFID = -1;
+        }
+        if( -1 == nFID )
+        {
+            nFID = i;
+            while( oSetUsedFIDs.find( nFID ) != oSetUsedFIDs.end() )
+                nFID ++;
+        }
+        oSetUsedFIDs.insert( nFID );
+        anFIDs_[i] = nFID;
+
+        if( nFID != i )
+            bSequential = false;
+        if( !CPL_INT64_FITS_ON_INT32(nFID) )
+            poLayer->SetMetadataItem(OLMD_FID64, "YES");
+    }
+
+    if( bSequential )
+    {
+        std::vector<GIntBig>().swap( anFIDs_ );
+        return;
+    }
+
+    aoFIDIndex_.reserve( nFeatures );
+    for( int i = 0; i < nFeatures; i++ )
+        aoFIDIndex_.push_back( std::pair<GIntBig, int>( anFIDs_[i], i ) );
+    std::sort( aoFIDIndex_.begin(), aoFIDIndex_.end() );
+}
+
+/************************************************************************/
+/*                            ResetReading()                            */
+/************************************************************************/
+
+void OGRGeoJSONReader::ResetReading()
+{
+    nNextFeatureIdx_ = 0;
+}
+
+/************************************************************************/
+/*                           GetNextFeature()                           */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONReader::GetNextFeature( OGRGeoJSONLayer* poLayer )
+{
+    if( nNextFeatureIdx_ >= static_cast<int>(anFeatureOffsets_.size()) )
+        return NULL;
+
+    // Unlike the in-memory layer, which returns features by increasing FID,
+    // features are returned in file order, so that they are read with
+    // forward reads only whatever their ids.
+    const int iFeature = nNextFeatureIdx_;
+    nNextFeatureIdx_ ++;
+    return ReadStreamedFeature( poLayer, iFeature );
+}
+
+/************************************************************************/
+/*                             GetFeature()                             */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONReader::GetFeature( OGRGeoJSONLayer* poLayer,
+                                          GIntBig nFID )
+{
+    int iFeature = -1;
+    if( aoFIDIndex_.empty() )
+    {
+        if( nFID >= 0 && nFID < GetFeatureCount() )
+            iFeature = static_cast<int>(nFID);
+    }
+    else
+    {
+        std::vector< std::pair<GIntBig, int> >::const_iterator oIter =
+            std::lower_bound( aoFIDIndex_.begin(), aoFIDIndex_.end(),
+                              std::pair<GIntBig, int>( nFID, 0 ) );
+        if( oIter != aoFIDIndex_.end() && oIter->first == nFID )
+            iFeature = oIter->second;
+    }
+
+    if( iFeature < 0 )
+        return NULL;
+
+    return ReadStreamedFeature( poLayer, iFeature );
+}
+
+/************************************************************************/
+/*                           SetNextByIndex()                           */
+/************************************************************************/
+
+OGRErr OGRGeoJSONReader::SetNextByIndex( GIntBig nIndex )
+{
+    if( nIndex < 0 || nIndex >= GetFeatureCount() )
+        return OGRERR_FAILURE;
+
+    nNextFeatureIdx_ = static_cast<int>(nIndex);
+    return OGRERR_NONE;
+}
+
+/************************************************************************/
+/*                         ReadStreamedFeature()                        */
+/************************************************************************/
+
+OGRFeature* OGRGeoJSONReader::ReadStreamedFeature( OGRGeoJSONLayer* poLayer,
+                                                   int iFeature )
+{
+    const vsi_l_offset nOffset = anFeatureOffsets_[iFeature];
+    const size_t nSize = anFeatureSizes_[iFeature];
+
+/* -------------------------------------------------------------------- */
+/*      Features are generally read in sequence, so the file is read by */
+/*      chunks and we only seek when the feature is not in the current  */
+/*      one.                                                            */
+/* -------------------------------------------------------------------- */
+    if( nOffset < nStreamBufOffset_ ||
+        nOffset + nSize > nStreamBufOffset_ + nStreamBufSize_ )
+    {
+        const size_t nToRead = std::max( nSize,
+                                         static_cast<size_t>(STREAM_CHUNK_SIZE) );
+        if( nToRead + 1 > nStreamBufAlloc_ )
+        {
+            GByte* pabyNewBuf = static_cast<GByte*>(
+                VSI_REALLOC_VERBOSE( pabyStreamBuf_, nToRead + 1 ) );
+            if( pabyNewBuf == NULL )
+                return NULL;
+            pabyStreamBuf_ = pabyNewBuf;
+            nStreamBufAlloc_ = nToRead + 1;
+        }
+
+        nStreamBufOffset_ = nOffset;
+        nStreamBufSize_ = 0;
+        if( VSIFSeekL( fpStream_, nOffset, SEEK_SET ) == 0 )
+            nStreamBufSize_ = VSIFReadL( pabyStreamBuf_, 1, nToRead, fpStream_ );
+        if( nStreamBufSize_ < nSize )
+        {
+            CPLError( CE_Failure, CPLE_FileIO,
+                      "Cannot read feature at offset " CPL_FRMT_GUIB,
+                      nOffset );
+            nStreamBufSize_ = 0;
+            return NULL;
+        }
+    }
+
+    char* pszText = reinterpret_cast<char*>(pabyStreamBuf_) +
+                    (nOffset - nStreamBufOffset_);
+    const char chSaved = pszText[nSize];
+    pszText[nSize] = '\0';
+    json_object* poObj = NULL;
+    const bool bParsed = OGRJSonParse( pszText, &poObj );
+    pszText[nSize] = chSaved;
+    if( !bParsed )
+        return NULL;
+
+    OGRFeature* poFeature = ReadFeature( poLayer, poObj );
+    json_object_put( poObj );
+
+    poFeature->SetFID( anFIDs_.empty() ? iFeature : anFIDs_[iFeature] );
+
+    return poFeature;
+}
+
 /************************************************************************/
 /*                           OGRGeoJSONFindMemberByName                 */
 /************************************************************************/
@@ -35,6 +35,8 @@
 #include "ogrsf_frmts.h"
 #include <json.h> // JSON-C
 #include <set>
+#include <utility>
+#include <vector>
 
 /************************************************************************/
 /*                         FORWARD DECLARATIONS                         */
@@ -108,10 +110,35 @@ public:
 
     json_object* GetJSonObject() { return poGJObject_; }
 
+    //
+    // Streaming of FeatureCollection files.
+    //
+    OGRGeoJSONLayer* FirstPassReadLayer( OGRGeoJSONDataSource* poDS,
+                                         VSILFILE* fp );
+    void ResetReading();
+    OGRFeature* GetNextFeature( OGRGeoJSONLayer* poLayer );
+    OGRFeature* GetFeature( OGRGeoJSONLayer* poLayer, GIntBig nFID );
+    OGRErr SetNextByIndex( GIntBig nIndex );
+    GIntBig GetFeatureCount() const
+        { return static_cast<GIntBig>(anFeatureOffsets_.size()); }
+
 private:
 
     json_object* poGJObject_;
 
+    // Streaming state: offset and size of each feature in file order,
+    // and their FID when it differs from their index.
+    VSILFILE* fpStream_;
+    std::vector<vsi_l_offset> anFeatureOffsets_;
+    std::vector<GUInt32> anFeatureSizes_;
+    std::vector<GIntBig> anFIDs_;
+    std::vector< std::pair<GIntBig, int> > aoFIDIndex_;
+    int nNextFeatureIdx_;
+    GByte* pabyStreamBuf_;
+    size_t nStreamBufAlloc_;
+    size_t nStreamBufSize_;
+    vsi_l_offset nStreamBufOffset_;
+
     bool bGeometryPreserve_;
     bool bAttributesSkip_;
     bool bFlattenNestedAttributes_;
@@ -140,12 +167,25 @@ private:
     //
     bool GenerateLayerDefn( OGRGeoJSONLayer* poLayer, json_object* poGJObject );
     bool GenerateFeatureDefn( OGRGeoJSONLayer* poLayer, json_object* poObj );
+    void SetFIDColumnFromIdField( OGRGeoJSONLayer* poLayer );
     bool AddFeature( OGRGeoJSONLayer* poLayer, OGRGeometry* poGeometry );
     bool AddFeature( OGRGeoJSONLayer* poLayer, OGRFeature* poFeature );
 
     OGRGeometry* ReadGeometry( json_object* poObj );
     OGRFeature* ReadFeature( OGRGeoJSONLayer* poLayer, json_object* poObj );
     void ReadFeatureCollection( OGRGeoJSONLayer* poLayer, json_object* poObj );
+
+    bool IngestStreamedFeature( OGRGeoJSONLayer* poLayer,
+                                const char* pszText,
+                                vsi_l_offset nOffset, size_t nSize,
+                                std::vector<GIntBig>& anRawIds,
+                                std::vector<bool>& abHasId,
+                                OGRwkbGeometryType& eLayerGeomType,
+                                bool& bFirstGeometry, bool& bMixedGeometry );
+    void AssignStreamedFIDs( OGRGeoJSONLayer* poLayer,
+                             const std::vector<GIntBig>& anRawIds,
+                             const std::vector<bool>& abHasId );
+    OGRFeature* ReadStreamedFeature( OGRGeoJSONLayer* poLayer, int iFeature );
 };
 
 void OGRGeoJSONReaderSetField(OGRLayer* poLayer,
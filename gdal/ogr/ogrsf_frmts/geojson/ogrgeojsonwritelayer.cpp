@@ -30,6 +30,9 @@
 #include "ogr_geojson.h"
 #include "ogrgeojsonwriter.h"
 
+/* Size above which the buffered features are written to the file. */
+#define WRITE_BUFFER_SIZE 65536
+
 /* Remove annoying warnings Microsoft Visual C++ */
 #if defined(_MSC_VER)
 #  pragma warning(disable:4512)
@@ -57,6 +60,10 @@ OGRGeoJSONWriteLayer::OGRGeoJSONWriteLayer( const char* pszName,
 
     nCoordPrecision_ = atoi(CSLFetchNameValueDef(papszOptions, "COORDINATE_PRECISION", "-1"));
     nSignificantFigures_ = atoi(CSLFetchNameValueDef(papszOptions, "SIGNIFICANT_FIGURES", "-1"));
+
+    /* Features are written as text without going through json-c objects, */
+    /* unless this is disabled. The output is the same. */
+    bDirectWrite_ = CPLTestBool(CPLGetConfigOption("OGR_GEOJSON_DIRECT_WRITE", "YES"));
 }
 
 /************************************************************************/
@@ -67,6 +74,8 @@ OGRGeoJSONWriteLayer::~OGRGeoJSONWriteLayer()
 {
     VSILFILE* fp = poDS_->GetOutputFile();
 
+    FlushWriteBuffer();
+
     VSIFPrintfL( fp, "\n]" );
 
     if( bWriteFC_BBOX && sEnvelopeLayer.IsInit() )
@@ -108,31 +117,39 @@ OGRGeoJSONWriteLayer::~OGRGeoJSONWriteLayer()
 
 OGRErr OGRGeoJSONWriteLayer::ICreateFeature( OGRFeature* poFeature )
 {
-    VSILFILE* fp = poDS_->GetOutputFile();
-
     if( NULL == poFeature )
     {
         CPLDebug( "GeoJSON", "Feature is null" );
         return OGRERR_INVALID_HANDLE;
     }
 
-    json_object* poObj = OGRGeoJSONWriteFeature( poFeature, bWriteBBOX,
-                                                 nCoordPrecision_, nSignificantFigures_ );
-    CPLAssert( NULL != poObj );
-
     if( nOutCounter_ > 0 )
     {
         /* Separate "Feature" entries in "FeatureCollection" object. */
-        VSIFPrintfL( fp, ",\n" );
+        osWriteBuffer_ += ",\n";
+    }
+
+    if( !bDirectWrite_ ||
+        !OGRGeoJSONWriteFeatureText( osWriteBuffer_, poFeature, bWriteBBOX,
+                                     nCoordPrecision_, nSignificantFigures_ ) )
+    {
+        json_object* poObj = OGRGeoJSONWriteFeature( poFeature, bWriteBBOX,
+                                                     nCoordPrecision_, nSignificantFigures_ );
+        CPLAssert( NULL != poObj );
+
+        osWriteBuffer_ += json_object_to_json_string( poObj );
+
+        json_object_put( poObj );
     }
-    VSIFPrintfL( fp, "%s", json_object_to_json_string( poObj ) );
 
-    json_object_put( poObj );
+    if( osWriteBuffer_.size() >= WRITE_BUFFER_SIZE && !FlushWriteBuffer() )
+        return OGRERR_FAILURE;
 
     ++nOutCounter_;
 
     OGRGeometry* poGeometry = poFeature->GetGeometryRef();
-    if ( (bWriteBBOX || bWriteFC_BBOX) && !poGeometry->IsEmpty() )
+    if ( (bWriteBBOX || bWriteFC_BBOX) && poGeometry != NULL &&
+         !poGeometry->IsEmpty() )
     {
         OGREnvelope3D sEnvelope;
         poGeometry->getEnvelope(&sEnvelope);
@@ -146,6 +163,28 @@ OGRErr OGRGeoJSONWriteLayer::ICreateFeature( OGRFeature* poFeature )
     return OGRERR_NONE;
 }
 
+/************************************************************************/
+/*                          FlushWriteBuffer()                          */
+/************************************************************************/
+
+bool OGRGeoJSONWriteLayer::FlushWriteBuffer()
+{
+    if( osWriteBuffer_.empty() )
+        return true;
+
+    VSILFILE* fp = poDS_->GetOutputFile();
+    const size_t nSize = osWriteBuffer_.size();
+    const bool bRet = VSIFWriteL( osWriteBuffer_.c_str(), 1, nSize, fp ) == nSize;
+    osWriteBuffer_.clear();
+    if( !bRet )
+    {
+        CPLError( CE_Failure, CPLE_FileIO,
+                  "Failed to write %d bytes of GeoJSON features",
+                  static_cast<int>(nSize) );
+    }
+    return bRet;
+}
+
 /************************************************************************/
 /*                           CreateField()                              */
 /************************************************************************/
@@ -38,6 +38,10 @@
 #include <ogr_p.h>
 
 
+static bool OGRGeoJSONAppendGeometry( CPLString& osOut, OGRGeometry* poGeometry,
+                                      int nCoordPrecision,
+                                      int nSignificantFigures );
+
 static json_object* json_object_new_coord(double dfVal, int nCoordPrecision, int nSignificantFigures)
 {
     // If coordinate precision is specified, or significant figures is not
@@ -931,6 +935,19 @@ char* OGR_G_ExportToJsonEx( OGRGeometryH hGeometry, char** papszOptions )
     const int nSignificantFigures
         = atoi(CSLFetchNameValueDef(papszOptions, "SIGNIFICANT_FIGURES", "-1"));
 
+    if( CPLTestBool(CPLGetConfigOption("OGR_GEOJSON_DIRECT_WRITE", "YES")) )
+    {
+        CPLString osJSon;
+        if( OGRGeoJSONAppendGeometry( osJSon, poGeometry, nCoordPrecision,
+                                      nSignificantFigures ) )
+        {
+            /* Empty point */
+            if( osJSon == "null" )
+                return NULL;
+            return CPLStrdup( osJSon );
+        }
+    }
+
     json_object* poObj
         = OGRGeoJSONWriteGeometry( poGeometry, nCoordPrecision, nSignificantFigures );
 
@@ -948,6 +965,22 @@ char* OGR_G_ExportToJsonEx( OGRGeometryH hGeometry, char** papszOptions )
     return NULL;
 }
 
+/************************************************************************/
+/*                   OGRGeoJSONFormatDoubleWithPrecision()              */
+/************************************************************************/
+
+static int OGRGeoJSONFormatDoubleWithPrecision( char* pszBuffer, int nBufferLen,
+                                                double dfVal, int nPrecision )
+{
+    OGRFormatDouble( pszBuffer, nBufferLen, dfVal, '.',
+                     (nPrecision < 0) ? 15 : nPrecision );
+    if( pszBuffer[0] == 't' /*oobig */ )
+    {
+        CPLsnprintf(pszBuffer, nBufferLen, "%.18g", dfVal);
+    }
+    return static_cast<int>(strlen(pszBuffer));
+}
+
 /************************************************************************/
 /*               OGR_json_double_with_precision_to_string()             */
 /************************************************************************/
@@ -959,13 +992,9 @@ static int OGR_json_double_with_precision_to_string(struct json_object *jso,
 {
     char szBuffer[75];
     const int nPrecision = (int) (size_t) jso->_userdata;
-    OGRFormatDouble( szBuffer, sizeof(szBuffer), jso->o.c_double, '.',
-                     (nPrecision < 0) ? 15 : nPrecision );
-    if( szBuffer[0] == 't' /*oobig */ )
-    {
-        CPLsnprintf(szBuffer, sizeof(szBuffer), "%.18g", jso->o.c_double);
-    }
-    return printbuf_memappend(pb, szBuffer, static_cast<int>(strlen(szBuffer)));
+    const int nSize = OGRGeoJSONFormatDoubleWithPrecision(
+        szBuffer, sizeof(szBuffer), jso->o.c_double, nPrecision );
+    return printbuf_memappend(pb, szBuffer, nSize);
 }
 
 /************************************************************************/
@@ -982,36 +1011,34 @@ json_object* json_object_new_double_with_precision(double dfVal,
 }
 
 /************************************************************************/
-/*             OGR_json_double_with_significant_figures_to_string()     */
+/*               OGRGeoJSONFormatDoubleWithSignificantFigures()         */
 /************************************************************************/
 
-static int OGR_json_double_with_significant_figures_to_string(struct json_object *jso,
-                                                    struct printbuf *pb,
-                                                    CPL_UNUSED int level,
-                                                    CPL_UNUSED int flags)
+static int OGRGeoJSONFormatDoubleWithSignificantFigures( char* pszBuffer,
+                                                         int nBufferLen,
+                                                         double dfVal,
+                                                         int nSignificantFigures )
 {
-    char szBuffer[75];
     int nSize;
-    if( CPLIsNan(jso->o.c_double))
-        nSize = CPLsnprintf(szBuffer, sizeof(szBuffer), "NaN");
-    else if(CPLIsInf(jso->o.c_double))
+    if( CPLIsNan(dfVal))
+        nSize = CPLsnprintf(pszBuffer, nBufferLen, "NaN");
+    else if(CPLIsInf(dfVal))
     {
-        if(jso->o.c_double > 0)
-            nSize = CPLsnprintf(szBuffer, sizeof(szBuffer), "Infinity");
+        if(dfVal > 0)
+            nSize = CPLsnprintf(pszBuffer, nBufferLen, "Infinity");
         else
-            nSize = CPLsnprintf(szBuffer, sizeof(szBuffer), "-Infinity");
+            nSize = CPLsnprintf(pszBuffer, nBufferLen, "-Infinity");
     }
     else
     {
         char szFormatting[32];
-        const int nSignificantFigures = (int) (size_t) jso->_userdata;
         const int nInitialSignificantFigures = nSignificantFigures >= 0 ? nSignificantFigures : 17;
         CPLsnprintf(szFormatting, sizeof(szFormatting), "%%.%dg", nInitialSignificantFigures);
-        nSize = CPLsnprintf(szBuffer, sizeof(szBuffer), szFormatting, jso->o.c_double);
+        nSize = CPLsnprintf(pszBuffer, nBufferLen, szFormatting, dfVal);
         const char* pszDot = NULL;
-        if( nSize+2 < (int)sizeof(szBuffer) && (pszDot = strchr(szBuffer, '.')) == NULL )
+        if( nSize+2 < nBufferLen && (pszDot = strchr(pszBuffer, '.')) == NULL )
         {
-            nSize += CPLsnprintf(szBuffer + nSize, sizeof(szBuffer) - nSize, ".0");
+            nSize += CPLsnprintf(pszBuffer + nSize, nBufferLen - nSize, ".0");
         }
 
         // Try to avoid .xxxx999999y or .xxxx000000y rounding issues by decreasing a bit precision
@@ -1022,8 +1049,8 @@ static int OGR_json_double_with_significant_figures_to_string(struct json_object
             for(int i=1; i<=3; i++)
             {
                 CPLsnprintf(szFormatting, sizeof(szFormatting), "%%.%dg", nInitialSignificantFigures- i);
-                nSize = CPLsnprintf(szBuffer, sizeof(szBuffer), szFormatting, jso->o.c_double);
-                pszDot = strchr(szBuffer, '.');
+                nSize = CPLsnprintf(pszBuffer, nBufferLen, szFormatting, dfVal);
+                pszDot = strchr(pszBuffer, '.');
                 if( pszDot != NULL &&
                     strstr(pszDot, "999999") == NULL && strstr(pszDot, "000000") == NULL )
                 {
@@ -1034,15 +1061,31 @@ static int OGR_json_double_with_significant_figures_to_string(struct json_object
             if( !bOK )
             {
                 CPLsnprintf(szFormatting, sizeof(szFormatting), "%%.%dg", nInitialSignificantFigures);
-                nSize = CPLsnprintf(szBuffer, sizeof(szBuffer), szFormatting, jso->o.c_double);
-                if( nSize+2 < (int)sizeof(szBuffer) && (pszDot = strchr(szBuffer, '.')) == NULL )
+                nSize = CPLsnprintf(pszBuffer, nBufferLen, szFormatting, dfVal);
+                if( nSize+2 < nBufferLen && (pszDot = strchr(pszBuffer, '.')) == NULL )
                 {
-                    nSize += CPLsnprintf(szBuffer + nSize, sizeof(szBuffer) - nSize, ".0");
+                    nSize += CPLsnprintf(pszBuffer + nSize, nBufferLen - nSize, ".0");
                 }
             }
         }
     }
 
+    return nSize;
+}
+
+/************************************************************************/
+/*             OGR_json_double_with_significant_figures_to_string()     */
+/************************************************************************/
+
+static int OGR_json_double_with_significant_figures_to_string(struct json_object *jso,
+                                                    struct printbuf *pb,
+                                                    CPL_UNUSED int level,
+                                                    CPL_UNUSED int flags)
+{
+    char szBuffer[75];
+    const int nSignificantFigures = (int) (size_t) jso->_userdata;
+    const int nSize = OGRGeoJSONFormatDoubleWithSignificantFigures(
+        szBuffer, sizeof(szBuffer), jso->o.c_double, nSignificantFigures );
     return printbuf_memappend(pb, szBuffer, nSize);
 }
 
@@ -1058,3 +1101,489 @@ json_object* json_object_new_double_with_significant_figures(double dfVal,
                                (void*)(size_t)nSignificantFigures, NULL );
     return jso;
 }
+
+/************************************************************************/
+/*                        OGRGeoJSONAppendString()                      */
+/*                                                                      */
+/*      Append a quoted string, escaped the same way as json-c.         */
+/************************************************************************/
+
+static void OGRGeoJSONAppendString( CPLString& osOut, const char* pszStr )
+{
+    static const char szHexChars[] = "0123456789abcdef";
+
+    osOut += '"';
+    const char* pszStart = pszStr;
+    for( ; *pszStr != '\0'; pszStr++ )
+    {
+        const unsigned char ch = static_cast<unsigned char>(*pszStr);
+        if( ch >= ' ' && ch != '"' && ch != '\\' && ch != '/' )
+            continue;
+
+        osOut.append(pszStart, pszStr - pszStart);
+        pszStart = pszStr + 1;
+        switch( ch )
+        {
+            case '\b': osOut += "\\b"; break;
+            case '\n': osOut += "\\n"; break;
+            case '\r': osOut += "\\r"; break;
+            case '\t': osOut += "\\t"; break;
+            case '\f': osOut += "\\f"; break;
+            case '"': osOut += "\\\""; break;
+            case '\\': osOut += "\\\\"; break;
+            case '/': osOut += "\\/"; break;
+            default:
+            {
+                const char szEscaped[] = { '\\', 'u', '0', '0',
+                                           szHexChars[ch >> 4],
+                                           szHexChars[ch & 0xf], '\0' };
+                osOut += szEscaped;
+                break;
+            }
+        }
+    }
+    osOut.append(pszStart, pszStr - pszStart);
+    osOut += '"';
+}
+
+/************************************************************************/
+/*                        OGRGeoJSONAppendInt64()                       */
+/************************************************************************/
+
+static void OGRGeoJSONAppendInt64( CPLString& osOut, GIntBig nVal )
+{
+    char szBuffer[32];
+    snprintf(szBuffer, sizeof(szBuffer), CPL_FRMT_GIB, nVal);
+    osOut += szBuffer;
+}
+
+/************************************************************************/
+/*                        OGRGeoJSONAppendDouble()                      */
+/*                                                                      */
+/*      Append a number formatted like the json-c serializers of        */
+/*      json_object_new_coord() (bCoord) or                             */
+/*      json_object_new_double_with_significant_figures().              */
+/************************************************************************/
+
+static void OGRGeoJSONAppendDouble( CPLString& osOut, double dfVal, bool bCoord,
+                                    int nCoordPrecision, int nSignificantFigures )
+{
+    char szBuffer[75];
+    int nSize;
+    if( bCoord && (nCoordPrecision >= 0 || nSignificantFigures < 0) )
+        nSize = OGRGeoJSONFormatDoubleWithPrecision(
+            szBuffer, sizeof(szBuffer), dfVal, nCoordPrecision );
+    else
+        nSize = OGRGeoJSONFormatDoubleWithSignificantFigures(
+            szBuffer, sizeof(szBuffer), dfVal, nSignificantFigures );
+    if( nSize < 0 || nSize >= static_cast<int>(sizeof(szBuffer)) )
+        nSize = static_cast<int>(strlen(szBuffer));
+    osOut.append(szBuffer, nSize);
+}
+
+/************************************************************************/
+/*                       OGRGeoJSONAppendPosition()                     */
+/************************************************************************/
+
+static bool OGRGeoJSONAppendPosition( CPLString& osOut,
+                                      double dfX, double dfY, double dfZ,
+                                      bool b3D, int nCoordPrecision,
+                                      int nSignificantFigures )
+{
+    /* Let the json-c writer emit the warning about it. */
+    if( CPLIsInf(dfX) || CPLIsInf(dfY) || CPLIsNan(dfX) || CPLIsNan(dfY) ||
+        (b3D && (CPLIsInf(dfZ) || CPLIsNan(dfZ))) )
+        return false;
+
+    osOut += "[ ";
+    OGRGeoJSONAppendDouble( osOut, dfX, true, nCoordPrecision, nSignificantFigures );
+    osOut += ", ";
+    OGRGeoJSONAppendDouble( osOut, dfY, true, nCoordPrecision, nSignificantFigures );
+    if( b3D )
+    {
+        osOut += ", ";
+        OGRGeoJSONAppendDouble( osOut, dfZ, true, nCoordPrecision, nSignificantFigures );
+    }
+    osOut += " ]";
+    return true;
+}
+
+/************************************************************************/
+/*                      OGRGeoJSONAppendPointCoords()                   */
+/************************************************************************/
+
+static bool OGRGeoJSONAppendPointCoords( CPLString& osOut, OGRPoint* poPoint,
+                                         int nCoordPrecision,
+                                         int nSignificantFigures )
+{
+    const int nDimension = poPoint->getCoordinateDimension();
+    if( nDimension != 2 && nDimension != 3 )
+        return false;
+    return OGRGeoJSONAppendPosition( osOut, poPoint->getX(), poPoint->getY(),
+                                     poPoint->getZ(), nDimension == 3,
+                                     nCoordPrecision, nSignificantFigures );
+}
+
+/************************************************************************/
+/*                       OGRGeoJSONAppendLineCoords()                   */
+/************************************************************************/
+
+static bool OGRGeoJSONAppendLineCoords( CPLString& osOut, OGRLineString* poLine,
+                                        int nCoordPrecision,
+                                        int nSignificantFigures )
+{
+    const int nCount = poLine->getNumPoints();
+    if( nCount == 0 )
+    {
+        osOut += "[ ]";
+        return true;
+    }
+
+    const bool b3D = poLine->getCoordinateDimension() != 2;
+    osOut += "[";
+    for( int i = 0; i < nCount; ++i )
+    {
+        osOut += (i == 0) ? " " : ", ";
+        if( !OGRGeoJSONAppendPosition( osOut, poLine->getX(i), poLine->getY(i),
+                                       b3D ? poLine->getZ(i) : 0.0, b3D,
+                                       nCoordPrecision, nSignificantFigures ) )
+            return false;
+    }
+    osOut += " ]";
+    return true;
+}
+
+/************************************************************************/
+/*                      OGRGeoJSONAppendPolygonCoords()                 */
+/************************************************************************/
+
+static bool OGRGeoJSONAppendPolygonCoords( CPLString& osOut, OGRPolygon* poPolygon,
+                                           int nCoordPrecision,
+                                           int nSignificantFigures )
+{
+    OGRLinearRing* poRing = poPolygon->getExteriorRing();
+    if( poRing == NULL )
+    {
+        osOut += "[ ]";
+        return true;
+    }
+
+    osOut += "[ ";
+    if( !OGRGeoJSONAppendLineCoords( osOut, poRing, nCoordPrecision,
+                                     nSignificantFigures ) )
+        return false;
+
+    const int nCount = poPolygon->getNumInteriorRings();
+    for( int i = 0; i < nCount; ++i )
+    {
+        poRing = poPolygon->getInteriorRing( i );
+        if( poRing == NULL )
+            continue;
+        osOut += ", ";
+        if( !OGRGeoJSONAppendLineCoords( osOut, poRing, nCoordPrecision,
+                                         nSignificantFigures ) )
+            return false;
+    }
+    osOut += " ]";
+    return true;
+}
+
+/************************************************************************/
+/*                        OGRGeoJSONAppendGeometry()                    */
+/*                                                                      */
+/*      Text equivalent of OGRGeoJSONWriteGeometry(). Returns false     */
+/*      for the cases that the json-c writer reports or handles in a    */
+/*      special way, with osOut left partially written.                 */
+/************************************************************************/
+
+static bool OGRGeoJSONAppendGeometry( CPLString& osOut, OGRGeometry* poGeometry,
+                                      int nCoordPrecision,
+                                      int nSignificantFigures )
+{
+    const OGRwkbGeometryType eType = poGeometry->getGeometryType();
+    if( (wkbPoint == eType || wkbPoint25D == eType) && poGeometry->IsEmpty() )
+    {
+        osOut += "null";
+        return true;
+    }
+
+    switch( eType )
+    {
+        case wkbPoint: case wkbPoint25D:
+        case wkbLineString: case wkbLineString25D:
+        case wkbPolygon: case wkbPolygon25D:
+        case wkbMultiPoint: case wkbMultiPoint25D:
+        case wkbMultiLineString: case wkbMultiLineString25D:
+        case wkbMultiPolygon: case wkbMultiPolygon25D:
+        case wkbGeometryCollection: case wkbGeometryCollection25D:
+            break;
+        default:
+            return false;
+    }
+
+    osOut += "{ \"type\": ";
+    OGRGeoJSONAppendString( osOut, OGRGeoJSONGetGeometryName( poGeometry ) );
+    osOut += (wkbGeometryCollection == eType ||
+              wkbGeometryCollection25D == eType) ? ", \"geometries\": "
+                                                 : ", \"coordinates\": ";
+
+    bool bRet = true;
+    if( wkbPoint == eType || wkbPoint25D == eType )
+    {
+        bRet = OGRGeoJSONAppendPointCoords( osOut,
+                    static_cast<OGRPoint*>(poGeometry),
+                    nCoordPrecision, nSignificantFigures );
+    }
+    else if( wkbLineString == eType || wkbLineString25D == eType )
+    {
+        bRet = OGRGeoJSONAppendLineCoords( osOut,
+                    static_cast<OGRLineString*>(poGeometry),
+                    nCoordPrecision, nSignificantFigures );
+    }
+    else if( wkbPolygon == eType || wkbPolygon25D == eType )
+    {
+        bRet = OGRGeoJSONAppendPolygonCoords( osOut,
+                    static_cast<OGRPolygon*>(poGeometry),
+                    nCoordPrecision, nSignificantFigures );
+    }
+    else
+    {
+        OGRGeometryCollection* poColl =
+            static_cast<OGRGeometryCollection*>(poGeometry);
+        const int nCount = poColl->getNumGeometries();
+        if( nCount == 0 )
+            osOut += "[ ]";
+        else
+        {
+            osOut += "[";
+            for( int i = 0; bRet && i < nCount; ++i )
+            {
+                osOut += (i == 0) ? " " : ", ";
+                OGRGeometry* poSubGeom = poColl->getGeometryRef( i );
+                if( wkbMultiPoint == eType || wkbMultiPoint25D == eType )
+                    bRet = OGRGeoJSONAppendPointCoords( osOut,
+                                static_cast<OGRPoint*>(poSubGeom),
+                                nCoordPrecision, nSignificantFigures );
+                else if( wkbMultiLineString == eType ||
+                         wkbMultiLineString25D == eType )
+                    bRet = OGRGeoJSONAppendLineCoords( osOut,
+                                static_cast<OGRLineString*>(poSubGeom),
+                                nCoordPrecision, nSignificantFigures );
+                else if( wkbMultiPolygon == eType ||
+                         wkbMultiPolygon25D == eType )
+                    bRet = OGRGeoJSONAppendPolygonCoords( osOut,
+                                static_cast<OGRPolygon*>(poSubGeom),
+                                nCoordPrecision, nSignificantFigures );
+                else
+                    bRet = OGRGeoJSONAppendGeometry( osOut, poSubGeom,
+                                nCoordPrecision, nSignificantFigures );
+            }
+            osOut += " ]";
+        }
+    }
+    osOut += " }";
+
+    return bRet;
+}
+
+/************************************************************************/
+/*                       OGRGeoJSONAppendAttributes()                   */
+/*                                                                      */
+/*      Text equivalent of OGRGeoJSONWriteAttributes().                 */
+/************************************************************************/
+
+static void OGRGeoJSONAppendAttributes( CPLString& osOut, OGRFeature* poFeature,
+                                        int nSignificantFigures )
+{
+    OGRFeatureDefn* poDefn = poFeature->GetDefnRef();
+    const int nFieldCount = poDefn->GetFieldCount();
+    if( nFieldCount == 0 )
+    {
+        osOut += "{ }";
+        return;
+    }
+
+    osOut += "{";
+    for( int nField = 0; nField < nFieldCount; ++nField )
+    {
+        OGRFieldDefn* poFieldDefn = poDefn->GetFieldDefn( nField );
+        const OGRFieldType eType = poFieldDefn->GetType();
+        const OGRFieldSubType eSubType = poFieldDefn->GetSubType();
+
+        osOut += (nField == 0) ? " " : ", ";
+        OGRGeoJSONAppendString( osOut, poFieldDefn->GetNameRef() );
+        osOut += ": ";
+
+        if( !poFeature->IsFieldSet(nField) )
+        {
+            osOut += "null";
+        }
+        else if( OFTInteger == eType || OFTInteger64 == eType )
+        {
+            const GIntBig nVal = poFeature->GetFieldAsInteger64( nField );
+            if( eSubType == OFSTBoolean )
+                osOut += static_cast<json_bool>(nVal) ? "true" : "false";
+            else
+                OGRGeoJSONAppendInt64( osOut, nVal );
+        }
+        else if( OFTReal == eType )
+        {
+            OGRGeoJSONAppendDouble( osOut, poFeature->GetFieldAsDouble(nField),
+                                    false, -1, nSignificantFigures );
+        }
+        else if( OFTString == eType )
+        {
+            const char* pszStr = poFeature->GetFieldAsString(nField);
+            const size_t nLen = strlen(pszStr);
+            json_object* poObjProp = NULL;
+            if( (pszStr[0] == '{' && pszStr[nLen-1] == '}') ||
+                (pszStr[0] == '[' && pszStr[nLen-1] == ']') )
+            {
+                OGRJSonParse(pszStr, &poObjProp, false);
+            }
+            if( poObjProp != NULL )
+            {
+                osOut += json_object_to_json_string( poObjProp );
+                json_object_put( poObjProp );
+            }
+            else
+                OGRGeoJSONAppendString( osOut, pszStr );
+        }
+        else if( OFTIntegerList == eType || OFTInteger64List == eType )
+        {
+            int nSize = 0;
+            const int* panList = NULL;
+            const GIntBig* panList64 = NULL;
+            if( OFTIntegerList == eType )
+                panList = poFeature->GetFieldAsIntegerList(nField, &nSize);
+            else
+                panList64 = poFeature->GetFieldAsInteger64List(nField, &nSize);
+            osOut += (nSize == 0) ? "[" : "[ ";
+            for( int i = 0; i < nSize; i++ )
+            {
+                if( i > 0 )
+                    osOut += ", ";
+                const GIntBig nVal = panList ? panList[i] : panList64[i];
+                if( eSubType == OFSTBoolean )
+                    osOut += static_cast<json_bool>(nVal) ? "true" : "false";
+                else
+                    OGRGeoJSONAppendInt64( osOut, nVal );
+            }
+            osOut += " ]";
+        }
+        else if( OFTRealList == eType )
+        {
+            int nSize = 0;
+            const double* padfList = poFeature->GetFieldAsDoubleList(nField, &nSize);
+            osOut += (nSize == 0) ? "[" : "[ ";
+            for( int i = 0; i < nSize; i++ )
+            {
+                if( i > 0 )
+                    osOut += ", ";
+                OGRGeoJSONAppendDouble( osOut, padfList[i], false, -1,
+                                        nSignificantFigures );
+            }
+            osOut += " ]";
+        }
+        else if( OFTStringList == eType )
+        {
+            char** papszStringList = poFeature->GetFieldAsStringList(nField);
+            const bool bEmpty = papszStringList == NULL ||
+                                papszStringList[0] == NULL;
+            osOut += bEmpty ? "[" : "[ ";
+            for( int i = 0; papszStringList && papszStringList[i]; i++ )
+            {
+                if( i > 0 )
+                    osOut += ", ";
+                OGRGeoJSONAppendString( osOut, papszStringList[i] );
+            }
+            osOut += " ]";
+        }
+        else
+        {
+            OGRGeoJSONAppendString( osOut, poFeature->GetFieldAsString(nField) );
+        }
+    }
+    osOut += " }";
+}
+
+/************************************************************************/
+/*                        OGRGeoJSONWriteFeatureText()                  */
+/************************************************************************/
+
+/**
+ * Append the GeoJSON text of a feature to osOut, without building a json-c
+ * tree. The text is identical to the serialization of the object returned
+ * by OGRGeoJSONWriteFeature().
+ *
+ * Returns false, with osOut unchanged, for features that must go through
+ * OGRGeoJSONWriteFeature(): features with GeoJSON native data, and
+ * geometries with non finite coordinates or of a type without a GeoJSON
+ * equivalent.
+ */
+
+bool OGRGeoJSONWriteFeatureText( CPLString& osOut, OGRFeature* poFeature,
+                                 int bWriteBBOX, int nCoordPrecision,
+                                 int nSignificantFigures )
+{
+    CPLAssert( NULL != poFeature );
+
+    const char* pszNativeMediaType = poFeature->GetNativeMediaType();
+    if( pszNativeMediaType &&
+        EQUAL(pszNativeMediaType, "application/vnd.geo+json") )
+        return false;
+
+    const size_t nInitialSize = osOut.size();
+
+    osOut += "{ \"type\": \"Feature\"";
+
+    if( poFeature->GetFID() != OGRNullFID )
+    {
+        osOut += ", \"id\": ";
+        OGRGeoJSONAppendInt64( osOut, poFeature->GetFID() );
+    }
+
+    osOut += ", \"properties\": ";
+    OGRGeoJSONAppendAttributes( osOut, poFeature, nSignificantFigures );
+
+    OGRGeometry* poGeometry = poFeature->GetGeometryRef();
+    if( NULL != poGeometry && bWriteBBOX && !poGeometry->IsEmpty() )
+    {
+        OGREnvelope3D sEnvelope;
+        poGeometry->getEnvelope(&sEnvelope);
+        const bool b3D = poGeometry->getCoordinateDimension() == 3;
+
+        osOut += ", \"bbox\": [ ";
+        OGRGeoJSONAppendDouble( osOut, sEnvelope.MinX, true, nCoordPrecision, nSignificantFigures );
+        osOut += ", ";
+        OGRGeoJSONAppendDouble( osOut, sEnvelope.MinY, true, nCoordPrecision, nSignificantFigures );
+        if( b3D )
+        {
+            osOut += ", ";
+            OGRGeoJSONAppendDouble( osOut, sEnvelope.MinZ, true, nCoordPrecision, nSignificantFigures );
+        }
+        osOut += ", ";
+        OGRGeoJSONAppendDouble( osOut, sEnvelope.MaxX, true, nCoordPrecision, nSignificantFigures );
+        osOut += ", ";
+        OGRGeoJSONAppendDouble( osOut, sEnvelope.MaxY, true, nCoordPrecision, nSignificantFigures );
+        if( b3D )
+        {
+            osOut += ", ";
+            OGRGeoJSONAppendDouble( osOut, sEnvelope.MaxZ, true, nCoordPrecision, nSignificantFigures );
+        }
+        osOut += " ]";
+    }
+
+    osOut += ", \"geometry\": ";
+    if( NULL == poGeometry )
+        osOut += "null";
+    else if( !OGRGeoJSONAppendGeometry( osOut, poGeometry, nCoordPrecision,
+                                        nSignificantFigures ) )
+    {
+        osOut.resize( nInitialSize );
+        return false;
+    }
+
+    osOut += " }";
+    return true;
+}
@@ -37,6 +37,7 @@
 /*                         FORWARD DECLARATIONS                         */
 /************************************************************************/
 #ifdef __cplusplus
+class CPLString;
 class OGRFeature;
 class OGRGeometry;
 class OGRPoint;
@@ -76,6 +77,12 @@ json_object* OGRGeoJSONWriteGeometryCollection( OGRGeometryCollection* poGeometr
 json_object* OGRGeoJSONWriteCoords( double const& fX, double const& fY, int nCoordPrecision, int nSignificantFigures );
 json_object* OGRGeoJSONWriteCoords( double const& fX, double const& fY, double const& fZ, int nCoordPrecision, int nSignificantFigures );
 json_object* OGRGeoJSONWriteLineCoords( OGRLineString* poLine, int nCoordPrecision, int nSignificantFigures );
+
+/************************************************************************/
+/*                 GeoJSON Direct Text Writer                           */
+/************************************************************************/
+
+bool OGRGeoJSONWriteFeatureText( CPLString& osOut, OGRFeature* poFeature, int bWriteBBOX, int nCoordPrecision, int nSignificantFigures );
 #endif
 
 #endif /* OGR_GEOJSONWRITER_H_INCLUDED */
@@ -510,6 +510,7 @@ OGRErr OGRPLScenesLayer::SetAttributeFilter( const char *pszQuery )
         swq_expr_node* poNode = (swq_expr_node*) m_poAttrQuery->GetSWQExpr();
 
         poNode->ReplaceBetweenByGEAndLERecurse();
+        m_poAttrQuery->ResetProgram();
 
         if( poNode->eNodeType == SNT_OPERATION &&
             poNode->nOperation == SWQ_EQ && poNode->nSubExprCount == 2 &&
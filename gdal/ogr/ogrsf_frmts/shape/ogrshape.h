@@ -36,6 +36,7 @@
 #include "shapefil.h"
 #include "shp_vsi.h"
 #include "ogrlayerpool.h"
+#include "cpl_virtualmem.h"
 #include <vector>
 
 /* Was limited to 255 until OGR 1.10, but 254 seems to be a more */
@@ -88,6 +89,41 @@ class OGRShapeGeomFieldDefn CPL_FINAL: public OGRGeomFieldDefn
         const CPLString& GetPrjFilename() { return osPrjFile; }
 };
 
+/************************************************************************/
+/*                            OGRShapeRTree                             */
+/*                                                                      */
+/*      Packed Hilbert R-tree spatial index, stored in a .rtx file.     */
+/************************************************************************/
+
+class OGRShapeRTree
+{
+    VSILFILE           *fp;
+    CPLVirtualMem      *psVirtualMem;
+    GByte              *pabyData;
+
+    int                 nNodeSize;
+    int                 nItemCount;
+    int                 nNodeCount;
+    int                 nLevelCount;
+    int                 nShapeCount;
+
+    const double       *padfBoxes;
+    const GUInt32      *panIndices;
+    const GUInt32      *panLevelEnds;
+
+                        OGRShapeRTree();
+
+  public:
+                       ~OGRShapeRTree();
+
+    static OGRShapeRTree *Open( const char *pszFilename, SHPHandle hSHP );
+    static bool         Build( const char *pszFilename, SHPHandle hSHP,
+                               int nNodeSize );
+
+    int                *Search( const OGREnvelope& sEnvelope,
+                                int *pnCount ) const;
+};
+
 /************************************************************************/
 /*                            OGRShapeLayer                             */
 /************************************************************************/
@@ -134,6 +170,10 @@ class OGRShapeLayer CPL_FINAL: public OGRAbstractProxiedLayer
     SBNSearchHandle     hSBN;
     int                 CheckForSBN();
 
+    int                 bCheckedForRTree;
+    OGRShapeRTree      *poRTree;
+    int                 CheckForRTree();
+
     int                 bSbnSbxDeleted;
 
     CPLString           ConvertCodePage( const char * );
@@ -164,6 +204,7 @@ class OGRShapeLayer CPL_FINAL: public OGRAbstractProxiedLayer
 
   public:
     OGRErr              CreateSpatialIndex( int nMaxDepth );
+    OGRErr              CreateRTreeSpatialIndex();
     OGRErr              DropSpatialIndex();
     OGRErr              Repack();
     OGRErr              RecomputeExtent();
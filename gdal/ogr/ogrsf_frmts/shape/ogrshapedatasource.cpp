@@ -916,7 +916,7 @@ OGRLayer *OGRShapeDataSource::GetLayerByName(const char * pszLayerNameIn)
 /*      We override this to provide special handling of CREATE          */
 /*      SPATIAL INDEX commands.  Support forms are:                     */
 /*                                                                      */
-/*        CREATE SPATIAL INDEX ON layer_name [DEPTH n]                  */
+/*        CREATE SPATIAL INDEX ON layer_name [DEPTH n | TYPE RTREE]     */
 /*        DROP SPATIAL INDEX ON layer_name                              */
 /*        REPACK layer_name                                             */
 /*        RECOMPUTE EXTENT ON layer_name                                */
@@ -1042,14 +1042,16 @@ OGRLayer * OGRShapeDataSource::ExecuteSQL( const char *pszStatement,
         || !EQUAL(papszTokens[2],"INDEX")
         || !EQUAL(papszTokens[3],"ON")
         || CSLCount(papszTokens) > 7
-        || (CSLCount(papszTokens) == 7 && !EQUAL(papszTokens[5],"DEPTH")) )
+        || (CSLCount(papszTokens) == 7 && !EQUAL(papszTokens[5],"DEPTH")
+            && !(EQUAL(papszTokens[5],"TYPE")
+                 && (EQUAL(papszTokens[6],"QIX") || EQUAL(papszTokens[6],"RTREE")))) )
     {
         CSLDestroy( papszTokens );
         CPLError( CE_Failure, CPLE_AppDefined,
                   "Syntax error in CREATE SPATIAL INDEX command.\n"
                   "Was '%s'\n"
                   "Should be of form 'CREATE SPATIAL INDEX ON <table> "
-                  "[DEPTH <n>]'",
+                  "[DEPTH <n> | TYPE {QIX|RTREE}]'",
                   pszStatement );
         return NULL;
     }
@@ -1058,8 +1060,11 @@ OGRLayer * OGRShapeDataSource::ExecuteSQL( const char *pszStatement,
 /*      Get depth if provided.                                          */
 /* -------------------------------------------------------------------- */
     int nDepth = 0;
-    if( CSLCount(papszTokens) == 7 )
+    bool bRTree = false;
+    if( CSLCount(papszTokens) == 7 && EQUAL(papszTokens[5],"DEPTH") )
         nDepth = atoi(papszTokens[6]);
+    else if( CSLCount(papszTokens) == 7 )
+        bRTree = EQUAL(papszTokens[6],"RTREE");
 
 /* -------------------------------------------------------------------- */
 /*      What layer are we operating on.                                 */
@@ -1077,7 +1082,10 @@ OGRLayer * OGRShapeDataSource::ExecuteSQL( const char *pszStatement,
 
     CSLDestroy( papszTokens );
 
-    poLayer->CreateSpatialIndex( nDepth );
+    if( bRTree )
+        poLayer->CreateRTreeSpatialIndex();
+    else
+        poLayer->CreateSpatialIndex( nDepth );
     return NULL;
 }
 
@@ -1129,6 +1137,7 @@ OGRErr OGRShapeDataSource::DeleteLayer( int iLayer )
     VSIUnlink( CPLResetExtension(pszFilename, "dbf") );
     VSIUnlink( CPLResetExtension(pszFilename, "prj") );
     VSIUnlink( CPLResetExtension(pszFilename, "qix") );
+    VSIUnlink( CPLResetExtension(pszFilename, "rtx") );
 
     CPLFree( pszFilename );
 
@@ -204,7 +204,7 @@ static CPLErr OGRShapeDriverDelete( const char *pszDataSource )
     VSIStatBufL sStatBuf;
     static const char * const apszExtensions[] =
         { "shp", "shx", "dbf", "sbn", "sbx", "prj", "idm", "ind",
-          "qix", "cpg", NULL };
+          "qix", "rtx", "cpg", NULL };
 
     if( VSIStatL( pszDataSource, &sStatBuf ) != 0 )
     {
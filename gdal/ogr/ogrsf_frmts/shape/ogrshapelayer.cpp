@@ -71,6 +71,8 @@ OGRShapeLayer::OGRShapeLayer( OGRShapeDataSource* poDSIn,
     hQIX(NULL),
     bCheckedForSBN(FALSE),
     hSBN(NULL),
+    bCheckedForRTree(FALSE),
+    poRTree(NULL),
     bSbnSbxDeleted(FALSE),
     bTruncationWarningEmitted(FALSE),
     eFileDescriptorsState(FD_OPENED),
@@ -253,6 +255,8 @@ OGRShapeLayer::~OGRShapeLayer()
 
     if( hSBN != NULL )
         SBNCloseDiskTree( hSBN );
+
+    delete poRTree;
 }
 
 
@@ -433,6 +437,28 @@ int OGRShapeLayer::CheckForSBN()
     return hSBN != NULL;
 }
 
+/************************************************************************/
+/*                           CheckForRTree()                            */
+/************************************************************************/
+
+int OGRShapeLayer::CheckForRTree()
+
+{
+    if( bCheckedForRTree )
+        return poRTree != NULL;
+
+    if( hSHP == NULL )
+        return FALSE;
+
+    const char *pszRTreeFilename = CPLResetExtension( pszFullName, "rtx" );
+
+    poRTree = OGRShapeRTree::Open( pszRTreeFilename, hSHP );
+
+    bCheckedForRTree = TRUE;
+
+    return poRTree != NULL;
+}
+
 /************************************************************************/
 /*                            ScanIndices()                             */
 /*                                                                      */
@@ -495,16 +521,29 @@ int OGRShapeLayer::ScanIndices()
 
     if( bTryQIXorSBN )
     {
-        if( !bCheckedForQIX )
+        if( !bCheckedForRTree )
+            CPL_IGNORE_RET_VAL(CheckForRTree());
+        if( poRTree == NULL && !bCheckedForQIX )
             CPL_IGNORE_RET_VAL(CheckForQIX());
-        if( hQIX == NULL && !bCheckedForSBN )
+        if( poRTree == NULL && hQIX == NULL && !bCheckedForSBN )
             CPL_IGNORE_RET_VAL(CheckForSBN());
     }
 
 /* -------------------------------------------------------------------- */
 /*      Compute spatial index if appropriate.                           */
 /* -------------------------------------------------------------------- */
-    if( bTryQIXorSBN && (hQIX != NULL || hSBN != NULL) && panSpatialFIDs == NULL )
+    if( bTryQIXorSBN && poRTree != NULL && panSpatialFIDs == NULL )
+    {
+        panSpatialFIDs = poRTree->Search( oSpatialFilterEnvelope,
+                                          &nSpatialFIDCount );
+
+        CPLDebug( "SHAPE", "Used R-tree spatial index, got %d matches.",
+                  nSpatialFIDCount );
+
+        delete m_poFilterGeomLastValid;
+        m_poFilterGeomLastValid = m_poFilterGeom->clone();
+    }
+    else if( bTryQIXorSBN && (hQIX != NULL || hSBN != NULL) && panSpatialFIDs == NULL )
     {
         double adfBoundsMin[4], adfBoundsMax[4];
 
@@ -905,7 +944,7 @@ OGRErr OGRShapeLayer::ISetFeature( OGRFeature *poFeature )
     }
 
     bHeaderDirty = TRUE;
-    if( CheckForQIX() || CheckForSBN() )
+    if( CheckForQIX() || CheckForSBN() || CheckForRTree() )
         DropSpatialIndex();
 
     unsigned int nOffset = 0;
@@ -975,7 +1014,7 @@ OGRErr OGRShapeLayer::DeleteFeature( GIntBig nFID )
         return OGRERR_FAILURE;
 
     bHeaderDirty = TRUE;
-    if( CheckForQIX() || CheckForSBN() )
+    if( CheckForQIX() || CheckForSBN() || CheckForRTree() )
         DropSpatialIndex();
 
     return OGRERR_NONE;
@@ -1008,7 +1047,7 @@ OGRErr OGRShapeLayer::ICreateFeature( OGRFeature *poFeature )
     }
 
     bHeaderDirty = TRUE;
-    if( CheckForQIX() || CheckForSBN() )
+    if( CheckForQIX() || CheckForSBN() || CheckForRTree() )
         DropSpatialIndex();
 
     poFeature->SetFID( OGRNullFID );
@@ -1474,7 +1513,8 @@ int OGRShapeLayer::TestCapability( const char * pszCap )
 
     else if( EQUAL(pszCap,OLCFastFeatureCount) )
     {
-        if( !(m_poFilterGeom == NULL || CheckForQIX() || CheckForSBN()) )
+        if( !(m_poFilterGeom == NULL || CheckForRTree() || CheckForQIX() ||
+              CheckForSBN()) )
             return FALSE;
 
         if( m_poAttrQuery != NULL )
@@ -1489,7 +1529,7 @@ int OGRShapeLayer::TestCapability( const char * pszCap )
         return bUpdateAccess;
 
     else if( EQUAL(pszCap,OLCFastSpatialFilter) )
-        return CheckForQIX() || CheckForSBN();
+        return CheckForRTree() || CheckForQIX() || CheckForSBN();
 
     else if( EQUAL(pszCap,OLCFastGetExtent) )
         return TRUE;
@@ -2140,7 +2180,7 @@ OGRErr OGRShapeLayer::DropSpatialIndex()
     if (!TouchLayer())
         return OGRERR_FAILURE;
 
-    if( !CheckForQIX() && !CheckForSBN() )
+    if( !CheckForQIX() && !CheckForSBN() && !CheckForRTree() )
     {
         CPLError( CE_Warning, CPLE_AppDefined,
                   "Layer %s has no spatial index, DROP SPATIAL INDEX failed.",
@@ -2149,6 +2189,7 @@ OGRErr OGRShapeLayer::DropSpatialIndex()
     }
 
     int bHadQIX = hQIX != NULL;
+    int bHadRTree = poRTree != NULL;
 
     SHPCloseDiskTree( hQIX );
     hQIX = NULL;
@@ -2158,6 +2199,24 @@ OGRErr OGRShapeLayer::DropSpatialIndex()
     hSBN = NULL;
     bCheckedForSBN = FALSE;
 
+    delete poRTree;
+    poRTree = NULL;
+    bCheckedForRTree = FALSE;
+
+    if( bHadRTree )
+    {
+        const char *pszRTreeFilename = CPLResetExtension( pszFullName, "rtx" );
+        CPLDebug( "SHAPE", "Unlinking index file %s", pszRTreeFilename );
+
+        if( VSIUnlink( pszRTreeFilename ) != 0 )
+        {
+            CPLError( CE_Failure, CPLE_AppDefined,
+                    "Failed to delete file %s.\n%s",
+                    pszRTreeFilename, VSIStrerror( errno ) );
+            return OGRERR_FAILURE;
+        }
+    }
+
     if( bHadQIX )
     {
         const char *pszQIXFilename;
@@ -2212,7 +2271,7 @@ OGRErr OGRShapeLayer::CreateSpatialIndex( int nMaxDepth )
 /* -------------------------------------------------------------------- */
 /*      If we have an existing spatial index, blow it away first.       */
 /* -------------------------------------------------------------------- */
-    if( CheckForQIX() )
+    if( CheckForQIX() || CheckForRTree() )
         DropSpatialIndex();
 
     bCheckedForQIX = FALSE;
@@ -2263,6 +2322,41 @@ OGRErr OGRShapeLayer::CreateSpatialIndex( int nMaxDepth )
     return OGRERR_NONE;
 }
 
+/************************************************************************/
+/*                      CreateRTreeSpatialIndex()                       */
+/************************************************************************/
+
+OGRErr OGRShapeLayer::CreateRTreeSpatialIndex()
+
+{
+    if (!TouchLayer())
+        return OGRERR_FAILURE;
+
+/* -------------------------------------------------------------------- */
+/*      If we have an existing spatial index, blow it away first.       */
+/* -------------------------------------------------------------------- */
+    if( CheckForQIX() || CheckForRTree() )
+        DropSpatialIndex();
+
+    bCheckedForRTree = FALSE;
+
+/* -------------------------------------------------------------------- */
+/*      Bulk load the tree into the .rtx file.                          */
+/* -------------------------------------------------------------------- */
+    SyncToDisk();
+
+    const CPLString osRTreeFilename = CPLResetExtension( pszFullName, "rtx" );
+
+    CPLDebug( "SHAPE", "Creating index file %s", osRTreeFilename.c_str() );
+
+    if( !OGRShapeRTree::Build( osRTreeFilename, hSHP, 16 ) )
+        return OGRERR_FAILURE;
+
+    CheckForRTree();
+
+    return OGRERR_NONE;
+}
+
 /************************************************************************/
 /*                            CopyInPlace()                             */
 /************************************************************************/
@@ -2508,7 +2602,7 @@ OGRErr OGRShapeLayer::Repack()
 /*      Cleanup any existing spatial index.  It will become             */
 /*      meaningless when the fids change.                               */
 /* -------------------------------------------------------------------- */
-    if( CheckForQIX() || CheckForSBN() )
+    if( CheckForQIX() || CheckForSBN() || CheckForRTree() )
         DropSpatialIndex();
 
 /* -------------------------------------------------------------------- */
@@ -3238,6 +3332,10 @@ void OGRShapeLayer::CloseUnderlyingLayer()
     hSBN = NULL;
     bCheckedForSBN = FALSE;
 
+    delete poRTree;
+    poRTree = NULL;
+    bCheckedForRTree = FALSE;
+
     eFileDescriptorsState = FD_CLOSED;
 }
 
@@ -3278,6 +3376,11 @@ void OGRShapeLayer::AddToFileList( CPLStringList& oFileList )
                 (OGRShapeGeomFieldDefn*)GetLayerDefn()->GetGeomFieldDefn(0);
             oFileList.AddString(poGeomFieldDefn->GetPrjFilename());
         }
+        if( CheckForRTree() )
+        {
+            const char* pszRTreeFilename = CPLResetExtension( pszFullName, "rtx" );
+            oFileList.AddString(pszRTreeFilename);
+        }
         if( CheckForQIX() )
         {
             const char* pszQIXFilename = CPLResetExtension( pszFullName, "qix" );
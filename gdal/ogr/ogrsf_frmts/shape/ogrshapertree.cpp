@@ -0,0 +1,639 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Project:  OpenGIS Simple Features Reference Implementation
+ * Purpose:  Implements OGRShapeRTree class, a packed Hilbert R-tree stored
+ *           in a .rtx file next to the .shp.
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+/*
+ * The tree is bulk loaded: the bounding boxes of the shapes are sorted by
+ * the Hilbert value of their center, and grouped by RTX_NODE_SIZE into
+ * nodes, themselves grouped into parent nodes until a single root remains.
+ * All the nodes are then stored level after level, leaves first, which
+ * needs no pointer other than the position of the first child of a node.
+ *
+ * File layout, all values little endian:
+ *
+ *   0  char[8]     "SHPRTREE"
+ *   8  int32       version (1)
+ *  12  int32       node size
+ *  16  int32       item count (shapes with a bounding box)
+ *  20  int32       node count, items included
+ *  24  int32       level count, items level included
+ *  28  int32       record count of the .shp when the index was built
+ *  32  uint32      size of the .shp when the index was built
+ *  36  int32       reserved (0)
+ *  40  double[4*node count]  minx, miny, maxx, maxy of each node
+ *  ..  uint32[node count]    shape id for items, first child for nodes
+ *  ..  uint32[level count]   index of the end of each level
+ *
+ * The index is ignored when the record count or size of the .shp do not
+ * match anymore.
+ */
+
+#include "ogrshape.h"
+#include "cpl_virtualmem.h"
+
+#include <algorithm>
+
+CPL_CVSID("$Id$");
+
+#define RTX_SIGNATURE     "SHPRTREE"
+#define RTX_VERSION       1
+#define RTX_HEADER_SIZE   40
+#define RTX_MAX_LEVELS    64
+
+/************************************************************************/
+/*                          OGRShapeRTreeItem                           */
+/************************************************************************/
+
+struct OGRShapeRTreeItem
+{
+    GUInt32 nHilbert;
+    GUInt32 nShapeId;
+    double  adfBox[4];
+
+    bool operator< (const OGRShapeRTreeItem& other) const
+    {
+        if( nHilbert != other.nHilbert )
+            return nHilbert < other.nHilbert;
+        return nShapeId < other.nShapeId;
+    }
+};
+
+/************************************************************************/
+/*                        OGRShapeRTreeHilbert()                        */
+/*                                                                      */
+/*      Position along the Hilbert curve of a point of a 65536x65536    */
+/*      grid, computed without loop (from "Fast Hilbert curve           */
+/*      generation, sorting, and range queries", rawrunprotected,       */
+/*      public domain).                                                 */
+/************************************************************************/
+
+static GUInt32 OGRShapeRTreeHilbert( GUInt32 x, GUInt32 y )
+{
+    GUInt32 a = x ^ y;
+    GUInt32 b = 0xFFFF ^ a;
+    GUInt32 c = 0xFFFF ^ (x | y);
+    GUInt32 d = x & (y ^ 0xFFFF);
+
+    GUInt32 A = a | (b >> 1);
+    GUInt32 B = (a >> 1) ^ a;
+    GUInt32 C = ((c >> 1) ^ (b & (d >> 1))) ^ c;
+    GUInt32 D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+    a = A; b = B; c = C; d = D;
+    A = ((a & (a >> 2)) ^ (b & (b >> 2)));
+    B = ((a & (b >> 2)) ^ (b & ((a ^ b) >> 2)));
+    C ^= ((a & (c >> 2)) ^ (b & (d >> 2)));
+    D ^= ((b & (c >> 2)) ^ ((a ^ b) & (d >> 2)));
+
+    a = A; b = B; c = C; d = D;
+    A = ((a & (a >> 4)) ^ (b & (b >> 4)));
+    B = ((a & (b >> 4)) ^ (b & ((a ^ b) >> 4)));
+    C ^= ((a & (c >> 4)) ^ (b & (d >> 4)));
+    D ^= ((b & (c >> 4)) ^ ((a ^ b) & (d >> 4)));
+
+    a = A; b = B; c = C; d = D;
+    C ^= ((a & (c >> 8)) ^ (b & (d >> 8)));
+    D ^= ((b & (c >> 8)) ^ ((a ^ b) & (d >> 8)));
+
+    a = C ^ (C >> 1);
+    b = D ^ (D >> 1);
+
+    GUInt32 i0 = x ^ y;
+    GUInt32 i1 = b | (0xFFFF ^ (i0 | a));
+
+    i0 = (i0 | (i0 << 8)) & 0x00FF00FF;
+    i0 = (i0 | (i0 << 4)) & 0x0F0F0F0F;
+    i0 = (i0 | (i0 << 2)) & 0x33333333;
+    i0 = (i0 | (i0 << 1)) & 0x55555555;
+
+    i1 = (i1 | (i1 << 8)) & 0x00FF00FF;
+    i1 = (i1 | (i1 << 4)) & 0x0F0F0F0F;
+    i1 = (i1 | (i1 << 2)) & 0x33333333;
+    i1 = (i1 | (i1 << 1)) & 0x55555555;
+
+    return (i1 << 1) | i0;
+}
+
+/************************************************************************/
+/*                           OGRShapeRTree()                            */
+/************************************************************************/
+
+OGRShapeRTree::OGRShapeRTree() :
+    fp(NULL),
+    psVirtualMem(NULL),
+    pabyData(NULL),
+    nNodeSize(0),
+    nItemCount(0),
+    nNodeCount(0),
+    nLevelCount(0),
+    nShapeCount(0),
+    padfBoxes(NULL),
+    panIndices(NULL),
+    panLevelEnds(NULL)
+{
+}
+
+/************************************************************************/
+/*                           ~OGRShapeRTree()                           */
+/************************************************************************/
+
+OGRShapeRTree::~OGRShapeRTree()
+{
+    if( psVirtualMem != NULL )
+        CPLVirtualMemFree( psVirtualMem );
+    else
+        VSIFree( pabyData );
+    if( fp != NULL )
+        VSIFCloseL( fp );
+}
+
+/************************************************************************/
+/*                                Open()                                */
+/*                                                                      */
+/*      Returns NULL if the file does not exist, is invalid, or does    */
+/*      not match the current content of the .shp.                      */
+/************************************************************************/
+
+OGRShapeRTree *OGRShapeRTree::Open( const char *pszFilename, SHPHandle hSHP )
+{
+    VSILFILE* fp = VSIFOpenL( pszFilename, "rb" );
+    if( fp == NULL )
+        return NULL;
+
+    GByte abyHeader[RTX_HEADER_SIZE];
+    GInt32 anHeader[7];
+    if( VSIFReadL( abyHeader, 1, RTX_HEADER_SIZE, fp ) != RTX_HEADER_SIZE ||
+        memcmp( abyHeader, RTX_SIGNATURE, 8 ) != 0 )
+    {
+        CPLError( CE_Warning, CPLE_AppDefined,
+                  "%s is not a shapefile R-tree index.", pszFilename );
+        VSIFCloseL( fp );
+        return NULL;
+    }
+    for( int i = 0; i < 7; i++ )
+    {
+        memcpy( &anHeader[i], abyHeader + 8 + 4 * i, 4 );
+        CPL_LSBPTR32( &anHeader[i] );
+    }
+    GUInt32 nSHPFileSize;
+    memcpy( &nSHPFileSize, abyHeader + 32, 4 );
+    CPL_LSBPTR32( &nSHPFileSize );
+
+    const int nVersion = anHeader[0];
+    const int nNodeSize = anHeader[1];
+    const int nItemCount = anHeader[2];
+    const int nNodeCount = anHeader[3];
+    const int nLevelCount = anHeader[4];
+    const int nShapeCount = anHeader[5];
+
+    VSIFSeekL( fp, 0, SEEK_END );
+    const vsi_l_offset nFileSize = VSIFTellL( fp );
+    const vsi_l_offset nExpectedSize = RTX_HEADER_SIZE +
+        static_cast<vsi_l_offset>(nNodeCount) * (4 * sizeof(double) + 4) +
+        static_cast<vsi_l_offset>(nLevelCount) * 4;
+    if( nVersion != RTX_VERSION || nNodeSize < 2 || nItemCount < 0 ||
+        nNodeCount < nItemCount || nLevelCount < 0 ||
+        nLevelCount > RTX_MAX_LEVELS ||
+        /* An empty tree has no node at all, and a non empty one has at */
+        /* least the items level and the root level */
+        (nItemCount == 0 && (nNodeCount != 0 || nLevelCount != 0)) ||
+        (nItemCount > 0 && nLevelCount < 2) ||
+        nFileSize != nExpectedSize ||
+        static_cast<size_t>(nFileSize) != nFileSize )
+    {
+        CPLError( CE_Warning, CPLE_AppDefined,
+                  "%s is a corrupted or unsupported shapefile R-tree index.",
+                  pszFilename );
+        VSIFCloseL( fp );
+        return NULL;
+    }
+
+    if( nShapeCount != hSHP->nRecords || nSHPFileSize != hSHP->nFileSize )
+    {
+        CPLDebug( "SHAPE", "%s does not match the .shp anymore. Ignoring it.",
+                  pszFilename );
+        VSIFCloseL( fp );
+        return NULL;
+    }
+
+    OGRShapeRTree* poTree = new OGRShapeRTree();
+    poTree->fp = fp;
+    poTree->nNodeSize = nNodeSize;
+    poTree->nItemCount = nItemCount;
+    poTree->nNodeCount = nNodeCount;
+    poTree->nLevelCount = nLevelCount;
+    poTree->nShapeCount = nShapeCount;
+
+/* -------------------------------------------------------------------- */
+/*      Map the file in memory when possible, otherwise read it.        */
+/* -------------------------------------------------------------------- */
+#ifdef CPL_LSB
+    if( CPLIsVirtualMemFileMapAvailable() &&
+        VSIFGetNativeFileDescriptorL( fp ) != NULL &&
+        CPLTestBool( CPLGetConfigOption( "SHAPE_RTREE_USE_MMAP", "YES" ) ) )
+    {
+        poTree->psVirtualMem = CPLVirtualMemFileMapNew(
+            fp, 0, nFileSize, VIRTUALMEM_READONLY, NULL, NULL );
+        if( poTree->psVirtualMem != NULL )
+            poTree->pabyData = static_cast<GByte*>(
+                CPLVirtualMemGetAddr( poTree->psVirtualMem ) );
+    }
+#endif
+    if( poTree->pabyData == NULL )
+    {
+        poTree->pabyData = static_cast<GByte*>(
+            VSI_MALLOC_VERBOSE( static_cast<size_t>(nFileSize) ) );
+        if( poTree->pabyData == NULL ||
+            VSIFSeekL( fp, 0, SEEK_SET ) != 0 ||
+            VSIFReadL( poTree->pabyData, 1, static_cast<size_t>(nFileSize),
+                       fp ) != nFileSize )
+        {
+            delete poTree;
+            return NULL;
+        }
+#ifdef CPL_MSB
+        GByte* pabyIter = poTree->pabyData + RTX_HEADER_SIZE;
+        for( int i = 0; i < 4 * nNodeCount; i++, pabyIter += 8 )
+            CPL_SWAP64PTR( pabyIter );
+        for( int i = 0; i < nNodeCount + nLevelCount; i++, pabyIter += 4 )
+            CPL_SWAP32PTR( pabyIter );
+#endif
+    }
+
+    poTree->padfBoxes =
+        reinterpret_cast<const double*>(poTree->pabyData + RTX_HEADER_SIZE);
+    poTree->panIndices =
+        reinterpret_cast<const GUInt32*>(poTree->padfBoxes + 4 * nNodeCount);
+    poTree->panLevelEnds = poTree->panIndices + nNodeCount;
+
+/* -------------------------------------------------------------------- */
+/*      Check the level structure, that the search relies on.           */
+/* -------------------------------------------------------------------- */
+    for( int i = 0; i < nLevelCount; i++ )
+    {
+        const GUInt32 nPrevEnd = (i == 0) ? 0 : poTree->panLevelEnds[i-1];
+        if( poTree->panLevelEnds[i] <= nPrevEnd ||
+            (i == 0 && poTree->panLevelEnds[i] !=
+                            static_cast<GUInt32>(nItemCount)) ||
+            (i == nLevelCount - 1 && poTree->panLevelEnds[i] !=
+                            static_cast<GUInt32>(nNodeCount)) )
+        {
+            CPLError( CE_Warning, CPLE_AppDefined,
+                      "%s is a corrupted shapefile R-tree index.",
+                      pszFilename );
+            delete poTree;
+            return NULL;
+        }
+    }
+
+    CPLDebug( "SHAPE", "Opened %s: %d items, %d levels%s.", pszFilename,
+              nItemCount, nLevelCount,
+              poTree->psVirtualMem ? ", memory mapped" : "" );
+
+    return poTree;
+}
+
+/************************************************************************/
+/*                               Search()                               */
+/*                                                                      */
+/*      Returns the ids of the shapes whose bounding box intersects     */
+/*      the envelope, in increasing order, so in the order of their     */
+/*      records in the .shp for files written sequentially. The list    */
+/*      is allocated with malloc(), and never NULL except if out of     */
+/*      memory.                                                         */
+/************************************************************************/
+
+int *OGRShapeRTree::Search( const OGREnvelope& sEnvelope, int *pnCount ) const
+{
+    std::vector<int> anResults;
+    std::vector<GUInt32> anStack;
+
+    /* Start from the root, alone in the last level */
+    GUInt32 iGroup = static_cast<GUInt32>(nNodeCount) - 1;
+    bool bContinue = nNodeCount > 0;
+    while( bContinue )
+    {
+        int iLevel = 0;
+        while( panLevelEnds[iLevel] <= iGroup )
+            iLevel++;
+        const GUInt32 nEnd = std::min( iGroup + static_cast<GUInt32>(nNodeSize),
+                                       panLevelEnds[iLevel] );
+        const bool bItems = iLevel == 0;
+
+        for( GUInt32 iPos = iGroup; iPos < nEnd; iPos++ )
+        {
+            const double* padfBox = padfBoxes + 4 * static_cast<size_t>(iPos);
+            if( padfBox[0] > sEnvelope.MaxX || padfBox[1] > sEnvelope.MaxY ||
+                padfBox[2] < sEnvelope.MinX || padfBox[3] < sEnvelope.MinY )
+                continue;
+
+            const GUInt32 nIndex = panIndices[iPos];
+            if( bItems )
+            {
+                if( nIndex < static_cast<GUInt32>(nShapeCount) )
+                    anResults.push_back( static_cast<int>(nIndex) );
+            }
+            /* Children are in the previous level: this also guarantees */
+            /* that a corrupted file cannot make us loop forever. */
+            else if( nIndex < panLevelEnds[iLevel-1] &&
+                     (iLevel == 1 || nIndex >= panLevelEnds[iLevel-2]) )
+            {
+                anStack.push_back( nIndex );
+            }
+        }
+
+        if( anStack.empty() )
+            bContinue = false;
+        else
+        {
+            iGroup = anStack.back();
+            anStack.pop_back();
+        }
+    }
+
+    std::sort( anResults.begin(), anResults.end() );
+
+    *pnCount = static_cast<int>(anResults.size());
+    int* panRet = static_cast<int*>( malloc( sizeof(int) * (anResults.size() + 1) ) );
+    if( panRet != NULL && !anResults.empty() )
+        memcpy( panRet, &anResults[0], sizeof(int) * anResults.size() );
+    return panRet;
+}
+
+/************************************************************************/
+/*                         ReadShapeBounds()                            */
+/*                                                                      */
+/*      Read the bounding box of a record from its header, without      */
+/*      reading the vertices. Returns false for null shapes.            */
+/************************************************************************/
+
+static bool ReadShapeBounds( SHPHandle hSHP, int iShape, double* padfBox,
+                             bool* pbError )
+{
+    unsigned int nOffset = hSHP->panRecOffset[iShape];
+    unsigned int nSize = hSHP->panRecSize[iShape];
+
+    /* With lazy loading of the .shx, the entry may not be known yet */
+    if( nOffset == 0 )
+    {
+        GUInt32 anEntry[2];
+        if( hSHP->sHooks.FSeek( hSHP->fpSHX,
+                                100 + 8 * static_cast<SAOffset>(iShape),
+                                SEEK_SET ) != 0 ||
+            hSHP->sHooks.FRead( anEntry, 8, 1, hSHP->fpSHX ) != 1 )
+        {
+            *pbError = true;
+            return false;
+        }
+        CPL_MSBPTR32( &anEntry[0] );
+        CPL_MSBPTR32( &anEntry[1] );
+        nOffset = anEntry[0] * 2;
+        nSize = anEntry[1] * 2;
+    }
+
+    if( nSize < 4 )
+        return false;
+
+    GByte abyContent[36];
+    const unsigned int nToRead = std::min( nSize, 36U );
+    if( hSHP->sHooks.FSeek( hSHP->fpSHP, static_cast<SAOffset>(nOffset) + 8,
+                            SEEK_SET ) != 0 ||
+        hSHP->sHooks.FRead( abyContent, nToRead, 1, hSHP->fpSHP ) != 1 )
+    {
+        *pbError = true;
+        return false;
+    }
+
+    GInt32 nShapeType;
+    memcpy( &nShapeType, abyContent, 4 );
+    CPL_LSBPTR32( &nShapeType );
+
+    if( nShapeType == SHPT_NULL )
+        return false;
+
+    if( nShapeType == SHPT_POINT || nShapeType == SHPT_POINTZ ||
+        nShapeType == SHPT_POINTM )
+    {
+        if( nToRead < 20 )
+            return false;
+        memcpy( padfBox, abyContent + 4, 16 );
+        CPL_LSBPTR64( padfBox );
+        CPL_LSBPTR64( padfBox + 1 );
+        padfBox[2] = padfBox[0];
+        padfBox[3] = padfBox[1];
+    }
+    else
+    {
+        if( nToRead < 36 )
+            return false;
+        memcpy( padfBox, abyContent + 4, 32 );
+        for( int i = 0; i < 4; i++ )
+            CPL_LSBPTR64( padfBox + i );
+    }
+
+    /* Also rejects NaN */
+    return padfBox[0] <= padfBox[2] && padfBox[1] <= padfBox[3];
+}
+
+/************************************************************************/
+/*                               Build()                                */
+/************************************************************************/
+
+bool OGRShapeRTree::Build( const char *pszFilename, SHPHandle hSHP,
+                           int nNodeSize )
+{
+/* -------------------------------------------------------------------- */
+/*      Collect the bounding boxes of the shapes.                       */
+/* -------------------------------------------------------------------- */
+    std::vector<OGRShapeRTreeItem> aoItems;
+    /* Not an OGREnvelope, whose Merge() takes a (0,0) extent as not */
+    /* initialized yet */
+    double dfMinX = 0.0;
+    double dfMinY = 0.0;
+    double dfMaxX = 0.0;
+    double dfMaxY = 0.0;
+    bool bError = false;
+    for( int iShape = 0; iShape < hSHP->nRecords && !bError; iShape++ )
+    {
+        OGRShapeRTreeItem oItem;
+        if( !ReadShapeBounds( hSHP, iShape, oItem.adfBox, &bError ) )
+            continue;
+        oItem.nShapeId = static_cast<GUInt32>(iShape);
+        oItem.nHilbert = 0;
+        if( aoItems.empty() )
+        {
+            dfMinX = oItem.adfBox[0];
+            dfMinY = oItem.adfBox[1];
+            dfMaxX = oItem.adfBox[2];
+            dfMaxY = oItem.adfBox[3];
+        }
+        else
+        {
+            dfMinX = std::min( dfMinX, oItem.adfBox[0] );
+            dfMinY = std::min( dfMinY, oItem.adfBox[1] );
+            dfMaxX = std::max( dfMaxX, oItem.adfBox[2] );
+            dfMaxY = std::max( dfMaxY, oItem.adfBox[3] );
+        }
+        aoItems.push_back( oItem );
+    }
+    if( bError )
+    {
+        CPLError( CE_Failure, CPLE_FileIO,
+                  "Failed to read shape bounds while building %s.",
+                  pszFilename );
+        return false;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Sort them along the Hilbert curve.                              */
+/* -------------------------------------------------------------------- */
+    const double dfWidth = dfMaxX - dfMinX;
+    const double dfHeight = dfMaxY - dfMinY;
+    for( size_t i = 0; i < aoItems.size(); i++ )
+    {
+        const double* padfBox = aoItems[i].adfBox;
+        /* Rounding errors on huge coordinates may put the center slightly */
+        /* out of the extent: clamp before casting */
+        double dfX = 0.0;
+        double dfY = 0.0;
+        if( dfWidth > 0 )
+            dfX = 65535 * ((padfBox[0] + padfBox[2]) / 2 - dfMinX) / dfWidth;
+        if( dfHeight > 0 )
+            dfY = 65535 * ((padfBox[1] + padfBox[3]) / 2 - dfMinY) / dfHeight;
+        const GUInt32 nX = static_cast<GUInt32>(
+            std::max( 0.0, std::min( 65535.0, dfX ) ) );
+        const GUInt32 nY = static_cast<GUInt32>(
+            std::max( 0.0, std::min( 65535.0, dfY ) ) );
+        aoItems[i].nHilbert = OGRShapeRTreeHilbert( nX, nY );
+    }
+    std::sort( aoItems.begin(), aoItems.end() );
+
+/* -------------------------------------------------------------------- */
+/*      Compute the level sizes and pack the nodes, level by level.     */
+/* -------------------------------------------------------------------- */
+    const size_t nItemCount = aoItems.size();
+    std::vector<GUInt32> anLevelEnds;
+    size_t nNodeCount = nItemCount;
+    if( nItemCount > 0 )
+    {
+        anLevelEnds.push_back( static_cast<GUInt32>(nItemCount) );
+        size_t nLevelNodes = nItemCount;
+        do
+        {
+            nLevelNodes = (nLevelNodes + nNodeSize - 1) / nNodeSize;
+            nNodeCount += nLevelNodes;
+            anLevelEnds.push_back( static_cast<GUInt32>(nNodeCount) );
+        } while( nLevelNodes != 1 );
+    }
+
+    std::vector<double> adfBoxes( 4 * nNodeCount );
+    std::vector<GUInt32> anIndices( nNodeCount );
+    for( size_t i = 0; i < nItemCount; i++ )
+    {
+        memcpy( &adfBoxes[4 * i], aoItems[i].adfBox, 4 * sizeof(double) );
+        anIndices[i] = aoItems[i].nShapeId;
+    }
+    std::vector<OGRShapeRTreeItem>().swap( aoItems );
+
+    size_t iChild = 0;
+    size_t iNode = nItemCount;
+    for( size_t iLevel = 0; iLevel + 1 < anLevelEnds.size(); iLevel++ )
+    {
+        const size_t nLevelEnd = anLevelEnds[iLevel];
+        while( iChild < nLevelEnd )
+        {
+            double* padfNodeBox = &adfBoxes[4 * iNode];
+            memcpy( padfNodeBox, &adfBoxes[4 * iChild], 4 * sizeof(double) );
+            anIndices[iNode] = static_cast<GUInt32>(iChild);
+            for( int j = 0; j < nNodeSize && iChild < nLevelEnd; j++, iChild++ )
+            {
+                const double* padfChildBox = &adfBoxes[4 * iChild];
+                padfNodeBox[0] = std::min( padfNodeBox[0], padfChildBox[0] );
+                padfNodeBox[1] = std::min( padfNodeBox[1], padfChildBox[1] );
+                padfNodeBox[2] = std::max( padfNodeBox[2], padfChildBox[2] );
+                padfNodeBox[3] = std::max( padfNodeBox[3], padfChildBox[3] );
+            }
+            iNode++;
+        }
+    }
+    CPLAssert( iNode == nNodeCount );
+
+/* -------------------------------------------------------------------- */
+/*      Write the file.                                                 */
+/* -------------------------------------------------------------------- */
+    VSILFILE* fp = VSIFOpenL( pszFilename, "wb" );
+    if( fp == NULL )
+    {
+        CPLError( CE_Failure, CPLE_OpenFailed,
+                  "Failed to create %s.", pszFilename );
+        return false;
+    }
+
+    GByte abyHeader[RTX_HEADER_SIZE];
+    memcpy( abyHeader, RTX_SIGNATURE, 8 );
+    GInt32 anHeader[8] = { RTX_VERSION, nNodeSize,
+                           static_cast<GInt32>(nItemCount),
+                           static_cast<GInt32>(nNodeCount),
+                           static_cast<GInt32>(anLevelEnds.size()),
+                           hSHP->nRecords,
+                           static_cast<GInt32>(hSHP->nFileSize), 0 };
+    for( int i = 0; i < 8; i++ )
+    {
+        CPL_LSBPTR32( &anHeader[i] );
+        memcpy( abyHeader + 8 + 4 * i, &anHeader[i], 4 );
+    }
+
+#ifdef CPL_MSB
+    for( size_t i = 0; i < adfBoxes.size(); i++ )
+        CPL_SWAP64PTR( &adfBoxes[i] );
+    for( size_t i = 0; i < anIndices.size(); i++ )
+        CPL_SWAP32PTR( &anIndices[i] );
+    for( size_t i = 0; i < anLevelEnds.size(); i++ )
+        CPL_SWAP32PTR( &anLevelEnds[i] );
+#endif
+
+    bool bOK = VSIFWriteL( abyHeader, 1, RTX_HEADER_SIZE, fp ) == RTX_HEADER_SIZE;
+    if( bOK && nNodeCount > 0 )
+    {
+        bOK = VSIFWriteL( &adfBoxes[0], sizeof(double), adfBoxes.size(), fp ) ==
+                    adfBoxes.size() &&
+              VSIFWriteL( &anIndices[0], 4, anIndices.size(), fp ) ==
+                    anIndices.size() &&
+              VSIFWriteL( &anLevelEnds[0], 4, anLevelEnds.size(), fp ) ==
+                    anLevelEnds.size();
+    }
+    if( VSIFCloseL( fp ) != 0 )
+        bOK = false;
+    if( !bOK )
+    {
+        CPLError( CE_Failure, CPLE_FileIO, "Failed to write %s.", pszFilename );
+        VSIUnlink( pszFilename );
+    }
+
+    return bOK;
+}
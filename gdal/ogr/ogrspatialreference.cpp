@@ -7128,6 +7128,7 @@ OGRErr OGRSpatialReference::SetExtension( const char *pszTargetKey,
 CPL_C_START
 void CleanupESRIDatumMappingTable();
 CPL_C_END
+void EPSGCacheCleanup();
 static void CleanupSRSWGS84Thread();
 
 /**
@@ -7140,7 +7141,9 @@ void OSRCleanup( void )
 
 {
     CleanupESRIDatumMappingTable();
+    EPSGCacheCleanup();
     CSVDeaccess( NULL );
+    OCTCleanupTransformationCache();
     OCTCleanupProjMutex();
     CleanupSRSWGS84Thread();
 }
@@ -41,6 +41,139 @@
 
 CPL_CVSID("$Id$");
 
+/************************************************************************/
+/*                       OGRFormatFixedDouble()                         */
+/*                                                                      */
+/*      Same output as CPLsnprintf() with "%.<nPrecision>f", computed   */
+/*      with integer arithmetic. This is only possible when all the     */
+/*      significant bits of the value are above 2^-60 and below 2^63,   */
+/*      which covers coordinates and most attribute values. Returns     */
+/*      -1 when the value cannot be handled that way, or does not fit   */
+/*      in the buffer, so that the caller uses CPLsnprintf().           */
+/************************************************************************/
+
+static int OGRFormatFixedDouble( char *pszBuffer, int nBufferLen,
+                                 double dfVal, int nPrecision )
+{
+    if( nPrecision < 0 || nPrecision > 64 )
+        return -1;
+
+    GUIntBig nBits;
+    memcpy(&nBits, &dfVal, sizeof(nBits));
+    const bool bNegative = (nBits >> 63) != 0;
+    const int nBiasedExp = static_cast<int>((nBits >> 52) & 0x7FF);
+    GUIntBig nMantissa = nBits & ((static_cast<GUIntBig>(1) << 52) - 1);
+    if( nBiasedExp == 0x7FF )
+        return -1;
+
+    /* dfVal = +/- nMantissa * 2^nExp */
+    int nExp = -1074;
+    if( nBiasedExp != 0 )
+    {
+        nMantissa |= static_cast<GUIntBig>(1) << 52;
+        nExp = nBiasedExp - 1075;
+    }
+    if( nMantissa == 0 )
+        nExp = 0;
+    else
+    {
+        while( (nMantissa & 1) == 0 )
+        {
+            nMantissa >>= 1;
+            nExp ++;
+        }
+    }
+
+    GUIntBig nInt;
+    GUIntBig nFrac = 0;
+    int nFracBits = 0;
+    if( nExp >= 0 )
+    {
+        /* nMantissa < 2^53, so this keeps nInt below 2^63 */
+        if( nExp > 10 )
+            return -1;
+        nInt = nMantissa << nExp;
+    }
+    else
+    {
+        nFracBits = -nExp;
+        if( nFracBits > 60 )
+            return -1;
+        nInt = nMantissa >> nFracBits;
+        nFrac = nMantissa & ((static_cast<GUIntBig>(1) << nFracBits) - 1);
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Generate the decimals. nFrac < 2^60 so nFrac * 10 cannot        */
+/*      overflow.                                                       */
+/* -------------------------------------------------------------------- */
+    char szFrac[64];
+    const GUIntBig nFracMask = (static_cast<GUIntBig>(1) << nFracBits) - 1;
+    for( int i = 0; i < nPrecision; i++ )
+    {
+        nFrac *= 10;
+        szFrac[i] = static_cast<char>('0' + (nFrac >> nFracBits));
+        nFrac &= nFracMask;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Round the remainder to nearest, ties to even, like printf().    */
+/* -------------------------------------------------------------------- */
+    if( nFracBits > 0 )
+    {
+        const GUIntBig nHalf = static_cast<GUIntBig>(1) << (nFracBits - 1);
+        const int nLastDigit = (nPrecision > 0) ? szFrac[nPrecision-1] - '0'
+                                                : static_cast<int>(nInt & 1);
+        if( nFrac > nHalf || (nFrac == nHalf && (nLastDigit & 1) != 0) )
+        {
+            int i = nPrecision - 1;
+            for( ; i >= 0; i-- )
+            {
+                if( szFrac[i] != '9' )
+                {
+                    szFrac[i] ++;
+                    break;
+                }
+                szFrac[i] = '0';
+            }
+            if( i < 0 )
+                nInt ++;
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Assemble sign, integral part and decimals.                      */
+/* -------------------------------------------------------------------- */
+    char szInt[24];
+    int nIntLen = 0;
+    do
+    {
+        szInt[sizeof(szInt) - 1 - nIntLen] = static_cast<char>('0' + nInt % 10);
+        nInt /= 10;
+        nIntLen ++;
+    } while( nInt != 0 );
+
+    const int nLen = (bNegative ? 1 : 0) + nIntLen +
+                     (nPrecision > 0 ? 1 + nPrecision : 0);
+    if( nLen >= nBufferLen )
+        return -1;
+
+    char* pszIter = pszBuffer;
+    if( bNegative )
+        *(pszIter++) = '-';
+    memcpy(pszIter, szInt + sizeof(szInt) - nIntLen, nIntLen);
+    pszIter += nIntLen;
+    if( nPrecision > 0 )
+    {
+        *(pszIter++) = '.';
+        memcpy(pszIter, szFrac, nPrecision);
+        pszIter += nPrecision;
+    }
+    *pszIter = '\0';
+
+    return nLen;
+}
+
 /************************************************************************/
 /*                        OGRFormatDouble()                             */
 /************************************************************************/
@@ -69,7 +202,11 @@ void OGRFormatDouble( char *pszBuffer, int nBufferLen, double dfVal,
 
     snprintf(szFormat, sizeof(szFormat), "%%.%d%c", nPrecision, chConversionSpecifier);
 
-    int ret = CPLsnprintf(pszBuffer, nBufferLen, szFormat, dfVal);
+    int ret = -1;
+    if( chConversionSpecifier == 'f' )
+        ret = OGRFormatFixedDouble(pszBuffer, nBufferLen, dfVal, nPrecision);
+    if( ret < 0 )
+        ret = CPLsnprintf(pszBuffer, nBufferLen, szFormat, dfVal);
     /* Windows CRT doesn't conform with C99 and return -1 when buffer is truncated */
     if (ret >= nBufferLen || ret == -1)
     {
@@ -152,7 +289,9 @@ void OGRFormatDouble( char *pszBuffer, int nBufferLen, double dfVal,
                 nPrecision --;
                 nTruncations ++;
                 snprintf(szFormat, sizeof(szFormat), "%%.%d%c", nPrecision, chConversionSpecifier);
-                CPLsnprintf(pszBuffer, nBufferLen, szFormat, dfVal);
+                if( chConversionSpecifier != 'f' ||
+                    OGRFormatFixedDouble(pszBuffer, nBufferLen, dfVal, nPrecision) < 0 )
+                    CPLsnprintf(pszBuffer, nBufferLen, szFormat, dfVal);
                 if( chConversionSpecifier == 'g' && strchr(pszBuffer, 'e') )
                     return;
                 continue;
@@ -170,7 +309,9 @@ void OGRFormatDouble( char *pszBuffer, int nBufferLen, double dfVal,
                 nPrecision --;
                 nTruncations ++;
                 snprintf(szFormat, sizeof(szFormat), "%%.%d%c", nPrecision, chConversionSpecifier);
-                CPLsnprintf(pszBuffer, nBufferLen, szFormat, dfVal);
+                if( chConversionSpecifier != 'f' ||
+                    OGRFormatFixedDouble(pszBuffer, nBufferLen, dfVal, nPrecision) < 0 )
+                    CPLsnprintf(pszBuffer, nBufferLen, szFormat, dfVal);
                 if( chConversionSpecifier == 'g' && strchr(pszBuffer, 'e') )
                     return;
                 continue;
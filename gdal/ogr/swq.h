@@ -25,6 +25,8 @@
 #include "cpl_string.h"
 #include "ogr_core.h"
 
+#include <vector>
+
 #if defined(_WIN32) && !defined(strcasecmp)
 #  define strcasecmp stricmp
 #endif
@@ -239,7 +241,9 @@ CPLErr swq_expr_compile2( const char *where_clause,
 /*
 ** Evaluation related.
 */
-int swq_test_like( const char *input, const char *pattern );
+int swq_test_like( const char *input, const char *pattern, char chEscape );
+int swq_test_string_equal( const char *pszValue1, swq_field_type eType1,
+                           const char *pszValue2, swq_field_type eType2 );
 
 swq_expr_node *SWQGeneralEvaluator( swq_expr_node *, swq_expr_node **);
 swq_field_type SWQGeneralChecker( swq_expr_node *node, int bAllowMismatchTypeOnFieldComparison );
@@ -247,6 +251,58 @@ swq_expr_node *SWQCastEvaluator( swq_expr_node *, swq_expr_node **);
 swq_field_type SWQCastChecker( swq_expr_node *node, int bAllowMismatchTypeOnFieldComparison );
 const char*    SWQFieldTypeToString( swq_field_type field_type );
 
+/*
+** Flat evaluation program.  A checked expression tree can be lowered to
+** a list of instructions working on typed value slots, which avoids the
+** node allocations done by swq_expr_node::Evaluate() for each record.
+*/
+typedef struct {
+    swq_field_type field_type;
+    int            is_null;
+    GIntBig        int_value;
+    double         float_value;
+    const char    *string_value;
+} swq_value;
+
+/* The fetcher must set is_null, and int_value for SWQ_INTEGER, */
+/* SWQ_INTEGER64 and SWQ_BOOLEAN columns, float_value for SWQ_FLOAT */
+/* columns and string_value otherwise.  It returns FALSE on error. */
+typedef int (*swq_value_fetcher)( swq_expr_node *op, void *record,
+                                  swq_value *value );
+
+typedef struct {
+    int            nOpCode;
+    int            nTarget;     /* result slot */
+    int            nFirstArg;   /* first argument slot index in anArgs */
+    int            nArgCount;
+    int            nJump;       /* target of SWQ_OPCODE_AND_SHORTCUT */
+    swq_expr_node *poNode;      /* column node of SWQ_OPCODE_FETCH */
+} swq_instruction;
+
+class swq_expr_program {
+    std::vector<swq_instruction> asInstructions;
+    std::vector<int>             anArgs;
+    std::vector<swq_value>       asSlots;
+    std::vector<CPLString>       aosStrings;
+    int                          nResultSlot;
+
+                    swq_expr_program() : nResultSlot(-1) {}
+
+    int             AddSlot( swq_field_type eType );
+    int             AddInstruction( int nOpCode, int nTarget,
+                                    const std::vector<int>& anArgSlots );
+    int             CompileNode( swq_expr_node *poNode );
+    int             CompileOperation( swq_expr_node *poNode );
+
+public:
+    static swq_expr_program *Compile( swq_expr_node *poExpr );
+
+    const swq_value *Evaluate( swq_value_fetcher pfnFetcher, void *record );
+
+    int             GetInstructionCount() const
+                        { return (int)asInstructions.size(); }
+};
+
 /****************************************************************************/
 
 #define SWQP_ALLOW_UNDEFINED_COL_FUNCS 0x01
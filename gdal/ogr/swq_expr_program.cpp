@@ -0,0 +1,794 @@
+/******************************************************************************
+ * $Id$
+ *
+ * Component: OGR SQL Engine
+ * Purpose: Implementation of swq_expr_program, a flat form of checked
+ *          expression trees used for fast evaluation.
+ *
+ ******************************************************************************
+ * Copyright (c) 2016, GDAL contributors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+ * OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ ****************************************************************************/
+
+#include "swq.h"
+
+CPL_CVSID("$Id$");
+
+/*
+** The program is a list of instructions evaluated in order.  Each
+** instruction reads its arguments from value slots and writes its result
+** to its own slot, so an expression tree is simply laid out in postorder.
+** Constants are stored in their slot once at compile time.  The operand
+** types of every operation are known after swq_expr_node::Check(), so
+** the type dispatch done by SWQGeneralEvaluator() for each record is
+** resolved at compile time into a specialized opcode.
+**
+** Only the operations of SWQGeneralEvaluator() producing a boolean or a
+** number are supported, and only for operand types where the result is
+** known to be identical to the one of the tree evaluation.  For anything
+** else Compile() returns NULL and the tree should be evaluated instead.
+**
+** The program keeps pointers to the nodes of the tree it was built from,
+** so it must be destroyed before the tree, or when the tree is modified.
+** Evaluate() is not reentrant.
+*/
+
+typedef enum {
+    SWQ_OPCODE_FETCH,
+    SWQ_OPCODE_TO_FLOAT,
+    SWQ_OPCODE_AND_SHORTCUT,
+    SWQ_OPCODE_ISNULL,
+
+    SWQ_OPCODE_AND,
+    SWQ_OPCODE_OR,
+    SWQ_OPCODE_NOT,
+
+    SWQ_OPCODE_INT_EQ,
+    SWQ_OPCODE_INT_NE,
+    SWQ_OPCODE_INT_GE,
+    SWQ_OPCODE_INT_LE,
+    SWQ_OPCODE_INT_LT,
+    SWQ_OPCODE_INT_GT,
+    SWQ_OPCODE_INT_IN,
+    SWQ_OPCODE_INT_BETWEEN,
+    SWQ_OPCODE_INT_ADD,
+    SWQ_OPCODE_INT_SUBTRACT,
+    SWQ_OPCODE_INT_MULTIPLY,
+    SWQ_OPCODE_INT_DIVIDE,
+    SWQ_OPCODE_INT_MODULUS,
+
+    SWQ_OPCODE_FLOAT_EQ,
+    SWQ_OPCODE_FLOAT_NE,
+    SWQ_OPCODE_FLOAT_GE,
+    SWQ_OPCODE_FLOAT_LE,
+    SWQ_OPCODE_FLOAT_LT,
+    SWQ_OPCODE_FLOAT_GT,
+    SWQ_OPCODE_FLOAT_IN,
+    SWQ_OPCODE_FLOAT_BETWEEN,
+    SWQ_OPCODE_FLOAT_ADD,
+    SWQ_OPCODE_FLOAT_SUBTRACT,
+    SWQ_OPCODE_FLOAT_MULTIPLY,
+    SWQ_OPCODE_FLOAT_DIVIDE,
+    SWQ_OPCODE_FLOAT_MODULUS,
+
+    SWQ_OPCODE_STRING_EQ,
+    SWQ_OPCODE_STRING_NE,
+    SWQ_OPCODE_STRING_GE,
+    SWQ_OPCODE_STRING_LE,
+    SWQ_OPCODE_STRING_LT,
+    SWQ_OPCODE_STRING_GT,
+    SWQ_OPCODE_STRING_IN,
+    SWQ_OPCODE_STRING_BETWEEN,
+    SWQ_OPCODE_STRING_LIKE
+} swq_opcode;
+
+/************************************************************************/
+/*                         SWQIsStringType()                            */
+/************************************************************************/
+
+static int SWQIsStringType( swq_field_type eType )
+{
+    return eType == SWQ_STRING || eType == SWQ_DATE ||
+           eType == SWQ_TIME || eType == SWQ_TIMESTAMP;
+}
+
+/************************************************************************/
+/*                              AddSlot()                               */
+/************************************************************************/
+
+int swq_expr_program::AddSlot( swq_field_type eType )
+
+{
+    swq_value sValue;
+
+    sValue.field_type = eType;
+    sValue.is_null = FALSE;
+    sValue.int_value = 0;
+    sValue.float_value = 0.0;
+    sValue.string_value = "";
+    asSlots.push_back( sValue );
+
+    return (int) asSlots.size() - 1;
+}
+
+/************************************************************************/
+/*                           AddInstruction()                           */
+/************************************************************************/
+
+int swq_expr_program::AddInstruction( int nOpCode, int nTarget,
+                                      const std::vector<int>& anArgSlots )
+
+{
+    swq_instruction sInstr;
+
+    sInstr.nOpCode = nOpCode;
+    sInstr.nTarget = nTarget;
+    sInstr.nFirstArg = (int) anArgs.size();
+    sInstr.nArgCount = (int) anArgSlots.size();
+    sInstr.nJump = -1;
+    sInstr.poNode = NULL;
+    anArgs.insert( anArgs.end(), anArgSlots.begin(), anArgSlots.end() );
+    asInstructions.push_back( sInstr );
+
+    return (int) asInstructions.size() - 1;
+}
+
+/************************************************************************/
+/*                            CompileNode()                             */
+/*                                                                      */
+/*      Returns the slot holding the value of the node, or -1 if the    */
+/*      node cannot be compiled.                                        */
+/************************************************************************/
+
+int swq_expr_program::CompileNode( swq_expr_node *poNode )
+
+{
+    if( poNode->eNodeType == SNT_CONSTANT )
+    {
+        swq_field_type eType = poNode->field_type;
+        if( !SWQ_IS_INTEGER(eType) && eType != SWQ_BOOLEAN &&
+            eType != SWQ_FLOAT && !SWQIsStringType(eType) )
+            return -1;
+
+        int iSlot = AddSlot( eType );
+        swq_value &sValue = asSlots[iSlot];
+        sValue.is_null = poNode->is_null;
+        sValue.int_value = poNode->int_value;
+        sValue.float_value = poNode->float_value;
+        sValue.string_value = poNode->string_value;
+        if( SWQIsStringType(eType) && sValue.string_value == NULL )
+        {
+            if( !sValue.is_null )
+                return -1;
+            sValue.string_value = "";
+        }
+        return iSlot;
+    }
+
+    if( poNode->eNodeType == SNT_COLUMN )
+    {
+/* -------------------------------------------------------------------- */
+/*      Fetchers return booleans as integers, and all the non numeric   */
+/*      types but geometries as strings.                                */
+/* -------------------------------------------------------------------- */
+        swq_field_type eType;
+        switch( poNode->field_type )
+        {
+          case SWQ_INTEGER:
+          case SWQ_BOOLEAN:
+            eType = SWQ_INTEGER;
+            break;
+
+          case SWQ_INTEGER64:
+          case SWQ_FLOAT:
+            eType = poNode->field_type;
+            break;
+
+          case SWQ_GEOMETRY:
+            return -1;
+
+          default:
+            eType = SWQ_STRING;
+            break;
+        }
+
+        int iSlot = AddSlot( eType );
+        int iInstr = AddInstruction( SWQ_OPCODE_FETCH, iSlot,
+                                     std::vector<int>() );
+        asInstructions[iInstr].poNode = poNode;
+        return iSlot;
+    }
+
+    if( poNode->eNodeType == SNT_OPERATION )
+        return CompileOperation( poNode );
+
+    return -1;
+}
+
+/************************************************************************/
+/*                          CompileOperation()                          */
+/************************************************************************/
+
+int swq_expr_program::CompileOperation( swq_expr_node *poNode )
+
+{
+    const swq_operation *poOp =
+        swq_op_registrar::GetOperator( (swq_op) poNode->nOperation );
+    const int nCount = poNode->nSubExprCount;
+
+    if( poOp == NULL || poOp->pfnEvaluator != SWQGeneralEvaluator ||
+        nCount < 1 )
+        return -1;
+
+/* -------------------------------------------------------------------- */
+/*      Compile the arguments.  The second argument of AND is skipped   */
+/*      when the first one is already false or null.                    */
+/* -------------------------------------------------------------------- */
+    std::vector<int> anArgSlots;
+    int iTarget = -1;
+    int iShortcut = -1;
+
+    for( int i = 0; i < nCount; i++ )
+    {
+        int iSlot = CompileNode( poNode->papoSubExpr[i] );
+        if( iSlot < 0 )
+            return -1;
+        anArgSlots.push_back( iSlot );
+
+        if( i == 0 && nCount == 2 && poNode->nOperation == SWQ_AND &&
+            (SWQ_IS_INTEGER(asSlots[iSlot].field_type) ||
+             asSlots[iSlot].field_type == SWQ_BOOLEAN) )
+        {
+            iTarget = AddSlot( SWQ_BOOLEAN );
+            iShortcut = AddInstruction( SWQ_OPCODE_AND_SHORTCUT, iTarget,
+                                        anArgSlots );
+        }
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Pick the evaluator branch the same way SWQGeneralEvaluator()    */
+/*      does.                                                           */
+/* -------------------------------------------------------------------- */
+    const swq_field_type eType0 = asSlots[anArgSlots[0]].field_type;
+    const swq_field_type eType1 =
+        nCount > 1 ? asSlots[anArgSlots[1]].field_type : SWQ_OTHER;
+    const swq_field_type eNodeType = poNode->field_type;
+    swq_field_type eResultType = eNodeType;
+    int nOpCode = -1;
+
+    if( poNode->nOperation == SWQ_ISNULL )
+    {
+        if( nCount != 1 || eNodeType != SWQ_BOOLEAN )
+            return -1;
+        nOpCode = SWQ_OPCODE_ISNULL;
+    }
+    else if( eType0 == SWQ_FLOAT || eType1 == SWQ_FLOAT )
+    {
+        // Only the first two arguments are converted from integer.
+        for( int i = 0; i < nCount; i++ )
+        {
+            swq_field_type eType = asSlots[anArgSlots[i]].field_type;
+            if( eType == SWQ_FLOAT )
+                continue;
+            if( i >= 2 || !SWQ_IS_INTEGER(eType) )
+                return -1;
+
+            std::vector<int> anConvArgs;
+            anConvArgs.push_back( anArgSlots[i] );
+            anArgSlots[i] = AddSlot( SWQ_FLOAT );
+            AddInstruction( SWQ_OPCODE_TO_FLOAT, anArgSlots[i], anConvArgs );
+        }
+
+        switch( poNode->nOperation )
+        {
+          case SWQ_EQ: nOpCode = SWQ_OPCODE_FLOAT_EQ; break;
+          case SWQ_NE: nOpCode = SWQ_OPCODE_FLOAT_NE; break;
+          case SWQ_GE: nOpCode = SWQ_OPCODE_FLOAT_GE; break;
+          case SWQ_LE: nOpCode = SWQ_OPCODE_FLOAT_LE; break;
+          case SWQ_LT: nOpCode = SWQ_OPCODE_FLOAT_LT; break;
+          case SWQ_GT: nOpCode = SWQ_OPCODE_FLOAT_GT; break;
+          case SWQ_IN: nOpCode = SWQ_OPCODE_FLOAT_IN; break;
+          case SWQ_BETWEEN: nOpCode = SWQ_OPCODE_FLOAT_BETWEEN; break;
+          case SWQ_ADD: nOpCode = SWQ_OPCODE_FLOAT_ADD; break;
+          case SWQ_SUBTRACT: nOpCode = SWQ_OPCODE_FLOAT_SUBTRACT; break;
+          case SWQ_MULTIPLY: nOpCode = SWQ_OPCODE_FLOAT_MULTIPLY; break;
+          case SWQ_DIVIDE: nOpCode = SWQ_OPCODE_FLOAT_DIVIDE; break;
+          case SWQ_MODULUS: nOpCode = SWQ_OPCODE_FLOAT_MODULUS; break;
+          default: return -1;
+        }
+
+        if( nOpCode == SWQ_OPCODE_FLOAT_MODULUS )
+        {
+            if( eNodeType != SWQ_INTEGER )
+                return -1;
+        }
+        else if( nOpCode >= SWQ_OPCODE_FLOAT_ADD )
+        {
+            if( eNodeType != SWQ_FLOAT )
+                return -1;
+        }
+        else if( eNodeType != SWQ_BOOLEAN )
+            return -1;
+    }
+    else if( SWQ_IS_INTEGER(eType0) || eType0 == SWQ_BOOLEAN )
+    {
+        for( int i = 0; i < nCount; i++ )
+        {
+            swq_field_type eType = asSlots[anArgSlots[i]].field_type;
+            if( !SWQ_IS_INTEGER(eType) && eType != SWQ_BOOLEAN )
+                return -1;
+        }
+
+        switch( poNode->nOperation )
+        {
+          case SWQ_AND: nOpCode = SWQ_OPCODE_AND; break;
+          case SWQ_OR: nOpCode = SWQ_OPCODE_OR; break;
+          case SWQ_NOT: nOpCode = SWQ_OPCODE_NOT; break;
+          case SWQ_EQ: nOpCode = SWQ_OPCODE_INT_EQ; break;
+          case SWQ_NE: nOpCode = SWQ_OPCODE_INT_NE; break;
+          case SWQ_GE: nOpCode = SWQ_OPCODE_INT_GE; break;
+          case SWQ_LE: nOpCode = SWQ_OPCODE_INT_LE; break;
+          case SWQ_LT: nOpCode = SWQ_OPCODE_INT_LT; break;
+          case SWQ_GT: nOpCode = SWQ_OPCODE_INT_GT; break;
+          case SWQ_IN: nOpCode = SWQ_OPCODE_INT_IN; break;
+          case SWQ_BETWEEN: nOpCode = SWQ_OPCODE_INT_BETWEEN; break;
+          case SWQ_ADD: nOpCode = SWQ_OPCODE_INT_ADD; break;
+          case SWQ_SUBTRACT: nOpCode = SWQ_OPCODE_INT_SUBTRACT; break;
+          case SWQ_MULTIPLY: nOpCode = SWQ_OPCODE_INT_MULTIPLY; break;
+          case SWQ_DIVIDE: nOpCode = SWQ_OPCODE_INT_DIVIDE; break;
+          case SWQ_MODULUS: nOpCode = SWQ_OPCODE_INT_MODULUS; break;
+          default: return -1;
+        }
+
+        if( nOpCode >= SWQ_OPCODE_INT_ADD )
+        {
+            if( !SWQ_IS_INTEGER(eNodeType) )
+                return -1;
+        }
+        else if( eNodeType != SWQ_BOOLEAN )
+            return -1;
+    }
+    else
+    {
+        for( int i = 0; i < nCount; i++ )
+        {
+            if( !SWQIsStringType(asSlots[anArgSlots[i]].field_type) )
+                return -1;
+        }
+
+        switch( poNode->nOperation )
+        {
+          case SWQ_EQ: nOpCode = SWQ_OPCODE_STRING_EQ; break;
+          case SWQ_NE: nOpCode = SWQ_OPCODE_STRING_NE; break;
+          case SWQ_GE: nOpCode = SWQ_OPCODE_STRING_GE; break;
+          case SWQ_LE: nOpCode = SWQ_OPCODE_STRING_LE; break;
+          case SWQ_LT: nOpCode = SWQ_OPCODE_STRING_LT; break;
+          case SWQ_GT: nOpCode = SWQ_OPCODE_STRING_GT; break;
+          case SWQ_IN: nOpCode = SWQ_OPCODE_STRING_IN; break;
+          case SWQ_BETWEEN: nOpCode = SWQ_OPCODE_STRING_BETWEEN; break;
+          case SWQ_LIKE: nOpCode = SWQ_OPCODE_STRING_LIKE; break;
+          default: return -1;
+        }
+
+        if( eNodeType != SWQ_BOOLEAN )
+            return -1;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Check the argument count expected by the opcode.                */
+/* -------------------------------------------------------------------- */
+    switch( nOpCode )
+    {
+      case SWQ_OPCODE_ISNULL:
+      case SWQ_OPCODE_NOT:
+        break;
+
+      case SWQ_OPCODE_INT_IN:
+      case SWQ_OPCODE_FLOAT_IN:
+      case SWQ_OPCODE_STRING_IN:
+        if( nCount < 2 )
+            return -1;
+        break;
+
+      case SWQ_OPCODE_INT_BETWEEN:
+      case SWQ_OPCODE_FLOAT_BETWEEN:
+      case SWQ_OPCODE_STRING_BETWEEN:
+        if( nCount != 3 )
+            return -1;
+        break;
+
+      case SWQ_OPCODE_STRING_LIKE:
+        if( nCount != 2 && nCount != 3 )
+            return -1;
+        break;
+
+      default:
+        if( nCount != 2 )
+            return -1;
+        break;
+    }
+
+    if( nOpCode == SWQ_OPCODE_FLOAT_MODULUS )
+        eResultType = SWQ_INTEGER;
+
+    if( iTarget < 0 )
+        iTarget = AddSlot( eResultType );
+    else
+        asSlots[iTarget].field_type = eResultType;
+
+    AddInstruction( nOpCode, iTarget, anArgSlots );
+
+    if( iShortcut >= 0 )
+        asInstructions[iShortcut].nJump = (int) asInstructions.size();
+
+    return iTarget;
+}
+
+/************************************************************************/
+/*                              Compile()                               */
+/************************************************************************/
+
+swq_expr_program *swq_expr_program::Compile( swq_expr_node *poExpr )
+
+{
+    if( poExpr == NULL ||
+        !CPLTestBool(CPLGetConfigOption("OGR_SQL_COMPILE_EXPRESSIONS", "YES")) )
+        return NULL;
+
+    swq_expr_program *poProgram = new swq_expr_program();
+
+    poProgram->nResultSlot = poProgram->CompileNode( poExpr );
+    if( poProgram->nResultSlot < 0 )
+    {
+        delete poProgram;
+        return NULL;
+    }
+
+    poProgram->aosStrings.resize( poProgram->asSlots.size() );
+
+    return poProgram;
+}
+
+/************************************************************************/
+/*                              Evaluate()                              */
+/*                                                                      */
+/*      Returns the value of the expression, valid until the next call, */
+/*      or NULL if a field could not be fetched.                        */
+/************************************************************************/
+
+const swq_value *swq_expr_program::Evaluate( swq_value_fetcher pfnFetcher,
+                                             void *pRecord )
+
+{
+    const int nInstructions = (int) asInstructions.size();
+    const int *panAllArgs = anArgs.empty() ? NULL : &anArgs[0];
+    swq_value *pasSlots = &asSlots[0];
+
+    for( int iInstr = 0; iInstr < nInstructions; )
+    {
+        const swq_instruction *psInstr = &asInstructions[iInstr];
+        const int *panArgs = panAllArgs + psInstr->nFirstArg;
+        swq_value *psTarget = pasSlots + psInstr->nTarget;
+        const swq_value *psArg0 =
+            psInstr->nArgCount > 0 ? pasSlots + panArgs[0] : NULL;
+        const swq_value *psArg1 =
+            psInstr->nArgCount > 1 ? pasSlots + panArgs[1] : NULL;
+
+        iInstr++;
+
+        if( psInstr->nOpCode == SWQ_OPCODE_FETCH )
+        {
+            if( !pfnFetcher( psInstr->poNode, pRecord, psTarget ) )
+                return NULL;
+            if( psTarget->field_type == SWQ_STRING )
+            {
+                // Keep our own copy, reusing the slot buffer.
+                CPLString &osValue = aosStrings[psInstr->nTarget];
+                if( psTarget->string_value != NULL )
+                    osValue.assign( psTarget->string_value );
+                else
+                    osValue.clear();
+                psTarget->string_value = osValue.c_str();
+            }
+            continue;
+        }
+
+        if( psInstr->nOpCode == SWQ_OPCODE_AND_SHORTCUT )
+        {
+            if( psArg0->is_null || !psArg0->int_value )
+            {
+                psTarget->is_null = FALSE;
+                psTarget->int_value = FALSE;
+                iInstr = psInstr->nJump;
+            }
+            continue;
+        }
+
+/* -------------------------------------------------------------------- */
+/*      Null arguments make boolean operations false and the other      */
+/*      ones null.                                                      */
+/* -------------------------------------------------------------------- */
+        if( psInstr->nOpCode != SWQ_OPCODE_ISNULL )
+        {
+            bool bNull = false;
+            for( int i = 0; i < psInstr->nArgCount; i++ )
+            {
+                if( pasSlots[panArgs[i]].is_null )
+                {
+                    bNull = true;
+                    break;
+                }
+            }
+            if( bNull )
+            {
+                psTarget->is_null = psTarget->field_type != SWQ_BOOLEAN;
+                psTarget->int_value = 0;
+                psTarget->float_value = 0.0;
+                continue;
+            }
+        }
+
+        psTarget->is_null = FALSE;
+
+        switch( (swq_opcode) psInstr->nOpCode )
+        {
+          case SWQ_OPCODE_FETCH:
+          case SWQ_OPCODE_AND_SHORTCUT:
+            break;
+
+          case SWQ_OPCODE_TO_FLOAT:
+            psTarget->float_value = (double) psArg0->int_value;
+            break;
+
+          case SWQ_OPCODE_ISNULL:
+            psTarget->int_value = psArg0->is_null;
+            break;
+
+          case SWQ_OPCODE_AND:
+            psTarget->int_value = psArg0->int_value && psArg1->int_value;
+            break;
+
+          case SWQ_OPCODE_OR:
+            psTarget->int_value = psArg0->int_value || psArg1->int_value;
+            break;
+
+          case SWQ_OPCODE_NOT:
+            psTarget->int_value = !psArg0->int_value;
+            break;
+
+/* -------------------------------------------------------------------- */
+/*      Integer operations.                                             */
+/* -------------------------------------------------------------------- */
+          case SWQ_OPCODE_INT_EQ:
+            psTarget->int_value = psArg0->int_value == psArg1->int_value;
+            break;
+
+          case SWQ_OPCODE_INT_NE:
+            psTarget->int_value = psArg0->int_value != psArg1->int_value;
+            break;
+
+          case SWQ_OPCODE_INT_GE:
+            psTarget->int_value = psArg0->int_value >= psArg1->int_value;
+            break;
+
+          case SWQ_OPCODE_INT_LE:
+            psTarget->int_value = psArg0->int_value <= psArg1->int_value;
+            break;
+
+          case SWQ_OPCODE_INT_LT:
+            psTarget->int_value = psArg0->int_value < psArg1->int_value;
+            break;
+
+          case SWQ_OPCODE_INT_GT:
+            psTarget->int_value = psArg0->int_value > psArg1->int_value;
+            break;
+
+          case SWQ_OPCODE_INT_IN:
+            psTarget->int_value = FALSE;
+            for( int i = 1; i < psInstr->nArgCount; i++ )
+            {
+                if( psArg0->int_value == pasSlots[panArgs[i]].int_value )
+                {
+                    psTarget->int_value = TRUE;
+                    break;
+                }
+            }
+            break;
+
+          case SWQ_OPCODE_INT_BETWEEN:
+            psTarget->int_value =
+                psArg0->int_value >= psArg1->int_value &&
+                psArg0->int_value <= pasSlots[panArgs[2]].int_value;
+            break;
+
+          case SWQ_OPCODE_INT_ADD:
+            psTarget->int_value = psArg0->int_value + psArg1->int_value;
+            break;
+
+          case SWQ_OPCODE_INT_SUBTRACT:
+            psTarget->int_value = psArg0->int_value - psArg1->int_value;
+            break;
+
+          case SWQ_OPCODE_INT_MULTIPLY:
+            psTarget->int_value = psArg0->int_value * psArg1->int_value;
+            break;
+
+          case SWQ_OPCODE_INT_DIVIDE:
+            if( psArg1->int_value == 0 )
+                psTarget->int_value = INT_MAX;
+            else
+                psTarget->int_value = psArg0->int_value / psArg1->int_value;
+            break;
+
+          case SWQ_OPCODE_INT_MODULUS:
+            if( psArg1->int_value == 0 )
+                psTarget->int_value = INT_MAX;
+            else
+                psTarget->int_value = psArg0->int_value % psArg1->int_value;
+            break;
+
+/* -------------------------------------------------------------------- */
+/*      Floating point operations.                                      */
+/* -------------------------------------------------------------------- */
+          case SWQ_OPCODE_FLOAT_EQ:
+            psTarget->int_value = psArg0->float_value == psArg1->float_value;
+            break;
+
+          case SWQ_OPCODE_FLOAT_NE:
+            psTarget->int_value = psArg0->float_value != psArg1->float_value;
+            break;
+
+          case SWQ_OPCODE_FLOAT_GE:
+            psTarget->int_value = psArg0->float_value >= psArg1->float_value;
+            break;
+
+          case SWQ_OPCODE_FLOAT_LE:
+            psTarget->int_value = psArg0->float_value <= psArg1->float_value;
+            break;
+
+          case SWQ_OPCODE_FLOAT_LT:
+            psTarget->int_value = psArg0->float_value < psArg1->float_value;
+            break;
+
+          case SWQ_OPCODE_FLOAT_GT:
+            psTarget->int_value = psArg0->float_value > psArg1->float_value;
+            break;
+
+          case SWQ_OPCODE_FLOAT_IN:
+            psTarget->int_value = FALSE;
+            for( int i = 1; i < psInstr->nArgCount; i++ )
+            {
+                if( psArg0->float_value == pasSlots[panArgs[i]].float_value )
+                {
+                    psTarget->int_value = TRUE;
+                    break;
+                }
+            }
+            break;
+
+          case SWQ_OPCODE_FLOAT_BETWEEN:
+            psTarget->int_value =
+                psArg0->float_value >= psArg1->float_value &&
+                psArg0->float_value <= pasSlots[panArgs[2]].float_value;
+            break;
+
+          case SWQ_OPCODE_FLOAT_ADD:
+            psTarget->float_value = psArg0->float_value + psArg1->float_value;
+            break;
+
+          case SWQ_OPCODE_FLOAT_SUBTRACT:
+            psTarget->float_value = psArg0->float_value - psArg1->float_value;
+            break;
+
+          case SWQ_OPCODE_FLOAT_MULTIPLY:
+            psTarget->float_value = psArg0->float_value * psArg1->float_value;
+            break;
+
+          case SWQ_OPCODE_FLOAT_DIVIDE:
+            if( psArg1->float_value == 0 )
+                psTarget->float_value = INT_MAX;
+            else
+                psTarget->float_value =
+                    psArg0->float_value / psArg1->float_value;
+            break;
+
+          case SWQ_OPCODE_FLOAT_MODULUS:
+          {
+            GIntBig nRight = (GIntBig) psArg1->float_value;
+            if( nRight == 0 )
+                psTarget->int_value = INT_MAX;
+            else
+                psTarget->int_value =
+                    ((GIntBig) psArg0->float_value) % nRight;
+            break;
+          }
+
+/* -------------------------------------------------------------------- */
+/*      String operations.                                              */
+/* -------------------------------------------------------------------- */
+          case SWQ_OPCODE_STRING_EQ:
+            psTarget->int_value =
+                swq_test_string_equal( psArg0->string_value,
+                                       psArg0->field_type,
+                                       psArg1->string_value,
+                                       psArg1->field_type );
+            break;
+
+          case SWQ_OPCODE_STRING_NE:
+            psTarget->int_value =
+                strcasecmp( psArg0->string_value, psArg1->string_value ) != 0;
+            break;
+
+          case SWQ_OPCODE_STRING_GE:
+            psTarget->int_value =
+                strcasecmp( psArg0->string_value, psArg1->string_value ) >= 0;
+            break;
+
+          case SWQ_OPCODE_STRING_LE:
+            psTarget->int_value =
+                strcasecmp( psArg0->string_value, psArg1->string_value ) <= 0;
+            break;
+
+          case SWQ_OPCODE_STRING_LT:
+            psTarget->int_value =
+                strcasecmp( psArg0->string_value, psArg1->string_value ) < 0;
+            break;
+
+          case SWQ_OPCODE_STRING_GT:
+            psTarget->int_value =
+                strcasecmp( psArg0->string_value, psArg1->string_value ) > 0;
+            break;
+
+          case SWQ_OPCODE_STRING_IN:
+            psTarget->int_value = FALSE;
+            for( int i = 1; i < psInstr->nArgCount; i++ )
+            {
+                if( strcasecmp( psArg0->string_value,
+                                pasSlots[panArgs[i]].string_value ) == 0 )
+                {
+                    psTarget->int_value = TRUE;
+                    break;
+                }
+            }
+            break;
+
+          case SWQ_OPCODE_STRING_BETWEEN:
+            psTarget->int_value =
+                strcasecmp( psArg0->string_value,
+                            psArg1->string_value ) >= 0 &&
+                strcasecmp( psArg0->string_value,
+                            pasSlots[panArgs[2]].string_value ) <= 0;
+            break;
+
+          case SWQ_OPCODE_STRING_LIKE:
+          {
+            char chEscape = '\0';
+            if( psInstr->nArgCount == 3 )
+                chEscape = pasSlots[panArgs[2]].string_value[0];
+            psTarget->int_value =
+                swq_test_like( psArg0->string_value, psArg1->string_value,
+                               chEscape );
+            break;
+          }
+        }
+    }
+
+    return pasSlots + nResultSlot;
+}
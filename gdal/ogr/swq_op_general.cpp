@@ -39,7 +39,7 @@
 /*      Does input match pattern?                                       */
 /************************************************************************/
 
-static int swq_test_like( const char *input, const char *pattern, char chEscape )
+int swq_test_like( const char *input, const char *pattern, char chEscape )
 
 {
     if( input == NULL || pattern == NULL )
@@ -103,6 +103,42 @@ static int swq_test_like( const char *input, const char *pattern, char chEscape
         return 1;
 }
 
+/************************************************************************/
+/*                       swq_test_string_equal()                        */
+/*                                                                      */
+/*      Are two string or timestamp values equal?                       */
+/************************************************************************/
+
+int swq_test_string_equal( const char *pszValue1, swq_field_type eType1,
+                           const char *pszValue2, swq_field_type eType2 )
+
+{
+    /* When comparing timestamps, the +00 at the end might be discarded */
+    /* if the other member has no explicit timezone */
+    if( (eType1 == SWQ_TIMESTAMP || eType1 == SWQ_STRING) &&
+        (eType2 == SWQ_TIMESTAMP || eType2 == SWQ_STRING) &&
+        strlen(pszValue1) > 3 &&
+        strlen(pszValue2) > 3 &&
+        (strcmp(pszValue1 + strlen(pszValue1)-3, "+00") == 0 &&
+         pszValue2[strlen(pszValue2)-3] == ':') )
+    {
+        return EQUALN(pszValue1, pszValue2, strlen(pszValue2));
+    }
+    else if( (eType1 == SWQ_TIMESTAMP || eType1 == SWQ_STRING) &&
+             (eType2 == SWQ_TIMESTAMP || eType2 == SWQ_STRING) &&
+             strlen(pszValue1) > 3 &&
+             strlen(pszValue2) > 3 &&
+             (pszValue1[strlen(pszValue1)-3] == ':')  &&
+              strcmp(pszValue2 + strlen(pszValue2)-3, "+00") == 0)
+    {
+        return EQUALN(pszValue1, pszValue2, strlen(pszValue1));
+    }
+    else
+    {
+        return strcasecmp(pszValue1, pszValue2) == 0;
+    }
+}
+
 /************************************************************************/
 /*                        OGRHStoreGetValue()                           */
 /************************************************************************/
@@ -571,42 +607,11 @@ swq_expr_node *SWQGeneralEvaluator( swq_expr_node *node,
         {
           case SWQ_EQ:
           {
-            /* When comparing timestamps, the +00 at the end might be discarded */
-            /* if the other member has no explicit timezone */
-            if( (sub_node_values[0]->field_type == SWQ_TIMESTAMP ||
-                 sub_node_values[0]->field_type == SWQ_STRING) &&
-                (sub_node_values[1]->field_type == SWQ_TIMESTAMP ||
-                 sub_node_values[1]->field_type == SWQ_STRING) &&
-                strlen(sub_node_values[0]->string_value) > 3 &&
-                strlen(sub_node_values[1]->string_value) > 3 &&
-                (strcmp(sub_node_values[0]->string_value + strlen(sub_node_values[0]->string_value)-3, "+00") == 0 &&
-                 sub_node_values[1]->string_value[strlen(sub_node_values[1]->string_value)-3] == ':') )
-            {
-                poRet->int_value =
-                    EQUALN(sub_node_values[0]->string_value,
-                           sub_node_values[1]->string_value,
-                           strlen(sub_node_values[1]->string_value));
-            }
-            else if( (sub_node_values[0]->field_type == SWQ_TIMESTAMP ||
-                      sub_node_values[0]->field_type == SWQ_STRING) &&
-                     (sub_node_values[1]->field_type == SWQ_TIMESTAMP ||
-                      sub_node_values[1]->field_type == SWQ_STRING) &&
-                     strlen(sub_node_values[0]->string_value) > 3 &&
-                     strlen(sub_node_values[1]->string_value) > 3 &&
-                     (sub_node_values[0]->string_value[strlen(sub_node_values[0]->string_value)-3] == ':')  &&
-                      strcmp(sub_node_values[1]->string_value + strlen(sub_node_values[1]->string_value)-3, "+00") == 0)
-            {
-                poRet->int_value =
-                    EQUALN(sub_node_values[0]->string_value,
-                           sub_node_values[1]->string_value,
-                           strlen(sub_node_values[0]->string_value));
-            }
-            else
-            {
-                poRet->int_value =
-                    strcasecmp(sub_node_values[0]->string_value,
-                            sub_node_values[1]->string_value) == 0;
-            }
+            poRet->int_value =
+                swq_test_string_equal(sub_node_values[0]->string_value,
+                                      sub_node_values[0]->field_type,
+                                      sub_node_values[1]->string_value,
+                                      sub_node_values[1]->field_type);
             break;
           }
 
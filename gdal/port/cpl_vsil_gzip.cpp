@@ -2427,7 +2427,9 @@ void VSIInstallZipFileHandler(void)
  *
  * @param ptr input buffer.
  * @param nBytes size of input buffer in bytes.
- * @param nLevel ZLib compression level (-1 for default).
+ * @param nLevel ZLib compression level, from 0 to 9 (-1, or any other value,
+ *               for default). Before GDAL 2.2, it was ignored and the default
+ *               level was always used.
  * @param outptr output buffer, or NULL to let the function allocate it.
  * @param nOutAvailableBytes size of output buffer if provided, or ignored.
  * @param pnOutBytes pointer to a size_t, where to store the size of the
@@ -2441,7 +2443,7 @@ void VSIInstallZipFileHandler(void)
 
 void* CPLZLibDeflate( const void* ptr,
                       size_t nBytes,
-                      CPL_UNUSED int nLevel,
+                      int nLevel,
                       void* outptr,
                       size_t nOutAvailableBytes,
                       size_t* pnOutBytes )
@@ -2450,7 +2452,9 @@ void* CPLZLibDeflate( const void* ptr,
     strm.zalloc = NULL;
     strm.zfree = NULL;
     strm.opaque = NULL;
-    int ret = deflateInit(&strm, Z_DEFAULT_COMPRESSION);
+    if( nLevel < 0 || nLevel > 9 )
+        nLevel = Z_DEFAULT_COMPRESSION;
+    int ret = deflateInit(&strm, nLevel);
     if (ret != Z_OK)
     {
         if( pnOutBytes != NULL )
@@ -2485,6 +2489,7 @@ void* CPLZLibDeflate( const void* ptr,
     ret = deflate(&strm, Z_FINISH);
     if( ret != Z_STREAM_END )
     {
+        deflateEnd(&strm);
         if( pTmp != outptr )
             VSIFree(pTmp);
         if( pnOutBytes != NULL )